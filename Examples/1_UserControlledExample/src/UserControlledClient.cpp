@@ -168,7 +168,7 @@ void UserControlledClient::CreateTestWorld()
     int num_biomes = 0;
     for (int i = 0; i < 256; ++i)
     {
-        std::shared_ptr<Biome> biome = AssetsManager::getInstance().GetBiome(i);
+        const Biome* biome = AssetsManager::getInstance().GetBiome(i);
         if (biome)
         {
             num_biomes++;
@@ -189,7 +189,7 @@ void UserControlledClient::CreateTestWorld()
     x = 0;
     for (int i = 0; i < 256; ++i)
     {
-        std::shared_ptr<Biome> biome = AssetsManager::getInstance().GetBiome(i);
+        const Biome* biome = AssetsManager::getInstance().GetBiome(i);
         if (biome)
         {
             Position pos(-(x * biome_spacing) - 1, 0, 0);
@@ -207,21 +207,18 @@ void UserControlledClient::CreateTestWorld()
             pos = Position(-(x * biome_spacing) - 1, 0, 1);
 
             const Block *block = world->GetBlock(pos);
-            std::shared_ptr<Blockstate> previous_blockstate;
-            unsigned char previous_model_id;
+            const Blockstate* previous_blockstate;
             if (block != nullptr)
             {
                 previous_blockstate = block->GetBlockstate();
-                previous_model_id = block->GetModelId();
             }
             else
             {
 #if PROTOCOL_VERSION < 347
-                previous_blockstate = AssetsManager::getInstance().Blockstates().at(0).at(0);
+                previous_blockstate = AssetsManager::getInstance().GetBlockstate(0, 0);
 #else
-                previous_blockstate = AssetsManager::getInstance().Blockstates().at(0);
+                previous_blockstate = AssetsManager::getInstance().GetBlockstate(0);
 #endif
-                previous_model_id = 0;
             }
 #if PROTOCOL_VERSION < 347
             world->SetBlock(pos, 18, 0);
@@ -239,16 +236,14 @@ void UserControlledClient::CreateTestWorld()
             if (block != nullptr)
             {
                 previous_blockstate = block->GetBlockstate();
-                previous_model_id = block->GetModelId();
             }
             else
             {
 #if PROTOCOL_VERSION < 347
-                previous_blockstate = AssetsManager::getInstance().Blockstates().at(0).at(0);
+                previous_blockstate = AssetsManager::getInstance().GetBlockstate(0, 0);
 #else
-                previous_blockstate = AssetsManager::getInstance().Blockstates().at(0);
+                previous_blockstate = AssetsManager::getInstance().GetBlockstate(0);
 #endif
-                previous_model_id = 0;
             }
 
 #if PROTOCOL_VERSION < 347
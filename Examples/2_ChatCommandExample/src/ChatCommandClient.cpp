@@ -89,8 +89,8 @@ void ChatCommandClient::Handle(ClientboundChatPacket &msg)
                     // only the lambda solution can use default
                     // parameters for the last bool value
                     .leaf([=](ChatCommandClient& c) { return GoTo(c, target_position, 0, 0, speed); })
-                    .leaf(GoTo, target_position, 0, 0, speed, true)
-                    .leaf(std::bind(GoTo, std::placeholders::_1, target_position, 0, 0, speed, true))
+                    .leaf(GoTo, target_position, 0, 0, speed, true, false)
+                    .leaf(std::bind(GoTo, std::placeholders::_1, target_position, 0, 0, speed, true, false))
                     // If goto fails, say something in chat
                     .leaf(Say, "Pathfinding failed :(")
                 .end()
@@ -188,7 +188,7 @@ void ChatCommandClient::Handle(ClientboundChatPacket &msg)
         auto tree = Builder<ChatCommandClient>()
             // shortcut for composite<Sequence<ChatCommandClient>>()
             .sequence()
-                .leaf(GoTo, pos, 4, 1, 4.317f, true)
+                .leaf(GoTo, pos, 4, 1, 4.317f, true, false)
                 // Set interaction position in the blackboard
                 .leaf(SetBlackboardData<Position>, "InteractWithBlock.pos", pos)
                 .selector()
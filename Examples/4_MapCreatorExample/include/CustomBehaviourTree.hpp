@@ -12,6 +12,7 @@ class RepeatUntilSuccess : public Botcraft::Decorator<Context>
 public:
     RepeatUntilSuccess(const size_t n_)
     {
+        this->SetName("RepeatUntilSuccess");
         n = n_;
     }
 
@@ -19,7 +20,7 @@ public:
     {
         for (size_t i = 0; i < n; ++i)
         {
-            Botcraft::Status child_return = this->child->Tick(context);
+            Botcraft::Status child_return = this->TickChild(*this->child, context);
             if (child_return == Botcraft::Status::Success)
             {
                 return Botcraft::Status::Success;
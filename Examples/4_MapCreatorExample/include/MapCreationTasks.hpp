@@ -1,9 +1,11 @@
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include <botcraft/AI/BehaviourTree.hpp>
 #include <botcraft/AI/BehaviourClient.hpp>
+#include <botcraft/AI/BuildCoordinator.hpp>
 #include <botcraft/Game/Vector3.hpp>
 
 /// @brief Check all blocks nearby for chests. Save the found positions in World.ChestsPos
@@ -29,20 +31,23 @@ Botcraft::Status GetBlocksAvailableInInventory(Botcraft::BehaviourClient& c);
 /// @return Success if all the items were deposited/the inventory is full, Failure otherwise
 Botcraft::Status SwapChestsInventory(Botcraft::BehaviourClient& c, const std::string& food_name, const bool take_from_chest);
 
-/// @brief Read block list in blackboard at Inventory.block_list and fill in NextTask.action, NextTask.pos, NextTask.face and NextTask.item
+/// @brief Read block list in blackboard at Inventory.block_list, lease the nearest doable job from the coordinator and fill in NextTask.action, NextTask.pos, NextTask.face and NextTask.item
 /// @param c The client performing the action
+/// @param coordinator The coordinator shared by all bots, its plan is set from the blackboard Structure.XXX values if needed
 /// @return success if a task was found, failure otherwise
-Botcraft::Status FindNextTask(Botcraft::BehaviourClient& c);
+Botcraft::Status FindNextTask(Botcraft::BehaviourClient& c, std::shared_ptr<Botcraft::BuildCoordinator> coordinator);
 
-/// @brief Read the blackboard NextTask.XXX values, and perform the given task
+/// @brief Read the blackboard NextTask.XXX values, perform the given task and release it in the coordinator
 /// @param c The client performing the action
+/// @param coordinator The coordinator the task was leased from
 /// @return Success if the task was correctly executed, failure otherwise
-Botcraft::Status ExecuteNextTask(Botcraft::BehaviourClient& c);
+Botcraft::Status ExecuteNextTask(Botcraft::BehaviourClient& c, std::shared_ptr<Botcraft::BuildCoordinator> coordinator);
 
-/// @brief Check if the whole structure is built, check in the blackboard for CheckCompletion.(print_details, print_errors and full_check) to know if details should be displayed in the console
+/// @brief Check if the whole structure is built, check in the blackboard for CheckCompletion.(print_details and print_errors) to know if details should be displayed in the console
 /// @param c The client performing the action
+/// @param coordinator The coordinator shared by all bots, holding the diff between the structure and the world
 /// @return Success if the structure is fully built, failure otherwise
-Botcraft::Status CheckCompletion(Botcraft::BehaviourClient& c);
+Botcraft::Status CheckCompletion(Botcraft::BehaviourClient& c, std::shared_ptr<Botcraft::BuildCoordinator> coordinator);
 
 /// @brief Write a message in the console, prefixed with bot name
 /// @param c The client performing the action
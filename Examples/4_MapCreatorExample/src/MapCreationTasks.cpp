@@ -5,6 +5,7 @@
 #include <botcraft/Game/Entities/EntityManager.hpp>
 #include <botcraft/Game/Entities/LocalPlayer.hpp>
 #include <botcraft/Game/World/World.hpp>
+#include <botcraft/Game/World/StructureDiff.hpp>
 #include <botcraft/Game/Vector3.hpp>
 #include <botcraft/Game/Inventory/InventoryManager.hpp>
 #include <botcraft/Game/Inventory/Window.hpp>
@@ -16,7 +17,7 @@
 
 #include <iostream>
 #include <fstream>
-#include <unordered_set>
+#include <set>
 
 using namespace Botcraft;
 using namespace ProtocolCraft;
@@ -28,7 +29,8 @@ Status GetAllChestsAround(BehaviourClient& c)
     std::shared_ptr<LocalPlayer> local_player = c.GetEntityManager()->GetLocalPlayer();
     std::shared_ptr<World> world = c.GetWorld();
 
-    const Position player_position(local_player->GetX(), local_player->GetY(), local_player->GetZ());
+    const Vector3<double> player_state_position = local_player->GetState().position;
+    const Position player_position(player_state_position.x, player_state_position.y, player_state_position.z);
 
     Position checked_position;
     {
@@ -120,9 +122,9 @@ Status GetSomeFood(BehaviourClient& c, const std::string& food_name)
                         && it->first < first_player_index
                         && !it->second.IsEmptySlot()
 #if PROTOCOL_VERSION < 347
-                        && AssetsManager::getInstance().Items().at(it->second.GetBlockID()).at(it->second.GetItemDamage())->GetName() == item_name
+                        && AssetsManager::getInstance().GetItem(it->second.GetBlockID(), it->second.GetItemDamage())->GetName() == item_name
 #else
-                        && AssetsManager::getInstance().Items().at(it->second.GetItemID())->GetName() == food_name
+                        && AssetsManager::getInstance().GetItem(it->second.GetItemID())->GetName() == food_name
 #endif
                         )
                     {
@@ -161,12 +163,18 @@ Status GetSomeFood(BehaviourClient& c, const std::string& food_name)
         auto start = std::chrono::system_clock::now();
         while (
 #if PROTOCOL_VERSION < 347
-            AssetsManager::getInstance().Items().at(inventory_manager->GetPlayerInventory()->GetSlot(/*Window::INVENTORY_HOTBAR_START*/36).GetBlockID()).at(inventory_manager->GetPlayerInventory()->GetSlot(/*Window::INVENTORY_HOTBAR_START*/36).GetItemDamage())->GetName() != item_name
+            AssetsManager::getInstance().GetItem(inventory_manager->GetPlayerInventory()->GetSlot(/*Window::INVENTORY_HOTBAR_START*/36).GetBlockID(), inventory_manager->GetPlayerInventory()->GetSlot(/*Window::INVENTORY_HOTBAR_START*/36).GetItemDamage())->GetName() != item_name
 #else
-            AssetsManager::getInstance().Items().at(inventory_manager->GetPlayerInventory()->GetSlot(/*Window::INVENTORY_HOTBAR_START*/36).GetItemID())->GetName() != food_name
+            AssetsManager::getInstance().GetItem(inventory_manager->GetPlayerInventory()->GetSlot(/*Window::INVENTORY_HOTBAR_START*/36).GetItemID())->GetName() != food_name
 #endif
             )
         {
+            // Yield returns immediately once interrupted,
+            // don't spin until the timeout
+            if (c.IsBehaviourInterrupted())
+            {
+                return Status::Failure;
+            }
             if (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count() >= 10000)
             {
                 std::cerr << "Something went wrong trying to get food from chest (Timeout)." << std::endl;
@@ -196,9 +204,9 @@ Status GetBlocksAvailableInInventory(BehaviourClient& c)
             !it->second.IsEmptySlot())
         {
 #if PROTOCOL_VERSION < 347
-            blocks_in_inventory.insert(AssetsManager::getInstance().Items().at(it->second.GetBlockID()).at(it->second.GetItemDamage())->GetName());
+            blocks_in_inventory.insert(AssetsManager::getInstance().GetItem(it->second.GetBlockID(), it->second.GetItemDamage())->GetName());
 #else
-            blocks_in_inventory.insert(AssetsManager::getInstance().Items().at(it->second.GetItemID())->GetName());
+            blocks_in_inventory.insert(AssetsManager::getInstance().GetItem(it->second.GetItemID())->GetName());
 #endif
         }
     }
@@ -272,9 +280,9 @@ Status SwapChestsInventory(BehaviourClient& c, const std::string& food_name, con
                     && take_from_chest
                     && !it->second.IsEmptySlot()
 #if PROTOCOL_VERSION < 347
-                    && AssetsManager::getInstance().Items().at(it->second.GetBlockID()).at(it->second.GetItemDamage())->GetName() != food_name
+                    && AssetsManager::getInstance().GetItem(it->second.GetBlockID(), it->second.GetItemDamage())->GetName() != food_name
 #else
-                    && AssetsManager::getInstance().Items().at(it->second.GetItemID())->GetName() != food_name
+                    && AssetsManager::getInstance().GetItem(it->second.GetItemID())->GetName() != food_name
 #endif
                     )
                 {
@@ -300,9 +308,9 @@ Status SwapChestsInventory(BehaviourClient& c, const std::string& food_name, con
                     && !take_from_chest
                     && !it->second.IsEmptySlot()
 #if PROTOCOL_VERSION < 347
-                    && AssetsManager::getInstance().Items().at(it->second.GetBlockID()).at(it->second.GetItemDamage())->GetName() != food_name
+                    && AssetsManager::getInstance().GetItem(it->second.GetBlockID(), it->second.GetItemDamage())->GetName() != food_name
 #else
-                    && AssetsManager::getInstance().Items().at(it->second.GetItemID())->GetName() != food_name
+                    && AssetsManager::getInstance().GetItem(it->second.GetItemID())->GetName() != food_name
 #endif
                     )
                 {
@@ -352,6 +360,11 @@ Status SwapChestsInventory(BehaviourClient& c, const std::string& food_name, con
         const short checked_slot_index = (take_from_chest ? slots_dst[dst_index] : slots_src[src_index]) - first_player_index + 9; /*Window::INVENTORY_STORAGE_START*/
         while (true)
         {
+            // Same as in GetSomeFood, don't spin until the timeout
+            if (c.IsBehaviourInterrupted())
+            {
+                return Status::Failure;
+            }
             if (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count() >= 10000)
             {
                 std::cerr << "Something went wrong trying to get items from chest (Timeout)." << std::endl;
@@ -373,347 +386,155 @@ Status SwapChestsInventory(BehaviourClient& c, const std::string& food_name, con
     return Status::Success;
 }
 
-Status FindNextTask(BehaviourClient& c)
+// Set the plan of the coordinator from the loaded structure if it's not done yet
+void SetCoordinatorPlan(Blackboard& blackboard, std::shared_ptr<BuildCoordinator> coordinator)
 {
-    Blackboard& blackboard = c.GetBlackboard();
-    std::shared_ptr<EntityManager> entity_manager = c.GetEntityManager();
-    std::shared_ptr<World> world = c.GetWorld();
-
-    const Position& start = blackboard.Get<Position>("Structure.start");
-    const Position& end = blackboard.Get<Position>("Structure.end");
-    const std::vector<std::vector<std::vector<short> > >& target = blackboard.Get<std::vector<std::vector<std::vector<short> > > >("Structure.target");
-    const std::map<short, std::string>& palette = blackboard.Get<std::map<short, std::string> >("Structure.palette");
-
-    const std::set<std::string>& available = blackboard.Get<std::set<std::string> >("Inventory.block_list");
-
-    std::mt19937 random_engine = std::mt19937(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
-
-    Position start_pos;
-
-    start_pos.x = std::min(end.x, std::max(start.x, (int)std::floor(entity_manager->GetLocalPlayer()->GetX())));
-    start_pos.y = std::min(end.y, std::max(start.y, (int)std::floor(entity_manager->GetLocalPlayer()->GetY())));
-    start_pos.z = std::min(end.z, std::max(start.z, (int)std::floor(entity_manager->GetLocalPlayer()->GetZ())));
-
-    std::unordered_set<Position> explored;
-    std::unordered_set<Position> to_explore;
-
-    const std::vector<Position> neighbour_offsets({ Position(0, 1, 0), Position(0, -1, 0),
-        Position(0, 0, 1), Position(0, 0, -1),
-        Position(1, 0, 0), Position(-1, 0, 0) });
-
-    to_explore.insert(start_pos);
-
-    std::vector<Position> pos_candidates;
-    std::vector<std::string> item_candidates;
-    std::vector<PlayerDiggingFace> face_candidates;
-
-    while (!to_explore.empty())
+    if (coordinator->HasPlan())
     {
-        // For each candidate, check if
-        // 1) the target is not air
-        // 2) we have the correct block in the inventory
-        // 3) it is currently a free space
-        // 4) it has a block under or next to it so we can put the new block
-
-        // OR
-
-        // 1) the placed block is not air
-        // 2) it does not match the desired build
-        // 3) it has a free block under or next to it so we can dig it
-
-        for (auto it = to_explore.begin(); it != to_explore.end(); ++it)
-        {
-            const Position pos = *it;
-
-            const int target_palette = target[pos.x - start.x][pos.y - start.y][pos.z - start.z];
-            const std::string& target_name = palette.at(target_palette);
-            std::shared_ptr<Blockstate> blockstate;
-            {
-                std::lock_guard<std::mutex> world_guard(world->GetMutex());
-                const Block* block = world->GetBlock(pos);
-
-                if (!block)
-                {
-#if PROTOCOL_VERSION < 347
-                    blockstate = AssetsManager::getInstance().Blockstates().at(0).at(0);
-#else
-                    blockstate = AssetsManager::getInstance().Blockstates().at(0);
-#endif
-                }
-                else
-                {
-                    blockstate = block->GetBlockstate();
-                }
-            }
-
-            // Empty space requiring block placement
-            if (target_palette != -1
-                && blockstate->IsAir()
-                && available.find(target_name) != available.end())
-            {
-                for (int i = 0; i < neighbour_offsets.size(); ++i)
-                {
-                    std::lock_guard<std::mutex> world_guard(world->GetMutex());
-                    const Block* neighbour_block = world->GetBlock(pos + neighbour_offsets[i]);
-
-                    if (neighbour_block && !neighbour_block->GetBlockstate()->IsAir())
-                    {
-                        pos_candidates.push_back(pos);
-                        item_candidates.push_back(target_name);
-                        face_candidates.push_back((PlayerDiggingFace)i);
-                        break;
-                    }
-                }
-            }
-            // Wrong block requiring digging
-            else if ((target_palette != -1 && !blockstate->IsAir() && target_name != blockstate->GetName())
-                || (target_palette == -1 && !blockstate->IsAir()))
-            {
-                for (int i = 0; i < neighbour_offsets.size(); ++i)
-                {
-                    std::lock_guard<std::mutex> world_guard(world->GetMutex());
-                    const Block* neighbour_block = world->GetBlock(pos + neighbour_offsets[i]);
-
-                    if (neighbour_block && !neighbour_block->GetBlockstate()->IsAir())
-                    {
-                        pos_candidates.push_back(pos);
-                        item_candidates.push_back("");
-                        face_candidates.push_back((PlayerDiggingFace)i);
-                        break;
-                    }
-                }
-            }
-        }
-
-        // If we have at least one candidate
-        if (pos_candidates.size() > 0)
-        {
-            // Get the position of all other players
-            std::vector<Vector3<double> > other_player_pos;
-            {
-                std::lock_guard<std::mutex> entity_manager_lock(entity_manager->GetMutex());
-                for (auto it = entity_manager->GetEntities().begin(); it != entity_manager->GetEntities().end(); ++it)
-                {
-                    if (it->second->GetType() == EntityType::Player)
-                    {
-                        other_player_pos.push_back(it->second->GetPosition());
-                    }
-                }
-            }
+        return;
+    }
 
-            // Get all the candidates that are as far as possible from all 
-            // the other players
-            std::vector<int> max_dist_indices;
-            double max_dist = 0.0;
-            for (int i = 0; i < pos_candidates.size(); ++i)
-            {
-                double dist = 0.0;
-                for (int j = 0; j < other_player_pos.size(); ++j)
-                {
-                    dist += std::abs(pos_candidates[i].x - other_player_pos[j].x) +
-                        std::abs(pos_candidates[i].y - other_player_pos[j].y) +
-                        std::abs(pos_candidates[i].z - other_player_pos[j].z);
+    static const BlackboardSlot<Position> start_slot("Structure.start");
+    static const BlackboardSlot<Position> end_slot("Structure.end");
+    static const BlackboardSlot<std::vector<std::vector<std::vector<short> > > > target_slot("Structure.target");
+    static const BlackboardSlot<std::map<short, std::string> > palette_slot("Structure.palette");
 
-                    if (dist > max_dist)
-                    {
-                        max_dist_indices.clear();
-                        max_dist = dist;
-                    }
+    coordinator->SetPlan(blackboard.Get(start_slot), blackboard.Get(end_slot), blackboard.Get(target_slot), blackboard.Get(palette_slot));
+}
 
-                    if (dist == max_dist)
-                    {
-                        max_dist_indices.push_back(i);
-                    }
-                }
-            }
+Status FindNextTask(BehaviourClient& c, std::shared_ptr<BuildCoordinator> coordinator)
+{
+    Blackboard& blackboard = c.GetBlackboard();
 
-            // Select one randomly if multiple possibilities
-            int selected_index = max_dist_indices.size() == 1 ? 0 : max_dist_indices[std::uniform_int_distribution<int>(0, max_dist_indices.size() - 1)(random_engine)];
+    // The first bot with a loaded structure sets the plan for everyone
+    SetCoordinatorPlan(blackboard, coordinator);
 
-            blackboard.Set<std::string>("NextTask.action", item_candidates[selected_index].empty() ? "Dig" : "Place");
-            blackboard.Set("NextTask.block_position", pos_candidates[selected_index]);
-            blackboard.Set("NextTask.face", face_candidates[selected_index]);
-            if (!item_candidates[selected_index].empty())
-            {
-                blackboard.Set("NextTask.item", item_candidates[selected_index]);
-            }
+    static const BlackboardSlot<std::set<std::string> > available_slot("Inventory.block_list");
+    const std::set<std::string>& available = blackboard.Get(available_slot);
 
-            return Status::Success;
-        }
+    const Vector3<double> player_position = c.GetEntityManager()->GetLocalPlayer()->GetState().position;
 
-        explored.insert(to_explore.begin(), to_explore.end());
-        std::unordered_set<Position> neighbours;
-        for (auto it = to_explore.begin(); it != to_explore.end(); ++it)
-        {
-            for (int i = 0; i < neighbour_offsets.size(); ++i)
-            {
-                const Position p = *it + neighbour_offsets[i];
-
-                if (p.x < start.x ||
-                    p.x > end.x ||
-                    p.y < start.y ||
-                    p.y > end.y ||
-                    p.z < start.z ||
-                    p.z > end.z)
-                {
-                    continue;
-                }
+    BuildJob job;
+    if (!coordinator->AcquireJob(c.GetNetworkManager()->GetMyName(), c.GetWorld(), player_position, available, job))
+    {
+        return Status::Failure;
+    }
 
-                if (explored.find(p) == explored.end())
-                {
-                    neighbours.insert(p);
-                }
-            }
-        }
-        to_explore = neighbours;
+    blackboard.Set<std::string>("NextTask.action", job.action == BuildJobAction::Dig ? "Dig" : "Place");
+    blackboard.Set("NextTask.block_position", job.position);
+    blackboard.Set("NextTask.face", job.face);
+    if (job.action == BuildJobAction::Place)
+    {
+        blackboard.Set("NextTask.item", job.item);
     }
 
-    return Status::Failure;
+    return Status::Success;
 }
 
-Status ExecuteNextTask(BehaviourClient& c)
+Status ExecuteNextTask(BehaviourClient& c, std::shared_ptr<BuildCoordinator> coordinator)
 {
     Blackboard& b = c.GetBlackboard();
 
     const std::string& action = b.Get<std::string>("NextTask.action");
     const Position& block_position = b.Get<Position>("NextTask.block_position");
     const PlayerDiggingFace face = b.Get<PlayerDiggingFace>("NextTask.face");
+
+    Status result = Status::Failure;
     if (action == "Dig")
     {
-        return Dig(c, block_position, face);
+        result = Dig(c, block_position, face);
     }
     else if (action == "Place")
     {
         const std::string& item_name = b.Get<std::string>("NextTask.item");
-        return PlaceBlock(c, item_name, block_position, face, true);
+        result = PlaceBlock(c, item_name, block_position, face, true);
+    }
+    else
+    {
+        std::cerr << "Warning, unknown task in ExecuteNextTask" << std::endl;
     }
 
-    std::cerr << "Warning, unknown task in ExecuteNextTask" << std::endl;
-    return Status::Failure;
+    coordinator->ReleaseJob(c.GetNetworkManager()->GetMyName(), result == Status::Success);
+    return result;
 }
 
-Status CheckCompletion(BehaviourClient& c)
+Status CheckCompletion(BehaviourClient& c, std::shared_ptr<BuildCoordinator> coordinator)
 {
     Blackboard& blackboard = c.GetBlackboard();
     std::shared_ptr<World> world = c.GetWorld();
 
-    Position world_pos;
-    Position target_pos;
+    SetCoordinatorPlan(blackboard, coordinator);
+    std::shared_ptr<StructureDiff> diff = coordinator->GetDiff();
+    // The diff is computed once and then updated
+    // with the changes, so checking it is cheap
+    diff->Watch(world);
 
-    int additional_blocks = 0;
-    int wrong_blocks = 0;
-    int missing_blocks = 0;
+    static const BlackboardSlot<bool> print_details_slot("CheckCompletion.print_details");
+    static const BlackboardSlot<bool> print_errors_slot("CheckCompletion.print_errors");
 
-    const Position& start = blackboard.Get<Position>("Structure.start");
-    const Position& end = blackboard.Get<Position>("Structure.end");
-    const std::vector<std::vector<std::vector<short> > >& target = blackboard.Get<std::vector<std::vector<std::vector<short> > > >("Structure.target");
-    const std::map<short, std::string>& palette = blackboard.Get<std::map<short, std::string> >("Structure.palette");
-
-    const bool print_details = blackboard.Get<bool>("CheckCompletion.print_details", false);
-    const bool print_errors = blackboard.Get<bool>("CheckCompletion.print_errors", false);
-    const bool full_check = blackboard.Get<bool>("CheckCompletion.full_check", false);
+    const bool print_details = blackboard.Get(print_details_slot, false);
+    const bool print_errors = blackboard.Get(print_errors_slot, false);
 
     //Reset values for the next time
-    blackboard.Set("CheckCompletion.print_details", false);
-    blackboard.Set("CheckCompletion.print_errors", false);
-    blackboard.Set("CheckCompletion.full_check", false);
+    blackboard.Set(print_details_slot, false);
+    blackboard.Set(print_errors_slot, false);
 
-    for (int x = start.x; x <= end.x; ++x)
+    if (print_details)
     {
-        world_pos.x = x;
-        target_pos.x = x - start.x;
-        for (int y = start.y; y <= end.y; ++y)
+        // Don't print more than 100 blocks
+        const std::vector<StructureDiffEntry> remaining = diff->GetRemaining(100);
+        for (size_t i = 0; i < remaining.size(); ++i)
         {
-            world_pos.y = y;
-            target_pos.y = y - start.y;
-            for (int z = start.z; z <= end.z; ++z)
+            const StructureDiffEntry& entry = remaining[i];
+            switch (entry.type)
             {
-                world_pos.z = z;
-                target_pos.z = z - start.z;
-
-                const short target_id = target[target_pos.x][target_pos.y][target_pos.z];
-                std::shared_ptr<Blockstate> blockstate;
+            case StructureDiffType::Missing:
+                std::cout << "Missing " << entry.expected << " in " << entry.position << std::endl;
+                break;
+            case StructureDiffType::Wrong:
+            case StructureDiffType::Additional:
+            {
+                std::string current_name;
                 {
                     std::lock_guard<std::mutex> world_guard(world->GetMutex());
-                    const Block* block = world->GetBlock(world_pos);
-
-                    if (!block)
-                    {
-                        if (target_id != -1)
-                        {
-                            if (!full_check)
-                            {
-                                return Status::Failure;
-                            }
-                            missing_blocks++;
-                            if (print_details && missing_blocks < 100) // Don't print more than 100 missing blocks
-                            {
-                                std::cout << "Missing " << palette.at(target_id) << " in " << world_pos << std::endl;
-                            }
-                        }
-                        continue;
-                    }
-                    blockstate = block->GetBlockstate();
+                    const Block* block = world->GetBlock(entry.position);
+                    current_name = block ? block->GetBlockstate()->GetName() : "minecraft:air";
                 }
-
-                if (target_id == -1)
+                if (entry.type == StructureDiffType::Wrong)
                 {
-                    if (!blockstate->IsAir())
-                    {
-                        if (!full_check)
-                        {
-                            return Status::Failure;
-                        }
-                        additional_blocks++;
-                        if (print_details)
-                        {
-                            std::cout << "Additional " << blockstate->GetName() << " in " << world_pos << std::endl;
-                        }
-                    }
+                    std::cout << "Wrong " << current_name << " instead of " << entry.expected << " in " << entry.position << std::endl;
                 }
                 else
                 {
-                    if (blockstate->IsAir())
-                    {
-                        if (!full_check)
-                        {
-                            return Status::Failure;
-                        }
-                        missing_blocks++;
-                        if (print_details)
-                        {
-                            std::cout << "Missing " << palette.at(target_id) << " in " << world_pos << std::endl;
-                        }
-                    }
-                    else
-                    {
-                        const std::string& target_name = palette.at(target_id);
-                        if (blockstate->GetName() != target_name)
-                        {
-                            if (!full_check)
-                            {
-                                return Status::Failure;
-                            }
-                            wrong_blocks++;
-                            if (print_details)
-                            {
-                                std::cout << "Wrong " << blockstate->GetName() << " instead of " << target_name << " in " << world_pos << std::endl;
-                            }
-                        }
-                    }
+                    std::cout << "Additional " << current_name << " in " << entry.position << std::endl;
                 }
+                break;
+            }
             }
         }
     }
 
+    const size_t wrong_blocks = diff->GetNumWrong();
+    const size_t missing_blocks = diff->GetNumMissing();
+    const size_t additional_blocks = diff->GetNumAdditional();
+    const size_t unknown_blocks = diff->GetNumUnknown();
+
     if (print_errors)
     {
+        std::cout << "Done: " << diff->GetDonePercentage() << "%" << std::endl;
         std::cout << "Wrong blocks: " << wrong_blocks << std::endl;
         std::cout << "Missing blocks: " << missing_blocks << std::endl;
         std::cout << "Additional blocks: " << additional_blocks << std::endl;
+        std::cout << "Not loaded blocks: " << unknown_blocks << std::endl;
+
+        const std::map<std::string, size_t> needed = diff->GetNeededItems();
+        for (auto it = needed.begin(); it != needed.end(); ++it)
+        {
+            std::cout << "\t" << it->first << "\t\t" << it->second << std::endl;
+        }
     }
 
-    return (missing_blocks + additional_blocks + wrong_blocks == 0) ? Status::Success : Status::Failure;
+    return (missing_blocks + additional_blocks + wrong_blocks + unknown_blocks == 0) ? Status::Success : Status::Failure;
 }
 
 Status WarnConsole(BehaviourClient& c, const std::string& msg)
@@ -26,7 +26,8 @@ void ShowHelp(const char* argv0)
 using namespace Botcraft;
 
 std::shared_ptr<BehaviourTree<SimpleBehaviourClient>> GenerateMapArtCreatorTree(const std::string& food_name,
-    const std::string& nbt_path, const Botcraft::Position& offset, const std::string& temp_block, const bool detailed);
+    const std::string& nbt_path, const Botcraft::Position& offset, const std::string& temp_block, const bool detailed,
+    std::shared_ptr<BuildCoordinator> coordinator);
 
 int main(int argc, char* argv[])
 {
@@ -132,8 +133,14 @@ int main(int argc, char* argv[])
             }
         }
 
-        auto map_art_detailed_behaviour_tree = GenerateMapArtCreatorTree("minecraft:golden_carrot", nbt_file, offset, temp_block, true);
-        auto map_art_behaviour_tree = GenerateMapArtCreatorTree("minecraft:golden_carrot", nbt_file, offset, temp_block, false);
+        // Shared by all the bots so they don't work on the same blocks
+        std::shared_ptr<BuildCoordinator> coordinator = std::make_shared<BuildCoordinator>();
+
+        auto map_art_detailed_behaviour_tree = GenerateMapArtCreatorTree("minecraft:golden_carrot", nbt_file, offset, temp_block, true, coordinator);
+        auto map_art_behaviour_tree = GenerateMapArtCreatorTree("minecraft:golden_carrot", nbt_file, offset, temp_block, false, coordinator);
+        // Flatten the trees as they won't be modified anymore
+        map_art_detailed_behaviour_tree->Compile();
+        map_art_behaviour_tree->Compile();
 
         std::vector<std::shared_ptr<Botcraft::World> > shared_worlds(num_world);
         for (int i = 0; i < num_world; i++)
@@ -202,7 +209,12 @@ int main(int argc, char* argv[])
                 // Set blackboard values to true so the next check completion will print the details
                 blackboard.Set<bool>("CheckCompletion.print_details", true);
                 blackboard.Set<bool>("CheckCompletion.print_errors", true);
-                blackboard.Set<bool>("CheckCompletion.full_check", true);
+
+#if USE_BEHAVIOUR_PROFILING
+                // Dump all clients trees statistics
+                BehaviourProfiler::ExportFoldedStacks("behaviour.folded");
+                BehaviourProfiler::ExportChromeTrace("behaviour_trace.json");
+#endif
 
                 next_time_display += std::chrono::minutes(2);
             }
@@ -233,21 +245,22 @@ int main(int argc, char* argv[])
 }
 
 std::shared_ptr<BehaviourTree<SimpleBehaviourClient>> GenerateMapArtCreatorTree(const std::string& food_name,
-    const std::string& nbt_path, const Botcraft::Position& offset, const std::string& temp_block, const bool detailed)
+    const std::string& nbt_path, const Botcraft::Position& offset, const std::string& temp_block, const bool detailed,
+    std::shared_ptr<BuildCoordinator> coordinator)
 {
     auto loading_tree = Builder<SimpleBehaviourClient>()
         .selector()
             // Check if the structure is already loaded
             .leaf(CheckBlackboardBoolData, "Structure.loaded")
             // Otherwise load it
-            .leaf(LoadNBT, nbt_path, offset, temp_block, detailed)
+            .leaf("LoadNBT", LoadNBT, nbt_path, offset, temp_block, detailed)
         .end()
         .build();
 
     auto completion_tree = Builder<SimpleBehaviourClient>()
         .succeeder()
             .sequence()
-                .leaf(CheckCompletion)
+                .leaf("CheckCompletion", CheckCompletion, coordinator)
                 .leaf(WarnConsole, "Task fully completed!")
                 .repeater(0)
                     .inverter()
@@ -286,7 +299,7 @@ std::shared_ptr<BehaviourTree<SimpleBehaviourClient>> GenerateMapArtCreatorTree(
                     .leaf(WarnConsole, "Can't find food anywhere!")
                 .end()
                 .selector()
-                    .leaf(Eat, food_name, true)
+                    .leaf("Eat", Eat, food_name, true)
                     .inverter()
                         .leaf(WarnConsole, "Can't eat!")
                     .end()
@@ -304,7 +317,7 @@ std::shared_ptr<BehaviourTree<SimpleBehaviourClient>> GenerateMapArtCreatorTree(
             // If no block found, get some in neighbouring chests
             .sequence()
                 .selector()
-                    .leaf(SwapChestsInventory, food_name, true)
+                    .leaf("SwapChestsInventory", SwapChestsInventory, food_name, true)
                     .inverter()
                         .leaf(WarnConsole, "Can't swap with chests, will wait before retrying.")
                     .end()
@@ -333,8 +346,8 @@ std::shared_ptr<BehaviourTree<SimpleBehaviourClient>> GenerateMapArtCreatorTree(
             .decorator<RepeatUntilSuccess<SimpleBehaviourClient>>(5)
                 .selector()
                     .sequence()
-                        .leaf(FindNextTask)
-                        .leaf(ExecuteNextTask)
+                        .leaf("FindNextTask", FindNextTask, coordinator)
+                        .leaf("ExecuteNextTask", ExecuteNextTask, coordinator)
                     .end()
                     // If the previous task failed, sleep for ~1 second
                     // before retrying to get an action
@@ -347,7 +360,7 @@ std::shared_ptr<BehaviourTree<SimpleBehaviourClient>> GenerateMapArtCreatorTree(
             .end()
             // If failed 5 times, put all blocks in chests to
             // randomize available blocks for next time
-            .leaf(SwapChestsInventory, food_name, false)
+            .leaf("SwapChestsInventory", SwapChestsInventory, food_name, false)
         .end()
         .build();
 
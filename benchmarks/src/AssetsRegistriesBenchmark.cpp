@@ -0,0 +1,302 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+
+#include "botcraft/Game/AssetsManager.hpp"
+#include "botcraft/Game/World/Chunk.hpp"
+
+#include "protocolCraft/BinaryReadWrite.hpp"
+
+using namespace Botcraft;
+using namespace ProtocolCraft;
+
+// Measure the cost of a blockstate/item lookup in the flattened
+// registries compared to the maps, and the chunk loading
+// throughput that depends on these lookups
+
+namespace
+{
+    const int NUM_LOOKUPS = 10000000;
+    const int NUM_NAME_LOOKUPS = 100000;
+    const int NUM_CHUNKS = 1000;
+    const int BITS_PER_BLOCK = 4;
+
+    double ElapsedSeconds(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Encode a full chunk (16 sections) with the same
+    // format as the one sent by the server
+    std::vector<unsigned char> EncodeChunk(const std::vector<unsigned int>& palette, std::mt19937& random_gen)
+    {
+        std::vector<unsigned char> output;
+        std::uniform_int_distribution<int> palette_dist(0, static_cast<int>(palette.size()) - 1);
+
+        for (int section_y = 0; section_y < CHUNK_HEIGHT / SECTION_HEIGHT; ++section_y)
+        {
+#if PROTOCOL_VERSION > 404
+            WriteData<short>(SECTION_HEIGHT * CHUNK_WIDTH * CHUNK_WIDTH, output);
+#endif
+            WriteData<unsigned char>(BITS_PER_BLOCK, output);
+            WriteData<VarInt>(static_cast<int>(palette.size()), output);
+            for (size_t i = 0; i < palette.size(); ++i)
+            {
+                WriteData<VarInt>(palette[i], output);
+            }
+
+            std::vector<unsigned long long int> data_array;
+#if PROTOCOL_VERSION > 712
+            // Values don't span across multiple longs
+            const int values_per_long = 64 / BITS_PER_BLOCK;
+            data_array = std::vector<unsigned long long int>((SECTION_HEIGHT * CHUNK_WIDTH * CHUNK_WIDTH + values_per_long - 1) / values_per_long, 0);
+            for (int i = 0; i < SECTION_HEIGHT * CHUNK_WIDTH * CHUNK_WIDTH; ++i)
+            {
+                data_array[i / values_per_long] |= static_cast<unsigned long long int>(palette_dist(random_gen)) << ((i % values_per_long) * BITS_PER_BLOCK);
+            }
+#else
+            // 64 is a multiple of BITS_PER_BLOCK, so values never span across two longs
+            data_array = std::vector<unsigned long long int>(SECTION_HEIGHT * CHUNK_WIDTH * CHUNK_WIDTH * BITS_PER_BLOCK / 64, 0);
+            for (int i = 0; i < SECTION_HEIGHT * CHUNK_WIDTH * CHUNK_WIDTH; ++i)
+            {
+                data_array[(i * BITS_PER_BLOCK) / 64] |= static_cast<unsigned long long int>(palette_dist(random_gen)) << ((i * BITS_PER_BLOCK) % 64);
+            }
+#endif
+            WriteData<VarInt>(static_cast<int>(data_array.size()), output);
+            for (size_t i = 0; i < data_array.size(); ++i)
+            {
+                WriteData<unsigned long long int>(data_array[i], output);
+            }
+
+#if PROTOCOL_VERSION <= 404
+            // Block light and sky light
+            output.insert(output.end(), SECTION_HEIGHT * CHUNK_WIDTH * CHUNK_WIDTH, 0xFF);
+#endif
+        }
+
+#if PROTOCOL_VERSION < 552
+        // Biomes
+        for (int i = 0; i < CHUNK_WIDTH * CHUNK_WIDTH; ++i)
+        {
+#if PROTOCOL_VERSION < 358
+            WriteData<unsigned char>(1, output);
+#else
+            WriteData<int>(1, output);
+#endif
+        }
+#endif
+
+        return output;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const AssetsManager& assets_manager = AssetsManager::getInstance();
+    std::cout << "Assets loading: " << ElapsedSeconds(start) * 1000.0 << " ms" << std::endl;
+
+    std::mt19937 random_gen(42);
+
+    // List all the known blockstates and items
+#if PROTOCOL_VERSION < 347
+    std::vector<std::pair<int, unsigned char> > blockstate_ids;
+    for (auto it = assets_manager.Blockstates().begin(); it != assets_manager.Blockstates().end(); ++it)
+    {
+        for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+        {
+            if (it->first >= 0)
+            {
+                blockstate_ids.push_back({ it->first, it2->first });
+            }
+        }
+    }
+    std::vector<std::pair<int, unsigned char> > item_ids;
+    for (auto it = assets_manager.Items().begin(); it != assets_manager.Items().end(); ++it)
+    {
+        for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+        {
+            if (it->first >= 0)
+            {
+                item_ids.push_back({ it->first, it2->first });
+            }
+        }
+    }
+#else
+    std::vector<int> blockstate_ids;
+    for (auto it = assets_manager.Blockstates().begin(); it != assets_manager.Blockstates().end(); ++it)
+    {
+        if (it->first >= 0)
+        {
+            blockstate_ids.push_back(it->first);
+        }
+    }
+    std::vector<int> item_ids;
+    for (auto it = assets_manager.Items().begin(); it != assets_manager.Items().end(); ++it)
+    {
+        if (it->first >= 0)
+        {
+            item_ids.push_back(it->first);
+        }
+    }
+#endif
+
+    if (blockstate_ids.empty() || item_ids.empty())
+    {
+        std::cerr << "Error, no assets loaded, check that the Assets folder is next to the executable" << std::endl;
+        return 1;
+    }
+
+    // Same random sequence for all the lookup methods
+    std::vector<size_t> blockstate_indices(NUM_LOOKUPS);
+    std::vector<size_t> item_indices(NUM_LOOKUPS);
+    std::uniform_int_distribution<size_t> blockstate_dist(0, blockstate_ids.size() - 1);
+    std::uniform_int_distribution<size_t> item_dist(0, item_ids.size() - 1);
+    for (int i = 0; i < NUM_LOOKUPS; ++i)
+    {
+        blockstate_indices[i] = blockstate_dist(random_gen);
+        item_indices[i] = item_dist(random_gen);
+    }
+
+    // Accumulate something so the lookups are not optimized out
+    size_t checksum = 0;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NUM_LOOKUPS; ++i)
+    {
+#if PROTOCOL_VERSION < 347
+        const std::pair<int, unsigned char>& id = blockstate_ids[blockstate_indices[i]];
+        checksum += reinterpret_cast<size_t>(assets_manager.GetBlockstate(id.first, id.second));
+#else
+        checksum += reinterpret_cast<size_t>(assets_manager.GetBlockstate(blockstate_ids[blockstate_indices[i]]));
+#endif
+    }
+    const double flat_blockstate_time = ElapsedSeconds(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NUM_LOOKUPS; ++i)
+    {
+#if PROTOCOL_VERSION < 347
+        const std::pair<int, unsigned char>& id = blockstate_ids[blockstate_indices[i]];
+        checksum += reinterpret_cast<size_t>(assets_manager.Blockstates().at(id.first).at(id.second).get());
+#else
+        checksum += reinterpret_cast<size_t>(assets_manager.Blockstates().at(blockstate_ids[blockstate_indices[i]]).get());
+#endif
+    }
+    const double map_blockstate_time = ElapsedSeconds(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NUM_LOOKUPS; ++i)
+    {
+#if PROTOCOL_VERSION < 347
+        const std::pair<int, unsigned char>& id = item_ids[item_indices[i]];
+        checksum += reinterpret_cast<size_t>(assets_manager.GetItem(id.first, id.second));
+#else
+        checksum += reinterpret_cast<size_t>(assets_manager.GetItem(item_ids[item_indices[i]]));
+#endif
+    }
+    const double flat_item_time = ElapsedSeconds(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NUM_LOOKUPS; ++i)
+    {
+#if PROTOCOL_VERSION < 347
+        const std::pair<int, unsigned char>& id = item_ids[item_indices[i]];
+        checksum += reinterpret_cast<size_t>(assets_manager.Items().at(id.first).at(id.second).get());
+#else
+        checksum += reinterpret_cast<size_t>(assets_manager.Items().at(item_ids[item_indices[i]]).get());
+#endif
+    }
+    const double map_item_time = ElapsedSeconds(start);
+
+    // Name lookups, hashed index vs linear search
+    std::vector<std::string> names(NUM_NAME_LOOKUPS);
+    for (int i = 0; i < NUM_NAME_LOOKUPS; ++i)
+    {
+#if PROTOCOL_VERSION < 347
+        names[i] = assets_manager.GetBlockstate(blockstate_ids[blockstate_indices[i]].first, blockstate_ids[blockstate_indices[i]].second)->GetName();
+#else
+        names[i] = assets_manager.GetBlockstate(blockstate_ids[blockstate_indices[i]])->GetName();
+#endif
+    }
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NUM_NAME_LOOKUPS; ++i)
+    {
+#if PROTOCOL_VERSION < 347
+        checksum += assets_manager.GetBlockstateID(names[i]).first;
+#else
+        checksum += assets_manager.GetBlockstateID(names[i]);
+#endif
+    }
+    const double hashed_name_time = ElapsedSeconds(start);
+
+    // Linear search is much slower, only do a fraction of the lookups
+    const int num_linear_lookups = NUM_NAME_LOOKUPS / 100;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_linear_lookups; ++i)
+    {
+        for (auto it = assets_manager.Blockstates().begin(); it != assets_manager.Blockstates().end(); ++it)
+        {
+#if PROTOCOL_VERSION < 347
+            if (!it->second.empty() && it->second.begin()->second->GetName() == names[i])
+#else
+            if (it->second->GetName() == names[i])
+#endif
+            {
+                checksum += it->first;
+                break;
+            }
+        }
+    }
+    const double linear_name_time = ElapsedSeconds(start);
+
+    std::cout << "Blockstate lookup (flat): " << flat_blockstate_time * 1e9 / NUM_LOOKUPS << " ns" << std::endl;
+    std::cout << "Blockstate lookup (map): " << map_blockstate_time * 1e9 / NUM_LOOKUPS << " ns" << std::endl;
+    std::cout << "Item lookup (flat): " << flat_item_time * 1e9 / NUM_LOOKUPS << " ns" << std::endl;
+    std::cout << "Item lookup (map): " << map_item_time * 1e9 / NUM_LOOKUPS << " ns" << std::endl;
+    std::cout << "Blockstate name lookup (hashed): " << hashed_name_time * 1e9 / NUM_NAME_LOOKUPS << " ns" << std::endl;
+    std::cout << "Blockstate name lookup (linear): " << linear_name_time * 1e9 / num_linear_lookups << " ns" << std::endl;
+
+    // Chunk loading, random blocks from a 16 blockstates palette
+    std::vector<unsigned int> palette(1 << BITS_PER_BLOCK);
+    for (size_t i = 0; i < palette.size(); ++i)
+    {
+#if PROTOCOL_VERSION < 347
+        const std::pair<int, unsigned char>& id = blockstate_ids[blockstate_dist(random_gen)];
+        palette[i] = Blockstate::IdMetadataToId(id.first, id.second);
+#else
+        palette[i] = blockstate_ids[blockstate_dist(random_gen)];
+#endif
+    }
+
+    std::vector<std::vector<unsigned char> > chunks_data(NUM_CHUNKS);
+    for (int i = 0; i < NUM_CHUNKS; ++i)
+    {
+        chunks_data[i] = EncodeChunk(palette, random_gen);
+    }
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NUM_CHUNKS; ++i)
+    {
+        Chunk chunk;
+#if PROTOCOL_VERSION < 552
+        chunk.LoadChunkData(chunks_data[i], 0xFFFF, true);
+#elif PROTOCOL_VERSION < 755
+        chunk.LoadChunkData(chunks_data[i], 0xFFFF);
+#else
+        chunk.LoadChunkData(chunks_data[i], { 0xFFFF });
+#endif
+        checksum += reinterpret_cast<size_t>(chunk.GetBlock(Position(0, 0, 0)));
+    }
+    const double chunk_time = ElapsedSeconds(start);
+
+    std::cout << "Chunk loading: " << NUM_CHUNKS / chunk_time << " chunks/s ("
+        << NUM_CHUNKS * static_cast<double>(CHUNK_HEIGHT * CHUNK_WIDTH * CHUNK_WIDTH) / chunk_time / 1e6 << " M blocks/s)" << std::endl;
+
+    std::cout << "Checksum: " << checksum << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,380 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <set>
+#include <memory>
+
+#include "botcraft/AI/BehaviourTree.hpp"
+#include "botcraft/AI/Blackboard.hpp"
+#include "botcraft/Game/Vector3.hpp"
+#include "botcraft/Game/Enums.hpp"
+
+#include "CustomBehaviourTree.hpp"
+
+using namespace Botcraft;
+
+// Measure the ticks per second of a tree of 80 leaves reading
+// and writing blackboard entries, walking the nodes with name
+// lookups (the original API), walking the nodes with
+// BlackboardSlot, and ticking the compiled tree with BlackboardSlot.
+//
+// Then tick the MapCreator example tree, walking the nodes and
+// compiled. Its real leaves can't run here: LoadNBT needs a
+// structure file, CheckCompletion and FindNextTask scan the world
+// sent by a server, and the eat and inventory leaves wait for the
+// server to answer. The tree is built with the same composites,
+// decorators (including the example RepeatUntilSuccess), sub trees
+// and names, and each leaf is replaced by a stub doing the same
+// blackboard accesses as the real one. The stubs follow the path of
+// a bot placing blocks: structure loaded, not completed, not hungry,
+// blocks in inventory and a task found and executed at each tick
+
+namespace
+{
+    const int NUM_GROUPS = 16;
+    const int NUM_TICKS = 500000;
+
+    double ElapsedSeconds(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    struct Context
+    {
+        Blackboard blackboard;
+#if USE_BEHAVIOUR_PROFILING
+        BehaviourProfiler profiler;
+        BehaviourProfiler& GetBehaviourProfiler() { return profiler; }
+#endif
+    };
+
+    Status IncrementKey(Context& context, const std::string& key)
+    {
+        const int value = context.blackboard.Get<int>(key, 0);
+        context.blackboard.Set(key, value + 1);
+        return value % 3 == 0 ? Status::Failure : Status::Success;
+    }
+
+    Status CheckKey(Context& context, const std::string& key)
+    {
+        return context.blackboard.Get<int>(key) % 2 == 0 ? Status::Success : Status::Failure;
+    }
+
+    Status IncrementSlot(Context& context, const BlackboardSlot<int> slot)
+    {
+        const int value = context.blackboard.Get<int>(slot, 0);
+        context.blackboard.Set(slot, value + 1);
+        return value % 3 == 0 ? Status::Failure : Status::Success;
+    }
+
+    Status CheckSlot(Context& context, const BlackboardSlot<int> slot)
+    {
+        return context.blackboard.Get<int>(slot) % 2 == 0 ? Status::Success : Status::Failure;
+    }
+
+    // Each group is a selector of a sequence (increment, check) and
+    // an inverted check, all groups are in a root sequence of succeeders
+    std::shared_ptr<BehaviourTree<Context> > CreateTree(const bool use_slots)
+    {
+        Builder<Context> builder;
+        CompositeBuilder<Builder<Context>, Context> root = builder.sequence();
+        for (int i = 0; i < NUM_GROUPS; ++i)
+        {
+            const std::string key = "Benchmark.value_" + std::to_string(i);
+            if (use_slots)
+            {
+                const BlackboardSlot<int> slot(key);
+                root.succeeder().selector()
+                        .sequence()
+                            .leaf(IncrementSlot, slot)
+                            .leaf(CheckSlot, slot)
+                        .end()
+                        .inverter().leaf(CheckSlot, slot).end()
+                        .leaf(IncrementSlot, slot)
+                    .end()
+                .end();
+            }
+            else
+            {
+                root.succeeder().selector()
+                        .sequence()
+                            .leaf(IncrementKey, key)
+                            .leaf(CheckKey, key)
+                        .end()
+                        .inverter().leaf(CheckKey, key).end()
+                        .leaf(IncrementKey, key)
+                    .end()
+                .end();
+            }
+        }
+        return builder.build();
+    }
+
+    Status CheckBlackboardBoolData(Context& context, const std::string& key)
+    {
+        return context.blackboard.Get(key, false) ? Status::Success : Status::Failure;
+    }
+
+    Status LoadNBT(Context& context, const std::string&, const Position&, const std::string&, const bool)
+    {
+        context.blackboard.Set("Structure.loaded", true);
+        return Status::Success;
+    }
+
+    Status CheckCompletion(Context& context)
+    {
+        static const BlackboardSlot<bool> print_details_slot("CheckCompletion.print_details");
+        static const BlackboardSlot<bool> print_errors_slot("CheckCompletion.print_errors");
+        const bool print_details = context.blackboard.Get(print_details_slot, false);
+        const bool print_errors = context.blackboard.Get(print_errors_slot, false);
+        context.blackboard.Set(print_details_slot, false);
+        context.blackboard.Set(print_errors_slot, false);
+        // Not completed yet
+        return print_details && print_errors ? Status::Success : Status::Failure;
+    }
+
+    Status WarnConsole(Context&, const std::string&)
+    {
+        return Status::Success;
+    }
+
+    // Only reached when a leaf fails, which never happens with these stubs
+    Status Unreachable(Context&)
+    {
+        return Status::Failure;
+    }
+
+    Status IsHungry(Context&)
+    {
+        return Status::Failure;
+    }
+
+    Status ItemLeaf(Context&, const std::string&)
+    {
+        return Status::Failure;
+    }
+
+    Status SetItemInHand(Context&, const std::string&, const Hand)
+    {
+        return Status::Failure;
+    }
+
+    Status Eat(Context&, const std::string&, const bool)
+    {
+        return Status::Failure;
+    }
+
+    Status SwapChestsInventory(Context&, const std::string&, const bool)
+    {
+        return Status::Failure;
+    }
+
+    Status GetBlocksAvailableInInventory(Context& context)
+    {
+        static const std::vector<std::string> inventory = { "minecraft:white_wool", "minecraft:black_wool", "minecraft:red_wool", "minecraft:stone" };
+        std::set<std::string> blocks_in_inventory;
+        for (size_t i = 0; i < inventory.size(); ++i)
+        {
+            blocks_in_inventory.insert(inventory[i]);
+        }
+        context.blackboard.Set("Inventory.block_list", blocks_in_inventory);
+        return Status::Success;
+    }
+
+    Status FindNextTask(Context& context)
+    {
+        static const BlackboardSlot<std::set<std::string> > available_slot("Inventory.block_list");
+        const std::set<std::string>& available = context.blackboard.Get(available_slot);
+        context.blackboard.Set<std::string>("NextTask.action", "Place");
+        context.blackboard.Set("NextTask.block_position", Position(static_cast<int>(available.size()), 64, 0));
+        context.blackboard.Set("NextTask.face", PlayerDiggingFace::Top);
+        context.blackboard.Set("NextTask.item", *available.begin());
+        return Status::Success;
+    }
+
+    Status ExecuteNextTask(Context& context)
+    {
+        const std::string& action = context.blackboard.Get<std::string>("NextTask.action");
+        const Position& block_position = context.blackboard.Get<Position>("NextTask.block_position");
+        const PlayerDiggingFace face = context.blackboard.Get<PlayerDiggingFace>("NextTask.face");
+        const std::string& item_name = context.blackboard.Get<std::string>("NextTask.item");
+        return !action.empty() && block_position.y == 64 && face == PlayerDiggingFace::Top && !item_name.empty() ? Status::Success : Status::Failure;
+    }
+
+    // Same structure as GenerateMapArtCreatorTree in the MapCreator example
+    std::shared_ptr<BehaviourTree<Context> > CreateMapCreatorTree()
+    {
+        const std::string food_name = "minecraft:golden_carrot";
+
+        auto loading_tree = Builder<Context>()
+            .selector()
+                .leaf(CheckBlackboardBoolData, "Structure.loaded")
+                .leaf("LoadNBT", LoadNBT, "", Position(0, 0, 0), "minecraft:slime_block", false)
+            .end()
+            .build();
+
+        auto completion_tree = Builder<Context>()
+            .succeeder()
+                .sequence()
+                    .leaf("CheckCompletion", CheckCompletion)
+                    .leaf(WarnConsole, "Task fully completed!")
+                    .repeater(0)
+                        .inverter()
+                            .leaf(Unreachable)
+                        .end()
+                    .end()
+                .end()
+            .end()
+            .build();
+
+        auto disconnect_subtree = Builder<Context>()
+            .sequence()
+                .leaf(Unreachable)
+                .repeater(0)
+                    .inverter()
+                        .leaf(Unreachable)
+                    .end()
+                .end()
+            .end()
+            .build();
+
+        auto eat_subtree = Builder<Context>()
+            .selector()
+                .inverter()
+                    .leaf(IsHungry)
+                .end()
+                .sequence()
+                    .selector()
+                        .leaf(SetItemInHand, food_name, Hand::Left)
+                        .sequence()
+                            .leaf(ItemLeaf, food_name)
+                            .leaf(SetItemInHand, food_name, Hand::Left)
+                        .end()
+                        .leaf(WarnConsole, "Can't find food anywhere!")
+                    .end()
+                    .selector()
+                        .leaf("Eat", Eat, food_name, true)
+                        .inverter()
+                            .leaf(WarnConsole, "Can't eat!")
+                        .end()
+                        .tree(disconnect_subtree)
+                    .end()
+                .end()
+            .end()
+            .build();
+
+        auto getinventory_tree = Builder<Context>()
+            .selector()
+                .leaf(GetBlocksAvailableInInventory)
+                .sequence()
+                    .selector()
+                        .leaf("SwapChestsInventory", SwapChestsInventory, food_name, true)
+                        .inverter()
+                            .leaf(WarnConsole, "Can't swap with chests, will wait before retrying.")
+                        .end()
+                        .inverter()
+                            .repeater(100)
+                                .leaf(Unreachable)
+                            .end()
+                        .end()
+                    .end()
+                    .selector()
+                        .leaf(GetBlocksAvailableInInventory)
+                        .inverter()
+                            .leaf(WarnConsole, "No more block in chests, I will stop here.")
+                        .end()
+                        .tree(disconnect_subtree)
+                    .end()
+                .end()
+            .end()
+            .build();
+
+        auto placeblock_tree = Builder<Context>()
+            .selector()
+                .decorator<RepeatUntilSuccess<Context> >(5)
+                    .selector()
+                        .sequence()
+                            .leaf("FindNextTask", FindNextTask)
+                            .leaf("ExecuteNextTask", ExecuteNextTask)
+                        .end()
+                        .inverter()
+                            .repeater(100)
+                                .leaf(Unreachable)
+                            .end()
+                        .end()
+                    .end()
+                .end()
+                .leaf("SwapChestsInventory", SwapChestsInventory, food_name, false)
+            .end()
+            .build();
+
+        return Builder<Context>()
+            .sequence()
+                .tree(loading_tree)
+                .tree(completion_tree)
+                .tree(eat_subtree)
+                .tree(getinventory_tree)
+                .tree(placeblock_tree)
+            .end()
+            .build();
+    }
+
+    unsigned long long int RunMapCreator(const std::string& name, const BehaviourTree<Context>& tree)
+    {
+        Context context;
+        unsigned long long int checksum = 0;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < NUM_TICKS; ++i)
+        {
+            checksum += tree.Tick(context) == Status::Success;
+        }
+        const double elapsed = ElapsedSeconds(start);
+        std::cout << name << ": " << NUM_TICKS / elapsed / 1e3 << " k ticks/s" << std::endl;
+
+        return checksum;
+    }
+
+    unsigned long long int Run(const std::string& name, const BehaviourTree<Context>& tree)
+    {
+        Context context;
+        unsigned long long int checksum = 0;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < NUM_TICKS; ++i)
+        {
+            checksum += tree.Tick(context) == Status::Success;
+        }
+        const double elapsed = ElapsedSeconds(start);
+        std::cout << name << ": " << NUM_TICKS / elapsed / 1e3 << " k ticks/s" << std::endl;
+
+        for (int i = 0; i < NUM_GROUPS; ++i)
+        {
+            checksum += context.blackboard.Get<int>("Benchmark.value_" + std::to_string(i));
+        }
+        return checksum;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned long long int checksum = 0;
+
+    std::shared_ptr<BehaviourTree<Context> > key_tree = CreateTree(false);
+    checksum += Run("Nodes, names", *key_tree);
+
+    std::shared_ptr<BehaviourTree<Context> > slot_tree = CreateTree(true);
+    checksum += Run("Nodes, slots", *slot_tree);
+
+    slot_tree->Compile();
+    checksum += Run("Compiled, slots", *slot_tree);
+
+    std::shared_ptr<BehaviourTree<Context> > map_creator_tree = CreateMapCreatorTree();
+    checksum += RunMapCreator("MapCreator, nodes", *map_creator_tree);
+
+    map_creator_tree->Compile();
+    checksum += RunMapCreator("MapCreator, compiled", *map_creator_tree);
+
+    std::cout << "Checksum: " << checksum << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,345 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <ctime>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <string>
+
+#include "botcraft/AI/BehaviourTree.hpp"
+#include "botcraft/AI/BehaviourWorkerPool.hpp"
+#include "botcraft/AI/TemplatedBehaviourClient.hpp"
+#include "botcraft/Network/NetworkManager.hpp"
+#include "botcraft/Utilities/Fiber.hpp"
+#include "botcraft/Utilities/Signal.hpp"
+
+using namespace Botcraft;
+
+// Run 1000 behaviour clients with a one leaf tree, first with
+// BehaviourExecutionMode::Thread and one loop stepping all of them
+// every 10 ms, like the MapCreator example, then with
+// BehaviourExecutionMode::WorkerPool. For both, measure the ticks per
+// second actually performed (each client should tick every 10 ms),
+// the CPU time used and the memory per bot.
+// Then run 300 clients waiting for a signal that is never notified,
+// in both modes, and measure the process CPU time over a fixed window.
+// Then run 1000 bare fibers in the BehaviourWorkerPool, park them all,
+// like bots waiting for a signal, and check they cost nothing until
+// woken up. Also measure the raw cost of a Resume/Suspend
+
+namespace
+{
+    const int NUM_BOTS = 1000;
+    const int NUM_IDLE_BOTS = 300;
+    const int DURATION_S = 5;
+
+    double ElapsedSeconds(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Resident memory of the process in kB, -1 if not available
+    long long int GetResidentMemory()
+    {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line))
+        {
+            if (line.rfind("VmRSS:", 0) == 0)
+            {
+                return std::stoll(line.substr(6));
+            }
+        }
+        return -1;
+    }
+
+    struct Bot
+    {
+        std::unique_ptr<Fiber> fiber;
+        unsigned long long int counter;
+    };
+
+    // A behaviour client counting its ticks. Its network manager
+    // is always in Play state, so the tree runs without a server
+    class CountingClient : public TemplatedBehaviourClient<CountingClient>
+    {
+    public:
+        CountingClient() : TemplatedBehaviourClient<CountingClient>(false)
+        {
+            network_manager = std::shared_ptr<NetworkManager>(new NetworkManager(ProtocolCraft::ConnectionState::Play));
+            num_ticks = 0;
+        }
+
+        std::atomic<unsigned long long int> num_ticks;
+    };
+
+    Status CountTick(CountingClient& c)
+    {
+        c.num_ticks += 1;
+        return Status::Success;
+    }
+
+    // Never notified during the measure, like a bot waiting
+    // for a block change that doesn't happen
+    Signal idle_signal;
+
+    // Count the condition checks, done once per wake up
+    Status WaitIdle(CountingClient& c)
+    {
+        return c.WaitFor([&c]() { c.num_ticks += 1; return false; }, { &idle_signal }, -1) ? Status::Success : Status::Failure;
+    }
+
+    unsigned long long int GetNumTicks(const std::vector<std::unique_ptr<CountingClient> >& clients)
+    {
+        unsigned long long int output = 0;
+        for (size_t i = 0; i < clients.size(); ++i)
+        {
+            output += clients[i]->num_ticks;
+        }
+        return output;
+    }
+
+    // In Thread mode, one loop steps all the clients every 10 ms.
+    // In WorkerPool mode, the pool does it on its own
+    void RunFor(const std::vector<std::unique_ptr<CountingClient> >& clients, const BehaviourExecutionMode mode,
+        const std::chrono::steady_clock::duration& duration)
+    {
+        const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + duration;
+        if (mode == BehaviourExecutionMode::WorkerPool)
+        {
+            std::this_thread::sleep_until(end);
+            return;
+        }
+        while (std::chrono::steady_clock::now() < end)
+        {
+            const std::chrono::steady_clock::time_point next_step = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+            for (size_t i = 0; i < clients.size(); ++i)
+            {
+                clients[i]->BehaviourStep();
+            }
+            std::this_thread::sleep_until(next_step);
+        }
+    }
+
+    void CloseAll(std::vector<std::unique_ptr<CountingClient> >& clients)
+    {
+        // Close them all first, so they stop in parallel
+        for (size_t i = 0; i < clients.size(); ++i)
+        {
+            clients[i]->SetShouldBeClosed(true);
+        }
+        clients.clear();
+    }
+
+    unsigned long long int RunClients(const std::string& name, const BehaviourExecutionMode mode)
+    {
+        const std::shared_ptr<BehaviourTree<CountingClient> > tree = Builder<CountingClient>()
+            .leaf(CountTick)
+            .build();
+
+        const long long int memory_before = GetResidentMemory();
+        std::vector<std::unique_ptr<CountingClient> > clients(NUM_BOTS);
+        for (int i = 0; i < NUM_BOTS; ++i)
+        {
+            clients[i] = std::unique_ptr<CountingClient>(new CountingClient());
+            clients[i]->StartBehaviour(mode);
+            clients[i]->SetBehaviourTree(tree);
+        }
+
+        // Let the trees be swapped in and the workers spread the jobs
+        RunFor(clients, mode, std::chrono::seconds(1));
+        const long long int memory_after = GetResidentMemory();
+
+        const unsigned long long int ticks_before = GetNumTicks(clients);
+        const std::clock_t cpu_start = std::clock();
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        RunFor(clients, mode, std::chrono::seconds(DURATION_S));
+        const double elapsed = ElapsedSeconds(start);
+        const double cpu = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+        const unsigned long long int ticks = GetNumTicks(clients) - ticks_before;
+
+        const std::chrono::steady_clock::time_point stop_start = std::chrono::steady_clock::now();
+        CloseAll(clients);
+        const double stop_time = ElapsedSeconds(stop_start);
+
+        std::cout << name << ":" << std::endl;
+        std::cout << "\tTicks: " << ticks / elapsed << " ticks/s (expected " << NUM_BOTS * 100 << ")" << std::endl;
+        std::cout << "\tCPU: " << 100.0 * cpu / elapsed << "% of a core" << std::endl;
+        if (memory_before >= 0 && memory_after >= 0)
+        {
+            std::cout << "\tMemory: " << (memory_after - memory_before) / 1024.0 << " MB for " << NUM_BOTS << " bots ("
+                << static_cast<double>(memory_after - memory_before) / NUM_BOTS << " kB/bot)" << std::endl;
+        }
+        else
+        {
+            std::cout << "\tMemory: n/a" << std::endl;
+        }
+        std::cout << "\tStop all: " << stop_time * 1000.0 << " ms" << std::endl;
+
+        return ticks;
+    }
+
+    unsigned long long int RunIdleClients(const std::string& name, const BehaviourExecutionMode mode)
+    {
+        const std::shared_ptr<BehaviourTree<CountingClient> > tree = Builder<CountingClient>()
+            .leaf(WaitIdle)
+            .build();
+
+        std::vector<std::unique_ptr<CountingClient> > clients(NUM_IDLE_BOTS);
+        for (int i = 0; i < NUM_IDLE_BOTS; ++i)
+        {
+            clients[i] = std::unique_ptr<CountingClient>(new CountingClient());
+            clients[i]->StartBehaviour(mode);
+            clients[i]->SetBehaviourTree(tree);
+        }
+
+        // Let all the trees start waiting
+        RunFor(clients, mode, std::chrono::seconds(1));
+
+        const std::clock_t cpu_start = std::clock();
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        RunFor(clients, mode, std::chrono::seconds(DURATION_S));
+        const double elapsed = ElapsedSeconds(start);
+        const double cpu = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+        // One notification must make them all check their condition again
+        const unsigned long long int ticks_before = GetNumTicks(clients);
+        const std::chrono::steady_clock::time_point wake_start = std::chrono::steady_clock::now();
+        idle_signal.Notify();
+        while (GetNumTicks(clients) - ticks_before < NUM_IDLE_BOTS && ElapsedSeconds(wake_start) < 1.0)
+        {
+            RunFor(clients, mode, std::chrono::milliseconds(1));
+        }
+        const double wake_time = ElapsedSeconds(wake_start);
+        const unsigned long long int woken = GetNumTicks(clients) - ticks_before;
+
+        CloseAll(clients);
+
+        std::cout << name << ":" << std::endl;
+        std::cout << "\tCPU: " << 100.0 * cpu / elapsed << "% of a core (" << cpu * 1000.0 << " ms in " << elapsed << " s)" << std::endl;
+        std::cout << "\tWoken: " << woken << "/" << NUM_IDLE_BOTS << " in " << wake_time * 1000.0 << " ms" << std::endl;
+
+        return woken;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::atomic<bool> stop(false);
+    std::atomic<bool> park(false);
+    unsigned long long int checksum = 0;
+
+    // Raw Resume/Suspend cost
+    {
+        Bot bot;
+        bot.counter = 0;
+        bot.fiber = std::unique_ptr<Fiber>(new Fiber([&bot, &stop]()
+            {
+                while (!stop)
+                {
+                    bot.counter += 1;
+                    bot.fiber->Suspend();
+                }
+            }));
+        const int num_resumes = 1000000;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_resumes; ++i)
+        {
+            bot.fiber->Resume();
+        }
+        std::cout << "Resume + Suspend: " << ElapsedSeconds(start) * 1e9 / num_resumes << " ns" << std::endl;
+        stop = true;
+        bot.fiber->Resume();
+        checksum += bot.counter;
+        stop = false;
+    }
+
+    std::cout << "Workers: " << std::max(1u, std::thread::hardware_concurrency()) << std::endl;
+    checksum += RunClients("Clients, thread per bot", BehaviourExecutionMode::Thread);
+    checksum += RunClients("Clients, worker pool", BehaviourExecutionMode::WorkerPool);
+    checksum += RunIdleClients("Idle clients, thread per bot", BehaviourExecutionMode::Thread);
+    checksum += RunIdleClients("Idle clients, worker pool", BehaviourExecutionMode::WorkerPool);
+
+    const long long int memory_before = GetResidentMemory();
+
+    std::vector<Bot> bots(NUM_BOTS);
+    std::vector<size_t> ids(NUM_BOTS);
+    for (int i = 0; i < NUM_BOTS; ++i)
+    {
+        Bot& bot = bots[i];
+        bot.counter = 0;
+        bot.fiber = std::unique_ptr<Fiber>(new Fiber([&bot, &stop]()
+            {
+                while (!stop)
+                {
+                    bot.counter += 1;
+                    bot.fiber->Suspend();
+                }
+            }));
+    }
+    for (int i = 0; i < NUM_BOTS; ++i)
+    {
+        Bot& bot = bots[i];
+        ids[i] = BehaviourWorkerPool::getInstance().Add([&bot, &park](std::chrono::steady_clock::time_point& next_step)
+            {
+                bot.fiber->Resume();
+                // Like a bot waiting for a signal
+                if (park)
+                {
+                    next_step = std::chrono::steady_clock::time_point::max();
+                }
+                return !bot.fiber->IsFinished();
+            });
+    }
+
+    // Let the workers start and spread the jobs
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    const long long int memory_after = GetResidentMemory();
+
+    const unsigned long long int steps_before = BehaviourWorkerPool::getInstance().GetNumSteps();
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::seconds(DURATION_S));
+    const double elapsed = ElapsedSeconds(start);
+    const unsigned long long int steps = BehaviourWorkerPool::getInstance().GetNumSteps() - steps_before;
+
+    // Park all the bots, they should not be stepped anymore
+    park = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const unsigned long long int parked_steps_before = BehaviourWorkerPool::getInstance().GetNumSteps();
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    const unsigned long long int parked_steps = BehaviourWorkerPool::getInstance().GetNumSteps() - parked_steps_before;
+
+    // Wake them all up to stop them
+    stop = true;
+    const std::chrono::steady_clock::time_point stop_start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NUM_BOTS; ++i)
+    {
+        BehaviourWorkerPool::getInstance().Wake(ids[i]);
+    }
+    for (int i = 0; i < NUM_BOTS; ++i)
+    {
+        BehaviourWorkerPool::getInstance().Wait(ids[i]);
+        checksum += bots[i].counter;
+    }
+    const double stop_time = ElapsedSeconds(stop_start);
+
+    std::cout << "Fibers:" << std::endl;
+    std::cout << "\tSteps: " << steps / elapsed << " steps/s (expected " << NUM_BOTS * 100 << ")" << std::endl;
+    if (memory_before >= 0 && memory_after >= 0)
+    {
+        std::cout << "\tMemory: " << (memory_after - memory_before) / 1024.0 << " MB for " << NUM_BOTS << " bots ("
+            << static_cast<double>(memory_after - memory_before) / NUM_BOTS << " kB/bot)" << std::endl;
+    }
+    else
+    {
+        std::cout << "\tMemory: n/a" << std::endl;
+    }
+    std::cout << "\tParked: " << parked_steps << " steps/s" << std::endl;
+    std::cout << "\tWake and stop all: " << stop_time * 1000.0 << " ms" << std::endl;
+
+    std::cout << "Checksum: " << checksum << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,227 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <random>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <map>
+#include <set>
+
+#include "botcraft/AI/BuildCoordinator.hpp"
+#include "botcraft/Game/AssetsManager.hpp"
+#include "botcraft/Game/World/World.hpp"
+#include "botcraft/Game/World/StructureDiff.hpp"
+
+using namespace Botcraft;
+
+// Build a 128x128 map art (stone and dirt on a stone floor, one wrong
+// block out of seven already there) in an in-process World.
+// First measure the initial StructureDiff of the whole structure and
+// the nearest remaining block queries. Then build it with an increasing
+// number of bots, one thread each, all sharing one BuildCoordinator:
+// each bot leases a job, applies it in the world right away and
+// releases it, until nothing remains. Measure the time to build the
+// whole structure, the mean AcquireJob time, and count the jobs given
+// to a bot while another one was working on the same block
+
+namespace
+{
+    const int SIZE = 128;
+    const int FLOOR_Y = 9;
+    const int NUM_QUERIES = 10000;
+
+    double ElapsedSeconds(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void SetBlock(World& world, const Position& pos, const std::string& name)
+    {
+#if PROTOCOL_VERSION < 347
+        const std::pair<int, unsigned char> id = AssetsManager::getInstance().GetBlockstateID(name);
+        world.SetBlock(pos, id.first, id.second);
+#else
+        world.SetBlock(pos, AssetsManager::getInstance().GetBlockstateID(name));
+#endif
+    }
+
+    std::shared_ptr<World> CreateWorld()
+    {
+        std::shared_ptr<World> world = std::make_shared<World>(false);
+        for (int x = 0; x < SIZE / CHUNK_WIDTH; ++x)
+        {
+            for (int z = 0; z < SIZE / CHUNK_WIDTH; ++z)
+            {
+#if PROTOCOL_VERSION < 719
+                world->AddChunk(x, z, Dimension::Overworld);
+#else
+                world->AddChunk(x, z, "minecraft:overworld");
+#endif
+            }
+        }
+        for (int x = 0; x < SIZE; ++x)
+        {
+            for (int z = 0; z < SIZE; ++z)
+            {
+                SetBlock(*world, Position(x, FLOOR_Y, z), "minecraft:stone");
+                if ((x * SIZE + z) % 7 == 0)
+                {
+                    SetBlock(*world, Position(x, FLOOR_Y + 1, z), "minecraft:glass");
+                }
+            }
+        }
+        return world;
+    }
+
+    void CreatePlan(std::vector<std::vector<std::vector<short> > >& target, std::map<short, std::string>& palette)
+    {
+        palette[0] = "minecraft:stone";
+        palette[1] = "minecraft:dirt";
+        target = std::vector<std::vector<std::vector<short> > >(SIZE, std::vector<std::vector<short> >(2, std::vector<short>(SIZE, -1)));
+        for (int x = 0; x < SIZE; ++x)
+        {
+            for (int z = 0; z < SIZE; ++z)
+            {
+                target[x][0][z] = ((x / 8) + (z / 8)) % 2;
+            }
+        }
+    }
+
+    void BuildWithBots(const int num_bots, unsigned long long int& checksum)
+    {
+        std::shared_ptr<World> world = CreateWorld();
+        std::vector<std::vector<std::vector<short> > > target;
+        std::map<short, std::string> palette;
+        CreatePlan(target, palette);
+
+        BuildCoordinator coordinator;
+        coordinator.SetPlan(Position(0, FLOOR_Y + 1, 0), Position(SIZE - 1, FLOOR_Y + 2, SIZE - 1), target, palette);
+        std::shared_ptr<StructureDiff> diff = coordinator.GetDiff();
+        diff->Watch(world);
+        const size_t num_remaining = diff->GetNumRemaining();
+
+        const std::set<std::string> items = { "minecraft:stone", "minecraft:dirt" };
+        std::vector<std::atomic<bool> > working(SIZE * SIZE);
+        for (size_t i = 0; i < working.size(); ++i)
+        {
+            working[i] = false;
+        }
+        std::atomic<int> num_jobs(0);
+        std::atomic<int> num_conflicts(0);
+        std::atomic<long long int> acquire_ns(0);
+        std::atomic<int> num_acquire(0);
+
+        std::mt19937 random_gen(42);
+        std::uniform_real_distribution<double> position_dist(0.0, SIZE);
+        std::vector<Vector3<double> > positions(num_bots);
+        for (int i = 0; i < num_bots; ++i)
+        {
+            positions[i] = Vector3<double>(position_dist(random_gen), FLOOR_Y + 2.0, position_dist(random_gen));
+        }
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::vector<std::thread> bots;
+        for (int i = 0; i < num_bots; ++i)
+        {
+            bots.push_back(std::thread([&, i]()
+                {
+                    const std::string name = "Bot_" + std::to_string(i);
+                    Vector3<double> position = positions[i];
+                    BuildJob job;
+                    while (diff->GetNumRemaining() > 0)
+                    {
+                        const std::chrono::steady_clock::time_point acquire_start = std::chrono::steady_clock::now();
+                        const bool has_job = coordinator.AcquireJob(name, world, position, items, job);
+                        acquire_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - acquire_start).count();
+                        num_acquire += 1;
+                        if (!has_job)
+                        {
+                            // Everything left is leased by other bots
+                            std::this_thread::yield();
+                            continue;
+                        }
+
+                        std::atomic<bool>& block_working = working[job.position.x * SIZE + job.position.z];
+                        if (block_working.exchange(true))
+                        {
+                            num_conflicts += 1;
+                        }
+                        {
+                            std::lock_guard<std::mutex> world_guard(world->GetMutex());
+                            SetBlock(*world, job.position, job.action == BuildJobAction::Dig ? "minecraft:air" : job.item);
+                        }
+                        block_working = false;
+                        num_jobs += 1;
+                        position = Vector3<double>(job.position.x + 0.5, job.position.y + 1.0, job.position.z + 0.5);
+                        coordinator.ReleaseJob(name, true);
+                    }
+                }));
+        }
+        for (size_t i = 0; i < bots.size(); ++i)
+        {
+            bots[i].join();
+        }
+        const double build_time = ElapsedSeconds(start);
+
+        std::cout << num_bots << " bots:" << std::endl;
+        std::cout << "\tBuild time: " << build_time * 1e3 << " ms for " << num_jobs << " jobs (" << num_remaining << " blocks remaining at start)" << std::endl;
+        std::cout << "\tJobs: " << num_jobs / build_time << " per second" << std::endl;
+        std::cout << "\tAcquireJob: " << acquire_ns / 1e3 / std::max(1, num_acquire.load()) << " us (" << num_acquire << " calls)" << std::endl;
+        std::cout << "\tSame block jobs: " << num_conflicts << std::endl;
+        checksum += num_jobs + diff->GetNumRemaining();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // Load the assets before measuring anything
+    AssetsManager::getInstance();
+
+    unsigned long long int checksum = 0;
+
+    {
+        std::shared_ptr<World> world = CreateWorld();
+        std::vector<std::vector<std::vector<short> > > target;
+        std::map<short, std::string> palette;
+        CreatePlan(target, palette);
+
+        StructureDiff diff(Position(0, FLOOR_Y + 1, 0), Position(SIZE - 1, FLOOR_Y + 2, SIZE - 1), target, palette);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        diff.Watch(world);
+        diff.Update();
+        const double diff_time = ElapsedSeconds(start);
+        checksum += diff.GetNumRemaining();
+
+        std::mt19937 random_gen(42);
+        std::uniform_real_distribution<double> position_dist(0.0, SIZE);
+        std::vector<Vector3<double> > positions(NUM_QUERIES);
+        for (int i = 0; i < NUM_QUERIES; ++i)
+        {
+            positions[i] = Vector3<double>(position_dist(random_gen), FLOOR_Y + 2.0, position_dist(random_gen));
+        }
+        Position nearest;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < NUM_QUERIES; ++i)
+        {
+            diff.GetNearestRemaining(positions[i], nearest);
+            checksum += nearest.x + nearest.z;
+        }
+        const double nearest_time = ElapsedSeconds(start);
+
+        std::cout << SIZE << "x2x" << SIZE << " structure:" << std::endl;
+        std::cout << "\tInitial diff: " << diff_time * 1e3 << " ms" << std::endl;
+        std::cout << "\tNearest remaining: " << nearest_time * 1e6 / NUM_QUERIES << " us" << std::endl;
+    }
+
+    const std::vector<int> num_bots = { 1, 10, 50, 100, 1000 };
+    for (size_t i = 0; i < num_bots.size(); ++i)
+    {
+        BuildWithBots(num_bots[i], checksum);
+    }
+
+    std::cout << "Checksum: " << checksum << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,238 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+
+#include "botcraft/Game/AssetsManager.hpp"
+#include "botcraft/Game/World/World.hpp"
+#include "botcraft/Renderer/Atlas.hpp"
+#include "botcraft/Renderer/ChunkMesher.hpp"
+#include "botcraft/Renderer/SectionVisibility.hpp"
+
+using namespace Botcraft;
+using namespace Botcraft::Renderer;
+
+// Measure how many sections and faces are culled by the occlusion
+// culling of the renderer. Solid stone with cave tunnels is meshed with
+// ChunkMesher to get the visibility of each section, then the sections
+// seen from a camera in a cave and from a camera above the ground are
+// searched with GetVisibleSections. The frustum is not used, so only
+// the sections hidden by opaque blocks are culled
+
+namespace
+{
+    // Chunks are loaded from -RADIUS to RADIUS, only the
+    // inner ones are meshed so they all have their neighbours
+    const int RADIUS = 6;
+    const int GROUND_LEVEL = 64;
+    const int NUM_WORMS = 16;
+    const int NUM_SEARCHES = 20;
+
+    double ElapsedSeconds(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    struct BlockId
+    {
+        int id;
+        unsigned char metadata;
+    };
+
+    const BlockId GetBlockId(const std::string& name)
+    {
+        BlockId output;
+#if PROTOCOL_VERSION < 347
+        const std::pair<int, unsigned char> id = AssetsManager::getInstance().GetBlockstateID(name);
+        output.id = id.first;
+        output.metadata = id.second;
+#else
+        output.id = AssetsManager::getInstance().GetBlockstateID(name);
+        output.metadata = 0;
+#endif
+        return output;
+    }
+
+    void SetBlock(World& world, const Position& pos, const BlockId& block)
+    {
+#if PROTOCOL_VERSION < 347
+        world.SetBlock(pos, block.id, block.metadata);
+#else
+        world.SetBlock(pos, block.id);
+#endif
+    }
+
+    unsigned int random_state = 2024;
+    double Random()
+    {
+        random_state = random_state * 1664525u + 1013904223u;
+        return (random_state >> 8) / static_cast<double>(1 << 24);
+    }
+
+    // Stone up to the ground level, with tunnels dug by random walks.
+    // Returns the position of a block in the first tunnel
+    const Position GenerateCaves(World& world)
+    {
+        const BlockId stone = GetBlockId("minecraft:stone");
+        const BlockId grass = GetBlockId("minecraft:grass_block");
+        const BlockId air = GetBlockId("minecraft:air");
+
+        for (int x = -RADIUS; x <= RADIUS; ++x)
+        {
+            for (int z = -RADIUS; z <= RADIUS; ++z)
+            {
+#if PROTOCOL_VERSION < 719
+                world.AddChunk(x, z, Dimension::Overworld);
+#else
+                world.AddChunk(x, z, "minecraft:overworld");
+#endif
+            }
+        }
+
+        for (int x = -RADIUS * CHUNK_WIDTH; x < (RADIUS + 1) * CHUNK_WIDTH; ++x)
+        {
+            for (int z = -RADIUS * CHUNK_WIDTH; z < (RADIUS + 1) * CHUNK_WIDTH; ++z)
+            {
+                for (int y = 0; y <= GROUND_LEVEL; ++y)
+                {
+                    SetBlock(world, Position(x, y, z), y == GROUND_LEVEL ? grass : stone);
+                }
+            }
+        }
+
+        Position camera;
+        for (int i = 0; i < NUM_WORMS; ++i)
+        {
+            // The first one starts near the center, where the camera is
+            const double spread = i == 0 ? CHUNK_WIDTH : 2.0 * RADIUS * CHUNK_WIDTH;
+            double x = (Random() - 0.5) * spread;
+            double y = 12.0 + Random() * 40.0;
+            double z = (Random() - 0.5) * spread;
+            double yaw = Random() * 6.283;
+            if (i == 0)
+            {
+                camera = Position(static_cast<int>(std::floor(x)), static_cast<int>(std::floor(y)), static_cast<int>(std::floor(z)));
+            }
+            for (int step = 0; step < 150; ++step)
+            {
+                for (int dx = -2; dx <= 2; ++dx)
+                {
+                    for (int dy = -1; dy <= 2; ++dy)
+                    {
+                        for (int dz = -2; dz <= 2; ++dz)
+                        {
+                            const Position pos(static_cast<int>(std::floor(x)) + dx, static_cast<int>(std::floor(y)) + dy, static_cast<int>(std::floor(z)) + dz);
+                            // Nothing is set outside of the loaded chunks
+                            if (pos.y > 2 && pos.y < GROUND_LEVEL - 4)
+                            {
+                                SetBlock(world, pos, air);
+                            }
+                        }
+                    }
+                }
+                yaw += (Random() - 0.5) * 0.6;
+                x += std::cos(yaw);
+                z += std::sin(yaw);
+                y += (Random() - 0.5) * 0.8;
+            }
+        }
+        return camera;
+    }
+
+    unsigned long long int Run(const std::string& name, const Position& camera_block,
+        const std::unordered_map<Position, SectionVisibility>& visibilities,
+        const std::unordered_map<Position, unsigned int>& section_faces,
+        const Position& min_section, const Position& max_section)
+    {
+        const Position camera_section(
+            static_cast<int>(std::floor(camera_block.x / static_cast<double>(CHUNK_WIDTH))),
+            static_cast<int>(std::floor(camera_block.y / static_cast<double>(CHUNK_WIDTH))),
+            static_cast<int>(std::floor(camera_block.z / static_cast<double>(CHUNK_WIDTH))));
+
+        std::unordered_set<Position> visible_sections;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < NUM_SEARCHES; ++i)
+        {
+            GetVisibleSections(camera_section, visibilities, min_section, max_section,
+                [](const Position&) { return true; }, visible_sections);
+        }
+        const double search_time = ElapsedSeconds(start) / NUM_SEARCHES;
+
+        size_t num_faces = 0;
+        size_t num_visible_faces = 0;
+        size_t num_visible_sections = 0;
+        for (auto it = section_faces.begin(); it != section_faces.end(); ++it)
+        {
+            num_faces += it->second;
+            if (visible_sections.find(it->first) != visible_sections.end())
+            {
+                num_visible_faces += it->second;
+                num_visible_sections += 1;
+            }
+        }
+
+        std::cout << name << " (camera section " << camera_section.x << ", " << camera_section.y << ", " << camera_section.z << "):" << std::endl;
+        std::cout << "\tSections with faces: " << num_visible_sections << " visible / " << section_faces.size()
+            << " (" << 100.0 * (section_faces.size() - num_visible_sections) / section_faces.size() << "% culled)" << std::endl;
+        std::cout << "\tFaces: " << num_visible_faces << " visible / " << num_faces
+            << " (" << 100.0 * (num_faces - num_visible_faces) / num_faces << "% culled)" << std::endl;
+        std::cout << "\tSearch: " << search_time * 1e3 << " ms" << std::endl;
+
+        return num_visible_faces + num_visible_sections;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::shared_ptr<Atlas> atlas = std::make_shared<Atlas>();
+    atlas->LoadData(AssetsManager::getInstance().GetTexturesPathsNames());
+
+    ChunkMesher mesher(atlas, CHUNK_WIDTH);
+
+    World world(false);
+    std::lock_guard<std::mutex> world_guard(world.GetMutex());
+    const Position cave_camera = GenerateCaves(world);
+
+    // Same visibility map as WorldRenderer, fully connected sections are not stored
+    std::unordered_map<Position, SectionVisibility> visibilities;
+    std::unordered_map<Position, unsigned int> section_faces;
+    SectionMesh mesh;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int x = -RADIUS + 1; x < RADIUS; ++x)
+    {
+        for (int z = -RADIUS + 1; z < RADIUS; ++z)
+        {
+            const std::shared_ptr<const Chunk> chunk = world.GetChunkCopy(x, z);
+            for (int y = 0; y < mesher.GetNumSections(); ++y)
+            {
+                mesher.MeshSection(chunk.get(), x, z, y, mesh);
+                const Position section(x, y, z);
+                if (!mesh.visibility.IsFullyConnected())
+                {
+                    visibilities[section] = mesh.visibility;
+                }
+                const unsigned int num_faces = static_cast<unsigned int>(mesh.opaque_faces.size() + mesh.transparent_faces.size());
+                if (num_faces > 0)
+                {
+                    section_faces[section] = num_faces;
+                }
+            }
+        }
+    }
+    std::cout << "Meshed " << (2 * RADIUS - 1) * (2 * RADIUS - 1) * mesher.GetNumSections() << " sections in "
+        << ElapsedSeconds(start) * 1e3 << " ms, " << visibilities.size() << " not fully connected" << std::endl;
+
+    const Position min_section(-RADIUS + 1, 0, -RADIUS + 1);
+    const Position max_section(RADIUS - 1, mesher.GetNumSections() - 1, RADIUS - 1);
+    unsigned long long int checksum = Run("In a cave", cave_camera, visibilities, section_faces, min_section, max_section);
+    checksum += Run("Above the ground", Position(0, GROUND_LEVEL + 20, 0), visibilities, section_faces, min_section, max_section);
+
+    std::cout << "Checksum: " << checksum << std::endl;
+
+    return 0;
+}
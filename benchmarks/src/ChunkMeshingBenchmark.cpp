@@ -0,0 +1,257 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <memory>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include "botcraft/Game/AssetsManager.hpp"
+#include "botcraft/Game/World/World.hpp"
+#include "botcraft/Renderer/Atlas.hpp"
+#include "botcraft/Renderer/ChunkMesher.hpp"
+
+using namespace Botcraft;
+using namespace Botcraft::Renderer;
+
+// Mesh the sections of synthetic chunks with ChunkMesher::MeshSection
+// and report the faces produced per second, on one thread and on all
+// the hardware threads, like the meshing workers of the RenderingManager.
+// Then the same sections are meshed with greedy meshing and with lower
+// levels of detail (cells of 2x2x2 and 4x4x4 blocks), to compare the
+// number of faces and the meshing time with and without merging.
+// Two worlds are meshed: hills of stone, dirt and grass with water
+// up to the sea level, and a worst case of randomly placed stone
+// blocks, where most of the faces are visible
+
+namespace
+{
+    // Chunks are loaded from -RADIUS to RADIUS, only the inner
+    // ones are meshed so they all have their neighbours' borders
+    const int RADIUS = 2;
+    const int SEA_LEVEL = 62;
+    const int NUM_REPEATS = 5;
+
+    double ElapsedSeconds(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    struct BlockId
+    {
+        int id;
+        unsigned char metadata;
+    };
+
+    const BlockId GetBlockId(const std::string& name)
+    {
+        BlockId output;
+#if PROTOCOL_VERSION < 347
+        const std::pair<int, unsigned char> id = AssetsManager::getInstance().GetBlockstateID(name);
+        output.id = id.first;
+        output.metadata = id.second;
+#else
+        output.id = AssetsManager::getInstance().GetBlockstateID(name);
+        output.metadata = 0;
+#endif
+        return output;
+    }
+
+    void SetBlock(World& world, const Position& pos, const BlockId& block)
+    {
+#if PROTOCOL_VERSION < 347
+        world.SetBlock(pos, block.id, block.metadata);
+#else
+        world.SetBlock(pos, block.id);
+#endif
+    }
+
+    void AddChunks(World& world)
+    {
+        for (int x = -RADIUS; x <= RADIUS; ++x)
+        {
+            for (int z = -RADIUS; z <= RADIUS; ++z)
+            {
+#if PROTOCOL_VERSION < 719
+                world.AddChunk(x, z, Dimension::Overworld);
+#else
+                world.AddChunk(x, z, "minecraft:overworld");
+#endif
+            }
+        }
+    }
+
+    void GenerateHills(World& world)
+    {
+        const BlockId stone = GetBlockId("minecraft:stone");
+        const BlockId dirt = GetBlockId("minecraft:dirt");
+        const BlockId grass = GetBlockId("minecraft:grass_block");
+        const BlockId sand = GetBlockId("minecraft:sand");
+        const BlockId water = GetBlockId("minecraft:water");
+
+        for (int x = -RADIUS * CHUNK_WIDTH; x < (RADIUS + 1) * CHUNK_WIDTH; ++x)
+        {
+            for (int z = -RADIUS * CHUNK_WIDTH; z < (RADIUS + 1) * CHUNK_WIDTH; ++z)
+            {
+                const int height = static_cast<int>(60.0 + 6.0 * std::sin(x * 0.15) + 5.0 * std::cos(z * 0.11) + 3.0 * std::sin((x + z) * 0.3));
+                for (int y = 0; y <= std::max(height, SEA_LEVEL); ++y)
+                {
+                    const Position pos(x, y, z);
+                    if (y > height)
+                    {
+                        SetBlock(world, pos, water);
+                    }
+                    else if (y == height)
+                    {
+                        SetBlock(world, pos, height <= SEA_LEVEL + 1 ? sand : grass);
+                    }
+                    else if (y > height - 4)
+                    {
+                        SetBlock(world, pos, dirt);
+                    }
+                    else
+                    {
+                        SetBlock(world, pos, stone);
+                    }
+                }
+            }
+        }
+    }
+
+    void GenerateNoise(World& world)
+    {
+        const BlockId stone = GetBlockId("minecraft:stone");
+        unsigned int random = 42;
+        for (int x = -RADIUS * CHUNK_WIDTH; x < (RADIUS + 1) * CHUNK_WIDTH; ++x)
+        {
+            for (int z = -RADIUS * CHUNK_WIDTH; z < (RADIUS + 1) * CHUNK_WIDTH; ++z)
+            {
+                for (int y = 0; y < 64; ++y)
+                {
+                    random = random * 1664525u + 1013904223u;
+                    if ((random >> 16) % 2 == 0)
+                    {
+                        SetBlock(world, Position(x, y, z), stone);
+                    }
+                }
+            }
+        }
+    }
+
+    struct MeshingJob
+    {
+        std::shared_ptr<const Chunk> chunk;
+        int x;
+        int z;
+        int section_y;
+    };
+
+    // Mesh all the jobs NUM_REPEATS times with num_threads threads, at this level of detail
+    unsigned long long int Run(const std::string& name, const ChunkMesher& mesher, const std::vector<MeshingJob>& jobs, const unsigned int num_threads, const int lod = 0)
+    {
+        std::atomic<size_t> next_job(0);
+        std::atomic<unsigned long long int> num_faces(0);
+        std::atomic<unsigned long long int> num_block_faces(0);
+        const size_t num_jobs = jobs.size() * NUM_REPEATS;
+
+        auto mesh_jobs = [&]()
+        {
+            SectionMesh mesh;
+            unsigned long long int faces = 0;
+            unsigned long long int block_faces = 0;
+            for (size_t i = next_job++; i < num_jobs; i = next_job++)
+            {
+                const MeshingJob& job = jobs[i % jobs.size()];
+                mesher.MeshSection(job.chunk.get(), job.x, job.z, job.section_y, mesh, lod);
+                faces += mesh.opaque_faces.size() + mesh.transparent_faces.size();
+                block_faces += mesh.num_block_faces;
+            }
+            num_faces += faces;
+            num_block_faces += block_faces;
+        };
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for (unsigned int i = 1; i < num_threads; ++i)
+        {
+            threads.push_back(std::thread(mesh_jobs));
+        }
+        mesh_jobs();
+        for (size_t i = 0; i < threads.size(); ++i)
+        {
+            threads[i].join();
+        }
+        const double elapsed = ElapsedSeconds(start);
+
+        std::cout << "\t" << name << ", " << num_threads << " thread(s): "
+            << num_jobs / elapsed << " sections/s (" << elapsed * 1e6 / num_jobs << " us per section), "
+            << num_faces / elapsed / 1e6 << " M faces/s, "
+            << num_faces / num_jobs << " faces per section ("
+            << num_block_faces / num_jobs << " block faces)" << std::endl;
+        return num_faces + num_block_faces;
+    }
+
+    unsigned long long int RunWorld(const std::string& name, void (*generate)(World&), const ChunkMesher& mesher, const ChunkMesher& greedy_mesher)
+    {
+        World world(false);
+        std::vector<MeshingJob> jobs;
+        {
+            std::lock_guard<std::mutex> world_guard(world.GetMutex());
+            AddChunks(world);
+            generate(world);
+
+            for (int x = -RADIUS + 1; x < RADIUS; ++x)
+            {
+                for (int z = -RADIUS + 1; z < RADIUS; ++z)
+                {
+                    const std::shared_ptr<const Chunk> chunk = world.GetChunkCopy(x, z);
+                    for (int y = 0; y < mesher.GetNumSections(); ++y)
+                    {
+                        jobs.push_back(MeshingJob{ chunk, x, z, y });
+                    }
+                }
+            }
+        }
+
+        std::cout << name << ":" << std::endl;
+        unsigned long long int checksum = Run("Sequential", mesher, jobs, 1);
+        checksum += Run("Parallel", mesher, jobs, std::max(1u, std::thread::hardware_concurrency()));
+        checksum += Run("Greedy", greedy_mesher, jobs, 1);
+        checksum += Run("Lod 1", mesher, jobs, 1, 1);
+        checksum += Run("Lod 2", mesher, jobs, 1, 2);
+        return checksum;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::shared_ptr<Atlas> atlas = std::make_shared<Atlas>();
+    atlas->LoadData(AssetsManager::getInstance().GetTexturesPathsNames());
+
+    ChunkMesher mesher(atlas, CHUNK_WIDTH);
+    ChunkMesher greedy_mesher(atlas, CHUNK_WIDTH, true);
+
+    // Fill the shape tables so the first measures don't include them
+    {
+        World world(false);
+        std::lock_guard<std::mutex> world_guard(world.GetMutex());
+        AddChunks(world);
+        GenerateHills(world);
+        SectionMesh mesh;
+        const std::shared_ptr<const Chunk> chunk = world.GetChunkCopy(0, 0);
+        for (int y = 0; y < mesher.GetNumSections(); ++y)
+        {
+            mesher.MeshSection(chunk.get(), 0, 0, y, mesh);
+            greedy_mesher.MeshSection(chunk.get(), 0, 0, y, mesh);
+        }
+    }
+
+    unsigned long long int checksum = RunWorld("Hills", GenerateHills, mesher, greedy_mesher);
+    checksum += RunWorld("Random blocks", GenerateNoise, mesher, greedy_mesher);
+
+    std::cout << "Checksum: " << checksum << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <random>
+
+#include "botcraft/Game/Entities/Entity.hpp"
+#include "botcraft/Game/Entities/EntityStore.hpp"
+
+using namespace Botcraft;
+
+// Fill an EntityStore with a high number of entities spread over
+// 400x400 blocks, then measure the position updates per second
+// (like entity movement packets) and the time of proximity queries
+// (QueryAABB and QueryRadius) compared to a scan of all the entities
+
+namespace
+{
+    const double AREA_SIZE = 400.0;
+    const int NUM_UPDATES = 2000000;
+    const int NUM_QUERIES = 20000;
+    const double QUERY_RADIUS = 8.0;
+
+    double ElapsedSeconds(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::mt19937 random_gen(42);
+    std::uniform_real_distribution<double> position_dist(0.0, AREA_SIZE);
+    std::uniform_real_distribution<double> move_dist(-0.5, 0.5);
+
+    const std::vector<int> num_entities = { 1000, 5000, 20000 };
+    unsigned long long int checksum = 0;
+    for (int n = 0; n < num_entities.size(); ++n)
+    {
+        EntityStore store;
+        for (int i = 0; i < num_entities[n]; ++i)
+        {
+            std::shared_ptr<Entity> entity = std::make_shared<Entity>();
+            entity->SetEID(i);
+            entity->SetPosition(Vector3<double>(position_dist(random_gen), 64.0, position_dist(random_gen)));
+            store.Add(entity);
+        }
+
+        std::vector<int> ids(NUM_UPDATES);
+        std::vector<Vector3<double> > moves(NUM_UPDATES);
+        std::uniform_int_distribution<int> id_dist(0, num_entities[n] - 1);
+        for (int i = 0; i < NUM_UPDATES; ++i)
+        {
+            ids[i] = id_dist(random_gen);
+            moves[i] = Vector3<double>(move_dist(random_gen), 0.0, move_dist(random_gen));
+        }
+
+        // Position updates, the slot is resolved once per update like in the packet handlers
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < NUM_UPDATES; ++i)
+        {
+            const int slot = store.GetSlot(ids[i]);
+            store.SetPosition(slot, store.GetPosition(slot) + moves[i]);
+        }
+        const double update_time = ElapsedSeconds(start);
+
+        std::vector<Vector3<double> > centers(NUM_QUERIES);
+        for (int i = 0; i < NUM_QUERIES; ++i)
+        {
+            centers[i] = Vector3<double>(position_dist(random_gen), 64.0, position_dist(random_gen));
+        }
+        std::vector<std::shared_ptr<Entity> > found;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < NUM_QUERIES; ++i)
+        {
+            found.clear();
+            store.QueryAABB(AABB(centers[i], Vector3<double>(QUERY_RADIUS, QUERY_RADIUS, QUERY_RADIUS)), found);
+            checksum += found.size();
+        }
+        const double aabb_time = ElapsedSeconds(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < NUM_QUERIES; ++i)
+        {
+            found.clear();
+            store.QueryRadius(centers[i], QUERY_RADIUS, found);
+            checksum += found.size();
+        }
+        const double radius_time = ElapsedSeconds(start);
+
+        // Same radius query, testing all the entities
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < NUM_QUERIES; ++i)
+        {
+            found.clear();
+            const std::vector<std::shared_ptr<Entity> >& all = store.GetAll();
+            for (int j = 0; j < all.size(); ++j)
+            {
+                const Vector3<double> delta = all[j]->GetPosition() - centers[i];
+                if (delta.dot(delta) <= QUERY_RADIUS * QUERY_RADIUS)
+                {
+                    found.push_back(all[j]);
+                }
+            }
+            checksum += found.size();
+        }
+        const double scan_time = ElapsedSeconds(start);
+
+        std::cout << num_entities[n] << " entities:" << std::endl;
+        std::cout << "\tPosition updates: " << NUM_UPDATES / update_time / 1e6 << " M/s" << std::endl;
+        std::cout << "\tQueryAABB: " << aabb_time * 1e6 / NUM_QUERIES << " us" << std::endl;
+        std::cout << "\tQueryRadius: " << radius_time * 1e6 / NUM_QUERIES << " us" << std::endl;
+        std::cout << "\tFull scan: " << scan_time * 1e6 / NUM_QUERIES << " us" << std::endl;
+    }
+
+    std::cout << "Checksum: " << checksum << std::endl;
+
+    return 0;
+}
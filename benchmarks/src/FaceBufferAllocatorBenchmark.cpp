@@ -0,0 +1,202 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#include "botcraft/Renderer/FaceBufferAllocator.hpp"
+#include "botcraft/Renderer/FaceShapeTable.hpp"
+
+using namespace Botcraft::Renderer;
+
+// Simulate the uploads of the rendering sections in the shared face
+// buffer, with the same allocation policy as FaceBuffer::Upload but
+// without OpenGL. A view distance worth of sections is loaded, then
+// each frame a few sections are meshed again after block changes and
+// a row of chunks is streamed in and out, like a player walking.
+// Reported: the bytes of GPU buffer per stored face, the bytes
+// uploaded per frame and the bytes copied when the buffer grows
+
+namespace
+{
+    const int VIEW_DISTANCE = 12;
+    const int NUM_SECTIONS = 16;
+    const int NUM_FRAMES = 2000;
+    const int EDITS_PER_FRAME = 4;
+    // Same initial size as FaceBuffer
+    const unsigned int INITIAL_FACE_CAPACITY = 65536;
+    const size_t FACE_BYTES = sizeof(PackedFace);
+
+    double ElapsedSeconds(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    unsigned int random_state = 12345;
+    unsigned int Random()
+    {
+        random_state = random_state * 1664525u + 1013904223u;
+        return random_state >> 8;
+    }
+
+    // Most faces are around the surface, the
+    // other sections are almost empty caves
+    unsigned int SectionFaces(const int section_y)
+    {
+        if (section_y == 3 || section_y == 4)
+        {
+            return 600 + Random() % 900;
+        }
+        if (section_y < 3)
+        {
+            return 100 + Random() % 400;
+        }
+        return Random() % 20 == 0 ? Random() % 200 : 0;
+    }
+
+    class SimulatedFaceBuffer
+    {
+    public:
+        SimulatedFaceBuffer() : allocator(INITIAL_FACE_CAPACITY)
+        {
+            uploaded_bytes = 0;
+            copied_bytes = 0;
+            num_faces = 0;
+            num_grows = 0;
+        }
+
+        // Same as FaceBuffer::Upload
+        void Upload(const unsigned int faces, const unsigned int previous_faces, FaceAllocation& allocation)
+        {
+            num_faces += faces;
+            num_faces -= previous_faces;
+            if (faces == 0)
+            {
+                allocator.Free(allocation);
+                return;
+            }
+            if (!allocator.Resize(faces, allocation))
+            {
+                const unsigned int capacity = allocator.GetCapacity();
+                copied_bytes += capacity * FACE_BYTES;
+                num_grows += 1;
+                allocator.Grow(capacity + std::max(capacity, 2 * faces + 64));
+                allocator.Allocate(faces, allocation);
+            }
+            uploaded_bytes += faces * FACE_BYTES;
+        }
+
+        FaceBufferAllocator allocator;
+        size_t uploaded_bytes;
+        size_t copied_bytes;
+        size_t num_faces;
+        int num_grows;
+    };
+
+    struct Section
+    {
+        FaceAllocation allocation;
+        unsigned int num_faces;
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    const int width = 2 * VIEW_DISTANCE + 1;
+    // Sections of all the chunks in view, a streamed
+    // row reuses the slots of the row it replaces
+    std::vector<Section> sections(width * width * NUM_SECTIONS);
+    SimulatedFaceBuffer buffer;
+
+    auto load_chunk = [&](const int slot_x, const int slot_z)
+    {
+        for (int y = 0; y < NUM_SECTIONS; ++y)
+        {
+            Section& section = sections[(slot_x * width + slot_z) * NUM_SECTIONS + y];
+            const unsigned int faces = SectionFaces(y);
+            buffer.Upload(faces, section.num_faces, section.allocation);
+            section.num_faces = faces;
+        }
+    };
+    auto unload_chunk = [&](const int slot_x, const int slot_z)
+    {
+        for (int y = 0; y < NUM_SECTIONS; ++y)
+        {
+            Section& section = sections[(slot_x * width + slot_z) * NUM_SECTIONS + y];
+            buffer.Upload(0, section.num_faces, section.allocation);
+            section.num_faces = 0;
+        }
+    };
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int x = 0; x < width; ++x)
+    {
+        for (int z = 0; z < width; ++z)
+        {
+            load_chunk(x, z);
+        }
+    }
+    double elapsed = ElapsedSeconds(start);
+
+    std::cout << "Initial load (" << width * width << " chunks):" << std::endl;
+    std::cout << "\tStored faces: " << buffer.num_faces << std::endl;
+    std::cout << "\tBuffer: " << buffer.allocator.GetCapacity() * FACE_BYTES / 1024 << " KB, "
+        << static_cast<double>(buffer.allocator.GetCapacity() * FACE_BYTES) / buffer.num_faces << " bytes per face ("
+        << FACE_BYTES << " bytes per face stored)" << std::endl;
+    std::cout << "\tUploaded: " << buffer.uploaded_bytes / 1024 << " KB, copied on growth: "
+        << buffer.copied_bytes / 1024 << " KB in " << buffer.num_grows << " grows" << std::endl;
+    std::cout << "\tAllocator time: " << elapsed * 1e3 << " ms" << std::endl;
+
+    buffer.uploaded_bytes = 0;
+    buffer.copied_bytes = 0;
+    buffer.num_grows = 0;
+    std::vector<size_t> frame_bytes;
+    frame_bytes.reserve(NUM_FRAMES);
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < NUM_FRAMES; ++frame)
+    {
+        const size_t frame_start = buffer.uploaded_bytes;
+
+        // A few block changes, the section gains or loses some faces
+        for (int i = 0; i < EDITS_PER_FRAME; ++i)
+        {
+            Section& section = sections[Random() % sections.size()];
+            if (section.num_faces == 0)
+            {
+                continue;
+            }
+            const unsigned int faces = std::max(1, static_cast<int>(section.num_faces) + static_cast<int>(Random() % 13) - 6);
+            buffer.Upload(faces, section.num_faces, section.allocation);
+            section.num_faces = faces;
+        }
+
+        // Every 20 frames, the player crosses a chunk
+        // border: one row is unloaded and another loaded
+        if (frame % 20 == 0)
+        {
+            const int slot_x = (frame / 20) % width;
+            for (int z = 0; z < width; ++z)
+            {
+                unload_chunk(slot_x, z);
+                load_chunk(slot_x, z);
+            }
+        }
+
+        frame_bytes.push_back(buffer.uploaded_bytes - frame_start);
+    }
+    elapsed = ElapsedSeconds(start);
+
+    std::sort(frame_bytes.begin(), frame_bytes.end());
+    std::cout << "Streaming (" << NUM_FRAMES << " frames):" << std::endl;
+    std::cout << "\tStored faces: " << buffer.num_faces << std::endl;
+    std::cout << "\tBuffer: " << buffer.allocator.GetCapacity() * FACE_BYTES / 1024 << " KB, "
+        << static_cast<double>(buffer.allocator.GetCapacity() * FACE_BYTES) / buffer.num_faces << " bytes per face, largest free range "
+        << buffer.allocator.GetLargestFreeRange() * FACE_BYTES / 1024 << " KB" << std::endl;
+    std::cout << "\tUploaded per frame: mean " << buffer.uploaded_bytes / NUM_FRAMES << " bytes, p50 "
+        << frame_bytes[NUM_FRAMES / 2] << " bytes, max " << frame_bytes.back() << " bytes" << std::endl;
+    std::cout << "\tCopied on growth: " << buffer.copied_bytes / 1024 << " KB in " << buffer.num_grows << " grows" << std::endl;
+    std::cout << "\tAllocator time: " << elapsed * 1e6 / NUM_FRAMES << " us per frame" << std::endl;
+
+    std::cout << "Checksum: " << buffer.num_faces + buffer.uploaded_bytes + buffer.allocator.GetCapacity() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <memory>
+#include <string>
+#include <thread>
+#include <algorithm>
+
+#include "botcraft/Game/AssetsManager.hpp"
+#include "botcraft/Game/World/World.hpp"
+#include "botcraft/Renderer/MapRasterizer.hpp"
+
+using namespace Botcraft;
+using namespace Botcraft::Renderer;
+
+// Load 1000 synthetic chunks (hills of grass and sand with water up to
+// the sea level) and measure the first MapRasterizer::Update, scanning
+// all the columns, on one thread and on all the hardware threads. Then
+// measure an Update after random modifications at the surface, which
+// only scans the modified columns, and the time to rasterize the image
+// of all the chunks
+
+namespace
+{
+    const int SIZE_X = 40;
+    const int SIZE_Z = 25;
+    const int SEA_LEVEL = 62;
+    const int NUM_MODIFICATIONS = 1000;
+    const int NUM_REPEATS = 5;
+
+    double ElapsedSeconds(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    struct BlockId
+    {
+        int id;
+        unsigned char metadata;
+    };
+
+    const BlockId GetBlockId(const std::string& name)
+    {
+        BlockId output;
+#if PROTOCOL_VERSION < 347
+        const std::pair<int, unsigned char> id = AssetsManager::getInstance().GetBlockstateID(name);
+        output.id = id.first;
+        output.metadata = id.second;
+#else
+        output.id = AssetsManager::getInstance().GetBlockstateID(name);
+        output.metadata = 0;
+#endif
+        return output;
+    }
+
+    void SetBlock(World& world, const Position& pos, const BlockId& block)
+    {
+#if PROTOCOL_VERSION < 347
+        world.SetBlock(pos, block.id, block.metadata);
+#else
+        world.SetBlock(pos, block.id);
+#endif
+    }
+
+    const int GetHeight(const int x, const int z)
+    {
+        return static_cast<int>(60.0 + 6.0 * std::sin(x * 0.15) + 5.0 * std::cos(z * 0.11) + 3.0 * std::sin((x + z) * 0.3));
+    }
+
+    std::shared_ptr<World> GenerateWorld()
+    {
+        std::shared_ptr<World> world = std::make_shared<World>(false);
+#if PROTOCOL_VERSION < 347
+        const BlockId grass = GetBlockId("minecraft:grass");
+#else
+        const BlockId grass = GetBlockId("minecraft:grass_block");
+#endif
+        const BlockId dirt = GetBlockId("minecraft:dirt");
+        const BlockId sand = GetBlockId("minecraft:sand");
+        const BlockId water = GetBlockId("minecraft:water");
+
+        for (int chunk_x = 0; chunk_x < SIZE_X; ++chunk_x)
+        {
+            for (int chunk_z = 0; chunk_z < SIZE_Z; ++chunk_z)
+            {
+#if PROTOCOL_VERSION < 719
+                world->AddChunk(chunk_x, chunk_z, Dimension::Overworld);
+#else
+                world->AddChunk(chunk_x, chunk_z, "minecraft:overworld");
+#endif
+            }
+        }
+
+        // Only the top of the columns, the blocks below
+        // the surface are never read by the rasterizer
+        for (int x = 0; x < SIZE_X * CHUNK_WIDTH; ++x)
+        {
+            for (int z = 0; z < SIZE_Z * CHUNK_WIDTH; ++z)
+            {
+                const int height = GetHeight(x, z);
+                for (int y = height - 3; y <= std::max(height, SEA_LEVEL); ++y)
+                {
+                    const Position pos(x, y, z);
+                    if (y > height)
+                    {
+                        SetBlock(*world, pos, water);
+                    }
+                    else if (y == height)
+                    {
+                        SetBlock(*world, pos, height <= SEA_LEVEL + 1 ? sand : grass);
+                    }
+                    else
+                    {
+                        SetBlock(*world, pos, dirt);
+                    }
+                }
+            }
+        }
+
+        return world;
+    }
+
+    unsigned long long int Run(const std::shared_ptr<World>& world, const unsigned int num_threads)
+    {
+        const BlockId dirt = GetBlockId("minecraft:dirt");
+        const BlockId air = GetBlockId("minecraft:air");
+        unsigned long long int checksum = 0;
+
+        double full_time = 0.0;
+        double modified_time = 0.0;
+        double rasterize_time = 0.0;
+        int num_scanned = 0;
+        unsigned int random = 42;
+        std::vector<unsigned char> image;
+        for (int i = 0; i < NUM_REPEATS; ++i)
+        {
+            MapRasterizer rasterizer(world, num_threads);
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            checksum += rasterizer.Update();
+            full_time += ElapsedSeconds(start);
+
+            // Add or remove a block at the surface
+            {
+                std::lock_guard<std::mutex> world_guard(world->GetMutex());
+                for (int j = 0; j < NUM_MODIFICATIONS; ++j)
+                {
+                    random = random * 1664525u + 1013904223u;
+                    const int x = (random >> 8) % (SIZE_X * CHUNK_WIDTH);
+                    random = random * 1664525u + 1013904223u;
+                    const int z = (random >> 8) % (SIZE_Z * CHUNK_WIDTH);
+                    const int y = std::max(GetHeight(x, z), SEA_LEVEL) + 1;
+                    SetBlock(*world, Position(x, y, z), i % 2 == 0 ? dirt : air);
+                }
+            }
+            start = std::chrono::steady_clock::now();
+            num_scanned += rasterizer.Update();
+            modified_time += ElapsedSeconds(start);
+
+            start = std::chrono::steady_clock::now();
+            rasterizer.Rasterize(0, 0, SIZE_X - 1, SIZE_Z - 1, image);
+            rasterize_time += ElapsedSeconds(start);
+            for (size_t j = 0; j < image.size(); j += 4 * 97)
+            {
+                checksum += image[j];
+            }
+        }
+
+        std::cout << num_threads << " thread(s):" << std::endl;
+        std::cout << "\tFirst update: " << full_time * 1e3 / NUM_REPEATS << " ms (" << SIZE_X * SIZE_Z << " chunks)" << std::endl;
+        std::cout << "\tUpdate after " << NUM_MODIFICATIONS << " modifications: " << modified_time * 1e3 / NUM_REPEATS << " ms (" << num_scanned / NUM_REPEATS << " chunks scanned)" << std::endl;
+        std::cout << "\tRasterize: " << rasterize_time * 1e3 / NUM_REPEATS << " ms (" << SIZE_X * CHUNK_WIDTH << "x" << SIZE_Z * CHUNK_WIDTH << " pixels)" << std::endl;
+
+        return checksum + num_scanned;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::shared_ptr<World> world = GenerateWorld();
+    std::cout << "World generated in " << ElapsedSeconds(start) << " s" << std::endl;
+
+    unsigned long long int checksum = 0;
+    checksum += Run(world, 1);
+    const unsigned int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    if (num_threads > 1)
+    {
+        checksum += Run(world, num_threads);
+    }
+
+    std::cout << "Checksum: " << checksum << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <thread>
+#include <string>
+
+#include "botcraft/Game/World/Blockstate.hpp"
+
+using namespace Botcraft;
+
+// Measure the cost of Blockstate::GetModelId, which is
+// called for every block by the physics and the renderer,
+// with one thread and with all the hardware threads
+
+namespace
+{
+    const int REGION_SIZE = 128;
+
+    double ElapsedSeconds(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    unsigned long long int ComputeRegion(const Blockstate& blockstate, const int offset)
+    {
+        unsigned long long int checksum = 0;
+        for (int y = 0; y < REGION_SIZE; ++y)
+        {
+            for (int z = 0; z < REGION_SIZE; ++z)
+            {
+                for (int x = 0; x < REGION_SIZE; ++x)
+                {
+                    checksum += blockstate.GetModelId(Position(x + offset, y, z));
+                }
+            }
+        }
+        return checksum;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // Same variants as the stone blockstate
+    const std::vector<Model> models(4);
+    const std::vector<int> weights = { 10, 10, 10, 1 };
+#if PROTOCOL_VERSION < 347
+    const Blockstate blockstate(1, 0, false, true, false, 1.5f, TintType::None, "minecraft:stone", models, weights);
+#else
+    const Blockstate blockstate(1, false, true, false, 1.5f, TintType::None, "minecraft:stone", models, weights);
+#endif
+    const double num_calls = static_cast<double>(REGION_SIZE) * REGION_SIZE * REGION_SIZE;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    unsigned long long int checksum = ComputeRegion(blockstate, 0);
+    std::cout << "GetModelId (1 thread): " << ElapsedSeconds(start) * 1e9 / num_calls << " ns" << std::endl;
+
+    const int num_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned long long int> checksums(num_threads, 0);
+    std::vector<std::thread> threads;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_threads; ++i)
+    {
+        threads.emplace_back([&blockstate, &checksums, i]()
+            {
+                checksums[i] = ComputeRegion(blockstate, i * REGION_SIZE);
+            });
+    }
+    for (int i = 0; i < num_threads; ++i)
+    {
+        threads[i].join();
+        checksum += checksums[i];
+    }
+    const double elapsed = ElapsedSeconds(start);
+    std::cout << "GetModelId (" << num_threads << " threads): " << num_threads * num_calls / elapsed / 1e6 << " M calls/s" << std::endl;
+
+    std::cout << "Checksum: " << checksum << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,243 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+
+#include "botcraft/Game/ManagersClient.hpp"
+#include "botcraft/Game/Entities/EntityManager.hpp"
+#include "botcraft/Game/Entities/LocalPlayer.hpp"
+#include "botcraft/Game/Entities/MovementController.hpp"
+#include "botcraft/Game/World/World.hpp"
+#include "botcraft/Game/AssetsManager.hpp"
+
+#include "protocolCraft/Messages/Play/Clientbound/ClientboundPlayerPositionPacket.hpp"
+
+using namespace Botcraft;
+
+// Measure the jitter of the local player physics ticks (every 50 ms)
+// while another thread streams chunks into the world, like the network
+// thread when joining a server or moving fast. Each streamed chunk is
+// filled block by block with the world mutex locked, then unloaded.
+// The same ticks are measured without the stream as a reference, and
+// the readers of the player state are timed during the stream.
+// Then a straight path is followed by the MovementController, and
+// the achieved speed is compared to the requested one.
+
+namespace
+{
+    const int NUM_TICKS = 200;
+    const int FLOOR_Y = 63;
+    const int STREAMED_HEIGHT = 64;
+
+    double ElapsedSeconds(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Gives access to the physics tick without a connection
+    class PhysicsClient : public ManagersClient
+    {
+    public:
+        PhysicsClient() : ManagersClient(false)
+        {
+            world = std::make_shared<World>(false);
+            entity_manager = std::make_shared<EntityManager>();
+            movement_controller = std::make_shared<MovementController>();
+        }
+
+        using ManagersClient::PhysicsTick;
+    };
+
+    // Follow a straight path on the floor, without waiting between ticks
+    unsigned long long int RunPath(PhysicsClient& client, const double speed, const bool sprint_jump)
+    {
+        std::shared_ptr<MovementController> movement_controller = client.GetMovementController();
+        const Vector3<double> start_position = client.GetEntityManager()->GetLocalPlayer()->GetState().position;
+        const Position start(std::floor(start_position.x), std::floor(start_position.y), std::floor(start_position.z));
+        const int direction = start.x < 0 ? 1 : -1;
+
+        std::vector<Position> path;
+        for (int i = 1; i <= 24; ++i)
+        {
+            path.push_back(start + Position(direction * i, 0, 0));
+        }
+
+        const unsigned int path_id = movement_controller->SetPath(path, speed, sprint_jump);
+        int num_ticks = 0;
+        while (movement_controller->GetStatus(path_id) == MovementStatus::Moving && num_ticks < 1000)
+        {
+            client.PhysicsTick();
+            num_ticks += 1;
+        }
+
+        std::cout << "Path, " << speed << " blocks/s" << (sprint_jump ? ", sprint jump" : "") << ":" << std::endl;
+        std::cout << "\tStatus: " << (movement_controller->GetStatus(path_id) == MovementStatus::Arrived ? "arrived" : "not arrived")
+            << " in " << num_ticks << " ticks" << std::endl;
+        std::cout << "\tAchieved speed: " << movement_controller->GetAchievedSpeed() << " blocks/s" << std::endl;
+        return num_ticks;
+    }
+
+    void AddChunk(World& world, const int x, const int z)
+    {
+#if PROTOCOL_VERSION < 719
+        world.AddChunk(x, z, Dimension::Overworld);
+#else
+        world.AddChunk(x, z, "minecraft:overworld");
+#endif
+    }
+
+    void SetStone(World& world, const Position& pos)
+    {
+#if PROTOCOL_VERSION < 347
+        world.SetBlock(pos, 1, 0);
+#else
+        world.SetBlock(pos, 1);
+#endif
+    }
+
+    double Percentile(std::vector<double> values, const double p)
+    {
+        std::sort(values.begin(), values.end());
+        return values[std::min(values.size() - 1, static_cast<size_t>(p * values.size()))];
+    }
+
+    void Print(const std::string& name, const std::vector<double>& values, const std::string& unit)
+    {
+        std::cout << "\t" << name << ": p50 " << Percentile(values, 0.5) << " " << unit
+            << ", p99 " << Percentile(values, 0.99) << " " << unit
+            << ", max " << Percentile(values, 1.0) << " " << unit << std::endl;
+    }
+
+    // Tick the player for NUM_TICKS, walking back and forth, and
+    // report the tick durations and how late each tick started
+    unsigned long long int RunTicks(PhysicsClient& client, const std::string& name, const bool measure_readers)
+    {
+        std::shared_ptr<LocalPlayer> local_player = client.GetEntityManager()->GetLocalPlayer();
+        std::vector<double> durations;
+        std::vector<double> delays;
+        std::vector<double> reads;
+        unsigned long long int checksum = 0;
+
+        std::chrono::steady_clock::time_point next_tick = std::chrono::steady_clock::now();
+        for (int i = 0; i < NUM_TICKS; ++i)
+        {
+            std::this_thread::sleep_until(next_tick);
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            delays.push_back(std::chrono::duration<double, std::milli>(start - next_tick).count());
+
+            local_player->PushMovementCommand(MovementCommand{ MovementCommandType::AddSpeed,
+                Vector3<double>((i / 20) % 2 == 0 ? 0.2 : -0.2, 0.0, 0.0), false, 0 });
+            checksum += client.PhysicsTick();
+            durations.push_back(ElapsedSeconds(start) * 1e3);
+
+            if (measure_readers)
+            {
+                const std::chrono::steady_clock::time_point read_start = std::chrono::steady_clock::now();
+                const LocalPlayerState state = local_player->GetState();
+                reads.push_back(ElapsedSeconds(read_start) * 1e6);
+                checksum += static_cast<unsigned long long int>(state.position.x * 100.0);
+            }
+
+            next_tick += std::chrono::milliseconds(50);
+        }
+
+        std::cout << name << ":" << std::endl;
+        Print("Tick duration", durations, "ms");
+        Print("Tick start delay", delays, "ms");
+        if (measure_readers)
+        {
+            Print("GetState", reads, "us");
+        }
+        return checksum;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    AssetsManager::getInstance();
+
+    PhysicsClient client;
+    std::shared_ptr<World> world = client.GetWorld();
+
+    // Stone floor around the player
+    {
+        std::lock_guard<std::mutex> world_guard(world->GetMutex());
+        for (int x = -2; x < 2; ++x)
+        {
+            for (int z = -2; z < 2; ++z)
+            {
+                AddChunk(*world, x, z);
+            }
+        }
+        for (int x = -32; x < 32; ++x)
+        {
+            for (int z = -32; z < 32; ++z)
+            {
+                SetStone(*world, Position(x, FLOOR_Y, z));
+            }
+        }
+    }
+
+    // Spawn, as sent by the server
+    ProtocolCraft::ClientboundPlayerPositionPacket spawn;
+    spawn.SetX(0.5);
+    spawn.SetY(FLOOR_Y + 1.0);
+    spawn.SetZ(0.5);
+    spawn.SetYRot(0.0f);
+    spawn.SetXRot(0.0f);
+    spawn.SetRelativeArguments(0);
+    spawn.Dispatch(client.GetEntityManager().get());
+
+    unsigned long long int checksum = RunTicks(client, "Idle world", false);
+
+    std::atomic<bool> stop(false);
+    std::atomic<int> num_streamed(0);
+    std::thread stream_thread([&]()
+        {
+            int i = 0;
+            while (!stop)
+            {
+                const int x = 8 + (i % 16);
+                const int z = 8 + (i / 16) % 16;
+                {
+                    std::lock_guard<std::mutex> world_guard(world->GetMutex());
+                    AddChunk(*world, x, z);
+                    for (int y = 0; y < STREAMED_HEIGHT; ++y)
+                    {
+                        for (int bx = 0; bx < CHUNK_WIDTH; ++bx)
+                        {
+                            for (int bz = 0; bz < CHUNK_WIDTH; ++bz)
+                            {
+                                SetStone(*world, Position(x * CHUNK_WIDTH + bx, y, z * CHUNK_WIDTH + bz));
+                            }
+                        }
+                    }
+                }
+                {
+                    std::lock_guard<std::mutex> world_guard(world->GetMutex());
+                    world->RemoveChunk(x, z);
+                }
+                num_streamed += 1;
+                i += 1;
+            }
+        });
+
+    const std::chrono::steady_clock::time_point stream_start = std::chrono::steady_clock::now();
+    checksum += RunTicks(client, "Chunk stream", true);
+    const double stream_time = ElapsedSeconds(stream_start);
+    stop = true;
+    stream_thread.join();
+    std::cout << "\tStreamed: " << num_streamed / stream_time << " chunks/s" << std::endl;
+
+    checksum += RunPath(client, 4.317, false);
+    checksum += RunPath(client, 5.612, false);
+    checksum += RunPath(client, 5.612, true);
+
+    std::cout << "Checksum: " << checksum << std::endl;
+
+    return 0;
+}
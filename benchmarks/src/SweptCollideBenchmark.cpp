@@ -0,0 +1,93 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <random>
+
+#include "botcraft/Game/AABB.hpp"
+
+using namespace Botcraft;
+
+// Compare testing the physics candidate boxes one by one
+// with the scalar AABB::SweptCollide and all at once with
+// the AABBArray version, for several numbers of candidates
+
+namespace
+{
+    const int NUM_SPEEDS = 1024;
+    const long long int NUM_BOX_TESTS = 50000000;
+
+    double ElapsedSeconds(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::mt19937 random_gen(42);
+    std::uniform_real_distribution<double> speed_dist(-1.0, 1.0);
+    std::uniform_int_distribution<int> position_dist(-3, 3);
+
+    const AABB player(Vector3<double>(0.5, 1.9, 0.5), Vector3<double>(0.3, 0.9, 0.3));
+    std::vector<Vector3<double> > speeds(NUM_SPEEDS);
+    for (int i = 0; i < NUM_SPEEDS; ++i)
+    {
+        speeds[i] = Vector3<double>(speed_dist(random_gen), speed_dist(random_gen), speed_dist(random_gen));
+    }
+
+    // Number of candidates for a player standing still, walking,
+    // and moving fast (elytra, knockback...) in a dense area
+    const std::vector<int> num_candidates = { 8, 27, 64, 256 };
+    double checksum = 0.0;
+    for (int n = 0; n < num_candidates.size(); ++n)
+    {
+        std::vector<AABB> boxes;
+        AABBArray boxes_array;
+        while (boxes.size() < num_candidates[n])
+        {
+            const AABB box(Vector3<double>(position_dist(random_gen) + 0.5, position_dist(random_gen) + 0.5, position_dist(random_gen) + 0.5), Vector3<double>(0.5, 0.5, 0.5));
+            if (box.Collide(player))
+            {
+                continue;
+            }
+            boxes.push_back(box);
+            boxes_array.Add(box);
+        }
+
+        const long long int num_iterations = NUM_BOX_TESTS / num_candidates[n];
+        Vector3<double> normal;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (long long int i = 0; i < num_iterations; ++i)
+        {
+            const Vector3<double>& speed = speeds[i % NUM_SPEEDS];
+            double best_time = 1.0;
+            for (int j = 0; j < boxes.size(); ++j)
+            {
+                Vector3<double> current_normal;
+                const double time = player.SweptCollide(speed, boxes[j], current_normal);
+                if (time < best_time)
+                {
+                    best_time = time;
+                    normal = current_normal;
+                }
+            }
+            checksum += best_time;
+        }
+        const double scalar_time = ElapsedSeconds(start);
+
+        start = std::chrono::steady_clock::now();
+        for (long long int i = 0; i < num_iterations; ++i)
+        {
+            checksum += player.SweptCollide(speeds[i % NUM_SPEEDS], boxes_array, normal);
+        }
+        const double array_time = ElapsedSeconds(start);
+
+        std::cout << num_candidates[n] << " boxes: scalar " << scalar_time * 1e9 / num_iterations << " ns, array "
+            << array_time * 1e9 / num_iterations << " ns (" << scalar_time / array_time << "x)" << std::endl;
+    }
+
+    std::cout << "Checksum: " << checksum << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <memory>
+#include <string>
+#include <algorithm>
+
+#include "botcraft/Game/AssetsManager.hpp"
+#include "botcraft/Game/World/World.hpp"
+#include "botcraft/Renderer/Atlas.hpp"
+#include "botcraft/Renderer/ChunkMesher.hpp"
+#include "botcraft/Renderer/FaceSorter.hpp"
+
+using namespace Botcraft;
+using namespace Botcraft::Renderer;
+
+// Measure the time spent each frame sorting the transparent faces of
+// an ocean, the worst case for transparency as the whole surface is
+// water. The ocean is meshed with ChunkMesher at full detail and with
+// a lower level of detail, where the faces are stretched over 2x2x2
+// blocks. Each frame, the camera moves above the surface and the faces
+// of every section are sorted again, like TransparentChunk::Sort does
+
+namespace
+{
+    // Chunks are loaded from -RADIUS to RADIUS, only the
+    // inner ones are meshed so they all have their neighbours
+    const int RADIUS = 8;
+    const int SEA_LEVEL = 62;
+    const int NUM_FRAMES = 100;
+
+    double ElapsedSeconds(const std::chrono::steady_clock::time_point& start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    struct BlockId
+    {
+        int id;
+        unsigned char metadata;
+    };
+
+    const BlockId GetBlockId(const std::string& name)
+    {
+        BlockId output;
+#if PROTOCOL_VERSION < 347
+        const std::pair<int, unsigned char> id = AssetsManager::getInstance().GetBlockstateID(name);
+        output.id = id.first;
+        output.metadata = id.second;
+#else
+        output.id = AssetsManager::getInstance().GetBlockstateID(name);
+        output.metadata = 0;
+#endif
+        return output;
+    }
+
+    void SetBlock(World& world, const Position& pos, const BlockId& block)
+    {
+#if PROTOCOL_VERSION < 347
+        world.SetBlock(pos, block.id, block.metadata);
+#else
+        world.SetBlock(pos, block.id);
+#endif
+    }
+
+    // Sand floor with some islands, water up to the sea level
+    void GenerateOcean(World& world)
+    {
+        const BlockId sand = GetBlockId("minecraft:sand");
+        const BlockId water = GetBlockId("minecraft:water");
+
+        for (int x = -RADIUS; x <= RADIUS; ++x)
+        {
+            for (int z = -RADIUS; z <= RADIUS; ++z)
+            {
+#if PROTOCOL_VERSION < 719
+                world.AddChunk(x, z, Dimension::Overworld);
+#else
+                world.AddChunk(x, z, "minecraft:overworld");
+#endif
+            }
+        }
+
+        for (int x = -RADIUS * CHUNK_WIDTH; x < (RADIUS + 1) * CHUNK_WIDTH; ++x)
+        {
+            for (int z = -RADIUS * CHUNK_WIDTH; z < (RADIUS + 1) * CHUNK_WIDTH; ++z)
+            {
+                const int floor = static_cast<int>(50.0 + 8.0 * std::sin(x * 0.07) * std::cos(z * 0.05) + 6.0 * std::sin((x - z) * 0.13));
+                for (int y = 40; y <= std::max(floor, SEA_LEVEL); ++y)
+                {
+                    SetBlock(world, Position(x, y, z), y > floor ? water : sand);
+                }
+            }
+        }
+    }
+
+    struct SortedSection
+    {
+        std::vector<PackedFace> faces;
+        std::vector<glm::vec3> centers;
+        glm::vec3 origin;
+    };
+
+    unsigned long long int Run(const std::string& name, World& world, const ChunkMesher& mesher, const int lod)
+    {
+        std::vector<glm::vec3> shape_centers;
+        std::vector<SortedSection> sections;
+        SectionMesh mesh;
+        for (int x = -RADIUS + 1; x < RADIUS; ++x)
+        {
+            for (int z = -RADIUS + 1; z < RADIUS; ++z)
+            {
+                const std::shared_ptr<const Chunk> chunk = world.GetChunkCopy(x, z);
+                for (int y = 0; y < mesher.GetNumSections(); ++y)
+                {
+                    mesher.MeshSection(chunk.get(), x, z, y, mesh, lod);
+                    if (mesh.transparent_faces.empty())
+                    {
+                        continue;
+                    }
+                    SortedSection section;
+                    section.faces = mesh.transparent_faces;
+                    // Same as WorldRenderer::GetSectionOrigin
+                    section.origin = glm::vec3(CHUNK_WIDTH * x, static_cast<int>(mesher.GetSectionHeight()) * y, CHUNK_WIDTH * z);
+                    sections.push_back(section);
+                }
+            }
+        }
+        mesher.GetShapes().GetCenters(0, shape_centers);
+
+        size_t num_faces = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < sections.size(); ++i)
+        {
+            FaceSorter::ComputeCenters(sections[i].faces, shape_centers, sections[i].centers);
+            num_faces += sections[i].faces.size();
+        }
+        const double centers_time = ElapsedSeconds(start);
+
+        // One sorter per section, as each TransparentChunk has its own
+        std::vector<FaceSorter> sorters(sections.size());
+        std::vector<double> frame_times;
+        unsigned long long int checksum = 0;
+        for (int frame = 0; frame < NUM_FRAMES; ++frame)
+        {
+            // Fly over the ocean, one block per frame
+            const glm::vec3 cam_pos(frame - NUM_FRAMES / 2.0f, SEA_LEVEL + 4.0f, 0.5f * frame);
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < sections.size(); ++i)
+            {
+                sorters[i].Sort(cam_pos - sections[i].origin, sections[i].faces, sections[i].centers);
+            }
+            frame_times.push_back(ElapsedSeconds(start) * 1e3);
+            checksum += sections[frame % sections.size()].faces[0].position;
+        }
+        std::sort(frame_times.begin(), frame_times.end());
+
+        std::cout << name << ": " << num_faces << " transparent faces in " << sections.size() << " sections" << std::endl;
+        std::cout << "\tCenters: " << centers_time * 1e3 << " ms" << std::endl;
+        std::cout << "\tSort per frame: p50 " << frame_times[NUM_FRAMES / 2] << " ms, max " << frame_times.back() << " ms ("
+            << num_faces / (frame_times[NUM_FRAMES / 2] * 1e3) << " M faces/s)" << std::endl;
+
+        return checksum + num_faces;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::shared_ptr<Atlas> atlas = std::make_shared<Atlas>();
+    atlas->LoadData(AssetsManager::getInstance().GetTexturesPathsNames());
+
+    ChunkMesher mesher(atlas, CHUNK_WIDTH);
+
+    World world(false);
+    std::lock_guard<std::mutex> world_guard(world.GetMutex());
+    GenerateOcean(world);
+
+    unsigned long long int checksum = Run("Ocean, full detail", world, mesher, 0);
+    checksum += Run("Ocean, lod 1", world, mesher, 1);
+
+    std::cout << "Checksum: " << checksum << std::endl;
+
+    return 0;
+}
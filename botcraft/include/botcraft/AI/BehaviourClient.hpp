@@ -1,10 +1,22 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <vector>
+
 #include "botcraft/Game/ManagersClient.hpp"
+#include "botcraft/Game/Vector3.hpp"
 #include "botcraft/AI/Blackboard.hpp"
+#if USE_BEHAVIOUR_PROFILING
+#include "botcraft/AI/BehaviourProfiler.hpp"
+#endif
 
 namespace Botcraft
 {
+    class Signal;
+
     /// @brief A ManagersClient extended with a blackboard that can store any
     /// kind of data and a virtual Yield function.
     /// You should **not** inherit from this class, but from TemplatedBehaviourClient
@@ -17,9 +29,65 @@ namespace Botcraft
 
         virtual void Yield() = 0;
 
+        /// @brief Yield until condition is true. The behaviour is not
+        /// resumed until one of the given signals is notified or
+        /// the timeout expires, so waiting costs nothing in between.
+        /// @param condition Function checking the awaited state
+        /// @param signals Signals notified when the state may have changed
+        /// @param timeout_ms Maximum waiting time, in milliseconds, negative to wait forever
+        /// @return True if the condition is met, false on timeout or if the behaviour is interrupted
+        const bool WaitFor(const std::function<bool()>& condition, const std::vector<const Signal*>& signals, const long long int timeout_ms);
+
+        /// @brief Same as WaitFor, but also resumed when a block in [min, max]
+        /// changes. Changes in other chunks don't wake the behaviour up.
+        /// Must not be called with the world mutex locked.
+        /// @param condition Function checking the awaited state
+        /// @param min Min corner of the watched blocks (included)
+        /// @param max Max corner of the watched blocks (included)
+        /// @param signals Other signals notified when the state may have changed
+        /// @param timeout_ms Maximum waiting time, in milliseconds, negative to wait forever
+        /// @return True if the condition is met, false on timeout or if the behaviour is interrupted
+        const bool WaitForBlocks(const std::function<bool()>& condition, const Position& min, const Position& max,
+            const std::vector<const Signal*>& signals, const long long int timeout_ms);
+
+        /// @brief True if the current tree has to stop, because it
+        /// has been swapped or the client is closing. Nodes are not
+        /// ticked anymore and Yield returns immediately once set.
+        const bool IsBehaviourInterrupted() const;
+
         Blackboard& GetBlackboard();
 
+#if USE_BEHAVIOUR_PROFILING
+        BehaviourProfiler& GetBehaviourProfiler();
+#endif
+
+    protected:
+        /// @brief Check if the behaviour, suspended in WaitFor, has
+        /// something new to check. Always true if not in WaitFor.
+        const bool ShouldResume();
+
+        /// @brief Deadline of the current WaitFor, time_point::min()
+        /// if the behaviour is not waiting
+        const std::chrono::steady_clock::time_point GetWaitDeadline();
+
+        /// @brief Called on the notifying thread when one of the
+        /// signals of the current WaitFor is notified
+        virtual void WakeUp() = 0;
+
     protected:
         Blackboard blackboard;
+        std::atomic<bool> behaviour_interrupted;
+#if USE_BEHAVIOUR_PROFILING
+        BehaviourProfiler behaviour_profiler;
+#endif
+
+    private:
+        const bool WaitForImpl(const std::function<bool()>& condition, const std::vector<const Signal*>& signals, const long long int timeout_ms);
+
+    private:
+        std::mutex wait_mutex;
+        bool is_waiting;
+        std::chrono::steady_clock::time_point wait_deadline;
+        std::vector<std::pair<const Signal*, unsigned long long int> > wait_signals;
     };
 } // namespace Botcraft
@@ -0,0 +1,196 @@
+#pragma once
+
+#if USE_BEHAVIOUR_PROFILING
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+
+namespace Botcraft
+{
+    enum class Status;
+
+    /// @brief Statistics of one node, identified by its path in the tree
+    struct BehaviourNodeStats
+    {
+        /// @brief Names of all the nodes from the root, separated by ';'
+        std::string path;
+        unsigned long long int count;
+        unsigned long long int success;
+        unsigned long long int failure;
+        /// @brief Total time between entering and leaving the node
+        unsigned long long int wall_ns;
+        /// @brief Part of wall_ns spent suspended in Yield
+        unsigned long long int suspended_ns;
+    };
+
+    /// @brief Record all the nodes ticked by one client. Aggregated
+    /// statistics are kept for every node path, and the last events
+    /// are stored in a ring buffer for trace export. All living
+    /// profilers are registered so they can be aggregated/exported
+    /// together. Only available when compiled with USE_BEHAVIOUR_PROFILING.
+    /// The thread ticking the tree only pushes timestamps in a lock free
+    /// queue, they are aggregated when a tick ends if no one is reading
+    /// the stats, or by the reader.
+    class BehaviourProfiler
+    {
+    public:
+        BehaviourProfiler(const size_t ring_buffer_size = 1 << 12, const size_t queue_size = 1 << 12);
+        ~BehaviourProfiler();
+
+        BehaviourProfiler(const BehaviourProfiler&) = delete;
+        BehaviourProfiler& operator=(const BehaviourProfiler&) = delete;
+
+        /// @brief Set the name displayed for this profiler in exports
+        void SetName(const std::string& name_);
+
+        /// @brief Get a unique id for a node name
+        static const unsigned int GetNameId(const std::string& name);
+
+        /// @brief Called by the thread ticking the tree, never blocks
+        void BeginNode(const unsigned int name_id);
+        /// @brief Close the last opened node, never blocks
+        /// @param has_status False if the node was interrupted by an exception
+        void EndNode(const bool has_status, const Status status);
+
+        /// @brief Called by the thread ticking the tree, never blocks
+        void BeginSuspension();
+        /// @brief Called by the thread ticking the tree, never blocks
+        void EndSuspension();
+
+        /// @brief Clear all recorded data
+        void Reset();
+
+        const std::vector<BehaviourNodeStats> GetStats();
+
+        /// @brief Get the stats of all profilers, merged by node path
+        static const std::vector<BehaviourNodeStats> GetAggregatedStats();
+
+        /// @brief Write the events in the ring buffers of all profilers
+        /// in Chrome trace event format (chrome://tracing, Perfetto...)
+        /// @return False if the file can't be written
+        static const bool ExportChromeTrace(const std::string& path);
+
+        /// @brief Write the aggregated stats as folded stacks (one line
+        /// per path followed by the self time in microseconds) to generate
+        /// flame graphs. Time suspended in Yield appears as a [Suspended] frame.
+        /// @return False if the file can't be written
+        static const bool ExportFoldedStacks(const std::string& path);
+
+    private:
+        struct Event
+        {
+            unsigned long long int start_ns;
+            unsigned long long int duration_ns;
+            unsigned long long int suspended_ns;
+            unsigned int name_id;
+            unsigned short depth;
+            // 0 interrupted, 1 success, 2 failure
+            unsigned char status;
+        };
+
+        enum class RawEventType : unsigned char
+        {
+            BeginNode,
+            EndNode,
+            BeginSuspension,
+            EndSuspension
+        };
+
+        // What the ticking thread pushes in the queue
+        struct RawEvent
+        {
+            unsigned long long int time_ns;
+            unsigned int name_id;
+            // Depth of the node, used to resynchronize
+            // after dropped events or a Reset
+            unsigned short depth;
+            RawEventType type;
+            // Same values as Event::status
+            unsigned char status;
+        };
+
+        struct OpenNode
+        {
+            unsigned int path_id;
+            unsigned long long int start_ns;
+            unsigned long long int suspended_at_start;
+        };
+
+        struct PathStats
+        {
+            unsigned int parent;
+            unsigned int name_id;
+            unsigned long long int count;
+            unsigned long long int success;
+            unsigned long long int failure;
+            unsigned long long int wall_ns;
+            unsigned long long int suspended_ns;
+        };
+
+        static const unsigned long long int Now();
+        const std::string GetPath(const unsigned int path_id) const;
+
+        // Producer side, drop the event if the queue is full
+        void Push(const RawEvent& event);
+        // Consumer side, profiler_mutex must be locked
+        void ProcessQueue();
+        void ProcessEvent(const RawEvent& event);
+
+    private:
+        mutable std::mutex profiler_mutex;
+        std::string name;
+
+        // Single producer (ticking thread) single consumer
+        // (whoever holds profiler_mutex) queue
+        std::vector<RawEvent> queue;
+        size_t queue_mask;
+        std::atomic<size_t> queue_head;
+        std::atomic<size_t> queue_tail;
+        // Only used by the ticking thread
+        unsigned short current_depth;
+
+        // Everything below is protected by profiler_mutex
+        std::vector<Event> events;
+        size_t next_event;
+        bool events_wrapped;
+
+        std::vector<OpenNode> stack;
+        // Path 0 is the (empty) root, key is parent << 32 | name_id
+        std::unordered_map<unsigned long long int, unsigned int> path_ids;
+        std::vector<PathStats> paths;
+
+        unsigned long long int total_suspended_ns;
+        unsigned long long int suspension_start;
+    };
+
+    /// @brief RAII helper recording a node while in scope
+    class BehaviourProfilerScope
+    {
+    public:
+        BehaviourProfilerScope(BehaviourProfiler& profiler_, const unsigned int name_id) : profiler(profiler_)
+        {
+            status = Status();
+            has_status = false;
+            profiler.BeginNode(name_id);
+        }
+
+        ~BehaviourProfilerScope()
+        {
+            profiler.EndNode(has_status, status);
+        }
+
+        void SetStatus(const Status status_)
+        {
+            status = status_;
+            has_status = true;
+        }
+
+    private:
+        BehaviourProfiler& profiler;
+        Status status;
+        bool has_status;
+    };
+} // namespace Botcraft
+#endif
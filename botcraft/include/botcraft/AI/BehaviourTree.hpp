@@ -3,6 +3,11 @@
 #include <vector>
 #include <memory>
 #include <functional>
+#include <string>
+#include <typeinfo>
+#include <type_traits>
+
+#include "botcraft/AI/BehaviourProfiler.hpp"
 
 // A behaviour tree implementation following this blog article
 // https://www.gamasutra.com/blogs/ChrisSimpson/20140717/221339/Behavior_trees_for_AI_How_they_work.php
@@ -20,13 +25,74 @@ namespace Botcraft
 		Success
 	};
 
+	namespace Internal
+	{
+		// Contexts with an IsBehaviourInterrupted function can stop
+		// the tree, other contexts are never interrupted
+		template<class Context>
+		auto IsInterrupted(const Context& context, int) -> decltype(context.IsBehaviourInterrupted())
+		{
+			return context.IsBehaviourInterrupted();
+		}
+
+		template<class Context>
+		const bool IsInterrupted(const Context&, long)
+		{
+			return false;
+		}
+	}
+
 	template<class Context>
 	class Node
 	{
 	public:
-		Node() {}
+		Node() { SetName("Node"); }
 		virtual ~Node() {}
 		virtual const Status Tick(Context& context) const = 0;
+
+#if USE_BEHAVIOUR_PROFILING
+		/// @brief Set the name used to identify this node when profiling
+		void SetName(const std::string& name_)
+		{
+			name = name_;
+			profiler_id = BehaviourProfiler::GetNameId(name);
+		}
+
+		const std::string& GetName() const { return name; }
+
+		const unsigned int GetProfilerId() const { return profiler_id; }
+#else
+		/// @brief Names are only used when profiling, no-op otherwise
+		void SetName(const char*) {}
+		void SetName(const std::string&) {}
+#endif
+
+		/// @brief Tick a node, recording it in the context profiler if
+		/// compiled with USE_BEHAVIOUR_PROFILING. Should be used by all
+		/// nodes with children instead of calling child->Tick directly.
+		/// Once the context is interrupted, children are not ticked anymore
+		/// and fail so the whole tree returns.
+		static const Status TickChild(const Node<Context>& child, Context& context)
+		{
+			if (Internal::IsInterrupted(context, 0))
+			{
+				return Status::Failure;
+			}
+#if USE_BEHAVIOUR_PROFILING
+			BehaviourProfilerScope scope(context.GetBehaviourProfiler(), child.GetProfilerId());
+			const Status status = child.Tick(context);
+			scope.SetStatus(status);
+			return status;
+#else
+			return child.Tick(context);
+#endif
+		}
+
+#if USE_BEHAVIOUR_PROFILING
+	private:
+		std::string name;
+		unsigned int profiler_id;
+#endif
 	};
 
 
@@ -42,6 +108,11 @@ namespace Botcraft
 			children.push_back(child);
 		}
 
+		const std::vector<std::shared_ptr<Node<Context>>>& GetChildren() const
+		{
+			return children;
+		}
+
 	protected:
 		std::vector<std::shared_ptr<Node<Context>>> children;
 	};
@@ -58,6 +129,11 @@ namespace Botcraft
 			child = child_;
 		}
 
+		const std::shared_ptr<Node<Context>>& GetChild() const
+		{
+			return child;
+		}
+
 	protected:
 		std::shared_ptr<Node<Context>> child;
 	};
@@ -69,12 +145,14 @@ namespace Botcraft
 		Leaf() = delete;
 		Leaf(const std::function<Status(Context&)>& func_)
 		{
+			this->SetName("Leaf");
 			func = func_;
 		}
 
 		template <class FunctionType, class... Args>
 		Leaf(FunctionType func_, Args... args)
 		{
+			this->SetName("Leaf");
 			func = [=](Context& c) -> Status { return func_(c, (args)...); };
 		}
 
@@ -84,30 +162,38 @@ namespace Botcraft
 			return func(context);
 		}
 
+		const std::function<Status(Context&)>& GetFunction() const
+		{
+			return func;
+		}
+
 	private:
 		std::function<Status(Context&)> func;
 	};
 
+	template<class Context>
+	class CompiledTree;
+
 	template<class Context>
 	class BehaviourTree : public Node<Context>
 	{
 	public:
-		BehaviourTree() { root = nullptr; }
+		BehaviourTree() { this->SetName("Tree"); root = nullptr; }
 		virtual ~BehaviourTree() {}
 
-		void SetRoot(const std::shared_ptr<Node<Context>> node) { root = node; }
+		void SetRoot(const std::shared_ptr<Node<Context>> node) { root = node; compiled = nullptr; }
+		const std::shared_ptr<Node<Context>>& GetRoot() const { return root; }
 
-		virtual const Status Tick(Context& context) const override
-		{
-			if (root == nullptr)
-			{
-				return Status::Failure;
-			}
-			return root->Tick(context);
-		}
+		/// @brief Flatten the current tree into a contiguous array of nodes
+		/// that will be used for all next ticks. Sub trees are copied,
+		/// so later modifications of them won't be seen by this tree.
+		void Compile();
+
+		virtual const Status Tick(Context& context) const override;
 
 	private:
 		std::shared_ptr<Node<Context>> root;
+		std::shared_ptr<const CompiledTree<Context>> compiled;
 	};
 
 	/// @brief Sequence implementation. Run all children until
@@ -118,12 +204,14 @@ namespace Botcraft
 	class Sequence : public Composite<Context>
 	{
 	public:
+		Sequence() { this->SetName("Sequence"); }
+
 		virtual const Status Tick(Context& context) const override
 		{
 			auto it = this->children.begin();
 			while (it != this->children.end())
 			{
-				Status child_status = (*it)->Tick(context);
+				Status child_status = this->TickChild(**it, context);
 				switch (child_status)
 				{
 				case Status::Failure:
@@ -146,12 +234,14 @@ namespace Botcraft
 	class Selector : public Composite<Context>
 	{
 	public:
+		Selector() { this->SetName("Selector"); }
+
 		virtual const Status Tick(Context& context) const override
 		{
 			auto it = this->children.begin();
 			while (it != this->children.end())
 			{
-				Status child_status = (*it)->Tick(context);
+				Status child_status = this->TickChild(**it, context);
 				switch (child_status)
 				{
 				case Status::Failure:
@@ -177,9 +267,11 @@ namespace Botcraft
 	class Inverter : public Decorator<Context>
 	{
 	public:
+		Inverter() { this->SetName("Inverter"); }
+
 		virtual const Status Tick(Context& context) const override
 		{
-			Status child_status = this->child->Tick(context);
+			Status child_status = this->TickChild(*this->child, context);
 
 			switch (child_status)
 			{
@@ -199,9 +291,11 @@ namespace Botcraft
 	class Succeeder : public Decorator<Context>
 	{
 	public:
+		Succeeder() { this->SetName("Succeeder"); }
+
 		virtual const Status Tick(Context& context) const override
 		{
-			Status child_status = this->child->Tick(context);
+			Status child_status = this->TickChild(*this->child, context);
 
 			switch (child_status)
 			{
@@ -223,16 +317,22 @@ namespace Botcraft
 	public:
 		Repeater(const size_t n_)
 		{
+			this->SetName("Repeater");
 			n = n_;
 		}
 
+		const size_t GetN() const
+		{
+			return n;
+		}
+
 		virtual const Status Tick(Context& context) const override
 		{
 			Status child_status = Status::Failure;
 			size_t counter = 0;
-			while ((child_status == Status::Failure && n == 0) || counter < n)
+			while (((child_status == Status::Failure && n == 0) || counter < n) && !Internal::IsInterrupted(context, 0))
 			{
-				child_status = this->child->Tick(context);
+				child_status = this->TickChild(*this->child, context);
 				counter += 1;
 			}
 			return Status::Success;
@@ -244,9 +344,242 @@ namespace Botcraft
 
 
 
+	/// @brief A behaviour tree flattened into a contiguous array
+	/// of nodes in depth-first order. The children of the node i
+	/// start at i + 1 and each node stores the index following its
+	/// subtree, used to jump to the next sibling. Nodes of unknown
+	/// types (custom composites/decorators) are kept as is and
+	/// ticked through their virtual function.
+	/// @tparam Context The tree context type
+	template<class Context>
+	class CompiledTree
+	{
+	public:
+		CompiledTree(const std::shared_ptr<Node<Context>>& root)
+		{
+			if (root != nullptr)
+			{
+				Flatten(root);
+			}
+		}
+
+		const Status Tick(Context& context) const
+		{
+			if (nodes.empty())
+			{
+				return Status::Failure;
+			}
+			return TickNode(0, context);
+		}
+
+	private:
+		// Each node type has its own tick function, nodes
+		// are dispatched through this pointer instead of a
+		// virtual call on a separately allocated object
+		typedef const Status(*TickFunction)(const CompiledTree&, const size_t, Context&);
+
+		struct FlatNode
+		{
+			TickFunction tick;
+			// Index of the first node after this subtree
+			size_t subtree_end;
+			// Leaf or opaque node index, repeater count
+			size_t data;
+#if USE_BEHAVIOUR_PROFILING
+			unsigned int profiler_id;
+#endif
+		};
+
+		void Flatten(std::shared_ptr<Node<Context>> node)
+		{
+			// Sub trees are inlined
+			std::shared_ptr<BehaviourTree<Context>> subtree = std::dynamic_pointer_cast<BehaviourTree<Context>>(node);
+#if USE_BEHAVIOUR_PROFILING
+			// Keep a node for them so the profiled
+			// paths are the same as in the source tree
+			if (subtree != nullptr && subtree->GetRoot() != nullptr)
+			{
+				const size_t index = nodes.size();
+				nodes.push_back(FlatNode{ &TickSubtree, 0, 0, node->GetProfilerId() });
+				Flatten(subtree->GetRoot());
+				nodes[index].subtree_end = nodes.size();
+				return;
+			}
+#else
+			while (subtree != nullptr && subtree->GetRoot() != nullptr)
+			{
+				node = subtree->GetRoot();
+				subtree = std::dynamic_pointer_cast<BehaviourTree<Context>>(node);
+			}
+#endif
+
+			const size_t index = nodes.size();
+			nodes.push_back(FlatNode{ &TickOpaque, 0, 0 });
+#if USE_BEHAVIOUR_PROFILING
+			nodes[index].profiler_id = node->GetProfilerId();
+#endif
+
+			const std::type_info& type = typeid(*node);
+			if (type == typeid(Leaf<Context>))
+			{
+				nodes[index].tick = &TickLeaf;
+				nodes[index].data = leaves.size();
+				leaves.push_back(static_cast<const Leaf<Context>*>(node.get())->GetFunction());
+			}
+			else if (type == typeid(Sequence<Context>) || type == typeid(Selector<Context>))
+			{
+				nodes[index].tick = type == typeid(Sequence<Context>) ? &TickSequence : &TickSelector;
+				for (const auto& child : static_cast<const Composite<Context>*>(node.get())->GetChildren())
+				{
+					Flatten(child);
+				}
+			}
+			else if ((type == typeid(Inverter<Context>) || type == typeid(Succeeder<Context>) || type == typeid(Repeater<Context>))
+				&& static_cast<const Decorator<Context>*>(node.get())->GetChild() != nullptr)
+			{
+				if (type == typeid(Inverter<Context>))
+				{
+					nodes[index].tick = &TickInverter;
+				}
+				else if (type == typeid(Succeeder<Context>))
+				{
+					nodes[index].tick = &TickSucceeder;
+				}
+				else
+				{
+					nodes[index].tick = &TickRepeater;
+					nodes[index].data = static_cast<const Repeater<Context>*>(node.get())->GetN();
+				}
+				Flatten(static_cast<const Decorator<Context>*>(node.get())->GetChild());
+			}
+			else
+			{
+				nodes[index].data = opaques.size();
+				opaques.push_back(node);
+			}
+
+			nodes[index].subtree_end = nodes.size();
+		}
+
+		const Status TickNode(const size_t index, Context& context) const
+		{
+			if (Internal::IsInterrupted(context, 0))
+			{
+				return Status::Failure;
+			}
+#if USE_BEHAVIOUR_PROFILING
+			BehaviourProfilerScope scope(context.GetBehaviourProfiler(), nodes[index].profiler_id);
+			const Status status = nodes[index].tick(*this, index, context);
+			scope.SetStatus(status);
+			return status;
+#else
+			return nodes[index].tick(*this, index, context);
+#endif
+		}
+
+		static const Status TickLeaf(const CompiledTree& tree, const size_t index, Context& context)
+		{
+			return tree.leaves[tree.nodes[index].data](context);
+		}
+
+#if USE_BEHAVIOUR_PROFILING
+		static const Status TickSubtree(const CompiledTree& tree, const size_t index, Context& context)
+		{
+			return tree.TickNode(index + 1, context);
+		}
+#endif
+
+		static const Status TickOpaque(const CompiledTree& tree, const size_t index, Context& context)
+		{
+			return tree.opaques[tree.nodes[index].data]->Tick(context);
+		}
+
+		static const Status TickSequence(const CompiledTree& tree, const size_t index, Context& context)
+		{
+			const size_t end = tree.nodes[index].subtree_end;
+			for (size_t child = index + 1; child < end; child = tree.nodes[child].subtree_end)
+			{
+				if (tree.TickNode(child, context) == Status::Failure)
+				{
+					return Status::Failure;
+				}
+			}
+			return Status::Success;
+		}
+
+		static const Status TickSelector(const CompiledTree& tree, const size_t index, Context& context)
+		{
+			const size_t end = tree.nodes[index].subtree_end;
+			for (size_t child = index + 1; child < end; child = tree.nodes[child].subtree_end)
+			{
+				if (tree.TickNode(child, context) == Status::Success)
+				{
+					return Status::Success;
+				}
+			}
+			return Status::Failure;
+		}
+
+		static const Status TickInverter(const CompiledTree& tree, const size_t index, Context& context)
+		{
+			return tree.TickNode(index + 1, context) == Status::Failure ? Status::Success : Status::Failure;
+		}
+
+		static const Status TickSucceeder(const CompiledTree& tree, const size_t index, Context& context)
+		{
+			tree.TickNode(index + 1, context);
+			return Status::Success;
+		}
+
+		static const Status TickRepeater(const CompiledTree& tree, const size_t index, Context& context)
+		{
+			const size_t n = tree.nodes[index].data;
+			Status child_status = Status::Failure;
+			size_t counter = 0;
+			while (((child_status == Status::Failure && n == 0) || counter < n) && !Internal::IsInterrupted(context, 0))
+			{
+				child_status = tree.TickNode(index + 1, context);
+				counter += 1;
+			}
+			return Status::Success;
+		}
+
+	private:
+		std::vector<FlatNode> nodes;
+		std::vector<std::function<Status(Context&)>> leaves;
+		std::vector<std::shared_ptr<Node<Context>>> opaques;
+	};
+
+	template<class Context>
+	void BehaviourTree<Context>::Compile()
+	{
+		compiled = std::make_shared<const CompiledTree<Context>>(root);
+	}
+
+	template<class Context>
+	const Status BehaviourTree<Context>::Tick(Context& context) const
+	{
+		if (compiled != nullptr)
+		{
+			return compiled->Tick(context);
+		}
+		if (root == nullptr)
+		{
+			return Status::Failure;
+		}
+		return this->TickChild(*root, context);
+	}
+
 
 	// Builder implementation for easy tree building
 
+	// True if the first argument is a name for the leaf
+	template <class... Args>
+	struct IsNamedLeaf : std::false_type {};
+
+	template <class First, class... Args>
+	struct IsNamedLeaf<First, Args...> : std::is_convertible<First, std::string> {};
+
 	template <class Parent, class Context>
 	class DecoratorBuilder;
 
@@ -257,7 +590,7 @@ namespace Botcraft
 		CompositeBuilder(Parent* parent, Composite<Context>* node) : parent(parent), node(node) {}
 
 		// To add a leaf
-		template <class... Args>
+		template <class... Args, typename std::enable_if<!IsNamedLeaf<Args...>::value, int>::type = 0>
 		CompositeBuilder leaf(Args... args)
 		{
 			auto child = std::make_shared<Leaf<Context> >((args)...);
@@ -265,6 +598,18 @@ namespace Botcraft
 			return *this;
 		}
 
+		// To add a leaf with a name (displayed when profiling)
+		// Name is a template so literals are not converted
+		// to std::string when profiling is disabled
+		template <class Name, class... Args, typename std::enable_if<IsNamedLeaf<Name>::value, int>::type = 0>
+		CompositeBuilder leaf(const Name& name, Args... args)
+		{
+			auto child = std::make_shared<Leaf<Context> >((args)...);
+			child->SetName(name);
+			node->AddChild(child);
+			return *this;
+		}
+
 		// To add a tree
 		CompositeBuilder tree(std::shared_ptr<BehaviourTree<Context> > arg)
 		{
@@ -350,7 +695,7 @@ namespace Botcraft
 		DecoratorBuilder(Parent* parent, Decorator<Context>* node) : parent(parent), node(node) {}
 
 		// To add a leaf
-		template <typename... Args>
+		template <typename... Args, typename std::enable_if<!IsNamedLeaf<Args...>::value, int>::type = 0>
 		DecoratorBuilder leaf(Args... args)
 		{
 			auto child = std::make_shared<Leaf<Context> >((args)...);
@@ -358,6 +703,16 @@ namespace Botcraft
 			return *this;
 		}
 
+		// To add a leaf with a name (displayed when profiling)
+		template <typename Name, typename... Args, typename std::enable_if<IsNamedLeaf<Name>::value, int>::type = 0>
+		DecoratorBuilder leaf(const Name& name, Args... args)
+		{
+			auto child = std::make_shared<Leaf<Context> >((args)...);
+			child->SetName(name);
+			node->SetChild(child);
+			return *this;
+		}
+
 		// To add a tree
 		DecoratorBuilder tree(std::shared_ptr<BehaviourTree<Context> > arg)
 		{
@@ -442,13 +797,21 @@ namespace Botcraft
 	class Builder
 	{
 	public:
-		template <typename... Args>
+		template <typename... Args, typename std::enable_if<!IsNamedLeaf<Args...>::value, int>::type = 0>
 		Builder leaf(Args... args)
 		{
 			root = std::make_shared<Leaf<Context> >((args)...);
 			return *this;
 		}
 
+		template <typename Name, typename... Args, typename std::enable_if<IsNamedLeaf<Name>::value, int>::type = 0>
+		Builder leaf(const Name& name, Args... args)
+		{
+			root = std::make_shared<Leaf<Context> >((args)...);
+			root->SetName(name);
+			return *this;
+		}
+
 		// I'm not sure why someone would add a tree as the root of a tree but...
 		Builder tree(std::shared_ptr<BehaviourTree<Context> > arg)
 		{
@@ -517,6 +880,13 @@ namespace Botcraft
 			return tree;
 		}
 
+		std::shared_ptr<BehaviourTree<Context> > build(const std::string& name)
+		{
+			auto tree = build();
+			tree->SetName(name);
+			return tree;
+		}
+
 	private:
 		std::shared_ptr<Node<Context> > root;
 	};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <set>
+#include <vector>
+#include <memory>
+
+namespace Botcraft
+{
+    /// @brief A small pool of threads shared by all the behaviour
+    /// clients of the process running in BehaviourExecutionMode::WorkerPool.
+    /// Each registered step function is called every 10 ms, by only one
+    /// worker at a time. Each worker has its own queue, idle workers
+    /// steal the late jobs of the others that have never been stepped.
+    /// A worker with nothing due sleeps until its next deadline, or
+    /// until a job is added or woken up.
+    /// Once stepped, a job stays on the same worker: the fiber it resumes
+    /// may be suspended with thread_local addresses or locked mutexes on
+    /// its stack, and must not continue on another thread.
+    /// A step function with nothing to do can be parked until a
+    /// deadline or a call to Wake, so it costs nothing in between.
+    class BehaviourWorkerPool
+    {
+    public:
+        static BehaviourWorkerPool& getInstance();
+
+        BehaviourWorkerPool(BehaviourWorkerPool const&) = delete;
+        void operator=(BehaviourWorkerPool const&) = delete;
+
+        /// @brief Register a function to call every step (10 ms)
+        /// @param step The function to call, returns false when it's done and must not be called anymore.
+        /// Its argument is the time of the next call, it can be set later to park the function until then
+        /// (time_point::max() to wait for Wake)
+        /// @return An id to use with Wake and Wait
+        const size_t Add(const std::function<bool(std::chrono::steady_clock::time_point&)>& step);
+
+        /// @brief Call the step function with this id as soon as possible,
+        /// even if it is parked. Can be called from any thread.
+        /// @param id The id returned by Add
+        void Wake(const size_t id);
+
+        /// @brief Block until the step function with this id returned false.
+        /// Must not be called from a step function.
+        /// @param id The id returned by Add
+        void Wait(const size_t id);
+
+        /// @brief Number of steps performed since the pool started
+        const unsigned long long int GetNumSteps() const;
+
+    private:
+        BehaviourWorkerPool();
+        ~BehaviourWorkerPool();
+
+        struct Job
+        {
+            size_t id;
+            std::function<bool(std::chrono::steady_clock::time_point&)> step;
+            std::chrono::steady_clock::time_point next_step;
+            // Index of the worker running the job, fixed after its first step
+            std::atomic<size_t> worker;
+            // Set by Wake while the job is running, so it's not parked after
+            std::atomic<bool> woken;
+        };
+
+        struct Worker
+        {
+            std::thread thread;
+            std::mutex mutex;
+            std::condition_variable cond_var;
+            // Set when something may have to be done before the
+            // deadline the worker is sleeping until
+            bool notified;
+            // Sorted by next_step as all jobs have the same period
+            std::deque<std::unique_ptr<Job> > jobs;
+            // Jobs of this worker waiting for a deadline or a Wake call
+            std::map<size_t, std::unique_ptr<Job> > parked;
+            std::set<std::pair<std::chrono::steady_clock::time_point, size_t> > parked_deadlines;
+        };
+
+        void WorkerLoop(const size_t index);
+        // Take the first job with an expired next_step, from the worker's
+        // own queue or a never stepped one stolen from another worker.
+        // Otherwise, next_wake_up is set to the next deadline of the worker
+        std::unique_ptr<Job> GetNextJob(const size_t index, std::chrono::steady_clock::time_point& next_wake_up);
+        // Insert a job in a worker queue, sorted by next_step.
+        // The worker mutex must be locked
+        void Enqueue(Worker& worker, std::unique_ptr<Job> job);
+        // Move the parked jobs of a worker with an expired deadline
+        // back to its queue. The worker mutex must be locked
+        void UnparkExpired(Worker& worker, const std::chrono::steady_clock::time_point& now);
+        // Wake a worker up if it's sleeping. The worker mutex must be locked
+        void Notify(Worker& worker);
+        void JobDone(const size_t id);
+
+    private:
+        std::vector<std::unique_ptr<Worker> > workers;
+        std::mutex pool_mutex;
+        std::condition_variable done_cond_var;
+        // All the jobs not done yet
+        std::map<size_t, Job*> jobs;
+        size_t next_id;
+        std::atomic<bool> running;
+        std::atomic<unsigned long long int> num_steps;
+    };
+} // namespace Botcraft
@@ -1,31 +1,55 @@
 #pragma once
 
-#include <map>
-#include <any>
+#include <vector>
+#include <memory>
 #include <string>
+#include <typeinfo>
+#include <any>
 
 namespace Botcraft
-{    
-    /// @brief A map wrapper to store arbitrary data
+{
+    template<class T>
+    class BlackboardSlot;
+
+    /// @brief A flat store of arbitrary data. Each entry lives
+    /// in a slot whose index is resolved once from its name, the
+    /// same name always gives the same index in all blackboards.
+    /// Each slot holds a typed value, reading it only costs a type
+    /// check before a static cast, and setting a value of the same
+    /// type assigns it in place.
     class Blackboard
     {
     public:
         Blackboard() {}
         ~Blackboard() {}
 
-        /// @brief Get the map value at key, casting it to T.
-        /// The map has to contains key and it has to be a T.
+        /// @brief Get the index of the slot associated to a key,
+        /// allocating a new one the first time a key is seen
+        /// @param key The name of the entry
+        /// @return The index of the slot
+        static const size_t GetSlotIndex(const std::string& key);
+
+        /// @brief Get the value at key, casting it to T.
+        /// The blackboard has to contains key and it has to be a T,
+        /// std::bad_any_cast is thrown otherwise.
         /// @tparam T Any type, must match the type stored at key
         /// @param key key to retrieve the value from
         /// @return The stored value
         template<class T>
         const T& Get(const std::string& key)
         {
-            return std::any_cast<T&>(blackboard[key]);
+            return GetValue<T>(GetSlotIndex(key));
+        }
+
+        /// @brief Same as Get, without the name resolution
+        template<class T>
+        const T& Get(const BlackboardSlot<T>& slot)
+        {
+            return GetValue<T>(slot.GetIndex());
         }
-        
-        /// @brief Get the map value at key, casting it to T.
-        /// If the key is not present in the map, add
+
+        /// @brief Get the value at key, casting it to T.
+        /// If the key is not present in the blackboard, add
         /// it with default_value, and returns it.
         /// @tparam T Any type, must match the type stored at key
         /// @param key key to retrieve the value from
@@ -34,38 +58,156 @@ namespace Botcraft
         template<class T>
         const T& Get(const std::string& key, const T& default_value)
         {
-            auto it = blackboard.find(key);
-            if (it == blackboard.end())
-            {
-                it = blackboard.insert(std::pair<std::string, std::any>(key, default_value)).first;
-            }
-            return std::any_cast<T&>(it->second);
+            return GetOrDefault(GetSlotIndex(key), default_value);
+        }
+
+        /// @brief Same as Get, without the name resolution
+        template<class T>
+        const T& Get(const BlackboardSlot<T>& slot, const T& default_value)
+        {
+            return GetOrDefault(slot.GetIndex(), default_value);
         }
 
-        /// @brief Set map entry at key to value
+        /// @brief Set entry at key to value
         /// @tparam T Any type, be careful to be explicit with strings because "foo" is not a std::string
         /// @param key key to store the value at
         /// @param value value to store at key
         template<class T>
         void Set(const std::string& key, const T& value)
         {
-            blackboard[key] = value;
+            SetValue(GetSlotIndex(key), value);
         }
 
-        /// @brief Remove a map entry if present
+        /// @brief Same as Set, without the name resolution
+        template<class T>
+        void Set(const BlackboardSlot<T>& slot, const T& value)
+        {
+            SetValue(slot.GetIndex(), value);
+        }
+
+        /// @brief Remove an entry if present
         /// @param key key we want to remove
         void Erase(const std::string& key)
         {
-            blackboard.erase(key);
+            EraseSlot(GetSlotIndex(key));
         }
-        
+
+        /// @brief Same as Erase, without the name resolution
+        template<class T>
+        void Erase(const BlackboardSlot<T>& slot)
+        {
+            EraseSlot(slot.GetIndex());
+        }
+
         /// @brief Clear all the entries in the blackboard
         void Clear()
         {
-            blackboard.clear();
+            slots.clear();
+        }
+
+    private:
+        class Value
+        {
+        public:
+            virtual ~Value() {}
+
+            const std::type_info* type;
+        };
+
+        template<class T>
+        class TypedValue : public Value
+        {
+        public:
+            TypedValue(const T& value_) : value(value_)
+            {
+                this->type = &typeid(T);
+            }
+
+            T value;
+        };
+
+        template<class T>
+        static const bool IsType(const Value& value)
+        {
+            // Comparing the addresses is enough in most cases,
+            // they can only differ across shared libraries
+            return value.type == &typeid(T) || *value.type == typeid(T);
+        }
+
+        template<class T>
+        T& GetValue(const size_t index)
+        {
+            Value* value = index < slots.size() ? slots[index].get() : nullptr;
+            if (value == nullptr || !IsType<T>(*value))
+            {
+                // Same as with the original std::any storage
+                throw std::bad_any_cast();
+            }
+            return static_cast<TypedValue<T>*>(value)->value;
+        }
+
+        template<class T>
+        void SetValue(const size_t index, const T& value)
+        {
+            if (index >= slots.size())
+            {
+                slots.resize(index + 1);
+            }
+            std::unique_ptr<Value>& slot = slots[index];
+            if (slot != nullptr && IsType<T>(*slot))
+            {
+                static_cast<TypedValue<T>*>(slot.get())->value = value;
+            }
+            else
+            {
+                slot = std::unique_ptr<Value>(new TypedValue<T>(value));
+            }
+        }
+
+        void EraseSlot(const size_t index)
+        {
+            if (index < slots.size())
+            {
+                slots[index].reset();
+            }
+        }
+
+        template<class T>
+        const T& GetOrDefault(const size_t index, const T& default_value)
+        {
+            if (index >= slots.size() || slots[index] == nullptr)
+            {
+                SetValue(index, default_value);
+            }
+            return GetValue<T>(index);
+        }
+
+    private:
+        // Values are allocated separately, so references
+        // returned by Get stay valid when slots grows. Not a
+        // deque, indexing a vector is faster on the hot path
+        std::vector<std::unique_ptr<Value> > slots;
+    };
+
+    /// @brief A typed handle on a blackboard entry. Create it once
+    /// (for example as a static variable) and use it instead of
+    /// the key name to skip the name resolution at each access.
+    /// @tparam T The type of the value stored in this entry
+    template<class T>
+    class BlackboardSlot
+    {
+    public:
+        explicit BlackboardSlot(const std::string& key) : index(Blackboard::GetSlotIndex(key))
+        {
+
+        }
+
+        const size_t GetIndex() const
+        {
+            return index;
         }
 
     private:
-        std::map<std::string, std::any> blackboard;
+        size_t index;
     };
 } // namespace Botcraft
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "botcraft/Game/Enums.hpp"
+#include "botcraft/Game/Vector3.hpp"
+
+namespace Botcraft
+{
+    class World;
+    class StructureDiff;
+
+    enum class BuildJobAction
+    {
+        Place,
+        Dig
+    };
+
+    struct BuildJob
+    {
+        BuildJobAction action;
+        Position position;
+        PlayerDiggingFace face;
+        /// @brief Item to place, empty for Dig jobs
+        std::string item;
+    };
+
+    /// @brief Share the work needed to build a structure between
+    /// all the bots of the process. Outstanding place/dig jobs come
+    /// from a StructureDiff kept up to date from the block changes
+    /// of the watched worlds, and each bot leases the nearest one it
+    /// can do, so two bots never work on the same block.
+    class BuildCoordinator
+    {
+    public:
+        /// @param lease_duration_ms Time after which a job not released by its owner is given to someone else
+        BuildCoordinator(const long long int lease_duration_ms = 30000);
+        ~BuildCoordinator();
+
+        BuildCoordinator(const BuildCoordinator&) = delete;
+        BuildCoordinator& operator=(const BuildCoordinator&) = delete;
+
+        /// @brief Set the structure to build. Only the first call is taken into account.
+        /// @param start Min corner of the structure in the world
+        /// @param end Max corner (included) of the structure in the world
+        /// @param target Palette id of each block relative to start, -1 for air
+        /// @param palette Block name of each palette id
+        /// @return True if the plan was set by this call
+        const bool SetPlan(const Position& start, const Position& end,
+            const std::vector<std::vector<std::vector<short> > >& target,
+            const std::map<short, std::string>& palette);
+
+        const bool HasPlan() const;
+
+        /// @brief Get the diff between the plan and the world, nullptr if no plan is set
+        std::shared_ptr<StructureDiff> GetDiff() const;
+
+        /// @brief Lease the nearest job that can be done with the given items.
+        /// A job previously leased by owner is released first. The first call
+        /// with a world starts listening to its block changes.
+        /// @param owner Unique name of the bot asking for a job
+        /// @param world The world of this bot, used to check the job is still valid
+        /// @param position Current position of the bot
+        /// @param available_items Names of the blocks the bot can place
+        /// @param job Output job
+        /// @return True if a job was found, false otherwise
+        const bool AcquireJob(const std::string& owner, const std::shared_ptr<World>& world,
+            const Vector3<double>& position, const std::set<std::string>& available_items, BuildJob& job);
+
+        /// @brief Give back the job leased by owner
+        /// @param owner Unique name of the bot
+        /// @param success False if the job couldn't be done, it won't be given again to this owner for a few seconds
+        void ReleaseJob(const std::string& owner, const bool success);
+
+    private:
+        struct Lease
+        {
+            std::string owner;
+            std::chrono::steady_clock::time_point expiry;
+        };
+
+        struct Owner
+        {
+            bool has_lease;
+            Position leased;
+            bool has_failed;
+            Position failed;
+            std::chrono::steady_clock::time_point failed_until;
+        };
+
+        void ExpireLeases();
+
+    private:
+        // Only protects the leases, it is never held
+        // while waiting on the diff or the world mutex
+        mutable std::mutex coordinator_mutex;
+        std::chrono::milliseconds lease_duration;
+
+        std::shared_ptr<StructureDiff> diff;
+
+        std::unordered_map<Position, Lease> leases;
+        // Leases all have the same duration, so
+        // this queue is sorted by expiry date
+        std::deque<std::pair<std::chrono::steady_clock::time_point, Position> > leases_queue;
+        std::unordered_map<std::string, Owner> owners;
+    };
+} // namespace Botcraft
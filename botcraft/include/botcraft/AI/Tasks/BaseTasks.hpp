@@ -9,7 +9,7 @@ namespace Botcraft
 {
     /// @brief Just call client.Yield(). Can be used to Idle the behaviour.
     /// @param client The client performing the action
-    /// @return Always return Success
+    /// @return Success, or Failure if the behaviour is interrupted
     Status Yield(BehaviourClient& client);
 
     /// @brief Ask this client to disconnect from the server by setting should_be_closed to true.
@@ -73,14 +73,15 @@ namespace Botcraft
     template<typename T>
     Status SetBlackboardDataBlackboard(BehaviourClient& client)
     {
-        const std::vector<std::string> variable_names = {
-            "SetBlackboardData.key" , "SetBlackboardData.data" };
+        // Keys are resolved only once
+        static const BlackboardSlot<std::string> key_slot("SetBlackboardData.key");
+        static const BlackboardSlot<T> data_slot("SetBlackboardData.data");
 
         Blackboard& blackboard = client.GetBlackboard();
 
         // Mandatory
-        const std::string& key = blackboard.Get<std::string>(variable_names[0]);
-        const T& data = blackboard.Get<T>(variable_names[1]);
+        const std::string& key = blackboard.Get<std::string>(key_slot);
+        const T& data = blackboard.Get<T>(data_slot);
 
         return SetBlackboardData<T>(client, key, data);
     }
@@ -14,11 +14,13 @@ namespace Botcraft
     /// @param min_end_dist Desired minimal distance between the final position and goal (useful if you want to place a block, you don't want to be at the exact spot, but close to it)
     /// @param speed Travel speed (block per s)
     /// @param allow_jump If true, allow to jump above 1-wide gaps
+    /// @param sprint_jump If true, jump on long straight parts of the path to go faster
     /// @return Success if goal is reached, Failure otherwise
     Status GoTo(BehaviourClient& client, const Position& goal, const int dist_tolerance = 0,
-        const int min_end_dist = 0, const float speed = 4.317f, const bool allow_jump = true);
+        const int min_end_dist = 0, const float speed = 4.317f, const bool allow_jump = true, const bool sprint_jump = false);
 
-    /// @brief Same thing as GoTo, but reads its parameters from the blackboard
+    /// @brief Same thing as GoTo, but reads its parameters from the blackboard.
+    /// The average speed of the last followed path is written in GoTo.achieved_speed (blocks per s)
     /// @param client The client performing the action
     /// @return Success if goal is reached, Failure otherwise
     Status GoToBlackboard(BehaviourClient& client);
@@ -1,13 +1,31 @@
 #pragma once
 
 #include <iostream>
+#include <limits>
 
 #include "botcraft/AI/BehaviourClient.hpp"
 #include "botcraft/AI/BehaviourTree.hpp"
+#include "botcraft/AI/BehaviourWorkerPool.hpp"
 #include "botcraft/Network/NetworkManager.hpp"
+#include "botcraft/Utilities/Fiber.hpp"
 
 namespace Botcraft
 {
+    /// @brief How the behaviour tree of a client is executed
+    enum class BehaviourExecutionMode
+    {
+        /// @brief The tree runs in a dedicated thread, BehaviourStep
+        /// and Yield synchronize with it using a condition variable
+        Thread,
+        /// @brief The tree runs in a fiber, resumed by the thread calling
+        /// BehaviourStep, Yield is a simple context switch. BehaviourStep
+        /// must always be called by the same thread
+        Fiber,
+        /// @brief The tree runs in a fiber, automatically resumed every step
+        /// by the shared BehaviourWorkerPool. BehaviourStep does nothing
+        WorkerPool
+    };
+
     /// @brief The base class you should inherit if you need to
     /// implement some custom Handle functions AND need to add
     /// custom fields to your derived class. If you just need
@@ -17,23 +35,15 @@ namespace Botcraft
     template<typename TDerived>
     class TemplatedBehaviourClient : public BehaviourClient
     {
-    private:
-        /// @brief Custom internal exception used
-        /// when the tree needs to be changed
-        class SwapTreeException : public std::exception
-        {
-        };
-        /// @brief Custom internal exception used
-        /// when the tree needs to be stopped
-        class InterruptedException : public std::exception
-        {
-        };
-
     public:
         TemplatedBehaviourClient(const bool use_renderer_) :
             BehaviourClient(use_renderer_)
         {
             swap_tree = false;
+            execution_mode = BehaviourExecutionMode::Thread;
+            // No job in the pool yet
+            pool_id = std::numeric_limits<size_t>::max();
+            step_woken = false;
         }
 
         virtual ~TemplatedBehaviourClient()
@@ -46,6 +56,27 @@ namespace Botcraft
                 should_be_closed = true;
             }
 
+            if (fiber && !fiber->IsFinished())
+            {
+                // The fiber is only resumed by the thread that ran it so far.
+                // Its pool worker, woken up if the tree is waiting, sees
+                // should_be_closed and resumes the fiber one last time
+                if (execution_mode == BehaviourExecutionMode::WorkerPool)
+                {
+                    BehaviourWorkerPool::getInstance().Wake(pool_id);
+                    BehaviourWorkerPool::getInstance().Wait(pool_id);
+                }
+                else if (std::this_thread::get_id() == fiber_thread)
+                {
+                    FinishFiber();
+                }
+                else
+                {
+                    std::cerr << "Warning, behaviour client destroyed by another thread than the one calling BehaviourStep, the tree is not stopped properly" << std::endl;
+                }
+            }
+
+            WakeUp();
             behaviour_cond_var.notify_all();
             if (behaviour_thread.joinable())
             {
@@ -64,25 +95,70 @@ namespace Botcraft
 
         /// @brief Can be called to pause the execution of the internal
         /// tree function. Call it in long function so the behaviour
-        /// can be interrupted.
+        /// can be interrupted. Once the tree has to stop (swapped or
+        /// client closing), IsBehaviourInterrupted() is true and Yield
+        /// returns immediately so the tree can return.
         virtual void Yield() override
         {
-            std::unique_lock<std::mutex> lock(behaviour_mutex);
-            behaviour_cond_var.notify_all();
-            behaviour_cond_var.wait(lock);
-            if (should_be_closed)
+            if (behaviour_interrupted)
             {
-                throw InterruptedException();
+                return;
             }
-            else if (swap_tree)
+
+            if (fiber)
             {
-                throw SwapTreeException();
+#if USE_BEHAVIOUR_PROFILING
+                behaviour_profiler.BeginSuspension();
+                fiber->Suspend();
+                behaviour_profiler.EndSuspension();
+#else
+                fiber->Suspend();
+#endif
+                std::lock_guard<std::mutex> behaviour_guard(behaviour_mutex);
+                behaviour_interrupted = should_be_closed || swap_tree;
+                return;
             }
+
+            std::unique_lock<std::mutex> lock(behaviour_mutex);
+            behaviour_cond_var.notify_all();
+#if USE_BEHAVIOUR_PROFILING
+            behaviour_profiler.BeginSuspension();
+            behaviour_cond_var.wait(lock);
+            behaviour_profiler.EndSuspension();
+#else
+            behaviour_cond_var.wait(lock);
+#endif
+            behaviour_interrupted = should_be_closed || swap_tree;
         }        
         
         /// @brief Start the behaviour thread loop.
-        void StartBehaviour()
+        /// @param mode How the tree should be executed
+        void StartBehaviour(const BehaviourExecutionMode mode = BehaviourExecutionMode::Thread)
         {
+            execution_mode = mode;
+#if USE_BEHAVIOUR_PROFILING
+            if (network_manager)
+            {
+                behaviour_profiler.SetName(network_manager->GetMyName());
+            }
+#endif
+            if (mode != BehaviourExecutionMode::Thread)
+            {
+                fiber = std::unique_ptr<Fiber>(new Fiber(std::bind(&TemplatedBehaviourClient<TDerived>::TreeLoop, this)));
+                // The fiber is only started by the pool worker it
+                // stays on, as it can't move once suspended
+                if (mode == BehaviourExecutionMode::WorkerPool)
+                {
+                    pool_id = BehaviourWorkerPool::getInstance().Add(std::bind(&TemplatedBehaviourClient<TDerived>::PoolStep, this, std::placeholders::_1));
+                    return;
+                }
+                // Run until the first Yield call, so it's
+                // in the same state as the thread version
+                fiber_thread = std::this_thread::get_id();
+                fiber->Resume();
+                return;
+            }
+
             std::unique_lock<std::mutex> lock(behaviour_mutex);
             behaviour_thread = std::thread(&TemplatedBehaviourClient<TDerived>::TreeLoop, this);
             // Wait for the first Yield call to be sure 
@@ -92,22 +168,37 @@ namespace Botcraft
 
         /// @brief Blocking call, will return only when the client is
         /// disconnected from the server.
-        void RunBehaviourUntilClosed()
+        /// @param mode How the tree should be executed if not already started
+        void RunBehaviourUntilClosed(const BehaviourExecutionMode mode = BehaviourExecutionMode::Thread)
         {
-            if (!behaviour_thread.joinable())
+            if (!behaviour_thread.joinable() && !fiber)
+            {
+                StartBehaviour(mode);
+            }
+
+            // Steps are performed by the pool, which stops
+            // stepping the client once it's closed
+            if (execution_mode == BehaviourExecutionMode::WorkerPool)
             {
-                StartBehaviour();
+                BehaviourWorkerPool::getInstance().Wait(pool_id);
+                return;
             }
 
             // Main behaviour loop
             while (!should_be_closed)
             {
-                std::chrono::system_clock::time_point start = std::chrono::system_clock::now();
-                std::chrono::system_clock::time_point end = start + std::chrono::milliseconds(10);
+                const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
 
                 BehaviourStep();
 
-                std::this_thread::sleep_until(end);
+                // While the tree waits, sleep until it's woken up or its
+                // deadline. Closing the connection is not signaled, so
+                // it's still checked every second
+                const std::chrono::steady_clock::time_point wake_up = std::max(now + std::chrono::milliseconds(10),
+                    std::min(GetWaitDeadline(), now + std::chrono::seconds(1)));
+                std::unique_lock<std::mutex> lock(step_mutex);
+                step_cond_var.wait_until(lock, wake_up, [this]() { return step_woken; });
+                step_woken = false;
             }
         }
 
@@ -115,12 +206,29 @@ namespace Botcraft
         /// Don't forget to call StartBehaviour before.
         void BehaviourStep()
         {
+            if (execution_mode == BehaviourExecutionMode::WorkerPool)
+            {
+                return;
+            }
+
+            if (execution_mode == BehaviourExecutionMode::Fiber)
+            {
+                fiber_thread = std::this_thread::get_id();
+                ResumeFiber();
+                return;
+            }
+
             if (should_be_closed || !network_manager || network_manager->GetConnectionState() != ProtocolCraft::ConnectionState::Play)
             {
                 return;
             }
 
             std::unique_lock<std::mutex> lock(behaviour_mutex);
+            // Nothing changed since the tree started waiting
+            if (!swap_tree && !ShouldResume())
+            {
+                return;
+            }
             // Resume tree ticking
             behaviour_cond_var.notify_all();
             // Wait for the next call to Yield()
@@ -128,6 +236,72 @@ namespace Botcraft
         }
 
     private:
+        void ResumeFiber()
+        {
+            if (should_be_closed || !network_manager || network_manager->GetConnectionState() != ProtocolCraft::ConnectionState::Play)
+            {
+                return;
+            }
+
+            {
+                // Nothing changed since the tree started waiting
+                std::lock_guard<std::mutex> behaviour_guard(behaviour_mutex);
+                if (!swap_tree && !ShouldResume())
+                {
+                    return;
+                }
+            }
+
+            // Run the tree until the next call to Yield()
+            fiber->Resume();
+        }
+
+        /// @brief Resume the fiber until the tree loop returns
+        void FinishFiber()
+        {
+            while (!fiber->IsFinished())
+            {
+                fiber->Resume();
+            }
+        }
+
+        /// @brief Step function called by the worker pool
+        /// @param next_step Time of the next call, pushed back while the tree waits
+        /// @return False once the client is closed and the fiber finished
+        const bool PoolStep(std::chrono::steady_clock::time_point& next_step)
+        {
+            if (should_be_closed)
+            {
+                FinishFiber();
+                return false;
+            }
+
+            ResumeFiber();
+
+            // Park the job until one of the awaited signals wakes it up
+            // or the deadline expires. Closing the connection is not
+            // signaled, so it's still checked every second
+            next_step = std::max(next_step,
+                std::min(GetWaitDeadline(), std::chrono::steady_clock::now() + std::chrono::seconds(1)));
+
+            return !fiber->IsFinished();
+        }
+
+        virtual void WakeUp() override
+        {
+            if (execution_mode == BehaviourExecutionMode::WorkerPool)
+            {
+                BehaviourWorkerPool::getInstance().Wake(pool_id);
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> step_guard(step_mutex);
+                step_woken = true;
+            }
+            step_cond_var.notify_all();
+        }
+
         void TreeLoop()
         {
             while (true)
@@ -140,19 +314,10 @@ namespace Botcraft
                     }
                     Yield();
                 }
-                // We need to update the tree with the new one
-                catch (const SwapTreeException&)
-                {
-                    tree = new_tree;
-                    new_tree = nullptr;
-                    swap_tree = false;
-                    blackboard.Clear();
-                    continue;
-                }
-                // We need to stop the behaviour thread
-                catch (const InterruptedException&)
+                catch (const Fiber::Unwind&)
                 {
-                    return;
+                    // The fiber is destroyed, let it unwind
+                    throw;
                 }
                 catch (std::exception& e)
                 {
@@ -164,6 +329,24 @@ namespace Botcraft
                     std::cerr << "Unknown exception caught during tree ticking. Stopping behaviour." << std::endl;
                     return;
                 }
+
+                if (!behaviour_interrupted)
+                {
+                    continue;
+                }
+
+                // The interrupted tree has returned,
+                // stop or switch to the new one
+                std::lock_guard<std::mutex> behaviour_guard(behaviour_mutex);
+                if (should_be_closed)
+                {
+                    return;
+                }
+                tree = new_tree;
+                new_tree = nullptr;
+                swap_tree = false;
+                blackboard.Clear();
+                behaviour_interrupted = false;
             }
         }
 
@@ -175,5 +358,16 @@ namespace Botcraft
         std::thread behaviour_thread;
         std::condition_variable behaviour_cond_var;
         std::mutex behaviour_mutex;
+
+        BehaviourExecutionMode execution_mode;
+        std::unique_ptr<Fiber> fiber;
+        // Last thread that resumed the fiber in Fiber mode
+        std::thread::id fiber_thread;
+        size_t pool_id;
+
+        // Used by RunBehaviourUntilClosed to sleep while the tree waits
+        std::mutex step_mutex;
+        std::condition_variable step_cond_var;
+        bool step_woken;
     };
 } // namespace Botcraft
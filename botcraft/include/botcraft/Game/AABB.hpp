@@ -1,14 +1,34 @@
 #pragma once
 
+#include <vector>
+
 #include "botcraft/Game/Vector3.hpp"
 
 namespace Botcraft
 {
+    class AABB;
+
+    // Boxes stored as structure of arrays, so
+    // collision tests can be done on all of them at once
+    struct AABBArray
+    {
+        void Clear();
+        void Add(const AABB& box);
+        const AABB Get(const size_t i) const;
+        const size_t Size() const;
+
+        std::vector<double> min_x;
+        std::vector<double> min_y;
+        std::vector<double> min_z;
+        std::vector<double> max_x;
+        std::vector<double> max_y;
+        std::vector<double> max_z;
+    };
+
     class AABB
     {
     public:
         AABB(const Vector3<double> &center_, const Vector3<double> &half_size_);
-        ~AABB();
         const Vector3<double> GetMin() const;
         const Vector3<double> GetMax() const;
         const Vector3<double>& GetCenter() const;
@@ -22,6 +42,11 @@ namespace Botcraft
         //AABB
         const double SweptCollide(const Vector3<double> &speed, const AABB &b, Vector3<double> &normal) const;
 
+        //Same as above, but against all the boxes of the array,
+        //return the fraction before the first collision and the
+        //normal of the box hit first (normal is not set if no collision)
+        const double SweptCollide(const Vector3<double> &speed, const AABBArray &boxes, Vector3<double> &normal) const;
+
         const bool Intersect(const Vector3<double> &origin, const Vector3<double> &direction) const;
 
         template <typename T>
@@ -39,4 +64,24 @@ namespace Botcraft
         Vector3<double> center;
         Vector3<double> half_size;
     };
+
+    // Read-only view over contiguous boxes stored elsewhere
+    // (in a vector or in a memory mapped file)
+    class AABBView
+    {
+    public:
+        AABBView() : boxes(nullptr), num_boxes(0) {}
+        AABBView(const AABB* boxes_, const size_t num_boxes_) : boxes(boxes_), num_boxes(num_boxes_) {}
+        AABBView(const std::vector<AABB>& boxes_) : boxes(boxes_.data()), num_boxes(boxes_.size()) {}
+
+        const AABB& operator[](const size_t i) const { return boxes[i]; }
+        const size_t size() const { return num_boxes; }
+        const bool empty() const { return num_boxes == 0; }
+        const AABB* begin() const { return boxes; }
+        const AABB* end() const { return boxes + num_boxes; }
+
+    private:
+        const AABB* boxes;
+        size_t num_boxes;
+    };
 } // Botcraft
\ No newline at end of file
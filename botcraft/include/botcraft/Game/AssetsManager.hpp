@@ -5,9 +5,31 @@
 #include "botcraft/Game/Inventory/Item.hpp"
 
 #include <vector>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
 
 namespace Botcraft
 {
+    namespace AssetsCache
+    {
+        class Reader;
+    }
+
+    enum class CollisionShapeType : unsigned char
+    {
+        Empty = 0,
+        FullCube = 1,
+        Boxes = 2
+    };
+
+    struct CollisionShape
+    {
+        CollisionShapeType type;
+        // Colliders in block coordinates (between 0 and 1)
+        AABBView boxes;
+    };
+
     class AssetsManager
     {
     public:
@@ -17,6 +39,7 @@ namespace Botcraft
         void operator=(AssetsManager const&) = delete;
 
 #ifdef USE_GUI
+        // Paths and names of all the textures used by the block models
         const std::vector<std::pair<std::string, std::string> > GetTexturesPathsNames() const;
 #endif
 #if PROTOCOL_VERSION < 347
@@ -25,26 +48,63 @@ namespace Botcraft
         const std::map<int, std::shared_ptr<Blockstate> >& Blockstates() const;
 #endif
         
+        // Direct access to a blockstate using its global id,
+        // returns the default blockstate if id is unknown
+#if PROTOCOL_VERSION < 347
+        const Blockstate* GetBlockstate(const int id, const unsigned char metadata) const;
+        // Get the id of the first blockstate with this name, -1,0 if unknown
+        const std::pair<int, unsigned char> GetBlockstateID(const std::string& blockstate_name) const;
+#else
+        const Blockstate* GetBlockstate(const int id) const;
+        // Get the id of the first blockstate with this name, -1 if unknown
+        const int GetBlockstateID(const std::string& blockstate_name) const;
+#endif
+        
+        // Colliders of a blockstate at a given position, precomputed
+        // for all model variants so no model lookup is needed
+        const CollisionShape& GetCollisionShape(const Blockstate* blockstate, const Position& pos) const;
+
 #if PROTOCOL_VERSION < 358
         const std::map<unsigned char, std::shared_ptr<Biome> >& Biomes() const;
-        const std::shared_ptr<Biome> GetBiome(const unsigned char id);
+        const Biome* GetBiome(const unsigned char id) const;
 #else
         const std::map<int, std::shared_ptr<Biome> >& Biomes() const;
-        const std::shared_ptr<Biome> GetBiome(const int id);
+        const Biome* GetBiome(const int id) const;
 #endif
 
 #if PROTOCOL_VERSION < 347
         const std::map<int, std::map<unsigned char, std::shared_ptr<Item> > >& Items() const;
+        // Direct access to an item using its id,
+        // returns the default item if id is unknown
+        const Item* GetItem(const int id, const unsigned char damage_id) const;
+        // Get the id of an item from its name, -1,0 if unknown
+        const std::pair<int, unsigned char> GetItemID(const std::string& item_name) const;
 #else
         const std::map<int, std::shared_ptr<Item> >& Items() const;
+        // Direct access to an item using its id,
+        // returns the default item if id is unknown
+        const Item* GetItem(const int id) const;
+        // Get the id of an item from its name, -1 if unknown
+        const int GetItemID(const std::string& item_name) const;
 #endif
 
     private:
         AssetsManager();
+        ~AssetsManager();
 
         void LoadBlocksFile();
         void LoadBiomesFile();
         void LoadItemsFile();
+        // Load all assets from the binary cache file, returns
+        // false if the file is missing, outdated or invalid
+        const bool LoadCacheFile(const std::string& path, const unsigned long long int source_signature);
+        void WriteCacheFile(const std::string& path, const unsigned long long int source_signature) const;
+        void FlattenRegistries();
+        void BuildCollisionShapes();
+#ifdef USE_GUI
+        // List all the textures used by the block models
+        void ListTextureNames();
+#endif
         void ClearCaches();
 
     private:
@@ -63,5 +123,42 @@ namespace Botcraft
 #else
         std::map<int, std::shared_ptr<Item> > items;
 #endif
+
+        // Flat versions of the maps above, indexed by global id
+        // (id << 4 | metadata for blockstates before 1.13), with
+        // unknown ids pointing to the default value
+        std::vector<const Blockstate*> flattened_blockstates;
+        std::vector<const Biome*> flattened_biomes;
+        std::vector<const Item*> flattened_items;
+#if PROTOCOL_VERSION < 347
+        // Items damage values are not limited to 4 bits, so each id
+        // gets its own range in flattened_items, starting at
+        // flattened_items_offsets[id] and ending at flattened_items_offsets[id + 1]
+        std::vector<unsigned int> flattened_items_offsets;
+#endif
+
+        // Collision shapes of all blockstates variants, indexed by
+        // global id with (first shape, number of variants) pairs
+        std::vector<CollisionShape> collision_shapes;
+        std::vector<std::pair<unsigned int, unsigned char> > flattened_collisions;
+        std::pair<unsigned int, unsigned char> default_collision;
+#ifdef USE_GUI
+        // Computed once when the assets are loaded, and stored in the cache file
+        std::vector<std::string> texture_names;
+#endif
+        // Keys are views of the blockstates/items names
+#if PROTOCOL_VERSION < 347
+        std::unordered_map<std::string_view, std::pair<int, unsigned char> > blockstates_name_to_id;
+        std::unordered_map<std::string_view, std::pair<int, unsigned char> > items_name_to_id;
+#else
+        std::unordered_map<std::string_view, int> blockstates_name_to_id;
+        std::unordered_map<std::string_view, int> items_name_to_id;
+#endif
+
+        // Mapped assets cache file. Blockstates, biomes, items and
+        // the models below point into it, so it is kept for the
+        // whole process lifetime
+        std::unique_ptr<AssetsCache::Reader> assets_cache;
+        std::vector<Model> cache_models;
     };
 } // Botcraft
\ No newline at end of file
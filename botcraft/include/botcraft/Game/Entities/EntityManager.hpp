@@ -1,7 +1,8 @@
 #pragma once
 
 #include "protocolCraft/Handler.hpp"
-#include <unordered_map>
+#include "botcraft/Utilities/Signal.hpp"
+#include "botcraft/Game/Entities/EntityStore.hpp"
 #include <memory>
 #include <mutex>
 
@@ -23,13 +24,19 @@ namespace Botcraft
         EntityManager();
 
         std::shared_ptr<LocalPlayer> GetLocalPlayer();
-        const std::unordered_map<int, std::shared_ptr<Entity> >& GetEntities() const;
+        // All the known entities, including the local player,
+        // with their spatial index. Mutex must be locked
+        const EntityStore& GetEntities() const;
 
 #if USE_GUI
         void SetRenderingManager(std::shared_ptr<Renderer::RenderingManager> rendering_manager_);
 #endif
         std::mutex& GetMutex();
 
+        // Notified each time the local player moves or
+        // its on ground state changes
+        Signal& GetLocalPlayerSignal();
+
     protected:
         virtual void Handle(ProtocolCraft::ClientboundLoginPacket& msg) override;
         virtual void Handle(ProtocolCraft::ClientboundPlayerPositionPacket& msg) override;
@@ -53,11 +60,12 @@ namespace Botcraft
 
 
     private:
-        std::unordered_map<int, std::shared_ptr<Entity> > entities;
+        EntityStore entities;
         // The current player is stored independently
         std::shared_ptr<LocalPlayer> local_player;
 
         std::mutex entity_manager_mutex;
+        Signal local_player_signal;
 
 #if USE_GUI
         std::shared_ptr<Renderer::RenderingManager> rendering_manager;
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "botcraft/Game/Vector3.hpp"
+#include "botcraft/Game/AABB.hpp"
+
+namespace Botcraft
+{
+    class Entity;
+
+    // Dense storage of the entities, with their positions and colliders
+    // stored as structure of arrays and bucketed in a uniform grid, so
+    // proximity queries only visit the entities of the overlapping cells.
+    // Entity objects are kept in sync with the arrays, the positions of
+    // the entities must be changed through this store to keep the grid
+    // up to date. Entities added as not indexed (the local player, moved
+    // by the physics thread) are always tested against their object.
+    // Not thread safe, EntityManager mutex must be locked.
+    class EntityStore
+    {
+    public:
+        EntityStore();
+
+        // Add the entity, replacing any entity with the same id
+        void Add(const std::shared_ptr<Entity>& entity, const bool indexed = true);
+        void Remove(const int id);
+        void Clear();
+
+        const size_t Size() const;
+        // Returns nullptr if there is no entity with this id
+        std::shared_ptr<Entity> Get(const int id) const;
+        // All the entities, order changes when one is removed
+        const std::vector<std::shared_ptr<Entity> >& GetAll() const;
+
+        // Returns -1 if there is no entity with this id. Slots
+        // are only valid until the next Add/Remove/Clear
+        const int GetSlot(const int id) const;
+        const Vector3<double> GetPosition(const int slot) const;
+        void SetPosition(const int slot, const Vector3<double>& position);
+        void SetRotation(const int slot, const float yaw, const float pitch);
+        void SetOnGround(const int slot, const bool on_ground);
+
+        // Append to output all the entities whose position is at
+        // most radius blocks away from center
+        void QueryRadius(const Vector3<double>& center, const double radius, std::vector<std::shared_ptr<Entity> >& output) const;
+        // Append to output all the entities whose collider collides box
+        void QueryAABB(const AABB& box, std::vector<std::shared_ptr<Entity> >& output) const;
+
+    private:
+        const Position GetCell(const Vector3<double>& position) const;
+        void AddToCell(const int slot);
+        void RemoveFromCell(const int slot);
+        void ReplaceInCell(const int slot, const int new_slot);
+        // Visit the indexed slots of the cells overlapping [min, max]
+        template<class Function>
+        void VisitCells(const Vector3<double>& min, const Vector3<double>& max, Function f) const;
+
+    private:
+        std::unordered_map<int, int> slots_by_id;
+
+        std::vector<std::shared_ptr<Entity> > entities;
+        std::vector<int> ids;
+        std::vector<double> x;
+        std::vector<double> y;
+        std::vector<double> z;
+        // Collider of each entity, relative to its position
+        std::vector<Vector3<double> > collider_offsets;
+        std::vector<Vector3<double> > collider_half_sizes;
+        std::vector<bool> indexed;
+        // Cell of each indexed slot
+        std::vector<Position> cells_of_slots;
+
+        // Indexed slots in each grid cell
+        std::unordered_map<Position, std::vector<int> > cells;
+        std::vector<int> not_indexed_slots;
+        // Max distance between the position and the collider
+        // border of all the entities added to the grid
+        Vector3<double> max_extent;
+    };
+} // Botcraft
@@ -1,13 +1,56 @@
 #pragma once
 
 #include <mutex>
+#include <vector>
 
 #include "botcraft/Game/Vector3.hpp"
 #include "botcraft/Game/AABB.hpp"
 #include "botcraft/Game/Entities/Entity.hpp"
+#include "botcraft/Utilities/Seqlock.hpp"
 
 namespace Botcraft 
 {
+    // Snapshot of the kinematic state of the local player
+    struct LocalPlayerState
+    {
+        Vector3<double> position;
+        Vector3<double> speed;
+        float yaw;
+        float pitch;
+        bool on_ground;
+    };
+
+    enum class MovementCommandType
+    {
+        // Add value to the speed of the next physics tick
+        AddSpeed,
+        // Set the X and Z speed of the next tick to reach value
+        ReachXZ,
+        // Set the vertical speed to value.y
+        Jump,
+        // Move by value, without checking for collisions
+        Translate,
+        // Turn toward value, pitch is changed only if set_pitch is true
+        LookAt,
+        // Start falling, for example to go down a block
+        LeaveGround,
+        // Set the position to value, used for the server corrections
+        Teleport,
+        // Set yaw to value.x and pitch to value.y
+        Rotate
+    };
+
+    // Movement intent sent to the physics thread
+    struct MovementCommand
+    {
+        MovementCommandType type;
+        Vector3<double> value;
+        bool set_pitch;
+        // Teleport and Rotate only, bit i set if
+        // value[i] is relative to the current value
+        unsigned char relative;
+    };
+
     class LocalPlayer : public Entity
     {
     public:
@@ -15,6 +58,21 @@ namespace Botcraft
 
         std::mutex& GetMutex();
 
+        // Last published state, can be called from any
+        // thread without locking the player mutex
+        const LocalPlayerState GetState() const;
+        // Publish the current state for GetState. Must
+        // be called with the player mutex locked
+        void PublishState();
+
+        // Queue a command to apply at the beginning of the next
+        // physics tick. Doesn't lock the player mutex
+        void PushMovementCommand(const MovementCommand& command);
+        // Apply all the queued commands. Called by the
+        // physics thread with the player mutex locked.
+        // Returns true if at least one command was applied
+        const bool ApplyMovementCommands();
+
         const Vector3<double>& GetFrontVector() const;
         const Vector3<double>& GetXZVector() const;
         const Vector3<double>& GetRightVector() const;
@@ -54,6 +112,14 @@ namespace Botcraft
     private:
         std::mutex player_mutex;
 
+        Seqlock<LocalPlayerState> state;
+
+        // Only protects the queue, so behaviours can
+        // send commands without waiting for the physics
+        std::mutex commands_mutex;
+        std::vector<MovementCommand> commands;
+        std::vector<MovementCommand> applied_commands;
+
         Vector3<double> frontVector;
         Vector3<double> xzVector;
         Vector3<double> rightVector;
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "botcraft/Game/Vector3.hpp"
+
+namespace Botcraft
+{
+    class LocalPlayer;
+
+    enum class MovementStatus
+    {
+        // No path, or a path that has been replaced/stopped
+        Idle,
+        Moving,
+        Arrived,
+        // No progress or too far from the path, it should be replanned
+        Stuck
+    };
+
+    // Follow a path in lockstep with the physics tick. Each tick, the
+    // player speed is set toward a target point a bit ahead on the path,
+    // so straight lines and turns are taken without stopping at each
+    // block. Jumps are triggered when the next block is higher or
+    // after a gap. Paths are set by the behaviour thread and followed
+    // by the physics thread, all functions are thread safe.
+    class MovementController
+    {
+    public:
+        MovementController();
+
+        // Start following path, the player has to stand in each of these
+        // blocks in turn. speed is in blocks/s, if sprint_jump is true, the
+        // player jumps on long straight flat parts to go faster.
+        // Returns an id to get the status of this path
+        const unsigned int SetPath(const std::vector<Position>& path, const double speed, const bool sprint_jump = false);
+        // Stop following the current path
+        void Stop();
+
+        // Status of the path with this id, Idle if another path has been set since
+        const MovementStatus GetStatus(const unsigned int path_id) const;
+        // Average horizontal speed achieved while following the current
+        // (or last) path, in blocks/s
+        const double GetAchievedSpeed() const;
+
+        // Called by the physics thread at the beginning of each tick, with
+        // the player mutex locked. Push the movement of this tick in the
+        // player command queue, it is applied with the other commands.
+        // Returns true if the status of the current path changed
+        const bool Tick(LocalPlayer& player);
+
+    private:
+        const Vector3<double> GetNodeCenter(const size_t index) const;
+        // Horizontal distance between position and the [from, to] segment,
+        // t is set to the (not clamped) projection of position on the segment
+        const double SegmentDistance(const Vector3<double>& from, const Vector3<double>& to, const Vector3<double>& position, double& t) const;
+        // True if the player is already on the segment after node index
+        const bool IsPast(const size_t index, const Vector3<double>& position) const;
+        // True if moving from node index - 1 to node index requires a jump
+        const bool NeedJump(const size_t index) const;
+        const bool IsFlatStraight(const size_t index, const size_t num_nodes) const;
+        const Vector3<double> GetLookaheadTarget(const Vector3<double>& position) const;
+        void SetStatus(const MovementStatus status_);
+
+    private:
+        mutable std::mutex controller_mutex;
+
+        std::vector<Position> path;
+        double speed;
+        bool sprint_jump;
+        unsigned int path_id;
+        MovementStatus status;
+        bool status_changed;
+
+        // Index of the node the player is going to
+        size_t next_node;
+        // Progress tracking to detect when we are stuck
+        double best_distance;
+        int ticks_without_progress;
+
+        bool has_previous_position;
+        Vector3<double> previous_position;
+        double travelled_distance;
+        int moving_ticks;
+    };
+} // Botcraft
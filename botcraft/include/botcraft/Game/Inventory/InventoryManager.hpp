@@ -7,6 +7,7 @@
 #include "protocolCraft/Handler.hpp"
 
 #include "botcraft/Game/Enums.hpp"
+#include "botcraft/Utilities/Signal.hpp"
 
 namespace Botcraft
 {
@@ -28,6 +29,10 @@ namespace Botcraft
 
         std::mutex& GetMutex();
 
+        // Notified each time a slot, a window or a
+        // transaction state changes
+        const Signal& GetInventorySignal() const;
+
         const std::shared_ptr<Window> GetWindow(const short window_id) const;
         const short GetFirstOpenedWindowId() const;
         const std::shared_ptr<Window> GetPlayerInventory() const;
@@ -71,6 +76,7 @@ namespace Botcraft
 
     private:
         std::mutex inventory_manager_mutex;
+        Signal inventory_signal;
         std::map<short, std::shared_ptr<Window> > inventories;
         short index_hotbar_selected;
         ProtocolCraft::Slot cursor;
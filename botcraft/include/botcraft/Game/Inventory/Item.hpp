@@ -1,11 +1,20 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 namespace Botcraft
 {
+    namespace AssetsCache
+    {
+        class Reader;
+    }
+
     class Item
     {
+        // Creates items from the cache file
+        friend class AssetsCache::Reader;
+
     public:
 #if PROTOCOL_VERSION < 347
         Item(const int id_, const unsigned char damage_id_, const std::string& name_);
@@ -14,10 +23,15 @@ namespace Botcraft
 #endif
         const int GetId() const;
         const std::string& GetName() const;
+        const std::string_view GetNameView() const;
 #if PROTOCOL_VERSION < 347
         const unsigned char GetDamageId() const;
 #endif
 
+    private:
+        // Empty item, filled by the assets cache reader
+        Item();
+
     private:
         int id;
         std::string name;
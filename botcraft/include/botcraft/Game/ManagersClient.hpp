@@ -13,6 +13,7 @@ namespace Botcraft
     class World;
     class InventoryManager;
     class EntityManager;
+    class MovementController;
 
 #if USE_GUI
     namespace Renderer
@@ -46,10 +47,15 @@ namespace Botcraft
         std::shared_ptr<World> GetWorld() const;
         std::shared_ptr<EntityManager> GetEntityManager() const;
         std::shared_ptr<InventoryManager> GetInventoryManager() const;
+        // Follows the paths given by the behaviours, ticked by the physics thread
+        std::shared_ptr<MovementController> GetMovementController() const;
         const bool GetCreativeMode() const;
 
     protected:
         void RunSyncPos();
+        // Apply the queued movement commands and compute one physics
+        // tick of the local player. Returns true if the player moved
+        const bool PhysicsTick();
         void Physics(const bool is_in_fluid);
 
     protected:
@@ -65,6 +71,7 @@ namespace Botcraft
         std::shared_ptr<World> world;
         std::shared_ptr<EntityManager> entity_manager;
         std::shared_ptr<InventoryManager> inventory_manager;
+        std::shared_ptr<MovementController> movement_controller;
 #if USE_GUI
         // If true, opens a window to display the view
         // from the bot. Only one renderer can be active
@@ -6,6 +6,7 @@
 #include <unordered_map>
 #include <vector>
 #include <deque>
+#include <mutex>
 
 #include "botcraft/Game/AABB.hpp"
 #if USE_GUI
@@ -16,6 +17,11 @@
 
 namespace Botcraft 
 {
+    namespace AssetsCache
+    {
+        class Reader;
+    }
+
 #if USE_GUI
     struct FaceDescriptor
     {
@@ -35,6 +41,8 @@ namespace Botcraft
 
     class Model
     {
+        // Creates models with colliders stored in the cache file
+        friend class AssetsCache::Reader;
 
     private:
         // Constructor from a json file
@@ -55,8 +63,13 @@ namespace Botcraft
             return m1;
         }
 
+        // Colliders of the model. For the models read from the assets cache
+        // they are copied out of the mapped file on the first call
         const std::vector<AABB> &GetColliders() const;
+        // Owned colliders, only used while loading the models from json files
         std::vector<AABB> &GetColliders();
+        // Same as GetColliders, but never copies the mapped colliders
+        const AABBView GetCollidersView() const;
 
         static void ClearCache();
 
@@ -66,6 +79,8 @@ namespace Botcraft
 #endif
     private:
         static std::unordered_map<std::string, Model> cached_models;
+        // Protects the copies of the mapped colliders
+        static std::mutex mapped_colliders_mutex;
 
         bool ambient_occlusion;
 
@@ -76,6 +91,11 @@ namespace Botcraft
         //All the faces of this model
         std::vector<FaceDescriptor> faces;
 #endif
-        std::vector<AABB> colliders;
+        // Filled by GetColliders for the models read from the assets cache
+        mutable std::vector<AABB> colliders;
+        // Set for the models read from the assets cache, colliders
+        // are then a view into the mapped file instead of a copy
+        const AABB* mapped_colliders;
+        size_t num_mapped_colliders;
     };
 } // Botcraft
\ No newline at end of file
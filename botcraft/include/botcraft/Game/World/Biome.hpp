@@ -2,10 +2,16 @@
 
 #include <map>
 #include <string>
+#include <string_view>
 #include <memory>
 
 namespace Botcraft
 {
+    namespace AssetsCache
+    {
+        class Reader;
+    }
+
     // Enum for biomes with special color processing
     enum class BiomeType
     {
@@ -23,6 +29,9 @@ namespace Botcraft
 
     class Biome
     {
+        // Creates biomes from the cache file
+        friend class AssetsCache::Reader;
+
     public:
         Biome(const std::string &name_, const float temperature_,
               const float rainfall_, const BiomeType biome_type_);
@@ -32,7 +41,16 @@ namespace Botcraft
         const unsigned int GetColorMultiplier(const int height, const bool is_grass) const;
         const unsigned int GetWaterColorMultiplier() const;
 
+        const std::string &GetName() const;
+        const std::string_view GetNameView() const;
+        const float GetTemperature() const;
+        const float GetRainfall() const;
+        const BiomeType GetBiomeType() const;
+
     private:
+        // Empty biome, filled by the assets cache reader
+        Biome();
+
         // Compute the value of the pixel in the triangle defined by the colors of the three corners
         // height is 0 if y <= 64 and y - 64 otherwise
         const unsigned int ComputeColorTriangle(const int height, const bool is_grass) const;
@@ -16,19 +16,19 @@ namespace Botcraft
 #if PROTOCOL_VERSION < 347
         Block(const int id_ = 0, const unsigned char metadata_ = 0);
 
-        void ChangeBlockstate(const int id_, const unsigned char metadata_, const int model_id_ = -1);
+        void ChangeBlockstate(const int id_, const unsigned char metadata_);
 #else
         Block(const int id_ = 0);
 
-        void ChangeBlockstate(const int id_, const int model_id_ = -1);
+        void ChangeBlockstate(const int id_);
 #endif
 
-        const std::shared_ptr<Blockstate> GetBlockstate() const;
-        const unsigned short GetModelId() const;
+        const Blockstate* GetBlockstate() const;
 
     private:
-        std::shared_ptr<Blockstate> blockstate;
-        unsigned short model_id;
+        // Model variant is not stored, use
+        // Blockstate::GetModelId(position) instead
+        const Blockstate* blockstate;
     };
 
     typedef std::shared_ptr<Block> BlockPtr;
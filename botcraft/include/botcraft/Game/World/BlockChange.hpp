@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "botcraft/Game/Vector3.hpp"
+
+namespace Botcraft
+{
+    class Blockstate;
+
+    // Values can be combined in BlockChangeFilter::types
+    enum class BlockChangeType : unsigned char
+    {
+        ChunkLoaded = 1 << 0,
+        ChunkUnloaded = 1 << 1,
+        // Several blocks changed at once by the server, the
+        // BlockChanged events of each block are in the same batch
+        SectionChanged = 1 << 2,
+        BlockChanged = 1 << 3
+    };
+
+    struct BlockChangeEvent
+    {
+        BlockChangeType type;
+        // Bounding box (included) of the modified blocks
+        Position min;
+        Position max;
+        // Only for BlockChanged events, nullptr means air in an empty section
+        const Blockstate* previous;
+        const Blockstate* current;
+    };
+
+    struct BlockChangeFilter
+    {
+        BlockChangeFilter();
+
+        // Check if an event passes this filter. Not thread
+        // safe as the blocks matches are cached
+        const bool Match(const BlockChangeEvent& event) const;
+
+        // Mask of BlockChangeType values to receive, all by default
+        unsigned char types;
+
+        // If true, only the events intersecting [min, max] are received
+        bool use_region;
+        Position min;
+        Position max;
+
+        // If not empty, only the BlockChanged events from or to one of
+        // these blocks are received. Other types are not filtered by block
+        std::set<std::string> blocks;
+
+    private:
+        const bool MatchBlock(const Blockstate* blockstate) const;
+
+    private:
+        mutable std::unordered_map<const Blockstate*, bool> blocks_cache;
+    };
+
+    // Lock free queue of events with a single producer (the thread
+    // modifying the world, with the world mutex locked) and a single
+    // consumer. When full, new events are dropped and the consumer
+    // is told so it can resynchronize with the world.
+    class BlockChangeQueue
+    {
+    public:
+        // Capacity is rounded up to a power of two
+        BlockChangeQueue(const size_t capacity = 1 << 12);
+
+        BlockChangeQueue(const BlockChangeQueue&) = delete;
+        BlockChangeQueue& operator=(const BlockChangeQueue&) = delete;
+
+        // Producer side
+        void Push(const BlockChangeEvent& event);
+
+        // Consumer side, append all the available events to output.
+        // Returns false if some events have been dropped since the
+        // last call because the queue was full
+        const bool PopAll(std::vector<BlockChangeEvent>& output);
+
+    private:
+        std::vector<BlockChangeEvent> buffer;
+        size_t mask;
+        std::atomic<size_t> head;
+        std::atomic<size_t> tail;
+        std::atomic<bool> overflowed;
+    };
+} // namespace Botcraft
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <random>
 #include <map>
 
@@ -8,11 +9,20 @@
 
 #include "botcraft/Game/Model.hpp"
 #include "botcraft/Game/Enums.hpp"
+#include "botcraft/Game/Vector3.hpp"
 
 namespace Botcraft
 {
+    namespace AssetsCache
+    {
+        class Reader;
+    }
+
     class Blockstate
     {
+        // Creates blockstates that are views into the cache file
+        friend class AssetsCache::Reader;
+
     public:
 
 #if PROTOCOL_VERSION < 347
@@ -25,6 +35,11 @@ namespace Botcraft
                    const bool transparent_, const bool solid_, const bool fluid_,
                    const float hardness_, const TintType tint_type_, const std::string &name_,
                    const Model &model_);
+
+        Blockstate(const int id_, const unsigned char metadata_,
+                   const bool transparent_, const bool solid_, const bool fluid_,
+                   const float hardness_, const TintType tint_type_, const std::string &name_,
+                   const std::vector<Model> &models_, const std::vector<int> &models_weights_);
 #else
         Blockstate(const int id_,
                    const bool transparent_, const bool solid_, const bool fluid_, const bool custom,
@@ -35,15 +50,34 @@ namespace Botcraft
                    const bool transparent_, const bool solid_, const bool fluid_,
                    const float hardness_, const TintType tint_type_, const std::string &name_,
                    const Model &model_);
+
+        Blockstate(const int id_,
+                   const bool transparent_, const bool solid_, const bool fluid_,
+                   const float hardness_, const TintType tint_type_, const std::string &name_,
+                   const std::vector<Model> &models_, const std::vector<int> &models_weights_);
 #endif
+        // Copies point to their own copy of the owned data
+        Blockstate(const Blockstate& other);
+        Blockstate& operator=(const Blockstate& other);
+
         const unsigned int GetId() const;
 #if PROTOCOL_VERSION < 347
         const unsigned char GetMetadata() const;
 #endif
         const Model &GetModel(const unsigned char index) const;
-        const unsigned char GetRandomModelId();
+        const int GetModelWeight(const unsigned char index) const;
+        // Get the model variant used at this position. This is a pure
+        // function of (pos, blockstate), so it can be computed on demand
+        // by any thread and always gives the same result
+        const unsigned char GetModelId(const Position& pos) const;
         const int GetNumModels() const;
         const std::string &GetName() const;
+        // Same as GetName, names are stored once per process for all
+        // the blockstates, whether they are read from json or the cache
+        const std::string_view GetNameView() const;
+        // Same value for all the blockstates with the same name,
+        // faster than comparing the names
+        const unsigned int GetNameId() const;
 
         const bool IsAir() const;
         const bool IsSolid() const;
@@ -58,21 +92,43 @@ namespace Botcraft
 #endif
         static void ClearCache();
 
+    private:
+        // Empty blockstate, filled by the assets cache reader
+        Blockstate();
+        // Read the models of a blockstate from its json file
+        void LoadModels(const bool custom, const std::string &path, const std::vector<std::string> &variables);
+        // Point the views to the data owned by this blockstate
+        void SetOwnedViews();
+        // Unique copy of this name, shared by all the blockstates with
+        // this name. Also sets name_id, to new_id if the name is new
+        void SetName(const std::string_view name_, const unsigned int new_id);
+
     private:
         static std::map<std::string, nlohmann::json> cached_jsons;
+        // Keys are never removed, so blockstates can point to them
+        static std::map<std::string, unsigned int, std::less<> > name_ids;
 
         bool transparent;
         bool solid;
         bool fluid;
         float hardness;
         TintType tint_type;
-        std::string m_name;
+        unsigned int name_id;
 
-        std::vector<Model> models;
-        std::vector<int> models_weights;
-        int weights_sum;
+        // Key of name_ids
+        const std::string* name;
 
-        std::mt19937 random_generator;
+        // Data of the blockstates loaded from json files,
+        // empty for the ones read from the assets cache
+        std::vector<Model> owned_models;
+        std::vector<int> owned_models_weights;
+
+        // Point either to the data above or to the
+        // mapped assets cache, which is never unmapped
+        const Model* models;
+        const int* models_weights;
+        int num_models;
+        int weights_sum;
 
         unsigned int id;
 #if PROTOCOL_VERSION < 347
@@ -31,12 +31,21 @@ namespace Botcraft
         Chunk(const std::string& dim = "minecraft:overworld");
 #endif
         Chunk(const Chunk& c);
+        // Copy only the sections of c with copied_sections[i] set to true,
+        // the others are left empty
+        Chunk(const Chunk& c, const std::vector<bool>& copied_sections);
 
         static const Position BlockCoordsToChunkCoords(const Position& pos);
 
 #if USE_GUI
+        // True if any section has been modified
         const bool GetModifiedSinceLastRender() const;
+        // Set the modification state of all the sections
         void SetModifiedSinceLastRender(const bool b);
+        // One value per section, true if a block in the section (or
+        // on the border of the next one) has changed since the last render
+        const std::vector<bool>& GetModifiedSectionsSinceLastRender() const;
+        void SetSectionModifiedSinceLastRender(const int y, const bool b);
 #endif
 
 #if PROTOCOL_VERSION < 552
@@ -53,9 +62,9 @@ namespace Botcraft
 
         const Block *GetBlock(const Position &pos) const;
 #if PROTOCOL_VERSION < 347
-        void SetBlock(const Position &pos, const unsigned int id, unsigned char metadata, const int model_id = -1);
+        void SetBlock(const Position &pos, const unsigned int id, unsigned char metadata);
 #else
-        void SetBlock(const Position &pos, const unsigned int id, const int model_id = -1);
+        void SetBlock(const Position &pos, const unsigned int id);
 #endif
         void SetBlock(const Position& pos, const Block* block);
 
@@ -102,7 +111,7 @@ namespace Botcraft
         std::string dimension;
 #endif
 #if USE_GUI
-        bool modified_since_last_rendered;
+        std::vector<bool> modified_sections_since_last_rendered;
 #endif
     };
 } // Botcraft
\ No newline at end of file
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "botcraft/Game/Vector3.hpp"
+#include "botcraft/Game/World/BlockChange.hpp"
+
+namespace Botcraft
+{
+    class World;
+    class Blockstate;
+
+    enum class StructureDiffType
+    {
+        // Air instead of a block
+        Missing,
+        // A block instead of another one
+        Wrong,
+        // A block instead of air
+        Additional
+    };
+
+    struct StructureDiffEntry
+    {
+        Position position;
+        StructureDiffType type;
+        // Expected block name, minecraft:air for Additional
+        std::string expected;
+    };
+
+    // Difference between a target structure and the world. The full
+    // structure is compared once when a world is watched, then only
+    // the blocks reported by the world block change queues are
+    // checked again. All counts are kept up to date so querying them
+    // is O(1), remaining blocks are stored in a grid of cells to find
+    // the nearest ones without scanning everything. Blocks in chunks
+    // that are not loaded keep their last known state (Unknown at start).
+    // All functions are thread safe, but must not be called with the
+    // world mutex locked.
+    class StructureDiff
+    {
+    public:
+        // start/end: min/max (included) corners of the structure in the world
+        // target: palette id of each block relative to start, -1 for air
+        // palette: block name of each palette id
+        StructureDiff(const Position& start_, const Position& end_,
+            const std::vector<std::vector<std::vector<short> > >& target,
+            const std::map<short, std::string>& palette);
+        ~StructureDiff();
+
+        StructureDiff(const StructureDiff&) = delete;
+        StructureDiff& operator=(const StructureDiff&) = delete;
+
+        // Start following the changes in world. Several worlds
+        // can be watched if they are views of the same server
+        void Watch(const std::shared_ptr<World>& world);
+
+        // Apply the pending block changes of the watched worlds. All
+        // the queries do it, calling it first only moves the world
+        // reads out of the callers' critical sections
+        void Update();
+
+        const Position& GetStart() const;
+        const Position& GetEnd() const;
+
+        const size_t GetNumBlocks() const;
+        // Blocks not matching the target, whatever the reason
+        const size_t GetNumRemaining();
+        const size_t GetNumMissing();
+        const size_t GetNumWrong();
+        const size_t GetNumAdditional();
+        // Blocks never seen in a loaded chunk
+        const size_t GetNumUnknown();
+        // Percentage of blocks known to match the target
+        const float GetDonePercentage();
+
+        // Number of blocks of this type that still have to be
+        // placed, either missing or replacing a wrong one
+        const size_t GetNumNeeded(const std::string& item);
+        const std::map<std::string, size_t> GetNeededItems();
+
+        // Get up to max_num remaining blocks, in no particular order
+        const std::vector<StructureDiffEntry> GetRemaining(const size_t max_num);
+
+        // Get the remaining block closest to position
+        // Returns false if there is no remaining block
+        const bool GetNearestRemaining(const Vector3<double>& position, Position& out);
+
+        // Search the remaining blocks, by increasing distance to position, and
+        // call accept for each of them until it returns true. Only blocks that
+        // can be fixed by placing one of items (or by digging if include_dig
+        // is true) are considered. Each candidate is checked in world first,
+        // accept is called with the world mutex locked, its second parameter
+        // is the item to place, empty if the block has to be dug.
+        // Returns true if a block was accepted
+        const bool FindNearest(const Vector3<double>& position, const std::set<std::string>& items, const bool include_dig,
+            const std::shared_ptr<World>& world, const std::function<bool(const Position&, const std::string&)>& accept);
+
+    private:
+        enum class BlockDiff : unsigned char
+        {
+            Unknown,
+            Correct,
+            Missing,
+            Wrong,
+            Additional
+        };
+
+        struct WatchedWorld
+        {
+            std::weak_ptr<World> world;
+            size_t subscriber_id;
+            std::shared_ptr<BlockChangeQueue> queue;
+            // True if the whole structure must be read from this world
+            bool full_diff;
+        };
+
+        void ProcessBlockChanges();
+        // Read [min, max] from world, locking its mutex for
+        // one x slice at a time to not block the network thread
+        void UpdateBox(World& world, const Position& min, const Position& max);
+        void UpdateBlock(const int index, const Blockstate* blockstate);
+        void SetDiff(const int index, const BlockDiff diff);
+        // Kind 0 is digging, kind k + 1 is placing palette_names[k]
+        const short GetKind(const int index) const;
+        const int GetCellIndex(const Position& pos) const;
+        const int GetIndex(const Position& pos) const;
+        const Position GetPosition(const int index) const;
+
+    private:
+        std::mutex diff_mutex;
+
+        Position start;
+        Position end;
+        Position size;
+        Position num_cells;
+
+        // Kind to place at each block (-1 if air is expected),
+        // indexed by ((x * size.y) + y) * size.z + z
+        std::vector<short> target_kinds;
+        std::vector<BlockDiff> diffs;
+        std::vector<std::string> palette_names;
+        std::unordered_map<std::string, short> kinds_by_name;
+
+        // Remaining blocks of each cell, for each kind
+        std::vector<std::vector<std::unordered_set<int> > > cells;
+
+        size_t num_unknown;
+        size_t num_correct;
+        size_t num_missing;
+        size_t num_wrong;
+        size_t num_additional;
+        // Missing blocks for each kind
+        std::vector<size_t> num_needed;
+
+        std::vector<WatchedWorld> watched_worlds;
+        // Reused buffer for the events popped from the queues
+        std::vector<BlockChangeEvent> block_changes;
+    };
+} // namespace Botcraft
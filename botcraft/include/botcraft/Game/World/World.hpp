@@ -2,6 +2,7 @@
 
 #include <map>
 #include <array>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <queue>
@@ -9,6 +10,8 @@
 #include "botcraft/Game/Vector3.hpp"
 #include "botcraft/Game/Enums.hpp"
 #include "botcraft/Game/World/Chunk.hpp"
+#include "botcraft/Game/World/BlockChange.hpp"
+#include "botcraft/Utilities/Signal.hpp"
 
 #include "protocolCraft/Types/NBT/NBT.hpp"
 #include "protocolCraft/Handler.hpp"
@@ -42,6 +45,23 @@ namespace Botcraft
         std::mutex& GetMutex();
         const bool IsShared() const;
 
+        // Notified each time a block is changed or a chunk
+        // is loaded/unloaded
+        const Signal& GetBlockChangedSignal() const;
+
+        // Subscribe to the block changes matching filter. Events are
+        // sent by batch, one for each packet modifying the world.
+        // callback is called on the thread modifying the world, with
+        // the world mutex locked, so it should be fast and must not
+        // try to lock it again
+        const size_t SubscribeBlockChanges(const BlockChangeFilter& filter,
+            const std::function<void(const std::vector<BlockChangeEvent>&)>& callback);
+        // Same, but events are pushed in queue so they can be read on
+        // any thread without locking the world
+        const size_t SubscribeBlockChanges(const BlockChangeFilter& filter, const std::shared_ptr<BlockChangeQueue>& queue);
+        // Subscribe/Unsubscribe must not be called with the world mutex locked
+        void UnsubscribeBlockChanges(const size_t id);
+
         ProtocolCraft::Handler* GetAsyncHandler();
 
 #if PROTOCOL_VERSION < 719
@@ -53,7 +73,15 @@ namespace Botcraft
 
 #if USE_GUI
         const bool HasChunkBeenModified(const int x, const int z);
+        // Modification state of each section of the chunk,
+        // empty if the chunk is not loaded
+        const std::vector<bool> GetChunkModifiedSections(const int x, const int z);
         void ResetChunkModificationState(const int x, const int z);
+        // Loaded chunks with at least one section modified since their
+        // last ResetChunkModificationState. Blocks copied in the border of
+        // a neighbour chunk modify it too, so it's the only place to look
+        // for the chunks to render again, except for the unloaded ones
+        const std::vector<Position> GetModifiedChunks() const;
 #endif
 
 #if PROTOCOL_VERSION < 552
@@ -77,14 +105,21 @@ namespace Botcraft
         void UpdateChunk(const int x, const int z, const Position& pos = Position());
 
         const std::shared_ptr<const Chunk> GetChunkCopy(const int x, const int z);
+        // Copy only the sections with copied_sections[i] set to true
+        const std::shared_ptr<const Chunk> GetChunkCopy(const int x, const int z, const std::vector<bool>& copied_sections);
 
 #if PROTOCOL_VERSION < 347
-        bool SetBlock(const Position &pos, const unsigned int id, unsigned char metadata, const int model_id = -1);
+        bool SetBlock(const Position &pos, const unsigned int id, unsigned char metadata);
 #else
-        bool SetBlock(const Position &pos, const unsigned int id, const int model_id = -1);
+        bool SetBlock(const Position &pos, const unsigned int id);
 #endif
         //Get the block at a given position
         const Block* GetBlock(const Position& pos);
+        // Get the blockstates of all the blocks between min and max (included),
+        // reading all of them under a single lock. Output is indexed by
+        // ((y - min.y) * size_z + (z - min.z)) * size_x + (x - min.x),
+        // with nullptr for blocks in unloaded chunks
+        void GetBlockstates(const Position& min, const Position& max, std::vector<const Blockstate*>& output);
         const bool IsLoaded(const Position& pos) const;
 
         bool SetBlockEntityData(const Position &pos, const ProtocolCraft::NBT& data);
@@ -135,7 +170,7 @@ namespace Botcraft
         * @param[out] out_normal the normal of the face hit
         * @return the blockstate of the hit cube (or null)
         */
-        std::shared_ptr<Blockstate> Raycast(const Vector3<double> &origin, const Vector3<double> &direction,
+        const Blockstate* Raycast(const Vector3<double> &origin, const Vector3<double> &direction,
             const float max_radius, Position &out_pos, Position &out_normal);
 
         // Get the list of chunks
@@ -143,6 +178,13 @@ namespace Botcraft
 
     private:
         std::shared_ptr<Chunk> GetChunk(const int x, const int z);
+        // Add an event to the current batch, if not in
+        // a batch, the event is sent immediately
+        void PushBlockChange(const BlockChangeEvent& event);
+        void FlushBlockChanges();
+        // Add/Remove a subscriber from the chunk or global lists
+        void IndexBlockChangeSubscriber(const size_t id, const BlockChangeFilter& filter);
+        void UnindexBlockChangeSubscriber(const size_t id, const BlockChangeFilter& filter);
 
     protected:
         virtual void Handle(ProtocolCraft::ClientboundLoginPacket& msg) override;
@@ -160,6 +202,26 @@ namespace Botcraft
         int cached_x;
         int cached_z;
         std::mutex world_mutex;
+        Signal block_changed_signal;
+        struct BlockChangeSubscriber
+        {
+            BlockChangeFilter filter;
+            std::function<void(const std::vector<BlockChangeEvent>&)> callback;
+            std::shared_ptr<BlockChangeQueue> queue;
+        };
+        std::map<size_t, BlockChangeSubscriber> block_change_subscribers;
+        // Subscribers watching a small region, indexed by the chunks it
+        // intersects, so an event is only matched against the subscribers
+        // of its own chunks
+        std::map<std::pair<int, int>, std::vector<size_t> > chunk_block_change_subscribers;
+        // Subscribers matched against all the events
+        std::vector<size_t> global_block_change_subscribers;
+        std::vector<size_t> block_change_candidates;
+        size_t next_subscriber_id;
+        // Greater than 0 while a packet is processed
+        int block_changes_batch_depth;
+        std::vector<BlockChangeEvent> block_changes_batch;
+        std::vector<BlockChangeEvent> filtered_block_changes;
         std::shared_ptr<Chunk> cached;
 
         std::map<std::pair<int, int>, std::shared_ptr<Chunk> > terrain;
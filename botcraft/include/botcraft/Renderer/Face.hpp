@@ -42,6 +42,7 @@ namespace Botcraft
             void SetTextureMultipliers(const std::array<unsigned int, 2> &mult);
             const std::array<float, 4>& GetTextureCoords(const bool overlay) const;
             void SetTextureCoords(const std::array<float, 4>& coords, const bool overlay);
+            const unsigned int GetTextureData() const;
 
             static const std::vector<float> base_face;
 
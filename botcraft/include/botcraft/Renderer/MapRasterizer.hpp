@@ -0,0 +1,127 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "botcraft/Game/Enums.hpp"
+#include "botcraft/Game/Vector3.hpp"
+#include "botcraft/Game/World/Chunk.hpp"
+#include "botcraft/Game/World/BlockChange.hpp"
+
+namespace Botcraft
+{
+    class World;
+    class Blockstate;
+
+    namespace Renderer
+    {
+        // Top-down map of a world, computed on the CPU only so it can be
+        // used without any OpenGL context (headless servers for example).
+        // It still needs the block textures, so it's only built with the GUI.
+        // One pixel per block, north (-z) up, colored with the mean color of
+        // the top texture of the blocks and the height shading of the in-game
+        // maps. The surface of each column is kept and only the columns
+        // modified since the last Update are scanned again, in parallel for
+        // each chunk.
+        class MapRasterizer
+        {
+        public:
+            // If num_threads is 0, one thread per core is used
+            MapRasterizer(const std::shared_ptr<World>& world_, const unsigned int num_threads = 0);
+            ~MapRasterizer();
+
+            // Process the world modifications since the last call and scan
+            // the modified columns again. Returns the number of scanned chunks
+            const int Update();
+
+            // Get the RGBA image of the chunks between min and max (included),
+            // output is (max_z - min_z + 1) * 16 rows of (max_x - min_x + 1) * 16
+            // pixels. Columns not loaded are transparent
+            void Rasterize(const int min_chunk_x, const int min_chunk_z, const int max_chunk_x, const int max_chunk_z,
+                std::vector<unsigned char>& output) const;
+
+            // Save the image of the chunks between min and max (included) as png
+            void WriteTile(const std::string& path, const int min_chunk_x, const int min_chunk_z, const int max_chunk_x, const int max_chunk_z) const;
+
+            // Save all the tiles of tile_size x tile_size chunks modified
+            // since the last call as folder/x_z.png, with x and z the tile
+            // coordinates. Returns the number of written tiles
+            const int WriteModifiedTiles(const std::string& folder, const int tile_size = 32);
+
+        private:
+            // Surface of one column of the map
+            struct MapColumn
+            {
+                // 0xAABBGGRR color of the surface block, 0 for empty columns
+                unsigned int color = 0;
+                // Height of the surface block, -1 for empty columns
+                short height = -1;
+                // Lowest block used to compute the color (bottom of the water),
+                // changes below it don't modify the map
+                short floor = 0;
+                unsigned char water_depth = 0;
+            };
+
+            struct MapChunk
+            {
+                std::array<MapColumn, CHUNK_WIDTH * CHUNK_WIDTH> columns;
+                std::array<bool, CHUNK_WIDTH * CHUNK_WIDTH> modified_columns = {};
+                bool modified = false;
+                // Lowest modified block since the last scan
+                int lowest_modified_y = CHUNK_HEIGHT;
+            };
+
+            // Mark the columns of chunk between min and max (world coordinates) as modified
+            void MarkModified(MapChunk& chunk, const int chunk_x, const int chunk_z, const Position& min, const Position& max);
+            // Mark all the loaded chunks as modified and remove the unloaded ones
+            void Resynchronize();
+            // Scan the modified columns of a chunk
+            void ScanChunk(const int chunk_x, const int chunk_z, MapChunk& map_chunk);
+            // Find the surface of a column between min_y and the top of the chunk.
+            // Returns false if the surface may be below min_y
+            const bool ScanColumn(const Chunk& chunk, const int x, const int z, const int min_y, MapColumn& column) const;
+            const unsigned int GetColor(const Chunk& chunk, const int x, const int y, const int z,
+                const std::pair<unsigned int, TintType>& block_color) const;
+            void RasterizeImpl(const int min_chunk_x, const int min_chunk_z, const int max_chunk_x, const int max_chunk_z,
+                std::vector<unsigned char>& output) const;
+
+            // Run all the jobs on the worker threads and wait for them to finish
+            void RunJobs(std::vector<std::function<void()> >& jobs_);
+            void ProcessJobs();
+
+        private:
+            std::shared_ptr<World> world;
+            size_t subscription_id;
+            std::shared_ptr<BlockChangeQueue> block_changes;
+            std::vector<BlockChangeEvent> events;
+            bool should_resynchronize;
+
+            // Texture color (0xAABBGGRR) and tint of all the blockstates visible
+            // on the map, computed once so it can be read by all the threads
+            std::unordered_map<const Blockstate*, std::pair<unsigned int, TintType> > blockstate_colors;
+
+            // Chunks are stored with y = 0
+            std::unordered_map<Position, std::unique_ptr<MapChunk> > chunks;
+            // Chunks with a different image since the last WriteModifiedTiles
+            std::unordered_set<Position> modified_chunks;
+            mutable std::mutex map_mutex;
+
+            std::deque<std::function<void()> > jobs;
+            int num_running_jobs;
+            std::mutex mutex_jobs;
+            std::condition_variable condition_jobs;
+            std::condition_variable condition_done;
+            bool running;
+            std::vector<std::thread> threads;
+        };
+    } // Renderer
+} // Botcraft
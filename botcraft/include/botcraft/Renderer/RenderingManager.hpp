@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 #include <tuple>
@@ -16,6 +17,7 @@
 
 #include "botcraft/Game/Enums.hpp"
 #include "botcraft/Game/Vector3.hpp"
+#include "botcraft/Game/World/BlockChange.hpp"
 #include "botcraft/Renderer/Face.hpp"
 
 #include "protocolCraft/Handler.hpp"
@@ -26,6 +28,7 @@ namespace Botcraft
 {
     class World;
     class InventoryManager;
+    class Chunk;
 
     namespace Renderer
     {
@@ -47,6 +50,44 @@ namespace Botcraft
             NUMBER_OF_KEYS
         };
 
+        // Full detail, 2x2x2 and 4x4x4 blocks cells
+        static const int NUM_LOD_LEVELS = 3;
+
+        // Counters of the meshing threads since the renderer creation
+        struct MeshingStats
+        {
+            unsigned long long int meshed_sections;
+            // Visible block faces before merging
+            unsigned long long int block_faces;
+            // Faces actually sent to the GPU, lower than block_faces with greedy meshing
+            unsigned long long int rendered_faces;
+            // Total time spent in meshing, in microseconds
+            unsigned long long int meshing_time;
+            // Same counters for each level of detail. For lower levels, block_faces
+            // counts the visible block sides the section would have at full detail
+            std::array<unsigned long long int, NUM_LOD_LEVELS> lod_sections;
+            std::array<unsigned long long int, NUM_LOD_LEVELS> lod_block_faces;
+            std::array<unsigned long long int, NUM_LOD_LEVELS> lod_rendered_faces;
+        };
+
+        // Memory used by the rendered faces, updated at each frame
+        struct MemoryStats
+        {
+            // Faces currently in the GPU buffer
+            size_t gpu_face_bytes;
+            // Allocated size of the GPU buffers, including the free space
+            size_t gpu_buffer_bytes;
+            // Faces waiting to be sent to the GPU, and
+            // partially transparent faces kept for sorting
+            size_t cpu_face_bytes;
+            // 0 if there is no budget
+            size_t memory_budget;
+            // Sections with faces dropped to fit in the budget
+            int num_evicted_sections;
+            // Sections with data kept by the renderer
+            int num_section_entries;
+        };
+
         class RenderingManager : public ProtocolCraft::Handler
         {
         public:
@@ -54,10 +95,12 @@ namespace Botcraft
             // Window can be resized at runtime
             // Chunks in renderer are independant of chunks in the corresponding world.
             // Set headless_ to true to run without opening a window (rendering is still done)
+            // Set greedy_meshing to true to merge the identical opaque faces of adjacent blocks
             RenderingManager(std::shared_ptr<World> world_, std::shared_ptr<InventoryManager> inventory_manager_,
                 const unsigned int &window_width, const unsigned int &window_height,
                 const std::vector<std::pair<std::string, std::string> > &textures_path_names,
-                const unsigned int section_height_ = 16, const bool headless = false);
+                const unsigned int section_height_ = 16, const bool headless = false,
+                const bool greedy_meshing = false);
             ~RenderingManager();
 
             // Set a flag to terminate the rendering loop after the current frame
@@ -66,6 +109,8 @@ namespace Botcraft
             // Set mouse and keyboard callbacks to handle user inputs
             void SetMouseCallback(std::function<void(double, double)> callback);
             void SetKeyboardCallback(std::function<void(std::array<bool, (int)KEY_CODE::NUMBER_OF_KEYS>, double)> callback);
+            // Check this chunk for modified sections without waiting for the
+            // next world change. Its neighbours are checked only if their border changed
             void AddChunkToUpdate(const int x, const int z);
 
             // Set world renderer's camera position and orientation
@@ -74,14 +119,39 @@ namespace Botcraft
             // Take a screenshot of the current frame and save it to path
             void Screenshot(const std::string &path);
 
+            const MeshingStats GetMeshingStats() const;
+
+            // Set the horizontal distances from the camera after which the
+            // chunks are rendered with a lower level of detail. A chunk only
+            // changes level when it's hysteresis blocks past a distance, so
+            // it's not meshed again and again when the camera moves around it.
+            // Use distances greater than the view distance to disable it
+            void SetLodDistances(const std::array<float, NUM_LOD_LEVELS - 1>& distances, const float hysteresis = 8.0f);
+
+            // Limit the memory used by the faces (GPU buffer and CPU copies),
+            // 0 for no limit. When it's exceeded, the sections furthest from
+            // the camera are dropped, and meshed again when it gets closer
+            void SetMemoryBudget(const size_t bytes);
+            const MemoryStats GetMemoryStats() const;
+
         protected:
             void WaitForRenderingUpdate();
+            // Loop of the meshing workers
+            void MeshSections();
+            // Mesh again the chunks with a different level of detail
+            // if the camera entered another chunk
+            void UpdateLods();
+            // Level of detail of a chunk at the current camera position
+            const int SelectLod(const Position& chunk, const int current_lod, const double camera_x, const double camera_z);
+            // Mesh again the sections dropped by the memory budget
+            // that are now close enough to the camera
+            void RestoreEvictedSections();
+
+            // Called by the world for each batch of block changes,
+            // queue the unloaded chunks and wake up the update thread
+            void OnBlockChanges(const std::vector<BlockChangeEvent>& events);
 
             virtual void Handle(ProtocolCraft::Message& msg) override;
-            virtual void Handle(ProtocolCraft::ClientboundBlockUpdatePacket& msg) override;
-            virtual void Handle(ProtocolCraft::ClientboundSectionBlocksUpdatePacket& msg) override;
-            virtual void Handle(ProtocolCraft::ClientboundForgetLevelChunkPacket& msg) override;
-            virtual void Handle(ProtocolCraft::ClientboundLevelChunkPacket& msg) override;
             virtual void Handle(ProtocolCraft::ClientboundSetTimePacket& msg) override;
             virtual void Handle(ProtocolCraft::ClientboundRespawnPacket& msg) override;
 
@@ -92,6 +162,9 @@ namespace Botcraft
             // Main rendering loop
             void Run(const bool headless);
 
+            // Stop and join the chunk updating and meshing threads
+            void StopUpdatingThreads();
+
             // Callbacks called by glfw
             static void ResizeCallback(GLFWwindow* window, int width, int height);
             static void InternalMouseCallback(GLFWwindow *window, double xpos, double ypos);
@@ -138,11 +211,50 @@ namespace Botcraft
 
             bool running;
 
+            // Id of the world block changes subscription
+            size_t block_changes_subscriber_id;
             std::unordered_set<Position> chunks_to_udpate;
             std::mutex mutex_updating;
             std::condition_variable condition_update;
             // Thread used to update the rendered chunks with current world data 
             std::thread thread_updating_chunks; 
+
+            // A rendering section of a chunk copy to mesh
+            struct MeshingJob
+            {
+                std::shared_ptr<const Botcraft::Chunk> chunk;
+                Position section;
+                unsigned long long int version;
+                int lod;
+            };
+            std::deque<MeshingJob> meshing_jobs;
+            std::mutex mutex_meshing;
+            std::condition_variable condition_meshing;
+            unsigned long long int meshing_version;
+            // Threads computing the faces of the sections in meshing_jobs
+            std::vector<std::thread> meshing_threads;
+            // Jobs taken by the meshing threads and not finished yet
+            int num_running_meshing_jobs;
+            std::atomic<unsigned long long int> meshed_sections;
+            std::atomic<unsigned long long int> meshed_block_faces;
+            std::atomic<unsigned long long int> meshed_rendered_faces;
+            std::atomic<unsigned long long int> meshing_time;
+            std::array<std::atomic<unsigned long long int>, NUM_LOD_LEVELS> meshed_lod_sections;
+            std::array<std::atomic<unsigned long long int>, NUM_LOD_LEVELS> meshed_lod_block_faces;
+            std::array<std::atomic<unsigned long long int>, NUM_LOD_LEVELS> meshed_lod_rendered_faces;
+
+            // Level of detail of each loaded chunk (y = 0), only
+            // used in the chunk updating thread
+            std::unordered_map<Position, int> chunks_lod;
+            // Camera chunk when the levels were last updated
+            Position lod_camera_chunk;
+            // Protected by mutex_updating
+            std::array<float, NUM_LOD_LEVELS - 1> lod_distances;
+            float lod_hysteresis;
+            bool lods_should_be_updated;
+
+            MemoryStats memory_stats;
+            mutable std::mutex mutex_memory_stats;
         };
     } // Renderer
 } // Botcraft
\ No newline at end of file
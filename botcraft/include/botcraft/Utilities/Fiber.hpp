@@ -0,0 +1,61 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <exception>
+
+namespace Botcraft
+{
+    /// @brief A stackful coroutine. The function runs on its own
+    /// stack and can suspend itself at any depth, giving the
+    /// control back to the thread that resumed it.
+    class Fiber
+    {
+    public:
+        /// @brief Create a fiber, the function is not started until the first Resume
+        /// @param function_ Function to run inside the fiber
+        /// @param stack_size Size of the fiber stack in bytes. Memory is reserved
+        /// but only committed by the OS when actually used
+        Fiber(const std::function<void()>& function_, const size_t stack_size = 1024 * 1024);
+        /// @brief If the function is suspended, it is resumed with Suspend
+        /// throwing Unwind until it returns, so the destructors of the
+        /// objects on the fiber stack are called before it is freed
+        ~Fiber();
+
+        Fiber(const Fiber&) = delete;
+        Fiber& operator=(const Fiber&) = delete;
+
+        /// @brief Run the fiber until it calls Suspend or returns.
+        /// Must not be called from inside the fiber itself. If the function
+        /// exits with an exception, it is rethrown here.
+        void Resume();
+
+        /// @brief Give the control back to the caller of Resume.
+        /// Must be called from inside the fiber. Throws Unwind
+        /// if the fiber is resumed by its destructor.
+        void Suspend();
+
+        const bool IsFinished() const;
+
+        /// @brief Thrown by Suspend when the fiber is destroyed before
+        /// its function returned. Can be caught to clean up, but must
+        /// be rethrown so the function returns.
+        struct Unwind {};
+
+    private:
+        static void Run(Fiber* fiber);
+        // Resume a suspended fiber until its function returned
+        void UnwindStack();
+
+    private:
+        struct Context;
+
+        std::function<void()> function;
+        std::unique_ptr<Context> context;
+        std::exception_ptr exception;
+        bool started;
+        bool finished;
+        bool running;
+        bool unwinding;
+    };
+} // namespace Botcraft
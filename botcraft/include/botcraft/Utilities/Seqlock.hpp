@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace Botcraft
+{
+    /// @brief A value published by one writer at a time and read by
+    /// any number of threads without locking. Readers never block the
+    /// writer, they retry if the value changed while they were copying
+    /// it. Writers must be serialized by the caller (for example with
+    /// a mutex only the writers take).
+    template<class T>
+    class Seqlock
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Seqlock value must be trivially copyable");
+
+    public:
+        Seqlock() : sequence(0)
+        {
+            Store(T());
+        }
+
+        Seqlock(const Seqlock&) = delete;
+        Seqlock& operator=(const Seqlock&) = delete;
+
+        void Store(const T& value)
+        {
+            std::uint64_t buffer[num_words] = {};
+            std::memcpy(buffer, &value, sizeof(T));
+
+            const unsigned long long int current = sequence.load(std::memory_order_relaxed);
+            // Odd sequence means a write is in progress
+            sequence.store(current + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (size_t i = 0; i < num_words; ++i)
+            {
+                words[i].store(buffer[i], std::memory_order_relaxed);
+            }
+            sequence.store(current + 2, std::memory_order_release);
+        }
+
+        const T Load() const
+        {
+            std::uint64_t buffer[num_words];
+            unsigned long long int before;
+            unsigned long long int after;
+            do
+            {
+                before = sequence.load(std::memory_order_acquire);
+                for (size_t i = 0; i < num_words; ++i)
+                {
+                    buffer[i] = words[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                after = sequence.load(std::memory_order_relaxed);
+            } while (before != after || (before & 1));
+
+            T value;
+            std::memcpy(&value, buffer, sizeof(T));
+            return value;
+        }
+
+    private:
+        static constexpr size_t num_words = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+        std::atomic<unsigned long long int> sequence;
+        std::atomic<std::uint64_t> words[num_words];
+    };
+} // namespace Botcraft
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+
+namespace Botcraft
+{
+    /// @brief A lightweight change notification. Producers call Notify
+    /// each time the watched state changes, consumers save the version
+    /// and later check if it has changed. Consumers that need to be
+    /// woken up can also add a listener, called by Notify. Without
+    /// listener, it never blocks and can be shared by any number of
+    /// producer and consumer threads.
+    class Signal
+    {
+    public:
+        Signal() : version(0), num_listeners(0)
+        {
+            next_listener_id = 0;
+        }
+
+        Signal(const Signal&) = delete;
+        Signal& operator=(const Signal&) = delete;
+
+        void Notify()
+        {
+            // Sequentially consistent, so either Notify sees a listener
+            // added before, or the listener owner sees the new version
+            version.fetch_add(1);
+            if (num_listeners.load() == 0)
+            {
+                return;
+            }
+            std::lock_guard<std::mutex> listeners_guard(listeners_mutex);
+            for (auto it = listeners.begin(); it != listeners.end(); ++it)
+            {
+                it->second();
+            }
+        }
+
+        const unsigned long long int GetVersion() const
+        {
+            return version.load();
+        }
+
+        /// @brief Add a function called on the notifying thread after
+        /// each Notify. It must be fast and must not add or remove listeners.
+        /// Const as it doesn't change the watched state.
+        /// @param listener The function to call
+        /// @return An id to use with RemoveListener
+        const size_t AddListener(const std::function<void()>& listener) const
+        {
+            std::lock_guard<std::mutex> listeners_guard(listeners_mutex);
+            const size_t id = next_listener_id++;
+            listeners[id] = listener;
+            num_listeners.fetch_add(1);
+            return id;
+        }
+
+        /// @brief Remove a listener. Once returned, it is guaranteed
+        /// that the listener is not running and won't be called anymore.
+        /// @param id The id returned by AddListener
+        void RemoveListener(const size_t id) const
+        {
+            std::lock_guard<std::mutex> listeners_guard(listeners_mutex);
+            if (listeners.erase(id))
+            {
+                num_listeners.fetch_sub(1);
+            }
+        }
+
+    private:
+        std::atomic<unsigned long long int> version;
+        mutable std::atomic<int> num_listeners;
+        mutable std::mutex listeners_mutex;
+        mutable std::map<size_t, std::function<void()> > listeners;
+        mutable size_t next_listener_id;
+    };
+} // namespace Botcraft
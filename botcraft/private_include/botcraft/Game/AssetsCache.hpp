@@ -0,0 +1,186 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+
+#include "botcraft/Game/AABB.hpp"
+#include "botcraft/Utilities/MemoryMappedFile.hpp"
+
+namespace Botcraft
+{
+    class Blockstate;
+    class Biome;
+    class Item;
+    class Model;
+
+    // Binary precompiled version of all the assets loaded by the
+    // AssetsManager (blockstates, models, biomes and items)
+    // The file is a header followed by arrays of fixed size records
+    // and two blobs (strings and model faces). All references
+    // between sections are offsets so the file can be mapped as is
+    namespace AssetsCache
+    {
+        // Must be incremented each time the layout of the file changes
+        static const unsigned int FORMAT_VERSION = 3;
+
+        struct Header
+        {
+            char magic[4];
+            unsigned int format_version;
+            int protocol_version;
+            unsigned int use_gui;
+            unsigned long long int source_signature;
+            unsigned int num_blockstates;
+            unsigned int num_models;
+            unsigned int num_colliders;
+            unsigned int num_biomes;
+            unsigned int num_items;
+            unsigned int strings_size;
+            unsigned long long int faces_size;
+            unsigned int num_textures;
+            unsigned int padding;
+        };
+
+        enum BlockstateFlags : unsigned char
+        {
+            Transparent = 1 << 0,
+            Solid = 1 << 1,
+            Fluid = 1 << 2
+        };
+
+        struct BlockstateRecord
+        {
+            int id;
+            unsigned char metadata;
+            unsigned char flags;
+            unsigned char tint_type;
+            // Metadata used as key in AssetsManager (can differ
+            // from metadata when a blockstate is shared, < 1.13)
+            unsigned char key_metadata;
+            float hardness;
+            unsigned int name_offset;
+            unsigned int name_size;
+            unsigned int name_id;
+            // Index of the first model in the models
+            // and the weights sections
+            unsigned int first_model;
+            unsigned int num_models;
+        };
+
+        // Colliders are stored as AABB in the file,
+        // so models can point to them directly
+        struct ModelRecord
+        {
+            unsigned int first_collider;
+            unsigned int num_colliders;
+            unsigned long long int faces_offset;
+        };
+
+        struct BiomeRecord
+        {
+            int id;
+            float temperature;
+            float rainfall;
+            int biome_type;
+            unsigned int name_offset;
+            unsigned int name_size;
+        };
+
+        struct ItemRecord
+        {
+            int id;
+            unsigned char damage_id;
+            unsigned char padding[3];
+            unsigned int name_offset;
+            unsigned int name_size;
+        };
+
+        struct TextureRecord
+        {
+            unsigned int name_offset;
+            unsigned int name_size;
+        };
+
+        // Compute a signature of all the files the cache is built from
+        // (custom json files, minecraft blockstates and models). Only
+        // paths, sizes and modification times are used, no file is read
+        const unsigned long long int ComputeSourceSignature(const std::string& assets_path);
+
+        class Writer
+        {
+        public:
+            Writer(const unsigned long long int source_signature_);
+
+            void AddBlockstate(const Blockstate& blockstate, const unsigned char key_metadata = 0);
+            void AddBiome(const int id, const Biome& biome);
+            void AddItem(const Item& item);
+            // Name of a texture used by the block models
+            void AddTexture(const std::string& name);
+
+            // Write all the data to the given file, return false on error
+            const bool Save(const std::string& path) const;
+
+        private:
+            const unsigned int AddString(const std::string_view s);
+            void AddModel(const Model& model, const int weight);
+
+        private:
+            unsigned long long int source_signature;
+
+            std::vector<BlockstateRecord> blockstates;
+            std::vector<ModelRecord> models;
+            std::vector<int> weights;
+            std::vector<AABB> colliders;
+            std::vector<BiomeRecord> biomes;
+            std::vector<ItemRecord> items;
+            std::vector<TextureRecord> textures;
+            std::vector<char> strings;
+            std::vector<char> faces;
+        };
+
+        class Reader
+        {
+        public:
+            // Map the given file, IsValid() returns false if the
+            // file is missing, corrupted or built from different sources.
+            // The file is never copied, all the processes reading
+            // it share the same physical pages
+            Reader(const std::string& path, const unsigned long long int expected_signature);
+
+            const bool IsValid() const;
+
+            const size_t GetNumTextures() const;
+
+            // All the objects below are read-only views into the
+            // mapped file (names, colliders and weights are not
+            // copied), the reader must outlive them
+            std::vector<Model> CreateModels() const;
+            // Blockstates are allocated at once, their models point into the
+            // given vector, which must be the output of CreateModels
+            std::vector<std::shared_ptr<Blockstate> > CreateBlockstates(const std::vector<Model>& models_, std::vector<unsigned char>& key_metadata) const;
+            std::vector<std::pair<int, std::shared_ptr<Biome> > > CreateBiomes() const;
+            std::vector<std::shared_ptr<Item> > CreateItems() const;
+            const std::string GetTextureName(const size_t i) const;
+
+        private:
+            const std::string_view GetString(const unsigned int offset, const unsigned int size) const;
+
+        private:
+            MemoryMappedFile file;
+            bool valid;
+
+            const Header* header;
+            const BlockstateRecord* blockstates;
+            const ModelRecord* models;
+            const int* weights;
+            const AABB* colliders;
+            const BiomeRecord* biomes;
+            const ItemRecord* items;
+            const TextureRecord* textures;
+            const char* strings;
+            const char* faces;
+        };
+    } // AssetsCache
+} // Botcraft
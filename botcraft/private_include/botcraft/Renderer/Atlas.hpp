@@ -1,3 +1,5 @@
+#pragma once
+
 #include <string>
 #include <vector>
 #include <map>
@@ -28,8 +30,10 @@ namespace Botcraft
 
             void Reset(const int height_, const int width_);
 
-            // Load data 
-            void LoadData(const std::vector<std::pair<std::string, std::string> > &textures_path);
+            // Load data. If cache_path is not empty, the packed atlas is
+            // read from this file if it was built from the same textures,
+            // or written to it after loading the textures
+            void LoadData(const std::vector<std::pair<std::string, std::string> > &textures_path, const std::string& cache_path = "");
 
             const int GetWidth() const;
             const int GetHeight() const;
@@ -41,6 +45,14 @@ namespace Botcraft
 
             unsigned char* Get(const int row = 0, const int col = 0, const int depth = 0);
 
+        private:
+            // Build the atlas from the texture files
+            void LoadTextures(const std::vector<std::pair<std::string, std::string> >& textures_path);
+            // Returns false if the file is missing, invalid or
+            // built from textures with a different signature
+            const bool LoadCacheFile(const std::string& path, const unsigned long long int signature);
+            void WriteCacheFile(const std::string& path, const unsigned long long int signature) const;
+
         private:
 
             std::vector<unsigned char> data;
@@ -1,9 +1,11 @@
 #pragma once
 
-#include <deque>
 #include <mutex>
+#include <vector>
 
-#include "botcraft/Renderer/Face.hpp"
+#include <glm/vec3.hpp>
+
+#include "botcraft/Renderer/FaceBuffer.hpp"
 
 namespace Botcraft
 {
@@ -12,9 +14,9 @@ namespace Botcraft
         // Status of a face buffer
         enum class BufferStatus
         {
-            Created,  // The buffer is new, must be created in OpenGL
-            Updated,  // The existing buffer has been updated
-            UpToDate, // The OpenGL buffer is up to date
+            Created,  // The faces are new, they don't have space in the buffer yet
+            Updated,  // The faces have been updated
+            UpToDate, // The faces in the buffer are up to date
         };
 
         class Chunk
@@ -23,23 +25,26 @@ namespace Botcraft
             Chunk();
             ~Chunk();
 
-            void Update();
-            void AddFace(const Face &f);
+            // Send the faces to buffer if they have changed. The CPU
+            // copy of the faces is released once they are sent, a new
+            // one is only set when the section is meshed again
+            void Update(FaceBuffer& buffer);
+            // Replace all the faces of this chunk with faces.
+            // faces is swapped with the previous ones
+            void SetFaces(std::vector<PackedFace>& faces);
             void ClearFaces();
             const unsigned int GetNumFace() const;
-            void Render() const;
-
-        protected:
-            void GenerateOpenGLBuffer();
-            void DeleteOpenGLBuffer();
+            // Memory used by the faces kept on the CPU side
+            const size_t GetCPUBytes();
+            // Draw the faces, origin is the position of the section corner
+            void Render(const FaceBuffer& buffer, const glm::vec3& origin) const;
 
         protected:
-            unsigned int faces_VAO;
-            unsigned int faces_VBO;
-            unsigned int data_VBO;
             unsigned int face_number;
 
-            std::deque<Face> faces_positions;
+            std::vector<PackedFace> faces_positions;
+            // Range of the faces in the shared buffer
+            FaceAllocation allocation;
 
             BufferStatus buffer_status;
 
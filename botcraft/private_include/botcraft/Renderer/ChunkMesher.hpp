@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "botcraft/Renderer/FaceShapeTable.hpp"
+#include "botcraft/Renderer/SectionVisibility.hpp"
+
+namespace Botcraft
+{
+    class Biome;
+    class Blockstate;
+    class Chunk;
+    struct FaceDescriptor;
+
+    namespace Renderer
+    {
+        // Faces of one rendering section
+        struct SectionMesh
+        {
+            std::vector<PackedFace> opaque_faces;
+            // Faces with partially transparent textures,
+            // they need to be sorted before rendering
+            std::vector<PackedFace> transparent_faces;
+            // Which faces of the section can see each other
+            SectionVisibility visibility;
+            // Number of visible block faces, before greedy meshing. For
+            // LOD meshes, number of visible block sides at full detail
+            unsigned int num_block_faces;
+            // Level of detail of the faces, cells of 2^lod blocks
+            int lod;
+
+            // Buffers used to compute visibility, kept to avoid reallocations
+            std::vector<bool> opaque_blocks;
+            std::vector<bool> visited_blocks;
+            // Faces waiting to be merged, one per block and per orientation.
+            // Cells are emptied by the merge, so it's only filled once
+            std::vector<PackedFace> mergeable_faces;
+            // Content of the cells of LOD meshes
+            std::vector<const Blockstate*> lod_cells;
+        };
+
+        // Compute the faces to render for the blocks of a chunk, one
+        // rendering section at a time. It doesn't use OpenGL and its only
+        // mutable state is the thread safe shape table, so the same mesher
+        // can be used to mesh several sections in parallel from different threads.
+        // With greedy meshing, the opaque faces covering a whole block side are
+        // merged with the identical faces of their neighbours into bigger quads.
+        // Distant sections can be meshed with a lower level of detail, where
+        // cubes of 2^lod blocks are rendered as one big block
+        class ChunkMesher
+        {
+        public:
+            ChunkMesher(const std::shared_ptr<const Atlas> atlas_, const unsigned int section_height_,
+                const bool greedy_meshing_ = false);
+
+            const unsigned int GetSectionHeight() const;
+            const int GetNumSections() const;
+            const bool GetGreedyMeshing() const;
+            // Shapes referenced by the faces of the meshes
+            const FaceShapeTable& GetShapes() const;
+
+            // Get the rendering sections to mesh again when the world sections
+            // with modified_sections[i] set to true have changed, and the world
+            // sections of the chunk needed to mesh them
+            void GetSectionsToUpdate(const std::vector<bool>& modified_sections,
+                std::vector<int>& sections_to_mesh, std::vector<bool>& required_sections) const;
+
+            // Fill mesh with the faces of the blocks of chunk between
+            // section_y * section_height and (section_y + 1) * section_height.
+            // Previous content of mesh is cleared, but its memory is reused.
+            // chunk must contain the border blocks of its neighbours, as
+            // the chunks of World do. chunk can be nullptr for an unloaded chunk.
+            // With lod > 0, all the blocks of the chunk may be used, and the
+            // lod is lowered if 2^lod doesn't divide the section height
+            void MeshSection(const Botcraft::Chunk* chunk, const int chunk_x, const int chunk_z,
+                const int section_y, SectionMesh& mesh, const int lod = 0) const;
+
+        private:
+            // Add a face at block (x_, y_, z_), relative to the
+            // section origin, to the right list of mesh. Faces with
+            // size_ > 1 are stretched over size_^3 blocks
+            void AddFace(const int x_, const int y_, const int z_, const FaceDescriptor& descriptor_,
+                const std::array<unsigned int, 2>& texture_multipliers_,
+                SectionMesh& mesh, const int size_ = 1) const;
+
+            // Mesh the blocks between min_y and max_y as cells of factor^3 blocks
+            void MeshSectionLod(const Botcraft::Chunk* chunk, const int chunk_x, const int chunk_z,
+                const int min_y, const int max_y, const int factor, SectionMesh& mesh) const;
+
+            // Merge the faces in mesh.mergeable_faces and add them to the opaque faces
+            void MergeFaces(const int height, SectionMesh& mesh) const;
+
+            // Returns the color modifier (for redstone/leaves/water etc...)
+            const std::array<unsigned int, 2> GetColorModifier(const int y, const Biome* biome, const Blockstate* blockstate, const std::vector<bool>& use_tintindex) const;
+
+        private:
+            std::unique_ptr<FaceShapeTable> shapes;
+            unsigned int section_height;
+            bool greedy_meshing;
+        };
+    } // Renderer
+} // Botcraft
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "botcraft/Renderer/FaceBufferAllocator.hpp"
+#include "botcraft/Renderer/FaceShapeTable.hpp"
+
+namespace Botcraft
+{
+    namespace Renderer
+    {
+        // OpenGL buffers shared by all the rendering sections. The faces
+        // of every section are stored in one big instance buffer, each
+        // section owning a range of it, and the shapes they reference are
+        // stored in a texture buffer read by the vertex shader.
+        // Must be created and used in the OpenGL thread.
+        class FaceBuffer
+        {
+        public:
+            FaceBuffer();
+            ~FaceBuffer();
+
+            // Send the shapes added to the table since the last call,
+            // the texture buffer is moved to a bigger one when full
+            void UpdateShapes(const FaceShapeTable& shapes);
+
+            // Send faces to the buffer. They are written in place if they
+            // still fit in allocation, else allocation is moved to a new
+            // range. An empty faces vector frees the allocation
+            void Upload(const std::vector<PackedFace>& faces, FaceAllocation& allocation);
+
+            // Bind the buffers and textures used by Draw
+            void Bind(const unsigned int program);
+            // Draw the first num_faces faces of allocation, with
+            // their positions relative to origin
+            void Draw(const FaceAllocation& allocation, const unsigned int num_faces, const glm::vec3& origin) const;
+
+            // Number of bytes sent since the last reset
+            const size_t GetUploadedBytes() const;
+            void ResetUploadedBytes();
+            // Size of the face and shape buffers on the GPU
+            const size_t GetAllocatedBytes() const;
+
+        private:
+            // Move the faces to a bigger buffer
+            void Grow(const unsigned int new_capacity);
+            // Move the shapes to a bigger texture buffer
+            void GrowShapes(const size_t new_capacity);
+
+        private:
+            unsigned int faces_VAO;
+            unsigned int base_face_VBO;
+            unsigned int data_VBO;
+            FaceBufferAllocator allocator;
+
+            unsigned int shapes_TBO;
+            unsigned int shapes_texture;
+            size_t num_shapes;
+            // Number of shapes the texture buffer can store
+            size_t shapes_capacity;
+
+            int section_origin_location;
+
+            size_t uploaded_bytes;
+        };
+    } // Renderer
+} // Botcraft
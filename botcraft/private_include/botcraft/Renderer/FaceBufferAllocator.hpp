@@ -0,0 +1,52 @@
+#pragma once
+
+#include <map>
+
+namespace Botcraft
+{
+    namespace Renderer
+    {
+        // A range of faces in the shared face buffer
+        struct FaceAllocation
+        {
+            unsigned int offset = 0;
+            // Number of faces reserved, can be more than
+            // the number of faces actually stored
+            unsigned int size = 0;
+        };
+
+        // Manage the free space of a buffer shared by all the rendering
+        // sections. Sizes and offsets are in number of faces. It doesn't
+        // use OpenGL, FaceBuffer does the actual memory operations.
+        class FaceBufferAllocator
+        {
+        public:
+            FaceBufferAllocator(const unsigned int capacity_ = 0);
+
+            // Reserve a range big enough for num_faces, with some extra
+            // space so it can be updated in place when it grows a bit.
+            // Returns false if there is no free range big enough
+            const bool Allocate(const unsigned int num_faces, FaceAllocation& allocation);
+            // Make sure allocation can store num_faces. It's kept if the faces
+            // still fit and use at least a quarter of it, else it's moved to a
+            // new range. Returns false if there is no free range big enough,
+            // allocation is then empty and the buffer should grow
+            const bool Resize(const unsigned int num_faces, FaceAllocation& allocation);
+            // Give back the range, allocation is reset
+            void Free(FaceAllocation& allocation);
+            // Add free space at the end of the buffer
+            void Grow(const unsigned int new_capacity);
+
+            const unsigned int GetCapacity() const;
+            const unsigned int GetUsed() const;
+            // Size of the biggest free range
+            const unsigned int GetLargestFreeRange() const;
+
+        private:
+            // offset --> size, ordered so neighbour ranges can be merged
+            std::map<unsigned int, unsigned int> free_ranges;
+            unsigned int capacity;
+            unsigned int used;
+        };
+    } // Renderer
+} // Botcraft
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "botcraft/Renderer/Atlas.hpp"
+#include "botcraft/Renderer/Face.hpp"
+
+namespace Botcraft
+{
+    struct FaceDescriptor;
+
+    namespace Renderer
+    {
+        // Instance data of one face sent to OpenGL, 16 bytes. Everything
+        // that only depends on the block model (transformation, texture
+        // coordinates in the atlas...) is stored once in the FaceShapeTable
+        struct PackedFace
+        {
+            // Block position relative to the rendering section
+            // origin (x: bits 0-3, z: bits 4-7, y: bits 8-16) and
+            // size - 1 of merged faces (x: bits 17-20, y: bits 21-24,
+            // z: bits 25-28), see PackFaceSize
+            unsigned int position;
+            // Index of the shape in the FaceShapeTable
+            unsigned int shape;
+            // Color multipliers (rgba) of the texture and its overlay
+            std::array<unsigned int, 2> texture_multipliers;
+        };
+
+        inline const unsigned int PackFacePosition(const int x, const int y, const int z)
+        {
+            return (x & 0x0F) | ((z & 0x0F) << 4) | ((y & 0x1FF) << 8);
+        }
+
+        // Size in blocks of a face merged with its neighbours, between 1 and 16
+        // on each axis. The face is stretched from the block toward the positive axes
+        inline const unsigned int PackFaceSize(const int size_x, const int size_y, const int size_z)
+        {
+            return (((size_x - 1) & 0x0F) << 17) | (((size_y - 1) & 0x0F) << 21) | (((size_z - 1) & 0x0F) << 25);
+        }
+
+        inline const glm::vec3 UnpackFacePosition(const unsigned int position)
+        {
+            return glm::vec3(static_cast<float>(position & 0x0F), static_cast<float>((position >> 8) & 0x1FF), static_cast<float>((position >> 4) & 0x0F));
+        }
+
+        struct FaceShape
+        {
+            unsigned int index;
+            // Transparency of the base texture
+            Transparency transparency;
+            // True if the face covers a whole side of the block and is
+            // hidden by a neighbour in this direction, so it can be
+            // merged with the same faces of the neighbour blocks
+            bool full_side;
+        };
+
+        // All the different model faces used by the rendered blocks, with
+        // their textures resolved in the atlas. Shapes are added the first
+        // time they are used, and never removed. Thread safe.
+        class FaceShapeTable
+        {
+        public:
+            FaceShapeTable(const std::shared_ptr<const Atlas> atlas_);
+
+            // Get the shape of this model face, adding it if it's new
+            const FaceShape Get(const FaceDescriptor& descriptor);
+
+            const size_t Size() const;
+            // Append the faces of the shapes [start, Size()) to output.
+            // Their matrices are relative to the block corner
+            void GetFaces(const size_t start, std::vector<Face>& output) const;
+            // Append the centers of the shapes [start, Size()) to output,
+            // relative to the block corner
+            void GetCenters(const size_t start, std::vector<glm::vec3>& output) const;
+
+        private:
+            const Face ResolveTextures(const FaceDescriptor& descriptor, Transparency& transparency) const;
+
+        private:
+            std::shared_ptr<const Atlas> atlas;
+
+            mutable std::shared_mutex shapes_mutex;
+            std::unordered_map<const FaceDescriptor*, FaceShape> shapes;
+            std::vector<Face> faces;
+            std::vector<glm::vec3> centers;
+        };
+    } // Renderer
+} // Botcraft
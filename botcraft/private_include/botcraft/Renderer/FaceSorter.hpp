@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "botcraft/Renderer/FaceShapeTable.hpp"
+
+namespace Botcraft
+{
+    namespace Renderer
+    {
+        // Sort the transparent faces of a section from far to near the
+        // camera with a radix sort on their quantized distance. It doesn't
+        // use OpenGL, TransparentChunk sends the sorted faces to the buffer
+        class FaceSorter
+        {
+        public:
+            FaceSorter();
+
+            // Center of each face relative to the section origin. Merged and
+            // LOD faces are stretched toward the positive axes by their size
+            static void ComputeCenters(const std::vector<PackedFace>& faces,
+                const std::vector<glm::vec3>& shape_centers, std::vector<glm::vec3>& centers);
+
+            // Sort faces and their centers from far to near relative_cam_pos,
+            // the camera position relative to the section origin
+            void Sort(const glm::vec3& relative_cam_pos, std::vector<PackedFace>& faces, std::vector<glm::vec3>& centers);
+
+            // Memory used by the sorting buffers
+            const size_t GetCPUBytes() const;
+
+        private:
+            // Sorting buffers, kept to avoid reallocations
+            std::vector<unsigned short> sort_keys;
+            std::vector<unsigned int> sort_indices;
+            std::vector<unsigned int> sort_indices_tmp;
+            std::vector<PackedFace> sorted_faces;
+            std::vector<glm::vec3> sorted_centers;
+        };
+    } // Renderer
+} // Botcraft
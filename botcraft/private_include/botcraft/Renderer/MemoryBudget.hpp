@@ -0,0 +1,64 @@
+#pragma once
+
+#include <functional>
+#include <unordered_set>
+#include <vector>
+
+#include "botcraft/Game/Vector3.hpp"
+
+namespace Botcraft
+{
+    namespace Renderer
+    {
+        // Memory used by the faces of a rendering section
+        struct SectionMemory
+        {
+            Position section;
+            // Distance to the camera
+            float distance;
+            size_t bytes;
+        };
+
+        // Choose the rendering sections whose faces are dropped to keep
+        // the memory used by the faces under a budget, and when they can be
+        // meshed again. It doesn't use OpenGL, WorldRenderer frees the faces
+        class MemoryBudget
+        {
+        public:
+            MemoryBudget();
+
+            // 0 for no limit
+            void SetBudget(const size_t bytes);
+            const size_t GetBudget() const;
+
+            // Must be called with the memory used by all the faces each
+            // time it's computed. Returns true if it's over the budget
+            const bool Update(const size_t used_bytes);
+            // Drop the furthest sections until the memory used is under 90%
+            // of the budget. sections are sorted by decreasing distance and
+            // the dropped ones are appended to evicted
+            void Evict(const size_t used_bytes, std::vector<SectionMemory>& sections, std::vector<Position>& evicted);
+            // Returns false if the faces of a new mesh must be dropped
+            // because the section is too far from the camera
+            const bool KeepMesh(const Position& section, const float distance, const bool has_faces);
+            // Get the dropped sections close enough to be meshed again.
+            // The limit moves one chunk further each time the memory
+            // used went under 75% of the budget since the last call
+            void GetSectionsToRestore(const std::function<float(const Position&)>& distance_to_camera, std::vector<Position>& sections);
+            // Forget all the dropped sections
+            void Clear();
+
+            const bool IsEvicted(const Position& section) const;
+            const size_t GetNumEvicted() const;
+            // Sections further than this don't keep their faces
+            const float GetEvictionDistance() const;
+
+        private:
+            size_t budget;
+            float eviction_distance;
+            std::unordered_set<Position> evicted_sections;
+            // True if the memory used is low enough to restore more sections
+            bool has_room;
+        };
+    } // Renderer
+} // Botcraft
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "botcraft/Game/Enums.hpp"
+#include "botcraft/Game/Vector3.hpp"
+
+namespace Botcraft
+{
+    namespace Renderer
+    {
+        // Which faces of a rendering section can see each other
+        // through the non opaque blocks inside the section
+        class SectionVisibility
+        {
+        public:
+            // By default, all the faces see each other (empty section)
+            SectionVisibility(const bool all_connected = true);
+
+            void SetConnected(const Orientation a, const Orientation b);
+            const bool IsConnected(const Orientation a, const Orientation b) const;
+            const bool IsFullyConnected() const;
+
+            // Compute the visibility of a section of size CHUNK_WIDTH x height x CHUNK_WIDTH.
+            // opaque[x + CHUNK_WIDTH * (z + CHUNK_WIDTH * y)] is true if the block
+            // hides what's behind it. visited is a buffer reused between calls
+            void Compute(const std::vector<bool>& opaque, const int height, std::vector<bool>& visited);
+
+        private:
+            // One bit for each pair of faces (6 x 6)
+            unsigned long long int connections;
+        };
+
+        // Find the sections that can be seen from the camera section. This is
+        // a breadth first search going from one section to its neighbour if the
+        // face it was entered by is connected to the face it leaves by, never
+        // going back toward the camera. Sections without visibility are
+        // considered empty. The search stays between min_section and
+        // max_section (included), and only go through sections for which
+        // is_in_frustum returns true.
+        void GetVisibleSections(const Position& camera_section,
+            const std::unordered_map<Position, SectionVisibility>& visibilities,
+            const Position& min_section, const Position& max_section,
+            const std::function<bool(const Position&)>& is_in_frustum,
+            std::unordered_set<Position>& visible_sections);
+    } // Renderer
+} // Botcraft
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <glm/vec3.hpp>
 
 #include "botcraft/Renderer/Chunk.hpp"
+#include "botcraft/Renderer/FaceSorter.hpp"
 
 namespace Botcraft
 {
@@ -15,12 +16,25 @@ namespace Botcraft
             ~TransparentChunk();
 
             void SetDisplayStatus(const BufferStatus s);
-            void Sort(const glm::vec3 &cam_pos);
-            void Update();
+            // Sort the faces from far to near cam_pos and send them to buffer.
+            // origin is the position of the section corner, shape_centers
+            // the centers of the shapes referenced by the faces
+            void Sort(const glm::vec3 &cam_pos, const glm::vec3& origin,
+                const std::vector<glm::vec3>& shape_centers, FaceBuffer& buffer);
+            void Update(FaceBuffer& buffer);
+            // Memory used by the faces kept on the CPU side,
+            // the displayed faces are needed to sort them again
+            const size_t GetCPUBytes();
 
         protected:
-            std::vector<Face> display_faces_positions;
+            std::vector<PackedFace> display_faces_positions;
             BufferStatus display_buffer_status;
+
+            // Center of each display face relative to the section
+            // origin, computed at the first sort after an update
+            std::vector<glm::vec3> display_faces_centers;
+
+            FaceSorter sorter;
         };
     } // Renderer
 } // Botcraft
\ No newline at end of file
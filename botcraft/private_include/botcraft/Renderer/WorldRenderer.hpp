@@ -1,9 +1,13 @@
 #pragma once
 
 #include "botcraft/Game/Vector3.hpp"
+#include "botcraft/Renderer/MemoryBudget.hpp"
+#include "botcraft/Renderer/SectionVisibility.hpp"
 
 #include <glm/glm.hpp>
 
+#include <array>
+
 #include <unordered_map>
 #include <mutex>
 #include <memory>
@@ -12,16 +16,16 @@
 
 namespace Botcraft
 {
-    class Biome;
-    class Blockstate;
-    class Chunk;
-
     namespace Renderer
     {
         class Chunk;
         class TransparentChunk;
         class Camera;
         class Atlas;
+        class ChunkMesher;
+        class FaceBuffer;
+        struct SectionMesh;
+        struct MemoryStats;
 
         // Intersection test for frustum culling
         enum class FrustumResult
@@ -35,8 +39,11 @@ namespace Botcraft
         {
         public:
             // Constructor
+            // If greedy_meshing is true, adjacent identical block faces are
+            // merged into bigger ones, see ChunkMesher
             WorldRenderer(const unsigned int section_height_, 
-                const std::vector<std::pair<std::string, std::string> >& textures_path_names);
+                const std::vector<std::pair<std::string, std::string> >& textures_path_names,
+                const bool greedy_meshing = false);
             ~WorldRenderer();
 
             std::shared_ptr<Camera> GetCamera();
@@ -45,31 +52,55 @@ namespace Botcraft
             void UpdateViewMatrix();
             void SetCameraProjection(const glm::mat4& proj);
             void UpdateFaces();
-            void UpdateChunk(const int x_, const int z_, const std::shared_ptr<const Botcraft::Chunk> chunk);
+
+            // Mesher to compute the faces of the sections, can
+            // be used from any thread without locking
+            const ChunkMesher& GetMesher() const;
+            // Replace the faces of a rendering section with the ones in mesh.
+            // The faces are swapped with the old ones, so mesh memory can be
+            // reused. Meshes with an older version than the current one of the
+            // section are ignored, so sections meshed in parallel can be set in any order.
+            // The faces are sent to OpenGL at the next UpdateFaces call
+            void SetSectionFaces(const Position& section, SectionMesh& mesh, const unsigned long long int version);
             void UseAtlasTextureGL();
             void ClearFaces();
 
+            // Set the maximum memory used by the faces (GPU faces and their
+            // CPU copies), 0 for no limit. When it's exceeded, the faces of the
+            // sections far from the camera are dropped until they get closer
+            void SetMemoryBudget(const size_t bytes);
+            // Get the sections with dropped faces that are close
+            // enough to the camera to be meshed again
+            void GetSectionsToRestore(std::vector<Position>& sections);
+            // Remove the data kept for the sections without any face. Must
+            // only be called when no mesh is being computed, as it removes
+            // the versions used to ignore outdated meshes
+            void ReleaseEmptySections();
+            // Must be called in the OpenGL thread
+            void GetMemoryStats(MemoryStats& stats);
+
             // Set camera position and orientation
             void SetPosOrientation(const double x_, const double y_, const double z_, const float yaw_, const float pitch_);
 
             // Render all the faces (chunks + partially transparent chunks)
             // Optional pointer can be passed to get statistics
             void RenderFaces(int* num_chunks_ = nullptr, int* num_rendered_chunks_ = nullptr,
-                int* num_faces_ = nullptr, int* num_rendered_faces_ = nullptr);
+                int* num_occluded_chunks_ = nullptr, int* num_faces_ = nullptr, int* num_rendered_faces_ = nullptr,
+                size_t* uploaded_bytes_ = nullptr, size_t* buffer_bytes_ = nullptr,
+                float* sorting_time_ = nullptr);
 
         private:
-            // Add a face to the rendering data
-            // It will not be rendered until the next frame with
-            // faces_should_be_updated set to true
-            void AddFace(const int x_, const int y_, const int z_, const Face& face_,
-                const std::vector<std::string>& texture_identifiers_,
-                const std::vector<unsigned int>& texture_multipliers_);
-
-            // Returns the color modifier (for redstone/leaves/water etc...)
-            const std::vector<unsigned int> GetColorModifier(const int y, const std::shared_ptr<Biome> biome, const std::shared_ptr<Blockstate> blockstate, const std::vector<bool>& use_tintindex) const;
-
             // Returns the distance from the center of the chunk to the camera
             const float DistanceToCamera(const Position& chunk) const;
+            // Returns true if the section is at least partially inside the frustum
+            const bool IsInFrustum(const Position& section, const std::array<glm::vec4, 6>& frustum_planes) const;
+            // Returns the position of the corner of a rendering section
+            const glm::vec3 GetSectionOrigin(const Position& section) const;
+            // Returns the rendering section containing a block
+            const Position GetSection(const Position& block) const;
+            // Compute the memory used by the faces, and drop the faces of the
+            // furthest sections if it's over budget. chunks_mutex must be locked
+            void EnforceMemoryBudget();
 
 
         private:
@@ -84,13 +115,40 @@ namespace Botcraft
             std::mutex chunks_mutex;
             std::unordered_map<Position, std::shared_ptr<TransparentChunk> > transparent_chunks;
             std::mutex transparent_chunks_mutex;
+            // Version of the last mesh set for each section, protected by chunks_mutex
+            std::unordered_map<Position, unsigned long long int> sections_version;
+            // Visibility through each section, protected by chunks_mutex.
+            // Sections not in the map are considered empty
+            std::unordered_map<Position, SectionVisibility> sections_visibility;
             bool faces_should_be_updated;
 
+            // Sections dropped to stay under the memory budget, protected by chunks_mutex
+            MemoryBudget memory_budget;
+            // Memory used by the faces at the last UpdateFaces
+            size_t gpu_face_bytes;
+            size_t cpu_face_bytes;
+
+            // All the sections with faces, sorted from far to near the camera.
+            // Only sorted again when a section is added/removed or when the
+            // camera enters another section
+            std::vector<Position> sorted_sections;
+            bool sections_order_should_be_updated;
+            // Camera block and section when the faces were last sorted
+            Position camera_block;
+            Position camera_section;
+
             std::shared_ptr<Camera> camera;
             std::mutex m_mutex_camera;
 
             std::shared_ptr<Atlas> atlas;
             unsigned int atlas_texture;
+
+            std::unique_ptr<ChunkMesher> mesher;
+
+            // GPU storage of all the faces, only used in the OpenGL thread
+            std::unique_ptr<FaceBuffer> face_buffer;
+            // Centers of the shapes sent to face_buffer, to sort transparent faces
+            std::vector<glm::vec3> shape_centers;
         };
     } // Renderer
 } // Botcraft
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+namespace Botcraft
+{
+    // Read-only mapping of a whole file in memory. Pages are
+    // shared through the OS page cache between all the
+    // processes mapping the same file
+    class MemoryMappedFile
+    {
+    public:
+        MemoryMappedFile(const std::string& path);
+        ~MemoryMappedFile();
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        const bool IsOpen() const;
+        const char* GetData() const;
+        const size_t GetSize() const;
+
+    private:
+        const char* data;
+        size_t size;
+#ifdef _WIN32
+        void* file_handle;
+        void* mapping_handle;
+#endif
+    };
+} // Botcraft
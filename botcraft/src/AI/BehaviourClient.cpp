@@ -1,11 +1,14 @@
 #include "botcraft/AI/BehaviourClient.hpp"
+#include "botcraft/Game/World/World.hpp"
+#include "botcraft/Utilities/Signal.hpp"
 
 namespace Botcraft
 {
     BehaviourClient::BehaviourClient(const bool use_renderer_) :
         ManagersClient(use_renderer_)
     {
-
+        is_waiting = false;
+        behaviour_interrupted = false;
     }
 
     BehaviourClient::~BehaviourClient()
@@ -13,8 +16,149 @@ namespace Botcraft
 
     }
 
+    const bool BehaviourClient::WaitFor(const std::function<bool()>& condition, const std::vector<const Signal*>& signals, const long long int timeout_ms)
+    {
+        // Wake the behaviour up as soon as one of the signals is notified
+        std::vector<size_t> listeners(signals.size());
+        for (size_t i = 0; i < signals.size(); ++i)
+        {
+            listeners[i] = signals[i]->AddListener(std::bind(&BehaviourClient::WakeUp, this));
+        }
+
+        bool result = false;
+        try
+        {
+            result = WaitForImpl(condition, signals, timeout_ms);
+        }
+        catch (...)
+        {
+            for (size_t i = 0; i < signals.size(); ++i)
+            {
+                signals[i]->RemoveListener(listeners[i]);
+            }
+            throw;
+        }
+
+        for (size_t i = 0; i < signals.size(); ++i)
+        {
+            signals[i]->RemoveListener(listeners[i]);
+        }
+        return result;
+    }
+
+    const bool BehaviourClient::WaitForBlocks(const std::function<bool()>& condition, const Position& min, const Position& max,
+        const std::vector<const Signal*>& signals, const long long int timeout_ms)
+    {
+        // Only notified by the changes in [min, max]
+        Signal blocks_signal;
+        BlockChangeFilter filter;
+        filter.use_region = true;
+        filter.min = min;
+        filter.max = max;
+        const size_t subscriber_id = world->SubscribeBlockChanges(filter,
+            [&blocks_signal](const std::vector<BlockChangeEvent>&) { blocks_signal.Notify(); });
+
+        std::vector<const Signal*> all_signals = signals;
+        all_signals.push_back(&blocks_signal);
+
+        bool result = false;
+        try
+        {
+            result = WaitFor(condition, all_signals, timeout_ms);
+        }
+        catch (...)
+        {
+            world->UnsubscribeBlockChanges(subscriber_id);
+            throw;
+        }
+
+        world->UnsubscribeBlockChanges(subscriber_id);
+        return result;
+    }
+
+    const bool BehaviourClient::IsBehaviourInterrupted() const
+    {
+        return behaviour_interrupted;
+    }
+
     Blackboard& BehaviourClient::GetBlackboard()
     {
         return blackboard;
     }
+
+#if USE_BEHAVIOUR_PROFILING
+    BehaviourProfiler& BehaviourClient::GetBehaviourProfiler()
+    {
+        return behaviour_profiler;
+    }
+#endif
+
+    const bool BehaviourClient::WaitForImpl(const std::function<bool()>& condition, const std::vector<const Signal*>& signals, const long long int timeout_ms)
+    {
+        const std::chrono::steady_clock::time_point deadline = timeout_ms < 0 ?
+            std::chrono::steady_clock::time_point::max() : std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        std::vector<std::pair<const Signal*, unsigned long long int> > versions(signals.size());
+
+        while (true)
+        {
+            // Versions are read before checking the condition so a
+            // change happening in between will wake us up
+            for (size_t i = 0; i < signals.size(); ++i)
+            {
+                versions[i] = { signals[i], signals[i]->GetVersion() };
+            }
+
+            if (condition())
+            {
+                return true;
+            }
+
+            if (behaviour_interrupted)
+            {
+                return false;
+            }
+
+            if (std::chrono::steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+
+            {
+                std::lock_guard<std::mutex> wait_guard(wait_mutex);
+                wait_signals = versions;
+                wait_deadline = deadline;
+                is_waiting = true;
+            }
+
+            Yield();
+
+            std::lock_guard<std::mutex> wait_guard(wait_mutex);
+            is_waiting = false;
+        }
+    }
+
+    const bool BehaviourClient::ShouldResume()
+    {
+        std::lock_guard<std::mutex> wait_guard(wait_mutex);
+        if (!is_waiting)
+        {
+            return true;
+        }
+
+        for (size_t i = 0; i < wait_signals.size(); ++i)
+        {
+            if (wait_signals[i].first->GetVersion() != wait_signals[i].second)
+            {
+                return true;
+            }
+        }
+
+        return std::chrono::steady_clock::now() >= wait_deadline;
+    }
+
+    const std::chrono::steady_clock::time_point BehaviourClient::GetWaitDeadline()
+    {
+        std::lock_guard<std::mutex> wait_guard(wait_mutex);
+        return is_waiting ? wait_deadline : std::chrono::steady_clock::time_point::min();
+    }
 } // namespace Botcraft
@@ -0,0 +1,405 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+#include <nlohmann/json.hpp>
+
+#include "botcraft/AI/BehaviourProfiler.hpp"
+#include "botcraft/AI/BehaviourTree.hpp"
+
+namespace Botcraft
+{
+    namespace
+    {
+        std::mutex& GetRegistryMutex()
+        {
+            static std::mutex registry_mutex;
+            return registry_mutex;
+        }
+
+        std::vector<BehaviourProfiler*>& GetRegistry()
+        {
+            static std::vector<BehaviourProfiler*> registry;
+            return registry;
+        }
+
+        std::mutex& GetNamesMutex()
+        {
+            static std::mutex names_mutex;
+            return names_mutex;
+        }
+
+        std::vector<std::string>& GetNames()
+        {
+            // Id 0 is reserved for unresolved names
+            static std::vector<std::string> names = { "" };
+            return names;
+        }
+
+        std::unordered_map<std::string, unsigned int>& GetNamesIds()
+        {
+            static std::unordered_map<std::string, unsigned int> names_ids;
+            return names_ids;
+        }
+
+        const std::string GetName(const unsigned int id)
+        {
+            std::lock_guard<std::mutex> names_guard(GetNamesMutex());
+            const std::vector<std::string>& names = GetNames();
+            return id < names.size() ? names[id] : "";
+        }
+    }
+
+    BehaviourProfiler::BehaviourProfiler(const size_t ring_buffer_size, const size_t queue_size)
+    {
+        events.resize(std::max(ring_buffer_size, static_cast<size_t>(1)));
+
+        size_t size = 1;
+        while (size < queue_size)
+        {
+            size <<= 1;
+        }
+        queue.resize(size);
+        queue_mask = size - 1;
+        queue_head = 0;
+        queue_tail = 0;
+        current_depth = 0;
+
+        Reset();
+
+        std::lock_guard<std::mutex> registry_guard(GetRegistryMutex());
+        GetRegistry().push_back(this);
+    }
+
+    BehaviourProfiler::~BehaviourProfiler()
+    {
+        std::lock_guard<std::mutex> registry_guard(GetRegistryMutex());
+        std::vector<BehaviourProfiler*>& registry = GetRegistry();
+        registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+    }
+
+    void BehaviourProfiler::SetName(const std::string& name_)
+    {
+        std::lock_guard<std::mutex> profiler_guard(profiler_mutex);
+        name = name_;
+    }
+
+    const unsigned int BehaviourProfiler::GetNameId(const std::string& name)
+    {
+        std::lock_guard<std::mutex> names_guard(GetNamesMutex());
+        std::unordered_map<std::string, unsigned int>& names_ids = GetNamesIds();
+        auto it = names_ids.find(name);
+        if (it != names_ids.end())
+        {
+            return it->second;
+        }
+        std::vector<std::string>& names = GetNames();
+        const unsigned int id = static_cast<unsigned int>(names.size());
+        names.push_back(name);
+        names_ids[name] = id;
+        return id;
+    }
+
+    void BehaviourProfiler::BeginNode(const unsigned int name_id)
+    {
+        Push(RawEvent{ Now(), name_id, current_depth, RawEventType::BeginNode, 0 });
+        current_depth += 1;
+    }
+
+    void BehaviourProfiler::EndNode(const bool has_status, const Status status)
+    {
+        current_depth -= 1;
+        Push(RawEvent{ Now(), 0, current_depth, RawEventType::EndNode,
+            static_cast<unsigned char>(has_status ? (status == Status::Success ? 1 : 2) : 0) });
+
+        // Aggregate at the end of each tick, or before the
+        // queue is full, unless someone is already doing it
+        if ((current_depth == 0 || queue_tail.load(std::memory_order_relaxed) - queue_head.load(std::memory_order_acquire) > queue.size() / 2)
+            && profiler_mutex.try_lock())
+        {
+            ProcessQueue();
+            profiler_mutex.unlock();
+        }
+    }
+
+    void BehaviourProfiler::BeginSuspension()
+    {
+        Push(RawEvent{ Now(), 0, current_depth, RawEventType::BeginSuspension, 0 });
+    }
+
+    void BehaviourProfiler::EndSuspension()
+    {
+        Push(RawEvent{ Now(), 0, current_depth, RawEventType::EndSuspension, 0 });
+    }
+
+    void BehaviourProfiler::Reset()
+    {
+        std::lock_guard<std::mutex> profiler_guard(profiler_mutex);
+        // Discard the pending events
+        queue_head.store(queue_tail.load(std::memory_order_acquire), std::memory_order_release);
+        next_event = 0;
+        events_wrapped = false;
+        stack.clear();
+        path_ids.clear();
+        paths.clear();
+        // Root path
+        paths.push_back(PathStats{ 0, 0, 0, 0, 0, 0, 0 });
+        total_suspended_ns = 0;
+        suspension_start = 0;
+    }
+
+    const std::vector<BehaviourNodeStats> BehaviourProfiler::GetStats()
+    {
+        std::lock_guard<std::mutex> profiler_guard(profiler_mutex);
+        ProcessQueue();
+        std::vector<BehaviourNodeStats> output;
+        output.reserve(paths.size() - 1);
+        for (size_t i = 1; i < paths.size(); ++i)
+        {
+            const PathStats& p = paths[i];
+            output.push_back(BehaviourNodeStats{ GetPath(static_cast<unsigned int>(i)), p.count, p.success, p.failure, p.wall_ns, p.suspended_ns });
+        }
+        return output;
+    }
+
+    const std::vector<BehaviourNodeStats> BehaviourProfiler::GetAggregatedStats()
+    {
+        std::map<std::string, BehaviourNodeStats> merged;
+        {
+            std::lock_guard<std::mutex> registry_guard(GetRegistryMutex());
+            for (BehaviourProfiler* profiler : GetRegistry())
+            {
+                for (const BehaviourNodeStats& s : profiler->GetStats())
+                {
+                    auto it = merged.find(s.path);
+                    if (it == merged.end())
+                    {
+                        merged[s.path] = s;
+                        continue;
+                    }
+                    it->second.count += s.count;
+                    it->second.success += s.success;
+                    it->second.failure += s.failure;
+                    it->second.wall_ns += s.wall_ns;
+                    it->second.suspended_ns += s.suspended_ns;
+                }
+            }
+        }
+
+        std::vector<BehaviourNodeStats> output;
+        output.reserve(merged.size());
+        for (const auto& p : merged)
+        {
+            output.push_back(p.second);
+        }
+        return output;
+    }
+
+    const bool BehaviourProfiler::ExportChromeTrace(const std::string& path)
+    {
+        nlohmann::json trace_events = nlohmann::json::array();
+        {
+            std::lock_guard<std::mutex> registry_guard(GetRegistryMutex());
+            const std::vector<BehaviourProfiler*>& registry = GetRegistry();
+            for (size_t tid = 0; tid < registry.size(); ++tid)
+            {
+                BehaviourProfiler* profiler = registry[tid];
+                std::lock_guard<std::mutex> profiler_guard(profiler->profiler_mutex);
+                profiler->ProcessQueue();
+
+                trace_events.push_back({
+                    { "name", "thread_name" }, { "ph", "M" }, { "pid", 0 }, { "tid", tid },
+                    { "args", { { "name", profiler->name.empty() ? "Client " + std::to_string(tid) : profiler->name } } }
+                    });
+
+                const size_t num_events = profiler->events_wrapped ? profiler->events.size() : profiler->next_event;
+                const size_t first_event = profiler->events_wrapped ? profiler->next_event : 0;
+                for (size_t i = 0; i < num_events; ++i)
+                {
+                    const Event& e = profiler->events[(first_event + i) % profiler->events.size()];
+                    trace_events.push_back({
+                        { "name", GetName(e.name_id) }, { "ph", "X" }, { "pid", 0 }, { "tid", tid },
+                        { "ts", e.start_ns / 1000.0 }, { "dur", e.duration_ns / 1000.0 },
+                        { "args", {
+                            { "suspended_us", e.suspended_ns / 1000.0 },
+                            { "status", e.status == 1 ? "Success" : (e.status == 2 ? "Failure" : "Interrupted") }
+                        } }
+                        });
+                }
+            }
+        }
+
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        if (!file.is_open())
+        {
+            std::cerr << "Error trying to write behaviour trace to " << path << std::endl;
+            return false;
+        }
+        file << nlohmann::json({ { "traceEvents", trace_events }, { "displayTimeUnit", "ms" } });
+        return true;
+    }
+
+    const bool BehaviourProfiler::ExportFoldedStacks(const std::string& path)
+    {
+        const std::vector<BehaviourNodeStats> stats = GetAggregatedStats();
+
+        // Children time has to be removed from
+        // the parent to get the self time
+        std::map<std::string, std::pair<unsigned long long int, unsigned long long int> > self_times;
+        for (const BehaviourNodeStats& s : stats)
+        {
+            std::pair<unsigned long long int, unsigned long long int>& self_time = self_times[s.path];
+            self_time.first += s.wall_ns - s.suspended_ns;
+            self_time.second += s.suspended_ns;
+
+            const size_t separator = s.path.rfind(';');
+            if (separator != std::string::npos)
+            {
+                std::pair<unsigned long long int, unsigned long long int>& parent_time = self_times[s.path.substr(0, separator)];
+                parent_time.first -= s.wall_ns - s.suspended_ns;
+                parent_time.second -= s.suspended_ns;
+            }
+        }
+
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        if (!file.is_open())
+        {
+            std::cerr << "Error trying to write behaviour folded stacks to " << path << std::endl;
+            return false;
+        }
+        for (const auto& p : self_times)
+        {
+            // Values are unsigned, a "negative" self
+            // time can only come from rounding
+            const long long int compute_us = static_cast<long long int>(p.second.first) / 1000;
+            const long long int suspended_us = static_cast<long long int>(p.second.second) / 1000;
+            if (compute_us > 0)
+            {
+                file << p.first << " " << compute_us << "\n";
+            }
+            if (suspended_us > 0)
+            {
+                file << p.first << ";[Suspended] " << suspended_us << "\n";
+            }
+        }
+        return true;
+    }
+
+    const unsigned long long int BehaviourProfiler::Now()
+    {
+        static const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count();
+    }
+
+    const std::string BehaviourProfiler::GetPath(const unsigned int path_id) const
+    {
+        std::vector<unsigned int> ids;
+        for (unsigned int p = path_id; p != 0; p = paths[p].parent)
+        {
+            ids.push_back(paths[p].name_id);
+        }
+
+        std::string output;
+        for (auto it = ids.rbegin(); it != ids.rend(); ++it)
+        {
+            if (!output.empty())
+            {
+                output += ";";
+            }
+            output += GetName(*it);
+        }
+        return output;
+    }
+
+    void BehaviourProfiler::Push(const RawEvent& event)
+    {
+        const size_t current_tail = queue_tail.load(std::memory_order_relaxed);
+        if (current_tail - queue_head.load(std::memory_order_acquire) == queue.size())
+        {
+            return;
+        }
+        queue[current_tail & queue_mask] = event;
+        queue_tail.store(current_tail + 1, std::memory_order_release);
+    }
+
+    void BehaviourProfiler::ProcessQueue()
+    {
+        const size_t current_head = queue_head.load(std::memory_order_relaxed);
+        const size_t current_tail = queue_tail.load(std::memory_order_acquire);
+        for (size_t i = current_head; i != current_tail; ++i)
+        {
+            ProcessEvent(queue[i & queue_mask]);
+        }
+        queue_head.store(current_tail, std::memory_order_release);
+    }
+
+    void BehaviourProfiler::ProcessEvent(const RawEvent& raw_event)
+    {
+        switch (raw_event.type)
+        {
+        case RawEventType::BeginNode:
+        {
+            // Some EndNode were dropped, close the nodes
+            if (stack.size() > raw_event.depth)
+            {
+                stack.resize(raw_event.depth);
+            }
+            // The parents are unknown (dropped or before a Reset), skip it
+            if (stack.size() < raw_event.depth)
+            {
+                return;
+            }
+            const unsigned int parent = stack.empty() ? 0 : stack.back().path_id;
+            const unsigned long long int key = (static_cast<unsigned long long int>(parent) << 32) | raw_event.name_id;
+            auto it = path_ids.find(key);
+            if (it == path_ids.end())
+            {
+                it = path_ids.insert({ key, static_cast<unsigned int>(paths.size()) }).first;
+                paths.push_back(PathStats{ parent, raw_event.name_id, 0, 0, 0, 0, 0 });
+            }
+            stack.push_back(OpenNode{ it->second, raw_event.time_ns, total_suspended_ns });
+            break;
+        }
+        case RawEventType::EndNode:
+        {
+            if (stack.size() > static_cast<size_t>(raw_event.depth) + 1)
+            {
+                stack.resize(static_cast<size_t>(raw_event.depth) + 1);
+            }
+            if (stack.size() != static_cast<size_t>(raw_event.depth) + 1)
+            {
+                return;
+            }
+            const OpenNode node = stack.back();
+            stack.pop_back();
+
+            PathStats& stats = paths[node.path_id];
+            const unsigned long long int suspended = total_suspended_ns - node.suspended_at_start;
+            stats.count += 1;
+            stats.wall_ns += raw_event.time_ns - node.start_ns;
+            stats.suspended_ns += suspended;
+            stats.success += raw_event.status == 1;
+            stats.failure += raw_event.status == 2;
+
+            Event& event = events[next_event];
+            event.start_ns = node.start_ns;
+            event.duration_ns = raw_event.time_ns - node.start_ns;
+            event.suspended_ns = suspended;
+            event.name_id = stats.name_id;
+            event.depth = static_cast<unsigned short>(stack.size());
+            event.status = raw_event.status;
+            next_event = (next_event + 1) % events.size();
+            events_wrapped |= next_event == 0;
+            break;
+        }
+        case RawEventType::BeginSuspension:
+            suspension_start = raw_event.time_ns;
+            break;
+        case RawEventType::EndSuspension:
+            total_suspended_ns += raw_event.time_ns - suspension_start;
+            break;
+        }
+    }
+} // namespace Botcraft
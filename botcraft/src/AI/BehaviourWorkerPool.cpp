@@ -0,0 +1,307 @@
+#include <iostream>
+#include <algorithm>
+#include <limits>
+
+#include "botcraft/AI/BehaviourWorkerPool.hpp"
+
+namespace Botcraft
+{
+    // Period at which each step function is called
+    const std::chrono::milliseconds step_period(10);
+    // Worker of a job that has never been stepped
+    const size_t no_worker = std::numeric_limits<size_t>::max();
+
+    BehaviourWorkerPool& BehaviourWorkerPool::getInstance()
+    {
+        static BehaviourWorkerPool instance;
+
+        return instance;
+    }
+
+    BehaviourWorkerPool::BehaviourWorkerPool()
+    {
+        next_id = 0;
+        running = true;
+        num_steps = 0;
+    }
+
+    BehaviourWorkerPool::~BehaviourWorkerPool()
+    {
+        running = false;
+        for (size_t i = 0; i < workers.size(); ++i)
+        {
+            std::lock_guard<std::mutex> worker_guard(workers[i]->mutex);
+            Notify(*workers[i]);
+        }
+        for (size_t i = 0; i < workers.size(); ++i)
+        {
+            if (workers[i]->thread.joinable())
+            {
+                workers[i]->thread.join();
+            }
+        }
+    }
+
+    const size_t BehaviourWorkerPool::Add(const std::function<bool(std::chrono::steady_clock::time_point&)>& step)
+    {
+        std::lock_guard<std::mutex> pool_guard(pool_mutex);
+
+        // Workers are only started on first use
+        if (workers.empty())
+        {
+            const unsigned int num_workers = std::max(1u, std::thread::hardware_concurrency());
+            workers.reserve(num_workers);
+            for (unsigned int i = 0; i < num_workers; ++i)
+            {
+                workers.push_back(std::unique_ptr<Worker>(new Worker()));
+                workers[i]->notified = false;
+            }
+            for (unsigned int i = 0; i < num_workers; ++i)
+            {
+                workers[i]->thread = std::thread(&BehaviourWorkerPool::WorkerLoop, this, i);
+            }
+        }
+
+        std::unique_ptr<Job> job(new Job());
+        job->id = next_id++;
+        job->step = step;
+        job->next_step = std::chrono::steady_clock::now();
+        job->worker = no_worker;
+        job->woken = false;
+        jobs[job->id] = job.get();
+
+        const size_t id = job->id;
+        // Give the new job to the least loaded worker, an idle
+        // one can still steal it until its first step
+        Worker* selected = workers[0].get();
+        size_t selected_size = std::numeric_limits<size_t>::max();
+        for (size_t i = 0; i < workers.size(); ++i)
+        {
+            std::lock_guard<std::mutex> worker_guard(workers[i]->mutex);
+            if (workers[i]->jobs.size() < selected_size)
+            {
+                selected = workers[i].get();
+                selected_size = workers[i]->jobs.size();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> worker_guard(selected->mutex);
+            // New jobs are due now, so they go in front
+            selected->jobs.push_front(std::move(job));
+            Notify(*selected);
+        }
+        // Idle workers only look at the other queues when they wake up,
+        // so give them a chance to steal it if the selected one is busy
+        for (size_t i = 0; i < workers.size(); ++i)
+        {
+            if (workers[i].get() != selected)
+            {
+                std::lock_guard<std::mutex> worker_guard(workers[i]->mutex);
+                Notify(*workers[i]);
+            }
+        }
+
+        return id;
+    }
+
+    void BehaviourWorkerPool::Wake(const size_t id)
+    {
+        std::lock_guard<std::mutex> pool_guard(pool_mutex);
+        auto it = jobs.find(id);
+        if (it == jobs.end())
+        {
+            return;
+        }
+        it->second->woken = true;
+
+        // A job never stepped can't be parked
+        const size_t index = it->second->worker;
+        if (index == no_worker)
+        {
+            return;
+        }
+
+        Worker& worker = *workers[index];
+        std::lock_guard<std::mutex> worker_guard(worker.mutex);
+        auto parked_it = worker.parked.find(id);
+        if (parked_it == worker.parked.end())
+        {
+            return;
+        }
+        std::unique_ptr<Job> job = std::move(parked_it->second);
+        worker.parked.erase(parked_it);
+        worker.parked_deadlines.erase({ job->next_step, id });
+        job->next_step = std::chrono::steady_clock::now();
+        Enqueue(worker, std::move(job));
+        Notify(worker);
+    }
+
+    void BehaviourWorkerPool::Wait(const size_t id)
+    {
+        std::unique_lock<std::mutex> lock(pool_mutex);
+        done_cond_var.wait(lock, [&]() { return jobs.find(id) == jobs.end(); });
+    }
+
+    const unsigned long long int BehaviourWorkerPool::GetNumSteps() const
+    {
+        return num_steps;
+    }
+
+    void BehaviourWorkerPool::WorkerLoop(const size_t index)
+    {
+        Worker& worker = *workers[index];
+        while (running)
+        {
+            std::chrono::steady_clock::time_point next_wake_up;
+            std::unique_ptr<Job> job = GetNextJob(index, next_wake_up);
+            if (job == nullptr)
+            {
+                std::unique_lock<std::mutex> lock(worker.mutex);
+                // With nothing due nor parked, only a new or woken job can wake it up
+                if (next_wake_up == std::chrono::steady_clock::time_point::max())
+                {
+                    worker.cond_var.wait(lock, [&worker, this]() { return worker.notified || !running; });
+                }
+                else
+                {
+                    worker.cond_var.wait_until(lock, next_wake_up, [&worker, this]() { return worker.notified || !running; });
+                }
+                continue;
+            }
+
+            // The job is in no queue while running,
+            // so no other worker can run it at the same time
+            job->worker = index;
+            bool done = true;
+            // If the job is late, don't try to catch up
+            std::chrono::steady_clock::time_point next_step = std::max(job->next_step + step_period, std::chrono::steady_clock::now());
+            const std::chrono::steady_clock::time_point regular_next_step = next_step;
+            job->woken = false;
+            try
+            {
+                done = !job->step(next_step);
+            }
+            catch (std::exception& e)
+            {
+                std::cerr << "Exception caught during behaviour step: " << e.what() << std::endl;
+            }
+            catch (...)
+            {
+                std::cerr << "Unknown exception caught during behaviour step" << std::endl;
+            }
+            num_steps += 1;
+
+            if (done)
+            {
+                JobDone(job->id);
+                continue;
+            }
+
+            std::lock_guard<std::mutex> worker_guard(worker.mutex);
+            if (next_step > regular_next_step)
+            {
+                // Not woken up during the step, park it. Wake sets woken
+                // before looking for the job in the parked ones, so
+                // either it's seen here or the job is found parked
+                if (!job->woken)
+                {
+                    job->next_step = next_step;
+                    worker.parked_deadlines.insert({ next_step, job->id });
+                    worker.parked[job->id] = std::move(job);
+                    continue;
+                }
+                next_step = regular_next_step;
+            }
+
+            job->next_step = next_step;
+            Enqueue(worker, std::move(job));
+        }
+    }
+
+    std::unique_ptr<BehaviourWorkerPool::Job> BehaviourWorkerPool::GetNextJob(const size_t index, std::chrono::steady_clock::time_point& next_wake_up)
+    {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        next_wake_up = std::chrono::steady_clock::time_point::max();
+
+        {
+            Worker& worker = *workers[index];
+            std::lock_guard<std::mutex> worker_guard(worker.mutex);
+            // Anything added from now on must wake the worker up
+            worker.notified = false;
+            UnparkExpired(worker, now);
+            if (!worker.jobs.empty())
+            {
+                if (worker.jobs.front()->next_step <= now)
+                {
+                    std::unique_ptr<Job> job = std::move(worker.jobs.front());
+                    worker.jobs.pop_front();
+                    return job;
+                }
+                next_wake_up = worker.jobs.front()->next_step;
+            }
+            if (!worker.parked_deadlines.empty())
+            {
+                next_wake_up = std::min(next_wake_up, worker.parked_deadlines.begin()->first);
+            }
+        }
+
+        // Nothing to do, steal the most late job of another worker,
+        // starting with the next one to spread the thefts. Only jobs
+        // never stepped can move, the others may have a suspended fiber
+        for (size_t i = 1; i < workers.size(); ++i)
+        {
+            Worker& victim = *workers[(index + i) % workers.size()];
+            std::lock_guard<std::mutex> victim_guard(victim.mutex);
+            for (auto it = victim.jobs.begin(); it != victim.jobs.end() && (*it)->next_step <= now; ++it)
+            {
+                if ((*it)->worker == no_worker)
+                {
+                    std::unique_ptr<Job> job = std::move(*it);
+                    victim.jobs.erase(it);
+                    return job;
+                }
+            }
+        }
+
+        return nullptr;
+    }
+
+    void BehaviourWorkerPool::Enqueue(Worker& worker, std::unique_ptr<Job> job)
+    {
+        // Usually goes at the end, except for stolen or woken
+        // jobs that can be earlier than the ones of this worker
+        auto it = worker.jobs.end();
+        while (it != worker.jobs.begin() && (*(it - 1))->next_step > job->next_step)
+        {
+            --it;
+        }
+        worker.jobs.insert(it, std::move(job));
+    }
+
+    void BehaviourWorkerPool::UnparkExpired(Worker& worker, const std::chrono::steady_clock::time_point& now)
+    {
+        while (!worker.parked_deadlines.empty() && worker.parked_deadlines.begin()->first <= now)
+        {
+            auto it = worker.parked.find(worker.parked_deadlines.begin()->second);
+            worker.parked_deadlines.erase(worker.parked_deadlines.begin());
+            std::unique_ptr<Job> job = std::move(it->second);
+            worker.parked.erase(it);
+            Enqueue(worker, std::move(job));
+        }
+    }
+
+    void BehaviourWorkerPool::Notify(Worker& worker)
+    {
+        worker.notified = true;
+        worker.cond_var.notify_one();
+    }
+
+    void BehaviourWorkerPool::JobDone(const size_t id)
+    {
+        {
+            std::lock_guard<std::mutex> pool_guard(pool_mutex);
+            jobs.erase(id);
+        }
+        done_cond_var.notify_all();
+    }
+} // namespace Botcraft
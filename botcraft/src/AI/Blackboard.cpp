@@ -0,0 +1,28 @@
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+
+#include "botcraft/AI/Blackboard.hpp"
+
+namespace Botcraft
+{
+    const size_t Blackboard::GetSlotIndex(const std::string& key)
+    {
+        static std::unordered_map<std::string, size_t> indices;
+        static std::shared_mutex indices_mutex;
+
+        {
+            std::shared_lock<std::shared_mutex> read_lock(indices_mutex);
+            auto it = indices.find(key);
+            if (it != indices.end())
+            {
+                return it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> write_lock(indices_mutex);
+        // Use the current size as index, if the key has been added
+        // by another thread in between, the existing index is kept
+        return indices.insert({ key, indices.size() }).first->second;
+    }
+} // namespace Botcraft
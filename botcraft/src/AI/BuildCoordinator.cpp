@@ -0,0 +1,170 @@
+#include "botcraft/AI/BuildCoordinator.hpp"
+#include "botcraft/Game/World/World.hpp"
+#include "botcraft/Game/World/Block.hpp"
+#include "botcraft/Game/World/StructureDiff.hpp"
+
+namespace Botcraft
+{
+    // Same order as the PlayerDiggingFace used to place/dig against them
+    static const Position neighbour_offsets[6] = { Position(0, 1, 0), Position(0, -1, 0),
+        Position(0, 0, 1), Position(0, 0, -1),
+        Position(1, 0, 0), Position(-1, 0, 0) };
+
+    BuildCoordinator::BuildCoordinator(const long long int lease_duration_ms)
+    {
+        lease_duration = std::chrono::milliseconds(lease_duration_ms);
+    }
+
+    BuildCoordinator::~BuildCoordinator()
+    {
+
+    }
+
+    const bool BuildCoordinator::SetPlan(const Position& start, const Position& end,
+        const std::vector<std::vector<std::vector<short> > >& target,
+        const std::map<short, std::string>& palette)
+    {
+        std::lock_guard<std::mutex> coordinator_guard(coordinator_mutex);
+        if (diff)
+        {
+            return false;
+        }
+
+        diff = std::make_shared<StructureDiff>(start, end, target, palette);
+        return true;
+    }
+
+    const bool BuildCoordinator::HasPlan() const
+    {
+        std::lock_guard<std::mutex> coordinator_guard(coordinator_mutex);
+        return diff != nullptr;
+    }
+
+    std::shared_ptr<StructureDiff> BuildCoordinator::GetDiff() const
+    {
+        std::lock_guard<std::mutex> coordinator_guard(coordinator_mutex);
+        return diff;
+    }
+
+    const bool BuildCoordinator::AcquireJob(const std::string& owner, const std::shared_ptr<World>& world,
+        const Vector3<double>& position, const std::set<std::string>& available_items, BuildJob& job)
+    {
+        std::shared_ptr<StructureDiff> current_diff;
+        std::chrono::steady_clock::time_point now;
+        bool skip_failed = false;
+        Position failed;
+        {
+            std::lock_guard<std::mutex> coordinator_guard(coordinator_mutex);
+            if (!diff)
+            {
+                return false;
+            }
+            current_diff = diff;
+
+            ExpireLeases();
+
+            now = std::chrono::steady_clock::now();
+            Owner& owner_data = owners.insert({ owner, Owner{ false, Position(), false, Position(), now } }).first->second;
+            if (owner_data.has_lease)
+            {
+                leases.erase(owner_data.leased);
+                owner_data.has_lease = false;
+            }
+            skip_failed = owner_data.has_failed && now < owner_data.failed_until;
+            failed = owner_data.failed;
+        }
+
+        // Reading the world can take a while (the whole structure
+        // the first time), so it's done without the coordinator
+        // lock to let the other bots get or release their jobs
+        current_diff->Watch(world);
+        current_diff->Update();
+
+        // Leased blocks are still in the diff, they are skipped here
+        return current_diff->FindNearest(position, available_items, true, world,
+            [&](const Position& pos, const std::string& item)
+            {
+                if (skip_failed && pos == failed)
+                {
+                    return false;
+                }
+
+                // Find a solid neighbour to place/dig against
+                int face = -1;
+                for (int i = 0; i < 6; ++i)
+                {
+                    const Block* neighbour_block = world->GetBlock(pos + neighbour_offsets[i]);
+                    if (neighbour_block && !neighbour_block->GetBlockstate()->IsAir())
+                    {
+                        face = i;
+                        break;
+                    }
+                }
+                if (face == -1)
+                {
+                    return false;
+                }
+
+                std::lock_guard<std::mutex> coordinator_guard(coordinator_mutex);
+                if (leases.find(pos) != leases.end())
+                {
+                    return false;
+                }
+                job.action = item.empty() ? BuildJobAction::Dig : BuildJobAction::Place;
+                job.position = pos;
+                job.face = static_cast<PlayerDiggingFace>(face);
+                job.item = item;
+
+                const std::chrono::steady_clock::time_point expiry = now + lease_duration;
+                leases[pos] = Lease{ owner, expiry };
+                leases_queue.push_back({ expiry, pos });
+                Owner& owner_data = owners[owner];
+                owner_data.has_lease = true;
+                owner_data.leased = pos;
+                return true;
+            });
+    }
+
+    void BuildCoordinator::ReleaseJob(const std::string& owner, const bool success)
+    {
+        std::lock_guard<std::mutex> coordinator_guard(coordinator_mutex);
+        auto it = owners.find(owner);
+        if (it == owners.end() || !it->second.has_lease)
+        {
+            return;
+        }
+
+        if (!success)
+        {
+            it->second.has_failed = true;
+            it->second.failed = it->second.leased;
+            it->second.failed_until = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        }
+        leases.erase(it->second.leased);
+        it->second.has_lease = false;
+    }
+
+    void BuildCoordinator::ExpireLeases()
+    {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        while (!leases_queue.empty() && leases_queue.front().first <= now)
+        {
+            const Position pos = leases_queue.front().second;
+            const std::chrono::steady_clock::time_point expiry = leases_queue.front().first;
+            leases_queue.pop_front();
+
+            auto it = leases.find(pos);
+            // This lease may have been released and given again since
+            if (it == leases.end() || it->second.expiry != expiry)
+            {
+                continue;
+            }
+            auto owner = owners.find(it->second.owner);
+            if (owner != owners.end() && owner->second.has_lease && owner->second.leased == pos)
+            {
+                owner->second.has_lease = false;
+            }
+            leases.erase(it);
+        }
+    }
+} // namespace Botcraft
@@ -14,7 +14,9 @@ namespace Botcraft
     {
         client.Yield();
 
-        return Status::Success;
+        // Yield returns immediately once interrupted, so loops
+        // of Yield leaves must stop instead of spinning
+        return client.IsBehaviourInterrupted() ? Status::Failure : Status::Success;
     }
 
     Status Disconnect(BehaviourClient& client)
@@ -31,13 +33,13 @@ namespace Botcraft
 
     Status SayBlackboard(BehaviourClient& client)
     {
-        const std::vector<std::string> variable_names = {
-            "Say.msg" };
+        // Keys are resolved only once
+        static const BlackboardSlot<std::string> msg_slot("Say.msg");
 
         Blackboard& blackboard = client.GetBlackboard();
 
         // Mandatory
-        const std::string& msg = blackboard.Get<std::string>(variable_names[0]);
+        const std::string& msg = blackboard.Get<std::string>(msg_slot);
 
         return Say(client, msg);
     }
@@ -108,17 +110,19 @@ namespace Botcraft
 
     Status InteractWithBlockBlackboard(BehaviourClient& client)
     {
-        const std::vector<std::string> variable_names = {
-            "InteractWithBlock.pos" , "InteractWithBlock.face", "InteractWithBlock.animation" };
+        // Keys are resolved only once
+        static const BlackboardSlot<Position> pos_slot("InteractWithBlock.pos");
+        static const BlackboardSlot<PlayerDiggingFace> face_slot("InteractWithBlock.face");
+        static const BlackboardSlot<bool> animation_slot("InteractWithBlock.animation");
 
         Blackboard& blackboard = client.GetBlackboard();
 
         // Mandatory
-        const Position& pos = blackboard.Get<Position>(variable_names[0]);
+        const Position& pos = blackboard.Get<Position>(pos_slot);
 
         // Optional
-        const PlayerDiggingFace face = blackboard.Get<PlayerDiggingFace>(variable_names[1], PlayerDiggingFace::Top);
-        const bool animation = blackboard.Get(variable_names[2], false);
+        const PlayerDiggingFace face = blackboard.Get<PlayerDiggingFace>(face_slot, PlayerDiggingFace::Top);
+        const bool animation = blackboard.Get(animation_slot, false);
 
         return InteractWithBlock(client, pos, face, animation);
     }
@@ -130,13 +134,13 @@ namespace Botcraft
 
     Status CheckBlackboardBoolDataBlackboard(BehaviourClient& client)
     {
-        const std::vector<std::string> variable_names = {
-            "CheckBlackboardBoolData.key" };
+        // Keys are resolved only once
+        static const BlackboardSlot<std::string> key_slot("CheckBlackboardBoolData.key");
 
         Blackboard& blackboard = client.GetBlackboard();
 
         // Mandatory
-        const std::string& key = blackboard.Get<std::string>(variable_names[0]);
+        const std::string& key = blackboard.Get<std::string>(key_slot);
 
         return CheckBlackboardBoolData(client, key);
     }
@@ -150,13 +154,13 @@ namespace Botcraft
 
     Status RemoveBlackboardDataBlackboard(BehaviourClient& client)
     {
-        const std::vector<std::string> variable_names = {
-            "RemoveBlackboardData.key" };
+        // Keys are resolved only once
+        static const BlackboardSlot<std::string> key_slot("RemoveBlackboardData.key");
 
         Blackboard& blackboard = client.GetBlackboard();
 
         // Mandatory
-        const std::string& key = blackboard.Get<std::string>(variable_names[0]);
+        const std::string& key = blackboard.Get<std::string>(key_slot);
 
         return RemoveBlackboardData(client, key);
     }
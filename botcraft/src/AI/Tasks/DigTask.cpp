@@ -22,7 +22,7 @@ namespace Botcraft
         }
 
         std::shared_ptr<World> world = c.GetWorld();
-        std::shared_ptr<Blockstate> blockstate;
+        const Blockstate* blockstate;
         {
             std::lock_guard<std::mutex> world_guard(world->GetMutex());
             const Block* block = world->GetBlock(pos);
@@ -59,37 +59,30 @@ namespace Botcraft
             std::cout << "Starting an expected " << expected_mining_time / 1000.0f << " seconds long mining at " << pos << ". A little help?" << std::endl;
         }
 
-        auto start = std::chrono::system_clock::now();
-        bool finished_sent = false;
-        while (true)
+        auto is_block_broken = [&]()
         {
-            long long int elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count();
-            if (elapsed > 5000 + expected_mining_time)
-            {
-                std::cerr << "Something went wrong waiting block breaking confirmation (Timeout)." << std::endl;
-                return Status::Failure;
-            }
-            if (elapsed >= expected_mining_time
-                && !finished_sent)
-            {
-                std::shared_ptr<ServerboundPlayerActionPacket> msg_finish(new ServerboundPlayerActionPacket);
-                msg_finish->SetAction((int)PlayerDiggingStatus::FinishDigging);
-                msg_finish->SetPos(pos.ToNetworkPosition());
-                msg_finish->SetDirection((int)face);
-                network_manager->Send(msg_finish);
+            std::lock_guard<std::mutex> world_guard(world->GetMutex());
+            const Block* block = world->GetBlock(pos);
+            return !block || block->GetBlockstate()->IsAir();
+        };
 
-                finished_sent = true;
-            }
-            {
-                std::lock_guard<std::mutex> world_guard(world->GetMutex());
-                const Block* block = world->GetBlock(pos);
+        // Wait for the expected mining time, the block
+        // may be broken sooner by the server
+        if (c.WaitForBlocks(is_block_broken, pos, pos, {}, expected_mining_time))
+        {
+            return Status::Success;
+        }
 
-                if (!block || block->GetBlockstate()->IsAir())
-                {
-                    return Status::Success;
-                }
-            }
-            c.Yield();
+        std::shared_ptr<ServerboundPlayerActionPacket> msg_finish(new ServerboundPlayerActionPacket);
+        msg_finish->SetAction((int)PlayerDiggingStatus::FinishDigging);
+        msg_finish->SetPos(pos.ToNetworkPosition());
+        msg_finish->SetDirection((int)face);
+        network_manager->Send(msg_finish);
+
+        if (!c.WaitForBlocks(is_block_broken, pos, pos, {}, 5000))
+        {
+            std::cerr << "Something went wrong waiting block breaking confirmation (Timeout)." << std::endl;
+            return Status::Failure;
         }
 
         return Status::Success;
@@ -97,16 +90,17 @@ namespace Botcraft
 
     Status DigBlackboard(BehaviourClient& c)
     {
-        const std::vector<std::string> variable_names = {
-            "Dig.pos", "Dig.face" };
+        // Keys are resolved only once
+        static const BlackboardSlot<Position> pos_slot("Dig.pos");
+        static const BlackboardSlot<PlayerDiggingFace> face_slot("Dig.face");
 
         Blackboard& blackboard = c.GetBlackboard();
 
         // Mandatory
-        const Position& pos = blackboard.Get<Position>(variable_names[0]);
+        const Position& pos = blackboard.Get<Position>(pos_slot);
 
         // Optional
-        const PlayerDiggingFace face = blackboard.Get<PlayerDiggingFace>(variable_names[1], PlayerDiggingFace::Top);
+        const PlayerDiggingFace face = blackboard.Get<PlayerDiggingFace>(face_slot, PlayerDiggingFace::Top);
 
         return Dig(c, pos, face);
     }
@@ -18,6 +18,22 @@ using namespace ProtocolCraft;
 
 namespace Botcraft
 {
+#if PROTOCOL_VERSION < 755
+    // Wait until the server accepts or refuses the transaction,
+    // return TransactionState::Waiting on timeout
+    TransactionState WaitForTransaction(BehaviourClient& client, const short container_id, const int transaction_id)
+    {
+        std::shared_ptr<InventoryManager> inventory_manager = client.GetInventoryManager();
+        TransactionState transaction_state = TransactionState::Waiting;
+        client.WaitFor([&]()
+            {
+                transaction_state = inventory_manager->GetTransactionState(container_id, transaction_id);
+                return transaction_state != TransactionState::Waiting;
+            }, { &inventory_manager->GetInventorySignal() }, 10000);
+        return transaction_state;
+    }
+#endif
+
     Status SwapItemsInContainer(BehaviourClient& client, const short container_id, const short first_slot, const short second_slot)
     {
         std::shared_ptr<InventoryManager> inventory_manager = client.GetInventoryManager();
@@ -58,26 +74,16 @@ namespace Botcraft
 
         // Wait for the click confirmation (versions < 1.17)
 #if PROTOCOL_VERSION < 755
-        auto start = std::chrono::system_clock::now();
-        while (true)
+        const TransactionState first_transaction_state = WaitForTransaction(client, container_id, transaction_id);
+        if (first_transaction_state == TransactionState::Waiting)
         {
-            if (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count() >= 10000)
-            {
-                std::cerr << "Something went wrong trying to select first slot during swap inventory (Timeout)." << std::endl;
-                return Status::Failure;
-            }
-            TransactionState transaction_state = inventory_manager->GetTransactionState(container_id, transaction_id);
-            if (transaction_state == TransactionState::Accepted)
-            {
-                break;
-            }
-            // The transaction has been refused by the server, don't bother with other clicks
-            else if (transaction_state == TransactionState::Refused)
-            {
-                return Status::Failure;
-            }
-
-            client.Yield();
+            std::cerr << "Something went wrong trying to select first slot during swap inventory (Timeout)." << std::endl;
+            return Status::Failure;
+        }
+        // The transaction has been refused by the server, don't bother with other clicks
+        else if (first_transaction_state == TransactionState::Refused)
+        {
+            return Status::Failure;
         }
 #endif
 
@@ -107,27 +113,16 @@ namespace Botcraft
 
         // Wait for confirmation in version < 1.17
 #if PROTOCOL_VERSION < 755
-        start = std::chrono::system_clock::now();
-        while (true)
+        const TransactionState second_transaction_state = WaitForTransaction(client, container_id, transaction_id);
+        if (second_transaction_state == TransactionState::Waiting)
         {
-            if (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count() >= 10000)
-            {
-                std::cerr << "Something went wrong trying to select second slot during swap inventory (Timeout)." << std::endl;
-                return Status::Failure;
-            }
-
-            TransactionState transaction_state = inventory_manager->GetTransactionState(container_id, transaction_id);
-            if (transaction_state == TransactionState::Accepted)
-            {
-                break;
-            }
-            // The transaction has been refused by the server, don't bother with other clicks
-            else if (transaction_state == TransactionState::Refused)
-            {
-                return Status::Failure;
-            }
-
-            client.Yield();
+            std::cerr << "Something went wrong trying to select second slot during swap inventory (Timeout)." << std::endl;
+            return Status::Failure;
+        }
+        // The transaction has been refused by the server, don't bother with other clicks
+        else if (second_transaction_state == TransactionState::Refused)
+        {
+            return Status::Failure;
         }
 #endif
         // Left click once again on the first slot, transferring the cursor to the slot
@@ -154,27 +149,16 @@ namespace Botcraft
 
         // Wait for confirmation in version < 1.17
 #if PROTOCOL_VERSION < 755
-        start = std::chrono::system_clock::now();
-        while (true)
+        const TransactionState third_transaction_state = WaitForTransaction(client, container_id, transaction_id);
+        if (third_transaction_state == TransactionState::Waiting)
         {
-            if (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count() >= 10000)
-            {
-                std::cerr << "Something went wrong trying to select third slot during swap inventory (Timeout)." << std::endl;
-                return Status::Failure;
-            }
-
-            TransactionState transaction_state = inventory_manager->GetTransactionState(container_id, transaction_id);
-            if (transaction_state == TransactionState::Accepted)
-            {
-                break;
-            }
-            // The transaction has been refused by the server, don't bother with other clicks
-            else if (transaction_state == TransactionState::Refused)
-            {
-                return Status::Failure;
-            }
-
-            client.Yield();
+            std::cerr << "Something went wrong trying to select third slot during swap inventory (Timeout)." << std::endl;
+            return Status::Failure;
+        }
+        // The transaction has been refused by the server, don't bother with other clicks
+        else if (third_transaction_state == TransactionState::Refused)
+        {
+            return Status::Failure;
         }
 #endif
         // If we're here, everything succeeded
@@ -183,17 +167,17 @@ namespace Botcraft
 
     Status SwapItemsInContainerBlackboard(BehaviourClient& client)
     {
-        const std::vector<std::string> variable_names = {
-               "SwapItemsInContainer.container_id",
-               "SwapItemsInContainer.first_slot",
-               "SwapItemsInContainer.second_slot" };
+        // Keys are resolved only once
+        static const BlackboardSlot<short> container_id_slot("SwapItemsInContainer.container_id");
+        static const BlackboardSlot<short> first_slot_slot("SwapItemsInContainer.first_slot");
+        static const BlackboardSlot<short> second_slot_slot("SwapItemsInContainer.second_slot");
 
         Blackboard& blackboard = client.GetBlackboard();
 
         // Mandatory
-        const short container_id = blackboard.Get<short>(variable_names[0]);
-        const short first_slot = blackboard.Get<short>(variable_names[1]);
-        const short second_slot = blackboard.Get<short>(variable_names[2]);
+        const short container_id = blackboard.Get<short>(container_id_slot);
+        const short first_slot = blackboard.Get<short>(first_slot_slot);
+        const short second_slot = blackboard.Get<short>(second_slot_slot);
 
         return SwapItemsInContainer(client, container_id, first_slot, second_slot);
     }
@@ -202,6 +186,13 @@ namespace Botcraft
     {
         std::shared_ptr<InventoryManager> inventory_manager = client.GetInventoryManager();
 
+        // Resolve the name only once, then compare ids
+#if PROTOCOL_VERSION < 347
+        const std::pair<int, unsigned char> item_id = AssetsManager::getInstance().GetItemID(item_name);
+#else
+        const int item_id = AssetsManager::getInstance().GetItemID(item_name);
+#endif
+
         short inventory_correct_slot_index = -1;
         short inventory_destination_slot_index = -1;
         {
@@ -214,9 +205,10 @@ namespace Botcraft
             const Slot& current_selected = hand == Hand::Left ? inventory_manager->GetOffHand() : inventory_manager->GetHotbarSelected();
             if (!current_selected.IsEmptySlot()
 #if PROTOCOL_VERSION < 347
-                && AssetsManager::getInstance().Items().at(current_selected.GetBlockID()).at(current_selected.GetItemDamage())->GetName() == item_name)
+                && current_selected.GetBlockID() == item_id.first
+                && current_selected.GetItemDamage() == item_id.second)
 #else
-                && AssetsManager::getInstance().Items().at(current_selected.GetItemID())->GetName() == item_name)
+                && current_selected.GetItemID() == item_id)
 #endif
             {
                 return Status::Success;
@@ -230,9 +222,10 @@ namespace Botcraft
                     && it->first < Window::INVENTORY_OFFHAND_INDEX
                     && !it->second.IsEmptySlot()
 #if PROTOCOL_VERSION < 347
-                    && AssetsManager::getInstance().Items().at(it->second.GetBlockID()).at(it->second.GetItemDamage())->GetName() == item_name)
+                    && it->second.GetBlockID() == item_id.first
+                    && it->second.GetItemDamage() == item_id.second)
 #else
-                    && AssetsManager::getInstance().Items().at(it->second.GetItemID())->GetName() == item_name)
+                    && it->second.GetItemID() == item_id)
 #endif
                 {
                     inventory_correct_slot_index = it->first;
@@ -252,14 +245,15 @@ namespace Botcraft
 
     Status SetItemInHandBlackboard(BehaviourClient& client)
     {
-        const std::vector<std::string> variable_names = {
-            "SetItemInHand.item_name", "SetItemInHand.hand" };
+        // Keys are resolved only once
+        static const BlackboardSlot<std::string> item_name_slot("SetItemInHand.item_name");
+        static const BlackboardSlot<Hand> hand_slot("SetItemInHand.hand");
 
         Blackboard& blackboard = client.GetBlackboard();
 
         // Mandatory
-        const std::string& item_name = blackboard.Get<std::string>(variable_names[0]);
-        const Hand hand = blackboard.Get<Hand>(variable_names[1], Hand::Right);
+        const std::string& item_name = blackboard.Get<std::string>(item_name_slot);
+        const Hand hand = blackboard.Get<Hand>(hand_slot, Hand::Right);
 
         return SetItemInHand(client, item_name, hand);
     }
@@ -292,15 +286,13 @@ namespace Botcraft
         {
             const AABB this_box_collider = AABB(Vector3<double>(pos.x + 0.5, pos.y + 0.5, pos.z + 0.5), Vector3<double>(0.5, 0.5, 0.5));
 
+            std::vector<std::shared_ptr<Entity> > colliding_entities;
             std::lock_guard<std::mutex> entity_manager_guard(entity_manager->GetMutex());
-            const std::unordered_map<int, std::shared_ptr<Entity> >& entities = entity_manager->GetEntities();
+            entity_manager->GetEntities().QueryAABB(this_box_collider, colliding_entities);
             // TODO, check entity type, xp orbs and items don't collide
-            for (auto it = entities.begin(); it != entities.end(); ++it)
+            if (!colliding_entities.empty())
             {
-                if (this_box_collider.Collide(it->second->GetCollider()))
-                {
-                    return Status::Failure;
-                }
+                return Status::Failure;
             }
         }
 
@@ -370,14 +362,8 @@ namespace Botcraft
 
         bool is_block_ok = false;
         bool is_slot_ok = false;
-        auto start = std::chrono::system_clock::now();
-        while (!is_block_ok || !is_slot_ok)
+        auto is_placement_confirmed = [&]()
         {
-            if (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count() >= 3000)
-            {
-                std::cerr << "[" << network_manager->GetMyName() << "] Something went wrong waiting block placement confirmation at " << pos << " (Timeout)." << std::endl;
-                return Status::Failure;
-            }
             if (!is_block_ok)
             {
                 std::lock_guard<std::mutex> world_guard(world->GetMutex());
@@ -395,12 +381,13 @@ namespace Botcraft
                 is_slot_ok = new_num_item_in_hand == num_item_in_hand - 1;
             }
 
-            if (is_block_ok && is_slot_ok)
-            {
-                return Status::Success;
-            }
+            return is_block_ok && is_slot_ok;
+        };
 
-            client.Yield();
+        if (!client.WaitForBlocks(is_placement_confirmed, pos, pos, { &inventory_manager->GetInventorySignal() }, 3000))
+        {
+            std::cerr << "[" << network_manager->GetMyName() << "] Something went wrong waiting block placement confirmation at " << pos << " (Timeout)." << std::endl;
+            return Status::Failure;
         }
 
         return Status::Success;
@@ -408,18 +395,21 @@ namespace Botcraft
 
     Status PlaceBlockBlackboard(BehaviourClient& client)
     {
-        const std::vector<std::string> variable_names = {
-               "PlaceBlock.item_name", "PlaceBlock.pos", "PlaceBlock.face", "PlaceBlock.wait_confirmation" };
+        // Keys are resolved only once
+        static const BlackboardSlot<std::string> item_name_slot("PlaceBlock.item_name");
+        static const BlackboardSlot<Position> pos_slot("PlaceBlock.pos");
+        static const BlackboardSlot<PlayerDiggingFace> face_slot("PlaceBlock.face");
+        static const BlackboardSlot<bool> wait_confirmation_slot("PlaceBlock.wait_confirmation");
 
         Blackboard& blackboard = client.GetBlackboard();
 
         // Mandatory
-        const std::string& item_name = blackboard.Get<std::string>(variable_names[0]);
-        const Position& pos = blackboard.Get<Position>(variable_names[1]);
+        const std::string& item_name = blackboard.Get<std::string>(item_name_slot);
+        const Position& pos = blackboard.Get<Position>(pos_slot);
 
         // Optional
-        const PlayerDiggingFace face = blackboard.Get<PlayerDiggingFace>(variable_names[2], PlayerDiggingFace::Top);
-        const bool wait_confirmation = blackboard.Get<bool>(variable_names[3], false);
+        const PlayerDiggingFace face = blackboard.Get<PlayerDiggingFace>(face_slot, PlayerDiggingFace::Top);
+        const bool wait_confirmation = blackboard.Get<bool>(wait_confirmation_slot, false);
 
 
         return PlaceBlock(client, item_name, pos, face, wait_confirmation);
@@ -445,15 +435,11 @@ namespace Botcraft
             return Status::Success;
         }
 
-        auto start = std::chrono::system_clock::now();
-        while (inventory_manager->GetOffHand().GetItemCount() == current_stack_size)
+        if (!client.WaitFor([&]() { return inventory_manager->GetOffHand().GetItemCount() != current_stack_size; },
+            { &inventory_manager->GetInventorySignal() }, 3000))
         {
-            if (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count() >= 3000)
-            {
-                std::cerr << "Something went wrong trying to eat (Timeout)." << std::endl;
-                return Status::Failure;
-            }
-            client.Yield();
+            std::cerr << "Something went wrong trying to eat (Timeout)." << std::endl;
+            return Status::Failure;
         }
 
         return Status::Success;
@@ -461,16 +447,17 @@ namespace Botcraft
 
     Status EatBlackboard(BehaviourClient& client)
     {
-        const std::vector<std::string> variable_names = {
-               "Eat.food_name", "Eat.wait_confirmation" };
+        // Keys are resolved only once
+        static const BlackboardSlot<std::string> food_name_slot("Eat.food_name");
+        static const BlackboardSlot<bool> wait_confirmation_slot("Eat.wait_confirmation");
 
         Blackboard& blackboard = client.GetBlackboard();
 
         // Mandatory
-        const std::string& food_name = blackboard.Get<std::string>(variable_names[0]);
+        const std::string& food_name = blackboard.Get<std::string>(food_name_slot);
 
         // Optional
-        const bool wait_confirmation = blackboard.Get<bool>(variable_names[1], false);
+        const bool wait_confirmation = blackboard.Get<bool>(wait_confirmation_slot, false);
 
 
         return Eat(client, food_name, wait_confirmation);
@@ -487,15 +474,11 @@ namespace Botcraft
         std::shared_ptr<InventoryManager> inventory_manager = client.GetInventoryManager();
 
         // Wait for a window to be opened
-        auto start = std::chrono::system_clock::now();
-        while (inventory_manager->GetFirstOpenedWindowId() == -1)
+        if (!client.WaitFor([&]() { return inventory_manager->GetFirstOpenedWindowId() != -1; },
+            { &inventory_manager->GetInventorySignal() }, 3000))
         {
-            if (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count() >= 3000)
-            {
-                std::cerr << "Something went wrong trying to open container (Timeout)." << std::endl;
-                return Status::Failure;
-            }
-            client.Yield();
+            std::cerr << "Something went wrong trying to open container (Timeout)." << std::endl;
+            return Status::Failure;
         }
 
         return Status::Success;
@@ -503,13 +486,13 @@ namespace Botcraft
 
     Status OpenContainerBlackboard(BehaviourClient& client)
     {
-        const std::vector<std::string> variable_names = {
-               "OpenContainer.pos" };
+        // Keys are resolved only once
+        static const BlackboardSlot<Position> pos_slot("OpenContainer.pos");
 
         Blackboard& blackboard = client.GetBlackboard();
 
         // Mandatory
-        const Position& pos = blackboard.Get<Position>(variable_names[0]);
+        const Position& pos = blackboard.Get<Position>(pos_slot);
 
 
         return OpenContainer(client, pos);
@@ -533,13 +516,13 @@ namespace Botcraft
 
     Status CloseContainerBlackboard(BehaviourClient& client)
     {
-        const std::vector<std::string> variable_names = {
-               "CloseContainer.container_id" };
+        // Keys are resolved only once
+        static const BlackboardSlot<short> container_id_slot("CloseContainer.container_id");
 
         Blackboard& blackboard = client.GetBlackboard();
 
         // Mandatory
-        const short container_id = blackboard.Get<short>(variable_names[0]);
+        const short container_id = blackboard.Get<short>(container_id_slot);
 
 
         return CloseContainer(client, container_id);
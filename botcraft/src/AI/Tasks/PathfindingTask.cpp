@@ -4,6 +4,7 @@
 #include "botcraft/AI/Blackboard.hpp"
 
 #include "botcraft/Game/Entities/LocalPlayer.hpp"
+#include "botcraft/Game/Entities/MovementController.hpp"
 #include "botcraft/Game/Entities/EntityManager.hpp"
 #include "botcraft/Game/World/World.hpp"
 #include "botcraft/Network/NetworkManager.hpp"
@@ -391,21 +392,28 @@ namespace Botcraft
     }
 
     Status GoTo(BehaviourClient& client, const Position& goal, const int dist_tolerance,
-        const int min_end_dist, const float speed, const bool allow_jump)
+        const int min_end_dist, const float speed, const bool allow_jump, const bool sprint_jump)
     {
         std::shared_ptr<LocalPlayer> local_player = client.GetEntityManager()->GetLocalPlayer();
+        std::shared_ptr<MovementController> movement_controller = client.GetMovementController();
         std::shared_ptr<World> world = client.GetWorld();
+        const Signal& local_player_signal = client.GetEntityManager()->GetLocalPlayerSignal();
+        auto is_on_ground = [&]() { return local_player->GetState().on_ground; };
         Position current_position;
         do
         {
             // Wait until we are on the ground
-            while (!local_player->GetOnGround())
+            client.WaitFor(is_on_ground, { &local_player_signal }, -1);
+
+            // WaitFor returns early when interrupted, don't compute a path for nothing
+            if (client.IsBehaviourInterrupted())
             {
-                client.Yield();
+                return Status::Failure;
             }
 
             // Get the position
-            current_position = Position(std::floor(local_player->GetPosition().x), std::floor(local_player->GetPosition().y), std::floor(local_player->GetPosition().z));
+            const Vector3<double> player_position = local_player->GetState().position;
+            current_position = Position(std::floor(player_position.x), std::floor(player_position.y), std::floor(player_position.z));
 
             std::vector<Position> path;
             bool is_goal_loaded;
@@ -447,124 +455,46 @@ namespace Botcraft
                 }
             }
 
-            for (int i = 0; i < path.size(); ++i)
+            // Don't start moving if the tree has to stop
+            if (client.IsBehaviourInterrupted())
             {
-                const Vector3<double> initial_position = local_player->GetPosition();
-                const Vector3<double> target_position(path[i].x + 0.5, path[i].y, path[i].z + 0.5);
-                const Vector3<double> motion_vector = target_position - initial_position;
-                local_player->LookAt(target_position);
-
-                // If we have to jump to get to the next position
-                if (path[i].y > current_position.y ||
-                    std::abs(motion_vector.x) > 1.5 ||
-                    std::abs(motion_vector.z) > 1.5)
-                {
-                    // Jump
-                    {
-                        std::lock_guard<std::mutex> player_lock(local_player->GetMutex());
-                        local_player->SetSpeedY(0.4196141); // Not sure about this. I tried to calculate it in order to get a 1.25 block height jump (reached in 6 ticks)
-                    }
-
-                    if (std::abs(motion_vector.x) < 1.5 &&
-                        std::abs(motion_vector.z) < 1.5)
-                    {
-                        auto now = std::chrono::system_clock::now();
-                        bool has_timeout = false;
-                        while (local_player->GetY() - initial_position.y < 1.0f)
-                        {
-                            // This indicates that a jump we wanted to make is not possible anymore
-                            // recalculating the path
-                            if (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - now).count() >= 3000)
-                            {
-                                has_timeout = true;
-                                break;
-                            }
-                            client.Yield();
-                        }
-                        if (has_timeout)
-                        {
-                            break;
-                        }
-                    }
-                }
+                return Status::Failure;
+            }
 
-                auto start = std::chrono::system_clock::now();
-                auto previous_step = start;
-                const double motion_norm_xz = std::abs(motion_vector.x) + std::abs(motion_vector.z);
-                while (true)
+            // The path is followed by the physics thread, tick by tick
+            const unsigned int path_id = movement_controller->SetPath(path, speed, sprint_jump);
+            const long long int timeout_ms = static_cast<long long int>(2000.0 * path.size() / speed) + 3000;
+            client.WaitFor([&]()
                 {
-                    auto now = std::chrono::system_clock::now();
-                    long long int time_count = std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count();
-                    // If we are over the time we have at speed to travel one block
-                    if (time_count > 1000 * motion_norm_xz / speed)
-                    {
-                        {
-                            std::lock_guard<std::mutex> player_lock(local_player->GetMutex());
-                            local_player->SetSpeedX(target_position.x - local_player->GetX());
-                            local_player->SetY(local_player->GetY() + 0.001);
-                            local_player->SetSpeedZ(target_position.z - local_player->GetZ());
-
-                            // If the target motion requires going down
-                            if (motion_vector.y < 0)
-                            {
-                                local_player->SetOnGround(false);
-                            }
-                        }
-                        break;
-                    }
-                    // Otherwise just move partially toward the goal
-                    else
+                    if (movement_controller->GetStatus(path_id) != MovementStatus::Moving)
                     {
-                        long long int delta_t = std::chrono::duration_cast<std::chrono::milliseconds>(now - previous_step).count();
-                        Vector3<double> delta_v = motion_vector * delta_t / (1000.0 * motion_norm_xz) * speed;
-                        {
-                            std::lock_guard<std::mutex> player_lock(local_player->GetMutex());
-                            local_player->SetSpeedX(local_player->GetSpeed().x + delta_v.x);
-                            local_player->SetY(local_player->GetY() + 0.001);
-                            local_player->SetSpeedZ(local_player->GetSpeed().z + delta_v.z);
-                        }
-                        previous_step = now;
+                        return true;
                     }
-                    client.Yield();
-                }
-
-                // Wait for the confirmation that we arrived at the destination
-                start = std::chrono::system_clock::now();
-                bool has_timeout = false;
-                while (true)
-                {
-                    if (std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - start).count() >= 3000)
+                    // Replan as soon as the goal is loaded
+                    if (!is_goal_loaded)
                     {
-                        has_timeout = true;
-                        break;
+                        std::lock_guard<std::mutex> world_guard(world->GetMutex());
+                        return world->IsLoaded(goal);
                     }
+                    return false;
+                }, { &local_player_signal }, timeout_ms);
 
-                    {
-                        std::lock_guard<std::mutex> player_lock(local_player->GetMutex());
-                        const Vector3<double> diff = local_player->GetPosition() - target_position;
-                        if (std::abs(diff.x) + std::abs(diff.z) < 1e-2)
-                        {
-                            break;
-                        }
-                    }
-                    client.Yield();
-                }
+            // Stuck, timeout or replanning, stop and compute a new path from where we are
+            if (movement_controller->GetStatus(path_id) != MovementStatus::Arrived)
+            {
+                movement_controller->Stop();
+            }
 
-                // Wait until we are on the ground
-                while (!local_player->GetOnGround())
-                {
-                    client.Yield();
-                }
+            if (client.IsBehaviourInterrupted())
+            {
+                return Status::Failure;
+            }
 
-                current_position = Position(std::floor(local_player->GetPosition().x), std::floor(local_player->GetPosition().y), std::floor(local_player->GetPosition().z));
+            // Wait until we are on the ground
+            client.WaitFor(is_on_ground, { &local_player_signal }, -1);
 
-                if (has_timeout)
-                {
-                    // Something went wrong during the movement,
-                    // replanning the path is safer
-                    break;
-                }
-            }
+            const Vector3<double> arrival_position = local_player->GetState().position;
+            current_position = Position(std::floor(arrival_position.x), std::floor(arrival_position.y), std::floor(arrival_position.z));
         } while (current_position != goal);
 
         return Status::Success;
@@ -572,21 +502,32 @@ namespace Botcraft
 
     Status GoToBlackboard(BehaviourClient& client)
     {
-        const std::vector<std::string> variable_names = {
-        "GoTo.goal", "GoTo.dist_tolerance", "GoTo.min_end_dist",
-        "GoTo.speed", "GoTo.allow_jump" };
+        // Keys are resolved only once
+        static const BlackboardSlot<Position> goal_slot("GoTo.goal");
+        static const BlackboardSlot<int> dist_tolerance_slot("GoTo.dist_tolerance");
+        static const BlackboardSlot<int> min_end_dist_slot("GoTo.min_end_dist");
+        static const BlackboardSlot<float> speed_slot("GoTo.speed");
+        static const BlackboardSlot<bool> allow_jump_slot("GoTo.allow_jump");
+        static const BlackboardSlot<bool> sprint_jump_slot("GoTo.sprint_jump");
+        static const BlackboardSlot<double> achieved_speed_slot("GoTo.achieved_speed");
 
         Blackboard& blackboard = client.GetBlackboard();
 
         // Mandatory
-        const Position& goal = blackboard.Get<Position>(variable_names[0]);
+        const Position& goal = blackboard.Get<Position>(goal_slot);
 
         // Optional
-        const int dist_tolerance = blackboard.Get(variable_names[1], 0);
-        const int min_end_dist = blackboard.Get(variable_names[2], 0);
-        const float speed = blackboard.Get(variable_names[3], 4.317f);
-        const bool allow_jump = blackboard.Get(variable_names[4], true);
+        const int dist_tolerance = blackboard.Get(dist_tolerance_slot, 0);
+        const int min_end_dist = blackboard.Get(min_end_dist_slot, 0);
+        const float speed = blackboard.Get(speed_slot, 4.317f);
+        const bool allow_jump = blackboard.Get(allow_jump_slot, true);
+        const bool sprint_jump = blackboard.Get(sprint_jump_slot, false);
+
+        const Status result = GoTo(client, goal, dist_tolerance, min_end_dist, speed, allow_jump, sprint_jump);
+
+        // Output
+        blackboard.Set(achieved_speed_slot, client.GetMovementController()->GetAchievedSpeed());
 
-        return GoTo(client, goal, dist_tolerance, min_end_dist, speed, allow_jump);;
+        return result;
     }
 }
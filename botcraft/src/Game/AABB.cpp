@@ -1,6 +1,7 @@
 #include "botcraft/Game/AABB.hpp"
 
 #include <algorithm>
+#include <limits>
 
 namespace Botcraft
 {
@@ -10,11 +11,6 @@ namespace Botcraft
         half_size = half_size_;
     }
 
-    AABB::~AABB()
-    {
-
-    }
-
     const Vector3<double> AABB::GetMin() const
     {
         return center - half_size;
@@ -140,6 +136,132 @@ namespace Botcraft
         return time_entry;
     }
 
+    const double AABB::SweptCollide(const Vector3<double> &speed, const AABBArray &boxes, Vector3<double> &normal) const
+    {
+        const size_t num_boxes = boxes.Size();
+        if (num_boxes == 0)
+        {
+            return 1.0;
+        }
+
+        const Vector3<double> min = GetMin();
+        const Vector3<double> max = GetMax();
+
+        // Select once per axis which faces are used for entry/exit
+        // so the loop below has no data dependent branch
+        const double* entry_box[3];
+        const double* exit_box[3];
+        double entry_offset[3];
+        double exit_offset[3];
+        double axis_speed[3];
+        bool moving[3];
+        const std::vector<double>* box_min[3] = { &boxes.min_x, &boxes.min_y, &boxes.min_z };
+        const std::vector<double>* box_max[3] = { &boxes.max_x, &boxes.max_y, &boxes.max_z };
+        for (int i = 0; i < 3; ++i)
+        {
+            if (speed[i] > 0.0)
+            {
+                entry_box[i] = box_min[i]->data();
+                exit_box[i] = box_max[i]->data();
+                entry_offset[i] = max[i];
+                exit_offset[i] = min[i];
+            }
+            else
+            {
+                entry_box[i] = box_max[i]->data();
+                exit_box[i] = box_min[i]->data();
+                entry_offset[i] = min[i];
+                exit_offset[i] = max[i];
+            }
+            moving[i] = speed[i] != 0.0;
+            axis_speed[i] = moving[i] ? speed[i] : 1.0;
+        }
+
+        const double infinity = std::numeric_limits<double>::infinity();
+
+        // Boxes are processed by blocks: first the collision times of all
+        // the boxes of the block (no dependency between iterations and no
+        // branch, so the compiler can vectorize it), then the search of the
+        // first one. Adding -inf/+inf to the times of the non moving axes
+        // gives the same values as the scalar version without any branch
+        const double* entry_x = entry_box[0];
+        const double* entry_y = entry_box[1];
+        const double* entry_z = entry_box[2];
+        const double* exit_x = exit_box[0];
+        const double* exit_y = exit_box[1];
+        const double* exit_z = exit_box[2];
+        const double entry_add_x = moving[0] ? 0.0 : -infinity;
+        const double entry_add_y = moving[1] ? 0.0 : -infinity;
+        const double entry_add_z = moving[2] ? 0.0 : -infinity;
+        const double exit_add_x = moving[0] ? 0.0 : infinity;
+        const double exit_add_y = moving[1] ? 0.0 : infinity;
+        const double exit_add_z = moving[2] ? 0.0 : infinity;
+
+        const size_t block_size = 64;
+        double times[block_size];
+        double best_time = 1.0;
+        size_t best_index = num_boxes;
+        for (size_t block_start = 0; block_start < num_boxes; block_start += block_size)
+        {
+            const size_t block_end = std::min(num_boxes, block_start + block_size);
+            for (size_t j = block_start; j < block_end; ++j)
+            {
+                double time_entry_x = (entry_x[j] - entry_offset[0]) / axis_speed[0] + entry_add_x;
+                double time_entry_y = (entry_y[j] - entry_offset[1]) / axis_speed[1] + entry_add_y;
+                double time_entry_z = (entry_z[j] - entry_offset[2]) / axis_speed[2] + entry_add_z;
+                time_entry_x = time_entry_x > 1.0 ? -infinity : time_entry_x;
+                time_entry_y = time_entry_y > 1.0 ? -infinity : time_entry_y;
+                time_entry_z = time_entry_z > 1.0 ? -infinity : time_entry_z;
+                const double time_exit_x = (exit_x[j] - exit_offset[0]) / axis_speed[0] + exit_add_x;
+                const double time_exit_y = (exit_y[j] - exit_offset[1]) / axis_speed[1] + exit_add_y;
+                const double time_exit_z = (exit_z[j] - exit_offset[2]) / axis_speed[2] + exit_add_z;
+
+                const double time_entry = std::max(std::max(time_entry_x, time_entry_y), time_entry_z);
+                const double time_exit = std::min(std::min(time_exit_x, time_exit_y), time_exit_z);
+                // All entry times negative <=> their max is negative. Written as
+                // chained selects, boolean operators prevent the vectorization
+                double time = time_entry > time_exit ? 1.0 : time_entry;
+                time = time_entry < 0.0 ? 1.0 : time;
+                times[j - block_start] = time;
+            }
+            for (size_t j = block_start; j < block_end; ++j)
+            {
+                if (times[j - block_start] < best_time)
+                {
+                    best_time = times[j - block_start];
+                    best_index = j;
+                }
+            }
+        }
+
+        if (best_index == num_boxes)
+        {
+            return 1.0;
+        }
+
+        // Normal of the first box hit, with the same axis
+        // selection as the scalar version
+        double time_entry[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            const double time = moving[i] ? (entry_box[i][best_index] - entry_offset[i]) / axis_speed[i] : -infinity;
+            time_entry[i] = time > 1.0 ? -infinity : time;
+        }
+        int axis = 2;
+        if (time_entry[0] > time_entry[1] && time_entry[0] > time_entry[2])
+        {
+            axis = 0;
+        }
+        else if (time_entry[1] > time_entry[0] && time_entry[1] > time_entry[2])
+        {
+            axis = 1;
+        }
+        normal = Vector3<double>(0.0, 0.0, 0.0);
+        normal[axis] = entry_box[axis][best_index] - entry_offset[axis] < 0.0 ? 1.0 : -1.0;
+
+        return best_time;
+    }
+
     const bool AABB::Intersect(const Vector3<double> &origin, const Vector3<double> &direction) const
     {
         double tmin = -std::numeric_limits<float>::max();
@@ -162,4 +284,38 @@ namespace Botcraft
 
         return tmin <= tmax;
     }
+
+    void AABBArray::Clear()
+    {
+        min_x.clear();
+        min_y.clear();
+        min_z.clear();
+        max_x.clear();
+        max_y.clear();
+        max_z.clear();
+    }
+
+    void AABBArray::Add(const AABB& box)
+    {
+        const Vector3<double> min = box.GetMin();
+        const Vector3<double> max = box.GetMax();
+        min_x.push_back(min.x);
+        min_y.push_back(min.y);
+        min_z.push_back(min.z);
+        max_x.push_back(max.x);
+        max_y.push_back(max.y);
+        max_z.push_back(max.z);
+    }
+
+    const AABB AABBArray::Get(const size_t i) const
+    {
+        const Vector3<double> min(min_x[i], min_y[i], min_z[i]);
+        const Vector3<double> max(max_x[i], max_y[i], max_z[i]);
+        return AABB((min + max) / 2.0, (max - min) / 2.0);
+    }
+
+    const size_t AABBArray::Size() const
+    {
+        return min_x.size();
+    }
 } // Botcraft
\ No newline at end of file
@@ -0,0 +1,648 @@
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <stdexcept>
+#include <random>
+#include <cstdio>
+#include <type_traits>
+
+#include "botcraft/Game/AssetsCache.hpp"
+#include "botcraft/Game/World/Blockstate.hpp"
+#include "botcraft/Game/World/Biome.hpp"
+#include "botcraft/Game/Inventory/Item.hpp"
+#include "botcraft/Game/Model.hpp"
+
+namespace Botcraft
+{
+    namespace AssetsCache
+    {
+        // Colliders are read in place from the mapped file
+        static_assert(std::is_trivially_copyable<AABB>::value && sizeof(AABB) == 6 * sizeof(double), "AABB can't be stored as is in the assets cache");
+
+        // Utilities functions
+
+        // FNV-1a 64 bits
+        const unsigned long long int HashBytes(const void* bytes, const size_t size, unsigned long long int hash = 14695981039346656037ULL)
+        {
+            const unsigned char* ptr = static_cast<const unsigned char*>(bytes);
+            for (size_t i = 0; i < size; ++i)
+            {
+                hash ^= ptr[i];
+                hash *= 1099511628211ULL;
+            }
+            return hash;
+        }
+
+        // Sections are aligned so the records can be read in place
+        const size_t Align(const size_t offset)
+        {
+            return (offset + 7) & ~static_cast<size_t>(7);
+        }
+
+        template<typename T>
+        void WriteValue(std::vector<char>& output, const T& value)
+        {
+            const char* ptr = reinterpret_cast<const char*>(&value);
+            output.insert(output.end(), ptr, ptr + sizeof(T));
+        }
+
+        void WriteString(std::vector<char>& output, const std::string& s)
+        {
+            WriteValue<unsigned int>(output, static_cast<unsigned int>(s.size()));
+            output.insert(output.end(), s.begin(), s.end());
+        }
+
+        template<typename T>
+        const T ReadValue(const char*& iter, const char* end)
+        {
+            if (end - iter < static_cast<std::ptrdiff_t>(sizeof(T)))
+            {
+                throw(std::runtime_error("Not enough input in assets cache"));
+            }
+            T output;
+            std::memcpy(&output, iter, sizeof(T));
+            iter += sizeof(T);
+            return output;
+        }
+
+        const std::string ReadString(const char*& iter, const char* end)
+        {
+            const unsigned int size = ReadValue<unsigned int>(iter, end);
+            if (end - iter < static_cast<std::ptrdiff_t>(size))
+            {
+                throw(std::runtime_error("Not enough input in assets cache"));
+            }
+            std::string output(iter, size);
+            iter += size;
+            return output;
+        }
+
+#if USE_GUI
+        enum class TransformationType : unsigned char
+        {
+            Translation = 0,
+            Rotation = 1,
+            Scale = 2
+        };
+
+        void WriteTransformation(std::vector<char>& output, const Renderer::TransformationPtr& transformation)
+        {
+            if (const std::shared_ptr<Renderer::Translation> translation = std::dynamic_pointer_cast<Renderer::Translation>(transformation))
+            {
+                WriteValue(output, TransformationType::Translation);
+                WriteValue(output, translation->x);
+                WriteValue(output, translation->y);
+                WriteValue(output, translation->z);
+            }
+            else if (const std::shared_ptr<Renderer::Rotation> rotation = std::dynamic_pointer_cast<Renderer::Rotation>(transformation))
+            {
+                WriteValue(output, TransformationType::Rotation);
+                WriteValue(output, rotation->axis_x);
+                WriteValue(output, rotation->axis_y);
+                WriteValue(output, rotation->axis_z);
+                WriteValue(output, rotation->deg_angle);
+            }
+            else if (const std::shared_ptr<Renderer::Scale> scale = std::dynamic_pointer_cast<Renderer::Scale>(transformation))
+            {
+                WriteValue(output, TransformationType::Scale);
+                WriteValue(output, scale->axis_x);
+                WriteValue(output, scale->axis_y);
+                WriteValue(output, scale->axis_z);
+            }
+            else
+            {
+                throw(std::runtime_error("Unknown transformation type in assets cache"));
+            }
+        }
+
+        Renderer::TransformationPtr ReadTransformation(const char*& iter, const char* end)
+        {
+            switch (ReadValue<TransformationType>(iter, end))
+            {
+            case TransformationType::Translation:
+            {
+                const float x = ReadValue<float>(iter, end);
+                const float y = ReadValue<float>(iter, end);
+                const float z = ReadValue<float>(iter, end);
+                return std::make_shared<Renderer::Translation>(x, y, z);
+            }
+            case TransformationType::Rotation:
+            {
+                const float axis_x = ReadValue<float>(iter, end);
+                const float axis_y = ReadValue<float>(iter, end);
+                const float axis_z = ReadValue<float>(iter, end);
+                const float deg_angle = ReadValue<float>(iter, end);
+                return std::make_shared<Renderer::Rotation>(axis_x, axis_y, axis_z, deg_angle);
+            }
+            case TransformationType::Scale:
+            {
+                const float axis_x = ReadValue<float>(iter, end);
+                const float axis_y = ReadValue<float>(iter, end);
+                const float axis_z = ReadValue<float>(iter, end);
+                return std::make_shared<Renderer::Scale>(axis_x, axis_y, axis_z);
+            }
+            default:
+                throw(std::runtime_error("Unknown transformation type in assets cache"));
+            }
+        }
+#endif
+
+        const unsigned long long int ComputeSourceSignature(const std::string& assets_path)
+        {
+            const std::vector<std::string> folders = {
+                assets_path + "/custom",
+                assets_path + "/minecraft/blockstates",
+                assets_path + "/minecraft/models"
+            };
+
+            // Per file hashes are summed so the result
+            // doesn't depend on the iteration order
+            unsigned long long int signature = 0;
+            std::error_code ec;
+            for (int i = 0; i < folders.size(); ++i)
+            {
+                for (std::filesystem::recursive_directory_iterator it(folders[i], ec), end; !ec && it != end; it.increment(ec))
+                {
+                    if (!it->is_regular_file(ec))
+                    {
+                        continue;
+                    }
+
+                    const std::string path = it->path().generic_string();
+                    const unsigned long long int size = it->file_size(ec);
+                    const long long int write_time = it->last_write_time(ec).time_since_epoch().count();
+
+                    unsigned long long int file_hash = HashBytes(path.data(), path.size());
+                    file_hash = HashBytes(&size, sizeof(size), file_hash);
+                    file_hash = HashBytes(&write_time, sizeof(write_time), file_hash);
+                    signature += file_hash;
+                }
+                ec.clear();
+            }
+
+            return signature;
+        }
+
+        Writer::Writer(const unsigned long long int source_signature_)
+        {
+            source_signature = source_signature_;
+        }
+
+        void Writer::AddBlockstate(const Blockstate& blockstate, const unsigned char key_metadata)
+        {
+            BlockstateRecord record;
+            std::memset(&record, 0, sizeof(BlockstateRecord));
+
+            record.id = blockstate.GetId();
+#if PROTOCOL_VERSION < 347
+            record.metadata = blockstate.GetMetadata();
+#endif
+            record.flags = (blockstate.IsTransparent() ? BlockstateFlags::Transparent : 0)
+                | (blockstate.IsSolid() ? BlockstateFlags::Solid : 0)
+                | (blockstate.IsFluid() ? BlockstateFlags::Fluid : 0);
+            record.tint_type = static_cast<unsigned char>(blockstate.GetTintType());
+            record.key_metadata = key_metadata;
+            record.hardness = blockstate.GetHardness();
+            record.name_size = static_cast<unsigned int>(blockstate.GetName().size());
+            record.name_offset = AddString(blockstate.GetName());
+            record.name_id = blockstate.GetNameId();
+            record.first_model = static_cast<unsigned int>(models.size());
+            record.num_models = blockstate.GetNumModels();
+
+            for (int i = 0; i < blockstate.GetNumModels(); ++i)
+            {
+                AddModel(blockstate.GetModel(i), blockstate.GetModelWeight(i));
+            }
+
+            blockstates.push_back(record);
+        }
+
+        void Writer::AddBiome(const int id, const Biome& biome)
+        {
+            BiomeRecord record;
+            std::memset(&record, 0, sizeof(BiomeRecord));
+
+            record.id = id;
+            record.temperature = biome.GetTemperature();
+            record.rainfall = biome.GetRainfall();
+            record.biome_type = static_cast<int>(biome.GetBiomeType());
+            record.name_size = static_cast<unsigned int>(biome.GetName().size());
+            record.name_offset = AddString(biome.GetName());
+
+            biomes.push_back(record);
+        }
+
+        void Writer::AddItem(const Item& item)
+        {
+            ItemRecord record;
+            std::memset(&record, 0, sizeof(ItemRecord));
+
+            record.id = item.GetId();
+#if PROTOCOL_VERSION < 347
+            record.damage_id = item.GetDamageId();
+#endif
+            record.name_size = static_cast<unsigned int>(item.GetName().size());
+            record.name_offset = AddString(item.GetName());
+
+            items.push_back(record);
+        }
+
+        void Writer::AddTexture(const std::string& name)
+        {
+            TextureRecord record;
+            record.name_size = static_cast<unsigned int>(name.size());
+            record.name_offset = AddString(name);
+
+            textures.push_back(record);
+        }
+
+        const bool Writer::Save(const std::string& path) const
+        {
+            Header header;
+            std::memset(&header, 0, sizeof(Header));
+            std::memcpy(header.magic, "BCAC", 4);
+            header.format_version = FORMAT_VERSION;
+            header.protocol_version = PROTOCOL_VERSION;
+#if USE_GUI
+            header.use_gui = 1;
+#endif
+            header.source_signature = source_signature;
+            header.num_blockstates = static_cast<unsigned int>(blockstates.size());
+            header.num_models = static_cast<unsigned int>(models.size());
+            header.num_colliders = static_cast<unsigned int>(colliders.size());
+            header.num_biomes = static_cast<unsigned int>(biomes.size());
+            header.num_items = static_cast<unsigned int>(items.size());
+            header.strings_size = static_cast<unsigned int>(strings.size());
+            header.faces_size = faces.size();
+            header.num_textures = static_cast<unsigned int>(textures.size());
+
+            std::vector<char> output;
+            auto append_section = [&output](const void* data, const size_t size)
+            {
+                output.resize(Align(output.size()), 0);
+                const char* ptr = static_cast<const char*>(data);
+                output.insert(output.end(), ptr, ptr + size);
+            };
+
+            append_section(&header, sizeof(Header));
+            append_section(blockstates.data(), blockstates.size() * sizeof(BlockstateRecord));
+            append_section(models.data(), models.size() * sizeof(ModelRecord));
+            append_section(weights.data(), weights.size() * sizeof(int));
+            append_section(colliders.data(), colliders.size() * sizeof(AABB));
+            append_section(biomes.data(), biomes.size() * sizeof(BiomeRecord));
+            append_section(items.data(), items.size() * sizeof(ItemRecord));
+            append_section(textures.data(), textures.size() * sizeof(TextureRecord));
+            append_section(strings.data(), strings.size());
+            append_section(faces.data(), faces.size());
+
+            // Write to a temporary file first and then rename it, so other
+            // processes never map a partially written cache file
+            const std::string tmp_path = path + "." + std::to_string(std::random_device()()) + ".tmp";
+            {
+                std::ofstream file(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+                if (!file.is_open())
+                {
+                    return false;
+                }
+                file.write(output.data(), output.size());
+                if (!file.good())
+                {
+                    file.close();
+                    std::remove(tmp_path.c_str());
+                    return false;
+                }
+            }
+
+            std::error_code ec;
+            std::filesystem::rename(tmp_path, path, ec);
+            if (ec)
+            {
+                std::remove(tmp_path.c_str());
+                return false;
+            }
+
+            return true;
+        }
+
+        const unsigned int Writer::AddString(const std::string_view s)
+        {
+            const unsigned int offset = static_cast<unsigned int>(strings.size());
+            strings.insert(strings.end(), s.begin(), s.end());
+            return offset;
+        }
+
+        void Writer::AddModel(const Model& model, const int weight)
+        {
+            ModelRecord record;
+            std::memset(&record, 0, sizeof(ModelRecord));
+
+            weights.push_back(weight);
+
+            const AABBView model_colliders = model.GetCollidersView();
+            record.first_collider = static_cast<unsigned int>(colliders.size());
+            record.num_colliders = static_cast<unsigned int>(model_colliders.size());
+            colliders.insert(colliders.end(), model_colliders.begin(), model_colliders.end());
+
+            record.faces_offset = faces.size();
+#if USE_GUI
+            const std::vector<FaceDescriptor>& model_faces = model.GetFaces();
+            WriteValue<unsigned int>(faces, static_cast<unsigned int>(model_faces.size()));
+            for (int i = 0; i < model_faces.size(); ++i)
+            {
+                const FaceDescriptor& face = model_faces[i];
+                const Renderer::FaceTransformation& transformations = face.transformations;
+
+                WriteValue<unsigned char>(faces, static_cast<unsigned char>(face.orientation));
+                WriteValue<unsigned char>(faces, static_cast<unsigned char>(face.cullface_direction));
+                WriteValue<unsigned char>(faces, transformations.rotation);
+                WriteValue(faces, transformations.offset_x1);
+                WriteValue(faces, transformations.offset_y1);
+                WriteValue(faces, transformations.offset_x2);
+                WriteValue(faces, transformations.offset_y2);
+
+                WriteValue<unsigned int>(faces, static_cast<unsigned int>(face.texture_names.size()));
+                for (int j = 0; j < face.texture_names.size(); ++j)
+                {
+                    WriteString(faces, face.texture_names[j]);
+                }
+                WriteValue<unsigned int>(faces, static_cast<unsigned int>(face.use_tintindexes.size()));
+                for (int j = 0; j < face.use_tintindexes.size(); ++j)
+                {
+                    WriteValue<unsigned char>(faces, face.use_tintindexes[j]);
+                }
+
+                WriteValue<unsigned int>(faces, static_cast<unsigned int>(transformations.scales.size()));
+                for (int j = 0; j < transformations.scales.size(); ++j)
+                {
+                    WriteValue(faces, transformations.scales[j]->axis_x);
+                    WriteValue(faces, transformations.scales[j]->axis_y);
+                    WriteValue(faces, transformations.scales[j]->axis_z);
+                }
+                WriteValue<unsigned int>(faces, static_cast<unsigned int>(transformations.rotations.size()));
+                for (int j = 0; j < transformations.rotations.size(); ++j)
+                {
+                    WriteTransformation(faces, transformations.rotations[j]);
+                }
+                WriteValue<unsigned int>(faces, static_cast<unsigned int>(transformations.translations.size()));
+                for (int j = 0; j < transformations.translations.size(); ++j)
+                {
+                    WriteTransformation(faces, transformations.translations[j]);
+                }
+            }
+#endif
+
+            models.push_back(record);
+        }
+
+
+        Reader::Reader(const std::string& path, const unsigned long long int expected_signature) : file(path)
+        {
+            valid = false;
+            header = nullptr;
+
+            if (!file.IsOpen() || file.GetSize() < sizeof(Header))
+            {
+                return;
+            }
+
+            header = reinterpret_cast<const Header*>(file.GetData());
+            if (std::memcmp(header->magic, "BCAC", 4) != 0
+                || header->format_version != FORMAT_VERSION
+                || header->protocol_version != PROTOCOL_VERSION
+#if USE_GUI
+                || header->use_gui != 1
+#else
+                || header->use_gui != 0
+#endif
+                || header->source_signature != expected_signature)
+            {
+                return;
+            }
+
+            // Compute sections positions and check they all fit in the file
+            size_t offset = 0;
+            auto next_section = [&](const size_t size)
+            {
+                const char* section = file.GetData() + Align(offset);
+                offset = Align(offset) + size;
+                return section;
+            };
+
+            next_section(sizeof(Header));
+            blockstates = reinterpret_cast<const BlockstateRecord*>(next_section(header->num_blockstates * sizeof(BlockstateRecord)));
+            models = reinterpret_cast<const ModelRecord*>(next_section(header->num_models * sizeof(ModelRecord)));
+            weights = reinterpret_cast<const int*>(next_section(header->num_models * sizeof(int)));
+            colliders = reinterpret_cast<const AABB*>(next_section(header->num_colliders * sizeof(AABB)));
+            biomes = reinterpret_cast<const BiomeRecord*>(next_section(header->num_biomes * sizeof(BiomeRecord)));
+            items = reinterpret_cast<const ItemRecord*>(next_section(header->num_items * sizeof(ItemRecord)));
+            textures = reinterpret_cast<const TextureRecord*>(next_section(header->num_textures * sizeof(TextureRecord)));
+            strings = next_section(header->strings_size);
+            faces = next_section(header->faces_size);
+
+            if (offset > file.GetSize())
+            {
+                return;
+            }
+
+            valid = true;
+        }
+
+        const bool Reader::IsValid() const
+        {
+            return valid;
+        }
+
+        const size_t Reader::GetNumTextures() const
+        {
+            return valid ? header->num_textures : 0;
+        }
+
+        std::vector<Model> Reader::CreateModels() const
+        {
+            std::vector<Model> output(valid ? header->num_models : 0);
+
+            for (size_t i = 0; i < output.size(); ++i)
+            {
+                const ModelRecord& record = models[i];
+                if (static_cast<unsigned long long int>(record.first_collider) + record.num_colliders > header->num_colliders)
+                {
+                    throw(std::runtime_error("Invalid collider index in assets cache"));
+                }
+                output[i].mapped_colliders = colliders + record.first_collider;
+                output[i].num_mapped_colliders = record.num_colliders;
+
+#if USE_GUI
+                // Faces hold the renderer transformations, they
+                // can't be used in place and are still deserialized
+                if (record.faces_offset > header->faces_size)
+                {
+                    throw(std::runtime_error("Invalid faces offset in assets cache"));
+                }
+                const char* iter = faces + record.faces_offset;
+                const char* end = faces + header->faces_size;
+
+                std::vector<FaceDescriptor>& model_faces = output[i].GetFaces();
+                model_faces.resize(ReadValue<unsigned int>(iter, end));
+                for (int j = 0; j < model_faces.size(); ++j)
+                {
+                    FaceDescriptor& face = model_faces[j];
+                    Renderer::FaceTransformation& transformations = face.transformations;
+
+                    face.orientation = static_cast<Orientation>(ReadValue<unsigned char>(iter, end));
+                    face.cullface_direction = static_cast<Orientation>(ReadValue<unsigned char>(iter, end));
+                    transformations.rotation = ReadValue<unsigned char>(iter, end);
+                    transformations.offset_x1 = ReadValue<float>(iter, end);
+                    transformations.offset_y1 = ReadValue<float>(iter, end);
+                    transformations.offset_x2 = ReadValue<float>(iter, end);
+                    transformations.offset_y2 = ReadValue<float>(iter, end);
+
+                    face.texture_names.resize(ReadValue<unsigned int>(iter, end));
+                    for (int k = 0; k < face.texture_names.size(); ++k)
+                    {
+                        face.texture_names[k] = ReadString(iter, end);
+                    }
+                    face.use_tintindexes.resize(ReadValue<unsigned int>(iter, end));
+                    for (int k = 0; k < face.use_tintindexes.size(); ++k)
+                    {
+                        face.use_tintindexes[k] = ReadValue<unsigned char>(iter, end) != 0;
+                    }
+
+                    transformations.scales.resize(ReadValue<unsigned int>(iter, end));
+                    for (int k = 0; k < transformations.scales.size(); ++k)
+                    {
+                        const float axis_x = ReadValue<float>(iter, end);
+                        const float axis_y = ReadValue<float>(iter, end);
+                        const float axis_z = ReadValue<float>(iter, end);
+                        transformations.scales[k] = std::make_shared<Renderer::Scale>(axis_x, axis_y, axis_z);
+                    }
+                    transformations.rotations.resize(ReadValue<unsigned int>(iter, end));
+                    for (int k = 0; k < transformations.rotations.size(); ++k)
+                    {
+                        transformations.rotations[k] = ReadTransformation(iter, end);
+                    }
+                    transformations.translations.resize(ReadValue<unsigned int>(iter, end));
+                    for (int k = 0; k < transformations.translations.size(); ++k)
+                    {
+                        transformations.translations[k] = ReadTransformation(iter, end);
+                    }
+
+                    face.face = Renderer::Face(transformations, face.orientation);
+                }
+#endif
+            }
+
+            return output;
+        }
+
+        std::vector<std::shared_ptr<Blockstate> > Reader::CreateBlockstates(const std::vector<Model>& models_, std::vector<unsigned char>& key_metadata) const
+        {
+            const size_t num_blockstates = valid ? header->num_blockstates : 0;
+            if (num_blockstates > 0 && models_.size() != header->num_models)
+            {
+                throw(std::runtime_error("Models don't match the assets cache"));
+            }
+
+            // One allocation for all the blockstates, the returned
+            // pointers share the ownership of the whole array
+            std::shared_ptr<Blockstate> storage(new Blockstate[num_blockstates], std::default_delete<Blockstate[]>());
+            std::vector<std::shared_ptr<Blockstate> > output(num_blockstates);
+            key_metadata.resize(num_blockstates);
+
+            for (size_t i = 0; i < num_blockstates; ++i)
+            {
+                const BlockstateRecord& record = blockstates[i];
+                if (static_cast<unsigned long long int>(record.first_model) + record.num_models > header->num_models)
+                {
+                    throw(std::runtime_error("Invalid model index in assets cache"));
+                }
+
+                Blockstate& blockstate = storage.get()[i];
+                blockstate.id = record.id;
+#if PROTOCOL_VERSION < 347
+                blockstate.metadata = record.metadata;
+#endif
+                blockstate.transparent = (record.flags & BlockstateFlags::Transparent) != 0;
+                blockstate.solid = (record.flags & BlockstateFlags::Solid) != 0;
+                blockstate.fluid = (record.flags & BlockstateFlags::Fluid) != 0;
+                blockstate.hardness = record.hardness;
+                blockstate.tint_type = static_cast<TintType>(record.tint_type);
+                blockstate.SetName(GetString(record.name_offset, record.name_size), record.name_id);
+                blockstate.models = models_.data() + record.first_model;
+                blockstate.models_weights = weights + record.first_model;
+                blockstate.num_models = record.num_models;
+                blockstate.weights_sum = 0;
+                for (unsigned int j = 0; j < record.num_models; ++j)
+                {
+                    blockstate.weights_sum += blockstate.models_weights[j];
+                }
+
+                key_metadata[i] = record.key_metadata;
+                output[i] = std::shared_ptr<Blockstate>(storage, &blockstate);
+            }
+
+            return output;
+        }
+
+        std::vector<std::pair<int, std::shared_ptr<Biome> > > Reader::CreateBiomes() const
+        {
+            const size_t num_biomes = valid ? header->num_biomes : 0;
+            std::shared_ptr<Biome> storage(new Biome[num_biomes], std::default_delete<Biome[]>());
+            std::vector<std::pair<int, std::shared_ptr<Biome> > > output(num_biomes);
+
+            for (size_t i = 0; i < num_biomes; ++i)
+            {
+                const BiomeRecord& record = biomes[i];
+
+                Biome& biome = storage.get()[i];
+                biome.name = std::string(GetString(record.name_offset, record.name_size));
+                biome.temperature = record.temperature;
+                biome.rainfall = record.rainfall;
+                biome.biome_type = static_cast<BiomeType>(record.biome_type);
+                biome.default_grass = biome.ComputeColorTriangle(0, true);
+                biome.default_leaves = biome.ComputeColorTriangle(0, false);
+
+                output[i] = { record.id, std::shared_ptr<Biome>(storage, &biome) };
+            }
+
+            return output;
+        }
+
+        std::vector<std::shared_ptr<Item> > Reader::CreateItems() const
+        {
+            const size_t num_items = valid ? header->num_items : 0;
+            std::shared_ptr<Item> storage(new Item[num_items], std::default_delete<Item[]>());
+            std::vector<std::shared_ptr<Item> > output(num_items);
+
+            for (size_t i = 0; i < num_items; ++i)
+            {
+                const ItemRecord& record = items[i];
+
+                Item& item = storage.get()[i];
+                item.id = record.id;
+#if PROTOCOL_VERSION < 347
+                item.damage_id = record.damage_id;
+#endif
+                item.name = std::string(GetString(record.name_offset, record.name_size));
+
+                output[i] = std::shared_ptr<Item>(storage, &item);
+            }
+
+            return output;
+        }
+
+        const std::string Reader::GetTextureName(const size_t i) const
+        {
+            const TextureRecord& record = textures[i];
+            return std::string(GetString(record.name_offset, record.name_size));
+        }
+
+        const std::string_view Reader::GetString(const unsigned int offset, const unsigned int size) const
+        {
+            if (static_cast<unsigned long long int>(offset) + size > header->strings_size)
+            {
+                throw(std::runtime_error("Invalid string in assets cache"));
+            }
+            return std::string_view(strings + offset, size);
+        }
+    } // AssetsCache
+} // Botcraft
@@ -1,8 +1,10 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <chrono>
 
 #include "botcraft/Game/AssetsManager.hpp"
+#include "botcraft/Game/AssetsCache.hpp"
 #include "botcraft/Game/World/Block.hpp"
 #include "botcraft/Game/World/Biome.hpp"
 
@@ -19,18 +21,58 @@ namespace Botcraft
 
     AssetsManager::AssetsManager()
     {
-        std::cout << "Loading blocks from file..." << std::endl;
-        LoadBlocksFile();
-        std::cout << "Done!" << std::endl;
-        std::cout << "Loading biomes from file..." << std::endl;
-        LoadBiomesFile();
-        std::cout << "Done!" << std::endl;
-        std::cout << "Loading items from file..." << std::endl;
-        LoadItemsFile();
-        std::cout << "Done!" << std::endl;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const std::string cache_path = ASSETS_PATH + std::string("/assets_cache.bin");
+        const unsigned long long int source_signature = AssetsCache::ComputeSourceSignature(ASSETS_PATH);
+
+        std::cout << "Loading assets from cache file..." << std::endl;
+        if (LoadCacheFile(cache_path, source_signature))
+        {
+            std::cout << "Done!" << std::endl;
+            std::cout << "Cache file read in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms" << std::endl;
+        }
+        else
+        {
+            std::cout << "No valid cache file found, loading from json files" << std::endl;
+            std::cout << "Loading blocks from file..." << std::endl;
+            LoadBlocksFile();
+            std::cout << "Done!" << std::endl;
+            std::cout << "Loading biomes from file..." << std::endl;
+            LoadBiomesFile();
+            std::cout << "Done!" << std::endl;
+            std::cout << "Loading items from file..." << std::endl;
+            LoadItemsFile();
+            std::cout << "Done!" << std::endl;
+#ifdef USE_GUI
+            ListTextureNames();
+#endif
+            std::cout << "Json files read in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms" << std::endl;
+            std::cout << "Writing cache file..." << std::endl;
+            WriteCacheFile(cache_path, source_signature);
+            std::cout << "Done!" << std::endl;
+            // Switch to the file we just wrote, so the registries are
+            // views into the mapping, shared with the other processes
+            const std::chrono::steady_clock::time_point cache_start = std::chrono::steady_clock::now();
+            if (!LoadCacheFile(cache_path, source_signature))
+            {
+                std::cerr << "Can't read back assets cache file, using assets loaded from json files" << std::endl;
+            }
+            else
+            {
+                std::cout << "Cache file read in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - cache_start).count() << " ms" << std::endl;
+            }
+        }
+        FlattenRegistries();
+        BuildCollisionShapes();
         std::cout << "Clearing cache from memory..." << std::endl;
         ClearCaches();
         std::cout << "Done!" << std::endl;
+        std::cout << "Assets loaded in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms" << std::endl;
+    }
+
+    AssetsManager::~AssetsManager()
+    {
+
     }
 
 #if PROTOCOL_VERSION < 347
@@ -51,21 +93,81 @@ namespace Botcraft
         return biomes;
     }
 
-#if PROTOCOL_VERSION < 358
-    const std::shared_ptr<Biome> AssetsManager::GetBiome(const unsigned char id)
+#if PROTOCOL_VERSION < 347
+    const Blockstate* AssetsManager::GetBlockstate(const int id, const unsigned char metadata) const
+    {
+        if (id < 0 || metadata > 0x0F)
+        {
+            return blockstates.at(-1).at(0).get();
+        }
+        const size_t global_id = static_cast<size_t>(Blockstate::IdMetadataToId(id, metadata));
+        if (global_id >= flattened_blockstates.size())
+        {
+            return blockstates.at(-1).at(0).get();
+        }
+        return flattened_blockstates[global_id];
+    }
+
+    const std::pair<int, unsigned char> AssetsManager::GetBlockstateID(const std::string& blockstate_name) const
+    {
+        auto it = blockstates_name_to_id.find(blockstate_name);
+        if (it == blockstates_name_to_id.end())
+        {
+            return { -1, 0 };
+        }
+        return it->second;
+    }
 #else
-    const std::shared_ptr<Biome> AssetsManager::GetBiome(const int id)
+    const Blockstate* AssetsManager::GetBlockstate(const int id) const
+    {
+        if (id < 0 || static_cast<size_t>(id) >= flattened_blockstates.size())
+        {
+            return blockstates.at(-1).get();
+        }
+        return flattened_blockstates[id];
+    }
+
+    const int AssetsManager::GetBlockstateID(const std::string& blockstate_name) const
+    {
+        auto it = blockstates_name_to_id.find(blockstate_name);
+        if (it == blockstates_name_to_id.end())
+        {
+            return -1;
+        }
+        return it->second;
+    }
 #endif
+
+    const CollisionShape& AssetsManager::GetCollisionShape(const Blockstate* blockstate, const Position& pos) const
     {
-        auto it = biomes.find(id);
-        if (it != biomes.end())
+#if PROTOCOL_VERSION < 347
+        const unsigned int global_id = Blockstate::IdMetadataToId(blockstate->GetId(), blockstate->GetMetadata());
+#else
+        const unsigned int global_id = blockstate->GetId();
+#endif
+        const std::pair<unsigned int, unsigned char>& collision = global_id < flattened_collisions.size() ? flattened_collisions[global_id] : default_collision;
+        if (collision.second < 2)
         {
-            return biomes[id];
+            return collision_shapes[collision.first];
         }
-        else
+        return collision_shapes[collision.first + blockstate->GetModelId(pos)];
+    }
+
+#if PROTOCOL_VERSION < 358
+    const Biome* AssetsManager::GetBiome(const unsigned char id) const
+#else
+    const Biome* AssetsManager::GetBiome(const int id) const
+#endif
+    {
+#if PROTOCOL_VERSION < 358
+        if (id >= flattened_biomes.size())
+#else
+        if (id < 0 || static_cast<size_t>(id) >= flattened_biomes.size())
+#endif
         {
             return nullptr;
         }
+        return flattened_biomes[id];
     }
 
 #if PROTOCOL_VERSION < 347
@@ -77,8 +179,65 @@ namespace Botcraft
         return items;
     }
 
+#if PROTOCOL_VERSION < 347
+    const Item* AssetsManager::GetItem(const int id, const unsigned char damage_id) const
+    {
+        if (id < 0 || static_cast<size_t>(id) + 1 >= flattened_items_offsets.size())
+        {
+            return items.at(-1).at(0).get();
+        }
+        const unsigned int index = flattened_items_offsets[id] + damage_id;
+        if (index >= flattened_items_offsets[id + 1])
+        {
+            return items.at(-1).at(0).get();
+        }
+        return flattened_items[index];
+    }
+
+    const std::pair<int, unsigned char> AssetsManager::GetItemID(const std::string& item_name) const
+    {
+        auto it = items_name_to_id.find(item_name);
+        if (it == items_name_to_id.end())
+        {
+            return { -1, 0 };
+        }
+        return it->second;
+    }
+#else
+    const Item* AssetsManager::GetItem(const int id) const
+    {
+        if (id < 0 || static_cast<size_t>(id) >= flattened_items.size())
+        {
+            return items.at(-1).get();
+        }
+        return flattened_items[id];
+    }
+
+    const int AssetsManager::GetItemID(const std::string& item_name) const
+    {
+        auto it = items_name_to_id.find(item_name);
+        if (it == items_name_to_id.end())
+        {
+            return -1;
+        }
+        return it->second;
+    }
+#endif
+
 #ifdef USE_GUI
     const std::vector<std::pair<std::string, std::string> > AssetsManager::GetTexturesPathsNames() const
+    {
+        std::vector<std::pair<std::string, std::string> > output;
+        output.reserve(texture_names.size());
+        for (int i = 0; i < texture_names.size(); ++i)
+        {
+            output.push_back({ (ASSETS_PATH + std::string("/minecraft/textures/") + texture_names[i] + ".png") , texture_names[i] });
+        }
+
+        return output;
+    }
+
+    void AssetsManager::ListTextureNames()
     {
         std::set<std::string> unique_names;
 
@@ -116,18 +275,16 @@ namespace Botcraft
 #endif
         }
 
-        std::vector<std::pair<std::string, std::string> > output;
-        output.reserve(unique_names.size());
+        texture_names.clear();
+        texture_names.reserve(unique_names.size());
         for (auto it = unique_names.begin(); it != unique_names.end(); ++it)
         {
             if ((*it).empty())
             {
                 continue;
             }
-            output.push_back({ (ASSETS_PATH + std::string("/minecraft/textures/") + *it + ".png") , *it});
+            texture_names.push_back(*it);
         }
-
-        return output;
     }
 #endif
 
@@ -678,6 +835,311 @@ namespace Botcraft
         }
     }
 
+    const bool AssetsManager::LoadCacheFile(const std::string& path, const unsigned long long int source_signature)
+    {
+        std::unique_ptr<AssetsCache::Reader> reader = std::make_unique<AssetsCache::Reader>(path, source_signature);
+        if (!reader->IsValid())
+        {
+            return false;
+        }
+
+        std::vector<Model> models;
+        std::vector<std::shared_ptr<Blockstate> > cache_blockstates;
+        std::vector<unsigned char> key_metadata;
+        std::vector<std::pair<int, std::shared_ptr<Biome> > > cache_biomes;
+        std::vector<std::shared_ptr<Item> > cache_items;
+        try
+        {
+            models = reader->CreateModels();
+            cache_blockstates = reader->CreateBlockstates(models, key_metadata);
+            cache_biomes = reader->CreateBiomes();
+            cache_items = reader->CreateItems();
+        }
+        catch (const std::runtime_error& e)
+        {
+            std::cerr << "Error reading assets cache file " << path << ": " << e.what() << std::endl;
+            return false;
+        }
+
+        // Everything is valid, replace any previously loaded assets
+        blockstates.clear();
+        for (size_t i = 0; i < cache_blockstates.size(); ++i)
+        {
+#if PROTOCOL_VERSION < 347
+            blockstates[cache_blockstates[i]->GetId()][key_metadata[i]] = cache_blockstates[i];
+#else
+            blockstates[cache_blockstates[i]->GetId()] = cache_blockstates[i];
+#endif
+        }
+
+        biomes.clear();
+        for (size_t i = 0; i < cache_biomes.size(); ++i)
+        {
+            biomes[cache_biomes[i].first] = cache_biomes[i].second;
+        }
+
+        items.clear();
+        for (size_t i = 0; i < cache_items.size(); ++i)
+        {
+#if PROTOCOL_VERSION < 347
+            items[cache_items[i]->GetId()][cache_items[i]->GetDamageId()] = cache_items[i];
+#else
+            items[cache_items[i]->GetId()] = cache_items[i];
+#endif
+        }
+
+#ifdef USE_GUI
+        texture_names.clear();
+        for (size_t i = 0; i < reader->GetNumTextures(); ++i)
+        {
+            texture_names.push_back(reader->GetTextureName(i));
+        }
+#endif
+
+        // Moving the vector keeps its buffer, so
+        // the blockstates models stay valid
+        cache_models = std::move(models);
+        assets_cache = std::move(reader);
+
+        return true;
+    }
+
+    void AssetsManager::WriteCacheFile(const std::string& path, const unsigned long long int source_signature) const
+    {
+        AssetsCache::Writer writer(source_signature);
+
+        for (auto it = blockstates.begin(); it != blockstates.end(); ++it)
+        {
+#if PROTOCOL_VERSION < 347
+            for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+            {
+                writer.AddBlockstate(*it2->second, it2->first);
+            }
+#else
+            writer.AddBlockstate(*it->second);
+#endif
+        }
+
+        for (auto it = biomes.begin(); it != biomes.end(); ++it)
+        {
+            writer.AddBiome(it->first, *it->second);
+        }
+
+        for (auto it = items.begin(); it != items.end(); ++it)
+        {
+#if PROTOCOL_VERSION < 347
+            for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+            {
+                writer.AddItem(*it2->second);
+            }
+#else
+            writer.AddItem(*it->second);
+#endif
+        }
+
+#ifdef USE_GUI
+        for (int i = 0; i < texture_names.size(); ++i)
+        {
+            writer.AddTexture(texture_names[i]);
+        }
+#endif
+
+        if (!writer.Save(path))
+        {
+            std::cerr << "Error writing assets cache file " << path << std::endl;
+        }
+    }
+
+    void AssetsManager::FlattenRegistries()
+    {
+        // Default values are not present if
+        // something went wrong while loading the files
+        if (blockstates.find(-1) == blockstates.end() ||
+            items.find(-1) == items.end())
+        {
+            std::cerr << "Error, can't flatten assets registries without default values" << std::endl;
+            return;
+        }
+
+        // Blockstates
+        blockstates_name_to_id.clear();
+#if PROTOCOL_VERSION < 347
+        const Blockstate* default_blockstate = blockstates.at(-1).at(0).get();
+        flattened_blockstates = std::vector<const Blockstate*>(Blockstate::IdMetadataToId(blockstates.rbegin()->first + 1, 0), default_blockstate);
+        for (auto it = blockstates.begin(); it != blockstates.end(); ++it)
+        {
+            if (it->first < 0)
+            {
+                continue;
+            }
+            // Unknown metadata fall back to metadata 0
+            const auto default_it = it->second.find(0);
+            for (unsigned char m = 0; m < 16; ++m)
+            {
+                const auto it2 = it->second.find(m);
+                if (it2 != it->second.end())
+                {
+                    flattened_blockstates[Blockstate::IdMetadataToId(it->first, m)] = it2->second.get();
+                    // Maps are sorted, so the first blockstate with a name has the lowest id
+                    blockstates_name_to_id.insert({ it2->second->GetName(), { it->first, m } });
+                }
+                else if (default_it != it->second.end())
+                {
+                    flattened_blockstates[Blockstate::IdMetadataToId(it->first, m)] = default_it->second.get();
+                }
+            }
+        }
+#else
+        const Blockstate* default_blockstate = blockstates.at(-1).get();
+        flattened_blockstates = std::vector<const Blockstate*>(blockstates.rbegin()->first + 1, default_blockstate);
+        for (auto it = blockstates.begin(); it != blockstates.end(); ++it)
+        {
+            if (it->first < 0)
+            {
+                continue;
+            }
+            flattened_blockstates[it->first] = it->second.get();
+            // Map is sorted, so the first blockstate with a name has the lowest id
+            blockstates_name_to_id.insert({ it->second->GetName(), it->first });
+        }
+#endif
+
+        // Biomes
+        flattened_biomes = std::vector<const Biome*>(biomes.empty() ? 0 : biomes.rbegin()->first + 1, nullptr);
+        for (auto it = biomes.begin(); it != biomes.end(); ++it)
+        {
+            flattened_biomes[it->first] = it->second.get();
+        }
+
+        // Items
+        items_name_to_id.clear();
+#if PROTOCOL_VERSION < 347
+        const Item* default_item = items.at(-1).at(0).get();
+        flattened_items_offsets = std::vector<unsigned int>(items.rbegin()->first + 2, 0);
+        for (auto it = items.begin(); it != items.end(); ++it)
+        {
+            if (it->first < 0 || it->second.empty())
+            {
+                continue;
+            }
+            // Damage values are sorted, the last one gives the range size
+            flattened_items_offsets[it->first + 1] = it->second.rbegin()->first + 1;
+        }
+        for (size_t i = 1; i < flattened_items_offsets.size(); ++i)
+        {
+            flattened_items_offsets[i] += flattened_items_offsets[i - 1];
+        }
+        flattened_items = std::vector<const Item*>(flattened_items_offsets.back(), default_item);
+        for (auto it = items.begin(); it != items.end(); ++it)
+        {
+            if (it->first < 0)
+            {
+                continue;
+            }
+            for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+            {
+                flattened_items[flattened_items_offsets[it->first] + it2->first] = it2->second.get();
+                items_name_to_id[it2->second->GetName()] = { it->first, it2->first };
+            }
+        }
+#else
+        const Item* default_item = items.at(-1).get();
+        flattened_items = std::vector<const Item*>(items.rbegin()->first + 1, default_item);
+        for (auto it = items.begin(); it != items.end(); ++it)
+        {
+            if (it->first < 0)
+            {
+                continue;
+            }
+            flattened_items[it->first] = it->second.get();
+            items_name_to_id[it->second->GetName()] = it->first;
+        }
+#endif
+    }
+
+    void AssetsManager::BuildCollisionShapes()
+    {
+        if (flattened_blockstates.empty())
+        {
+            return;
+        }
+
+        auto same_colliders = [](const AABBView a, const AABBView b)
+        {
+            if (a.size() != b.size())
+            {
+                return false;
+            }
+            for (size_t i = 0; i < a.size(); ++i)
+            {
+                if (a[i].GetCenter() != b[i].GetCenter() || a[i].GetHalfSize() != b[i].GetHalfSize())
+                {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        // Several ids can point to the same blockstate,
+        // compute the shapes only once for each of them
+        std::unordered_map<const Blockstate*, std::pair<unsigned int, unsigned char> > computed;
+        auto get_collision = [&](const Blockstate* blockstate)
+        {
+            auto it = computed.find(blockstate);
+            if (it != computed.end())
+            {
+                return it->second;
+            }
+
+            // If all the variants share the same colliders, only one shape is needed
+            bool variant_dependent = false;
+            for (int i = 1; i < blockstate->GetNumModels(); ++i)
+            {
+                if (!same_colliders(blockstate->GetModel(0).GetCollidersView(), blockstate->GetModel(i).GetCollidersView()))
+                {
+                    variant_dependent = true;
+                    break;
+                }
+            }
+
+            const std::pair<unsigned int, unsigned char> collision(static_cast<unsigned int>(collision_shapes.size()), variant_dependent ? blockstate->GetNumModels() : 1);
+            for (int i = 0; i < collision.second; ++i)
+            {
+                CollisionShape shape;
+                shape.boxes = blockstate->GetNumModels() > 0 ? blockstate->GetModel(i).GetCollidersView() : AABBView();
+                if (shape.boxes.empty())
+                {
+                    shape.type = CollisionShapeType::Empty;
+                }
+                else if (shape.boxes.size() == 1 &&
+                    shape.boxes[0].GetCenter() == Vector3<double>(0.5, 0.5, 0.5) &&
+                    shape.boxes[0].GetHalfSize() == Vector3<double>(0.5, 0.5, 0.5))
+                {
+                    shape.type = CollisionShapeType::FullCube;
+                }
+                else
+                {
+                    shape.type = CollisionShapeType::Boxes;
+                }
+                collision_shapes.push_back(shape);
+            }
+
+            computed[blockstate] = collision;
+            return collision;
+        };
+
+#if PROTOCOL_VERSION < 347
+        default_collision = get_collision(blockstates.at(-1).at(0).get());
+#else
+        default_collision = get_collision(blockstates.at(-1).get());
+#endif
+        flattened_collisions = std::vector<std::pair<unsigned int, unsigned char> >(flattened_blockstates.size());
+        for (size_t i = 0; i < flattened_blockstates.size(); ++i)
+        {
+            flattened_collisions[i] = get_collision(flattened_blockstates[i]);
+        }
+    }
+
     void AssetsManager::ClearCaches()
     {
         Blockstate::ClearCache();
@@ -19,7 +19,7 @@ namespace Botcraft
         return local_player;
     }
 
-    const std::unordered_map<int, std::shared_ptr<Entity>>& EntityManager::GetEntities() const
+    const EntityStore& EntityManager::GetEntities() const
     {
         return entities;
     }
@@ -36,6 +36,11 @@ namespace Botcraft
         return entity_manager_mutex;
     }
 
+    Signal& EntityManager::GetLocalPlayerSignal()
+    {
+        return local_player_signal;
+    }
+
     void EntityManager::Handle(ProtocolCraft::ClientboundLoginPacket& msg)
     {
         std::lock_guard<std::mutex> entity_manager_locker(entity_manager_mutex);
@@ -43,19 +48,20 @@ namespace Botcraft
         local_player->GetMutex().lock();
         local_player->SetEID(msg.GetPlayerId());
         local_player->GetMutex().unlock();
-        entities[msg.GetPlayerId()] = local_player;
+        // The local player is moved by the physics thread,
+        // it can't be kept in the spatial index
+        entities.Add(local_player, false);
     }
     
 #if PROTOCOL_VERSION < 755
     void EntityManager::Handle(ProtocolCraft::ClientboundMoveEntityPacket& msg)
     {
         std::lock_guard<std::mutex> entity_manager_locker(entity_manager_mutex);
-        auto it = entities.find(msg.GetEntityId());
-        if (it == entities.end())
+        if (entities.GetSlot(msg.GetEntityId()) == -1)
         {
             std::shared_ptr<Entity> entity = std::shared_ptr<Entity>(new Entity);
             entity->SetEID(msg.GetEntityId());
-            entities[msg.GetEntityId()] = entity;
+            entities.Add(entity);
         }
     }
 #endif
@@ -63,112 +69,72 @@ namespace Botcraft
     void EntityManager::Handle(ProtocolCraft::ClientboundMoveEntityPacketPos& msg)
     {
         std::lock_guard<std::mutex> entity_manager_locker(entity_manager_mutex);
-        // Player position is also used by physics thread, so we need
-        // to lock it
+        // The local player is only moved by the physics thread,
+        // so it's the only writer of its published state
         if (msg.GetEntityId() == local_player->GetEID())
         {
-            local_player->GetMutex().lock();
-        }
-        
-        auto it = entities.find(msg.GetEntityId());
-        if (it != entities.end())
-        {
-            it->second->SetX((msg.GetXA() / 128.0f + it->second->GetPosition().x * 32.0f) / 32.0f);
-            it->second->SetY((msg.GetYA() / 128.0f + it->second->GetPosition().y * 32.0f) / 32.0f);
-            it->second->SetZ((msg.GetZA() / 128.0f + it->second->GetPosition().z * 32.0f) / 32.0f);
-            it->second->SetOnGround(msg.GetOnGround());
+            local_player->PushMovementCommand(MovementCommand{ MovementCommandType::Teleport,
+                Vector3<double>(msg.GetXA(), msg.GetYA(), msg.GetZA()) / 4096.0, false, 0x07 });
+            return;
         }
-        
-        if (msg.GetEntityId() == local_player->GetEID())
+
+        const int slot = entities.GetSlot(msg.GetEntityId());
+        if (slot != -1)
         {
-#ifdef USE_GUI
-            if (rendering_manager)
-            {
-                rendering_manager->SetPosOrientation(local_player->GetPosition().x, local_player->GetPosition().y + 1.62f, local_player->GetPosition().z, local_player->GetYaw(), local_player->GetPitch());
-            }
-#endif // USE_GUI
-            local_player->GetMutex().unlock();
+            entities.SetPosition(slot, entities.GetPosition(slot) + Vector3<double>(msg.GetXA(), msg.GetYA(), msg.GetZA()) / 4096.0);
+            entities.SetOnGround(slot, msg.GetOnGround());
         }
     }
 
     void EntityManager::Handle(ProtocolCraft::ClientboundMoveEntityPacketPosRot& msg)
     {
         std::lock_guard<std::mutex> entity_manager_locker(entity_manager_mutex);
-        // Player position is also used by physics thread, so we need
-        // to lock it
         if (msg.GetEntityId() == local_player->GetEID())
         {
-            local_player->GetMutex().lock();
-        }
-
-        auto it = entities.find(msg.GetEntityId());
-        if (it != entities.end())
-        {
-            it->second->SetX((msg.GetXA() / 128.0f + it->second->GetPosition().x * 32.0f) / 32.0f);
-            it->second->SetY((msg.GetYA() / 128.0f + it->second->GetPosition().y * 32.0f) / 32.0f);
-            it->second->SetZ((msg.GetZA() / 128.0f + it->second->GetPosition().z * 32.0f) / 32.0f);
-            it->second->SetYaw(360.0f * msg.GetYRot() / 256.0f);
-            it->second->SetPitch(360.0f * msg.GetXRot() / 256.0f);
-            it->second->SetOnGround(msg.GetOnGround());
+            local_player->PushMovementCommand(MovementCommand{ MovementCommandType::Teleport,
+                Vector3<double>(msg.GetXA(), msg.GetYA(), msg.GetZA()) / 4096.0, false, 0x07 });
+            local_player->PushMovementCommand(MovementCommand{ MovementCommandType::Rotate,
+                Vector3<double>(360.0 * msg.GetYRot() / 256.0, 360.0 * msg.GetXRot() / 256.0, 0.0), false, 0 });
+            return;
         }
 
-        if (msg.GetEntityId() == local_player->GetEID())
+        const int slot = entities.GetSlot(msg.GetEntityId());
+        if (slot != -1)
         {
-#ifdef USE_GUI
-            if (rendering_manager)
-            {
-                rendering_manager->SetPosOrientation(local_player->GetPosition().x, local_player->GetPosition().y + 1.62f, local_player->GetPosition().z, local_player->GetYaw(), local_player->GetPitch());
-            }
-#endif // USE_GUI
-            local_player->GetMutex().unlock();
+            entities.SetPosition(slot, entities.GetPosition(slot) + Vector3<double>(msg.GetXA(), msg.GetYA(), msg.GetZA()) / 4096.0);
+            entities.SetRotation(slot, 360.0f * msg.GetYRot() / 256.0f, 360.0f * msg.GetXRot() / 256.0f);
+            entities.SetOnGround(slot, msg.GetOnGround());
         }
     }
 
     void EntityManager::Handle(ProtocolCraft::ClientboundMoveEntityPacketRot& msg)
     {
         std::lock_guard<std::mutex> entity_manager_locker(entity_manager_mutex);
-        // Player position is also used by physics thread, so we need
-        // to lock it
         if (msg.GetEntityId() == local_player->GetEID())
         {
-            local_player->GetMutex().lock();
+            local_player->PushMovementCommand(MovementCommand{ MovementCommandType::Rotate,
+                Vector3<double>(360.0 * msg.GetYRot() / 256.0, 360.0 * msg.GetXRot() / 256.0, 0.0), false, 0 });
+            return;
         }
 
-        auto it = entities.find(msg.GetEntityId());
-        if (it != entities.end())
+        const int slot = entities.GetSlot(msg.GetEntityId());
+        if (slot != -1)
         {
-            it->second->SetYaw(360.0f * msg.GetYRot() / 256.0f);
-            it->second->SetPitch(360.0f * msg.GetXRot() / 256.0f);
-            it->second->SetOnGround(msg.GetOnGround());
-        }
-
-        if (msg.GetEntityId() == local_player->GetEID())
-        {
-#ifdef USE_GUI
-            if (rendering_manager)
-            {
-                rendering_manager->SetPosOrientation(local_player->GetPosition().x, local_player->GetPosition().y + 1.62f, local_player->GetPosition().z, local_player->GetYaw(), local_player->GetPitch());
-            }
-#endif // USE_GUI
-            local_player->GetMutex().unlock();
+            entities.SetRotation(slot, 360.0f * msg.GetYRot() / 256.0f, 360.0f * msg.GetXRot() / 256.0f);
+            entities.SetOnGround(slot, msg.GetOnGround());
         }
     }
 
     void EntityManager::Handle(ProtocolCraft::ClientboundPlayerPositionPacket& msg)
     {
-        std::lock_guard<std::mutex> player_guard(local_player->GetMutex());
-        (msg.GetRelativeArguments() & 0x01) ? local_player->SetX(local_player->GetPosition().x + msg.GetX()) : local_player->SetX(msg.GetX());
-        (msg.GetRelativeArguments() & 0x02) ? local_player->SetY(local_player->GetPosition().y + msg.GetY()) : local_player->SetY(msg.GetY());
-        (msg.GetRelativeArguments() & 0x04) ? local_player->SetZ(local_player->GetPosition().z + msg.GetZ()) : local_player->SetZ(msg.GetZ());
-        (msg.GetRelativeArguments() & 0x08) ? local_player->SetYaw(local_player->GetYaw() + msg.GetYRot()) : local_player->SetYaw(msg.GetYRot());
-        (msg.GetRelativeArguments() & 0x10) ? local_player->SetPitch(local_player->GetPitch() + msg.GetXRot()) : local_player->SetPitch(msg.GetXRot());
-
-#ifdef USE_GUI
-        if (rendering_manager)
-        {
-            rendering_manager->SetPosOrientation(local_player->GetPosition().x, local_player->GetPosition().y + 1.62f, local_player->GetPosition().z, local_player->GetYaw(), local_player->GetPitch());
-        }
-#endif // USE_GUI
+        // The physics thread is the only writer of the local player
+        // position, server corrections are applied at its next tick
+        local_player->PushMovementCommand(MovementCommand{ MovementCommandType::Teleport,
+            Vector3<double>(msg.GetX(), msg.GetY(), msg.GetZ()), false,
+            static_cast<unsigned char>(msg.GetRelativeArguments() & 0x07) });
+        local_player->PushMovementCommand(MovementCommand{ MovementCommandType::Rotate,
+            Vector3<double>(msg.GetYRot(), msg.GetXRot(), 0.0), false,
+            static_cast<unsigned char>((msg.GetRelativeArguments() >> 3) & 0x03) });
     }
 
     void EntityManager::Handle(ProtocolCraft::ClientboundAddEntityPacket& msg)
@@ -193,7 +159,7 @@ namespace Botcraft
         entity->SetYaw(360.0f * msg.GetYRot() / 256.0f);
         entity->SetPitch(360.0f * msg.GetXRot() / 256.0f);
 
-        entities[msg.GetId_()] = entity;
+        entities.Add(entity);
     }
 
     void EntityManager::Handle(ProtocolCraft::ClientboundAddMobPacket& msg)
@@ -218,32 +184,30 @@ namespace Botcraft
         entity->SetYaw(360.0f * msg.GetYRot() / 256.0f);
         entity->SetPitch(360.0f * msg.GetXRot() / 256.0f);
 
-        entities[msg.GetId_()] = entity;
+        entities.Add(entity);
     }
 
     void EntityManager::Handle(ProtocolCraft::ClientboundAddPlayerPacket& msg)
     {
         std::lock_guard<std::mutex> entity_manager_locker(entity_manager_mutex);
 
-        std::shared_ptr<Entity> entity;
-
-        auto it = entities.find(msg.GetEntityId());
-        if (it == entities.end())
+        const int slot = entities.GetSlot(msg.GetEntityId());
+        if (slot != -1)
         {
-            entity = std::shared_ptr<Player>(new Player);
-            entities[msg.GetEntityId()] = entity;
-        }
-        else
-        {
-            entity = it->second;
+            entities.SetPosition(slot, Vector3<double>(msg.GetX(), msg.GetY(), msg.GetZ()));
+            entities.SetRotation(slot, 360.0f * msg.GetYRot() / 256.0f, 360.0f * msg.GetXRot() / 256.0f);
+            return;
         }
 
+        std::shared_ptr<Entity> entity = std::shared_ptr<Player>(new Player);
         entity->SetEID(msg.GetEntityId());
         entity->SetX(msg.GetX());
         entity->SetY(msg.GetY());
         entity->SetZ(msg.GetZ());
         entity->SetYaw(360.0f * msg.GetYRot() / 256.0f);
         entity->SetPitch(360.0f * msg.GetXRot() / 256.0f);
+
+        entities.Add(entity);
     }
 
     void EntityManager::Handle(ProtocolCraft::ClientboundSetHealthPacket& msg)
@@ -259,29 +223,19 @@ namespace Botcraft
         std::lock_guard<std::mutex> entity_manager_locker(entity_manager_mutex);
         if (msg.GetId_() == local_player->GetEID())
         {
-            local_player->GetMutex().lock();
+            local_player->PushMovementCommand(MovementCommand{ MovementCommandType::Teleport,
+                Vector3<double>(msg.GetX(), msg.GetY(), msg.GetZ()), false, 0 });
+            local_player->PushMovementCommand(MovementCommand{ MovementCommandType::Rotate,
+                Vector3<double>(360.0 * msg.GetYRot() / 256.0, 360.0 * msg.GetXRot() / 256.0, 0.0), false, 0 });
+            return;
         }
 
-        auto it = entities.find(msg.GetId_());
-        if (it != entities.end())
-        {
-            it->second->SetX(msg.GetX());
-            it->second->SetY(msg.GetY());
-            it->second->SetZ(msg.GetZ());
-            it->second->SetYaw(360.0f * msg.GetYRot() / 256.0f);
-            it->second->SetPitch(360.0f * msg.GetXRot() / 256.0f);
-            it->second->SetOnGround(msg.GetOnGround());
-        }
-
-        if (msg.GetId_() == local_player->GetEID())
+        const int slot = entities.GetSlot(msg.GetId_());
+        if (slot != -1)
         {
-#ifdef USE_GUI
-            if (rendering_manager)
-            {
-                rendering_manager->SetPosOrientation(local_player->GetPosition().x, local_player->GetPosition().y + 1.62f, local_player->GetPosition().z, local_player->GetYaw(), local_player->GetPitch());
-            }
-#endif // USE_GUI
-            local_player->GetMutex().unlock();
+            entities.SetPosition(slot, Vector3<double>(msg.GetX(), msg.GetY(), msg.GetZ()));
+            entities.SetRotation(slot, 360.0f * msg.GetYRot() / 256.0f, 360.0f * msg.GetXRot() / 256.0f);
+            entities.SetOnGround(slot, msg.GetOnGround());
         }
     }
     
@@ -299,7 +253,7 @@ namespace Botcraft
     void EntityManager::Handle(ProtocolCraft::ClientboundRemoveEntityPacket& msg)
     {
         std::lock_guard<std::mutex> entity_manager_locker(entity_manager_mutex);
-        entities.erase(msg.GetEntityId());
+        entities.Remove(msg.GetEntityId());
     }
 #else
     void EntityManager::Handle(ProtocolCraft::ClientboundRemoveEntitiesPacket& msg)
@@ -307,7 +261,7 @@ namespace Botcraft
         std::lock_guard<std::mutex> entity_manager_locker(entity_manager_mutex);
         for (int i = 0; i < msg.GetEntityIds().size(); ++i)
         {
-            entities.erase(msg.GetEntityIds()[i]);
+            entities.Remove(msg.GetEntityIds()[i]);
         }
     }
 #endif
@@ -0,0 +1,319 @@
+#include <algorithm>
+#include <cmath>
+
+#include "botcraft/Game/Entities/EntityStore.hpp"
+#include "botcraft/Game/Entities/Entity.hpp"
+
+namespace Botcraft
+{
+    // Size of the grid cells, in blocks
+    static const int ENTITY_CELL_SIZE = 16;
+
+    EntityStore::EntityStore()
+    {
+        max_extent = Vector3<double>(0.0, 0.0, 0.0);
+    }
+
+    void EntityStore::Add(const std::shared_ptr<Entity>& entity, const bool indexed_)
+    {
+        Remove(entity->GetEID());
+
+        const int slot = static_cast<int>(entities.size());
+        const Vector3<double>& position = entity->GetPosition();
+        const AABB collider = entity->GetCollider();
+
+        slots_by_id[entity->GetEID()] = slot;
+        entities.push_back(entity);
+        ids.push_back(entity->GetEID());
+        x.push_back(position.x);
+        y.push_back(position.y);
+        z.push_back(position.z);
+        collider_offsets.push_back(collider.GetCenter() - position);
+        collider_half_sizes.push_back(collider.GetHalfSize());
+        indexed.push_back(indexed_);
+        cells_of_slots.push_back(GetCell(position));
+
+        if (indexed_)
+        {
+            const Vector3<double>& offset = collider_offsets[slot];
+            const Vector3<double>& half_size = collider_half_sizes[slot];
+            max_extent.x = std::max(max_extent.x, std::abs(offset.x) + half_size.x);
+            max_extent.y = std::max(max_extent.y, std::abs(offset.y) + half_size.y);
+            max_extent.z = std::max(max_extent.z, std::abs(offset.z) + half_size.z);
+            AddToCell(slot);
+        }
+        else
+        {
+            not_indexed_slots.push_back(slot);
+        }
+    }
+
+    void EntityStore::Remove(const int id)
+    {
+        auto it = slots_by_id.find(id);
+        if (it == slots_by_id.end())
+        {
+            return;
+        }
+        const int slot = it->second;
+        slots_by_id.erase(it);
+
+        if (indexed[slot])
+        {
+            RemoveFromCell(slot);
+        }
+        else
+        {
+            not_indexed_slots.erase(std::find(not_indexed_slots.begin(), not_indexed_slots.end(), slot));
+        }
+
+        // Move the last entity in the freed slot to keep the arrays dense
+        const int last = static_cast<int>(entities.size()) - 1;
+        if (slot != last)
+        {
+            if (indexed[last])
+            {
+                ReplaceInCell(last, slot);
+            }
+            else
+            {
+                *std::find(not_indexed_slots.begin(), not_indexed_slots.end(), last) = slot;
+            }
+            slots_by_id[ids[last]] = slot;
+
+            entities[slot] = entities[last];
+            ids[slot] = ids[last];
+            x[slot] = x[last];
+            y[slot] = y[last];
+            z[slot] = z[last];
+            collider_offsets[slot] = collider_offsets[last];
+            collider_half_sizes[slot] = collider_half_sizes[last];
+            indexed[slot] = indexed[last];
+            cells_of_slots[slot] = cells_of_slots[last];
+        }
+
+        entities.pop_back();
+        ids.pop_back();
+        x.pop_back();
+        y.pop_back();
+        z.pop_back();
+        collider_offsets.pop_back();
+        collider_half_sizes.pop_back();
+        indexed.pop_back();
+        cells_of_slots.pop_back();
+    }
+
+    void EntityStore::Clear()
+    {
+        slots_by_id.clear();
+        entities.clear();
+        ids.clear();
+        x.clear();
+        y.clear();
+        z.clear();
+        collider_offsets.clear();
+        collider_half_sizes.clear();
+        indexed.clear();
+        cells_of_slots.clear();
+        cells.clear();
+        not_indexed_slots.clear();
+        max_extent = Vector3<double>(0.0, 0.0, 0.0);
+    }
+
+    const size_t EntityStore::Size() const
+    {
+        return entities.size();
+    }
+
+    std::shared_ptr<Entity> EntityStore::Get(const int id) const
+    {
+        auto it = slots_by_id.find(id);
+        if (it == slots_by_id.end())
+        {
+            return nullptr;
+        }
+        return entities[it->second];
+    }
+
+    const std::vector<std::shared_ptr<Entity> >& EntityStore::GetAll() const
+    {
+        return entities;
+    }
+
+    const int EntityStore::GetSlot(const int id) const
+    {
+        auto it = slots_by_id.find(id);
+        return it == slots_by_id.end() ? -1 : it->second;
+    }
+
+    const Vector3<double> EntityStore::GetPosition(const int slot) const
+    {
+        if (!indexed[slot])
+        {
+            return entities[slot]->GetPosition();
+        }
+        return Vector3<double>(x[slot], y[slot], z[slot]);
+    }
+
+    void EntityStore::SetPosition(const int slot, const Vector3<double>& position)
+    {
+        x[slot] = position.x;
+        y[slot] = position.y;
+        z[slot] = position.z;
+        entities[slot]->SetPosition(position);
+
+        if (!indexed[slot])
+        {
+            return;
+        }
+
+        const Position cell = GetCell(position);
+        if (cell != cells_of_slots[slot])
+        {
+            RemoveFromCell(slot);
+            cells_of_slots[slot] = cell;
+            AddToCell(slot);
+        }
+    }
+
+    void EntityStore::SetRotation(const int slot, const float yaw, const float pitch)
+    {
+        entities[slot]->SetYaw(yaw);
+        entities[slot]->SetPitch(pitch);
+    }
+
+    void EntityStore::SetOnGround(const int slot, const bool on_ground)
+    {
+        entities[slot]->SetOnGround(on_ground);
+    }
+
+    void EntityStore::QueryRadius(const Vector3<double>& center, const double radius, std::vector<std::shared_ptr<Entity> >& output) const
+    {
+        const double sqr_radius = radius * radius;
+        const Vector3<double> extent(radius, radius, radius);
+        VisitCells(center - extent, center + extent, [&](const int slot)
+            {
+                const double dx = x[slot] - center.x;
+                const double dy = y[slot] - center.y;
+                const double dz = z[slot] - center.z;
+                if (dx * dx + dy * dy + dz * dz <= sqr_radius)
+                {
+                    output.push_back(entities[slot]);
+                }
+            });
+
+        for (size_t i = 0; i < not_indexed_slots.size(); ++i)
+        {
+            const std::shared_ptr<Entity>& entity = entities[not_indexed_slots[i]];
+            const Vector3<double> diff = entity->GetPosition() - center;
+            if (diff.dot(diff) <= sqr_radius)
+            {
+                output.push_back(entity);
+            }
+        }
+    }
+
+    void EntityStore::QueryAABB(const AABB& box, std::vector<std::shared_ptr<Entity> >& output) const
+    {
+        const Vector3<double>& center = box.GetCenter();
+        const Vector3<double>& half_size = box.GetHalfSize();
+        // Colliders extend up to max_extent away from the positions stored in the grid
+        VisitCells(box.GetMin() - max_extent, box.GetMax() + max_extent, [&](const int slot)
+            {
+                const Vector3<double>& offset = collider_offsets[slot];
+                const Vector3<double>& collider_half_size = collider_half_sizes[slot];
+                if (std::abs(x[slot] + offset.x - center.x) <= half_size.x + collider_half_size.x &&
+                    std::abs(y[slot] + offset.y - center.y) <= half_size.y + collider_half_size.y &&
+                    std::abs(z[slot] + offset.z - center.z) <= half_size.z + collider_half_size.z)
+                {
+                    output.push_back(entities[slot]);
+                }
+            });
+
+        for (size_t i = 0; i < not_indexed_slots.size(); ++i)
+        {
+            const std::shared_ptr<Entity>& entity = entities[not_indexed_slots[i]];
+            if (box.Collide(entity->GetCollider()))
+            {
+                output.push_back(entity);
+            }
+        }
+    }
+
+    const Position EntityStore::GetCell(const Vector3<double>& position) const
+    {
+        return Position(static_cast<int>(std::floor(position.x / ENTITY_CELL_SIZE)),
+            static_cast<int>(std::floor(position.y / ENTITY_CELL_SIZE)),
+            static_cast<int>(std::floor(position.z / ENTITY_CELL_SIZE)));
+    }
+
+    void EntityStore::AddToCell(const int slot)
+    {
+        cells[cells_of_slots[slot]].push_back(slot);
+    }
+
+    void EntityStore::RemoveFromCell(const int slot)
+    {
+        auto it = cells.find(cells_of_slots[slot]);
+        std::vector<int>& cell = it->second;
+        *std::find(cell.begin(), cell.end(), slot) = cell.back();
+        cell.pop_back();
+        if (cell.empty())
+        {
+            cells.erase(it);
+        }
+    }
+
+    void EntityStore::ReplaceInCell(const int slot, const int new_slot)
+    {
+        std::vector<int>& cell = cells[cells_of_slots[slot]];
+        *std::find(cell.begin(), cell.end(), slot) = new_slot;
+    }
+
+    template<class Function>
+    void EntityStore::VisitCells(const Vector3<double>& min, const Vector3<double>& max, Function f) const
+    {
+        const Position min_cell = GetCell(min);
+        const Position max_cell = GetCell(max);
+
+        // Large boxes are faster to check by iterating over the non empty cells
+        const long long int num_cells = static_cast<long long int>(max_cell.x - min_cell.x + 1) *
+            (max_cell.y - min_cell.y + 1) * (max_cell.z - min_cell.z + 1);
+        if (num_cells > static_cast<long long int>(cells.size()))
+        {
+            for (auto it = cells.begin(); it != cells.end(); ++it)
+            {
+                if (it->first.x < min_cell.x || it->first.y < min_cell.y || it->first.z < min_cell.z ||
+                    it->first.x > max_cell.x || it->first.y > max_cell.y || it->first.z > max_cell.z)
+                {
+                    continue;
+                }
+                for (size_t i = 0; i < it->second.size(); ++i)
+                {
+                    f(it->second[i]);
+                }
+            }
+            return;
+        }
+
+        Position cell;
+        for (cell.x = min_cell.x; cell.x <= max_cell.x; ++cell.x)
+        {
+            for (cell.y = min_cell.y; cell.y <= max_cell.y; ++cell.y)
+            {
+                for (cell.z = min_cell.z; cell.z <= max_cell.z; ++cell.z)
+                {
+                    auto it = cells.find(cell);
+                    if (it == cells.end())
+                    {
+                        continue;
+                    }
+                    for (size_t i = 0; i < it->second.size(); ++i)
+                    {
+                        f(it->second[i]);
+                    }
+                }
+            }
+        }
+    }
+} // Botcraft
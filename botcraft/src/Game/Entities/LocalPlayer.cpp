@@ -22,6 +22,8 @@ namespace Botcraft
         food_saturation = 5.0f;
 
         has_moved = true;
+
+        PublishState();
     }
 
     std::mutex& LocalPlayer::GetMutex()
@@ -29,6 +31,70 @@ namespace Botcraft
         return player_mutex;
     }
 
+    const LocalPlayerState LocalPlayer::GetState() const
+    {
+        return state.Load();
+    }
+
+    void LocalPlayer::PublishState()
+    {
+        state.Store(LocalPlayerState{ position, speed, yaw, pitch, on_ground });
+    }
+
+    void LocalPlayer::PushMovementCommand(const MovementCommand& command)
+    {
+        std::lock_guard<std::mutex> commands_guard(commands_mutex);
+        commands.push_back(command);
+    }
+
+    const bool LocalPlayer::ApplyMovementCommands()
+    {
+        {
+            std::lock_guard<std::mutex> commands_guard(commands_mutex);
+            applied_commands.swap(commands);
+        }
+
+        for (size_t i = 0; i < applied_commands.size(); ++i)
+        {
+            const MovementCommand& command = applied_commands[i];
+            switch (command.type)
+            {
+            case MovementCommandType::AddSpeed:
+                SetSpeed(speed + command.value);
+                break;
+            case MovementCommandType::ReachXZ:
+                SetSpeedX(command.value.x - position.x);
+                SetSpeedZ(command.value.z - position.z);
+                break;
+            case MovementCommandType::Jump:
+                SetSpeedY(command.value.y);
+                break;
+            case MovementCommandType::Translate:
+                SetPosition(position + command.value);
+                break;
+            case MovementCommandType::LookAt:
+                LookAt(command.value, command.set_pitch);
+                break;
+            case MovementCommandType::LeaveGround:
+                SetOnGround(false);
+                break;
+            case MovementCommandType::Teleport:
+                SetPosition(Vector3<double>(
+                    (command.relative & 0x01) ? position.x + command.value.x : command.value.x,
+                    (command.relative & 0x02) ? position.y + command.value.y : command.value.y,
+                    (command.relative & 0x04) ? position.z + command.value.z : command.value.z));
+                break;
+            case MovementCommandType::Rotate:
+                SetYaw(static_cast<float>((command.relative & 0x01) ? yaw + command.value.x : command.value.x));
+                SetPitch(static_cast<float>((command.relative & 0x02) ? pitch + command.value.y : command.value.y));
+                break;
+            }
+        }
+        const bool applied = !applied_commands.empty();
+        applied_commands.clear();
+        return applied;
+    }
+
     const Vector3<double>& LocalPlayer::GetFrontVector() const
     {
         return frontVector;
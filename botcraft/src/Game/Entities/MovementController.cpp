@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "botcraft/Game/Entities/MovementController.hpp"
+#include "botcraft/Game/Entities/LocalPlayer.hpp"
+
+namespace Botcraft
+{
+    // Duration of a physics tick, in seconds
+    static const double TICK_DURATION = 0.05;
+    // Vertical speed to get a 1.25 block height jump
+    static const double JUMP_SPEED = 0.4196141;
+    // Extra horizontal distance of a sprint jump take off
+    static const double SPRINT_JUMP_BOOST = 0.2;
+    // Distance the target point is ahead of the player on flat parts
+    static const double LOOKAHEAD_DISTANCE = 1.0;
+    // Horizontal distance at which an intermediate node is considered reached
+    static const double NODE_REACHED_DISTANCE = 0.35;
+    // Horizontal distance at which the last node is considered reached
+    static const double ARRIVAL_DISTANCE = 0.05;
+    // Number of ticks without getting closer to the next node before giving up
+    static const int STUCK_TICKS = 30;
+    // Max horizontal distance from the current path segment
+    static const double MAX_PATH_DEVIATION = 1.5;
+
+    static const double HorizontalDistance(const Vector3<double>& a, const Vector3<double>& b)
+    {
+        return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.z - b.z) * (a.z - b.z));
+    }
+
+    // True if a player at height y is standing in the block of
+    // node_center, or jumping above it
+    static const bool IsAtNodeHeight(const double y, const Vector3<double>& node_center)
+    {
+        return y > node_center.y - 0.5 && y < node_center.y + 1.3;
+    }
+
+    MovementController::MovementController()
+    {
+        speed = 4.317;
+        sprint_jump = false;
+        path_id = 0;
+        status = MovementStatus::Idle;
+        status_changed = false;
+        next_node = 0;
+        best_distance = std::numeric_limits<double>::max();
+        ticks_without_progress = 0;
+        has_previous_position = false;
+        travelled_distance = 0.0;
+        moving_ticks = 0;
+    }
+
+    const unsigned int MovementController::SetPath(const std::vector<Position>& path_, const double speed_, const bool sprint_jump_)
+    {
+        std::lock_guard<std::mutex> controller_guard(controller_mutex);
+        path = path_;
+        speed = speed_;
+        sprint_jump = sprint_jump_;
+        path_id += 1;
+        status = path.empty() ? MovementStatus::Arrived : MovementStatus::Moving;
+        next_node = 0;
+        best_distance = std::numeric_limits<double>::max();
+        ticks_without_progress = 0;
+        has_previous_position = false;
+        travelled_distance = 0.0;
+        moving_ticks = 0;
+        return path_id;
+    }
+
+    void MovementController::Stop()
+    {
+        std::lock_guard<std::mutex> controller_guard(controller_mutex);
+        status = MovementStatus::Idle;
+    }
+
+    const MovementStatus MovementController::GetStatus(const unsigned int path_id_) const
+    {
+        std::lock_guard<std::mutex> controller_guard(controller_mutex);
+        return path_id_ == path_id ? status : MovementStatus::Idle;
+    }
+
+    const double MovementController::GetAchievedSpeed() const
+    {
+        std::lock_guard<std::mutex> controller_guard(controller_mutex);
+        return moving_ticks == 0 ? 0.0 : travelled_distance / (moving_ticks * TICK_DURATION);
+    }
+
+    const bool MovementController::Tick(LocalPlayer& player)
+    {
+        std::lock_guard<std::mutex> controller_guard(controller_mutex);
+        status_changed = false;
+        if (status != MovementStatus::Moving)
+        {
+            return false;
+        }
+
+        const Vector3<double> position = player.GetPosition();
+        const bool on_ground = player.GetOnGround();
+
+        if (has_previous_position)
+        {
+            travelled_distance += HorizontalDistance(position, previous_position);
+        }
+        has_previous_position = true;
+        previous_position = position;
+        moving_ticks += 1;
+
+        // Skip the nodes we already are in or went past
+        while (next_node + 1 < path.size())
+        {
+            const Vector3<double> center = GetNodeCenter(next_node);
+            if (!IsAtNodeHeight(position.y, center) ||
+                (HorizontalDistance(position, center) > NODE_REACHED_DISTANCE && !IsPast(next_node, position)))
+            {
+                break;
+            }
+            next_node += 1;
+            best_distance = std::numeric_limits<double>::max();
+            ticks_without_progress = 0;
+        }
+
+        const Vector3<double> next_center = GetNodeCenter(next_node);
+        const double distance = HorizontalDistance(position, next_center);
+        const bool is_last_node = next_node + 1 == path.size();
+
+        if (is_last_node && on_ground &&
+            distance < ARRIVAL_DISTANCE && std::abs(position.y - next_center.y) < 0.5)
+        {
+            SetStatus(MovementStatus::Arrived);
+            return status_changed;
+        }
+
+        // Give up early so the path can be replanned
+        if (distance < best_distance - 0.05)
+        {
+            best_distance = distance;
+            ticks_without_progress = 0;
+        }
+        else if (++ticks_without_progress > STUCK_TICKS)
+        {
+            SetStatus(MovementStatus::Stuck);
+            return status_changed;
+        }
+        if (next_node > 0)
+        {
+            double t;
+            if (SegmentDistance(GetNodeCenter(next_node - 1), next_center, position, t) > MAX_PATH_DEVIATION)
+            {
+                SetStatus(MovementStatus::Stuck);
+                return status_changed;
+            }
+        }
+
+        const Vector3<double> target = GetLookaheadTarget(position);
+        const double target_distance = HorizontalDistance(position, target);
+        double step = speed * TICK_DURATION;
+
+        bool jump = false;
+        if (on_ground)
+        {
+            if (NeedJump(next_node) && distance < 1.3)
+            {
+                jump = true;
+            }
+            else if (sprint_jump && IsFlatStraight(next_node, 4))
+            {
+                jump = true;
+                step += SPRINT_JUMP_BOOST;
+            }
+        }
+
+        // Don't overshoot the end of the path
+        if (is_last_node)
+        {
+            step = std::min(step, target_distance);
+        }
+
+        // The movement goes through the player command queue, so it is applied
+        // in order with the server corrections received since the last tick
+        if (target_distance > 1e-6)
+        {
+            player.PushMovementCommand(MovementCommand{ MovementCommandType::AddSpeed,
+                Vector3<double>((target.x - position.x) / target_distance * step, 0.0, (target.z - position.z) / target_distance * step), false, 0 });
+            player.PushMovementCommand(MovementCommand{ MovementCommandType::LookAt, target, false, 0 });
+        }
+
+        if (jump)
+        {
+            player.PushMovementCommand(MovementCommand{ MovementCommandType::Jump, Vector3<double>(0.0, JUMP_SPEED, 0.0), false, 0 });
+        }
+        else if (on_ground && target_distance > 1e-6)
+        {
+            // Slightly lift the player so it doesn't catch on the blocks it walks on
+            player.PushMovementCommand(MovementCommand{ MovementCommandType::Translate, Vector3<double>(0.0, 0.001, 0.0), false, 0 });
+            // If the target motion requires going down
+            if (next_center.y < position.y - 0.5)
+            {
+                player.PushMovementCommand(MovementCommand{ MovementCommandType::LeaveGround, Vector3<double>(), false, 0 });
+            }
+        }
+
+        return status_changed;
+    }
+
+    const double MovementController::SegmentDistance(const Vector3<double>& from, const Vector3<double>& to, const Vector3<double>& position, double& t) const
+    {
+        const double segment_x = to.x - from.x;
+        const double segment_z = to.z - from.z;
+        const double segment_sqr_length = segment_x * segment_x + segment_z * segment_z;
+        t = segment_sqr_length > 0.0 ?
+            ((position.x - from.x) * segment_x + (position.z - from.z) * segment_z) / segment_sqr_length : 0.0;
+        const double clamped_t = std::max(0.0, std::min(1.0, t));
+        return HorizontalDistance(position, Vector3<double>(from.x + clamped_t * segment_x, position.y, from.z + clamped_t * segment_z));
+    }
+
+    const bool MovementController::IsPast(const size_t index, const Vector3<double>& position) const
+    {
+        // Only on flat parts, where shortcuts are taken
+        if (index + 1 >= path.size() || path[index + 1].y != path[index].y || NeedJump(index + 1))
+        {
+            return false;
+        }
+        double t;
+        const double distance = SegmentDistance(GetNodeCenter(index), GetNodeCenter(index + 1), position, t);
+        return t > 0.0 && distance < NODE_REACHED_DISTANCE;
+    }
+
+    const Vector3<double> MovementController::GetNodeCenter(const size_t index) const
+    {
+        return Vector3<double>(path[index].x + 0.5, path[index].y, path[index].z + 0.5);
+    }
+
+    const bool MovementController::NeedJump(const size_t index) const
+    {
+        if (index == 0)
+        {
+            return previous_position.y < path[0].y - 0.5;
+        }
+        const Vector3<double> from = GetNodeCenter(index - 1);
+        const Vector3<double> to = GetNodeCenter(index);
+        return to.y > from.y || HorizontalDistance(from, to) > 1.5;
+    }
+
+    const bool MovementController::IsFlatStraight(const size_t index, const size_t num_nodes) const
+    {
+        if (index == 0 || index + num_nodes > path.size())
+        {
+            return false;
+        }
+        const Position direction = path[index] - path[index - 1];
+        if (direction.y != 0 || std::abs(direction.x) + std::abs(direction.z) != 1)
+        {
+            return false;
+        }
+        for (size_t i = index + 1; i < index + num_nodes; ++i)
+        {
+            if (path[i] - path[i - 1] != direction)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    const Vector3<double> MovementController::GetLookaheadTarget(const Vector3<double>& position) const
+    {
+        Vector3<double> target = GetNodeCenter(next_node);
+        // No shortcut while going up or down
+        if (!IsAtNodeHeight(position.y, target))
+        {
+            return target;
+        }
+
+        double remaining = LOOKAHEAD_DISTANCE - HorizontalDistance(position, target);
+        for (size_t i = next_node; remaining > 0.0 && i + 1 < path.size(); ++i)
+        {
+            if (path[i + 1].y != path[i].y || NeedJump(i + 1))
+            {
+                break;
+            }
+            const Vector3<double> from = GetNodeCenter(i);
+            const Vector3<double> to = GetNodeCenter(i + 1);
+            const double length = HorizontalDistance(from, to);
+            if (length >= remaining)
+            {
+                return from + (to - from) * (remaining / length);
+            }
+            remaining -= length;
+            target = to;
+        }
+        return target;
+    }
+
+    void MovementController::SetStatus(const MovementStatus status_)
+    {
+        status_changed = status != status_;
+        status = status_;
+    }
+} // Botcraft
@@ -19,6 +19,11 @@ namespace Botcraft
         return inventory_manager_mutex;
     }
 
+    const Signal& InventoryManager::GetInventorySignal() const
+    {
+        return inventory_signal;
+    }
+
     void InventoryManager::SetSlot(const short window_id, const short index, const Slot &slot)
     {
         auto it = inventories.find(window_id);
@@ -121,6 +126,7 @@ namespace Botcraft
         SynchronizeContainerPlayerInventory(window_id);
 #endif
         inventories.erase(window_id);
+        inventory_signal.Notify();
     }
 
 #if PROTOCOL_VERSION < 755
@@ -287,6 +293,7 @@ namespace Botcraft
         {
             std::cerr << "Warning, unknown window called during ClientboundContainerSetSlotPacket Handle: " << msg.GetContainerId() << ", " << msg.GetSlot() << std::endl;
         }
+        inventory_signal.Notify();
     }
 
     void InventoryManager::Handle(ProtocolCraft::ClientboundContainerSetContentPacket& msg)
@@ -303,6 +310,7 @@ namespace Botcraft
             SetStateId(msg.GetContainerId(), msg.GetStateId());
         }
 #endif
+        inventory_signal.Notify();
     }
 
     void InventoryManager::Handle(ProtocolCraft::ClientboundOpenScreenPacket& msg)
@@ -333,12 +341,14 @@ namespace Botcraft
 #else
         AddInventory(msg.GetContainerId(), (InventoryType)msg.GetType());
 #endif
+        inventory_signal.Notify();
     }
 
     void InventoryManager::Handle(ProtocolCraft::ClientboundSetCarriedItemPacket& msg)
     {
         std::lock_guard<std::mutex> inventory_manager_locker(inventory_manager_mutex);
         SetHotbarSelected(msg.GetSlot());
+        inventory_signal.Notify();
     }
 
 #if PROTOCOL_VERSION < 755
@@ -354,6 +364,7 @@ namespace Botcraft
             it_container = transaction_states.find(msg.GetContainerId());
         }
         it_container->second[msg.GetUid()] = msg.GetAccepted() ? TransactionState::Accepted : TransactionState::Refused;
+        inventory_signal.Notify();
 
         auto container_transactions = pending_transactions.find(msg.GetContainerId());
 
@@ -13,6 +13,14 @@ namespace Botcraft
 
     }
 
+    Item::Item()
+    {
+        id = 0;
+#if PROTOCOL_VERSION < 347
+        damage_id = 0;
+#endif
+    }
+
     const int Item::GetId() const
     {
         return id;
@@ -23,6 +31,11 @@ namespace Botcraft
         return name;
     }
 
+    const std::string_view Item::GetNameView() const
+    {
+        return name;
+    }
+
 #if PROTOCOL_VERSION < 347
     const unsigned char Item::GetDamageId() const
     {
@@ -4,6 +4,7 @@
 #include "botcraft/Game/AssetsManager.hpp"
 #include "botcraft/Game/Entities/EntityManager.hpp"
 #include "botcraft/Game/Entities/LocalPlayer.hpp"
+#include "botcraft/Game/Entities/MovementController.hpp"
 #include "botcraft/Game/World/Chunk.hpp"
 #include "botcraft/Game/World/World.hpp"
 #include "botcraft/Game/World/Block.hpp"
@@ -33,6 +34,7 @@ namespace Botcraft
         world = nullptr;
         inventory_manager = nullptr;
         entity_manager = nullptr;
+        movement_controller = nullptr;
 
 #if USE_GUI
         use_renderer = use_renderer_;
@@ -85,6 +87,7 @@ namespace Botcraft
         }
         inventory_manager.reset();
         entity_manager.reset();
+        movement_controller.reset();
     }
 
     void ManagersClient::RunSyncPos()
@@ -94,99 +97,125 @@ namespace Botcraft
 
         auto last_send = std::chrono::system_clock::now();
         std::shared_ptr<ServerboundMovePlayerPacketPosRot> msg_position(new ServerboundMovePlayerPacketPosRot);
-        bool has_moved = false;
 
         while (network_manager && network_manager->GetConnectionState() == ProtocolCraft::ConnectionState::Play)
         {
             // End of the current tick
             auto end = std::chrono::system_clock::now() + std::chrono::milliseconds(50);
 
-            if (entity_manager)
+            std::shared_ptr<LocalPlayer> local_player = entity_manager ? entity_manager->GetLocalPlayer() : nullptr;
+            if (local_player && local_player->GetState().position.y < 1000.0)
             {
-                std::shared_ptr<LocalPlayer> local_player = entity_manager->GetLocalPlayer();
-                if (local_player && local_player->GetPosition().y < 1000.0)
+                const bool has_moved = PhysicsTick();
+
+                if (network_manager &&
+                    (has_moved || std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - last_send).count() >= 1000))
                 {
-                    bool is_loaded = false;
-                    bool is_in_fluid = false;
-                    std::lock_guard<std::mutex> player_guard(local_player->GetMutex());
-                    {
-                        std::lock_guard<std::mutex> mutex_guard(world->GetMutex());
-                        const Position player_position = Position(std::floor(local_player->GetX()), std::floor(local_player->GetY()), std::floor(local_player->GetZ()));
+                    const LocalPlayerState state = local_player->GetState();
+                    msg_position->SetX(state.position.x);
+                    msg_position->SetY(state.position.y);
+                    msg_position->SetZ(state.position.z);
+                    msg_position->SetYRot(state.yaw);
+                    msg_position->SetXRot(state.pitch);
+                    msg_position->SetOnGround(state.on_ground);
+
+                    network_manager->Send(msg_position);
+                    last_send = std::chrono::system_clock::now();
+                }
+            }
+            std::this_thread::sleep_until(end);
+        }
+    }
 
-                        is_loaded = world->IsLoaded(player_position);
+    const bool ManagersClient::PhysicsTick()
+    {
+        std::shared_ptr<LocalPlayer> local_player = entity_manager->GetLocalPlayer();
+        const LocalPlayerState state = local_player->GetState();
 
-                        if (is_loaded)
-                        {
-                            const Block* block_ptr = world->GetBlock(player_position);
-                            is_in_fluid = block_ptr && block_ptr->GetBlockstate()->IsFluid();
-                        }
-                    }
+        bool is_loaded = false;
+        bool is_in_fluid = false;
+        // The world is checked before locking the player, so
+        // readers of the player are never delayed by a chunk
+        // being loaded
+        {
+            std::lock_guard<std::mutex> mutex_guard(world->GetMutex());
+            const Position player_position = Position(std::floor(state.position.x), std::floor(state.position.y), std::floor(state.position.z));
 
-                    if (is_loaded)
-                    {
-                        //Check that we did not go through a block
-                        Physics(is_in_fluid);
+            is_loaded = world->IsLoaded(player_position);
 
-                        if (local_player->GetHasMoved() ||
-                            std::abs(local_player->GetSpeed().x) > 1e-3 ||
-                            std::abs(local_player->GetSpeed().y) > 1e-3 ||
-                            std::abs(local_player->GetSpeed().z) > 1e-3)
-                        {
-                            has_moved = true;
-                            // Reset the player move state until next tick
-                            local_player->SetHasMoved(false);
-                        }
-                        else
-                        {
-                            has_moved = false;
-                        }
+            if (is_loaded)
+            {
+                const Block* block_ptr = world->GetBlock(player_position);
+                is_in_fluid = block_ptr && block_ptr->GetBlockstate()->IsFluid();
+            }
+        }
 
-                        //Avoid forever falling if position is <= 0.0
-                        // TODO : not good with world extension
-                        if (local_player->GetPosition().y <= 0.0)
-                        {
-                            local_player->SetY(0.0);
-                            local_player->SetSpeedY(0.0);
-                            local_player->SetOnGround(true);
-                        }
+        std::lock_guard<std::mutex> player_guard(local_player->GetMutex());
+        // Queue the movement of this tick to follow the current path
+        const bool movement_status_changed = is_loaded && movement_controller && movement_controller->Tick(*local_player);
+        // Commands from the behaviours, the movement controller
+        // and corrections from the server (teleportations...)
+        const bool commands_applied = local_player->ApplyMovementCommands();
+        bool notify = commands_applied || movement_status_changed;
+        bool has_moved = false;
 
-                        // Reset the speed until next frame
-                        // Update the gravity value if needed
-                        local_player->SetSpeedX(0.0);
-                        local_player->SetSpeedZ(0.0);
-                        if (local_player->GetOnGround())
-                        {
-                            local_player->SetSpeedY(0.0);
-                        }
-                        else
-                        {
-                            local_player->SetSpeedY((local_player->GetSpeed().y - 0.08) * 0.98);//TODO replace hardcoded value?
-                        }
-                    }
+        if (is_loaded)
+        {
+            const bool was_on_ground = local_player->GetOnGround();
 
-#if USE_GUI
-                    if (rendering_manager && has_moved)
-                    {
-                        rendering_manager->SetPosOrientation(local_player->GetPosition().x, local_player->GetPosition().y + 1.62, local_player->GetPosition().z, local_player->GetYaw(), local_player->GetPitch());
-                    }
-#endif
-                    if (network_manager &&
-                        (has_moved || std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - last_send).count() >= 1000))
-                    {
-                        msg_position->SetX(local_player->GetPosition().x);
-                        msg_position->SetY(local_player->GetPosition().y);
-                        msg_position->SetZ(local_player->GetPosition().z);
-                        msg_position->SetYRot(local_player->GetYaw());
-                        msg_position->SetXRot(local_player->GetPitch());
-                        msg_position->SetOnGround(local_player->GetOnGround());
-
-                        network_manager->Send(msg_position);
-                        last_send = std::chrono::system_clock::now();
-                    }
-                }
+            //Check that we did not go through a block
+            Physics(is_in_fluid);
+
+            if (local_player->GetHasMoved() ||
+                std::abs(local_player->GetSpeed().x) > 1e-3 ||
+                std::abs(local_player->GetSpeed().y) > 1e-3 ||
+                std::abs(local_player->GetSpeed().z) > 1e-3)
+            {
+                has_moved = true;
+                // Reset the player move state until next tick
+                local_player->SetHasMoved(false);
             }
-            std::this_thread::sleep_until(end);
+
+            //Avoid forever falling if position is <= 0.0
+            // TODO : not good with world extension
+            if (local_player->GetPosition().y <= 0.0)
+            {
+                local_player->SetY(0.0);
+                local_player->SetSpeedY(0.0);
+                local_player->SetOnGround(true);
+            }
+
+            notify = notify || has_moved || local_player->GetOnGround() != was_on_ground;
+
+            // Reset the speed until next frame
+            // Update the gravity value if needed
+            local_player->SetSpeedX(0.0);
+            local_player->SetSpeedZ(0.0);
+            if (local_player->GetOnGround())
+            {
+                local_player->SetSpeedY(0.0);
+            }
+            else
+            {
+                local_player->SetSpeedY((local_player->GetSpeed().y - 0.08) * 0.98);//TODO replace hardcoded value?
+            }
+        }
+        // Published before the notification so
+        // woken up behaviours see the new state
+        local_player->PublishState();
+        if (notify)
+        {
+            entity_manager->GetLocalPlayerSignal().Notify();
+        }
+
+#if USE_GUI
+        if (rendering_manager && notify)
+        {
+            rendering_manager->SetPosOrientation(local_player->GetPosition().x, local_player->GetPosition().y + 1.62, local_player->GetPosition().z, local_player->GetYaw(), local_player->GetPitch());
         }
+#endif
+
+        return has_moved || commands_applied;
     }
 
     void ManagersClient::Physics(const bool is_in_fluid)
@@ -221,76 +250,95 @@ namespace Botcraft
 
         bool has_hit_down = false;
         bool has_hit_up = false;
-        
+
+        // Get all the blocks in the broadphase box at once
+        const Position min_cube((int)std::floor(min_player_collider.x), (int)std::floor(min_player_collider.y), (int)std::floor(min_player_collider.z));
+        const Position max_cube((int)std::ceil(max_player_collider.x) - 1, (int)std::ceil(max_player_collider.y) - 1, (int)std::ceil(max_player_collider.z) - 1);
+        std::vector<const Blockstate*> region_blockstates;
+        world->GetBlockstates(min_cube, max_cube, region_blockstates);
+
+        const AssetsManager& assets_manager = AssetsManager::getInstance();
+
+        // Gather all the colliders that can be hit during this step
+        AABBArray candidates;
         Position cube_pos;
-        for (int x = (int)std::floor(min_player_collider.x); x < (int)std::ceil(max_player_collider.x); ++x)
+        int index = 0;
+        for (int y = min_cube.y; y <= max_cube.y; ++y)
         {
-            cube_pos.x = x;
-            for (int y = (int)std::floor(min_player_collider.y); y < (int)std::ceil(max_player_collider.y); ++y)
+            cube_pos.y = y;
+            for (int z = min_cube.z; z <= max_cube.z; ++z)
             {
-                cube_pos.y = y;
-                for (int z = (int)std::floor(min_player_collider.z); z < (int)std::ceil(max_player_collider.z); ++z)
+                cube_pos.z = z;
+                for (int x = min_cube.x; x <= max_cube.x; ++x, ++index)
                 {
-                    cube_pos.z = z;
+                    cube_pos.x = x;
 
-                    Block block;
+                    const Blockstate* blockstate = region_blockstates[index];
+                    if (blockstate == nullptr)
                     {
-                        std::lock_guard<std::mutex> mutex_guard(world->GetMutex());
-                        const Block *block_ptr = world->GetBlock(cube_pos);
-
-                        if (block_ptr == nullptr)
-                        {
-                            continue;
-                        }
-                        block = *block_ptr;
+                        continue;
                     }
 
-                    if (!is_in_fluid && !block.GetBlockstate()->IsSolid())
+                    if (!is_in_fluid && !blockstate->IsSolid())
                     {
                         continue;
                     }
                     
                     if (is_in_fluid &&
-                        !block.GetBlockstate()->IsSolid() &&
-                        (!block.GetBlockstate()->IsFluid() ||
+                        !blockstate->IsSolid() &&
+                        (!blockstate->IsFluid() ||
                             cube_pos.y >= player_position.y))
                     {
                         continue;
                     }
 
-                    const std::vector<AABB> &block_colliders = block.GetBlockstate()->GetModel(block.GetModelId()).GetColliders();
+                    const CollisionShape& shape = assets_manager.GetCollisionShape(blockstate, cube_pos);
+                    if (shape.type == CollisionShapeType::Empty)
+                    {
+                        continue;
+                    }
 
-                    for (int i = 0; i < block_colliders.size(); ++i)
+                    const Vector3<double> offset(cube_pos.x, cube_pos.y, cube_pos.z);
+                    for (int i = 0; i < shape.boxes.size(); ++i)
                     {
-                        if (!broadphase_collider.Collide(block_colliders[i] + Vector3<double>(cube_pos.x, cube_pos.y, cube_pos.z)))
+                        const AABB box = shape.boxes[i] + offset;
+                        if (broadphase_collider.Collide(box))
                         {
-                            continue;
+                            candidates.Add(box);
                         }
+                    }
+                }
+            }
+        }
 
-                        Vector3<double> normal;
-                        const double speed_fraction = local_player->GetCollider().SweptCollide(local_player->GetSpeed(), block_colliders[i] + Vector3<double>(cube_pos.x, cube_pos.y, cube_pos.z), normal);
+        // Resolve the first collision along the current speed, then
+        // try again with the corrected speed. Each collision removes
+        // the speed along one axis, so three steps are enough
+        const AABB player_collider = local_player->GetCollider();
+        for (int step = 0; step < 3; ++step)
+        {
+            Vector3<double> normal;
+            const double speed_fraction = player_collider.SweptCollide(local_player->GetSpeed(), candidates, normal);
 
-                        if (speed_fraction < 1.0)
-                        {
-                            const Vector3<double> remaining_speed = local_player->GetSpeed() * (1.0 - speed_fraction);
+            if (speed_fraction >= 1.0)
+            {
+                break;
+            }
 
-                            // We remove epsilon to be sure we do not go
-                            // through the face due to numerical imprecision
-                            local_player->SetSpeed(local_player->GetSpeed() * (speed_fraction - 1e-6) + // Base speed truncated
-                                (remaining_speed - normal * remaining_speed.dot(normal))); // Remaining speed projected on the plane
-                        }
+            const Vector3<double> remaining_speed = local_player->GetSpeed() * (1.0 - speed_fraction);
 
-                        if (normal.y == 1.0)
-                        {
-                            has_hit_down = true;
-                        }
-                        else if (normal.y == -1.0)
-                        {
-                            has_hit_up = true;
-                        }
+            // We remove epsilon to be sure we do not go
+            // through the face due to numerical imprecision
+            local_player->SetSpeed(local_player->GetSpeed() * (speed_fraction - 1e-6) + // Base speed truncated
+                (remaining_speed - normal * remaining_speed.dot(normal))); // Remaining speed projected on the plane
 
-                    }
-                }
+            if (normal.y == 1.0)
+            {
+                has_hit_down = true;
+            }
+            else if (normal.y == -1.0)
+            {
+                has_hit_up = true;
             }
         }
         local_player->SetPosition(local_player->GetPosition() + local_player->GetSpeed());
@@ -355,6 +403,11 @@ namespace Botcraft
         return inventory_manager;
     }
 
+    std::shared_ptr<MovementController> ManagersClient::GetMovementController() const
+    {
+        return movement_controller;
+    }
+
     const bool ManagersClient::GetCreativeMode() const
     {
         return creative_mode;
@@ -374,6 +427,7 @@ namespace Botcraft
 
         inventory_manager = std::make_shared<InventoryManager>();
         entity_manager = std::make_shared<EntityManager>();
+        movement_controller = std::make_shared<MovementController>();
 
         network_manager->AddHandler(world->GetAsyncHandler());
         network_manager->AddHandler(inventory_manager.get());
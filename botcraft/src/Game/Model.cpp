@@ -10,10 +10,13 @@
 namespace Botcraft
 {
     std::unordered_map<std::string, Model> Model::cached_models;
+    std::mutex Model::mapped_colliders_mutex;
 
     Model::Model()
     {
         ambient_occlusion = false;
+        mapped_colliders = nullptr;
+        num_mapped_colliders = 0;
     }
 
     const Model& Model::GetModel(const std::string& filepath, const bool custom)
@@ -34,6 +37,9 @@ namespace Botcraft
 
     Model::Model(const std::string &filepath, const bool custom)
     {
+        mapped_colliders = nullptr;
+        num_mapped_colliders = 0;
+
         std::string full_filepath;
         
         if (custom)
@@ -504,6 +510,8 @@ namespace Botcraft
     Model::Model(const unsigned char height, const std::string &texture)
     {
         ambient_occlusion = false;
+        mapped_colliders = nullptr;
+        num_mapped_colliders = 0;
         colliders = std::vector<AABB>({ AABB(Vector3<double>(0.5, (height + 1.0) / 2.0 / 16.0, 0.5), Vector3<double>(0.5, (height + 1.0) / 2.0 / 16.0, 0.5)) });
 
 #ifdef USE_GUI
@@ -578,9 +586,26 @@ namespace Botcraft
 
     const std::vector<AABB> &Model::GetColliders() const
     {
+        if (mapped_colliders != nullptr)
+        {
+            std::lock_guard<std::mutex> lock(mapped_colliders_mutex);
+            if (colliders.size() != num_mapped_colliders)
+            {
+                colliders = std::vector<AABB>(mapped_colliders, mapped_colliders + num_mapped_colliders);
+            }
+        }
         return colliders;
     }
 
+    const AABBView Model::GetCollidersView() const
+    {
+        if (mapped_colliders != nullptr)
+        {
+            return AABBView(mapped_colliders, num_mapped_colliders);
+        }
+        return AABBView(colliders);
+    }
+
     std::vector<AABB> &Model::GetColliders()
     {
         return colliders;
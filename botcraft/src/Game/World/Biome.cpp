@@ -24,6 +24,15 @@ namespace Botcraft
         default_leaves = ComputeColorTriangle(0, false);
     }
 
+    Biome::Biome()
+    {
+        temperature = 0.0f;
+        rainfall = 0.0f;
+        default_grass = 0;
+        default_leaves = 0;
+        biome_type = BiomeType::Classic;
+    }
+
     Biome::~Biome()
     {
     }
@@ -108,6 +117,31 @@ namespace Botcraft
 #endif
     }
 
+    const std::string &Biome::GetName() const
+    {
+        return name;
+    }
+
+    const std::string_view Biome::GetNameView() const
+    {
+        return name;
+    }
+
+    const float Biome::GetTemperature() const
+    {
+        return temperature;
+    }
+
+    const float Biome::GetRainfall() const
+    {
+        return rainfall;
+    }
+
+    const BiomeType Biome::GetBiomeType() const
+    {
+        return biome_type;
+    }
+
     const unsigned int Biome::ComputeColorTriangle(const int height, const bool is_grass) const
     {
         const float local_temperature = std::max(0.0f, std::min(1.0f, temperature - height * 0.0016667f));
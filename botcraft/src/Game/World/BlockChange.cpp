@@ -0,0 +1,89 @@
+#include "botcraft/Game/World/BlockChange.hpp"
+#include "botcraft/Game/World/Blockstate.hpp"
+
+namespace Botcraft
+{
+    BlockChangeFilter::BlockChangeFilter()
+    {
+        types = 0xFF;
+        use_region = false;
+    }
+
+    const bool BlockChangeFilter::Match(const BlockChangeEvent& event) const
+    {
+        if (!(types & static_cast<unsigned char>(event.type)))
+        {
+            return false;
+        }
+
+        if (use_region &&
+            (event.max.x < min.x || event.max.y < min.y || event.max.z < min.z ||
+             event.min.x > max.x || event.min.y > max.y || event.min.z > max.z))
+        {
+            return false;
+        }
+
+        if (blocks.empty() || event.type != BlockChangeType::BlockChanged)
+        {
+            return true;
+        }
+
+        return MatchBlock(event.previous) || MatchBlock(event.current);
+    }
+
+    const bool BlockChangeFilter::MatchBlock(const Blockstate* blockstate) const
+    {
+        // Blockstates are never destroyed, the
+        // names lookup can be done only once
+        auto it = blocks_cache.find(blockstate);
+        if (it == blocks_cache.end())
+        {
+            const bool match = blocks.find(blockstate ? blockstate->GetName() : "minecraft:air") != blocks.end();
+            it = blocks_cache.insert({ blockstate, match }).first;
+        }
+        return it->second;
+    }
+
+    BlockChangeQueue::BlockChangeQueue(const size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        buffer.resize(size);
+        mask = size - 1;
+        head = 0;
+        tail = 0;
+        overflowed = false;
+    }
+
+    void BlockChangeQueue::Push(const BlockChangeEvent& event)
+    {
+        const size_t current_tail = tail.load(std::memory_order_relaxed);
+        if (current_tail - head.load(std::memory_order_acquire) == buffer.size())
+        {
+            overflowed.store(true, std::memory_order_release);
+            return;
+        }
+        buffer[current_tail & mask] = event;
+        tail.store(current_tail + 1, std::memory_order_release);
+    }
+
+    const bool BlockChangeQueue::PopAll(std::vector<BlockChangeEvent>& output)
+    {
+        // Read the flag first, so events dropped after
+        // this point are reported on the next call
+        const bool lost = overflowed.exchange(false, std::memory_order_acq_rel);
+
+        const size_t current_head = head.load(std::memory_order_relaxed);
+        const size_t current_tail = tail.load(std::memory_order_acquire);
+        for (size_t i = current_head; i != current_tail; ++i)
+        {
+            output.push_back(buffer[i & mask]);
+        }
+        head.store(current_tail, std::memory_order_release);
+
+        return !lost;
+    }
+} // namespace Botcraft
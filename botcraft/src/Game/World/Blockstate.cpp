@@ -1,8 +1,6 @@
 #include <sstream>
 #include <fstream>
 #include <iostream>
-#include <random>
-#include <chrono>
 
 #include <nlohmann/json.hpp>
 
@@ -234,6 +232,7 @@ namespace Botcraft
 
     // Blockstate implementation starts here
     std::map<std::string, nlohmann::json> Blockstate::cached_jsons;
+    std::map<std::string, unsigned int, std::less<> > Blockstate::name_ids;
 
 #if PROTOCOL_VERSION < 347
     Blockstate::Blockstate(const int id_, const unsigned char metadata_, 
@@ -241,31 +240,38 @@ namespace Botcraft
                            const float hardness_, const TintType tint_type_, const std::string &name_,
                            const std::string &path, const std::vector<std::string> &variables) :
                            id(id_), metadata(metadata_), transparent(transparent_), solid(solid_), fluid(fluid_),
-                           hardness(hardness_), tint_type(tint_type_), m_name(name_)
+                           hardness(hardness_), tint_type(tint_type_)
 #else
     Blockstate::Blockstate(const int id_,
                            const bool transparent_, const bool solid_, const bool fluid_, const bool custom,
                            const float hardness_, const TintType tint_type_, const std::string &name_,
                            const std::string &path, const std::vector<std::string> &variables) :
                            id(id_), transparent(transparent_), solid(solid_), fluid(fluid_),
-                           hardness(hardness_), tint_type(tint_type_), m_name(name_)
+                           hardness(hardness_), tint_type(tint_type_)
 #endif
+    {
+        SetName(name_, static_cast<unsigned int>(name_ids.size()));
+
+        LoadModels(custom, path, variables);
+        SetOwnedViews();
+    }
+
+    void Blockstate::LoadModels(const bool custom, const std::string &path, const std::vector<std::string> &variables)
     {
         weights_sum = 0;
-        random_generator = std::mt19937(std::chrono::system_clock::now().time_since_epoch().count());
 
         if (path == "none")
         {
-            models.push_back(Model());
-            models_weights.push_back(1);
+            owned_models.push_back(Model());
+            owned_models_weights.push_back(1);
             weights_sum += 1;
             return;
         }
 
         if (path.empty())
         {
-            models.push_back(Model::GetModel("", false));
-            models_weights.push_back(1);
+            owned_models.push_back(Model::GetModel("", false));
+            owned_models_weights.push_back(1);
             weights_sum += 1;
 
             return;
@@ -301,8 +307,8 @@ namespace Botcraft
             }
             std::cerr << e.what() << std::endl;
             
-            models.push_back(Model::GetModel("", false));
-            models_weights.push_back(1);
+            owned_models.push_back(Model::GetModel("", false));
+            owned_models_weights.push_back(1);
             weights_sum += 1;
 
             return;
@@ -367,7 +373,7 @@ namespace Botcraft
                     {
                         const int weight = WeightFromJson(model);
                         models_deque.push_back(ModelModificationFromJson(Model::GetModel(ModelNameFromJson(model), custom), model));
-                        models_weights.push_back(weight);
+                        owned_models_weights.push_back(weight);
                         weights_sum += weight;
                     }
                 }
@@ -375,7 +381,7 @@ namespace Botcraft
                 {
                     const int weight = WeightFromJson(variant_value);
                     models_deque.push_back(ModelModificationFromJson(Model::GetModel(ModelNameFromJson(variant_value), custom), variant_value));
-                    models_weights.push_back(weight);
+                    owned_models_weights.push_back(weight);
                     weights_sum += weight;
                 }
             }
@@ -383,7 +389,7 @@ namespace Botcraft
             {
                 std::cerr << "Error reading " << full_filepath << std::endl;
                 models_deque.push_back(Model::GetModel("", false));
-                models_weights.push_back(1);
+                owned_models_weights.push_back(1);
                 weights_sum += 1;
             }
         }
@@ -393,7 +399,7 @@ namespace Botcraft
         {
             //Start with an empty model
             models_deque.push_back(Model());
-            models_weights.push_back(1);
+            owned_models_weights.push_back(1);
             weights_sum = 0;
 
             for (auto& part : json["multipart"])
@@ -411,11 +417,11 @@ namespace Botcraft
                             for (int k = 0; k < num_models; ++k)
                             {
                                 models_deque.push_back(models_deque[k] + ModelModificationFromJson(Model::GetModel(model_name, custom), m));
-                                models_weights.push_back(models_weights[k] * WeightFromJson(m));
+                                owned_models_weights.push_back(owned_models_weights[k] * WeightFromJson(m));
                             }
                         }
                         models_deque.erase(models_deque.begin(), models_deque.begin() + num_models);
-                        models_weights.erase(models_weights.begin(), models_weights.begin() + num_models);
+                        owned_models_weights.erase(owned_models_weights.begin(), owned_models_weights.begin() + num_models);
                     }
                     else
                     {
@@ -423,7 +429,7 @@ namespace Botcraft
                         for (int k = 0; k < models_deque.size(); ++k)
                         {
                             models_deque[k] += ModelModificationFromJson(Model::GetModel(model_name, custom), part["apply"]);
-                            models_weights[k] *= WeightFromJson(part["apply"]);
+                            owned_models_weights[k] *= WeightFromJson(part["apply"]);
                         }
                     }
                 }
@@ -514,11 +520,11 @@ namespace Botcraft
                                 {
                                     Model new_model = models_deque[k] + ModelModificationFromJson(Model::GetModel(model_name, custom), m);
                                     models_deque.push_back(new_model);
-                                    models_weights.push_back(models_weights[k] * model_weight);
+                                    owned_models_weights.push_back(owned_models_weights[k] * model_weight);
                                 }
                             }
                             models_deque.erase(models_deque.begin(), models_deque.begin() + num_models);
-                            models_weights.erase(models_weights.begin(), models_weights.begin() + num_models);
+                            owned_models_weights.erase(owned_models_weights.begin(), owned_models_weights.begin() + num_models);
                         }
                         else
                         {
@@ -527,19 +533,19 @@ namespace Botcraft
                             for (int k = 0; k < models_deque.size(); ++k)
                             {
                                 models_deque[k] += ModelModificationFromJson(Model::GetModel(model_name, custom), part["apply"]);
-                                models_weights[k] *= model_weight;
+                                owned_models_weights[k] *= model_weight;
                             }
                         }
                     }
                 }
             }
 
-            for (int i = 0; i < models_weights.size(); ++i)
+            for (int i = 0; i < owned_models_weights.size(); ++i)
             {
-                weights_sum += models_weights[i];
+                weights_sum += owned_models_weights[i];
             }
         }
-        models = std::vector<Model>(std::make_move_iterator(models_deque.begin()), std::make_move_iterator(models_deque.end()));
+        owned_models = std::vector<Model>(std::make_move_iterator(models_deque.begin()), std::make_move_iterator(models_deque.end()));
     }
     
 #if PROTOCOL_VERSION < 347
@@ -548,21 +554,130 @@ namespace Botcraft
                            const float hardness_, const TintType tint_type_, const std::string &name_,
                            const Model &model_) :
                            id(id_), metadata(metadata_), transparent(transparent_),solid(solid_),
-                           hardness(hardness_), fluid(fluid_), tint_type(tint_type_), m_name(name_)
+                           hardness(hardness_), fluid(fluid_), tint_type(tint_type_)
 #else
     Blockstate::Blockstate(const int id_,
                            const bool transparent_, const bool solid_, const bool fluid_,
                            const float hardness_, const TintType tint_type_, const std::string &name_,
                            const Model &model_) :
                            id(id_), transparent(transparent_), solid(solid_), 
-                           hardness(hardness_), fluid(fluid_), tint_type(tint_type_), m_name(name_)
+                           hardness(hardness_), fluid(fluid_), tint_type(tint_type_)
 #endif
     {
+        SetName(name_, static_cast<unsigned int>(name_ids.size()));
+
         weights_sum = 1;
-        random_generator = std::mt19937(std::chrono::system_clock::now().time_since_epoch().count());
 
-        models_weights = { 1 };
-        models = { model_ };
+        owned_models_weights = { 1 };
+        owned_models = { model_ };
+
+        SetOwnedViews();
+    }
+
+#if PROTOCOL_VERSION < 347
+    Blockstate::Blockstate(const int id_, const unsigned char metadata_,
+                           const bool transparent_, const bool solid_, const bool fluid_,
+                           const float hardness_, const TintType tint_type_, const std::string &name_,
+                           const std::vector<Model> &models_, const std::vector<int> &models_weights_) :
+                           transparent(transparent_), solid(solid_), fluid(fluid_), hardness(hardness_), tint_type(tint_type_),
+                           owned_models(models_), owned_models_weights(models_weights_), id(id_), metadata(metadata_)
+#else
+    Blockstate::Blockstate(const int id_,
+                           const bool transparent_, const bool solid_, const bool fluid_,
+                           const float hardness_, const TintType tint_type_, const std::string &name_,
+                           const std::vector<Model> &models_, const std::vector<int> &models_weights_) :
+                           transparent(transparent_), solid(solid_), fluid(fluid_), hardness(hardness_), tint_type(tint_type_),
+                           owned_models(models_), owned_models_weights(models_weights_), id(id_)
+#endif
+    {
+        SetName(name_, static_cast<unsigned int>(name_ids.size()));
+
+        weights_sum = 0;
+        for (int i = 0; i < owned_models_weights.size(); ++i)
+        {
+            weights_sum += owned_models_weights[i];
+        }
+
+        SetOwnedViews();
+    }
+
+    Blockstate::Blockstate()
+    {
+        name = nullptr;
+        transparent = false;
+        solid = false;
+        fluid = false;
+        hardness = 0.0f;
+        tint_type = TintType::None;
+        name_id = 0;
+        models = nullptr;
+        models_weights = nullptr;
+        num_models = 0;
+        weights_sum = 0;
+        id = 0;
+#if PROTOCOL_VERSION < 347
+        metadata = 0;
+#endif
+    }
+
+    Blockstate::Blockstate(const Blockstate& other)
+    {
+        *this = other;
+    }
+
+    Blockstate& Blockstate::operator=(const Blockstate& other)
+    {
+        if (this == &other)
+        {
+            return *this;
+        }
+
+        transparent = other.transparent;
+        solid = other.solid;
+        fluid = other.fluid;
+        hardness = other.hardness;
+        tint_type = other.tint_type;
+        name_id = other.name_id;
+        name = other.name;
+        owned_models = other.owned_models;
+        owned_models_weights = other.owned_models_weights;
+        weights_sum = other.weights_sum;
+        id = other.id;
+#if PROTOCOL_VERSION < 347
+        metadata = other.metadata;
+#endif
+
+        // Mapped data can be shared, owned data must point to the copy
+        if (other.models == other.owned_models.data())
+        {
+            SetOwnedViews();
+        }
+        else
+        {
+            models = other.models;
+            models_weights = other.models_weights;
+            num_models = other.num_models;
+        }
+
+        return *this;
+    }
+
+    void Blockstate::SetOwnedViews()
+    {
+        models = owned_models.data();
+        models_weights = owned_models_weights.data();
+        num_models = static_cast<int>(owned_models.size());
+    }
+
+    void Blockstate::SetName(const std::string_view name_, const unsigned int new_id)
+    {
+        auto name_it = name_ids.find(name_);
+        if (name_it == name_ids.end())
+        {
+            name_it = name_ids.insert({ std::string(name_), new_id }).first;
+        }
+        name = &name_it->first;
+        name_id = name_it->second;
     }
 
     const unsigned int Blockstate::GetId() const
@@ -582,10 +697,34 @@ namespace Botcraft
         return models[index];
     }
 
-    const unsigned char Blockstate::GetRandomModelId()
+    const int Blockstate::GetModelWeight(const unsigned char index) const
     {
-        int random_value = std::uniform_int_distribution<int>(0, weights_sum - 1)(random_generator);
-        for (int i = 0; i < models_weights.size(); ++i)
+        return models_weights[index];
+    }
+
+    const unsigned char Blockstate::GetModelId(const Position& pos) const
+    {
+        if (num_models < 2)
+        {
+            return 0;
+        }
+
+        unsigned long long int hash = static_cast<unsigned int>(pos.x) * 0x9E3779B97F4A7C15ULL;
+        hash ^= static_cast<unsigned int>(pos.y) * 0xC2B2AE3D27D4EB4FULL;
+        hash ^= static_cast<unsigned int>(pos.z) * 0x165667B19E3779F9ULL;
+        hash ^= static_cast<unsigned long long int>(id) * 0xD6E8FEB86659FD93ULL;
+        hash ^= hash >> 32;
+        hash *= 0xD6E8FEB86659FD93ULL;
+        hash ^= hash >> 32;
+
+        // All the variants have a null weight, pick them uniformly
+        if (weights_sum <= 0)
+        {
+            return static_cast<unsigned char>(hash % static_cast<unsigned long long int>(num_models));
+        }
+
+        int random_value = static_cast<int>(hash % static_cast<unsigned long long int>(weights_sum));
+        for (int i = 0; i < num_models; ++i)
         {
             if (random_value < models_weights[i])
             {
@@ -597,9 +736,19 @@ namespace Botcraft
         return 0;
     }
 
-    const std::string& Blockstate::GetName() const
+    const std::string &Blockstate::GetName() const
+    {
+        return *name;
+    }
+
+    const std::string_view Blockstate::GetNameView() const
+    {
+        return *name;
+    }
+
+    const unsigned int Blockstate::GetNameId() const
     {
-        return m_name;
+        return name_id;
     }
 
     const bool Blockstate::IsAir() const
@@ -652,6 +801,6 @@ namespace Botcraft
 
     const int Blockstate::GetNumModels() const
     {
-        return models.size();
+        return num_models;
     }
 } //Botcraft
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "protocolCraft/Types/NBT/TagInt.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 using namespace ProtocolCraft;
@@ -39,11 +40,16 @@ namespace Botcraft
         sections = std::vector<std::shared_ptr<Section> >(CHUNK_HEIGHT / SECTION_HEIGHT);
 
 #if USE_GUI
-        modified_since_last_rendered = true;
+        modified_sections_since_last_rendered = std::vector<bool>(CHUNK_HEIGHT / SECTION_HEIGHT, true);
 #endif
     }
 
-    Chunk::Chunk(const Chunk& c)
+    Chunk::Chunk(const Chunk& c) : Chunk(c, std::vector<bool>(CHUNK_HEIGHT / SECTION_HEIGHT, true))
+    {
+
+    }
+
+    Chunk::Chunk(const Chunk& c, const std::vector<bool>& copied_sections)
     {
         dimension = c.dimension;
 #if PROTOCOL_VERSION < 358
@@ -56,7 +62,7 @@ namespace Botcraft
         sections = std::vector<std::shared_ptr<Section> >(CHUNK_HEIGHT / SECTION_HEIGHT);
         for (int i = 0; i < c.sections.size(); i++)
         {
-            if (c.sections[i] == nullptr)
+            if (c.sections[i] == nullptr || !copied_sections[i])
             {
                 sections[i] = nullptr;
             }
@@ -70,6 +76,10 @@ namespace Botcraft
         {
             block_entities_data[it->first] = std::shared_ptr<NBT>(new NBT(*it->second));
         }
+
+#if USE_GUI
+        modified_sections_since_last_rendered = c.modified_sections_since_last_rendered;
+#endif
     }
 
     const Position Chunk::BlockCoordsToChunkCoords(const Position& pos)
@@ -80,12 +90,33 @@ namespace Botcraft
 #if USE_GUI
     const bool Chunk::GetModifiedSinceLastRender() const
     {
-        return modified_since_last_rendered;
+        for (int i = 0; i < modified_sections_since_last_rendered.size(); ++i)
+        {
+            if (modified_sections_since_last_rendered[i])
+            {
+                return true;
+            }
+        }
+        return false;
     }
 
     void Chunk::SetModifiedSinceLastRender(const bool b)
     {
-        modified_since_last_rendered = b;
+        std::fill(modified_sections_since_last_rendered.begin(), modified_sections_since_last_rendered.end(), b);
+    }
+
+    const std::vector<bool>& Chunk::GetModifiedSectionsSinceLastRender() const
+    {
+        return modified_sections_since_last_rendered;
+    }
+
+    void Chunk::SetSectionModifiedSinceLastRender(const int y, const bool b)
+    {
+        if (y < 0 || y >= modified_sections_since_last_rendered.size())
+        {
+            return;
+        }
+        modified_sections_since_last_rendered[y] = b;
     }
 #endif
 
@@ -283,7 +314,7 @@ namespace Botcraft
         }
 #endif
 #if USE_GUI
-        modified_since_last_rendered = true;
+        SetModifiedSinceLastRender(true);
 #endif
     }
 
@@ -308,7 +339,7 @@ namespace Botcraft
         }
 
 #if USE_GUI
-        modified_since_last_rendered = true;
+        SetModifiedSinceLastRender(true);
 #endif
     }
 
@@ -322,7 +353,7 @@ namespace Botcraft
         block_entities_data[pos] = std::make_shared<NBT>(block_entity);
 
 #if USE_GUI
-        modified_since_last_rendered = true;
+        SetSectionModifiedSinceLastRender(pos.y / SECTION_HEIGHT, true);
 #endif
     }
 
@@ -358,9 +389,9 @@ namespace Botcraft
     }
 
 #if PROTOCOL_VERSION < 347
-    void Chunk::SetBlock(const Position &pos, const unsigned int id, unsigned char metadata, const int model_id)
+    void Chunk::SetBlock(const Position &pos, const unsigned int id, unsigned char metadata)
 #else
-    void Chunk::SetBlock(const Position &pos, const unsigned int id, const int model_id)
+    void Chunk::SetBlock(const Position &pos, const unsigned int id)
 #endif
     {
         if (pos.x < -1 || pos.x > CHUNK_WIDTH || pos.y < 0 || pos.y > CHUNK_HEIGHT - 1 || pos.z < -1 || pos.z > CHUNK_WIDTH)
@@ -381,15 +412,32 @@ namespace Botcraft
         }
         Block *block = sections[pos.y / SECTION_HEIGHT]->data_blocks.data() + ((pos.y % SECTION_HEIGHT) * (CHUNK_WIDTH + 2) * (CHUNK_WIDTH + 2) + (pos.z + 1) * (CHUNK_WIDTH + 2) + pos.x + 1);
 
+#if USE_GUI
+        const Blockstate* previous_blockstate = block->GetBlockstate();
+#endif
 
 #if PROTOCOL_VERSION < 347
-        block->ChangeBlockstate(id, metadata, model_id);
+        block->ChangeBlockstate(id, metadata);
 #else
-        block->ChangeBlockstate(id, model_id);
+        block->ChangeBlockstate(id);
 #endif
 
 #if USE_GUI
-        modified_since_last_rendered = true;
+        // Only invalidate the sections that need to be
+        // rendered again if the block actually changed
+        if (block->GetBlockstate() != previous_blockstate)
+        {
+            SetSectionModifiedSinceLastRender(pos.y / SECTION_HEIGHT, true);
+            // Blocks on the vertical border of a section can hide faces of the next one
+            if (pos.y % SECTION_HEIGHT == 0 && pos.y > 0)
+            {
+                SetSectionModifiedSinceLastRender(pos.y / SECTION_HEIGHT - 1, true);
+            }
+            else if (pos.y % SECTION_HEIGHT == SECTION_HEIGHT - 1 && pos.y < CHUNK_HEIGHT - 1)
+            {
+                SetSectionModifiedSinceLastRender(pos.y / SECTION_HEIGHT + 1, true);
+            }
+        }
 #endif
     }
 
@@ -398,17 +446,17 @@ namespace Botcraft
         if (block == nullptr)
         {
 #if PROTOCOL_VERSION < 347
-            SetBlock(pos, 0, 0, -1);
+            SetBlock(pos, 0, 0);
 #else
-            SetBlock(pos, 0, -1);
+            SetBlock(pos, 0u);
 #endif
         }
         else
         {
 #if PROTOCOL_VERSION < 347
-            SetBlock(pos, block->GetBlockstate()->GetId(), block->GetBlockstate()->GetMetadata(), block->GetModelId());
+            SetBlock(pos, block->GetBlockstate()->GetId(), block->GetBlockstate()->GetMetadata());
 #else
-            SetBlock(pos, block->GetBlockstate()->GetId(), block->GetModelId());
+            SetBlock(pos, block->GetBlockstate()->GetId());
 #endif
         }
     }
@@ -443,7 +491,7 @@ namespace Botcraft
 
         // Not necessary as we don't render lights
 //#if USE_GUI
-//        modified_since_last_rendered = true;
+//        SetSectionModifiedSinceLastRender(pos.y / SECTION_HEIGHT, true);
 //#endif
     }
 
@@ -487,7 +535,7 @@ namespace Botcraft
         sections[pos.y / SECTION_HEIGHT]->block_light[(pos.y % SECTION_HEIGHT) * CHUNK_WIDTH * CHUNK_WIDTH + pos.z * CHUNK_WIDTH + pos.x] = v;
         // Not necessary as we don't render lights
 //#if USE_GUI
-//        modified_since_last_rendered = true;
+//        SetSectionModifiedSinceLastRender(pos.y / SECTION_HEIGHT, true);
 //#endif
     }
 
@@ -512,7 +560,7 @@ namespace Botcraft
 		biomes[z * CHUNK_WIDTH + x] = b;
 
 #if USE_GUI
-        modified_since_last_rendered = true;
+        SetModifiedSinceLastRender(true);
 #endif
 	}
 
@@ -537,7 +585,7 @@ namespace Botcraft
 		biomes[z * CHUNK_WIDTH + x] = b;
 
 #if USE_GUI
-        modified_since_last_rendered = true;
+        SetModifiedSinceLastRender(true);
 #endif
 	}
 #else
@@ -566,7 +614,7 @@ namespace Botcraft
 		biomes = new_biomes;
 
 #if USE_GUI
-        modified_since_last_rendered = true;
+        SetModifiedSinceLastRender(true);
 #endif
 	}
 
@@ -585,7 +633,7 @@ namespace Botcraft
 		biomes[i] = new_biome;
 
 #if USE_GUI
-        modified_since_last_rendered = true;
+        SetSectionModifiedSinceLastRender(((i >> 4) & 63) * 4 / SECTION_HEIGHT, true);
 #endif
 	}
 #endif
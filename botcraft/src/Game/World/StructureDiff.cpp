@@ -0,0 +1,501 @@
+#include <algorithm>
+#include <queue>
+
+#include "botcraft/Game/World/StructureDiff.hpp"
+#include "botcraft/Game/World/World.hpp"
+#include "botcraft/Game/World/Block.hpp"
+
+namespace Botcraft
+{
+    // Size of the cells used to store the remaining blocks
+    static const int CELL_SIZE = 8;
+
+    StructureDiff::StructureDiff(const Position& start_, const Position& end_,
+        const std::vector<std::vector<std::vector<short> > >& target,
+        const std::map<short, std::string>& palette)
+    {
+        start = start_;
+        end = end_;
+        size = end - start + Position(1, 1, 1);
+        num_cells = Position((size.x + CELL_SIZE - 1) / CELL_SIZE, (size.y + CELL_SIZE - 1) / CELL_SIZE, (size.z + CELL_SIZE - 1) / CELL_SIZE);
+
+        // Several palette ids can have the same name (different block properties)
+        std::map<short, short> palette_kinds;
+        for (auto it = palette.begin(); it != palette.end(); ++it)
+        {
+            if (it->first == -1)
+            {
+                continue;
+            }
+            auto kind = kinds_by_name.find(it->second);
+            if (kind == kinds_by_name.end())
+            {
+                kind = kinds_by_name.insert({ it->second, static_cast<short>(palette_names.size() + 1) }).first;
+                palette_names.push_back(it->second);
+            }
+            palette_kinds[it->first] = kind->second;
+        }
+
+        target_kinds = std::vector<short>(size.x * size.y * size.z, -1);
+        for (int x = 0; x < size.x; ++x)
+        {
+            for (int y = 0; y < size.y; ++y)
+            {
+                for (int z = 0; z < size.z; ++z)
+                {
+                    const short palette_id = target[x][y][z];
+                    if (palette_id != -1)
+                    {
+                        target_kinds[(x * size.y + y) * size.z + z] = palette_kinds[palette_id];
+                    }
+                }
+            }
+        }
+
+        diffs = std::vector<BlockDiff>(target_kinds.size(), BlockDiff::Unknown);
+        cells = std::vector<std::vector<std::unordered_set<int> > >(num_cells.x * num_cells.y * num_cells.z,
+            std::vector<std::unordered_set<int> >(palette_names.size() + 1));
+
+        num_unknown = target_kinds.size();
+        num_correct = 0;
+        num_missing = 0;
+        num_wrong = 0;
+        num_additional = 0;
+        num_needed = std::vector<size_t>(palette_names.size() + 1, 0);
+    }
+
+    StructureDiff::~StructureDiff()
+    {
+        for (size_t i = 0; i < watched_worlds.size(); ++i)
+        {
+            std::shared_ptr<World> world = watched_worlds[i].world.lock();
+            if (world)
+            {
+                world->UnsubscribeBlockChanges(watched_worlds[i].subscriber_id);
+            }
+        }
+    }
+
+    void StructureDiff::Watch(const std::shared_ptr<World>& world)
+    {
+        std::lock_guard<std::mutex> diff_guard(diff_mutex);
+        for (size_t i = 0; i < watched_worlds.size(); ++i)
+        {
+            if (watched_worlds[i].world.lock() == world)
+            {
+                return;
+            }
+        }
+
+        // Unloaded chunks are not needed, blocks keep their last known state
+        BlockChangeFilter filter;
+        filter.types = static_cast<unsigned char>(BlockChangeType::ChunkLoaded) | static_cast<unsigned char>(BlockChangeType::BlockChanged);
+        filter.use_region = true;
+        filter.min = start;
+        filter.max = end;
+
+        std::shared_ptr<BlockChangeQueue> queue = std::make_shared<BlockChangeQueue>();
+        const size_t subscriber_id = world->SubscribeBlockChanges(filter, queue);
+        // Initial diff with what is already loaded
+        watched_worlds.push_back(WatchedWorld{ world, subscriber_id, queue, true });
+    }
+
+    void StructureDiff::Update()
+    {
+        std::lock_guard<std::mutex> diff_guard(diff_mutex);
+        ProcessBlockChanges();
+    }
+
+    const Position& StructureDiff::GetStart() const
+    {
+        return start;
+    }
+
+    const Position& StructureDiff::GetEnd() const
+    {
+        return end;
+    }
+
+    const size_t StructureDiff::GetNumBlocks() const
+    {
+        return target_kinds.size();
+    }
+
+    const size_t StructureDiff::GetNumRemaining()
+    {
+        std::lock_guard<std::mutex> diff_guard(diff_mutex);
+        ProcessBlockChanges();
+        return num_missing + num_wrong + num_additional;
+    }
+
+    const size_t StructureDiff::GetNumMissing()
+    {
+        std::lock_guard<std::mutex> diff_guard(diff_mutex);
+        ProcessBlockChanges();
+        return num_missing;
+    }
+
+    const size_t StructureDiff::GetNumWrong()
+    {
+        std::lock_guard<std::mutex> diff_guard(diff_mutex);
+        ProcessBlockChanges();
+        return num_wrong;
+    }
+
+    const size_t StructureDiff::GetNumAdditional()
+    {
+        std::lock_guard<std::mutex> diff_guard(diff_mutex);
+        ProcessBlockChanges();
+        return num_additional;
+    }
+
+    const size_t StructureDiff::GetNumUnknown()
+    {
+        std::lock_guard<std::mutex> diff_guard(diff_mutex);
+        ProcessBlockChanges();
+        return num_unknown;
+    }
+
+    const float StructureDiff::GetDonePercentage()
+    {
+        std::lock_guard<std::mutex> diff_guard(diff_mutex);
+        ProcessBlockChanges();
+        return target_kinds.empty() ? 100.0f : 100.0f * num_correct / target_kinds.size();
+    }
+
+    const size_t StructureDiff::GetNumNeeded(const std::string& item)
+    {
+        std::lock_guard<std::mutex> diff_guard(diff_mutex);
+        ProcessBlockChanges();
+        auto it = kinds_by_name.find(item);
+        return it == kinds_by_name.end() ? 0 : num_needed[it->second];
+    }
+
+    const std::map<std::string, size_t> StructureDiff::GetNeededItems()
+    {
+        std::lock_guard<std::mutex> diff_guard(diff_mutex);
+        ProcessBlockChanges();
+        std::map<std::string, size_t> output;
+        for (size_t i = 0; i < palette_names.size(); ++i)
+        {
+            if (num_needed[i + 1] > 0)
+            {
+                output[palette_names[i]] = num_needed[i + 1];
+            }
+        }
+        return output;
+    }
+
+    const std::vector<StructureDiffEntry> StructureDiff::GetRemaining(const size_t max_num)
+    {
+        std::lock_guard<std::mutex> diff_guard(diff_mutex);
+        ProcessBlockChanges();
+        std::vector<StructureDiffEntry> output;
+        for (size_t c = 0; c < cells.size() && output.size() < max_num; ++c)
+        {
+            for (size_t k = 0; k < cells[c].size() && output.size() < max_num; ++k)
+            {
+                for (auto it = cells[c][k].begin(); it != cells[c][k].end() && output.size() < max_num; ++it)
+                {
+                    const short target_kind = target_kinds[*it];
+                    StructureDiffEntry entry;
+                    entry.position = GetPosition(*it);
+                    entry.type = diffs[*it] == BlockDiff::Missing ? StructureDiffType::Missing :
+                        (diffs[*it] == BlockDiff::Wrong ? StructureDiffType::Wrong : StructureDiffType::Additional);
+                    entry.expected = target_kind == -1 ? "minecraft:air" : palette_names[target_kind - 1];
+                    output.push_back(entry);
+                }
+            }
+        }
+        return output;
+    }
+
+    const bool StructureDiff::GetNearestRemaining(const Vector3<double>& position, Position& out)
+    {
+        return FindNearest(position, std::set<std::string>(palette_names.begin(), palette_names.end()), true, nullptr,
+            [&out](const Position& pos, const std::string&)
+            {
+                out = pos;
+                return true;
+            });
+    }
+
+    const bool StructureDiff::FindNearest(const Vector3<double>& position, const std::set<std::string>& items, const bool include_dig,
+        const std::shared_ptr<World>& world, const std::function<bool(const Position&, const std::string&)>& accept)
+    {
+        std::lock_guard<std::mutex> diff_guard(diff_mutex);
+        ProcessBlockChanges();
+
+        std::vector<short> kinds;
+        if (include_dig)
+        {
+            kinds.push_back(0);
+        }
+        for (auto it = items.begin(); it != items.end(); ++it)
+        {
+            auto kind = kinds_by_name.find(*it);
+            if (kind != kinds_by_name.end())
+            {
+                kinds.push_back(kind->second);
+            }
+        }
+
+        // Search the cells ring by ring around the position. Once a ring is
+        // done, all the remaining blocks are at least ring * CELL_SIZE away
+        // so all the candidates closer than that can be checked in order
+        const Vector3<double> clamped(
+            std::min(static_cast<double>(end.x + 1), std::max(static_cast<double>(start.x), position.x)),
+            std::min(static_cast<double>(end.y + 1), std::max(static_cast<double>(start.y), position.y)),
+            std::min(static_cast<double>(end.z + 1), std::max(static_cast<double>(start.z), position.z)));
+        const Position center_cell(
+            std::min(num_cells.x - 1, static_cast<int>(clamped.x - start.x) / CELL_SIZE),
+            std::min(num_cells.y - 1, static_cast<int>(clamped.y - start.y) / CELL_SIZE),
+            std::min(num_cells.z - 1, static_cast<int>(clamped.z - start.z) / CELL_SIZE));
+        const int max_ring = std::max(std::max(std::max(center_cell.x, num_cells.x - 1 - center_cell.x),
+            std::max(center_cell.y, num_cells.y - 1 - center_cell.y)),
+            std::max(center_cell.z, num_cells.z - 1 - center_cell.z));
+
+        std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int> >, std::greater<std::pair<double, int> > > candidates;
+        for (int ring = 0; ring <= max_ring; ++ring)
+        {
+            for (int x = std::max(0, center_cell.x - ring); x <= std::min(num_cells.x - 1, center_cell.x + ring); ++x)
+            {
+                for (int y = std::max(0, center_cell.y - ring); y <= std::min(num_cells.y - 1, center_cell.y + ring); ++y)
+                {
+                    for (int z = std::max(0, center_cell.z - ring); z <= std::min(num_cells.z - 1, center_cell.z + ring); ++z)
+                    {
+                        if (std::abs(x - center_cell.x) != ring &&
+                            std::abs(y - center_cell.y) != ring &&
+                            std::abs(z - center_cell.z) != ring)
+                        {
+                            continue;
+                        }
+                        const std::vector<std::unordered_set<int> >& cell = cells[(x * num_cells.y + y) * num_cells.z + z];
+                        for (size_t k = 0; k < kinds.size(); ++k)
+                        {
+                            for (const int index : cell[kinds[k]])
+                            {
+                                const Position pos = GetPosition(index);
+                                const double dx = pos.x + 0.5 - position.x;
+                                const double dy = pos.y + 0.5 - position.y;
+                                const double dz = pos.z + 0.5 - position.z;
+                                candidates.push({ dx * dx + dy * dy + dz * dz, index });
+                            }
+                        }
+                    }
+                }
+            }
+
+            const double bound = static_cast<double>(ring * CELL_SIZE) * ring * CELL_SIZE;
+            while (!candidates.empty() && (ring == max_ring || candidates.top().first < bound))
+            {
+                const int index = candidates.top().second;
+                candidates.pop();
+                const Position pos = GetPosition(index);
+
+                if (!world)
+                {
+                    const short kind = GetKind(index);
+                    if (accept(pos, kind == 0 ? "" : palette_names[kind - 1]))
+                    {
+                        return true;
+                    }
+                    continue;
+                }
+
+                std::lock_guard<std::mutex> world_guard(world->GetMutex());
+                // Make sure the diff is still the same in this world
+                if (world->IsLoaded(pos))
+                {
+                    const Block* block = world->GetBlock(pos);
+                    UpdateBlock(index, block ? block->GetBlockstate() : nullptr);
+                }
+                const short kind = GetKind(index);
+                if (kind == -1 || std::find(kinds.begin(), kinds.end(), kind) == kinds.end())
+                {
+                    continue;
+                }
+                if (accept(pos, kind == 0 ? "" : palette_names[kind - 1]))
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void StructureDiff::ProcessBlockChanges()
+    {
+        for (size_t i = 0; i < watched_worlds.size(); ++i)
+        {
+            WatchedWorld& watched = watched_worlds[i];
+            std::shared_ptr<World> world = watched.world.lock();
+            if (!world)
+            {
+                continue;
+            }
+
+            // Events dropped because the queue was full are
+            // recovered by diffing the whole structure again
+            block_changes.clear();
+            if (!watched.queue->PopAll(block_changes) || watched.full_diff)
+            {
+                watched.full_diff = false;
+                UpdateBox(*world, start, end);
+                continue;
+            }
+
+            for (size_t j = 0; j < block_changes.size(); ++j)
+            {
+                const BlockChangeEvent& event = block_changes[j];
+                if (event.type == BlockChangeType::BlockChanged)
+                {
+                    // The new blockstate is in the event, no need to lock the world
+                    UpdateBlock(GetIndex(event.min), event.current);
+                }
+                else
+                {
+                    UpdateBox(*world,
+                        Position(std::max(start.x, event.min.x), std::max(start.y, event.min.y), std::max(start.z, event.min.z)),
+                        Position(std::min(end.x, event.max.x), std::min(end.y, event.max.y), std::min(end.z, event.max.z)));
+                }
+            }
+        }
+    }
+
+    void StructureDiff::UpdateBox(World& world, const Position& min, const Position& max)
+    {
+        Position pos;
+        for (pos.x = min.x; pos.x <= max.x; ++pos.x)
+        {
+            std::lock_guard<std::mutex> world_guard(world.GetMutex());
+            for (pos.z = min.z; pos.z <= max.z; ++pos.z)
+            {
+                // Unloaded blocks keep their last known state
+                if (!world.IsLoaded(pos))
+                {
+                    continue;
+                }
+                for (pos.y = min.y; pos.y <= max.y; ++pos.y)
+                {
+                    const Block* block = world.GetBlock(pos);
+                    UpdateBlock(GetIndex(pos), block ? block->GetBlockstate() : nullptr);
+                }
+            }
+        }
+    }
+
+    void StructureDiff::UpdateBlock(const int index, const Blockstate* blockstate)
+    {
+        // No block in a loaded chunk means air
+        const bool is_air = blockstate == nullptr || blockstate->IsAir();
+        const short target_kind = target_kinds[index];
+
+        if (target_kind == -1)
+        {
+            SetDiff(index, is_air ? BlockDiff::Correct : BlockDiff::Additional);
+        }
+        else if (is_air)
+        {
+            SetDiff(index, BlockDiff::Missing);
+        }
+        else
+        {
+            SetDiff(index, blockstate->GetName() == palette_names[target_kind - 1] ? BlockDiff::Correct : BlockDiff::Wrong);
+        }
+    }
+
+    void StructureDiff::SetDiff(const int index, const BlockDiff diff)
+    {
+        const BlockDiff previous = diffs[index];
+        if (previous == diff)
+        {
+            return;
+        }
+
+        const short target_kind = target_kinds[index];
+        const short previous_kind = GetKind(index);
+        switch (previous)
+        {
+        case BlockDiff::Unknown:
+            num_unknown -= 1;
+            break;
+        case BlockDiff::Correct:
+            num_correct -= 1;
+            break;
+        case BlockDiff::Missing:
+            num_missing -= 1;
+            num_needed[target_kind] -= 1;
+            break;
+        case BlockDiff::Wrong:
+            num_wrong -= 1;
+            num_needed[target_kind] -= 1;
+            break;
+        case BlockDiff::Additional:
+            num_additional -= 1;
+            break;
+        }
+        if (previous_kind != -1)
+        {
+            cells[GetCellIndex(GetPosition(index))][previous_kind].erase(index);
+        }
+
+        diffs[index] = diff;
+
+        const short kind = GetKind(index);
+        switch (diff)
+        {
+        case BlockDiff::Unknown:
+            num_unknown += 1;
+            break;
+        case BlockDiff::Correct:
+            num_correct += 1;
+            break;
+        case BlockDiff::Missing:
+            num_missing += 1;
+            num_needed[target_kind] += 1;
+            break;
+        case BlockDiff::Wrong:
+            num_wrong += 1;
+            num_needed[target_kind] += 1;
+            break;
+        case BlockDiff::Additional:
+            num_additional += 1;
+            break;
+        }
+        if (kind != -1)
+        {
+            cells[GetCellIndex(GetPosition(index))][kind].insert(index);
+        }
+    }
+
+    const short StructureDiff::GetKind(const int index) const
+    {
+        switch (diffs[index])
+        {
+        case BlockDiff::Missing:
+            return target_kinds[index];
+        case BlockDiff::Wrong:
+        case BlockDiff::Additional:
+            return 0;
+        default:
+            return -1;
+        }
+    }
+
+    const int StructureDiff::GetCellIndex(const Position& pos) const
+    {
+        return (((pos.x - start.x) / CELL_SIZE) * num_cells.y + (pos.y - start.y) / CELL_SIZE) * num_cells.z + (pos.z - start.z) / CELL_SIZE;
+    }
+
+    const int StructureDiff::GetIndex(const Position& pos) const
+    {
+        return ((pos.x - start.x) * size.y + pos.y - start.y) * size.z + pos.z - start.z;
+    }
+
+    const Position StructureDiff::GetPosition(const int index) const
+    {
+        return Position(index / (size.y * size.z) + start.x, (index / size.z) % size.y + start.y, index % size.z + start.z);
+    }
+} // namespace Botcraft
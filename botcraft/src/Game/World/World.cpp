@@ -8,12 +8,31 @@
 
 #include <iostream>
 #include <fstream>
+#include <algorithm>
 
 namespace Botcraft
 {
+    // Subscribers watching more chunks than that
+    // are matched against all the events
+    static const int max_indexed_subscriber_chunks = 64;
+
+    static const int ToChunkCoordinate(const int block_coordinate)
+    {
+        return (int)floor(block_coordinate / (double)CHUNK_WIDTH);
+    }
+
+    static const bool IsIndexedByChunk(const BlockChangeFilter& filter)
+    {
+        return filter.use_region &&
+            (ToChunkCoordinate(filter.max.x) - ToChunkCoordinate(filter.min.x) + 1) *
+            (ToChunkCoordinate(filter.max.z) - ToChunkCoordinate(filter.min.z) + 1) <= max_indexed_subscriber_chunks;
+    }
+
     World::World(const bool is_shared_, const bool async_handler_)
     {
         is_shared = is_shared_;
+        next_subscriber_id = 0;
+        block_changes_batch_depth = 0;
 
 #if PROTOCOL_VERSION < 719
         current_dimension = Dimension::None;
@@ -45,6 +64,42 @@ namespace Botcraft
         return is_shared;
     }
 
+    const Signal& World::GetBlockChangedSignal() const
+    {
+        return block_changed_signal;
+    }
+
+    const size_t World::SubscribeBlockChanges(const BlockChangeFilter& filter,
+        const std::function<void(const std::vector<BlockChangeEvent>&)>& callback)
+    {
+        std::lock_guard<std::mutex> world_guard(world_mutex);
+        const size_t id = next_subscriber_id++;
+        block_change_subscribers[id] = BlockChangeSubscriber{ filter, callback, nullptr };
+        IndexBlockChangeSubscriber(id, filter);
+        return id;
+    }
+
+    const size_t World::SubscribeBlockChanges(const BlockChangeFilter& filter, const std::shared_ptr<BlockChangeQueue>& queue)
+    {
+        std::lock_guard<std::mutex> world_guard(world_mutex);
+        const size_t id = next_subscriber_id++;
+        block_change_subscribers[id] = BlockChangeSubscriber{ filter, nullptr, queue };
+        IndexBlockChangeSubscriber(id, filter);
+        return id;
+    }
+
+    void World::UnsubscribeBlockChanges(const size_t id)
+    {
+        std::lock_guard<std::mutex> world_guard(world_mutex);
+        auto it = block_change_subscribers.find(id);
+        if (it == block_change_subscribers.end())
+        {
+            return;
+        }
+        UnindexBlockChangeSubscriber(id, it->second.filter);
+        block_change_subscribers.erase(it);
+    }
+
     ProtocolCraft::Handler* World::GetAsyncHandler()
     {
         if (async_handler != nullptr)
@@ -94,6 +149,10 @@ namespace Botcraft
             }
 
             UpdateChunk(x, z);
+            PushBlockChange(BlockChangeEvent{ BlockChangeType::ChunkUnloaded,
+                Position(x * CHUNK_WIDTH, WORLD_START_Y, z * CHUNK_WIDTH),
+                Position((x + 1) * CHUNK_WIDTH - 1, WORLD_END_Y - 1, (z + 1) * CHUNK_WIDTH - 1),
+                nullptr, nullptr });
             return true;
         }
 
@@ -112,6 +171,17 @@ namespace Botcraft
         return chunk->GetModifiedSinceLastRender();
     }
 
+    const std::vector<bool> World::GetChunkModifiedSections(const int x, const int z)
+    {
+        std::shared_ptr<Chunk> chunk = GetChunk(x, z);
+        if (chunk == nullptr)
+        {
+            return std::vector<bool>();
+        }
+
+        return chunk->GetModifiedSectionsSinceLastRender();
+    }
+
     void World::ResetChunkModificationState(const int x, const int z)
     {
         std::shared_ptr<Chunk> chunk = GetChunk(x, z);
@@ -123,6 +193,19 @@ namespace Botcraft
         chunk->SetModifiedSinceLastRender(false);
     }
 
+    const std::vector<Position> World::GetModifiedChunks() const
+    {
+        std::vector<Position> output;
+        for (auto it = terrain.begin(); it != terrain.end(); ++it)
+        {
+            if (it->second->GetModifiedSinceLastRender())
+            {
+                output.push_back(Position(it->first.first, 0, it->first.second));
+            }
+        }
+        return output;
+    }
+
 #endif
 
 #if PROTOCOL_VERSION < 552
@@ -142,6 +225,10 @@ namespace Botcraft
             chunk->LoadChunkData(data, primary_bit_mask);
 #endif
             UpdateChunk(x, z);
+            PushBlockChange(BlockChangeEvent{ BlockChangeType::ChunkLoaded,
+                Position(x * CHUNK_WIDTH, WORLD_START_Y, z * CHUNK_WIDTH),
+                Position((x + 1) * CHUNK_WIDTH - 1, WORLD_END_Y - 1, (z + 1) * CHUNK_WIDTH - 1),
+                nullptr, nullptr });
             return true;
         }
         return false;
@@ -174,9 +261,9 @@ namespace Botcraft
 #endif
 
 #if PROTOCOL_VERSION < 347
-    bool World::SetBlock(const Position &pos, const unsigned int id, unsigned char metadata, const int model_id)
+    bool World::SetBlock(const Position &pos, const unsigned int id, unsigned char metadata)
 #else
-    bool World::SetBlock(const Position &pos, const unsigned int id, const int model_id)
+    bool World::SetBlock(const Position &pos, const unsigned int id)
 #endif
     {
         int chunk_x = (int)floor(pos.x / (double)CHUNK_WIDTH);
@@ -200,11 +287,19 @@ namespace Botcraft
 
         const int in_chunk_x = (pos.x % CHUNK_WIDTH + CHUNK_WIDTH) % CHUNK_WIDTH;
         const int in_chunk_z = (pos.z % CHUNK_WIDTH + CHUNK_WIDTH) % CHUNK_WIDTH;
+        const Position in_chunk_pos(in_chunk_x, pos.y, in_chunk_z);
+
+        // Blockstates are only needed for the subscribers
+        const Block* previous = block_change_subscribers.empty() ? nullptr : cached->GetBlock(in_chunk_pos);
+        const Blockstate* previous_blockstate = previous ? previous->GetBlockstate() : nullptr;
 #if PROTOCOL_VERSION < 347
-        cached->SetBlock(Position(in_chunk_x, pos.y, in_chunk_z), id, metadata, model_id);
+        cached->SetBlock(in_chunk_pos, id, metadata);
 #else
-        cached->SetBlock(Position(in_chunk_x, pos.y, in_chunk_z), id, model_id);
+        cached->SetBlock(in_chunk_pos, id);
 #endif
+        const Block* current = block_change_subscribers.empty() ? nullptr : cached->GetBlock(in_chunk_pos);
+        PushBlockChange(BlockChangeEvent{ BlockChangeType::BlockChanged, pos, pos,
+            previous_blockstate, current ? current->GetBlockstate() : nullptr });
 
         if (in_chunk_x > 0 && in_chunk_x < CHUNK_WIDTH - 1 &&
             in_chunk_z > 0 && in_chunk_z < CHUNK_WIDTH - 1)
@@ -212,27 +307,36 @@ namespace Botcraft
             return true;
         }
 
-        Position update_pos;
-        if (in_chunk_x == 0)
+        // Only copy this block in the border of the neighbours,
+        // the rest of the borders didn't change
+        if (in_chunk_x == 0 || in_chunk_x == CHUNK_WIDTH - 1)
         {
-            update_pos.x = -1;
-        }
-        else if (in_chunk_x == CHUNK_WIDTH - 1)
-        {
-            update_pos.x = 1;
+            auto it = terrain.find({ in_chunk_x == 0 ? chunk_x - 1 : chunk_x + 1, chunk_z });
+            if (it != terrain.end())
+            {
+                const Position neighbour_pos(in_chunk_x == 0 ? CHUNK_WIDTH : -1, pos.y, in_chunk_z);
+#if PROTOCOL_VERSION < 347
+                it->second->SetBlock(neighbour_pos, id, metadata);
+#else
+                it->second->SetBlock(neighbour_pos, id);
+#endif
+            }
         }
 
-        if (in_chunk_z == 0)
+        if (in_chunk_z == 0 || in_chunk_z == CHUNK_WIDTH - 1)
         {
-            update_pos.z = -1;
-        }
-        else if (in_chunk_z == CHUNK_WIDTH - 1)
-        {
-            update_pos.z = 1;
+            auto it = terrain.find({ chunk_x, in_chunk_z == 0 ? chunk_z - 1 : chunk_z + 1 });
+            if (it != terrain.end())
+            {
+                const Position neighbour_pos(in_chunk_x, pos.y, in_chunk_z == 0 ? CHUNK_WIDTH : -1);
+#if PROTOCOL_VERSION < 347
+                it->second->SetBlock(neighbour_pos, id, metadata);
+#else
+                it->second->SetBlock(neighbour_pos, id);
+#endif
+            }
         }
 
-        UpdateChunk(chunk_x, chunk_z, update_pos);
-
         return true;
     }
 
@@ -553,6 +657,17 @@ namespace Botcraft
         return std::shared_ptr<const Chunk>(new Chunk(*chunk));
     }
 
+    const std::shared_ptr<const Chunk> World::GetChunkCopy(const int x, const int z, const std::vector<bool>& copied_sections)
+    {
+        std::shared_ptr<Chunk> chunk = GetChunk(x, z);
+        if (chunk == nullptr)
+        {
+            return nullptr;
+        }
+
+        return std::shared_ptr<const Chunk>(new Chunk(*chunk, copied_sections));
+    }
+
     const Block* World::GetBlock(const Position &pos)
     {
         int chunk_x = (int)floor(pos.x / (double)CHUNK_WIDTH);
@@ -576,6 +691,35 @@ namespace Botcraft
         return cached->GetBlock(Position((pos.x % CHUNK_WIDTH + CHUNK_WIDTH) % CHUNK_WIDTH, pos.y, (pos.z % CHUNK_WIDTH + CHUNK_WIDTH) % CHUNK_WIDTH));
     }
 
+    void World::GetBlockstates(const Position& min, const Position& max, std::vector<const Blockstate*>& output)
+    {
+        const int size_x = std::max(0, max.x - min.x + 1);
+        const int size_y = std::max(0, max.y - min.y + 1);
+        const int size_z = std::max(0, max.z - min.z + 1);
+
+        output.assign(size_x * size_y * size_z, nullptr);
+
+        std::lock_guard<std::mutex> world_guard(world_mutex);
+        Position pos;
+        for (int z = 0; z < size_z; ++z)
+        {
+            pos.z = min.z + z;
+            for (int x = 0; x < size_x; ++x)
+            {
+                pos.x = min.x + x;
+                for (int y = 0; y < size_y; ++y)
+                {
+                    pos.y = min.y + y;
+                    const Block* block = GetBlock(pos);
+                    if (block != nullptr)
+                    {
+                        output[(y * size_z + z) * size_x + x] = block->GetBlockstate();
+                    }
+                }
+            }
+        }
+    }
+
     const bool World::IsLoaded(const Position& pos) const
     {
         const int chunk_x = (int)floor(pos.x / (double)CHUNK_WIDTH);
@@ -744,6 +888,129 @@ namespace Botcraft
         return cached;
     }
 
+    void World::PushBlockChange(const BlockChangeEvent& event)
+    {
+        if (!block_change_subscribers.empty())
+        {
+            block_changes_batch.push_back(event);
+        }
+        if (block_changes_batch_depth == 0)
+        {
+            FlushBlockChanges();
+        }
+    }
+
+    void World::FlushBlockChanges()
+    {
+        block_changed_signal.Notify();
+        if (block_changes_batch.empty())
+        {
+            return;
+        }
+
+        // Only the subscribers of the modified chunks need to check the events
+        block_change_candidates = global_block_change_subscribers;
+        if (!chunk_block_change_subscribers.empty())
+        {
+            std::pair<int, int> previous_chunk(0, 0);
+            bool has_previous_chunk = false;
+            for (size_t i = 0; i < block_changes_batch.size(); ++i)
+            {
+                const BlockChangeEvent& event = block_changes_batch[i];
+                for (int x = ToChunkCoordinate(event.min.x); x <= ToChunkCoordinate(event.max.x); ++x)
+                {
+                    for (int z = ToChunkCoordinate(event.min.z); z <= ToChunkCoordinate(event.max.z); ++z)
+                    {
+                        // Batches are usually all in the same chunk
+                        if (has_previous_chunk && previous_chunk.first == x && previous_chunk.second == z)
+                        {
+                            continue;
+                        }
+                        previous_chunk = { x, z };
+                        has_previous_chunk = true;
+                        auto it = chunk_block_change_subscribers.find(previous_chunk);
+                        if (it != chunk_block_change_subscribers.end())
+                        {
+                            block_change_candidates.insert(block_change_candidates.end(), it->second.begin(), it->second.end());
+                        }
+                    }
+                }
+            }
+            // Keep the subscription order
+            std::sort(block_change_candidates.begin(), block_change_candidates.end());
+            block_change_candidates.erase(std::unique(block_change_candidates.begin(), block_change_candidates.end()), block_change_candidates.end());
+        }
+
+        for (size_t c = 0; c < block_change_candidates.size(); ++c)
+        {
+            const BlockChangeSubscriber& subscriber = block_change_subscribers[block_change_candidates[c]];
+            if (subscriber.queue)
+            {
+                for (size_t i = 0; i < block_changes_batch.size(); ++i)
+                {
+                    if (subscriber.filter.Match(block_changes_batch[i]))
+                    {
+                        subscriber.queue->Push(block_changes_batch[i]);
+                    }
+                }
+                continue;
+            }
+
+            filtered_block_changes.clear();
+            for (size_t i = 0; i < block_changes_batch.size(); ++i)
+            {
+                if (subscriber.filter.Match(block_changes_batch[i]))
+                {
+                    filtered_block_changes.push_back(block_changes_batch[i]);
+                }
+            }
+            if (!filtered_block_changes.empty())
+            {
+                subscriber.callback(filtered_block_changes);
+            }
+        }
+        block_changes_batch.clear();
+    }
+
+    void World::IndexBlockChangeSubscriber(const size_t id, const BlockChangeFilter& filter)
+    {
+        if (!IsIndexedByChunk(filter))
+        {
+            global_block_change_subscribers.push_back(id);
+            return;
+        }
+
+        for (int x = ToChunkCoordinate(filter.min.x); x <= ToChunkCoordinate(filter.max.x); ++x)
+        {
+            for (int z = ToChunkCoordinate(filter.min.z); z <= ToChunkCoordinate(filter.max.z); ++z)
+            {
+                chunk_block_change_subscribers[{ x, z }].push_back(id);
+            }
+        }
+    }
+
+    void World::UnindexBlockChangeSubscriber(const size_t id, const BlockChangeFilter& filter)
+    {
+        if (!IsIndexedByChunk(filter))
+        {
+            global_block_change_subscribers.erase(std::find(global_block_change_subscribers.begin(), global_block_change_subscribers.end(), id));
+            return;
+        }
+
+        for (int x = ToChunkCoordinate(filter.min.x); x <= ToChunkCoordinate(filter.max.x); ++x)
+        {
+            for (int z = ToChunkCoordinate(filter.min.z); z <= ToChunkCoordinate(filter.max.z); ++z)
+            {
+                auto it = chunk_block_change_subscribers.find({ x, z });
+                it->second.erase(std::find(it->second.begin(), it->second.end(), id));
+                if (it->second.empty())
+                {
+                    chunk_block_change_subscribers.erase(it);
+                }
+            }
+        }
+    }
+
     void World::Handle(ProtocolCraft::ClientboundLoginPacket& msg)
     {
 #if PROTOCOL_VERSION < 719
@@ -756,7 +1023,18 @@ namespace Botcraft
     void World::Handle(ProtocolCraft::ClientboundRespawnPacket& msg)
     {
         std::lock_guard<std::mutex> world_guard(world_mutex);
+        block_changes_batch_depth += 1;
+        for (auto it = terrain.begin(); it != terrain.end(); ++it)
+        {
+            PushBlockChange(BlockChangeEvent{ BlockChangeType::ChunkUnloaded,
+                Position(it->first.first * CHUNK_WIDTH, WORLD_START_Y, it->first.second * CHUNK_WIDTH),
+                Position((it->first.first + 1) * CHUNK_WIDTH - 1, WORLD_END_Y - 1, (it->first.second + 1) * CHUNK_WIDTH - 1),
+                nullptr, nullptr });
+        }
         terrain = std::map<std::pair<int, int>, std::shared_ptr<Chunk> >();
+        cached = nullptr;
+        block_changes_batch_depth -= 1;
+        FlushBlockChanges();
 
 #if PROTOCOL_VERSION < 719
         current_dimension = (Dimension)msg.GetDimension();
@@ -780,6 +1058,11 @@ namespace Botcraft
 
     void World::Handle(ProtocolCraft::ClientboundSectionBlocksUpdatePacket& msg)
     {
+        // All the changes are sent as a single batch
+        std::lock_guard<std::mutex> world_guard(world_mutex);
+        block_changes_batch_depth += 1;
+        Position min_pos(std::numeric_limits<int>::max(), std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+        Position max_pos(std::numeric_limits<int>::min(), std::numeric_limits<int>::min(), std::numeric_limits<int>::min());
 #if PROTOCOL_VERSION < 739
         for (int i = 0; i < msg.GetRecordCount(); ++i)
         {
@@ -805,21 +1088,27 @@ namespace Botcraft
 #endif
             Position cube_pos(x_pos, y_pos, z_pos);
 
-            {
-                std::lock_guard<std::mutex> world_guard(world_mutex);
 #if PROTOCOL_VERSION < 347
-                unsigned int id;
-                unsigned char metadata;
-                Blockstate::IdToIdMetadata(msg.GetRecords()[i].GetBlockId(), id, metadata);
+            unsigned int id;
+            unsigned char metadata;
+            Blockstate::IdToIdMetadata(msg.GetRecords()[i].GetBlockId(), id, metadata);
 
-                SetBlock(cube_pos, id, metadata);
+            SetBlock(cube_pos, id, metadata);
 #elif PROTOCOL_VERSION < 739
-                SetBlock(cube_pos, msg.GetRecords()[i].GetBlockId());
+            SetBlock(cube_pos, msg.GetRecords()[i].GetBlockId());
 #else
-                SetBlock(cube_pos, block_id);
+            SetBlock(cube_pos, block_id);
 #endif
-            }
+            min_pos = Position(std::min(min_pos.x, x_pos), std::min(min_pos.y, y_pos), std::min(min_pos.z, z_pos));
+            max_pos = Position(std::max(max_pos.x, x_pos), std::max(max_pos.y, y_pos), std::max(max_pos.z, z_pos));
+        }
+
+        if (min_pos.x <= max_pos.x)
+        {
+            PushBlockChange(BlockChangeEvent{ BlockChangeType::SectionChanged, min_pos, max_pos, nullptr, nullptr });
         }
+        block_changes_batch_depth -= 1;
+        FlushBlockChanges();
     }
 
     void World::Handle(ProtocolCraft::ClientboundForgetLevelChunkPacket& msg)
@@ -886,7 +1175,7 @@ namespace Botcraft
         }
     }
 
-    std::shared_ptr<Blockstate> World::Raycast(const Vector3<double> &origin, const Vector3<double> &direction,
+    const Blockstate* World::Raycast(const Vector3<double> &origin, const Vector3<double> &direction,
         const float max_radius, Position & out_pos, Position & out_normal)
     {
         // Inspired from https://gist.github.com/dogfuntom/cc881c8fc86ad43d55d8
@@ -950,10 +1239,10 @@ namespace Botcraft
 
             if (block)
             {
-                std::shared_ptr<Blockstate> blockstate = block->GetBlockstate();
+                const Blockstate* blockstate = block->GetBlockstate();
                 if (!block->GetBlockstate()->IsAir())
                 {
-                    const auto& cubes = blockstate->GetModel(block->GetModelId()).GetColliders();
+                    const auto cubes = blockstate->GetModel(blockstate->GetModelId(out_pos)).GetCollidersView();
                     for (int i = 0; i < cubes.size(); ++i)
                     {
                         const AABB current_cube = cubes[i] + out_pos;
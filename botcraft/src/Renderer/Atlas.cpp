@@ -8,29 +8,69 @@
 // rectpack2D
 #include "finders_interface.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
 #include <fstream>
+#include <random>
+#include <stdexcept>
 #include <string>
+#include <thread>
 
 namespace Botcraft
 {
     namespace Renderer
     {
-        // A basic struct to hold a named image data
+        // Must be incremented each time the layout of the cache file changes
+        static const unsigned int CACHE_FORMAT_VERSION = 1;
+
+        // A basic struct to hold a named image data, always RGBA
         struct Texture
         {
             int width;
             int height;
-            int depth;
             std::string identifier;
             bool animated;
+            Transparency transparency;
             std::vector<unsigned char> data;
+        };
 
-            const unsigned char Get(const int x, const int y, const int c) const
+        // FNV-1a 64 bits
+        const unsigned long long int HashBytes(const void* bytes, const size_t size, unsigned long long int hash = 14695981039346656037ULL)
+        {
+            const unsigned char* ptr = static_cast<const unsigned char*>(bytes);
+            for (size_t i = 0; i < size; ++i)
             {
-                return data[(y * width + x) * depth + c];
+                hash ^= ptr[i];
+                hash *= 1099511628211ULL;
             }
-        };
+            return hash;
+        }
+
+        // Signature of the textures the atlas is built from. Only
+        // paths, sizes and modification times are used, no file is read
+        const unsigned long long int ComputeTexturesSignature(const std::vector<std::pair<std::string, std::string> >& textures_path_names)
+        {
+            unsigned long long int signature = HashBytes(&CACHE_FORMAT_VERSION, sizeof(CACHE_FORMAT_VERSION));
+            std::error_code ec;
+            for (int i = 0; i < textures_path_names.size(); ++i)
+            {
+                signature = HashBytes(textures_path_names[i].first.data(), textures_path_names[i].first.size(), signature);
+                signature = HashBytes(textures_path_names[i].second.data(), textures_path_names[i].second.size(), signature);
+                const unsigned long long int size = std::filesystem::file_size(textures_path_names[i].first, ec);
+                const long long int write_time = ec ? 0 : std::filesystem::last_write_time(textures_path_names[i].first, ec).time_since_epoch().count();
+                const bool animated = std::filesystem::exists(textures_path_names[i].first + ".mcmeta", ec);
+                signature = HashBytes(&size, sizeof(size), signature);
+                signature = HashBytes(&write_time, sizeof(write_time), signature);
+                signature = HashBytes(&animated, sizeof(animated), signature);
+            }
+            return signature;
+        }
 
         Atlas::Atlas()
         {
@@ -52,24 +92,29 @@ namespace Botcraft
             textures_size_map.clear();
             textures_position_map.clear();
 
-            //Fill with "undefined" texture
-            for (int row = 0; row < height; ++row)
+            //Fill with "undefined" texture, only two
+            //different rows so they can be copied
+            std::array<std::vector<unsigned char>, 2> rows;
+            for (int i = 0; i < 2; ++i)
             {
+                rows[i] = std::vector<unsigned char>(width * 4);
                 for (int col = 0; col < width; ++col)
                 {
-                    unsigned char* pixel_pointer = Get(row, col);
-
-                    bool is_magenta = !((row % 16 < 8 && col % 16 < 8) || (row % 16 >= 8 && col % 16 >= 8));
+                    const bool is_magenta = (i == 0) != (col % 16 < 8);
 
-                    *(pixel_pointer + 0) = is_magenta ? 255 : 0;
-                    *(pixel_pointer + 1) = 0;
-                    *(pixel_pointer + 2) = is_magenta ? 255 : 0;
-                    *(pixel_pointer + 3) = 255;
+                    rows[i][4 * col + 0] = is_magenta ? 255 : 0;
+                    rows[i][4 * col + 1] = 0;
+                    rows[i][4 * col + 2] = is_magenta ? 255 : 0;
+                    rows[i][4 * col + 3] = 255;
                 }
             }
+            for (int row = 0; row < height; ++row)
+            {
+                std::copy(rows[row % 16 >= 8].begin(), rows[row % 16 >= 8].end(), Get(row, 0));
+            }
         }
 
-        void Atlas::LoadData(const std::vector<std::pair<std::string, std::string> >& textures_path_names)
+        void Atlas::LoadData(const std::vector<std::pair<std::string, std::string> >& textures_path_names, const std::string& cache_path)
         {
             if (textures_path_names.size() == 0)
             {
@@ -77,43 +122,98 @@ namespace Botcraft
                 return;
             }
 
-            std::vector<Texture> textures;
-            textures.reserve(textures_path_names.size());
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-            for (int i = 0; i < textures_path_names.size(); ++i)
+            unsigned long long int signature = 0;
+            if (!cache_path.empty())
             {
-                if (textures_path_names[i].first.empty())
+                signature = ComputeTexturesSignature(textures_path_names);
+                if (LoadCacheFile(cache_path, signature))
                 {
-                    continue;
+                    std::cout << "Atlas loaded from cache file in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms" << std::endl;
+                    return;
                 }
-                Texture tex;
-                unsigned char* data = stbi_load(textures_path_names[i].first.c_str(), &tex.width, &tex.height, &tex.depth, 0);
-                if (data != nullptr)
+            }
+
+            LoadTextures(textures_path_names);
+
+            if (!cache_path.empty())
+            {
+                const std::chrono::steady_clock::time_point write_start = std::chrono::steady_clock::now();
+                WriteCacheFile(cache_path, signature);
+                std::cout << "Atlas cache file written in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - write_start).count() << " ms" << std::endl;
+            }
+            std::cout << "Atlas loaded in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms" << std::endl;
+        }
+
+        void Atlas::LoadTextures(const std::vector<std::pair<std::string, std::string> >& textures_path_names)
+        {
+            const std::chrono::steady_clock::time_point decode_start = std::chrono::steady_clock::now();
+
+            // Decode all the textures in parallel, stb_image can
+            // be used from several threads at the same time
+            std::vector<Texture> textures(textures_path_names.size());
+            std::atomic<int> next_texture(0);
+            auto decode_textures = [&]()
+            {
+                for (int i = next_texture++; i < textures_path_names.size(); i = next_texture++)
                 {
-                    tex.data = std::vector<unsigned char>(data, data + tex.width * tex.height * tex.depth);
+                    Texture& tex = textures[i];
+                    tex.width = 0;
+                    tex.height = 0;
+                    if (textures_path_names[i].first.empty())
+                    {
+                        continue;
+                    }
+
+                    // Always ask for RGBA, stb_image converts grayscale
+                    // images to (gray, gray, gray, alpha or 255)
+                    int depth = 0;
+                    unsigned char* data = stbi_load(textures_path_names[i].first.c_str(), &tex.width, &tex.height, &depth, 4);
+                    if (data == nullptr)
+                    {
+                        tex.width = 0;
+                        tex.height = 0;
+                        continue;
+                    }
+                    tex.data = std::vector<unsigned char>(data, data + tex.width * tex.height * 4);
+                    stbi_image_free(data);
+
                     tex.identifier = textures_path_names[i].second;
                     std::ifstream animation_file((textures_path_names[i].first + ".mcmeta").c_str());
                     tex.animated = animation_file.good();
 
-                    textures.push_back(tex);
+                    tex.transparency = Transparency::Opaque;
+                    for (int p = 3; p < tex.data.size(); p += 4)
+                    {
+                        if (tex.data[p] == 0 && tex.transparency != Transparency::Partial)
+                        {
+                            tex.transparency = Transparency::Total;
+                        }
+                        else if (tex.data[p] < 255)
+                        {
+                            tex.transparency = Transparency::Partial;
+                        }
+                    }
                 }
-                stbi_image_free(data);
-            }
+            };
 
-
-            // Copy the textures with correct size (crop if it's an animated texture)
-            std::vector<Texture> kept_textures;
-            kept_textures.reserve(textures.size());
-            for (int i = 0; i < textures.size(); ++i)
+            const unsigned int num_threads = std::max(1u, std::min(std::thread::hardware_concurrency(), static_cast<unsigned int>(textures.size())));
+            std::vector<std::thread> threads;
+            for (unsigned int i = 1; i < num_threads; ++i)
             {
-                // If the depth is not good, don't keep the texture
-                if (textures[i].depth < 1 || textures[i].depth > 4)
-                {
-                    std::cout << "Warning, unknown depth format (" << textures[i].depth << ") for texture " << textures[i].identifier << std::endl;
-                    continue;
-                }
-                kept_textures.push_back(textures[i]);
+                threads.push_back(std::thread(decode_textures));
             }
+            decode_textures();
+            for (int i = 0; i < threads.size(); ++i)
+            {
+                threads[i].join();
+            }
+
+            // Remove the textures that failed to load
+            textures.erase(std::remove_if(textures.begin(), textures.end(), [](const Texture& t) { return t.data.empty(); }), textures.end());
+
+            const std::chrono::steady_clock::time_point packing_start = std::chrono::steady_clock::now();
 
             //Compute atlas dimensions using rectpack2D
             using spaces_type = rectpack2D::empty_spaces<false>;
@@ -121,9 +221,9 @@ namespace Botcraft
 
             std::vector<rect_type> rectangles;
             rectangles.emplace_back(rectpack2D::rect_xywh(0, 0, 16, 16));
-            for (int i = 0; i < kept_textures.size(); ++i)
+            for (int i = 0; i < textures.size(); ++i)
             {
-                rectangles.emplace_back(rectpack2D::rect_xywh(0, 0, kept_textures[i].width, kept_textures[i].height));
+                rectangles.emplace_back(rectpack2D::rect_xywh(0, 0, textures[i].width, textures[i].height));
             }
 
             const auto result_size = rectpack2D::find_best_packing<spaces_type>(
@@ -143,7 +243,9 @@ namespace Botcraft
                 );
 
             std::cout << "All textures packed, resultant atlas size: " << result_size.h << "x" << result_size.w << std::endl;
-            
+
+            const std::chrono::steady_clock::time_point copy_start = std::chrono::steady_clock::now();
+
             //Compute the global texture image
             Reset(result_size.h, result_size.w);
 
@@ -153,72 +255,185 @@ namespace Botcraft
             textures_size_map[""] = { rectangles[0].w, rectangles[0].h };
             textures_position_map[""] = { rectangles[0].x, rectangles[0].y };
 
-            for (int i = 0; i < kept_textures.size(); ++i)
+            for (int i = 0; i < textures.size(); ++i)
             {
                 const rect_type& rectangle = rectangles[i + 1];
-                
-                transparency_map[kept_textures[i].identifier] = Transparency::Opaque;
-                animation_map[kept_textures[i].identifier] = (kept_textures[i].animated ? Animation::Animated : Animation::Static);
-                textures_size_map[kept_textures[i].identifier] = { rectangle.w, rectangle.h };
-                textures_position_map[kept_textures[i].identifier] = { rectangle.x, rectangle.y };
 
+                transparency_map[textures[i].identifier] = textures[i].transparency;
+                animation_map[textures[i].identifier] = (textures[i].animated ? Animation::Animated : Animation::Static);
+                textures_size_map[textures[i].identifier] = { rectangle.w, rectangle.h };
+                textures_position_map[textures[i].identifier] = { rectangle.x, rectangle.y };
+
+                // Textures are RGBA like the atlas, copy them row by row
                 for (int row = 0; row < rectangle.h; ++row)
                 {
-                    for (int col = 0; col < rectangle.w; ++col)
-                    {
-                        int r = 0;
-                        int g = 0;
-                        int b = 0;
-                        int a = 0;
+                    const unsigned char* src = textures[i].data.data() + row * textures[i].width * 4;
+                    std::copy(src, src + rectangle.w * 4, Get(rectangle.y + row, rectangle.x, 0));
+                }
+            }
 
-                        switch (kept_textures[i].depth)
-                        {
-                        case 1: //Grayscale image
-                            r = kept_textures[i].Get(col, row, 0);
-                            g = kept_textures[i].Get(col, row, 0);
-                            b = kept_textures[i].Get(col, row, 0);
-                            a = 255;
-                            break;
-                        case 2: //Grayscale + Alpha image
-                            r = kept_textures[i].Get(col, row, 0);
-                            g = kept_textures[i].Get(col, row, 0);
-                            b = kept_textures[i].Get(col, row, 0);
-                            a = kept_textures[i].Get(col, row, 1);
-                            break;
-                        case 3: //RGB image
-                            r = kept_textures[i].Get(col, row, 0);
-                            g = kept_textures[i].Get(col, row, 1);
-                            b = kept_textures[i].Get(col, row, 2);
-                            a = 255;
-                            break;
-                        case 4: //RGBA image
-                            r = kept_textures[i].Get(col, row, 0);
-                            g = kept_textures[i].Get(col, row, 1);
-                            b = kept_textures[i].Get(col, row, 2);
-                            a = kept_textures[i].Get(col, row, 3);
-                            break;
-                        }
+            const std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+            std::cout << "Atlas built from " << textures.size() << " textures (decoding: "
+                << std::chrono::duration_cast<std::chrono::milliseconds>(packing_start - decode_start).count() << " ms on " << num_threads << " threads, packing: "
+                << std::chrono::duration_cast<std::chrono::milliseconds>(copy_start - packing_start).count() << " ms, copy: "
+                << std::chrono::duration_cast<std::chrono::milliseconds>(end - copy_start).count() << " ms)" << std::endl;
 
-                        *(Get(rectangle.y + row, rectangle.x + col, 0)) = r;
-                        *(Get(rectangle.y + row, rectangle.x + col, 1)) = g;
-                        *(Get(rectangle.y + row, rectangle.x + col, 2)) = b;
-                        *(Get(rectangle.y + row, rectangle.x + col, 3)) = a;
+            //In case we want to save the atlas to check the data
+            //WriteImage("atlas.png", height, width, 4, data.data(), false);
+        }
 
-                         
-                        if (a == 0 && transparency_map[kept_textures[i].identifier] != Transparency::Partial)
-                        {
-                            transparency_map[kept_textures[i].identifier] = Transparency::Total;
-                        }
-                        else if (a < 255)
-                        {
-                            transparency_map[kept_textures[i].identifier] = Transparency::Partial;
-                        }
-                    }
+        const bool Atlas::LoadCacheFile(const std::string& path, const unsigned long long int signature)
+        {
+            std::vector<char> content;
+            {
+                std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+                if (!file.is_open())
+                {
+                    return false;
+                }
+                content.resize(file.tellg());
+                file.seekg(0);
+                file.read(content.data(), content.size());
+                if (!file.good())
+                {
+                    return false;
                 }
             }
 
-            //In case we want to save the atlas to check the data
-            //WriteImage("atlas.png", height, width, 4, data.data(), false);
+            const char* iter = content.data();
+            const char* end = content.data() + content.size();
+            auto read = [&iter, end](void* output, const size_t size)
+            {
+                if (end - iter < static_cast<std::ptrdiff_t>(size))
+                {
+                    throw(std::runtime_error("Not enough input in atlas cache"));
+                }
+                std::memcpy(output, iter, size);
+                iter += size;
+            };
+
+            try
+            {
+                char magic[4];
+                read(magic, 4);
+                unsigned int format_version;
+                read(&format_version, sizeof(format_version));
+                unsigned long long int file_signature;
+                read(&file_signature, sizeof(file_signature));
+                if (std::memcmp(magic, "BCAT", 4) != 0 ||
+                    format_version != CACHE_FORMAT_VERSION ||
+                    file_signature != signature)
+                {
+                    return false;
+                }
+
+                int height_, width_;
+                read(&height_, sizeof(height_));
+                read(&width_, sizeof(width_));
+                unsigned int num_textures;
+                read(&num_textures, sizeof(num_textures));
+
+                transparency_map.clear();
+                animation_map.clear();
+                textures_size_map.clear();
+                textures_position_map.clear();
+                for (unsigned int i = 0; i < num_textures; ++i)
+                {
+                    unsigned int name_size;
+                    read(&name_size, sizeof(name_size));
+                    std::string name(name_size, ' ');
+                    read(&name[0], name_size);
+                    unsigned char transparency, animation;
+                    read(&transparency, sizeof(transparency));
+                    read(&animation, sizeof(animation));
+                    std::array<int, 4> rectangle;
+                    read(rectangle.data(), sizeof(rectangle));
+
+                    transparency_map[name] = static_cast<Transparency>(transparency);
+                    animation_map[name] = static_cast<Animation>(animation);
+                    textures_position_map[name] = { rectangle[0], rectangle[1] };
+                    textures_size_map[name] = { rectangle[2], rectangle[3] };
+                }
+
+                if (height_ <= 0 || width_ <= 0 ||
+                    end - iter != static_cast<std::ptrdiff_t>(height_) * width_ * 4 ||
+                    textures_position_map.find("") == textures_position_map.end())
+                {
+                    throw(std::runtime_error("Invalid atlas size in atlas cache"));
+                }
+                height = height_;
+                width = width_;
+                data = std::vector<unsigned char>(iter, end);
+            }
+            catch (const std::runtime_error& e)
+            {
+                std::cerr << "Error reading atlas cache file " << path << ": " << e.what() << std::endl;
+                transparency_map.clear();
+                animation_map.clear();
+                textures_size_map.clear();
+                textures_position_map.clear();
+                return false;
+            }
+
+            return true;
+        }
+
+        void Atlas::WriteCacheFile(const std::string& path, const unsigned long long int signature) const
+        {
+            std::vector<char> output;
+            auto write = [&output](const void* value, const size_t size)
+            {
+                const char* ptr = static_cast<const char*>(value);
+                output.insert(output.end(), ptr, ptr + size);
+            };
+
+            write("BCAT", 4);
+            write(&CACHE_FORMAT_VERSION, sizeof(CACHE_FORMAT_VERSION));
+            write(&signature, sizeof(signature));
+            write(&height, sizeof(height));
+            write(&width, sizeof(width));
+            const unsigned int num_textures = static_cast<unsigned int>(textures_position_map.size());
+            write(&num_textures, sizeof(num_textures));
+            for (auto it = textures_position_map.begin(); it != textures_position_map.end(); ++it)
+            {
+                const unsigned int name_size = static_cast<unsigned int>(it->first.size());
+                write(&name_size, sizeof(name_size));
+                write(it->first.data(), name_size);
+                const unsigned char transparency = static_cast<unsigned char>(transparency_map.at(it->first));
+                const unsigned char animation = static_cast<unsigned char>(animation_map.at(it->first));
+                write(&transparency, sizeof(transparency));
+                write(&animation, sizeof(animation));
+                const std::pair<int, int>& size = textures_size_map.at(it->first);
+                const std::array<int, 4> rectangle = { it->second.first, it->second.second, size.first, size.second };
+                write(rectangle.data(), sizeof(rectangle));
+            }
+            write(data.data(), data.size());
+
+            // Write to a temporary file first and then rename it, so other
+            // processes never read a partially written cache file
+            const std::string tmp_path = path + "." + std::to_string(std::random_device()()) + ".tmp";
+            {
+                std::ofstream file(tmp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+                if (file.is_open())
+                {
+                    file.write(output.data(), output.size());
+                }
+                if (!file.is_open() || !file.good())
+                {
+                    file.close();
+                    std::remove(tmp_path.c_str());
+                    std::cerr << "Error writing atlas cache file " << path << std::endl;
+                    return;
+                }
+            }
+
+            std::error_code ec;
+            std::filesystem::rename(tmp_path, path, ec);
+            if (ec)
+            {
+                std::remove(tmp_path.c_str());
+                std::cerr << "Error writing atlas cache file " << path << std::endl;
+            }
         }
 
         const int Atlas::GetWidth() const
@@ -0,0 +1,554 @@
+#include "botcraft/Renderer/ChunkMesher.hpp"
+
+#include "botcraft/Game/AssetsManager.hpp"
+#include "botcraft/Game/World/Biome.hpp"
+#include "botcraft/Game/World/Block.hpp"
+#include "botcraft/Game/World/Blockstate.hpp"
+#include "botcraft/Game/World/Chunk.hpp"
+
+#include <algorithm>
+
+namespace Botcraft
+{
+    namespace Renderer
+    {
+        // Neighbours of a block, in Orientation order
+        static const std::array<Position, 6> neighbour_positions({ Position(0, -1, 0), Position(0, 0, -1),
+                        Position(-1, 0, 0), Position(1, 0, 0), Position(0, 0, 1), Position(0, 1, 0) });
+
+        // Shape index of the empty cells in SectionMesh::mergeable_faces
+        static const unsigned int NO_SHAPE = 0xFFFFFFFF;
+        // Merged faces size is stored on 4 bits per axis
+        static const int MAX_MERGED_SIZE = 16;
+
+        ChunkMesher::ChunkMesher(const std::shared_ptr<const Atlas> atlas_, const unsigned int section_height_,
+            const bool greedy_meshing_)
+        {
+            shapes = std::make_unique<FaceShapeTable>(atlas_);
+            section_height = section_height_;
+            greedy_meshing = greedy_meshing_;
+        }
+
+        const FaceShapeTable& ChunkMesher::GetShapes() const
+        {
+            return *shapes;
+        }
+
+        const unsigned int ChunkMesher::GetSectionHeight() const
+        {
+            return section_height;
+        }
+
+        const int ChunkMesher::GetNumSections() const
+        {
+            return (CHUNK_HEIGHT + section_height - 1) / section_height;
+        }
+
+        const bool ChunkMesher::GetGreedyMeshing() const
+        {
+            return greedy_meshing;
+        }
+
+        void ChunkMesher::GetSectionsToUpdate(const std::vector<bool>& modified_sections,
+            std::vector<int>& sections_to_mesh, std::vector<bool>& required_sections) const
+        {
+            sections_to_mesh.clear();
+            required_sections = std::vector<bool>(modified_sections.size(), false);
+
+            for (int i = 0; i < GetNumSections(); ++i)
+            {
+                const int min_y = i * section_height;
+                const int max_y = std::min(CHUNK_HEIGHT, min_y + static_cast<int>(section_height)) - 1;
+
+                bool modified = false;
+                for (int y = min_y / SECTION_HEIGHT; y <= max_y / SECTION_HEIGHT; ++y)
+                {
+                    modified = modified || modified_sections[y];
+                }
+                if (!modified)
+                {
+                    continue;
+                }
+
+                sections_to_mesh.push_back(i);
+                // Blocks just above and below are needed to know which faces are hidden
+                for (int y = std::max(0, min_y - 1) / SECTION_HEIGHT; y <= std::min(CHUNK_HEIGHT - 1, max_y + 1) / SECTION_HEIGHT; ++y)
+                {
+                    required_sections[y] = true;
+                }
+            }
+        }
+
+        void ChunkMesher::MeshSection(const Botcraft::Chunk* chunk, const int chunk_x, const int chunk_z,
+            const int section_y, SectionMesh& mesh, const int lod) const
+        {
+            mesh.opaque_faces.clear();
+            mesh.transparent_faces.clear();
+            mesh.visibility = SectionVisibility(true);
+            mesh.num_block_faces = 0;
+            mesh.lod = 0;
+
+            if (chunk == nullptr)
+            {
+                return;
+            }
+
+            const int min_y = section_y * section_height;
+            const int max_y = std::min(CHUNK_HEIGHT, min_y + static_cast<int>(section_height));
+
+            mesh.opaque_blocks.assign(CHUNK_WIDTH * CHUNK_WIDTH * (max_y - min_y), false);
+
+            // Cells must fit in the section and in the face size bits
+            int lod_ = std::max(0, lod);
+            while (lod_ > 0 && ((1 << lod_) > MAX_MERGED_SIZE || (max_y - min_y) % (1 << lod_) != 0))
+            {
+                lod_ -= 1;
+            }
+            if (lod_ > 0)
+            {
+                mesh.lod = lod_;
+                MeshSectionLod(chunk, chunk_x, chunk_z, min_y, max_y, 1 << lod_, mesh);
+                mesh.visibility.Compute(mesh.opaque_blocks, max_y - min_y, mesh.visited_blocks);
+                return;
+            }
+
+            if (greedy_meshing && mesh.mergeable_faces.size() != 6 * CHUNK_WIDTH * CHUNK_WIDTH * (max_y - min_y))
+            {
+                mesh.mergeable_faces.assign(6 * CHUNK_WIDTH * CHUNK_WIDTH * (max_y - min_y), PackedFace{ 0, NO_SHAPE, { 0, 0 } });
+            }
+
+            auto& AssetsManager_ = AssetsManager::getInstance();
+
+            std::array<const Blockstate*, 6> neighbour_blockstates;
+
+            Position pos;
+            for (int y = min_y; y < max_y; ++y)
+            {
+                // Empty world sections don't have any face
+                if (!chunk->HasSection(y / SECTION_HEIGHT))
+                {
+                    y = (y / SECTION_HEIGHT + 1) * SECTION_HEIGHT - 1;
+                    continue;
+                }
+
+                pos.y = y;
+                for (int z = 0; z < CHUNK_WIDTH; ++z)
+                {
+                    pos.z = z;
+                    for (int x = 0; x < CHUNK_WIDTH; ++x)
+                    {
+                        pos.x = x;
+
+                        // If this block is air, just skip it
+                        const Block* this_block = chunk->GetBlock(pos);
+                        if (this_block == nullptr ||
+                            this_block->GetBlockstate()->IsAir())
+                        {
+                            continue;
+                        }
+                        const Blockstate* this_blockstate = this_block->GetBlockstate();
+                        mesh.opaque_blocks[x + CHUNK_WIDTH * (z + CHUNK_WIDTH * (y - min_y))] = !this_blockstate->IsTransparent();
+
+                        // Else check its neighbours to find which face to draw
+                        bool surrounded = true;
+                        for (int i = 0; i < 6; ++i)
+                        {
+                            const Block* neighbour_block = chunk->GetBlock(pos + neighbour_positions[i]);
+                            neighbour_blockstates[i] = neighbour_block == nullptr ? nullptr : neighbour_block->GetBlockstate();
+                            surrounded = surrounded && neighbour_blockstates[i] != nullptr && !neighbour_blockstates[i]->IsTransparent();
+                        }
+
+                        // If all the neighbours are non transparent blocks,
+                        // there is no face to add to the renderer
+                        if (surrounded)
+                        {
+                            continue;
+                        }
+
+                        //Add all faces of the current state
+                        const Position world_pos(pos.x + CHUNK_WIDTH * chunk_x, pos.y, pos.z + CHUNK_WIDTH * chunk_z);
+                        const std::vector<FaceDescriptor>& current_faces = this_blockstate->GetModel(this_blockstate->GetModelId(world_pos)).GetFaces();
+
+                        const Biome* current_biome = nullptr;
+                        if (this_blockstate->GetTintType() != TintType::None)
+                        {
+#if PROTOCOL_VERSION < 552
+                            current_biome = AssetsManager_.GetBiome(chunk->GetBiome(x, z));
+#else
+                            current_biome = AssetsManager_.GetBiome(chunk->GetBiome(x, y, z));
+#endif
+                        }
+
+                        for (int i = 0; i < current_faces.size(); ++i)
+                        {
+                            //Check if the neighbour in this direction is hidding this face
+                            // We also remove the faces between two transparent blocks of the same block
+                            // (example: faces between two water blocks)
+                            const Blockstate* neighbour_blockstate = current_faces[i].cullface_direction == Orientation::None ?
+                                nullptr : neighbour_blockstates[(int)current_faces[i].cullface_direction];
+                            if (current_faces[i].cullface_direction == Orientation::None ||
+                                !neighbour_blockstate ||
+                                (neighbour_blockstate->IsTransparent() &&
+                                    neighbour_blockstate->GetNameId() != this_blockstate->GetNameId())
+                                )
+                            {
+                                AddFace(pos.x, pos.y - min_y, pos.z, current_faces[i],
+                                    GetColorModifier(pos.y, current_biome, this_blockstate,
+                                        current_faces[i].use_tintindexes), mesh);
+                                mesh.num_block_faces += 1;
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (greedy_meshing)
+            {
+                MergeFaces(max_y - min_y, mesh);
+            }
+
+            mesh.visibility.Compute(mesh.opaque_blocks, max_y - min_y, mesh.visited_blocks);
+        }
+
+        void ChunkMesher::AddFace(const int x_, const int y_, const int z_, const FaceDescriptor& descriptor_,
+            const std::array<unsigned int, 2>& texture_multipliers_,
+            SectionMesh& mesh, const int size_) const
+        {
+            const FaceShape shape = shapes->Get(descriptor_);
+
+            // Opaque full sides are kept to be merged at the end
+            if (greedy_meshing && size_ == 1 && shape.full_side && shape.transparency == Transparency::Opaque)
+            {
+                const int height = static_cast<int>(mesh.mergeable_faces.size()) / (6 * CHUNK_WIDTH * CHUNK_WIDTH);
+                PackedFace& cell = mesh.mergeable_faces[((static_cast<int>(descriptor_.orientation) * height + y_) * CHUNK_WIDTH + z_) * CHUNK_WIDTH + x_];
+                cell.shape = shape.index;
+                cell.texture_multipliers = texture_multipliers_;
+                return;
+            }
+
+            PackedFace face;
+            face.position = PackFacePosition(x_, y_, z_) | PackFaceSize(size_, size_, size_);
+            face.shape = shape.index;
+            face.texture_multipliers = texture_multipliers_;
+
+            if (shape.transparency == Transparency::Partial)
+            {
+                mesh.transparent_faces.push_back(face);
+            }
+            else
+            {
+                mesh.opaque_faces.push_back(face);
+            }
+        }
+
+        void ChunkMesher::MeshSectionLod(const Botcraft::Chunk* chunk, const int chunk_x, const int chunk_z,
+            const int min_y, const int max_y, const int factor, SectionMesh& mesh) const
+        {
+            const int size_xz = CHUNK_WIDTH / factor;
+            const int size_y = (max_y - min_y) / factor;
+            // Cells of the section, surrounded by one layer of
+            // cells to know which faces are hidden
+            const int stride_z = size_xz + 2;
+            const int stride_y = stride_z * (size_xz + 2);
+            mesh.lod_cells.assign(stride_y * (size_y + 2), nullptr);
+
+            // Visible block sides at full detail, to know how many faces are saved
+            unsigned int num_block_faces = 0;
+
+            for (int cy = -1; cy <= size_y; ++cy)
+            {
+                for (int cz = -1; cz <= size_xz; ++cz)
+                {
+                    for (int cx = -1; cx <= size_xz; ++cx)
+                    {
+                        const bool outside_x = cx < 0 || cx == size_xz;
+                        const bool outside_y = cy < 0 || cy == size_y;
+                        const bool outside_z = cz < 0 || cz == size_xz;
+                        // Only the cells sharing a side with the section are needed
+                        if (outside_x + outside_y + outside_z > 1)
+                        {
+                            continue;
+                        }
+                        const bool inside = !(outside_x || outside_y || outside_z);
+
+                        // Blocks in the cell. The chunk only has one layer of
+                        // blocks of its neighbours, so outside cells are thinner
+                        const int min_x = cx < 0 ? -1 : cx * factor;
+                        const int max_x = cx < 0 ? 0 : (cx == size_xz ? CHUNK_WIDTH + 1 : (cx + 1) * factor);
+                        const int min_z = cz < 0 ? -1 : cz * factor;
+                        const int max_z = cz < 0 ? 0 : (cz == size_xz ? CHUNK_WIDTH + 1 : (cz + 1) * factor);
+                        const int cell_min_y = std::max(0, min_y + cy * factor);
+                        const int cell_max_y = std::min(CHUNK_HEIGHT, min_y + (cy + 1) * factor);
+
+                        // The cell is filled with the highest opaque block (or
+                        // the highest block if they are all transparent) if at
+                        // least half of its blocks are not air
+                        const Blockstate* top_blockstate = nullptr;
+                        const Blockstate* top_opaque_blockstate = nullptr;
+                        int num_blocks = 0;
+                        Position pos;
+                        for (int y = cell_max_y - 1; y >= cell_min_y; --y)
+                        {
+                            if (!chunk->HasSection(y / SECTION_HEIGHT))
+                            {
+                                y = (y / SECTION_HEIGHT) * SECTION_HEIGHT;
+                                continue;
+                            }
+                            pos.y = y;
+                            for (int z = min_z; z < max_z; ++z)
+                            {
+                                pos.z = z;
+                                for (int x = min_x; x < max_x; ++x)
+                                {
+                                    pos.x = x;
+                                    const Block* block = chunk->GetBlock(pos);
+                                    if (block == nullptr || block->GetBlockstate()->IsAir())
+                                    {
+                                        continue;
+                                    }
+                                    const Blockstate* blockstate = block->GetBlockstate();
+                                    num_blocks += 1;
+                                    if (top_blockstate == nullptr)
+                                    {
+                                        top_blockstate = blockstate;
+                                    }
+                                    if (top_opaque_blockstate == nullptr && !blockstate->IsTransparent())
+                                    {
+                                        top_opaque_blockstate = blockstate;
+                                    }
+
+                                    if (!inside)
+                                    {
+                                        continue;
+                                    }
+                                    mesh.opaque_blocks[x + CHUNK_WIDTH * (z + CHUNK_WIDTH * (y - min_y))] = !blockstate->IsTransparent();
+                                    for (int i = 0; i < 6; ++i)
+                                    {
+                                        const Block* neighbour_block = chunk->GetBlock(pos + neighbour_positions[i]);
+                                        if (neighbour_block == nullptr ||
+                                            (neighbour_block->GetBlockstate()->IsTransparent() &&
+                                                neighbour_block->GetBlockstate()->GetNameId() != blockstate->GetNameId()))
+                                        {
+                                            num_block_faces += 1;
+                                        }
+                                    }
+                                }
+                            }
+                        }
+
+                        const int volume = (max_x - min_x) * (cell_max_y - cell_min_y) * (max_z - min_z);
+                        if (volume > 0 && 2 * num_blocks >= volume)
+                        {
+                            mesh.lod_cells[(cx + 1) + stride_z * (cz + 1) + stride_y * (cy + 1)] =
+                                top_opaque_blockstate != nullptr ? top_opaque_blockstate : top_blockstate;
+                        }
+                    }
+                }
+            }
+
+            // Neighbour cells, in Orientation order
+            const std::array<int, 6> neighbour_cells = { -stride_y, -stride_z, -1, 1, stride_z, stride_y };
+            auto& AssetsManager_ = AssetsManager::getInstance();
+
+            for (int cy = 0; cy < size_y; ++cy)
+            {
+                for (int cz = 0; cz < size_xz; ++cz)
+                {
+                    for (int cx = 0; cx < size_xz; ++cx)
+                    {
+                        const int index = (cx + 1) + stride_z * (cz + 1) + stride_y * (cy + 1);
+                        const Blockstate* blockstate = mesh.lod_cells[index];
+                        if (blockstate == nullptr)
+                        {
+                            continue;
+                        }
+
+                        const Position cell_pos(cx * factor, min_y + cy * factor, cz * factor);
+                        const Position world_pos(cell_pos.x + CHUNK_WIDTH * chunk_x, cell_pos.y, cell_pos.z + CHUNK_WIDTH * chunk_z);
+                        const std::vector<FaceDescriptor>& current_faces = blockstate->GetModel(blockstate->GetModelId(world_pos)).GetFaces();
+
+                        const Biome* current_biome = nullptr;
+                        if (blockstate->GetTintType() != TintType::None)
+                        {
+#if PROTOCOL_VERSION < 552
+                            current_biome = AssetsManager_.GetBiome(chunk->GetBiome(cell_pos.x, cell_pos.z));
+#else
+                            current_biome = AssetsManager_.GetBiome(chunk->GetBiome(cell_pos.x, cell_pos.y, cell_pos.z));
+#endif
+                        }
+
+                        // Same culling as for the blocks, but with the cells. Only
+                        // the faces on the sides of the block are stretched over the cell
+                        for (int i = 0; i < current_faces.size(); ++i)
+                        {
+                            if (current_faces[i].cullface_direction == Orientation::None)
+                            {
+                                continue;
+                            }
+                            const Blockstate* neighbour_blockstate = mesh.lod_cells[index + neighbour_cells[static_cast<int>(current_faces[i].cullface_direction)]];
+                            if (!neighbour_blockstate ||
+                                (neighbour_blockstate->IsTransparent() &&
+                                    neighbour_blockstate->GetNameId() != blockstate->GetNameId()))
+                            {
+                                AddFace(cell_pos.x, cell_pos.y - min_y, cell_pos.z, current_faces[i],
+                                    GetColorModifier(cell_pos.y, current_biome, blockstate,
+                                        current_faces[i].use_tintindexes), mesh, factor);
+                            }
+                        }
+                    }
+                }
+            }
+
+            mesh.num_block_faces = num_block_faces;
+        }
+
+        void ChunkMesher::MergeFaces(const int height, SectionMesh& mesh) const
+        {
+            // Block coordinates (x, y, z) of the faces of each orientation
+            // are iterated as (u, v, w), with w along the face normal
+            // Bottom, North, West, East, South, Top
+            static const std::array<std::array<int, 3>, 6> u_axis = { { {1, 0, 0}, {1, 0, 0}, {0, 0, 1}, {0, 0, 1}, {1, 0, 0}, {1, 0, 0} } };
+            static const std::array<std::array<int, 3>, 6> v_axis = { { {0, 0, 1}, {0, 1, 0}, {0, 1, 0}, {0, 1, 0}, {0, 1, 0}, {0, 0, 1} } };
+
+            const std::array<int, 3> dims = { CHUNK_WIDTH, height, CHUNK_WIDTH };
+
+            for (int o = 0; o < 6; ++o)
+            {
+                PackedFace* cells = mesh.mergeable_faces.data() + o * height * CHUNK_WIDTH * CHUNK_WIDTH;
+                const std::array<int, 3>& u = u_axis[o];
+                const std::array<int, 3>& v = v_axis[o];
+                const int size_u = std::min(MAX_MERGED_SIZE, dims[0] * u[0] + dims[1] * u[1] + dims[2] * u[2]);
+                const int size_v = std::min(MAX_MERGED_SIZE, dims[0] * v[0] + dims[1] * v[1] + dims[2] * v[2]);
+                // Strides of u and v in cells
+                const int stride_u = u[0] + u[1] * CHUNK_WIDTH * CHUNK_WIDTH + u[2] * CHUNK_WIDTH;
+                const int stride_v = v[0] + v[1] * CHUNK_WIDTH * CHUNK_WIDTH + v[2] * CHUNK_WIDTH;
+
+                for (int y = 0; y < height; ++y)
+                {
+                    for (int z = 0; z < CHUNK_WIDTH; ++z)
+                    {
+                        for (int x = 0; x < CHUNK_WIDTH; ++x)
+                        {
+                            PackedFace& start = cells[(y * CHUNK_WIDTH + z) * CHUNK_WIDTH + x];
+                            if (start.shape == NO_SHAPE)
+                            {
+                                continue;
+                            }
+
+                            auto same_face = [&start](const PackedFace& other)
+                            {
+                                return other.shape == start.shape && other.texture_multipliers == start.texture_multipliers;
+                            };
+
+                            // Position of the start along u and v
+                            const int start_u = x * u[0] + y * u[1] + z * u[2];
+                            const int start_v = x * v[0] + y * v[1] + z * v[2];
+                            const int max_u = std::min(size_u, (dims[0] * u[0] + dims[1] * u[1] + dims[2] * u[2]) - start_u);
+                            const int max_v = std::min(size_v, (dims[0] * v[0] + dims[1] * v[1] + dims[2] * v[2]) - start_v);
+
+                            // Extend along u as far as possible, then along v
+                            // while the whole row is the same face
+                            int length_u = 1;
+                            while (length_u < max_u && same_face(*(&start + length_u * stride_u)))
+                            {
+                                length_u += 1;
+                            }
+                            int length_v = 1;
+                            while (length_v < max_v)
+                            {
+                                bool same_row = true;
+                                for (int i = 0; i < length_u && same_row; ++i)
+                                {
+                                    same_row = same_face(*(&start + i * stride_u + length_v * stride_v));
+                                }
+                                if (!same_row)
+                                {
+                                    break;
+                                }
+                                length_v += 1;
+                            }
+
+                            PackedFace face;
+                            face.position = PackFacePosition(x, y, z) |
+                                PackFaceSize(1 + (length_u - 1) * u[0] + (length_v - 1) * v[0],
+                                    1 + (length_u - 1) * u[1] + (length_v - 1) * v[1],
+                                    1 + (length_u - 1) * u[2] + (length_v - 1) * v[2]);
+                            face.shape = start.shape;
+                            face.texture_multipliers = start.texture_multipliers;
+                            mesh.opaque_faces.push_back(face);
+
+                            // Empty the merged cells for the next mesh
+                            for (int j = 0; j < length_v; ++j)
+                            {
+                                for (int i = 0; i < length_u; ++i)
+                                {
+                                    (&start + i * stride_u + j * stride_v)->shape = NO_SHAPE;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        const std::array<unsigned int, 2> ChunkMesher::GetColorModifier(const int y, const Biome* biome, const Blockstate* blockstate, const std::vector<bool>& use_tintindex) const
+        {
+            std::array<unsigned int, 2> texture_modifier = { 0xFFFFFFFF, 0xFFFFFFFF };
+            for (int i = 0; i < std::min(2, (int)use_tintindex.size()); ++i)
+            {
+                switch (blockstate->GetTintType())
+                {
+                case TintType::None:
+                    break;
+                case TintType::Grass:
+                    if (use_tintindex[i])
+                    {
+                        if (biome)
+                        {
+                            texture_modifier[i] = biome->GetColorMultiplier(y, true);
+                        }
+                    }
+                    break;
+                case TintType::Leaves:
+                    if (use_tintindex[i])
+                    {
+                        if (biome)
+                        {
+                            texture_modifier[i] = biome->GetColorMultiplier(y, false);
+                        }
+                    }
+                    break;
+                    //Something like black when signal strength is 0 and red when it's 15
+                case TintType::Redstone:
+#if PROTOCOL_VERSION == 340 // 1.12.2
+                    texture_modifier[i] = 0xFF000000 | (25 + 15 * blockstate->GetMetadata());
+#elif PROTOCOL_VERSION == 393 // 1.13
+                    texture_modifier[i] = 0xFF000000 | (25 + 15 * (((blockstate->GetId() - 1752) / 9) % 16));
+#elif PROTOCOL_VERSION == 401 || PROTOCOL_VERSION == 404 // 1.13.1 && 1.13.2
+                    texture_modifier[i] = 0xFF000000 | (25 + 15 * (((blockstate->GetId() - 1753) / 9) % 16));
+#elif PROTOCOL_VERSION == 477 || PROTOCOL_VERSION == 480 || PROTOCOL_VERSION == 485 || PROTOCOL_VERSION == 490 || PROTOCOL_VERSION == 498 // 1.14.X
+                    texture_modifier[i] = 0xFF000000 | (25 + 15 * (((blockstate->GetId() - 2056) / 9) % 16));
+#elif PROTOCOL_VERSION == 573 || PROTOCOL_VERSION == 575 || PROTOCOL_VERSION == 578 // 1.15.X
+                    texture_modifier[i] = 0xFF000000 | (25 + 15 * (((blockstate->GetId() - 2056) / 9) % 16));
+#elif PROTOCOL_VERSION == 735 || PROTOCOL_VERSION == 736 || PROTOCOL_VERSION == 751 || PROTOCOL_VERSION == 753  || PROTOCOL_VERSION == 754 // 1.16.X
+                    texture_modifier[i] = 0xFF000000 | (25 + 15 * (((blockstate->GetId() - 2058) / 9) % 16));
+#elif PROTOCOL_VERSION == 755 || PROTOCOL_VERSION == 756 // 1.17.X
+                    texture_modifier[i] = 0xFF000000 | (25 + 15 * (((blockstate->GetId() - 2114) / 9) % 16));
+#else
+                    #error "Protocol version not implemented"
+#endif
+                    break;
+                case TintType::Water:
+                    if (biome)
+                    {
+                        texture_modifier[i] = biome->GetWaterColorMultiplier();
+                    }
+                    break;
+                default:
+                    break;
+                }
+            }
+            return texture_modifier;
+        }
+    } // Renderer
+} // Botcraft
@@ -145,6 +145,11 @@ namespace Botcraft
             return texture_coords;
         }
 
+        const unsigned int Face::GetTextureData() const
+        {
+            return texture_data;
+        }
+
         void Face::SetTextureCoords(const std::array<float, 4>& coords, const bool overlay)
         {
             if (overlay)
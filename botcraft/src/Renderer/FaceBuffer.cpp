@@ -0,0 +1,229 @@
+#include <glad/glad.h>
+
+#include "botcraft/Renderer/FaceBuffer.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace Botcraft
+{
+    namespace Renderer
+    {
+        // Initial size of the face buffer, 1MB
+        static const unsigned int INITIAL_FACE_CAPACITY = 65536;
+        // Number of vec4 texels used to store one shape
+        // (4 matrix columns, texture coords, overlay coords, texture data)
+        static const unsigned int TEXELS_PER_SHAPE = 7;
+        // Initial number of shapes the texture buffer can store
+        static const size_t INITIAL_SHAPE_CAPACITY = 1024;
+
+        FaceBuffer::FaceBuffer()
+        {
+            data_VBO = 0;
+            shapes_TBO = 0;
+            num_shapes = 0;
+            shapes_capacity = 0;
+            section_origin_location = -1;
+            uploaded_bytes = 0;
+
+            glGenVertexArrays(1, &faces_VAO);
+            glGenBuffers(1, &base_face_VBO);
+
+            //Buffer for the base face (x,y,z)
+            glBindVertexArray(faces_VAO);
+            glBindBuffer(GL_ARRAY_BUFFER, base_face_VBO);
+            glBufferData(GL_ARRAY_BUFFER, Face::base_face.size() * sizeof(float), Face::base_face.data(), GL_STATIC_DRAW);
+
+            //(x, y, z) for base face
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+
+            //(position) for one face
+            glEnableVertexAttribArray(1);
+            //Specify that only one instance of this must be sent to one index
+            glVertexAttribDivisor(1, 1);
+
+            //(shape) for one face
+            glEnableVertexAttribArray(2);
+            glVertexAttribDivisor(2, 1);
+
+            //(texture_multiplier, texture_multiplier_overlay) for one face
+            glEnableVertexAttribArray(3);
+            glVertexAttribDivisor(3, 1);
+
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            glBindVertexArray(0);
+
+            Grow(INITIAL_FACE_CAPACITY);
+
+            glGenTextures(1, &shapes_texture);
+            GrowShapes(INITIAL_SHAPE_CAPACITY);
+        }
+
+        FaceBuffer::~FaceBuffer()
+        {
+            glDeleteTextures(1, &shapes_texture);
+            glDeleteBuffers(1, &shapes_TBO);
+            glDeleteBuffers(1, &data_VBO);
+            glDeleteBuffers(1, &base_face_VBO);
+            glDeleteVertexArrays(1, &faces_VAO);
+        }
+
+        void FaceBuffer::UpdateShapes(const FaceShapeTable& shapes)
+        {
+            if (shapes.Size() <= num_shapes)
+            {
+                return;
+            }
+
+            std::vector<Face> new_faces;
+            shapes.GetFaces(num_shapes, new_faces);
+
+            std::vector<float> new_data;
+            new_data.reserve(new_faces.size() * TEXELS_PER_SHAPE * 4);
+            for (int i = 0; i < new_faces.size(); ++i)
+            {
+                const std::array<float, 16>& matrix = new_faces[i].GetMatrix();
+                new_data.insert(new_data.end(), matrix.begin(), matrix.end());
+                const std::array<float, 4>& coords = new_faces[i].GetTextureCoords(false);
+                new_data.insert(new_data.end(), coords.begin(), coords.end());
+                const std::array<float, 4>& coords_overlay = new_faces[i].GetTextureCoords(true);
+                new_data.insert(new_data.end(), coords_overlay.begin(), coords_overlay.end());
+                new_data.push_back(static_cast<float>(new_faces[i].GetTextureData()));
+                new_data.push_back(0.0f);
+                new_data.push_back(0.0f);
+                new_data.push_back(0.0f);
+            }
+
+            if (num_shapes + new_faces.size() > shapes_capacity)
+            {
+                GrowShapes(std::max(2 * shapes_capacity, num_shapes + new_faces.size()));
+            }
+
+            // Only the new shapes are sent, the previous ones don't change
+            glBindBuffer(GL_TEXTURE_BUFFER, shapes_TBO);
+            glBufferSubData(GL_TEXTURE_BUFFER, num_shapes * TEXELS_PER_SHAPE * 4 * sizeof(float), new_data.size() * sizeof(float), new_data.data());
+            glBindBuffer(GL_TEXTURE_BUFFER, 0);
+            uploaded_bytes += new_data.size() * sizeof(float);
+            num_shapes += new_faces.size();
+        }
+
+        void FaceBuffer::Upload(const std::vector<PackedFace>& faces, FaceAllocation& allocation)
+        {
+            const unsigned int num_faces = static_cast<unsigned int>(faces.size());
+            if (num_faces == 0)
+            {
+                allocator.Free(allocation);
+                return;
+            }
+
+            // Move the faces if they don't fit anymore, or if
+            // they use only a small part of their range
+            if (!allocator.Resize(num_faces, allocation))
+            {
+                // Double the capacity, the new free space is merged with the
+                // free range at the end of the buffer (if any), so it's
+                // always enough for this allocation
+                Grow(allocator.GetCapacity() + std::max(allocator.GetCapacity(), 2 * num_faces + 64));
+                allocator.Allocate(num_faces, allocation);
+            }
+
+            glBindBuffer(GL_ARRAY_BUFFER, data_VBO);
+            glBufferSubData(GL_ARRAY_BUFFER, allocation.offset * sizeof(PackedFace), num_faces * sizeof(PackedFace), faces.data());
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            uploaded_bytes += num_faces * sizeof(PackedFace);
+        }
+
+        void FaceBuffer::Bind(const unsigned int program)
+        {
+            glBindVertexArray(faces_VAO);
+            // Per face attributes pointers are set in Draw
+            glBindBuffer(GL_ARRAY_BUFFER, data_VBO);
+
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_BUFFER, shapes_texture);
+            glActiveTexture(GL_TEXTURE0);
+
+            section_origin_location = glGetUniformLocation(program, "section_origin");
+        }
+
+        void FaceBuffer::Draw(const FaceAllocation& allocation, const unsigned int num_faces, const glm::vec3& origin) const
+        {
+            if (num_faces == 0)
+            {
+                return;
+            }
+
+            // Without glDrawArraysInstancedBaseInstance (OpenGL 4.2), the
+            // instance attributes are pointed to the range of the section
+            const size_t offset = allocation.offset * sizeof(PackedFace);
+            glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, sizeof(PackedFace), (void*)(offset + offsetof(PackedFace, position)));
+            glVertexAttribIPointer(2, 1, GL_UNSIGNED_INT, sizeof(PackedFace), (void*)(offset + offsetof(PackedFace, shape)));
+            glVertexAttribIPointer(3, 2, GL_UNSIGNED_INT, sizeof(PackedFace), (void*)(offset + offsetof(PackedFace, texture_multipliers)));
+
+            glUniform3f(section_origin_location, origin.x, origin.y, origin.z);
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, num_faces);
+        }
+
+        const size_t FaceBuffer::GetUploadedBytes() const
+        {
+            return uploaded_bytes;
+        }
+
+        void FaceBuffer::ResetUploadedBytes()
+        {
+            uploaded_bytes = 0;
+        }
+
+        const size_t FaceBuffer::GetAllocatedBytes() const
+        {
+            return allocator.GetCapacity() * sizeof(PackedFace) + shapes_capacity * TEXELS_PER_SHAPE * 4 * sizeof(float);
+        }
+
+        void FaceBuffer::Grow(const unsigned int new_capacity)
+        {
+            unsigned int new_VBO;
+            glGenBuffers(1, &new_VBO);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, new_VBO);
+            glBufferData(GL_COPY_WRITE_BUFFER, new_capacity * sizeof(PackedFace), nullptr, GL_DYNAMIC_DRAW);
+
+            if (data_VBO)
+            {
+                glBindBuffer(GL_COPY_READ_BUFFER, data_VBO);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, allocator.GetCapacity() * sizeof(PackedFace));
+                glBindBuffer(GL_COPY_READ_BUFFER, 0);
+                glDeleteBuffers(1, &data_VBO);
+            }
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+            data_VBO = new_VBO;
+            allocator.Grow(new_capacity);
+        }
+
+        void FaceBuffer::GrowShapes(const size_t new_capacity)
+        {
+            const size_t shape_bytes = TEXELS_PER_SHAPE * 4 * sizeof(float);
+
+            unsigned int new_TBO;
+            glGenBuffers(1, &new_TBO);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, new_TBO);
+            glBufferData(GL_COPY_WRITE_BUFFER, new_capacity * shape_bytes, nullptr, GL_DYNAMIC_DRAW);
+
+            if (shapes_TBO)
+            {
+                glBindBuffer(GL_COPY_READ_BUFFER, shapes_TBO);
+                glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, num_shapes * shape_bytes);
+                glBindBuffer(GL_COPY_READ_BUFFER, 0);
+                glDeleteBuffers(1, &shapes_TBO);
+            }
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+            shapes_TBO = new_TBO;
+            shapes_capacity = new_capacity;
+
+            glBindTexture(GL_TEXTURE_BUFFER, shapes_texture);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, shapes_TBO);
+            glBindTexture(GL_TEXTURE_BUFFER, 0);
+        }
+    } // Renderer
+} // Botcraft
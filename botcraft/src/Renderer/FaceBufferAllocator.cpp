@@ -0,0 +1,133 @@
+#include "botcraft/Renderer/FaceBufferAllocator.hpp"
+
+#include <algorithm>
+
+namespace Botcraft
+{
+    namespace Renderer
+    {
+        // Allocations are a multiple of this number of faces
+        static const unsigned int ALLOCATION_GRANULARITY = 64;
+
+        FaceBufferAllocator::FaceBufferAllocator(const unsigned int capacity_)
+        {
+            capacity = 0;
+            used = 0;
+            Grow(capacity_);
+        }
+
+        const bool FaceBufferAllocator::Allocate(const unsigned int num_faces, FaceAllocation& allocation)
+        {
+            // 25% extra space for the next updates
+            const unsigned int size = ((num_faces + num_faces / 4) / ALLOCATION_GRANULARITY + 1) * ALLOCATION_GRANULARITY;
+
+            // Best fit to keep the big ranges for the big sections
+            auto selected = free_ranges.end();
+            for (auto it = free_ranges.begin(); it != free_ranges.end(); ++it)
+            {
+                if (it->second >= size && (selected == free_ranges.end() || it->second < selected->second))
+                {
+                    selected = it;
+                    if (it->second == size)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            if (selected == free_ranges.end())
+            {
+                return false;
+            }
+
+            allocation.offset = selected->first;
+            allocation.size = size;
+            if (selected->second > size)
+            {
+                free_ranges[selected->first + size] = selected->second - size;
+            }
+            free_ranges.erase(selected);
+            used += size;
+
+            return true;
+        }
+
+        const bool FaceBufferAllocator::Resize(const unsigned int num_faces, FaceAllocation& allocation)
+        {
+            if (num_faces <= allocation.size && num_faces >= allocation.size / 4)
+            {
+                return true;
+            }
+
+            Free(allocation);
+            return Allocate(num_faces, allocation);
+        }
+
+        void FaceBufferAllocator::Free(FaceAllocation& allocation)
+        {
+            if (allocation.size == 0)
+            {
+                return;
+            }
+
+            used -= allocation.size;
+            auto it = free_ranges.insert({ allocation.offset, allocation.size }).first;
+
+            // Merge with the next range
+            auto next = std::next(it);
+            if (next != free_ranges.end() && it->first + it->second == next->first)
+            {
+                it->second += next->second;
+                free_ranges.erase(next);
+            }
+            // Merge with the previous range
+            if (it != free_ranges.begin())
+            {
+                auto previous = std::prev(it);
+                if (previous->first + previous->second == it->first)
+                {
+                    previous->second += it->second;
+                    free_ranges.erase(it);
+                }
+            }
+
+            allocation = FaceAllocation();
+        }
+
+        void FaceBufferAllocator::Grow(const unsigned int new_capacity)
+        {
+            if (new_capacity <= capacity)
+            {
+                return;
+            }
+
+            FaceAllocation added;
+            added.offset = capacity;
+            added.size = new_capacity - capacity;
+            capacity = new_capacity;
+            // Freeing the new space merges it with the last free range
+            used += added.size;
+            Free(added);
+        }
+
+        const unsigned int FaceBufferAllocator::GetCapacity() const
+        {
+            return capacity;
+        }
+
+        const unsigned int FaceBufferAllocator::GetUsed() const
+        {
+            return used;
+        }
+
+        const unsigned int FaceBufferAllocator::GetLargestFreeRange() const
+        {
+            unsigned int largest = 0;
+            for (auto it = free_ranges.begin(); it != free_ranges.end(); ++it)
+            {
+                largest = std::max(largest, it->second);
+            }
+            return largest;
+        }
+    } // Renderer
+} // Botcraft
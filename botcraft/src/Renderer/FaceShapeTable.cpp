@@ -0,0 +1,150 @@
+#include "botcraft/Renderer/FaceShapeTable.hpp"
+
+#include "botcraft/Game/Model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace Botcraft
+{
+    namespace Renderer
+    {
+        FaceShapeTable::FaceShapeTable(const std::shared_ptr<const Atlas> atlas_)
+        {
+            atlas = atlas_;
+        }
+
+        const FaceShape FaceShapeTable::Get(const FaceDescriptor& descriptor)
+        {
+            {
+                std::shared_lock<std::shared_mutex> read_lock(shapes_mutex);
+                auto it = shapes.find(&descriptor);
+                if (it != shapes.end())
+                {
+                    return it->second;
+                }
+            }
+
+            FaceShape shape;
+            const Face face = ResolveTextures(descriptor, shape.transparency);
+
+            // Same computation as the shader, with base face center (0, -1, 0)
+            const std::array<float, 16>& matrix = face.GetMatrix();
+            const glm::vec3 center(matrix[12] - matrix[4] + 0.5f, matrix[13] - matrix[5] + 0.5f, matrix[14] - matrix[6] + 0.5f);
+
+            // A face is a full side if all the corners of the base face
+            // are transformed to corners of the block
+            shape.full_side = descriptor.cullface_direction != Orientation::None &&
+                descriptor.cullface_direction == descriptor.orientation;
+            for (int i = 0; i < 4 && shape.full_side; ++i)
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    float coord = matrix[12 + j];
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        coord += matrix[4 * k + j] * Face::base_face[3 * i + k];
+                    }
+                    if (std::abs(std::abs(coord) - 0.5f) > 0.001f)
+                    {
+                        shape.full_side = false;
+                        break;
+                    }
+                }
+            }
+
+            std::unique_lock<std::shared_mutex> write_lock(shapes_mutex);
+            // Another thread may have added it in the meantime
+            auto it = shapes.find(&descriptor);
+            if (it != shapes.end())
+            {
+                return it->second;
+            }
+            shape.index = static_cast<unsigned int>(faces.size());
+            faces.push_back(face);
+            centers.push_back(center);
+            shapes[&descriptor] = shape;
+
+            return shape;
+        }
+
+        const size_t FaceShapeTable::Size() const
+        {
+            std::shared_lock<std::shared_mutex> read_lock(shapes_mutex);
+            return faces.size();
+        }
+
+        void FaceShapeTable::GetFaces(const size_t start, std::vector<Face>& output) const
+        {
+            std::shared_lock<std::shared_mutex> read_lock(shapes_mutex);
+            if (start < faces.size())
+            {
+                output.insert(output.end(), faces.begin() + start, faces.end());
+            }
+        }
+
+        void FaceShapeTable::GetCenters(const size_t start, std::vector<glm::vec3>& output) const
+        {
+            std::shared_lock<std::shared_mutex> read_lock(shapes_mutex);
+            if (start < centers.size())
+            {
+                output.insert(output.end(), centers.begin() + start, centers.end());
+            }
+        }
+
+        const Face FaceShapeTable::ResolveTextures(const FaceDescriptor& descriptor, Transparency& transparency) const
+        {
+            const std::vector<std::string>& texture_identifiers_ = descriptor.texture_names;
+
+            std::array<unsigned short, 4> atlas_pos = { 0 };
+            std::array<unsigned short, 4> atlas_size = { 0 };
+            std::array<Transparency, 2> transparencies = { Transparency::Opaque };
+            std::array<Animation, 2> animated = { Animation::Static };
+
+            for (int i = 0; i < std::min(2, (int)texture_identifiers_.size()); ++i)
+            {
+                const std::pair<int, int>& atlas_coords = atlas->GetPosition(texture_identifiers_[i]);
+                atlas_pos[2 * i + 0] = atlas_coords.first;
+                atlas_pos[2 * i + 1] = atlas_coords.second;
+                const std::pair<int, int>& atlas_dims = atlas->GetSize(texture_identifiers_[i]);
+                atlas_size[2 * i + 0] = atlas_dims.first;
+                atlas_size[2 * i + 1] = atlas_dims.second;
+                transparencies[i] = atlas->GetTransparency(texture_identifiers_[i]);
+                animated[i] = atlas->GetAnimation(texture_identifiers_[i]);
+            }
+
+            Face face(descriptor.face);
+            face.SetTextureMultipliers({ 0xFFFFFFFF, 0xFFFFFFFF });
+
+            std::array<float, 4> coords = face.GetTextureCoords(false);
+            unsigned short height_normalizer = animated[0] == Animation::Animated ? atlas_size[0] : atlas_size[1];
+            for (int i = 0; i < 2; ++i)
+            {
+                coords[2 * i + 0] = (atlas_pos[0] + coords[2 * i + 0] / 16.0f * atlas_size[0]) / atlas->GetWidth();
+                coords[2 * i + 1] = (atlas_pos[1] + coords[2 * i + 1] / 16.0f * height_normalizer) / atlas->GetHeight();
+            }
+            face.SetTextureCoords(coords, false);
+
+            if (texture_identifiers_.size() > 1)
+            {
+                coords = face.GetTextureCoords(true);
+                height_normalizer = animated[1] == Animation::Animated ? atlas_size[2] : atlas_size[3];
+                for (int i = 0; i < 2; ++i)
+                {
+                    coords[2 * i + 0] = (atlas_pos[2] + coords[2 * i + 0] / 16.0f * atlas_size[2]) / atlas->GetWidth();
+                    coords[2 * i + 1] = (atlas_pos[3] + coords[2 * i + 1] / 16.0f * height_normalizer) / atlas->GetHeight();
+                }
+                face.SetTextureCoords(coords, true);
+            }
+
+            transparency = transparencies[0];
+            if (transparency == Transparency::Opaque)
+            {
+                face.SetDisplayBackface(false);
+            }
+
+            return face;
+        }
+    } // Renderer
+} // Botcraft
@@ -0,0 +1,104 @@
+#include "botcraft/Renderer/FaceSorter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace Botcraft
+{
+    namespace Renderer
+    {
+        // Distances are quantized to 1/64 block on 16 bits, faces
+        // further than 1024 blocks are all at the same distance
+        static const float DISTANCE_PRECISION = 64.0f;
+
+        // Stable LSD radix sort of indices by 16 bits keys, 8 bits per pass
+        static void RadixSort(const std::vector<unsigned short>& keys, std::vector<unsigned int>& indices, std::vector<unsigned int>& tmp)
+        {
+            const unsigned int n = static_cast<unsigned int>(keys.size());
+            indices.resize(n);
+            tmp.resize(n);
+            for (unsigned int i = 0; i < n; ++i)
+            {
+                indices[i] = i;
+            }
+
+            for (int shift = 0; shift < 16; shift += 8)
+            {
+                std::array<unsigned int, 257> offsets = { 0 };
+                for (unsigned int i = 0; i < n; ++i)
+                {
+                    offsets[((keys[i] >> shift) & 0xFF) + 1]++;
+                }
+                for (int i = 0; i < 256; ++i)
+                {
+                    offsets[i + 1] += offsets[i];
+                }
+                for (unsigned int i = 0; i < n; ++i)
+                {
+                    tmp[offsets[(keys[indices[i]] >> shift) & 0xFF]++] = indices[i];
+                }
+                indices.swap(tmp);
+            }
+        }
+
+        FaceSorter::FaceSorter()
+        {
+
+        }
+
+        void FaceSorter::ComputeCenters(const std::vector<PackedFace>& faces,
+            const std::vector<glm::vec3>& shape_centers, std::vector<glm::vec3>& centers)
+        {
+            centers.resize(faces.size());
+            for (int i = 0; i < faces.size(); ++i)
+            {
+                const unsigned int position = faces[i].position;
+                const glm::vec3& shape_center = shape_centers[faces[i].shape];
+                // Same as the shader, the vertices on the positive side of the block
+                // center are moved by size - 1 (bits 17-20, 21-24 and 25-28). The part
+                // of the face that moves is given by where its center is in the block
+                const glm::vec3 stretch(static_cast<float>((position >> 17) & 0x0F),
+                    static_cast<float>((position >> 21) & 0x0F),
+                    static_cast<float>((position >> 25) & 0x0F));
+                const glm::vec3 moved(std::max(0.0f, std::min(1.0f, shape_center.x)),
+                    std::max(0.0f, std::min(1.0f, shape_center.y)),
+                    std::max(0.0f, std::min(1.0f, shape_center.z)));
+                centers[i] = UnpackFacePosition(position) + shape_center + stretch * moved;
+            }
+        }
+
+        void FaceSorter::Sort(const glm::vec3& relative_cam_pos, std::vector<PackedFace>& faces, std::vector<glm::vec3>& centers)
+        {
+            const size_t num_faces = faces.size();
+
+            // Far faces first, so the keys are reversed
+            sort_keys.resize(num_faces);
+            for (int i = 0; i < num_faces; ++i)
+            {
+                const glm::vec3 delta = relative_cam_pos - centers[i];
+                const float distance = std::sqrt(delta.x * delta.x + delta.y * delta.y + delta.z * delta.z);
+                sort_keys[i] = 0xFFFF - static_cast<unsigned short>(std::min(65535.0f, distance * DISTANCE_PRECISION));
+            }
+            RadixSort(sort_keys, sort_indices, sort_indices_tmp);
+
+            sorted_faces.resize(num_faces);
+            sorted_centers.resize(num_faces);
+            for (int i = 0; i < num_faces; ++i)
+            {
+                sorted_faces[i] = faces[sort_indices[i]];
+                sorted_centers[i] = centers[sort_indices[i]];
+            }
+            faces.swap(sorted_faces);
+            centers.swap(sorted_centers);
+        }
+
+        const size_t FaceSorter::GetCPUBytes() const
+        {
+            return sorted_faces.capacity() * sizeof(PackedFace) +
+                sorted_centers.capacity() * sizeof(glm::vec3) +
+                sort_keys.capacity() * sizeof(unsigned short) +
+                (sort_indices.capacity() + sort_indices_tmp.capacity()) * sizeof(unsigned int);
+        }
+    } // Renderer
+} // Botcraft
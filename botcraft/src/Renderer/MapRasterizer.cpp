@@ -0,0 +1,654 @@
+#include "botcraft/Renderer/MapRasterizer.hpp"
+#include "botcraft/Renderer/ImageSaver.hpp"
+
+#include "botcraft/Game/AssetsManager.hpp"
+#include "botcraft/Game/World/Biome.hpp"
+#include "botcraft/Game/World/Block.hpp"
+#include "botcraft/Game/World/Blockstate.hpp"
+#include "botcraft/Game/World/World.hpp"
+
+#include <stb_image/stb_image.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Botcraft
+{
+    namespace Renderer
+    {
+        // Brightness of the map pixels, depending on the
+        // height difference with the northern block
+        static const unsigned int BRIGHTNESS_LOW = 180;
+        static const unsigned int BRIGHTNESS_NORMAL = 220;
+        static const unsigned int BRIGHTNESS_HIGH = 255;
+
+        const unsigned int MultiplyColors(const unsigned int a, const unsigned int b)
+        {
+            unsigned int output = 0xFF000000;
+            for (int i = 0; i < 24; i += 8)
+            {
+                output |= ((((a >> i) & 0xFF) * ((b >> i) & 0xFF) / 255) << i);
+            }
+            return output;
+        }
+
+        // Mean color (0xAABBGGRR) of the pixels of a texture file, weighted
+        // by their alpha. Alpha is the mean alpha, 0 if the file can't be read
+        const unsigned int LoadTextureColor(const std::string& path)
+        {
+            int width, height, depth;
+            unsigned char* data = stbi_load(path.c_str(), &width, &height, &depth, 4);
+            if (data == nullptr)
+            {
+                return 0;
+            }
+
+            unsigned long long int sum[4] = { 0, 0, 0, 0 };
+            for (int i = 0; i < width * height; ++i)
+            {
+                const unsigned char* pixel = data + 4 * i;
+                for (int c = 0; c < 3; ++c)
+                {
+                    sum[c] += pixel[c] * pixel[3];
+                }
+                sum[3] += pixel[3];
+            }
+            stbi_image_free(data);
+
+            if (sum[3] == 0)
+            {
+                return 0;
+            }
+            unsigned int output = static_cast<unsigned int>(sum[3] / (width * height)) << 24;
+            for (int c = 0; c < 3; ++c)
+            {
+                output |= static_cast<unsigned int>(sum[c] / sum[3]) << (8 * c);
+            }
+            return output;
+        }
+
+        // Color of a blockstate, from the texture of its top face. texture_colors
+        // is filled with the colors of the textures already loaded. A color of 0
+        // means the block is not drawn, the block below is used instead
+        const std::pair<unsigned int, TintType> ComputeBlockstateColor(const Blockstate* blockstate,
+            const std::unordered_map<std::string, std::string>& texture_paths,
+            std::unordered_map<std::string, unsigned int>& texture_colors)
+        {
+            // Flowers, torches, rails... are not visible
+            if (blockstate->GetNumModels() == 0 ||
+                (!blockstate->IsFluid() && !blockstate->IsSolid() && blockstate->IsTransparent()))
+            {
+                return { 0, TintType::None };
+            }
+
+            const std::vector<FaceDescriptor>& faces = blockstate->GetModel(0).GetFaces();
+            if (faces.empty())
+            {
+                return { 0, TintType::None };
+            }
+            const FaceDescriptor* face = &faces[0];
+            for (int i = 0; i < faces.size(); ++i)
+            {
+                if (faces[i].orientation == Orientation::Top)
+                {
+                    face = &faces[i];
+                    break;
+                }
+            }
+
+            const std::string& texture = face->texture_names[0];
+            auto it = texture_colors.find(texture);
+            if (it == texture_colors.end())
+            {
+                auto path = texture_paths.find(texture);
+                it = texture_colors.insert({ texture, path == texture_paths.end() ? 0 : LoadTextureColor(path->second) }).first;
+            }
+
+            // Mostly transparent textures (glass...) are not visible either
+            if ((it->second >> 24) < 128)
+            {
+                return { 0, TintType::None };
+            }
+
+            // Fluids are always tinted, other blocks only if the face is
+            const bool tinted = blockstate->IsFluid() || (!face->use_tintindexes.empty() && face->use_tintindexes[0]);
+            return { 0xFF000000 | it->second, tinted ? blockstate->GetTintType() : TintType::None };
+        }
+
+        MapRasterizer::MapRasterizer(const std::shared_ptr<World>& world_, const unsigned int num_threads)
+        {
+            world = world_;
+
+            const AssetsManager& assets_manager = AssetsManager::getInstance();
+            const std::vector<std::pair<std::string, std::string> > textures_paths_names = assets_manager.GetTexturesPathsNames();
+            std::unordered_map<std::string, std::string> texture_paths;
+            for (int i = 0; i < textures_paths_names.size(); ++i)
+            {
+                texture_paths[textures_paths_names[i].second] = textures_paths_names[i].first;
+            }
+            std::unordered_map<std::string, unsigned int> texture_colors;
+#if PROTOCOL_VERSION < 347
+            for (auto it = assets_manager.Blockstates().begin(); it != assets_manager.Blockstates().end(); ++it)
+            {
+                for (auto it2 = it->second.begin(); it2 != it->second.end(); ++it2)
+                {
+                    if (it2->second->IsAir())
+                    {
+                        continue;
+                    }
+                    const std::pair<unsigned int, TintType> color = ComputeBlockstateColor(it2->second.get(), texture_paths, texture_colors);
+                    if (color.first != 0)
+                    {
+                        blockstate_colors[it2->second.get()] = color;
+                    }
+                }
+            }
+#else
+            for (auto it = assets_manager.Blockstates().begin(); it != assets_manager.Blockstates().end(); ++it)
+            {
+                if (it->second->IsAir())
+                {
+                    continue;
+                }
+                const std::pair<unsigned int, TintType> color = ComputeBlockstateColor(it->second.get(), texture_paths, texture_colors);
+                if (color.first != 0)
+                {
+                    blockstate_colors[it->second.get()] = color;
+                }
+            }
+#endif
+
+            // Section changes also send one event per block
+            BlockChangeFilter filter;
+            filter.types = static_cast<unsigned char>(BlockChangeType::ChunkLoaded) |
+                static_cast<unsigned char>(BlockChangeType::ChunkUnloaded) |
+                static_cast<unsigned char>(BlockChangeType::BlockChanged);
+            block_changes = std::make_shared<BlockChangeQueue>();
+            subscription_id = world->SubscribeBlockChanges(filter, block_changes);
+            // The chunks already loaded are added at the first Update
+            should_resynchronize = true;
+
+            running = true;
+            num_running_jobs = 0;
+            // The thread calling RunJobs also processes jobs
+            const unsigned int num_workers = (num_threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : num_threads) - 1;
+            for (unsigned int i = 0; i < num_workers; ++i)
+            {
+                threads.push_back(std::thread(&MapRasterizer::ProcessJobs, this));
+            }
+        }
+
+        MapRasterizer::~MapRasterizer()
+        {
+            world->UnsubscribeBlockChanges(subscription_id);
+
+            {
+                std::lock_guard<std::mutex> guard_jobs(mutex_jobs);
+                running = false;
+                jobs.clear();
+            }
+            condition_jobs.notify_all();
+            for (int i = 0; i < threads.size(); ++i)
+            {
+                if (threads[i].joinable())
+                {
+                    threads[i].join();
+                }
+            }
+        }
+
+        const int MapRasterizer::Update()
+        {
+            std::lock_guard<std::mutex> map_guard(map_mutex);
+
+            events.clear();
+            // If some events have been dropped, get the loaded chunks from the world
+            if (!block_changes->PopAll(events) || should_resynchronize)
+            {
+                Resynchronize();
+                should_resynchronize = false;
+            }
+
+            for (int i = 0; i < events.size(); ++i)
+            {
+                const BlockChangeEvent& event = events[i];
+                const int min_chunk_x = static_cast<int>(std::floor(event.min.x / static_cast<double>(CHUNK_WIDTH)));
+                const int max_chunk_x = static_cast<int>(std::floor(event.max.x / static_cast<double>(CHUNK_WIDTH)));
+                const int min_chunk_z = static_cast<int>(std::floor(event.min.z / static_cast<double>(CHUNK_WIDTH)));
+                const int max_chunk_z = static_cast<int>(std::floor(event.max.z / static_cast<double>(CHUNK_WIDTH)));
+                for (int chunk_z = min_chunk_z; chunk_z <= max_chunk_z; ++chunk_z)
+                {
+                    for (int chunk_x = min_chunk_x; chunk_x <= max_chunk_x; ++chunk_x)
+                    {
+                        const Position chunk_pos(chunk_x, 0, chunk_z);
+                        auto it = chunks.find(chunk_pos);
+                        switch (event.type)
+                        {
+                        case BlockChangeType::ChunkLoaded:
+                            if (it == chunks.end())
+                            {
+                                it = chunks.insert({ chunk_pos, std::make_unique<MapChunk>() }).first;
+                            }
+                            MarkModified(*it->second, chunk_x, chunk_z, event.min, event.max);
+                            // Make sure the columns are scanned, even if the chunk was already there
+                            it->second->lowest_modified_y = WORLD_START_Y;
+                            break;
+                        case BlockChangeType::ChunkUnloaded:
+                            if (it != chunks.end())
+                            {
+                                chunks.erase(it);
+                                modified_chunks.insert(chunk_pos);
+                                modified_chunks.insert(chunk_pos + Position(0, 0, 1));
+                            }
+                            break;
+                        case BlockChangeType::BlockChanged:
+                            if (it != chunks.end())
+                            {
+                                MarkModified(*it->second, chunk_x, chunk_z, event.min, event.max);
+                            }
+                            break;
+                        default:
+                            break;
+                        }
+                    }
+                }
+            }
+
+            std::vector<std::function<void()> > scan_jobs;
+            for (auto it = chunks.begin(); it != chunks.end(); ++it)
+            {
+                if (!it->second->modified)
+                {
+                    continue;
+                }
+                MapChunk* map_chunk = it->second.get();
+                const int chunk_x = it->first.x;
+                const int chunk_z = it->first.z;
+                scan_jobs.push_back([this, chunk_x, chunk_z, map_chunk]() { ScanChunk(chunk_x, chunk_z, *map_chunk); });
+                // The shading of the southern chunk depends on this one
+                modified_chunks.insert(it->first);
+                modified_chunks.insert(it->first + Position(0, 0, 1));
+            }
+
+            RunJobs(scan_jobs);
+
+            return static_cast<int>(scan_jobs.size());
+        }
+
+        void MapRasterizer::Rasterize(const int min_chunk_x, const int min_chunk_z, const int max_chunk_x, const int max_chunk_z,
+            std::vector<unsigned char>& output) const
+        {
+            std::lock_guard<std::mutex> map_guard(map_mutex);
+            RasterizeImpl(min_chunk_x, min_chunk_z, max_chunk_x, max_chunk_z, output);
+        }
+
+        void MapRasterizer::WriteTile(const std::string& path, const int min_chunk_x, const int min_chunk_z, const int max_chunk_x, const int max_chunk_z) const
+        {
+            std::vector<unsigned char> pixels;
+            Rasterize(min_chunk_x, min_chunk_z, max_chunk_x, max_chunk_z, pixels);
+            WriteImage(path, (max_chunk_z - min_chunk_z + 1) * CHUNK_WIDTH, (max_chunk_x - min_chunk_x + 1) * CHUNK_WIDTH, 4, pixels.data(), false);
+        }
+
+        const int MapRasterizer::WriteModifiedTiles(const std::string& folder, const int tile_size)
+        {
+            std::lock_guard<std::mutex> map_guard(map_mutex);
+
+            std::unordered_set<Position> tiles;
+            for (auto it = modified_chunks.begin(); it != modified_chunks.end(); ++it)
+            {
+                tiles.insert(Position(static_cast<int>(std::floor(it->x / static_cast<double>(tile_size))), 0,
+                    static_cast<int>(std::floor(it->z / static_cast<double>(tile_size)))));
+            }
+            modified_chunks.clear();
+
+            // Images are computed in parallel, but written one at
+            // a time as stb_image_write uses a global flip setting
+            std::vector<Position> tiles_positions(tiles.begin(), tiles.end());
+            std::vector<std::vector<unsigned char> > tiles_pixels(tiles_positions.size());
+            std::vector<std::function<void()> > rasterize_jobs;
+            for (int i = 0; i < tiles_positions.size(); ++i)
+            {
+                rasterize_jobs.push_back([this, i, tile_size, &tiles_positions, &tiles_pixels]()
+                    {
+                        const Position& tile = tiles_positions[i];
+                        RasterizeImpl(tile.x * tile_size, tile.z * tile_size, (tile.x + 1) * tile_size - 1, (tile.z + 1) * tile_size - 1, tiles_pixels[i]);
+                    });
+            }
+            RunJobs(rasterize_jobs);
+
+            for (int i = 0; i < tiles_positions.size(); ++i)
+            {
+                WriteImage(folder + "/" + std::to_string(tiles_positions[i].x) + "_" + std::to_string(tiles_positions[i].z) + ".png",
+                    tile_size * CHUNK_WIDTH, tile_size * CHUNK_WIDTH, 4, tiles_pixels[i].data(), false);
+            }
+
+            return static_cast<int>(tiles_positions.size());
+        }
+
+        void MapRasterizer::MarkModified(MapChunk& chunk, const int chunk_x, const int chunk_z, const Position& min, const Position& max)
+        {
+            const int min_x = std::max(0, min.x - chunk_x * CHUNK_WIDTH);
+            const int max_x = std::min(CHUNK_WIDTH - 1, max.x - chunk_x * CHUNK_WIDTH);
+            const int min_z = std::max(0, min.z - chunk_z * CHUNK_WIDTH);
+            const int max_z = std::min(CHUNK_WIDTH - 1, max.z - chunk_z * CHUNK_WIDTH);
+            for (int z = min_z; z <= max_z; ++z)
+            {
+                for (int x = min_x; x <= max_x; ++x)
+                {
+                    const int index = z * CHUNK_WIDTH + x;
+                    // Blocks below the surface don't change the map
+                    if (chunk.modified_columns[index] || max.y >= chunk.columns[index].floor)
+                    {
+                        chunk.modified_columns[index] = true;
+                        chunk.lowest_modified_y = std::min(chunk.lowest_modified_y, std::min(min.y, static_cast<int>(chunk.columns[index].floor)));
+                        chunk.modified = true;
+                    }
+                }
+            }
+        }
+
+        void MapRasterizer::Resynchronize()
+        {
+            std::unordered_set<Position> loaded_chunks;
+            {
+                std::lock_guard<std::mutex> world_guard(world->GetMutex());
+                const std::map<std::pair<int, int>, std::shared_ptr<Chunk> >& all_chunks = world->GetAllChunks();
+                for (auto it = all_chunks.begin(); it != all_chunks.end(); ++it)
+                {
+                    loaded_chunks.insert(Position(it->first.first, 0, it->first.second));
+                }
+            }
+
+            for (auto it = chunks.begin(); it != chunks.end();)
+            {
+                if (loaded_chunks.find(it->first) == loaded_chunks.end())
+                {
+                    modified_chunks.insert(it->first);
+                    modified_chunks.insert(it->first + Position(0, 0, 1));
+                    it = chunks.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+
+            for (auto it = loaded_chunks.begin(); it != loaded_chunks.end(); ++it)
+            {
+                std::unique_ptr<MapChunk>& map_chunk = chunks[*it];
+                if (!map_chunk)
+                {
+                    map_chunk = std::make_unique<MapChunk>();
+                }
+                map_chunk->modified_columns.fill(true);
+                map_chunk->modified = true;
+                map_chunk->lowest_modified_y = WORLD_START_Y;
+            }
+
+            // Events received before are not needed anymore
+            events.clear();
+        }
+
+        void MapRasterizer::ScanChunk(const int chunk_x, const int chunk_z, MapChunk& map_chunk)
+        {
+            // Only copy the sections that can contain the new
+            // surface, plus one more for the removed blocks
+            int lowest_section = std::max(0, (map_chunk.lowest_modified_y - WORLD_START_Y) / SECTION_HEIGHT - 1);
+            bool complete = false;
+            while (!complete)
+            {
+                std::vector<bool> copied_sections(CHUNK_HEIGHT / SECTION_HEIGHT, false);
+                std::fill(copied_sections.begin() + lowest_section, copied_sections.end(), true);
+
+                std::shared_ptr<const Chunk> chunk;
+                {
+                    std::lock_guard<std::mutex> world_guard(world->GetMutex());
+                    chunk = world->GetChunkCopy(chunk_x, chunk_z, copied_sections);
+                }
+
+                complete = true;
+                for (int i = 0; i < map_chunk.columns.size(); ++i)
+                {
+                    if (!map_chunk.modified_columns[i])
+                    {
+                        continue;
+                    }
+
+                    if (chunk == nullptr)
+                    {
+                        // The chunk has been unloaded, the event
+                        // will be processed at the next Update
+                        map_chunk.columns[i] = MapColumn{ 0, -1, WORLD_START_Y, 0 };
+                    }
+                    else if (!ScanColumn(*chunk, i % CHUNK_WIDTH, i / CHUNK_WIDTH, WORLD_START_Y + lowest_section * SECTION_HEIGHT, map_chunk.columns[i]))
+                    {
+                        complete = false;
+                        continue;
+                    }
+                    map_chunk.modified_columns[i] = false;
+                }
+
+                // Some columns have their surface below the copied sections
+                lowest_section = 0;
+            }
+
+            map_chunk.modified = false;
+            map_chunk.lowest_modified_y = WORLD_END_Y;
+        }
+
+        const bool MapRasterizer::ScanColumn(const Chunk& chunk, const int x, const int z, const int min_y, MapColumn& column) const
+        {
+            int water_surface = -1;
+            unsigned int water_color = 0;
+            for (int y = WORLD_END_Y - 1; y >= min_y; --y)
+            {
+                const Block* block = chunk.GetBlock(Position(x, y - WORLD_START_Y, z));
+                if (block == nullptr || block->GetBlockstate() == nullptr)
+                {
+                    continue;
+                }
+                auto it = blockstate_colors.find(block->GetBlockstate());
+                if (it == blockstate_colors.end())
+                {
+                    continue;
+                }
+
+                // Water color is used for the whole depth
+                if (it->second.second == TintType::Water)
+                {
+                    if (water_surface == -1)
+                    {
+                        water_surface = y;
+                        water_color = GetColor(chunk, x, y, z, it->second);
+                    }
+                    continue;
+                }
+
+                if (water_surface != -1)
+                {
+                    column = MapColumn{ water_color, static_cast<short>(water_surface), static_cast<short>(y),
+                        static_cast<unsigned char>(std::min(255, water_surface - y)) };
+                }
+                else
+                {
+                    column = MapColumn{ GetColor(chunk, x, y, z, it->second), static_cast<short>(y), static_cast<short>(y), 0 };
+                }
+                return true;
+            }
+
+            // Reached the bottom of the copied sections
+            if (min_y > WORLD_START_Y)
+            {
+                return false;
+            }
+
+            if (water_surface != -1)
+            {
+                column = MapColumn{ water_color, static_cast<short>(water_surface), static_cast<short>(WORLD_START_Y),
+                    static_cast<unsigned char>(std::min(255, water_surface - WORLD_START_Y + 1)) };
+            }
+            else
+            {
+                column = MapColumn{ 0, -1, WORLD_START_Y, 0 };
+            }
+            return true;
+        }
+
+        const unsigned int MapRasterizer::GetColor(const Chunk& chunk, const int x, const int y, const int z,
+            const std::pair<unsigned int, TintType> & block_color) const
+        {
+            if (block_color.second == TintType::None)
+            {
+                return block_color.first;
+            }
+
+#if PROTOCOL_VERSION < 552
+            const Biome* biome = AssetsManager::getInstance().GetBiome(chunk.GetBiome(x, z));
+#else
+            const Biome* biome = AssetsManager::getInstance().GetBiome(chunk.GetBiome(x, y - WORLD_START_Y, z));
+#endif
+            if (biome == nullptr)
+            {
+                return block_color.first;
+            }
+
+            // Tinted textures are grayscale, except
+            // the water before 1.13, like in the renderer
+            switch (block_color.second)
+            {
+            case TintType::Grass:
+                return MultiplyColors(block_color.first, biome->GetColorMultiplier(y, true));
+            case TintType::Leaves:
+                return MultiplyColors(block_color.first, biome->GetColorMultiplier(y, false));
+            case TintType::Water:
+                return MultiplyColors(block_color.first, biome->GetWaterColorMultiplier());
+            default:
+                return block_color.first;
+            }
+        }
+
+        void MapRasterizer::RasterizeImpl(const int min_chunk_x, const int min_chunk_z, const int max_chunk_x, const int max_chunk_z,
+            std::vector<unsigned char>& output) const
+        {
+            const int width = std::max(0, max_chunk_x - min_chunk_x + 1) * CHUNK_WIDTH;
+            const int height = std::max(0, max_chunk_z - min_chunk_z + 1) * CHUNK_WIDTH;
+            output.assign(width * height * 4, 0);
+
+            for (int chunk_z = min_chunk_z; chunk_z <= max_chunk_z; ++chunk_z)
+            {
+                for (int chunk_x = min_chunk_x; chunk_x <= max_chunk_x; ++chunk_x)
+                {
+                    auto it = chunks.find(Position(chunk_x, 0, chunk_z));
+                    if (it == chunks.end())
+                    {
+                        continue;
+                    }
+                    const MapChunk& map_chunk = *it->second;
+                    auto north_it = chunks.find(Position(chunk_x, 0, chunk_z - 1));
+                    const MapChunk* north_chunk = north_it == chunks.end() ? nullptr : north_it->second.get();
+
+                    for (int z = 0; z < CHUNK_WIDTH; ++z)
+                    {
+                        unsigned char* row = output.data() + (((chunk_z - min_chunk_z) * CHUNK_WIDTH + z) * width + (chunk_x - min_chunk_x) * CHUNK_WIDTH) * 4;
+                        for (int x = 0; x < CHUNK_WIDTH; ++x)
+                        {
+                            const MapColumn& column = map_chunk.columns[z * CHUNK_WIDTH + x];
+                            if (column.color == 0)
+                            {
+                                continue;
+                            }
+
+                            // Same shading as the in-game maps, with a checkerboard
+                            // dithering on the flat areas and in the water
+                            const int checker = (chunk_x * CHUNK_WIDTH + x + chunk_z * CHUNK_WIDTH + z) & 1;
+                            unsigned int brightness = BRIGHTNESS_NORMAL;
+                            if (column.water_depth > 0)
+                            {
+                                const float shade = column.water_depth * 0.1f + checker * 0.2f;
+                                brightness = shade < 0.5f ? BRIGHTNESS_HIGH : (shade > 0.9f ? BRIGHTNESS_LOW : BRIGHTNESS_NORMAL);
+                            }
+                            else
+                            {
+                                int north_height = column.height;
+                                if (z > 0)
+                                {
+                                    north_height = map_chunk.columns[(z - 1) * CHUNK_WIDTH + x].height;
+                                }
+                                else if (north_chunk != nullptr)
+                                {
+                                    north_height = north_chunk->columns[(CHUNK_WIDTH - 1) * CHUNK_WIDTH + x].height;
+                                }
+                                if (north_height < 0)
+                                {
+                                    north_height = column.height;
+                                }
+                                const float shade = (column.height - north_height) * 0.8f + (checker - 0.5f) * 0.4f;
+                                brightness = shade > 0.6f ? BRIGHTNESS_HIGH : (shade < -0.6f ? BRIGHTNESS_LOW : BRIGHTNESS_NORMAL);
+                            }
+
+                            row[4 * x + 0] = (column.color & 0xFF) * brightness / 255;
+                            row[4 * x + 1] = ((column.color >> 8) & 0xFF) * brightness / 255;
+                            row[4 * x + 2] = ((column.color >> 16) & 0xFF) * brightness / 255;
+                            row[4 * x + 3] = 255;
+                        }
+                    }
+                }
+            }
+        }
+
+        void MapRasterizer::RunJobs(std::vector<std::function<void()> >& jobs_)
+        {
+            if (jobs_.empty())
+            {
+                return;
+            }
+
+            {
+                std::lock_guard<std::mutex> guard_jobs(mutex_jobs);
+                jobs.insert(jobs.end(), jobs_.begin(), jobs_.end());
+            }
+            condition_jobs.notify_all();
+
+            // Help the workers instead of just waiting
+            std::unique_lock<std::mutex> lck(mutex_jobs);
+            while (!jobs.empty())
+            {
+                std::function<void()> job = std::move(jobs.front());
+                jobs.pop_front();
+                num_running_jobs += 1;
+                lck.unlock();
+                job();
+                lck.lock();
+                num_running_jobs -= 1;
+            }
+            condition_done.wait(lck, [this]() { return num_running_jobs == 0; });
+        }
+
+        void MapRasterizer::ProcessJobs()
+        {
+            while (true)
+            {
+                std::function<void()> job;
+                {
+                    std::unique_lock<std::mutex> lck(mutex_jobs);
+                    condition_jobs.wait(lck, [this]() { return !running || !jobs.empty(); });
+                    if (!running)
+                    {
+                        return;
+                    }
+                    job = std::move(jobs.front());
+                    jobs.pop_front();
+                    num_running_jobs += 1;
+                }
+
+                job();
+
+                {
+                    std::lock_guard<std::mutex> guard_jobs(mutex_jobs);
+                    num_running_jobs -= 1;
+                }
+                condition_done.notify_all();
+            }
+        }
+    } // Renderer
+} // Botcraft
@@ -0,0 +1,129 @@
+#include "botcraft/Renderer/MemoryBudget.hpp"
+
+#include "botcraft/Game/World/Chunk.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace Botcraft
+{
+    namespace Renderer
+    {
+        MemoryBudget::MemoryBudget()
+        {
+            budget = 0;
+            eviction_distance = std::numeric_limits<float>::max();
+            has_room = false;
+        }
+
+        void MemoryBudget::SetBudget(const size_t bytes)
+        {
+            budget = bytes;
+            if (budget == 0)
+            {
+                eviction_distance = std::numeric_limits<float>::max();
+            }
+        }
+
+        const size_t MemoryBudget::GetBudget() const
+        {
+            return budget;
+        }
+
+        const bool MemoryBudget::Update(const size_t used_bytes)
+        {
+            if (budget == 0)
+            {
+                return false;
+            }
+
+            // Let the sections come back slowly when there is some room again
+            has_room = used_bytes < budget / 4 * 3;
+            return used_bytes > budget;
+        }
+
+        void MemoryBudget::Evict(const size_t used_bytes, std::vector<SectionMemory>& sections, std::vector<Position>& evicted)
+        {
+            std::sort(sections.begin(), sections.end(), [](const SectionMemory& s1, const SectionMemory& s2) { return s1.distance > s2.distance; });
+
+            // Drop the furthest sections until there is a bit of room
+            // left, so it's not done again as soon as a section is added
+            size_t remaining_bytes = used_bytes;
+            for (int i = 0; i < sections.size() && remaining_bytes > budget / 10 * 9; ++i)
+            {
+                remaining_bytes -= std::min(remaining_bytes, sections[i].bytes);
+                evicted_sections.insert(sections[i].section);
+                evicted.push_back(sections[i].section);
+                eviction_distance = sections[i].distance;
+            }
+        }
+
+        const bool MemoryBudget::KeepMesh(const Position& section, const float distance, const bool has_faces)
+        {
+            if (budget == 0)
+            {
+                return true;
+            }
+
+            if (distance >= eviction_distance && has_faces)
+            {
+                evicted_sections.insert(section);
+                return false;
+            }
+
+            evicted_sections.erase(section);
+            return true;
+        }
+
+        void MemoryBudget::GetSectionsToRestore(const std::function<float(const Position&)>& distance_to_camera, std::vector<Position>& sections)
+        {
+            sections.clear();
+            if (evicted_sections.empty())
+            {
+                eviction_distance = std::numeric_limits<float>::max();
+                return;
+            }
+            if (has_room)
+            {
+                eviction_distance += CHUNK_WIDTH;
+                has_room = false;
+            }
+
+            for (auto it = evicted_sections.begin(); it != evicted_sections.end();)
+            {
+                // Keep a margin so sections at the limit are not
+                // restored and dropped again at each frame
+                if (distance_to_camera(*it) < eviction_distance - CHUNK_WIDTH)
+                {
+                    sections.push_back(*it);
+                    it = evicted_sections.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+        }
+
+        void MemoryBudget::Clear()
+        {
+            evicted_sections.clear();
+            eviction_distance = std::numeric_limits<float>::max();
+        }
+
+        const bool MemoryBudget::IsEvicted(const Position& section) const
+        {
+            return evicted_sections.find(section) != evicted_sections.end();
+        }
+
+        const size_t MemoryBudget::GetNumEvicted() const
+        {
+            return evicted_sections.size();
+        }
+
+        const float MemoryBudget::GetEvictionDistance() const
+        {
+            return eviction_distance;
+        }
+    } // Renderer
+} // Botcraft
@@ -7,6 +7,9 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <unordered_set>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 
 #ifdef USE_IMGUI
 #include <imgui.h>
@@ -21,6 +24,7 @@ static bool imgui_demo = false;
 #include "botcraft/Renderer/WorldRenderer.hpp"
 #include "botcraft/Renderer/Camera.hpp"
 #include "botcraft/Renderer/Chunk.hpp"
+#include "botcraft/Renderer/ChunkMesher.hpp"
 #include "botcraft/Renderer/TransparentChunk.hpp"
 
 #include "botcraft/Game/AssetsManager.hpp"
@@ -41,7 +45,8 @@ namespace Botcraft
         RenderingManager::RenderingManager(std::shared_ptr<World> world_, std::shared_ptr<InventoryManager> inventory_manager_,
             const unsigned int &window_width, const unsigned int &window_height,
             const std::vector<std::pair<std::string, std::string> > &textures_path_names,
-            const unsigned int section_height_, const bool headless)
+            const unsigned int section_height_, const bool headless,
+            const bool greedy_meshing)
         {
             world = world_;
             inventory_manager = inventory_manager_;
@@ -64,19 +69,67 @@ namespace Botcraft
             MouseCallback = [](double, double) {};
             KeyboardCallback = [](std::array<bool, (int)KEY_CODE::NUMBER_OF_KEYS>, float) {};
 
-            world_renderer = std::unique_ptr<WorldRenderer>(new WorldRenderer(section_height_, textures_path_names));
+            world_renderer = std::unique_ptr<WorldRenderer>(new WorldRenderer(section_height_, textures_path_names, greedy_meshing));
 
             take_screenshot = false;
 
             day_time = 0.0f;
 
             running = true;
+            meshing_version = 0;
+            num_running_meshing_jobs = 0;
+            memory_stats = MemoryStats{ 0, 0, 0, 0, 0, 0 };
+            meshed_sections = 0;
+            meshed_block_faces = 0;
+            meshed_rendered_faces = 0;
+            meshing_time = 0;
+            for (int i = 0; i < NUM_LOD_LEVELS; ++i)
+            {
+                meshed_lod_sections[i] = 0;
+                meshed_lod_block_faces[i] = 0;
+                meshed_lod_rendered_faces[i] = 0;
+            }
+            lod_distances = { 64.0f, 128.0f };
+            lod_hysteresis = 8.0f;
+            lods_should_be_updated = true;
+
+            // World changes wake up the update thread, it then finds the
+            // chunks to mesh again from the world sections modification
+            // flags, so changes made directly on the world are rendered too
+            BlockChangeFilter block_changes_filter;
+            block_changes_filter.types = static_cast<unsigned char>(BlockChangeType::ChunkLoaded) |
+                static_cast<unsigned char>(BlockChangeType::ChunkUnloaded) |
+                static_cast<unsigned char>(BlockChangeType::BlockChanged);
+            block_changes_subscriber_id = world->SubscribeBlockChanges(block_changes_filter,
+                [this](const std::vector<BlockChangeEvent>& events) { OnBlockChanges(events); });
+
             rendering_thread = std::thread(&RenderingManager::Run, this, headless);
             thread_updating_chunks = std::thread(&RenderingManager::WaitForRenderingUpdate, this);
+            // Keep one core for the other threads
+            const unsigned int num_meshing_threads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+            for (unsigned int i = 0; i < num_meshing_threads; ++i)
+            {
+                meshing_threads.push_back(std::thread(&RenderingManager::MeshSections, this));
+            }
 
         }
 
         RenderingManager::~RenderingManager()
+        {
+            world->UnsubscribeBlockChanges(block_changes_subscriber_id);
+            running = false;
+
+            if (rendering_thread.joinable())
+            {
+                rendering_thread.join();
+            }
+
+            // Already done at the end of the rendering
+            // thread, except if the initialization failed
+            StopUpdatingThreads();
+        }
+
+        void RenderingManager::StopUpdatingThreads()
         {
             running = false;
 
@@ -86,9 +139,17 @@ namespace Botcraft
                 thread_updating_chunks.join();
             }
 
-            if (rendering_thread.joinable())
             {
-                rendering_thread.join();
+                std::lock_guard<std::mutex> guard_meshing(mutex_meshing);
+                meshing_jobs.clear();
+            }
+            condition_meshing.notify_all();
+            for (int i = 0; i < meshing_threads.size(); ++i)
+            {
+                if (meshing_threads[i].joinable())
+                {
+                    meshing_threads[i].join();
+                }
             }
         }
 
@@ -141,7 +202,7 @@ namespace Botcraft
                     ImGui::Begin("Targeted cube");
                     Position raycasted_pos;
                     Position raycasted_normal;
-                    std::shared_ptr<Blockstate> raycasted_blockstate;
+                    const Blockstate* raycasted_blockstate;
                     {
                         std::lock_guard<std::mutex> world_guard(world->GetMutex());
                         raycasted_blockstate =
@@ -183,6 +244,10 @@ namespace Botcraft
                 }
                 
                 world_renderer->UpdateFaces();
+                {
+                    std::lock_guard<std::mutex> guard_stats(mutex_memory_stats);
+                    world_renderer->GetMemoryStats(memory_stats);
+                }
 
                 my_shader->Use();
 
@@ -190,18 +255,41 @@ namespace Botcraft
                 world_renderer->UseAtlasTextureGL();
 
 #ifdef USE_IMGUI
-                int num_chunks, num_rendered_chunks, num_faces, num_rendered_faces;
-                world_renderer->RenderFaces(&num_chunks, &num_rendered_chunks, &num_faces, &num_rendered_faces);
+                int num_chunks, num_rendered_chunks, num_occluded_chunks, num_faces, num_rendered_faces;
+                size_t uploaded_bytes, buffer_bytes;
+                float sorting_time;
+                world_renderer->RenderFaces(&num_chunks, &num_rendered_chunks, &num_occluded_chunks, &num_faces, &num_rendered_faces,
+                    &uploaded_bytes, &buffer_bytes, &sorting_time);
                 {
                     ImGui::SetNextWindowPos(ImVec2(current_window_width, 0), 0, ImVec2(1.0f, 0.0f));
-                    ImGui::SetNextWindowSize(ImVec2(180, 140));
+                    ImGui::SetNextWindowSize(ImVec2(180, 275));
                     ImGui::Begin("Rendering");
                     ImGui::Text("Lim. FPS: %.1f (%.2fms)", 1.0 / deltaTime, deltaTime * 1000.0);
                     ImGui::Text("Real FPS: %.1f (%.2fms)", 1.0 / real_fps, real_fps * 1000.0);
                     ImGui::Text("Loaded sections: %i", num_chunks);
                     ImGui::Text("Rendered sections: %i", num_rendered_chunks);
+                    ImGui::Text("Occluded sections: %i", num_occluded_chunks);
                     ImGui::Text("Loaded faces: %i", num_faces);
                     ImGui::Text("Rendered faces: %i", num_rendered_faces);
+                    ImGui::Text("Uploaded: %.1f KB", uploaded_bytes / 1024.0f);
+                    ImGui::Text("Face buffer: %.1f MB", buffer_bytes / (1024.0f * 1024.0f));
+                    {
+                        std::lock_guard<std::mutex> guard_stats(mutex_memory_stats);
+                        ImGui::Text("GPU faces: %.1f MB", memory_stats.gpu_face_bytes / (1024.0f * 1024.0f));
+                        ImGui::Text("CPU faces: %.1f MB", memory_stats.cpu_face_bytes / (1024.0f * 1024.0f));
+                        if (memory_stats.memory_budget > 0)
+                        {
+                            ImGui::Text("Budget: %.1f MB", memory_stats.memory_budget / (1024.0f * 1024.0f));
+                        }
+                        else
+                        {
+                            ImGui::Text("Budget: none");
+                        }
+                        ImGui::Text("Evicted sections: %i", memory_stats.num_evicted_sections);
+                    }
+                    ImGui::Text("Sorting: %.2fms", sorting_time);
+                    ImGui::Text("Meshing: %llu -> %llu faces", meshed_block_faces.load(), meshed_rendered_faces.load());
+                    ImGui::Text("Meshed per LOD: %llu/%llu/%llu", meshed_lod_sections[0].load(), meshed_lod_sections[1].load(), meshed_lod_sections[2].load());
                     ImGui::End();
                 }
 #else
@@ -253,9 +341,9 @@ namespace Botcraft
                                 ImGui::Text("Offhand");
                             }
 #if PROTOCOL_VERSION < 347
-                            std::string name = AssetsManager::getInstance().Items().at(it->second.GetBlockID()).at(it->second.GetItemDamage())->GetName();
+                            std::string name = AssetsManager::getInstance().GetItem(it->second.GetBlockID(), it->second.GetItemDamage())->GetName();
 #else
-                            std::string name = AssetsManager::getInstance().Items().at(it->second.GetItemID())->GetName();
+                            std::string name = AssetsManager::getInstance().GetItem(it->second.GetItemID())->GetName();
 #endif
                             if (name != "minecraft:air")
                             {
@@ -289,6 +377,8 @@ namespace Botcraft
                 std::this_thread::sleep_until(end);
             }
 
+            // Meshing threads use the world renderer
+            StopUpdatingThreads();
             world_renderer.reset();
             my_shader.reset();
 
@@ -391,6 +481,10 @@ namespace Botcraft
             unsigned int uniform_view_block_index = glGetUniformBlockIndex(my_shader->Program(), "MatriceView");
             glUniformBlockBinding(my_shader->Program(), uniform_view_block_index, 0);
 
+            //Face shapes are read from texture unit 1
+            my_shader->Use();
+            my_shader->SetInt("face_shapes", 1);
+
             world_renderer->InitGL();
 
             return true;
@@ -501,14 +595,8 @@ namespace Botcraft
         */
         void RenderingManager::AddChunkToUpdate(const int x, const int z)
         {
-            const std::vector<Position> chunk_pos = { {Position(x, 0, z), Position(x - 1, 0, z),
-                            Position(x + 1, 0 , z), Position(x, 0, z - 1), Position(x, 0, z + 1)} };
-
             std::lock_guard<std::mutex> guard_rendering(mutex_updating);
-            for (int i = 0; i < chunk_pos.size(); ++i)
-            {
-                chunks_to_udpate.insert(chunk_pos[i]);
-            }
+            chunks_to_udpate.insert(Position(x, 0, z));
             condition_update.notify_all();
         }
 
@@ -526,9 +614,19 @@ namespace Botcraft
             {
                 {
                     std::unique_lock<std::mutex> lck(mutex_updating);
-                    condition_update.wait(lck);
+                    // Wake up regularly to check the camera for the levels of detail
+                    condition_update.wait_for(lck, std::chrono::milliseconds(200));
                 }
 
+                // All the chunks with modified sections, whatever modified them
+                std::vector<Position> modified_chunks;
+                world->GetMutex().lock();
+                modified_chunks = world->GetModifiedChunks();
+                world->GetMutex().unlock();
+                mutex_updating.lock();
+                chunks_to_udpate.insert(modified_chunks.begin(), modified_chunks.end());
+                mutex_updating.unlock();
+
                 while (!chunks_to_udpate.empty())
                 {
                     Position pos;
@@ -542,19 +640,77 @@ namespace Botcraft
                     mutex_updating.unlock();
 
                     std::shared_ptr<const Botcraft::Chunk> chunk;
+                    std::vector<int> sections_to_mesh;
+                    int lod = 0;
                     // Get the new values in the world
                     world->GetMutex().lock();
                     bool has_chunk_been_modified = world->HasChunkBeenModified(pos.x, pos.z);
                     if (has_chunk_been_modified)
                     {
-                        chunk = world->GetChunkCopy(pos.x, pos.z);
-                        world->ResetChunkModificationState(pos.x, pos.z);
+                        const std::vector<bool> modified_sections = world->GetChunkModifiedSections(pos.x, pos.z);
+                        // Chunk has been unloaded, clear all its sections
+                        if (modified_sections.empty())
+                        {
+                            for (int y = 0; y < world_renderer->GetMesher().GetNumSections(); ++y)
+                            {
+                                sections_to_mesh.push_back(y);
+                            }
+                            chunks_lod.erase(pos);
+                        }
+                        // Only copy the modified sections and their neighbours
+                        else
+                        {
+                            auto it = chunks_lod.find(pos);
+                            if (it == chunks_lod.end())
+                            {
+                                const glm::vec3 camera_position = world_renderer->GetCamera()->GetPosition();
+                                it = chunks_lod.insert({ pos, SelectLod(pos, 0, camera_position.x, camera_position.z) }).first;
+                            }
+                            lod = it->second;
+
+                            std::vector<bool> required_sections;
+                            world_renderer->GetMesher().GetSectionsToUpdate(modified_sections, sections_to_mesh, required_sections);
+                            if (lod == 0)
+                            {
+                                chunk = world->GetChunkCopy(pos.x, pos.z, required_sections);
+                            }
+                            // Lower levels of detail use the blocks of the
+                            // neighbour sections too
+                            else
+                            {
+                                std::vector<bool> lod_sections(world_renderer->GetMesher().GetNumSections(), false);
+                                for (int i = 0; i < sections_to_mesh.size(); ++i)
+                                {
+                                    for (int y = std::max(0, sections_to_mesh[i] - 1); y <= std::min(static_cast<int>(lod_sections.size()) - 1, sections_to_mesh[i] + 1); ++y)
+                                    {
+                                        lod_sections[y] = true;
+                                    }
+                                }
+                                sections_to_mesh.clear();
+                                for (int y = 0; y < lod_sections.size(); ++y)
+                                {
+                                    if (lod_sections[y])
+                                    {
+                                        sections_to_mesh.push_back(y);
+                                    }
+                                }
+                                chunk = world->GetChunkCopy(pos.x, pos.z);
+                            }
+                            world->ResetChunkModificationState(pos.x, pos.z);
+                        }
                     }
                     world->GetMutex().unlock();
 
-                    if (has_chunk_been_modified)
+                    // Mesh each modified rendering section of the copy in parallel
+                    if (!sections_to_mesh.empty())
                     {
-                        world_renderer->UpdateChunk(pos.x, pos.z, chunk);
+                        std::lock_guard<std::mutex> guard_meshing(mutex_meshing);
+                        meshing_version += 1;
+                        for (int i = 0; i < sections_to_mesh.size(); ++i)
+                        {
+                            meshing_jobs.push_back({ chunk, Position(pos.x, sections_to_mesh[i], pos.z), meshing_version, lod });
+                        }
+                        condition_meshing.notify_all();
                     }
 
                     // If we left the game, we don't need to process 
@@ -567,37 +723,223 @@ namespace Botcraft
                         break;
                     }
                 }
+
+                if (running)
+                {
+                    UpdateLods();
+                    RestoreEvictedSections();
+                }
             }
         }
 
-        void RenderingManager::Handle(ProtocolCraft::Message& msg)
+        void RenderingManager::UpdateLods()
         {
+            const glm::vec3 camera_position = world_renderer->GetCamera()->GetPosition();
+            const Position camera_chunk = Botcraft::Chunk::BlockCoordsToChunkCoords(
+                Position(static_cast<int>(std::floor(camera_position.x)), 0, static_cast<int>(std::floor(camera_position.z))));
+
+            {
+                std::lock_guard<std::mutex> guard_updating(mutex_updating);
+                if (!lods_should_be_updated && camera_chunk == lod_camera_chunk)
+                {
+                    return;
+                }
+                lods_should_be_updated = false;
+            }
+            lod_camera_chunk = camera_chunk;
+
+            for (auto it = chunks_lod.begin(); it != chunks_lod.end(); ++it)
+            {
+                const int lod = SelectLod(it->first, it->second, camera_position.x, camera_position.z);
+                if (lod == it->second)
+                {
+                    continue;
+                }
+
+                std::shared_ptr<const Botcraft::Chunk> chunk;
+                {
+                    std::lock_guard<std::mutex> world_guard(world->GetMutex());
+                    chunk = world->GetChunkCopy(it->first.x, it->first.z);
+                }
+                // Chunk has been unloaded, it will be removed with its update
+                if (chunk == nullptr)
+                {
+                    continue;
+                }
+                it->second = lod;
 
+                std::lock_guard<std::mutex> guard_meshing(mutex_meshing);
+                meshing_version += 1;
+                for (int y = 0; y < world_renderer->GetMesher().GetNumSections(); ++y)
+                {
+                    meshing_jobs.push_back({ chunk, Position(it->first.x, y, it->first.z), meshing_version, lod });
+                }
+                condition_meshing.notify_all();
+            }
+        }
+
+        void RenderingManager::RestoreEvictedSections()
+        {
+            std::vector<Position> sections;
+            world_renderer->GetSectionsToRestore(sections);
+            if (sections.empty())
+            {
+                return;
+            }
+
+            // Sections of the same chunk share one copy
+            std::unordered_map<Position, std::vector<int> > chunks_sections;
+            for (int i = 0; i < sections.size(); ++i)
+            {
+                chunks_sections[Position(sections[i].x, 0, sections[i].z)].push_back(sections[i].y);
+            }
+
+            for (auto it = chunks_sections.begin(); it != chunks_sections.end(); ++it)
+            {
+                auto lod_it = chunks_lod.find(it->first);
+                // Chunk has been unloaded
+                if (lod_it == chunks_lod.end())
+                {
+                    continue;
+                }
+
+                std::shared_ptr<const Botcraft::Chunk> chunk;
+                {
+                    std::lock_guard<std::mutex> world_guard(world->GetMutex());
+                    chunk = world->GetChunkCopy(it->first.x, it->first.z);
+                }
+                if (chunk == nullptr)
+                {
+                    continue;
+                }
+
+                std::lock_guard<std::mutex> guard_meshing(mutex_meshing);
+                meshing_version += 1;
+                for (int i = 0; i < it->second.size(); ++i)
+                {
+                    meshing_jobs.push_back({ chunk, Position(it->first.x, it->second[i], it->first.z), meshing_version, lod_it->second });
+                }
+                condition_meshing.notify_all();
+            }
         }
 
-        void RenderingManager::Handle(ProtocolCraft::ClientboundBlockUpdatePacket& msg)
+        void RenderingManager::SetMemoryBudget(const size_t bytes)
         {
-            Position chunk_coords = Botcraft::Chunk::BlockCoordsToChunkCoords(msg.GetPos());
-            AddChunkToUpdate(chunk_coords.x, chunk_coords.z);
+            world_renderer->SetMemoryBudget(bytes);
         }
 
-        void RenderingManager::Handle(ProtocolCraft::ClientboundSectionBlocksUpdatePacket& msg)
+        const MemoryStats RenderingManager::GetMemoryStats() const
         {
-#if PROTOCOL_VERSION < 737
-            AddChunkToUpdate(msg.GetChunkX(), msg.GetChunkZ());
-#else
-            AddChunkToUpdate(msg.GetSectionPos() >> 42, msg.GetSectionPos() << 22 >> 42);
-#endif
+            std::lock_guard<std::mutex> guard_stats(mutex_memory_stats);
+            return memory_stats;
+        }
+
+        const int RenderingManager::SelectLod(const Position& chunk, const int current_lod, const double camera_x, const double camera_z)
+        {
+            const double dx = (chunk.x + 0.5) * CHUNK_WIDTH - camera_x;
+            const double dz = (chunk.z + 0.5) * CHUNK_WIDTH - camera_z;
+            const float distance = static_cast<float>(std::sqrt(dx * dx + dz * dz));
+
+            std::lock_guard<std::mutex> guard_updating(mutex_updating);
+            int lod = current_lod;
+            while (lod < NUM_LOD_LEVELS - 1 && distance > lod_distances[lod] + lod_hysteresis)
+            {
+                lod += 1;
+            }
+            while (lod > 0 && distance < lod_distances[lod - 1] - lod_hysteresis)
+            {
+                lod -= 1;
+            }
+            return lod;
+        }
+
+        void RenderingManager::SetLodDistances(const std::array<float, NUM_LOD_LEVELS - 1>& distances, const float hysteresis)
+        {
+            std::lock_guard<std::mutex> guard_updating(mutex_updating);
+            lod_distances = distances;
+            lod_hysteresis = hysteresis;
+            lods_should_be_updated = true;
+            condition_update.notify_all();
+        }
+
+        const MeshingStats RenderingManager::GetMeshingStats() const
+        {
+            MeshingStats stats;
+            stats.meshed_sections = meshed_sections;
+            stats.block_faces = meshed_block_faces;
+            stats.rendered_faces = meshed_rendered_faces;
+            stats.meshing_time = meshing_time;
+            for (int i = 0; i < NUM_LOD_LEVELS; ++i)
+            {
+                stats.lod_sections[i] = meshed_lod_sections[i];
+                stats.lod_block_faces[i] = meshed_lod_block_faces[i];
+                stats.lod_rendered_faces[i] = meshed_lod_rendered_faces[i];
+            }
+            return stats;
+        }
+
+        void RenderingManager::MeshSections()
+        {
+            // Reused between jobs to avoid reallocating the faces
+            SectionMesh mesh;
+            while (running)
+            {
+                MeshingJob job;
+                {
+                    std::unique_lock<std::mutex> lck(mutex_meshing);
+                    condition_meshing.wait(lck, [this]() { return !running || !meshing_jobs.empty(); });
+                    if (!running)
+                    {
+                        return;
+                    }
+                    job = meshing_jobs.front();
+                    meshing_jobs.pop_front();
+                    num_running_meshing_jobs += 1;
+                }
+
+                const auto start = std::chrono::high_resolution_clock::now();
+                world_renderer->GetMesher().MeshSection(job.chunk.get(), job.section.x, job.section.z, job.section.y, mesh, job.lod);
+                meshing_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count();
+                meshed_sections += 1;
+                meshed_block_faces += mesh.num_block_faces;
+                meshed_rendered_faces += mesh.opaque_faces.size() + mesh.transparent_faces.size();
+                meshed_lod_sections[mesh.lod] += 1;
+                meshed_lod_block_faces[mesh.lod] += mesh.num_block_faces;
+                meshed_lod_rendered_faces[mesh.lod] += mesh.opaque_faces.size() + mesh.transparent_faces.size();
+                world_renderer->SetSectionFaces(job.section, mesh, job.version);
+
+                // Versions of the empty sections can only be removed when there
+                // is no other mesh being computed, the lock prevents other threads
+                // from starting a new one in the meantime
+                {
+                    std::lock_guard<std::mutex> guard_meshing(mutex_meshing);
+                    num_running_meshing_jobs -= 1;
+                    if (meshing_jobs.empty() && num_running_meshing_jobs == 0)
+                    {
+                        world_renderer->ReleaseEmptySections();
+                    }
+                }
+            }
         }
 
-        void RenderingManager::Handle(ProtocolCraft::ClientboundForgetLevelChunkPacket& msg)
+        void RenderingManager::OnBlockChanges(const std::vector<BlockChangeEvent>& events)
         {
-            AddChunkToUpdate(msg.GetX(), msg.GetZ());
+            std::lock_guard<std::mutex> guard_rendering(mutex_updating);
+            // The other modified chunks, including the neighbours with a
+            // modified border, are found from the world sections flags
+            for (size_t i = 0; i < events.size(); ++i)
+            {
+                if (events[i].type == BlockChangeType::ChunkUnloaded)
+                {
+                    chunks_to_udpate.insert(Botcraft::Chunk::BlockCoordsToChunkCoords(events[i].min));
+                }
+            }
+            condition_update.notify_all();
         }
 
-        void RenderingManager::Handle(ProtocolCraft::ClientboundLevelChunkPacket& msg)
+        void RenderingManager::Handle(ProtocolCraft::Message& msg)
         {
-            AddChunkToUpdate(msg.GetX(), msg.GetZ());
+
         }
 
         void RenderingManager::Handle(ProtocolCraft::ClientboundSetTimePacket& msg)
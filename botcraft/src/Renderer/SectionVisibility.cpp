@@ -0,0 +1,173 @@
+#include "botcraft/Renderer/SectionVisibility.hpp"
+
+#include "botcraft/Game/World/Chunk.hpp"
+
+#include <deque>
+
+namespace Botcraft
+{
+    namespace Renderer
+    {
+        // Neighbour sections, in Orientation order
+        static const std::array<Position, 6> neighbour_sections({ Position(0, -1, 0), Position(0, 0, -1),
+                        Position(-1, 0, 0), Position(1, 0, 0), Position(0, 0, 1), Position(0, 1, 0) });
+
+        // The opposite of face i is face 5 - i
+        inline const Orientation Opposite(const Orientation o)
+        {
+            return static_cast<Orientation>(5 - static_cast<int>(o));
+        }
+
+        SectionVisibility::SectionVisibility(const bool all_connected)
+        {
+            connections = all_connected ? 0xFFFFFFFFFULL : 0ULL;
+        }
+
+        void SectionVisibility::SetConnected(const Orientation a, const Orientation b)
+        {
+            connections |= 1ULL << (static_cast<int>(a) * 6 + static_cast<int>(b));
+            connections |= 1ULL << (static_cast<int>(b) * 6 + static_cast<int>(a));
+        }
+
+        const bool SectionVisibility::IsConnected(const Orientation a, const Orientation b) const
+        {
+            return (connections >> (static_cast<int>(a) * 6 + static_cast<int>(b))) & 1ULL;
+        }
+
+        const bool SectionVisibility::IsFullyConnected() const
+        {
+            return connections == 0xFFFFFFFFFULL;
+        }
+
+        void SectionVisibility::Compute(const std::vector<bool>& opaque, const int height, std::vector<bool>& visited)
+        {
+            connections = 0ULL;
+
+            const int num_blocks = CHUNK_WIDTH * CHUNK_WIDTH * height;
+            visited.assign(num_blocks, false);
+
+            std::vector<int> stack;
+            for (int start = 0; start < num_blocks; ++start)
+            {
+                if (opaque[start] || visited[start])
+                {
+                    continue;
+                }
+
+                // Flood fill the non opaque blocks connected
+                // to start and record the faces they touch
+                unsigned char touched_faces = 0;
+                visited[start] = true;
+                stack.push_back(start);
+                while (!stack.empty())
+                {
+                    const int index = stack.back();
+                    stack.pop_back();
+
+                    const int x = index % CHUNK_WIDTH;
+                    const int z = (index / CHUNK_WIDTH) % CHUNK_WIDTH;
+                    const int y = index / (CHUNK_WIDTH * CHUNK_WIDTH);
+
+                    const std::array<bool, 6> on_face = { y == 0, z == 0, x == 0, x == CHUNK_WIDTH - 1, z == CHUNK_WIDTH - 1, y == height - 1 };
+                    for (int i = 0; i < 6; ++i)
+                    {
+                        if (on_face[i])
+                        {
+                            touched_faces |= 1 << i;
+                            continue;
+                        }
+
+                        const int neighbour = index + neighbour_sections[i].x + CHUNK_WIDTH * (neighbour_sections[i].z + CHUNK_WIDTH * neighbour_sections[i].y);
+                        if (!opaque[neighbour] && !visited[neighbour])
+                        {
+                            visited[neighbour] = true;
+                            stack.push_back(neighbour);
+                        }
+                    }
+                }
+
+                for (int i = 0; i < 6; ++i)
+                {
+                    if (!(touched_faces & (1 << i)))
+                    {
+                        continue;
+                    }
+                    for (int j = i; j < 6; ++j)
+                    {
+                        if (touched_faces & (1 << j))
+                        {
+                            SetConnected(static_cast<Orientation>(i), static_cast<Orientation>(j));
+                        }
+                    }
+                }
+            }
+        }
+
+        void GetVisibleSections(const Position& camera_section,
+            const std::unordered_map<Position, SectionVisibility>& visibilities,
+            const Position& min_section, const Position& max_section,
+            const std::function<bool(const Position&)>& is_in_frustum,
+            std::unordered_set<Position>& visible_sections)
+        {
+            struct Step
+            {
+                Position section;
+                // Face of the section this step entered by
+                Orientation entered_by;
+                // Directions already taken since the camera, one bit per Orientation
+                unsigned char directions;
+            };
+
+            visible_sections.clear();
+            visible_sections.insert(camera_section);
+
+            std::deque<Step> steps;
+            steps.push_back({ camera_section, Orientation::None, 0 });
+
+            while (!steps.empty())
+            {
+                const Step step = steps.front();
+                steps.pop_front();
+
+                auto visibility_it = visibilities.find(step.section);
+                const SectionVisibility* visibility = visibility_it == visibilities.end() ? nullptr : &visibility_it->second;
+
+                for (int i = 0; i < 6; ++i)
+                {
+                    const Orientation direction = static_cast<Orientation>(i);
+
+                    // Never go back toward the camera
+                    if (step.directions & (1 << static_cast<int>(Opposite(direction))))
+                    {
+                        continue;
+                    }
+
+                    // Can we see this face from the one we entered by?
+                    if (step.entered_by != Orientation::None &&
+                        visibility != nullptr &&
+                        !visibility->IsConnected(step.entered_by, direction))
+                    {
+                        continue;
+                    }
+
+                    const Position next = step.section + neighbour_sections[i];
+                    if (next.x < min_section.x || next.x > max_section.x ||
+                        next.y < min_section.y || next.y > max_section.y ||
+                        next.z < min_section.z || next.z > max_section.z)
+                    {
+                        continue;
+                    }
+
+                    if (visible_sections.find(next) != visible_sections.end() ||
+                        !is_in_frustum(next))
+                    {
+                        continue;
+                    }
+
+                    visible_sections.insert(next);
+                    steps.push_back({ next, Opposite(direction), static_cast<unsigned char>(step.directions | (1 << i)) });
+                }
+            }
+        }
+    } // Renderer
+} // Botcraft
\ No newline at end of file
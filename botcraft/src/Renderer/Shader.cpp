@@ -183,15 +183,11 @@ namespace Botcraft
             "#version 330 core\n"
             "\n"
             "layout (location = 0) in vec3 aPos;\n"
-            "//This matrix is actually four columns\n"
-            "layout (location = 1) in mat4 aModel;\n"
-            "//layout (location = 2) in vec4 aModelCol1;\n"
-            "//layout (location = 3) in vec4 aModelCol2;\n"
-            "//layout (location = 4) in vec4 aModelCol3;\n"
-            "layout (location = 5) in vec4 texture_coords;\n"
-            "layout (location = 6) in vec4 texture_coords_overlay;\n"
-            "layout (location = 7) in uint texture_data;\n"
-            "layout (location = 8) in uvec2 texture_multiplier;\n"
+            "//Block position in the section (x: 4 bits, z: 4 bits, y: 9 bits)\n"
+            "//and size - 1 of merged faces (x: 4 bits, y: 4 bits, z: 4 bits)\n"
+            "layout (location = 1) in uint face_position;\n"
+            "layout (location = 2) in uint face_shape;\n"
+            "layout (location = 3) in uvec2 texture_multiplier;\n"
             "\n"
             "layout (std140) uniform MatriceView\n"
             "{\n"
@@ -199,9 +195,19 @@ namespace Botcraft
             "};\n"
             "\n"
             "uniform mat4 projection;\n"
+            "//Position of the corner of the current section\n"
+            "uniform vec3 section_origin;\n"
+            "//7 texels per shape: model matrix (4 columns), texture coords,\n"
+            "//overlay texture coords, (texture_data, 0, 0, 0)\n"
+            "uniform samplerBuffer face_shapes;\n"
             "\n"
             "out vec2 AtlasCoord;\n"
             "out vec2 AtlasCoord_overlay;\n"
+            "//Position in the repeated texture of merged faces\n"
+            "out vec2 TileCoord;\n"
+            "flat out uint RepeatTexture;\n"
+            "flat out vec4 TextureRect;\n"
+            "flat out vec4 TextureRect_overlay;\n"
             "flat out uint BackFaceDisplay;\n"
             "flat out uint UseOverlay;\n"
             "flat out vec4 TextureMultiplier;\n"
@@ -209,12 +215,20 @@ namespace Botcraft
             "\n"
             "void main()\n"
             "{\n"
-            "\t//mat4 aModel;\n"
-            "\t//aModel[0] = aModelCol0;\n"
-            "\t//aModel[1] = aModelCol1;\n"
-            "\t//aModel[2] = aModelCol2;\n"
-            "\t//aModel[3] = aModelCol3;\n"
-            "\tgl_Position = projection * view * (aModel * vec4(aPos, 1.0));\n"
+            "\tint shape_index = 7 * int(face_shape);\n"
+            "\tmat4 aModel = mat4(texelFetch(face_shapes, shape_index), texelFetch(face_shapes, shape_index + 1), texelFetch(face_shapes, shape_index + 2), texelFetch(face_shapes, shape_index + 3));\n"
+            "\tvec4 texture_coords = texelFetch(face_shapes, shape_index + 4);\n"
+            "\tvec4 texture_coords_overlay = texelFetch(face_shapes, shape_index + 5);\n"
+            "\tuint texture_data = uint(texelFetch(face_shapes, shape_index + 6).x);\n"
+            "\n"
+            "\t//Add 0.5 because the origin of the block is at the center\n"
+            "\t//but the coordinates start from the block corner\n"
+            "\tvec3 block_position = vec3(float(face_position & uint(0x0F)), float((face_position >> 8) & uint(0x1FF)), float((face_position >> 4) & uint(0x0F))) + 0.5;\n"
+            "\t//Merged faces are stretched toward the positive axes\n"
+            "\tvec3 face_size = vec3(float((face_position >> 17) & uint(0x0F)), float((face_position >> 21) & uint(0x0F)), float((face_position >> 25) & uint(0x0F))) + 1.0;\n"
+            "\tvec4 local_position = aModel * vec4(aPos, 1.0);\n"
+            "\tlocal_position.xyz += (face_size - 1.0) * step(0.0, local_position.xyz);\n"
+            "\tgl_Position = projection * view * (local_position + vec4(section_origin + block_position, 0.0));\n"
             "\n"
             "\tint vertex_id = gl_VertexID;\n"
             "\n"
@@ -229,6 +243,18 @@ namespace Botcraft
             "\tAtlasCoord = vec2(texture_coords[2 * int(vertex_id % 2)], texture_coords[1 + 2 * int(vertex_id > 1)]);\n"
             "\tAtlasCoord_overlay = vec2(texture_coords_overlay[2 * int(vertex_id % 2)], texture_coords_overlay[1 + 2 * int(vertex_id > 1)]);\n"
             "\n"
+            "\t//Number of blocks along the base face x and z axes,\n"
+            "\t//swapped if the texture is rotated by 90 or 270 degrees\n"
+            "\tvec2 repeat = vec2(dot(abs(normalize(aModel[0].xyz)), face_size), dot(abs(normalize(aModel[2].xyz)), face_size));\n"
+            "\tif(rotation % 2 == 1)\n"
+            "\t{\n"
+            "\t\trepeat = repeat.yx;\n"
+            "\t}\n"
+            "\tTileCoord = vec2(float(vertex_id % 2), float(vertex_id > 1)) * repeat;\n"
+            "\tRepeatTexture = uint(any(greaterThan(face_size, vec3(1.0))));\n"
+            "\tTextureRect = texture_coords;\n"
+            "\tTextureRect_overlay = texture_coords_overlay;\n"
+            "\n"
             "\tBackFaceDisplay = uint(texture_data & uint(0x01));\n"
             "\tUseOverlay = uint((texture_data >> 3) & uint(0x01));\n"
             "\tTextureMultiplier = vec4(float(texture_multiplier[0] & uint(0xFF)), float((texture_multiplier[0] >> 8) & uint(0xFF)), float((texture_multiplier[0] >> 16) & uint(0xFF)), float((texture_multiplier[0] >> 24) & uint(0xFF))) / 255.0f;\n"
@@ -240,6 +266,10 @@ namespace Botcraft
             "\n"
             "in vec2 AtlasCoord;\n"
             "in vec2 AtlasCoord_overlay;\n"
+            "in vec2 TileCoord;\n"
+            "flat in uint RepeatTexture;\n"
+            "flat in vec4 TextureRect;\n"
+            "flat in vec4 TextureRect_overlay;\n"
             "flat in uint BackFaceDisplay;\n"
             "flat in uint UseOverlay;\n"
             "flat in vec4 TextureMultiplier;\n"
@@ -249,6 +279,14 @@ namespace Botcraft
             "\n"
             "out vec4 FragColor;\n"
             "\n"
+            "//Sample one texture of the atlas repeated on a merged face. The gradients\n"
+            "//are computed before fract so the mipmap level is the same on the seams\n"
+            "vec4 SampleRepeated(vec4 rect, vec2 tile_coord, vec2 tile_dx, vec2 tile_dy)\n"
+            "{\n"
+            "\tvec2 size = rect.zw - rect.xy;\n"
+            "\treturn textureGrad(atlas_texture, rect.xy + size * fract(tile_coord), tile_dx * size, tile_dy * size);\n"
+            "}\n"
+            "\n"
             "void main()\n"
             "{\n"
             "\tif(!bool(BackFaceDisplay )&& !gl_FrontFacing)\n"
@@ -256,14 +294,18 @@ namespace Botcraft
             "\t\tdiscard;\n"
             "\t}\n"
             "\n"
+            "\tvec2 tile_dx = dFdx(TileCoord);\n"
+            "\tvec2 tile_dy = dFdy(TileCoord);\n"
+            "\tvec4 texture_color = bool(RepeatTexture) ? SampleRepeated(TextureRect, TileCoord, tile_dx, tile_dy) : texture(atlas_texture, AtlasCoord);\n"
+            "\n"
             "if(!bool(UseOverlay))\n"
             "{\n"
-            "\tFragColor = TextureMultiplier * texture(atlas_texture, AtlasCoord);\n"
+            "\tFragColor = TextureMultiplier * texture_color;\n"
             "}\n"
             "else\n"
             "{\n"
-            "\tvec4 base_color = TextureMultiplier * texture(atlas_texture, AtlasCoord);\n"
-            "\tvec4 overlay_color = TextureMultiplier_overlay * texture(atlas_texture, AtlasCoord_overlay);\n"
+            "\tvec4 base_color = TextureMultiplier * texture_color;\n"
+            "\tvec4 overlay_color = TextureMultiplier_overlay * (bool(RepeatTexture) ? SampleRepeated(TextureRect_overlay, TileCoord, tile_dx, tile_dy) : texture(atlas_texture, AtlasCoord_overlay));\n"
             "\tfloat alpha = overlay_color[3] + base_color[3] * (1.0f - overlay_color[3]);\n"
             "\tFragColor = vec4((vec3(overlay_color) * overlay_color[3] + (1.0f - overlay_color[3]) * vec3(base_color) * base_color[3]) / alpha, alpha);\n"
             "}\n"
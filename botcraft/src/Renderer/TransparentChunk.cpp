@@ -1,27 +1,9 @@
-#include <glm/vec4.hpp>
-#include <glm/gtc/type_ptr.hpp>
-
-#include <glad/glad.h>
-
 #include "botcraft/Renderer/TransparentChunk.hpp"
 
-#include <algorithm>
-
 namespace Botcraft
 {
     namespace Renderer
     {
-        const float Distance(const Face &f, const glm::vec3 &pos)
-        {
-            const glm::vec3 center = glm::make_mat4(f.GetMatrix().data()) * glm::vec4(0.0f, -1.0f, 0.0f, 1.0f);
-
-            const float delta_x = pos.x - center.x;
-            const float delta_y = pos.y - center.y;
-            const float delta_z = pos.z - center.z;
-
-            return delta_x * delta_x + delta_y * delta_y + delta_z * delta_z;
-        }
-
         TransparentChunk::TransparentChunk()
         {
             display_buffer_status = BufferStatus::UpToDate;
@@ -32,40 +14,21 @@ namespace Botcraft
 
         }
 
-        void TransparentChunk::Update()
+        void TransparentChunk::Update(FaceBuffer& buffer)
         {
             std::lock_guard<std::mutex> lock_faces(mutex_faces);
             switch (buffer_status)
             {
             case BufferStatus::Created:
-            {
-                GenerateOpenGLBuffer();
-                display_faces_positions = std::vector<Face>(faces_positions.begin(), faces_positions.end());
-                face_number = display_faces_positions.size();
-                glBindBuffer(GL_ARRAY_BUFFER, data_VBO);
-                glBufferData(GL_ARRAY_BUFFER, sizeof(Face) * face_number, display_faces_positions.data(), GL_DYNAMIC_DRAW);
-                glBindBuffer(GL_ARRAY_BUFFER, 0);
-                buffer_status = BufferStatus::UpToDate;
-                display_buffer_status = BufferStatus::Updated;
-                break;
-            }
             case BufferStatus::Updated:
             {
-                display_faces_positions = std::vector<Face>(faces_positions.begin(), faces_positions.end());
+                display_faces_positions.swap(faces_positions);
+                std::vector<PackedFace>().swap(faces_positions);
+                display_faces_centers.clear();
                 face_number = display_faces_positions.size();
+                buffer.Upload(display_faces_positions, allocation);
+                buffer_status = face_number == 0 ? BufferStatus::Created : BufferStatus::UpToDate;
                 display_buffer_status = BufferStatus::Updated;
-                glBindBuffer(GL_ARRAY_BUFFER, data_VBO);
-                glBufferData(GL_ARRAY_BUFFER, sizeof(Face) * face_number, display_faces_positions.data(), GL_DYNAMIC_DRAW);
-                glBindBuffer(GL_ARRAY_BUFFER, 0);
-                if (face_number == 0)
-                {
-                    DeleteOpenGLBuffer();
-                    buffer_status = BufferStatus::Created;
-                }
-                else
-                {
-                    buffer_status = BufferStatus::UpToDate;
-                }
                 break;
             }
             case BufferStatus::UpToDate:
@@ -75,12 +38,20 @@ namespace Botcraft
             }
         }
 
+        const size_t TransparentChunk::GetCPUBytes()
+        {
+            std::lock_guard<std::mutex> lock_faces(mutex_faces);
+            return (faces_positions.capacity() + display_faces_positions.capacity()) * sizeof(PackedFace) +
+                display_faces_centers.capacity() * sizeof(glm::vec3) + sorter.GetCPUBytes();
+        }
+
         void TransparentChunk::SetDisplayStatus(const BufferStatus s)
         {
             display_buffer_status = s;
         }
 
-        void TransparentChunk::Sort(const glm::vec3 &cam_pos)
+        void TransparentChunk::Sort(const glm::vec3 &cam_pos, const glm::vec3& origin,
+            const std::vector<glm::vec3>& shape_centers, FaceBuffer& buffer)
         {
             if (display_buffer_status == BufferStatus::UpToDate)
             {
@@ -88,12 +59,15 @@ namespace Botcraft
             }
 
             std::lock_guard<std::mutex> lock_faces(mutex_faces);
-            std::sort(display_faces_positions.begin(), display_faces_positions.end(), [this, cam_pos](const Face &f1, const Face &f2){return Distance(f1, cam_pos) > Distance(f2, cam_pos); });
 
+            if (display_faces_centers.size() != display_faces_positions.size())
+            {
+                FaceSorter::ComputeCenters(display_faces_positions, shape_centers, display_faces_centers);
+            }
+
+            sorter.Sort(cam_pos - origin, display_faces_positions, display_faces_centers);
 
-            glBindBuffer(GL_ARRAY_BUFFER, data_VBO);
-            glBufferData(GL_ARRAY_BUFFER, sizeof(Face) * face_number, display_faces_positions.data(), GL_DYNAMIC_DRAW);
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
+            buffer.Upload(display_faces_positions, allocation);
 
             display_buffer_status = BufferStatus::UpToDate;
         }
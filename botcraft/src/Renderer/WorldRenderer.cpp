@@ -1,17 +1,18 @@
 #include "botcraft/Renderer/Atlas.hpp"
 #include "botcraft/Renderer/Camera.hpp"
 #include "botcraft/Renderer/Chunk.hpp"
+#include "botcraft/Renderer/ChunkMesher.hpp"
+#include "botcraft/Renderer/FaceBuffer.hpp"
+#include "botcraft/Renderer/RenderingManager.hpp"
 #include "botcraft/Renderer/TransparentChunk.hpp"
 #include "botcraft/Renderer/WorldRenderer.hpp"
 
-#include "botcraft/Game/AssetsManager.hpp"
-#include "botcraft/Game/World/Biome.hpp"
-#include "botcraft/Game/World/Block.hpp"
-#include "botcraft/Game/World/Blockstate.hpp"
 #include "botcraft/Game/World/Chunk.hpp"
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include <chrono>
+#include <cmath>
 #include <unordered_set>
 
 namespace Botcraft
@@ -19,7 +20,8 @@ namespace Botcraft
     namespace Renderer
     {
         WorldRenderer::WorldRenderer(const unsigned int section_height_,
-            const std::vector<std::pair<std::string, std::string> >& textures_path_names)
+            const std::vector<std::pair<std::string, std::string> >& textures_path_names,
+            const bool greedy_meshing)
         {
             section_height = section_height_;
 
@@ -27,17 +29,25 @@ namespace Botcraft
             transparent_chunks = std::unordered_map<Position, std::shared_ptr<TransparentChunk> >();
 
             faces_should_be_updated = true;
+            sections_order_should_be_updated = true;
+
+            gpu_face_bytes = 0;
+            cpu_face_bytes = 0;
 
             camera = std::shared_ptr<Camera>(new Camera);
 
             //Build atlas
             atlas = std::shared_ptr<Atlas>(new Atlas);
-            atlas->LoadData(textures_path_names);
+            atlas->LoadData(textures_path_names, ASSETS_PATH + std::string("/atlas_cache.bin"));
+
+            mesher = std::unique_ptr<ChunkMesher>(new ChunkMesher(atlas, section_height, greedy_meshing));
         }
 
         WorldRenderer::~WorldRenderer()
         {
             glDeleteTextures(1, &atlas_texture);
+            face_buffer.reset();
+            mesher.reset();
             atlas.reset();
             camera.reset();
         }
@@ -72,6 +82,8 @@ namespace Botcraft
             glGenerateMipmap(GL_TEXTURE_2D);
 
             glBindTexture(GL_TEXTURE_2D, 0);
+
+            face_buffer = std::unique_ptr<FaceBuffer>(new FaceBuffer);
         }
 
         void WorldRenderer::UpdateViewMatrix()
@@ -82,12 +94,34 @@ namespace Botcraft
                 glm::mat4 view_matrix = camera->GetViewMatrix();
                 if (camera->GetHasChangedPosition())
                 {
-                    transparent_chunks_mutex.lock();
-                    for (auto it = transparent_chunks.begin(); it != transparent_chunks.end(); ++it)
+                    const glm::vec3& cam_pos = camera->GetPosition();
+                    const Position new_camera_block((int)std::floor(cam_pos.x), (int)std::floor(cam_pos.y), (int)std::floor(cam_pos.z));
+                    // Faces order only changes noticeably when the camera moves
+                    // to another block. When it stays in the same section, only
+                    // the sections around the camera are sorted again
+                    if (new_camera_block != camera_block)
                     {
-                        it->second->SetDisplayStatus(BufferStatus::Updated);
+                        const Position new_camera_section = GetSection(new_camera_block);
+                        const bool section_changed = new_camera_section != camera_section;
+                        transparent_chunks_mutex.lock();
+                        for (auto it = transparent_chunks.begin(); it != transparent_chunks.end(); ++it)
+                        {
+                            if (section_changed ||
+                                (std::abs(it->first.x - new_camera_section.x) < 2 &&
+                                 std::abs(it->first.y - new_camera_section.y) < 2 &&
+                                 std::abs(it->first.z - new_camera_section.z) < 2))
+                            {
+                                it->second->SetDisplayStatus(BufferStatus::Updated);
+                            }
+                        }
+                        transparent_chunks_mutex.unlock();
+                        if (section_changed)
+                        {
+                            sections_order_should_be_updated = true;
+                        }
+                        camera_block = new_camera_block;
+                        camera_section = new_camera_section;
                     }
-                    transparent_chunks_mutex.unlock();
                 }
                 camera->ResetHasChangedPosition();
                 camera->ResetHasChangedOrientation();
@@ -106,6 +140,7 @@ namespace Botcraft
 
         void WorldRenderer::UpdateFaces()
         {
+            face_buffer->ResetUploadedBytes();
             if (faces_should_be_updated)
             {
                 faces_should_be_updated = false;
@@ -113,10 +148,11 @@ namespace Botcraft
                     std::lock_guard<std::mutex> lock(chunks_mutex);
                     for (auto it = chunks.begin(); it != chunks.end();)
                     {
-                        it->second->Update();
+                        it->second->Update(*face_buffer);
                         if (it->second->GetNumFace() == 0)
                         {
                             it = chunks.erase(it);
+                            sections_order_should_be_updated = true;
                         }
                         else
                         {
@@ -128,10 +164,11 @@ namespace Botcraft
                     std::lock_guard<std::mutex> lock(transparent_chunks_mutex);
                     for (auto it = transparent_chunks.begin(); it != transparent_chunks.end();)
                     {
-                        it->second->Update();
+                        it->second->Update(*face_buffer);
                         if (it->second->GetNumFace() == 0)
                         {
                             it = transparent_chunks.erase(it);
+                            sections_order_should_be_updated = true;
                         }
                         else
                         {
@@ -140,134 +177,86 @@ namespace Botcraft
                     }
                 }
             }
+
+            {
+                std::lock_guard<std::mutex> lock(chunks_mutex);
+                EnforceMemoryBudget();
+            }
+
+            // Shapes are sent after the faces, so all the faces in
+            // the buffer reference shapes that are already sent too
+            face_buffer->UpdateShapes(mesher->GetShapes());
+            mesher->GetShapes().GetCenters(shape_centers.size(), shape_centers);
         }
 
-        void WorldRenderer::UpdateChunk(const int x_, const int z_, const std::shared_ptr<const Botcraft::Chunk> chunk)
+        const ChunkMesher& WorldRenderer::GetMesher() const
         {
-            // Remove any previous version of this chunk
+            return *mesher;
+        }
+
+        void WorldRenderer::SetSectionFaces(const Position& section, SectionMesh& mesh, const unsigned long long int version)
+        {
+            std::lock_guard<std::mutex> lock(chunks_mutex);
+            auto version_it = sections_version.find(section);
+            if (version_it != sections_version.end() && version_it->second > version)
             {
-                std::lock_guard<std::mutex> lock(chunks_mutex);
-                Position pos(x_, 0, z_);
-                for (int y = 0; y < CHUNK_HEIGHT / section_height; ++y)
-                {
-                    pos.y = y;
-                    auto it = chunks.find(pos);
-                    if (it != chunks.end())
-                    {
-                        it->second->ClearFaces();
-                    }
-                }
+                return;
             }
+            sections_version[section] = version;
+
+            if (mesh.visibility.IsFullyConnected())
             {
-                std::lock_guard<std::mutex> lock(transparent_chunks_mutex);
-                Position pos(x_, 0, z_);
-                for (int y = 0; y < CHUNK_HEIGHT / CHUNK_WIDTH; ++y)
+                sections_visibility.erase(section);
+            }
+            else
+            {
+                sections_visibility[section] = mesh.visibility;
+            }
+
+            // Don't keep the faces of the sections too far away with a memory budget
+            if (memory_budget.GetBudget() > 0)
+            {
+                float distance;
                 {
-                    pos.y = y;
-                    auto it = transparent_chunks.find(pos);
-                    if (it != transparent_chunks.end())
-                    {
-                        it->second->ClearFaces();
-                    }
+                    std::lock_guard<std::mutex> lock_camera(m_mutex_camera);
+                    distance = DistanceToCamera(section);
+                }
+                if (!memory_budget.KeepMesh(section, distance, !mesh.opaque_faces.empty() || !mesh.transparent_faces.empty()))
+                {
+                    mesh.opaque_faces.clear();
+                    mesh.transparent_faces.clear();
                 }
             }
 
-            if (chunk == nullptr)
+            auto chunk_it = chunks.find(section);
+            if (chunk_it != chunks.end())
             {
-                faces_should_be_updated = true;
-                return;
+                chunk_it->second->SetFaces(mesh.opaque_faces);
+            }
+            else if (!mesh.opaque_faces.empty())
+            {
+                std::shared_ptr<Chunk> chunk = std::shared_ptr<Chunk>(new Chunk);
+                chunk->SetFaces(mesh.opaque_faces);
+                chunks[section] = chunk;
+                sections_order_should_be_updated = true;
             }
 
-            auto& AssetsManager_ = AssetsManager::getInstance();
-
-            // For each block in the chunk, check its neighbours
-            // to see which face to draw
-            const std::vector<Position> neighbour_positions({ Position(0, -1, 0), Position(0, 0, -1),
-                            Position(-1, 0, 0), Position(1, 0, 0), Position(0, 0, 1), Position(0, 1, 0) });
-
-            std::vector<std::shared_ptr<Blockstate> > neighbour_blockstates(6);
-            std::vector<unsigned char> neighbour_model_ids(6);
-
-            Position pos;
-            for (int y = 0; y < CHUNK_HEIGHT; ++y)
             {
-                pos.y = y;
-                for (int z = 0; z < CHUNK_WIDTH; ++z)
+                std::lock_guard<std::mutex> transparent_lock(transparent_chunks_mutex);
+                auto transparent_chunk_it = transparent_chunks.find(section);
+                if (transparent_chunk_it != transparent_chunks.end())
                 {
-                    pos.z = z;
-                    for (int x = 0; x < CHUNK_WIDTH; ++x)
-                    {
-                        pos.x = x;
-
-                        // If this block is air, just skip it
-                        const Block* this_block = chunk->GetBlock(pos);
-                        if (this_block == nullptr ||
-                            this_block->GetBlockstate()->IsAir())
-                        {
-                            continue;
-                        }
-
-                        // Else check its neighbours to find which face to draw
-                        for (int i = 0; i < 6; ++i)
-                        {
-                            const Block* neighbour_block = chunk->GetBlock(pos + neighbour_positions[i]);
-                            if (neighbour_block == nullptr)
-                            {
-                                neighbour_blockstates[i] = nullptr;
-                                neighbour_model_ids[i] = 0;
-                            }
-                            else
-                            {
-                                neighbour_blockstates[i] = neighbour_block->GetBlockstate();
-                                neighbour_model_ids[i] = neighbour_block->GetModelId();
-                            }
-                        }
-
-                        //Check if this block is sourrounded by non transparent blocks
-                        for (int i = 0; i < neighbour_positions.size(); ++i)
-                        {
-                            if (neighbour_blockstates[i] == nullptr ||
-                                neighbour_blockstates[i]->IsTransparent())
-                            {
-                                break;
-                            }
-
-                            //If we are here, all the neigbhours are non transparent blocks, so
-                            //there is no face to add to the renderer
-                            if (i == neighbour_positions.size() - 1)
-                            {
-                                continue;
-                            }
-                        }
-
-                        //Add all faces of the current state
-                        const std::vector<FaceDescriptor>& current_faces = this_block->GetBlockstate()->GetModel(this_block->GetModelId()).GetFaces();
-#if PROTOCOL_VERSION < 552
-                        const std::shared_ptr<Biome> current_biome = AssetsManager_.GetBiome(chunk->GetBiome(x, z));
-#else
-                        const std::shared_ptr<Biome> current_biome = AssetsManager_.GetBiome(chunk->GetBiome(x, y, z));
-#endif
-
-                        for (int i = 0; i < current_faces.size(); ++i)
-                        {
-                            //Check if the neighbour in this direction is hidding this face
-                            // We also remove the faces between two transparent blocks with the same names
-                            // (example: faces between two water blocks)
-                            if (current_faces[i].cullface_direction == Orientation::None ||
-                                !neighbour_blockstates[(int)current_faces[i].cullface_direction] ||
-                                (neighbour_blockstates[(int)current_faces[i].cullface_direction]->IsTransparent() &&
-                                    neighbour_blockstates[(int)current_faces[i].cullface_direction]->GetName() != this_block->GetBlockstate()->GetName())
-                                )
-                            {
-                                AddFace(pos.x + CHUNK_WIDTH * x_, pos.y, pos.z + CHUNK_WIDTH * z_,
-                                    current_faces[i].face, current_faces[i].texture_names,
-                                    GetColorModifier(pos.y, current_biome, this_block->GetBlockstate(),
-                                        current_faces[i].use_tintindexes));
-                            }
-                        }
-                    }
+                    transparent_chunk_it->second->SetFaces(mesh.transparent_faces);
+                }
+                else if (!mesh.transparent_faces.empty())
+                {
+                    std::shared_ptr<TransparentChunk> transparent_chunk = std::shared_ptr<TransparentChunk>(new TransparentChunk);
+                    transparent_chunk->SetFaces(mesh.transparent_faces);
+                    transparent_chunks[section] = transparent_chunk;
+                    sections_order_should_be_updated = true;
                 }
             }
+
             faces_should_be_updated = true;
         }
 
@@ -286,6 +275,7 @@ namespace Botcraft
                 {
                     it->second->ClearFaces();
                 }
+                memory_budget.Clear();
             }
             {
                 std::lock_guard<std::mutex> lock(transparent_chunks_mutex);
@@ -297,6 +287,131 @@ namespace Botcraft
             faces_should_be_updated = true;
         }
 
+        void WorldRenderer::SetMemoryBudget(const size_t bytes)
+        {
+            std::lock_guard<std::mutex> lock(chunks_mutex);
+            memory_budget.SetBudget(bytes);
+        }
+
+        void WorldRenderer::GetSectionsToRestore(std::vector<Position>& sections)
+        {
+            std::lock_guard<std::mutex> lock(chunks_mutex);
+            std::lock_guard<std::mutex> lock_camera(m_mutex_camera);
+            memory_budget.GetSectionsToRestore([this](const Position& section) { return DistanceToCamera(section); }, sections);
+        }
+
+        void WorldRenderer::ReleaseEmptySections()
+        {
+            std::lock_guard<std::mutex> lock(chunks_mutex);
+            std::lock_guard<std::mutex> transparent_lock(transparent_chunks_mutex);
+            for (auto it = sections_version.begin(); it != sections_version.end();)
+            {
+                if (chunks.find(it->first) == chunks.end() &&
+                    transparent_chunks.find(it->first) == transparent_chunks.end() &&
+                    sections_visibility.find(it->first) == sections_visibility.end() &&
+                    !memory_budget.IsEvicted(it->first))
+                {
+                    it = sections_version.erase(it);
+                }
+                else
+                {
+                    ++it;
+                }
+            }
+            // Unordered maps never give their memory back when elements are removed
+            if (sections_version.bucket_count() > 4 * sections_version.size() + 64)
+            {
+                sections_version.rehash(0);
+            }
+            if (sections_visibility.bucket_count() > 4 * sections_visibility.size() + 64)
+            {
+                sections_visibility.rehash(0);
+            }
+        }
+
+        void WorldRenderer::GetMemoryStats(MemoryStats& stats)
+        {
+            std::lock_guard<std::mutex> lock(chunks_mutex);
+            stats.gpu_face_bytes = gpu_face_bytes;
+            stats.gpu_buffer_bytes = face_buffer ? face_buffer->GetAllocatedBytes() : 0;
+            stats.cpu_face_bytes = cpu_face_bytes;
+            stats.memory_budget = memory_budget.GetBudget();
+            stats.num_evicted_sections = static_cast<int>(memory_budget.GetNumEvicted());
+            stats.num_section_entries = static_cast<int>(sections_version.size());
+        }
+
+        void WorldRenderer::EnforceMemoryBudget()
+        {
+            gpu_face_bytes = 0;
+            cpu_face_bytes = 0;
+            for (auto it = chunks.begin(); it != chunks.end(); ++it)
+            {
+                gpu_face_bytes += it->second->GetNumFace() * sizeof(PackedFace);
+                cpu_face_bytes += it->second->GetCPUBytes();
+            }
+            {
+                std::lock_guard<std::mutex> transparent_lock(transparent_chunks_mutex);
+                for (auto it = transparent_chunks.begin(); it != transparent_chunks.end(); ++it)
+                {
+                    gpu_face_bytes += it->second->GetNumFace() * sizeof(PackedFace);
+                    cpu_face_bytes += it->second->GetCPUBytes();
+                }
+            }
+
+            if (!memory_budget.Update(gpu_face_bytes + cpu_face_bytes))
+            {
+                return;
+            }
+
+            // Memory used by each section
+            std::unordered_map<Position, size_t> sections_bytes;
+            for (auto it = chunks.begin(); it != chunks.end(); ++it)
+            {
+                sections_bytes[it->first] += it->second->GetNumFace() * sizeof(PackedFace) + it->second->GetCPUBytes();
+            }
+            {
+                std::lock_guard<std::mutex> transparent_lock(transparent_chunks_mutex);
+                for (auto it = transparent_chunks.begin(); it != transparent_chunks.end(); ++it)
+                {
+                    sections_bytes[it->first] += it->second->GetNumFace() * sizeof(PackedFace) + it->second->GetCPUBytes();
+                }
+            }
+
+            std::vector<SectionMemory> sections;
+            sections.reserve(sections_bytes.size());
+            {
+                std::lock_guard<std::mutex> lock_camera(m_mutex_camera);
+                for (auto it = sections_bytes.begin(); it != sections_bytes.end(); ++it)
+                {
+                    sections.push_back({ it->first, DistanceToCamera(it->first), it->second });
+                }
+            }
+
+            std::vector<Position> evicted;
+            memory_budget.Evict(gpu_face_bytes + cpu_face_bytes, sections, evicted);
+
+            std::lock_guard<std::mutex> transparent_lock(transparent_chunks_mutex);
+            for (int i = 0; i < evicted.size(); ++i)
+            {
+                auto chunk_it = chunks.find(evicted[i]);
+                if (chunk_it != chunks.end())
+                {
+                    // Give the range back to the buffer
+                    chunk_it->second->ClearFaces();
+                    chunk_it->second->Update(*face_buffer);
+                    chunks.erase(chunk_it);
+                }
+                auto transparent_chunk_it = transparent_chunks.find(evicted[i]);
+                if (transparent_chunk_it != transparent_chunks.end())
+                {
+                    transparent_chunk_it->second->ClearFaces();
+                    transparent_chunk_it->second->Update(*face_buffer);
+                    transparent_chunks.erase(transparent_chunk_it);
+                }
+                sections_order_should_be_updated = true;
+            }
+        }
+
         void WorldRenderer::SetPosOrientation(const double x_, const double y_, const double z_, const float yaw_, const float pitch_)
         {
             if (camera)
@@ -308,98 +423,143 @@ namespace Botcraft
         }
 
         void WorldRenderer::RenderFaces(int* num_chunks_, int* num_rendered_chunks_,
-            int* num_faces_, int* num_rendered_faces_)
+            int* num_occluded_chunks_, int* num_faces_, int* num_rendered_faces_,
+            size_t* uploaded_bytes_, size_t* buffer_bytes_,
+            float* sorting_time_)
         {
             const std::array<glm::vec4, 6>& frustum_planes = camera->GetFrustumPlanes();
 
-            // Get a list of all loaded chunks
-            std::unordered_set<Position> all_loaded_chunks;
-            all_loaded_chunks.reserve(chunks.size() + transparent_chunks.size());
-            int num_faces = 0;
+            const auto sort_start = std::chrono::steady_clock::now();
 
+            int num_faces = 0;
             chunks_mutex.lock();
             for (auto it = chunks.begin(); it != chunks.end(); ++it)
             {
-                all_loaded_chunks.insert(it->first);
                 num_faces += it->second->GetNumFace();
             }
             chunks_mutex.unlock();
             transparent_chunks_mutex.lock();
             for (auto it = transparent_chunks.begin(); it != transparent_chunks.end(); ++it)
             {
-                all_loaded_chunks.insert(it->first);
                 num_faces += it->second->GetNumFace();
             }
             transparent_chunks_mutex.unlock();
-            const int num_chunks = all_loaded_chunks.size();
 
-            // Apply frustum culling to render only the visible ones
-            std::vector<Position> chunks_to_render;
-            chunks_to_render.reserve(all_loaded_chunks.size());
-            // Frustum culling algorithm from http://old.cescg.org/CESCG-2002/DSykoraJJelinek/
-            for (auto it = all_loaded_chunks.begin(); it != all_loaded_chunks.end(); ++it)
+            if (sections_order_should_be_updated)
             {
-                FrustumResult result = FrustumResult::Inside;
-
-                const float min_x = CHUNK_WIDTH * (*it).x;
-                const float max_x = CHUNK_WIDTH * ((*it).x + 1);
-                const float min_y = (int)section_height * (*it).y;
-                const float max_y = (int)section_height * ((*it).y + 1);
-                const float min_z = CHUNK_WIDTH * (*it).z;
-                const float max_z = CHUNK_WIDTH * ((*it).z + 1);
+                sections_order_should_be_updated = false;
 
-                for (int i = 0; i < 6; ++i)
+                // Get a list of all loaded chunks
+                std::unordered_set<Position> all_loaded_chunks;
+                chunks_mutex.lock();
+                all_loaded_chunks.reserve(chunks.size());
+                for (auto it = chunks.begin(); it != chunks.end(); ++it)
                 {
-                    const bool sign_x = frustum_planes[i].x > 0.0f;
-                    const bool sign_y = frustum_planes[i].y > 0.0f;
-                    const bool sign_z = frustum_planes[i].z > 0.0f;
-
-                    const glm::vec4 p_vertex = glm::vec4(sign_x ? max_x : min_x, sign_y ? max_y : min_y, sign_z ? max_z : min_z, 1.0f);
-
-                    if (glm::dot(frustum_planes[i], p_vertex) < 0.0f)
-                    {
-                        result = FrustumResult::Outside;
-                        break;
-                    }
+                    all_loaded_chunks.insert(it->first);
+                }
+                chunks_mutex.unlock();
+                transparent_chunks_mutex.lock();
+                for (auto it = transparent_chunks.begin(); it != transparent_chunks.end(); ++it)
+                {
+                    all_loaded_chunks.insert(it->first);
+                }
+                transparent_chunks_mutex.unlock();
 
-                    const glm::vec4 n_vertex = glm::vec4(sign_x ? min_x : max_x, sign_y ? min_y : max_y, sign_z ? min_z : max_z, 1.0f);
+                sorted_sections.assign(all_loaded_chunks.begin(), all_loaded_chunks.end());
 
-                    if (glm::dot(frustum_planes[i], n_vertex) < 0.0f)
-                    {
-                        result = FrustumResult::Intersect;
-                    }
+                // Sort the chunks from far to near the camera
+                m_mutex_camera.lock();
+                std::vector<std::pair<float, Position> > distances(sorted_sections.size());
+                for (int i = 0; i < sorted_sections.size(); ++i)
+                {
+                    distances[i] = { DistanceToCamera(sorted_sections[i]), sorted_sections[i] };
+                }
+                m_mutex_camera.unlock();
+                std::sort(distances.begin(), distances.end(), [](const std::pair<float, Position>& d1, const std::pair<float, Position>& d2) {return d1.first > d2.first; });
+                for (int i = 0; i < distances.size(); ++i)
+                {
+                    sorted_sections[i] = distances[i].second;
                 }
+            }
+            const int num_chunks = sorted_sections.size();
+
+            // Occlusion culling, find the sections that can be seen through the
+            // non opaque blocks from the camera section. The search is limited
+            // to the box around the loaded sections and the camera
+            Position min_section = camera_section;
+            Position max_section = camera_section;
+            for (int i = 0; i < sorted_sections.size(); ++i)
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    min_section[j] = std::min(min_section[j], sorted_sections[i][j]);
+                    max_section[j] = std::max(max_section[j], sorted_sections[i][j]);
+                }
+            }
+            std::unordered_set<Position> visible_sections;
+            {
+                std::lock_guard<std::mutex> lock(chunks_mutex);
+                GetVisibleSections(camera_section, sections_visibility, min_section, max_section,
+                    [this, &frustum_planes](const Position& p) { return this->IsInFrustum(p, frustum_planes); },
+                    visible_sections);
+            }
 
-                if (result != FrustumResult::Outside)
+            // Apply frustum and occlusion culling to render only the
+            // visible ones (sorted_sections order is kept)
+            std::vector<Position> chunks_to_render;
+            chunks_to_render.reserve(sorted_sections.size());
+            int num_occluded_chunks = 0;
+            for (auto it = sorted_sections.begin(); it != sorted_sections.end(); ++it)
+            {
+                if (visible_sections.find(*it) != visible_sections.end())
                 {
                     chunks_to_render.push_back(*it);
                 }
+                else if (IsInFrustum(*it, frustum_planes))
+                {
+                    num_occluded_chunks++;
+                }
             }
 
-            // Sort the chunks from far to near the camera
             m_mutex_camera.lock();
-            std::sort(chunks_to_render.begin(), chunks_to_render.end(), [this](const Position& p1, const Position& p2) {return this->DistanceToCamera(p1) > this->DistanceToCamera(p2); });
+            const glm::vec3 cam_pos = camera->GetPosition();
             m_mutex_camera.unlock();
 
-            // Render all non partially transparent faces
+            // Sort the partially transparent faces first, as
+            // sorting sends them again to the face buffer
             const int num_rendered_chunks = chunks_to_render.size();
+            transparent_chunks_mutex.lock();
+            for (int i = 0; i < num_rendered_chunks; ++i)
+            {
+                auto found_it = transparent_chunks.find(chunks_to_render[i]);
+                if (found_it != transparent_chunks.end())
+                {
+                    found_it->second->Sort(cam_pos, GetSectionOrigin(chunks_to_render[i]), shape_centers, *face_buffer);
+                }
+            }
+            transparent_chunks_mutex.unlock();
+
+            const float sorting_time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - sort_start).count();
+
+            GLint current_program;
+            glGetIntegerv(GL_CURRENT_PROGRAM, &current_program);
+            face_buffer->Bind(current_program);
+
+            // Render all non partially transparent faces, from near
+            // to far so hidden fragments fail the depth test early
             int num_rendered_faces = 0;
             chunks_mutex.lock();
-            for (int i = 0; i < num_rendered_chunks; ++i)
+            for (int i = num_rendered_chunks - 1; i >= 0; --i)
             {
                 auto found_it = chunks.find(chunks_to_render[i]);
                 if (found_it != chunks.end())
                 {
-                    found_it->second->Render();
+                    found_it->second->Render(*face_buffer, GetSectionOrigin(chunks_to_render[i]));
                     num_rendered_faces += found_it->second->GetNumFace();
                 }
             }
             chunks_mutex.unlock();
 
-            m_mutex_camera.lock();
-            const glm::vec3 cam_pos = camera->GetPosition();
-            m_mutex_camera.unlock();
-
             // Render all partially transparent faces
             transparent_chunks_mutex.lock();
             for (int i = 0; i < num_rendered_chunks; ++i)
@@ -407,8 +567,7 @@ namespace Botcraft
                 auto found_it = transparent_chunks.find(chunks_to_render[i]);
                 if (found_it != transparent_chunks.end())
                 {
-                    found_it->second->Sort(cam_pos);
-                    found_it->second->Render();
+                    found_it->second->Render(*face_buffer, GetSectionOrigin(chunks_to_render[i]));
                     num_rendered_faces += found_it->second->GetNumFace();
                 }
             }
@@ -422,6 +581,10 @@ namespace Botcraft
             {
                 *num_rendered_chunks_ = num_rendered_chunks;
             }
+            if (num_occluded_chunks_)
+            {
+                *num_occluded_chunks_ = num_occluded_chunks;
+            }
             if (num_faces_)
             {
                 *num_faces_ = num_faces;
@@ -430,156 +593,63 @@ namespace Botcraft
             {
                 *num_rendered_faces_ = num_rendered_faces;
             }
-        }
-
-        void WorldRenderer::AddFace(const int x_, const int y_, const int z_, const Face& face_, const std::vector<std::string>& texture_identifiers_, const std::vector<unsigned int>& texture_multipliers_)
-        {
-            std::array<unsigned short, 4> atlas_pos = { 0 };
-            std::array<unsigned short, 4> atlas_size = { 0 };
-            std::array<Transparency, 2> transparencies = { Transparency::Opaque };
-            std::array<Animation, 2> animated = { Animation::Static };
-
-            for (int i = 0; i < std::min(2, (int)texture_identifiers_.size()); ++i)
-            {
-                const std::pair<int, int>& atlas_coords = atlas->GetPosition(texture_identifiers_[i]);
-                atlas_pos[2 * i + 0] = atlas_coords.first;
-                atlas_pos[2 * i + 1] = atlas_coords.second;
-                const std::pair<int, int>& atlas_dims = atlas->GetSize(texture_identifiers_[i]);
-                atlas_size[2 * i + 0] = atlas_dims.first;
-                atlas_size[2 * i + 1] = atlas_dims.second;
-                transparencies[i] = atlas->GetTransparency(texture_identifiers_[i]);
-                animated[i] = atlas->GetAnimation(texture_identifiers_[i]);
-            }
-
-            std::array<unsigned int, 2> texture_multipliers = { 0xFFFFFFFF };
-            for (int i = 0; i < std::min(2, (int)texture_multipliers_.size()); ++i)
+            if (uploaded_bytes_)
             {
-                texture_multipliers[i] = texture_multipliers_[i];
+                *uploaded_bytes_ = face_buffer->GetUploadedBytes();
             }
-
-            Face face(face_);
-            face.SetTextureMultipliers(texture_multipliers);
-
-            std::array<float, 4> coords = face.GetTextureCoords(false);
-            unsigned short height_normalizer = animated[0] == Animation::Animated ? atlas_size[0] : atlas_size[1];
-            for (int i = 0; i < 2; ++i)
+            if (buffer_bytes_)
             {
-                coords[2 * i + 0] = (atlas_pos[0] + coords[2 * i + 0] / 16.0f * atlas_size[0]) / atlas->GetWidth();
-                coords[2 * i + 1] = (atlas_pos[1] + coords[2 * i + 1] / 16.0f * height_normalizer) / atlas->GetHeight();
+                *buffer_bytes_ = face_buffer->GetAllocatedBytes();
             }
-            face.SetTextureCoords(coords, false);
-
-            if (texture_identifiers_.size() > 1)
+            if (sorting_time_)
             {
-                coords = face.GetTextureCoords(true);
-                height_normalizer = animated[1] == Animation::Animated ? atlas_size[2] : atlas_size[3];
-                for (int i = 0; i < 2; ++i)
-                {
-                    coords[2 * i + 0] = (atlas_pos[2] + coords[2 * i + 0] / 16.0f * atlas_size[2]) / atlas->GetWidth();
-                    coords[2 * i + 1] = (atlas_pos[3] + coords[2 * i + 1] / 16.0f * height_normalizer) / atlas->GetHeight();
-                }
-                face.SetTextureCoords(coords, true);
+                *sorting_time_ = sorting_time;
             }
+        }
 
-            //Add 0.5 because the origin of the block is at the center
-            //but the coordinates start from the block corner
-            face.GetMatrix()[12] += x_ + 0.5f;
-            face.GetMatrix()[13] += y_ + 0.5f;
-            face.GetMatrix()[14] += z_ + 0.5f;
+        const float WorldRenderer::DistanceToCamera(const Position& chunk) const
+        {
+            return camera->GetDistance(CHUNK_WIDTH * (chunk.x + 0.5f), section_height * (chunk.y + 0.5f), CHUNK_WIDTH * (chunk.z + 0.5f));
+        }
 
-            const Transparency transparency = transparencies[0];
-            if (transparency == Transparency::Opaque)
+        const bool WorldRenderer::IsInFrustum(const Position& section, const std::array<glm::vec4, 6>& frustum_planes) const
+        {
+            // Frustum culling algorithm from http://old.cescg.org/CESCG-2002/DSykoraJJelinek/
+            const float min_x = CHUNK_WIDTH * section.x;
+            const float max_x = CHUNK_WIDTH * (section.x + 1);
+            const float min_y = (int)section_height * section.y;
+            const float max_y = (int)section_height * (section.y + 1);
+            const float min_z = CHUNK_WIDTH * section.z;
+            const float max_z = CHUNK_WIDTH * (section.z + 1);
+
+            for (int i = 0; i < 6; ++i)
             {
-                face.SetDisplayBackface(false);
-            }
+                const bool sign_x = frustum_planes[i].x > 0.0f;
+                const bool sign_y = frustum_planes[i].y > 0.0f;
+                const bool sign_z = frustum_planes[i].z > 0.0f;
 
-            const Position position((int)floor(x_ / (double)CHUNK_WIDTH), (int)floor(y_ / (double)section_height), (int)floor(z_ / (double)CHUNK_WIDTH));
+                const glm::vec4 p_vertex = glm::vec4(sign_x ? max_x : min_x, sign_y ? max_y : min_y, sign_z ? max_z : min_z, 1.0f);
 
-            if (transparency == Transparency::Partial)
-            {
-                std::lock_guard<std::mutex> lock(transparent_chunks_mutex);
-                auto chunk_it = transparent_chunks.find(position);
-                if (chunk_it == transparent_chunks.end())
-                {
-                    transparent_chunks[position] = std::shared_ptr<TransparentChunk>(new TransparentChunk);
-                }
-                transparent_chunks[position]->AddFace(face);
-            }
-            else
-            {
-                std::lock_guard<std::mutex> lock(chunks_mutex);
-                auto chunk_it = chunks.find(position);
-                if (chunk_it == chunks.end())
+                // The box is completely outside of this plane
+                if (glm::dot(frustum_planes[i], p_vertex) < 0.0f)
                 {
-                    chunks[position] = std::shared_ptr<Chunk>(new Chunk);
+                    return false;
                 }
-                chunks[position]->AddFace(face);
             }
+            return true;
         }
 
-        const std::vector<unsigned int> WorldRenderer::GetColorModifier(const int y, const std::shared_ptr<Biome> biome, const std::shared_ptr<Blockstate> blockstate, const std::vector<bool>& use_tintindex) const
+        const glm::vec3 WorldRenderer::GetSectionOrigin(const Position& section) const
         {
-            std::vector<unsigned int> texture_modifier(use_tintindex.size(), 0xFFFFFFFF);
-            for (int i = 0; i < use_tintindex.size(); ++i)
-            {
-                switch (blockstate->GetTintType())
-                {
-                case TintType::None:
-                    break;
-                case TintType::Grass:
-                    if (use_tintindex[i])
-                    {
-                        if (biome)
-                        {
-                            texture_modifier[i] = biome->GetColorMultiplier(y, true);
-                        }
-                    }
-                    break;
-                case TintType::Leaves:
-                    if (use_tintindex[i])
-                    {
-                        if (biome)
-                        {
-                            texture_modifier[i] = biome->GetColorMultiplier(y, false);
-                        }
-                    }
-                    break;
-                    //Something like black when signal strength is 0 and red when it's 15
-                case TintType::Redstone:
-#if PROTOCOL_VERSION == 340 // 1.12.2
-                    texture_modifier[i] = 0xFF000000 | (25 + 15 * blockstate->GetMetadata());
-#elif PROTOCOL_VERSION == 393 // 1.13
-                    texture_modifier[i] = 0xFF000000 | (25 + 15 * (((blockstate->GetId() - 1752) / 9) % 16));
-#elif PROTOCOL_VERSION == 401 || PROTOCOL_VERSION == 404 // 1.13.1 && 1.13.2
-                    texture_modifier[i] = 0xFF000000 | (25 + 15 * (((blockstate->GetId() - 1753) / 9) % 16));
-#elif PROTOCOL_VERSION == 477 || PROTOCOL_VERSION == 480 || PROTOCOL_VERSION == 485 || PROTOCOL_VERSION == 490 || PROTOCOL_VERSION == 498 // 1.14.X
-                    texture_modifier[i] = 0xFF000000 | (25 + 15 * (((blockstate->GetId() - 2056) / 9) % 16));
-#elif PROTOCOL_VERSION == 573 || PROTOCOL_VERSION == 575 || PROTOCOL_VERSION == 578 // 1.15.X
-                    texture_modifier[i] = 0xFF000000 | (25 + 15 * (((blockstate->GetId() - 2056) / 9) % 16));
-#elif PROTOCOL_VERSION == 735 || PROTOCOL_VERSION == 736 || PROTOCOL_VERSION == 751 || PROTOCOL_VERSION == 753  || PROTOCOL_VERSION == 754 // 1.16.X
-                    texture_modifier[i] = 0xFF000000 | (25 + 15 * (((blockstate->GetId() - 2058) / 9) % 16));
-#elif PROTOCOL_VERSION == 755 || PROTOCOL_VERSION == 756 // 1.17.X
-                    texture_modifier[i] = 0xFF000000 | (25 + 15 * (((blockstate->GetId() - 2114) / 9) % 16));
-#else
-                    #error "Protocol version not implemented"
-#endif
-                    break;
-                case TintType::Water:
-                    if (biome)
-                    {
-                        texture_modifier[i] = biome->GetWaterColorMultiplier();
-                    }
-                    break;
-                default:
-                    break;
-                }
-            }
-            return texture_modifier;
+            return glm::vec3(CHUNK_WIDTH * section.x, (int)section_height * section.y, CHUNK_WIDTH * section.z);
         }
 
-        const float WorldRenderer::DistanceToCamera(const Position& chunk) const
+        const Position WorldRenderer::GetSection(const Position& block) const
         {
-            return camera->GetDistance(CHUNK_WIDTH * (chunk.x + 0.5f), section_height * (chunk.y + 0.5f), CHUNK_WIDTH * (chunk.z + 0.5f));
+            return Position(
+                static_cast<int>(std::floor(block.x / static_cast<double>(CHUNK_WIDTH))),
+                static_cast<int>(std::floor(block.y / static_cast<double>(section_height))),
+                static_cast<int>(std::floor(block.z / static_cast<double>(CHUNK_WIDTH))));
         }
     } // Renderer
 } // Botcraft
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include "botcraft/Utilities/Fiber.hpp"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <ucontext.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstdint>
+#endif
+
+namespace Botcraft
+{
+#ifdef _WIN32
+    struct Fiber::Context
+    {
+        static void WINAPI EntryPoint(void* param)
+        {
+            Fiber::Run(static_cast<Fiber*>(param));
+        }
+
+        void* fiber = nullptr;
+        void* caller = nullptr;
+    };
+
+    Fiber::Fiber(const std::function<void()>& function_, const size_t stack_size) :
+        function(function_), context(new Context), started(false), finished(false), running(false), unwinding(false)
+    {
+        // Stack is reserved, only a page is committed at start
+        context->fiber = CreateFiberEx(0, stack_size, FIBER_FLAG_FLOAT_SWITCH, Context::EntryPoint, this);
+        if (context->fiber == nullptr)
+        {
+            throw(std::runtime_error("Error creating fiber"));
+        }
+    }
+
+    Fiber::~Fiber()
+    {
+        UnwindStack();
+        if (context->fiber != nullptr)
+        {
+            DeleteFiber(context->fiber);
+        }
+    }
+
+    void Fiber::Resume()
+    {
+        if (finished || running)
+        {
+            return;
+        }
+
+        // Only fibers can switch to another fiber
+        if (!IsThreadAFiber())
+        {
+            ConvertThreadToFiberEx(nullptr, FIBER_FLAG_FLOAT_SWITCH);
+        }
+        context->caller = GetCurrentFiber();
+        started = true;
+        running = true;
+        SwitchToFiber(context->fiber);
+        running = false;
+
+        if (exception)
+        {
+            std::exception_ptr e = exception;
+            exception = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+    void Fiber::Suspend()
+    {
+        SwitchToFiber(context->caller);
+        if (unwinding)
+        {
+            throw Unwind();
+        }
+    }
+#else
+    struct Fiber::Context
+    {
+        // makecontext only accepts int arguments, the
+        // pointer is split in two halves
+        static void EntryPoint(const unsigned int high, const unsigned int low)
+        {
+            const std::uintptr_t ptr = (static_cast<std::uintptr_t>(high) << 16 << 16) | static_cast<std::uintptr_t>(low);
+            Fiber::Run(reinterpret_cast<Fiber*>(ptr));
+        }
+
+        ucontext_t fiber;
+        ucontext_t caller;
+        void* stack = nullptr;
+        size_t mapped_size = 0;
+    };
+
+    Fiber::Fiber(const std::function<void()>& function_, const size_t stack_size) :
+        function(function_), context(new Context), started(false), finished(false), running(false), unwinding(false)
+    {
+        const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        const size_t usable_size = ((stack_size + page_size - 1) / page_size) * page_size;
+
+        // One extra page at the bottom as a guard against stack overflows
+        context->mapped_size = usable_size + page_size;
+        context->stack = mmap(nullptr, context->mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (context->stack == MAP_FAILED)
+        {
+            context->stack = nullptr;
+            throw(std::runtime_error("Error allocating fiber stack"));
+        }
+        mprotect(context->stack, page_size, PROT_NONE);
+
+        getcontext(&context->fiber);
+        context->fiber.uc_stack.ss_sp = static_cast<char*>(context->stack) + page_size;
+        context->fiber.uc_stack.ss_size = usable_size;
+        context->fiber.uc_link = nullptr;
+
+        const std::uintptr_t ptr = reinterpret_cast<std::uintptr_t>(this);
+        makecontext(&context->fiber, reinterpret_cast<void(*)()>(Context::EntryPoint), 2,
+            static_cast<unsigned int>(ptr >> 16 >> 16), static_cast<unsigned int>(ptr & 0xFFFFFFFF));
+    }
+
+    Fiber::~Fiber()
+    {
+        UnwindStack();
+        if (context->stack != nullptr)
+        {
+            munmap(context->stack, context->mapped_size);
+        }
+    }
+
+    void Fiber::Resume()
+    {
+        if (finished || running)
+        {
+            return;
+        }
+
+        started = true;
+        running = true;
+        swapcontext(&context->caller, &context->fiber);
+        running = false;
+
+        if (exception)
+        {
+            std::exception_ptr e = exception;
+            exception = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+    void Fiber::Suspend()
+    {
+        swapcontext(&context->fiber, &context->caller);
+        if (unwinding)
+        {
+            throw Unwind();
+        }
+    }
+#endif
+
+    const bool Fiber::IsFinished() const
+    {
+        return finished;
+    }
+
+    void Fiber::Run(Fiber* fiber)
+    {
+        // Exceptions can't go through the fiber entry
+        // point, they are forwarded to Resume instead
+        try
+        {
+            fiber->function();
+        }
+        catch (const Unwind&)
+        {
+            // Destroyed while suspended, the stack is unwound
+        }
+        catch (...)
+        {
+            fiber->exception = std::current_exception();
+        }
+        fiber->finished = true;
+
+        // Never return from the entry point, just switch
+        // back to the caller for the last time
+        while (true)
+        {
+            fiber->Suspend();
+        }
+    }
+
+    void Fiber::UnwindStack()
+    {
+        if (!started || finished || running)
+        {
+            return;
+        }
+
+        unwinding = true;
+        while (!finished)
+        {
+            try
+            {
+                Resume();
+            }
+            catch (...)
+            {
+                // Exceptions thrown while unwinding are lost, the destructor can't throw
+            }
+        }
+    }
+} // namespace Botcraft
@@ -0,0 +1,114 @@
+#include "botcraft/Utilities/MemoryMappedFile.hpp"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Botcraft
+{
+#ifdef _WIN32
+    MemoryMappedFile::MemoryMappedFile(const std::string& path)
+    {
+        data = nullptr;
+        size = 0;
+        mapping_handle = nullptr;
+
+        file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_handle == INVALID_HANDLE_VALUE)
+        {
+            file_handle = nullptr;
+            return;
+        }
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0)
+        {
+            return;
+        }
+
+        mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_handle == nullptr)
+        {
+            return;
+        }
+
+        data = static_cast<const char*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+        if (data != nullptr)
+        {
+            size = static_cast<size_t>(file_size.QuadPart);
+        }
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        if (data != nullptr)
+        {
+            UnmapViewOfFile(data);
+        }
+        if (mapping_handle != nullptr)
+        {
+            CloseHandle(mapping_handle);
+        }
+        if (file_handle != nullptr)
+        {
+            CloseHandle(file_handle);
+        }
+    }
+#else
+    MemoryMappedFile::MemoryMappedFile(const std::string& path)
+    {
+        data = nullptr;
+        size = 0;
+
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+        {
+            return;
+        }
+
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0)
+        {
+            void* mapped = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            if (mapped != MAP_FAILED)
+            {
+                data = static_cast<const char*>(mapped);
+                size = static_cast<size_t>(file_stat.st_size);
+            }
+        }
+
+        // The mapping stays valid after the file is closed
+        close(fd);
+    }
+
+    MemoryMappedFile::~MemoryMappedFile()
+    {
+        if (data != nullptr)
+        {
+            munmap(const_cast<char*>(data), size);
+        }
+    }
+#endif
+
+    const bool MemoryMappedFile::IsOpen() const
+    {
+        return data != nullptr;
+    }
+
+    const char* MemoryMappedFile::GetData() const
+    {
+        return data;
+    }
+
+    const size_t MemoryMappedFile::GetSize() const
+    {
+        return size;
+    }
+} // Botcraft
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <iostream>
+
+// Minimal check utilities, as no test framework is used.
+// A failed check is reported but the test keeps running,
+// main returns TEST_RESULT() to tell ctest if all checks passed
+
+namespace Botcraft
+{
+    namespace Tests
+    {
+        inline int& NumFailedChecks()
+        {
+            static int num_failed_checks = 0;
+            return num_failed_checks;
+        }
+    } // Tests
+} // Botcraft
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " << #condition << std::endl; \
+            ++Botcraft::Tests::NumFailedChecks(); \
+        } \
+    } while (false)
+
+#define TEST_RESULT() (Botcraft::Tests::NumFailedChecks() == 0 ? 0 : 1)
@@ -0,0 +1,130 @@
+#include <vector>
+#include <random>
+
+#include "botcraft/Game/AABB.hpp"
+
+#include "TestUtilities.hpp"
+
+using namespace Botcraft;
+
+// AABB::SweptCollide over an AABBArray must give the same
+// result as testing the boxes one by one with the scalar
+// version and keeping the first collision
+
+namespace
+{
+    const int NUM_CASES = 20000;
+
+    double ScalarSweptCollide(const AABB& box, const Vector3<double>& speed, const std::vector<AABB>& boxes, Vector3<double>& normal)
+    {
+        double best_time = 1.0;
+        for (size_t i = 0; i < boxes.size(); ++i)
+        {
+            Vector3<double> current_normal;
+            const double time = box.SweptCollide(speed, boxes[i], current_normal);
+            if (time < best_time)
+            {
+                best_time = time;
+                normal = current_normal;
+            }
+        }
+        return best_time;
+    }
+
+    // Block aligned boxes like the ones sent by the
+    // physics, with full and partial heights
+    AABB RandomBlockBox(std::mt19937& random_gen)
+    {
+        std::uniform_int_distribution<int> position_dist(-3, 3);
+        std::uniform_int_distribution<int> height_dist(1, 4);
+        const double half_height = height_dist(random_gen) / 8.0;
+        return AABB(Vector3<double>(position_dist(random_gen) + 0.5, position_dist(random_gen) + half_height, position_dist(random_gen) + 0.5),
+            Vector3<double>(0.5, half_height, 0.5));
+    }
+
+    AABB RandomBox(std::mt19937& random_gen)
+    {
+        std::uniform_real_distribution<double> position_dist(-3.0, 3.0);
+        std::uniform_real_distribution<double> size_dist(0.05, 1.0);
+        return AABB(Vector3<double>(position_dist(random_gen), position_dist(random_gen), position_dist(random_gen)),
+            Vector3<double>(size_dist(random_gen), size_dist(random_gen), size_dist(random_gen)));
+    }
+
+    Vector3<double> RandomSpeed(std::mt19937& random_gen)
+    {
+        std::uniform_real_distribution<double> speed_dist(-2.0, 2.0);
+        std::uniform_int_distribution<int> zero_dist(0, 3);
+        Vector3<double> speed(speed_dist(random_gen), speed_dist(random_gen), speed_dist(random_gen));
+        // Null axis are frequent during physics (no horizontal input, on ground...)
+        for (int i = 0; i < 3; ++i)
+        {
+            if (zero_dist(random_gen) == 0)
+            {
+                speed[i] = 0.0;
+            }
+        }
+        return speed;
+    }
+}
+
+void TestEmptyArray()
+{
+    const AABB box(Vector3<double>(0.0, 0.0, 0.0), Vector3<double>(0.3, 0.9, 0.3));
+    const AABBArray boxes;
+    Vector3<double> normal(2.0, 2.0, 2.0);
+    CHECK(box.SweptCollide(Vector3<double>(1.0, -1.0, 0.0), boxes, normal) == 1.0);
+    CHECK(normal == Vector3<double>(2.0, 2.0, 2.0));
+}
+
+void TestMatchScalar(const bool block_aligned)
+{
+    std::mt19937 random_gen(block_aligned ? 1 : 2);
+    std::uniform_int_distribution<int> num_boxes_dist(1, 40);
+    int num_collisions = 0;
+
+    for (int n = 0; n < NUM_CASES; ++n)
+    {
+        // Player sized box
+        const AABB player(Vector3<double>(0.1, 0.9, -0.2), Vector3<double>(0.3, 0.9, 0.3));
+        const Vector3<double> speed = RandomSpeed(random_gen);
+
+        std::vector<AABB> boxes;
+        AABBArray boxes_array;
+        const int num_boxes = num_boxes_dist(random_gen);
+        for (int i = 0; i < num_boxes; ++i)
+        {
+            const AABB box = block_aligned ? RandomBlockBox(random_gen) : RandomBox(random_gen);
+            // Boxes already intersecting are not considered by the physics
+            if (box.Collide(player))
+            {
+                continue;
+            }
+            boxes.push_back(box);
+            boxes_array.Add(box);
+        }
+
+        Vector3<double> scalar_normal(0.0, 0.0, 0.0);
+        const double scalar_time = ScalarSweptCollide(player, speed, boxes, scalar_normal);
+        Vector3<double> array_normal(0.0, 0.0, 0.0);
+        const double array_time = player.SweptCollide(speed, boxes_array, array_normal);
+
+        CHECK(array_time == scalar_time);
+        if (scalar_time < 1.0)
+        {
+            num_collisions += 1;
+            CHECK(array_normal == scalar_normal);
+        }
+    }
+
+    // Make sure the cases are not trivial
+    CHECK(num_collisions > NUM_CASES / 10);
+}
+
+int main(int argc, char* argv[])
+{
+    TestEmptyArray();
+    TestMatchScalar(true);
+    TestMatchScalar(false);
+
+    return TEST_RESULT();
+}
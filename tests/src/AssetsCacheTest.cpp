@@ -0,0 +1,281 @@
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "botcraft/Game/AABB.hpp"
+#include "botcraft/Game/Model.hpp"
+#include "botcraft/Game/AssetsCache.hpp"
+#include "botcraft/Game/World/Biome.hpp"
+#include "botcraft/Game/World/Blockstate.hpp"
+#include "botcraft/Game/Inventory/Item.hpp"
+
+#include "TestUtilities.hpp"
+
+using namespace Botcraft;
+
+// Blockstates, biomes, items and texture names written in a cache
+// file must be read back with the same values. The file must be
+// rejected if it was built from other sources, with another format
+// version, or if it is corrupted, and the source signature must
+// change when any of the json files it is built from changes
+
+namespace
+{
+    const unsigned long long int SIGNATURE = 0x0123456789ABCDEFULL;
+
+    const std::filesystem::path GetTestFolder()
+    {
+        return std::filesystem::temp_directory_path() / "botcraft_assets_cache_test";
+    }
+
+    const std::vector<char> ReadFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void WriteFile(const std::filesystem::path& path, const std::vector<char>& data)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), data.size());
+    }
+
+    void WriteFile(const std::filesystem::path& path, const std::string& content)
+    {
+        WriteFile(path, std::vector<char>(content.begin(), content.end()));
+    }
+
+    bool IsEqual(const AABB& a, const AABB& b)
+    {
+        return a.GetCenter() == b.GetCenter() && a.GetHalfSize() == b.GetHalfSize();
+    }
+
+    void TestRoundTrip(const std::string& path)
+    {
+        Model slab;
+        slab.GetColliders().push_back(AABB(Vector3<double>(0.5, 0.25, 0.5), Vector3<double>(0.5, 0.25, 0.5)));
+        Model stairs;
+        stairs.GetColliders().push_back(AABB(Vector3<double>(0.5, 0.25, 0.5), Vector3<double>(0.5, 0.25, 0.5)));
+        stairs.GetColliders().push_back(AABB(Vector3<double>(0.5, 0.75, 0.75), Vector3<double>(0.5, 0.25, 0.25)));
+
+#if PROTOCOL_VERSION < 347
+        const Blockstate stone(1, 0, false, true, false, 1.5f, TintType::None, "minecraft:stone", slab);
+        const Blockstate water(9, 3, true, false, true, 100.0f, TintType::Water, "minecraft:water", Model());
+        const Blockstate oak_stairs(53, 2, true, true, false, 2.0f, TintType::None, "minecraft:oak_stairs", std::vector<Model>{ stairs, slab }, std::vector<int>{ 3, 1 });
+#else
+        const Blockstate stone(1, false, true, false, 1.5f, TintType::None, "minecraft:stone", slab);
+        const Blockstate water(42, true, false, true, 100.0f, TintType::Water, "minecraft:water", Model());
+        const Blockstate oak_stairs(1234, true, true, false, 2.0f, TintType::None, "minecraft:oak_stairs", std::vector<Model>{ stairs, slab }, std::vector<int>{ 3, 1 });
+#endif
+        const Biome plains("minecraft:plains", 0.8f, 0.4f, BiomeType::Classic);
+        const Biome swamp("minecraft:swamp", 0.8f, 0.9f, BiomeType::Swamp);
+#if PROTOCOL_VERSION < 347
+        const Item stone_item(1, 0, "minecraft:stone");
+        const Item granite_item(1, 1, "minecraft:granite");
+#else
+        const Item stone_item(1, "minecraft:stone");
+        const Item granite_item(2, "minecraft:granite");
+#endif
+
+        AssetsCache::Writer writer(SIGNATURE);
+        writer.AddBlockstate(stone);
+        writer.AddBlockstate(water, 5);
+        writer.AddBlockstate(oak_stairs);
+        writer.AddBiome(1, plains);
+        writer.AddBiome(6, swamp);
+        writer.AddItem(stone_item);
+        writer.AddItem(granite_item);
+        writer.AddTexture("block/stone");
+        writer.AddTexture("block/water_still");
+        CHECK(writer.Save(path));
+
+        const AssetsCache::Reader reader(path, SIGNATURE);
+        CHECK(reader.IsValid());
+        if (!reader.IsValid())
+        {
+            return;
+        }
+
+        const std::vector<Model> models = reader.CreateModels();
+        std::vector<unsigned char> key_metadata;
+        const std::vector<std::shared_ptr<Blockstate> > blockstates = reader.CreateBlockstates(models, key_metadata);
+        CHECK(blockstates.size() == 3);
+        CHECK(key_metadata.size() == 3);
+        if (blockstates.size() == 3 && key_metadata.size() == 3)
+        {
+            const Blockstate& read_stone = *blockstates[0];
+            CHECK(read_stone.GetId() == stone.GetId());
+            CHECK(read_stone.GetName() == "minecraft:stone");
+            CHECK(read_stone.GetNameId() == stone.GetNameId());
+            CHECK(!read_stone.IsTransparent() && read_stone.IsSolid() && !read_stone.IsFluid());
+            CHECK(read_stone.GetHardness() == 1.5f);
+            CHECK(read_stone.GetTintType() == TintType::None);
+            CHECK(read_stone.GetNumModels() == 1);
+            CHECK(read_stone.GetModel(0).GetColliders().size() == 1);
+            CHECK(IsEqual(read_stone.GetModel(0).GetColliders()[0], slab.GetColliders()[0]));
+            CHECK(key_metadata[0] == 0);
+
+            const Blockstate& read_water = *blockstates[1];
+            CHECK(read_water.GetId() == water.GetId());
+#if PROTOCOL_VERSION < 347
+            CHECK(read_water.GetMetadata() == 3);
+#endif
+            CHECK(read_water.GetName() == "minecraft:water");
+            CHECK(read_water.IsTransparent() && !read_water.IsSolid() && read_water.IsFluid());
+            CHECK(read_water.GetHardness() == 100.0f);
+            CHECK(read_water.GetTintType() == TintType::Water);
+            CHECK(read_water.GetModel(0).GetColliders().empty());
+            CHECK(key_metadata[1] == 5);
+
+            const Blockstate& read_stairs = *blockstates[2];
+            CHECK(read_stairs.GetName() == "minecraft:oak_stairs");
+            CHECK(read_stairs.GetNumModels() == 2);
+            CHECK(read_stairs.GetModelWeight(0) == 3 && read_stairs.GetModelWeight(1) == 1);
+            CHECK(read_stairs.GetModel(0).GetColliders().size() == 2);
+            CHECK(read_stairs.GetModel(1).GetColliders().size() == 1);
+            if (read_stairs.GetModel(0).GetColliders().size() == 2)
+            {
+                CHECK(IsEqual(read_stairs.GetModel(0).GetColliders()[1], stairs.GetColliders()[1]));
+            }
+            // Same variant picked at any position
+            for (int i = 0; i < 16; ++i)
+            {
+                const Position pos(i * 7, i, -i * 3);
+                CHECK(read_stairs.GetModelId(pos) == oak_stairs.GetModelId(pos));
+            }
+        }
+
+        const std::vector<std::pair<int, std::shared_ptr<Biome> > > biomes = reader.CreateBiomes();
+        CHECK(biomes.size() == 2);
+        if (biomes.size() == 2)
+        {
+            CHECK(biomes[0].first == 1);
+            CHECK(biomes[0].second->GetName() == "minecraft:plains");
+            CHECK(biomes[0].second->GetTemperature() == 0.8f);
+            CHECK(biomes[0].second->GetRainfall() == 0.4f);
+            CHECK(biomes[0].second->GetBiomeType() == BiomeType::Classic);
+            CHECK(biomes[1].first == 6);
+            CHECK(biomes[1].second->GetName() == "minecraft:swamp");
+            CHECK(biomes[1].second->GetRainfall() == 0.9f);
+            CHECK(biomes[1].second->GetBiomeType() == BiomeType::Swamp);
+        }
+
+        const std::vector<std::shared_ptr<Item> > items = reader.CreateItems();
+        CHECK(items.size() == 2);
+        if (items.size() == 2)
+        {
+            CHECK(items[0]->GetId() == 1);
+            CHECK(items[0]->GetName() == "minecraft:stone");
+            CHECK(items[1]->GetId() == granite_item.GetId());
+            CHECK(items[1]->GetName() == "minecraft:granite");
+#if PROTOCOL_VERSION < 347
+            CHECK(items[1]->GetDamageId() == 1);
+#endif
+        }
+
+        CHECK(reader.GetNumTextures() == 2);
+        CHECK(reader.GetTextureName(0) == "block/stone");
+        CHECK(reader.GetTextureName(1) == "block/water_still");
+    }
+
+    void TestStaleFile(const std::string& path)
+    {
+        const std::filesystem::path patched_path = GetTestFolder() / "patched_cache.bin";
+        const std::vector<char> data = ReadFile(path);
+        CHECK(data.size() > sizeof(AssetsCache::Header));
+
+        // Built from other json files
+        CHECK(!AssetsCache::Reader(path, SIGNATURE + 1).IsValid());
+
+        // Missing file
+        CHECK(!AssetsCache::Reader((GetTestFolder() / "missing_cache.bin").string(), SIGNATURE).IsValid());
+
+        // Written with an older layout
+        std::vector<char> patched = data;
+        const unsigned int old_version = AssetsCache::FORMAT_VERSION - 1;
+        std::memcpy(patched.data() + offsetof(AssetsCache::Header, format_version), &old_version, sizeof(old_version));
+        WriteFile(patched_path, patched);
+        CHECK(!AssetsCache::Reader(patched_path.string(), SIGNATURE).IsValid());
+
+        // Not a cache file
+        patched = data;
+        patched[0] = 'X';
+        WriteFile(patched_path, patched);
+        CHECK(!AssetsCache::Reader(patched_path.string(), SIGNATURE).IsValid());
+
+        // Truncated, in the sections and in the header
+        patched = std::vector<char>(data.begin(), data.end() - 1);
+        WriteFile(patched_path, patched);
+        CHECK(!AssetsCache::Reader(patched_path.string(), SIGNATURE).IsValid());
+        patched = std::vector<char>(data.begin(), data.begin() + sizeof(AssetsCache::Header) / 2);
+        WriteFile(patched_path, patched);
+        CHECK(!AssetsCache::Reader(patched_path.string(), SIGNATURE).IsValid());
+
+        // Unmodified copy is still valid
+        WriteFile(patched_path, data);
+        CHECK(AssetsCache::Reader(patched_path.string(), SIGNATURE).IsValid());
+    }
+
+    void TestSourceSignature()
+    {
+        const std::filesystem::path assets = GetTestFolder() / "Assets";
+        std::filesystem::create_directories(assets / "custom");
+        std::filesystem::create_directories(assets / "minecraft" / "blockstates");
+        std::filesystem::create_directories(assets / "minecraft" / "models");
+        const std::filesystem::path blockstate = assets / "minecraft" / "blockstates" / "stone.json";
+        WriteFile(assets / "custom" / "Blocks_info.json", "{}");
+        WriteFile(blockstate, "{ \"variants\": {} }");
+
+        const unsigned long long int signature = AssetsCache::ComputeSourceSignature(assets.string());
+        CHECK(AssetsCache::ComputeSourceSignature(assets.string()) == signature);
+
+        // Files the cache is not built from are ignored
+        WriteFile(assets / "readme.txt", "not an asset");
+        CHECK(AssetsCache::ComputeSourceSignature(assets.string()) == signature);
+
+        // Same size, new modification time
+        const std::filesystem::file_time_type write_time = std::filesystem::last_write_time(blockstate);
+        WriteFile(blockstate, "{ \"variants\": [] }");
+        std::filesystem::last_write_time(blockstate, write_time + std::chrono::hours(1));
+        const unsigned long long int modified_signature = AssetsCache::ComputeSourceSignature(assets.string());
+        CHECK(modified_signature != signature);
+
+        // New size
+        std::filesystem::last_write_time(blockstate, write_time);
+        WriteFile(blockstate, "{ \"variants\": { \"\": {} } }");
+        std::filesystem::last_write_time(blockstate, write_time);
+        const unsigned long long int resized_signature = AssetsCache::ComputeSourceSignature(assets.string());
+        CHECK(resized_signature != signature);
+        CHECK(resized_signature != modified_signature);
+
+        // New file
+        WriteFile(assets / "minecraft" / "models" / "stone.json", "{}");
+        const unsigned long long int added_signature = AssetsCache::ComputeSourceSignature(assets.string());
+        CHECK(added_signature != resized_signature);
+
+        // And removed again
+        std::filesystem::remove(assets / "minecraft" / "models" / "stone.json");
+        CHECK(AssetsCache::ComputeSourceSignature(assets.string()) == resized_signature);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::filesystem::remove_all(GetTestFolder());
+    std::filesystem::create_directories(GetTestFolder());
+    const std::string path = (GetTestFolder() / "assets_cache.bin").string();
+
+    TestRoundTrip(path);
+    TestStaleFile(path);
+    TestSourceSignature();
+
+    std::filesystem::remove_all(GetTestFolder());
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "botcraft/Renderer/Atlas.hpp"
+#include "botcraft/Renderer/ImageSaver.hpp"
+
+#include "TestUtilities.hpp"
+
+using namespace Botcraft::Renderer;
+
+// An atlas loaded from its cache file must be the same as the one
+// built from the textures. The cache file must be used as long as the
+// textures are unchanged, and rebuilt when a texture is modified or
+// added or when the file is corrupted
+
+namespace
+{
+    const std::filesystem::path GetTestFolder()
+    {
+        return std::filesystem::temp_directory_path() / "botcraft_atlas_cache_test";
+    }
+
+    const std::vector<char> ReadFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void WriteFile(const std::filesystem::path& path, const std::vector<char>& data)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), data.size());
+    }
+
+    // Write a width x height texture of the given color, with
+    // the alpha of the first row replaced by first_row_alpha
+    const std::pair<std::string, std::string> WriteTexture(const std::string& name, const int width, const int height,
+        const unsigned char r, const unsigned char g, const unsigned char b, const unsigned char first_row_alpha = 255)
+    {
+        std::vector<unsigned char> pixels(width * height * 4);
+        for (int i = 0; i < width * height; ++i)
+        {
+            pixels[4 * i + 0] = r;
+            pixels[4 * i + 1] = g;
+            pixels[4 * i + 2] = b;
+            pixels[4 * i + 3] = i < width ? first_row_alpha : 255;
+        }
+        const std::string path = (GetTestFolder() / (name + ".png")).string();
+        WriteImage(path, height, width, 4, pixels.data(), false);
+        return { path, "block/" + name };
+    }
+
+    // Color of the top left pixel of a texture in the atlas
+    const std::vector<unsigned char> GetTexturePixel(Atlas& atlas, const std::string& name, const int row = 0)
+    {
+        const std::pair<int, int>& position = atlas.GetPosition(name);
+        const unsigned char* pixel = atlas.Get(position.second + row, position.first);
+        return std::vector<unsigned char>(pixel, pixel + 4);
+    }
+
+    bool IsSameAtlas(Atlas& a, Atlas& b, const std::vector<std::pair<std::string, std::string> >& textures)
+    {
+        if (a.GetWidth() != b.GetWidth() || a.GetHeight() != b.GetHeight())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < textures.size(); ++i)
+        {
+            const std::string& name = textures[i].second;
+            if (a.GetPosition(name) != b.GetPosition(name) ||
+                a.GetSize(name) != b.GetSize(name) ||
+                a.GetTransparency(name) != b.GetTransparency(name) ||
+                a.GetAnimation(name) != b.GetAnimation(name))
+            {
+                return false;
+            }
+        }
+        return std::equal(a.Get(), a.Get() + a.GetWidth() * a.GetHeight() * 4, b.Get());
+    }
+
+    // Alpha value written in the last pixel of the cache file, the
+    // atlas built from the textures is opaque there
+    const unsigned char MARK = 42;
+
+    // Replace the last pixel byte of the cache file, so an
+    // atlas read from it can be told apart from a built one
+    void MarkCacheFile(const std::filesystem::path& path)
+    {
+        std::vector<char> data = ReadFile(path);
+        data.back() = static_cast<char>(MARK);
+        const std::filesystem::file_time_type write_time = std::filesystem::last_write_time(path);
+        WriteFile(path, data);
+        std::filesystem::last_write_time(path, write_time);
+    }
+
+    bool IsMarked(Atlas& atlas)
+    {
+        return atlas.Get()[atlas.GetWidth() * atlas.GetHeight() * 4 - 1] == MARK;
+    }
+
+    void TestAtlasCache()
+    {
+        const std::filesystem::path cache_path = GetTestFolder() / "atlas_cache.bin";
+
+        std::vector<std::pair<std::string, std::string> > textures;
+        textures.push_back(WriteTexture("red", 16, 16, 255, 0, 0));
+        textures.push_back(WriteTexture("green", 16, 32, 0, 255, 0, 128));
+        textures.push_back(WriteTexture("blue", 32, 32, 0, 0, 255, 0));
+        std::ofstream(textures[2].first + ".mcmeta") << "{ \"animation\": {} }";
+
+        // No cache file yet, built from the textures and written
+        Atlas built;
+        built.LoadData(textures, cache_path.string());
+        CHECK(std::filesystem::exists(cache_path));
+        CHECK(built.GetSize("block/red") == std::make_pair(16, 16));
+        CHECK(built.GetSize("block/green") == std::make_pair(16, 32));
+        CHECK(built.GetTransparency("block/red") == Transparency::Opaque);
+        CHECK(built.GetTransparency("block/green") == Transparency::Partial);
+        CHECK(built.GetTransparency("block/blue") == Transparency::Total);
+        CHECK(built.GetAnimation("block/red") == Animation::Static);
+        CHECK(built.GetAnimation("block/blue") == Animation::Animated);
+        CHECK(GetTexturePixel(built, "block/red") == std::vector<unsigned char>({ 255, 0, 0, 255 }));
+        CHECK(GetTexturePixel(built, "block/green") == std::vector<unsigned char>({ 0, 255, 0, 128 }));
+        CHECK(GetTexturePixel(built, "block/green", 1) == std::vector<unsigned char>({ 0, 255, 0, 255 }));
+
+        // Same atlas when loaded without a cache file
+        Atlas uncached;
+        uncached.LoadData(textures);
+        CHECK(IsSameAtlas(built, uncached, textures));
+
+        // Same textures, read from the cache file
+        MarkCacheFile(cache_path);
+        Atlas cached;
+        cached.LoadData(textures, cache_path.string());
+        CHECK(!IsMarked(built));
+        CHECK(IsMarked(cached));
+        cached.Get()[cached.GetWidth() * cached.GetHeight() * 4 - 1] = 255;
+        CHECK(IsSameAtlas(built, cached, textures));
+
+        // A texture is modified, the cache file is not used and is rewritten
+        const std::filesystem::file_time_type write_time = std::filesystem::last_write_time(textures[0].first);
+        WriteTexture("red", 16, 16, 200, 0, 0);
+        std::filesystem::last_write_time(textures[0].first, write_time + std::chrono::hours(1));
+        Atlas modified;
+        modified.LoadData(textures, cache_path.string());
+        CHECK(!IsMarked(modified));
+        CHECK(GetTexturePixel(modified, "block/red") == std::vector<unsigned char>({ 200, 0, 0, 255 }));
+        MarkCacheFile(cache_path);
+        Atlas modified_cached;
+        modified_cached.LoadData(textures, cache_path.string());
+        CHECK(IsMarked(modified_cached));
+
+        // A texture is added
+        textures.push_back(WriteTexture("white", 16, 16, 255, 255, 255));
+        Atlas added;
+        added.LoadData(textures, cache_path.string());
+        CHECK(!IsMarked(added));
+        CHECK(GetTexturePixel(added, "block/white") == std::vector<unsigned char>({ 255, 255, 255, 255 }));
+        CHECK(GetTexturePixel(added, "block/red") == std::vector<unsigned char>({ 200, 0, 0, 255 }));
+
+        // Truncated cache file, built again from the textures
+        std::vector<char> data = ReadFile(cache_path);
+        const size_t cache_size = data.size();
+        data.resize(cache_size / 2);
+        WriteFile(cache_path, data);
+        Atlas truncated;
+        truncated.LoadData(textures, cache_path.string());
+        CHECK(IsSameAtlas(added, truncated, textures));
+        CHECK(ReadFile(cache_path).size() == cache_size);
+
+        // Not an atlas cache file
+        data = ReadFile(cache_path);
+        data[0] = 'X';
+        WriteFile(cache_path, data);
+        Atlas wrong_magic;
+        wrong_magic.LoadData(textures, cache_path.string());
+        CHECK(IsSameAtlas(added, wrong_magic, textures));
+        CHECK(ReadFile(cache_path)[0] == 'B');
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::filesystem::remove_all(GetTestFolder());
+    std::filesystem::create_directories(GetTestFolder());
+
+    TestAtlasCache();
+
+    std::filesystem::remove_all(GetTestFolder());
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,241 @@
+#include <memory>
+#include <vector>
+
+#include "botcraft/Game/World/World.hpp"
+#include "botcraft/Game/World/Blockstate.hpp"
+#include "botcraft/Game/World/BlockChange.hpp"
+
+#include "TestUtilities.hpp"
+
+using namespace Botcraft;
+
+// Block change subscribers with a small region must only receive
+// the changes of their region, whatever the chunk index used to
+// dispatch the events. Filters must apply the type mask, the region
+// and the block names, and queues must report the dropped events
+
+namespace
+{
+    void AddChunk(World& world, const int x, const int z)
+    {
+#if PROTOCOL_VERSION < 719
+        world.AddChunk(x, z, Dimension::Overworld);
+#else
+        world.AddChunk(x, z, "minecraft:overworld");
+#endif
+    }
+
+    void SetBlock(World& world, const Position& pos)
+    {
+#if PROTOCOL_VERSION < 347
+        world.SetBlock(pos, 1, 0);
+#else
+        world.SetBlock(pos, 1);
+#endif
+    }
+
+    std::unique_ptr<Blockstate> CreateBlockstate(const int id, const std::string& name)
+    {
+#if PROTOCOL_VERSION < 347
+        return std::make_unique<Blockstate>(id, 0, false, true, false, 1.0f, TintType::None, name, Model());
+#else
+        return std::make_unique<Blockstate>(id, false, true, false, 1.0f, TintType::None, name, Model());
+#endif
+    }
+
+    BlockChangeEvent BlockEvent(const Position& pos, const Blockstate* previous, const Blockstate* current)
+    {
+        return BlockChangeEvent{ BlockChangeType::BlockChanged, pos, pos, previous, current };
+    }
+
+    void TestRegionSubscribers()
+    {
+        World world(false);
+        for (int x = -1; x < 8; ++x)
+        {
+            for (int z = -1; z < 8; ++z)
+            {
+                AddChunk(world, x, z);
+            }
+        }
+
+        // Indexed by chunk, across a chunk border
+        BlockChangeFilter border_filter;
+        border_filter.use_region = true;
+        border_filter.min = Position(-2, 10, -2);
+        border_filter.max = Position(1, 12, 1);
+        std::vector<Position> border_events;
+        const size_t border_id = world.SubscribeBlockChanges(border_filter, [&](const std::vector<BlockChangeEvent>& events)
+            {
+                for (size_t i = 0; i < events.size(); ++i)
+                {
+                    border_events.push_back(events[i].min);
+                }
+            });
+
+        // Too many chunks to be indexed
+        BlockChangeFilter large_filter;
+        large_filter.use_region = true;
+        large_filter.min = Position(-16, 0, -16);
+        large_filter.max = Position(16 * 8, 255, 16 * 8);
+        int large_events = 0;
+        const size_t large_id = world.SubscribeBlockChanges(large_filter, [&](const std::vector<BlockChangeEvent>& events)
+            {
+                large_events += static_cast<int>(events.size());
+            });
+
+        // Same chunk as the border one, other blocks
+        BlockChangeFilter other_filter;
+        other_filter.use_region = true;
+        other_filter.min = Position(8, 10, 8);
+        other_filter.max = Position(8, 10, 8);
+        int other_events = 0;
+        const size_t other_id = world.SubscribeBlockChanges(other_filter, [&](const std::vector<BlockChangeEvent>&)
+            {
+                other_events += 1;
+            });
+
+        SetBlock(world, Position(-1, 11, -1));
+        SetBlock(world, Position(1, 11, 1));
+        SetBlock(world, Position(5, 11, 5));
+        SetBlock(world, Position(100, 11, 100));
+
+        CHECK(border_events.size() == 2);
+        CHECK(border_events.size() == 2 && border_events[0] == Position(-1, 11, -1) && border_events[1] == Position(1, 11, 1));
+        CHECK(large_events == 4);
+        CHECK(other_events == 0);
+
+        SetBlock(world, Position(8, 10, 8));
+        CHECK(other_events == 1);
+        CHECK(border_events.size() == 2);
+
+        world.UnsubscribeBlockChanges(border_id);
+        world.UnsubscribeBlockChanges(large_id);
+        SetBlock(world, Position(0, 11, 0));
+        CHECK(border_events.size() == 2);
+        CHECK(large_events == 5);
+
+        world.UnsubscribeBlockChanges(other_id);
+        SetBlock(world, Position(8, 10, 8));
+        CHECK(other_events == 1);
+    }
+
+    void TestFilter()
+    {
+        const std::unique_ptr<Blockstate> stone = CreateBlockstate(1, "minecraft:stone");
+        const std::unique_ptr<Blockstate> dirt = CreateBlockstate(2, "minecraft:dirt");
+        const BlockChangeEvent section_event{ BlockChangeType::SectionChanged, Position(0, 0, 0), Position(15, 15, 15), nullptr, nullptr };
+
+        // Everything by default
+        BlockChangeFilter all_filter;
+        CHECK(all_filter.Match(BlockEvent(Position(1000, 5, -1000), stone.get(), dirt.get())));
+        CHECK(all_filter.Match(section_event));
+
+        BlockChangeFilter types_filter;
+        types_filter.types = static_cast<unsigned char>(BlockChangeType::SectionChanged) | static_cast<unsigned char>(BlockChangeType::ChunkUnloaded);
+        CHECK(types_filter.Match(section_event));
+        CHECK(!types_filter.Match(BlockEvent(Position(0, 0, 0), stone.get(), dirt.get())));
+
+        // Region bounds are included, events are boxes
+        BlockChangeFilter region_filter;
+        region_filter.use_region = true;
+        region_filter.min = Position(2, 2, 2);
+        region_filter.max = Position(4, 4, 4);
+        CHECK(region_filter.Match(BlockEvent(Position(2, 2, 2), stone.get(), dirt.get())));
+        CHECK(region_filter.Match(BlockEvent(Position(4, 4, 4), stone.get(), dirt.get())));
+        CHECK(!region_filter.Match(BlockEvent(Position(5, 4, 4), stone.get(), dirt.get())));
+        CHECK(!region_filter.Match(BlockEvent(Position(2, 1, 2), stone.get(), dirt.get())));
+        CHECK(region_filter.Match(section_event));
+
+        // Matched against the previous and the current block, null is air
+        BlockChangeFilter blocks_filter;
+        blocks_filter.blocks = { "minecraft:stone", "minecraft:air" };
+        CHECK(blocks_filter.Match(BlockEvent(Position(0, 0, 0), stone.get(), dirt.get())));
+        CHECK(blocks_filter.Match(BlockEvent(Position(0, 0, 0), dirt.get(), stone.get())));
+        CHECK(blocks_filter.Match(BlockEvent(Position(0, 0, 0), nullptr, dirt.get())));
+        CHECK(!blocks_filter.Match(BlockEvent(Position(0, 0, 0), dirt.get(), dirt.get())));
+        // Same result from the cache
+        CHECK(!blocks_filter.Match(BlockEvent(Position(0, 0, 0), dirt.get(), dirt.get())));
+        // Other types are not filtered by block
+        CHECK(blocks_filter.Match(section_event));
+    }
+
+    void TestQueue()
+    {
+        // Rounded up to 4
+        BlockChangeQueue queue(3);
+        std::vector<BlockChangeEvent> events;
+        CHECK(queue.PopAll(events));
+        CHECK(events.empty());
+
+        for (int i = 0; i < 6; ++i)
+        {
+            queue.Push(BlockEvent(Position(i, 0, 0), nullptr, nullptr));
+        }
+        // The two last ones are dropped, and reported only once
+        CHECK(!queue.PopAll(events));
+        CHECK(events.size() == 4);
+        CHECK(events.size() == 4 && events[0].min.x == 0 && events[3].min.x == 3);
+
+        events.clear();
+        queue.Push(BlockEvent(Position(6, 0, 0), nullptr, nullptr));
+        CHECK(queue.PopAll(events));
+        CHECK(events.size() == 1 && events[0].min.x == 6);
+    }
+
+    void TestWorldSubscribers()
+    {
+        World world(false);
+        AddChunk(world, 0, 0);
+        AddChunk(world, 1, 0);
+
+        // One batch per modification
+        BlockChangeFilter all_filter;
+        std::vector<size_t> batch_sizes;
+        const size_t all_id = world.SubscribeBlockChanges(all_filter, [&](const std::vector<BlockChangeEvent>& events)
+            {
+                batch_sizes.push_back(events.size());
+            });
+
+        BlockChangeFilter unload_filter;
+        unload_filter.types = static_cast<unsigned char>(BlockChangeType::ChunkUnloaded);
+        const std::shared_ptr<BlockChangeQueue> queue = std::make_shared<BlockChangeQueue>();
+        const size_t queue_id = world.SubscribeBlockChanges(unload_filter, queue);
+
+        SetBlock(world, Position(1, 1, 1));
+        CHECK(batch_sizes.size() == 1 && batch_sizes[0] == 1);
+
+        std::vector<BlockChangeEvent> events;
+        CHECK(queue->PopAll(events));
+        CHECK(events.empty());
+
+        world.RemoveChunk(1, 0);
+        CHECK(batch_sizes.size() == 2);
+        CHECK(queue->PopAll(events));
+        CHECK(events.size() == 1);
+        CHECK(events.size() == 1 && events[0].type == BlockChangeType::ChunkUnloaded &&
+            events[0].min.x == CHUNK_WIDTH && events[0].max.x == 2 * CHUNK_WIDTH - 1);
+
+        // Nothing removed, no event
+        world.RemoveChunk(1, 0);
+        CHECK(batch_sizes.size() == 2);
+
+        world.UnsubscribeBlockChanges(all_id);
+        world.UnsubscribeBlockChanges(queue_id);
+        world.RemoveChunk(0, 0);
+        events.clear();
+        CHECK(queue->PopAll(events));
+        CHECK(events.empty());
+        CHECK(batch_sizes.size() == 2);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    TestRegionSubscribers();
+    TestFilter();
+    TestQueue();
+    TestWorldSubscribers();
+
+    return TEST_RESULT();
+}
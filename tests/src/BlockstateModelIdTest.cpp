@@ -0,0 +1,152 @@
+#include <vector>
+#include <thread>
+#include <memory>
+#include <cmath>
+
+#include "botcraft/Game/World/Blockstate.hpp"
+
+#include "TestUtilities.hpp"
+
+using namespace Botcraft;
+
+// Blockstate::GetModelId must be a pure function of
+// (position, blockstate), follow the weights of the
+// variants and be callable from any thread
+
+namespace
+{
+    const int REGION_SIZE = 48;
+
+    std::unique_ptr<Blockstate> CreateBlockstate(const int id, const std::vector<int>& weights)
+    {
+        const std::vector<Model> models(weights.size());
+#if PROTOCOL_VERSION < 347
+        return std::make_unique<Blockstate>(id, 0, false, true, false, 1.0f, TintType::None, "test:blockstate_" + std::to_string(id), models, weights);
+#else
+        return std::make_unique<Blockstate>(id, false, true, false, 1.0f, TintType::None, "test:blockstate_" + std::to_string(id), models, weights);
+#endif
+    }
+
+    const size_t Index(const int x, const int y, const int z)
+    {
+        return (static_cast<size_t>(y) * REGION_SIZE + z) * REGION_SIZE + x;
+    }
+
+    std::vector<unsigned char> ComputeRegion(const Blockstate& blockstate, const int offset)
+    {
+        std::vector<unsigned char> output(static_cast<size_t>(REGION_SIZE) * REGION_SIZE * REGION_SIZE);
+        for (int y = 0; y < REGION_SIZE; ++y)
+        {
+            for (int z = 0; z < REGION_SIZE; ++z)
+            {
+                for (int x = 0; x < REGION_SIZE; ++x)
+                {
+                    output[Index(x, y, z)] = blockstate.GetModelId(Position(x + offset, y - offset, z - offset));
+                }
+            }
+        }
+        return output;
+    }
+
+    std::vector<int> CountVariants(const std::vector<unsigned char>& ids, const int num_models)
+    {
+        std::vector<int> output(num_models, 0);
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            CHECK(ids[i] < num_models);
+            if (ids[i] < num_models)
+            {
+                output[ids[i]] += 1;
+            }
+        }
+        return output;
+    }
+}
+
+void TestSingleModel()
+{
+    const std::unique_ptr<Blockstate> blockstate = CreateBlockstate(1, { 1 });
+    CHECK(blockstate->GetModelId(Position(0, 0, 0)) == 0);
+    CHECK(blockstate->GetModelId(Position(-12, 70, 3456)) == 0);
+}
+
+void TestWeights()
+{
+    const std::vector<int> weights = { 1, 2, 3, 0 };
+    const std::unique_ptr<Blockstate> blockstate = CreateBlockstate(2, weights);
+
+    const std::vector<unsigned char> ids = ComputeRegion(*blockstate, -1000);
+    // Same inputs, same variant
+    CHECK(ids == ComputeRegion(*blockstate, -1000));
+
+    const std::vector<int> counts = CountVariants(ids, static_cast<int>(weights.size()));
+    for (size_t i = 0; i < weights.size(); ++i)
+    {
+        const double expected = static_cast<double>(ids.size()) * weights[i] / 6.0;
+        CHECK(std::abs(counts[i] - expected) <= 0.05 * ids.size());
+    }
+    // A null weight variant is never picked if the others are not null
+    CHECK(counts[3] == 0);
+}
+
+void TestNullWeights()
+{
+    // Must not divide by zero and fall back to a uniform pick
+    const std::unique_ptr<Blockstate> blockstate = CreateBlockstate(3, { 0, 0, 0 });
+
+    const std::vector<unsigned char> ids = ComputeRegion(*blockstate, 0);
+    const std::vector<int> counts = CountVariants(ids, 3);
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        CHECK(std::abs(counts[i] - ids.size() / 3.0) <= 0.05 * ids.size());
+    }
+}
+
+void TestConcurrentCalls()
+{
+    const std::unique_ptr<Blockstate> blockstate = CreateBlockstate(4, { 5, 1, 1, 3 });
+
+    const int num_threads = std::max(4u, std::thread::hardware_concurrency());
+    std::vector<std::vector<unsigned char> > results(num_threads);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; ++i)
+    {
+        threads.emplace_back([&blockstate, &results, i]()
+            {
+                // All threads compute the same region several times, interleaved with the others
+                for (int n = 0; n < 4; ++n)
+                {
+                    std::vector<unsigned char> ids = ComputeRegion(*blockstate, 17);
+                    if (n == 0)
+                    {
+                        results[i] = std::move(ids);
+                    }
+                    else if (ids != results[i])
+                    {
+                        results[i].clear();
+                        break;
+                    }
+                }
+            });
+    }
+    for (int i = 0; i < num_threads; ++i)
+    {
+        threads[i].join();
+    }
+
+    const std::vector<unsigned char> reference = ComputeRegion(*blockstate, 17);
+    for (int i = 0; i < num_threads; ++i)
+    {
+        CHECK(results[i] == reference);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    TestSingleModel();
+    TestWeights();
+    TestNullWeights();
+    TestConcurrentCalls();
+
+    return TEST_RESULT();
+}
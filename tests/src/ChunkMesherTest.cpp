@@ -0,0 +1,253 @@
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "botcraft/Game/AssetsManager.hpp"
+#include "botcraft/Game/World/World.hpp"
+#include "botcraft/Renderer/Atlas.hpp"
+#include "botcraft/Renderer/ChunkMesher.hpp"
+
+#include "TestUtilities.hpp"
+
+using namespace Botcraft;
+using namespace Botcraft::Renderer;
+
+// With greedy meshing, the full opaque block faces are merged into
+// bigger quads. The merged faces must have the expected sizes and
+// cover exactly the same block faces as without greedy meshing,
+// each of them only once
+
+namespace
+{
+    // Shape, texture multipliers and block of a face
+    typedef std::tuple<unsigned int, unsigned int, unsigned int, int, int, int> BlockFace;
+
+    struct BlockId
+    {
+        int id;
+        unsigned char metadata;
+    };
+
+    const BlockId GetBlockId(const std::string& name)
+    {
+        BlockId output;
+#if PROTOCOL_VERSION < 347
+        const std::pair<int, unsigned char> id = AssetsManager::getInstance().GetBlockstateID(name);
+        output.id = id.first;
+        output.metadata = id.second;
+#else
+        output.id = AssetsManager::getInstance().GetBlockstateID(name);
+        output.metadata = 0;
+#endif
+        return output;
+    }
+
+    void SetBlock(World& world, const Position& pos, const BlockId& block)
+    {
+#if PROTOCOL_VERSION < 347
+        world.SetBlock(pos, block.id, block.metadata);
+#else
+        world.SetBlock(pos, block.id);
+#endif
+    }
+
+    void AddChunk(World& world, const int x, const int z)
+    {
+#if PROTOCOL_VERSION < 719
+        world.AddChunk(x, z, Dimension::Overworld);
+#else
+        world.AddChunk(x, z, "minecraft:overworld");
+#endif
+    }
+
+    const int SizeX(const PackedFace& face)
+    {
+        return ((face.position >> 17) & 0x0F) + 1;
+    }
+
+    const int SizeY(const PackedFace& face)
+    {
+        return ((face.position >> 21) & 0x0F) + 1;
+    }
+
+    const int SizeZ(const PackedFace& face)
+    {
+        return ((face.position >> 25) & 0x0F) + 1;
+    }
+
+    // Number of times each block face is covered by faces
+    const std::map<BlockFace, int> GetCoverage(const std::vector<PackedFace>& faces)
+    {
+        std::map<BlockFace, int> output;
+        for (size_t i = 0; i < faces.size(); ++i)
+        {
+            const int x = faces[i].position & 0x0F;
+            const int z = (faces[i].position >> 4) & 0x0F;
+            const int y = (faces[i].position >> 8) & 0x1FF;
+            for (int dx = 0; dx < SizeX(faces[i]); ++dx)
+            {
+                for (int dy = 0; dy < SizeY(faces[i]); ++dy)
+                {
+                    for (int dz = 0; dz < SizeZ(faces[i]); ++dz)
+                    {
+                        output[BlockFace(faces[i].shape, faces[i].texture_multipliers[0], faces[i].texture_multipliers[1], x + dx, y + dy, z + dz)] += 1;
+                    }
+                }
+            }
+        }
+        return output;
+    }
+
+    // A 4x1x3 slab of stone is meshed as 6 faces
+    void TestSlab(const std::shared_ptr<const Atlas>& atlas)
+    {
+        const BlockId stone = GetBlockId("minecraft:stone");
+        World world(false);
+        AddChunk(world, 0, 0);
+        for (int x = 2; x < 6; ++x)
+        {
+            for (int z = 3; z < 6; ++z)
+            {
+                SetBlock(world, Position(x, 70, z), stone);
+            }
+        }
+        const std::shared_ptr<const Chunk> chunk = world.GetChunkCopy(0, 0);
+
+        const ChunkMesher mesher(atlas, CHUNK_WIDTH, false);
+        const ChunkMesher greedy_mesher(atlas, CHUNK_WIDTH, true);
+        const int section_y = 70 / CHUNK_WIDTH;
+        const int y = 70 - section_y * CHUNK_WIDTH;
+
+        SectionMesh mesh;
+        mesher.MeshSection(chunk.get(), 0, 0, section_y, mesh);
+        CHECK(mesh.opaque_faces.size() == 4 * 3 * 2 + 2 * (4 + 3));
+        CHECK(mesh.num_block_faces == mesh.opaque_faces.size());
+
+        SectionMesh greedy_mesh;
+        greedy_mesher.MeshSection(chunk.get(), 0, 0, section_y, greedy_mesh);
+        CHECK(greedy_mesh.opaque_faces.size() == 6);
+        CHECK(greedy_mesh.transparent_faces.empty());
+        // Still counted before merging
+        CHECK(greedy_mesh.num_block_faces == mesh.num_block_faces);
+
+        int num_top_bottom = 0;
+        int num_north_south = 0;
+        int num_west_east = 0;
+        for (size_t i = 0; i < greedy_mesh.opaque_faces.size(); ++i)
+        {
+            const PackedFace& face = greedy_mesh.opaque_faces[i];
+            const int size_x = SizeX(face);
+            const int size_y = SizeY(face);
+            const int size_z = SizeZ(face);
+            if (size_x == 4 && size_y == 1 && size_z == 3)
+            {
+                num_top_bottom += 1;
+                CHECK((face.position & 0x1FFFF) == PackFacePosition(2, y, 3));
+            }
+            else if (size_x == 4 && size_y == 1 && size_z == 1)
+            {
+                num_north_south += 1;
+                CHECK((face.position & 0x1FFFF) == PackFacePosition(2, y, 3) || (face.position & 0x1FFFF) == PackFacePosition(2, y, 5));
+            }
+            else if (size_x == 1 && size_y == 1 && size_z == 3)
+            {
+                num_west_east += 1;
+                CHECK((face.position & 0x1FFFF) == PackFacePosition(2, y, 3) || (face.position & 0x1FFFF) == PackFacePosition(5, y, 3));
+            }
+        }
+        CHECK(num_top_bottom == 2);
+        CHECK(num_north_south == 2);
+        CHECK(num_west_east == 2);
+    }
+
+    // Random blocks of different types, the merged faces must
+    // cover the same block faces as the non merged ones, once
+    void TestCoverage(const std::shared_ptr<const Atlas>& atlas)
+    {
+        const std::vector<BlockId> blocks = { GetBlockId("minecraft:stone"), GetBlockId("minecraft:dirt"), GetBlockId("minecraft:cobblestone") };
+        World world(false);
+        for (int x = -1; x <= 1; ++x)
+        {
+            for (int z = -1; z <= 1; ++z)
+            {
+                AddChunk(world, x, z);
+            }
+        }
+        unsigned int random = 3;
+        for (int x = -CHUNK_WIDTH; x < 2 * CHUNK_WIDTH; ++x)
+        {
+            for (int z = -CHUNK_WIDTH; z < 2 * CHUNK_WIDTH; ++z)
+            {
+                for (int y = 0; y < 2 * CHUNK_WIDTH; ++y)
+                {
+                    random = random * 1664525u + 1013904223u;
+                    // Mostly solid with holes, so there are big faces to merge
+                    const unsigned int r = (random >> 16) % 16;
+                    if (r < 12)
+                    {
+                        SetBlock(world, Position(x, y, z), blocks[y / 6 % blocks.size()]);
+                    }
+                    else if (r < 13)
+                    {
+                        SetBlock(world, Position(x, y, z), blocks[r % blocks.size()]);
+                    }
+                }
+            }
+        }
+        const std::shared_ptr<const Chunk> chunk = world.GetChunkCopy(0, 0);
+
+        const ChunkMesher mesher(atlas, CHUNK_WIDTH, false);
+        const ChunkMesher greedy_mesher(atlas, CHUNK_WIDTH, true);
+        SectionMesh mesh;
+        SectionMesh greedy_mesh;
+        for (int section_y = 0; section_y < 2; ++section_y)
+        {
+            mesher.MeshSection(chunk.get(), 0, 0, section_y, mesh);
+            greedy_mesher.MeshSection(chunk.get(), 0, 0, section_y, greedy_mesh);
+            CHECK(!mesh.opaque_faces.empty());
+            CHECK(greedy_mesh.opaque_faces.size() < mesh.opaque_faces.size());
+            CHECK(greedy_mesh.num_block_faces == mesh.num_block_faces);
+
+            bool in_section = true;
+            bool flat = true;
+            for (size_t i = 0; i < greedy_mesh.opaque_faces.size(); ++i)
+            {
+                const PackedFace& face = greedy_mesh.opaque_faces[i];
+                const int x = face.position & 0x0F;
+                const int z = (face.position >> 4) & 0x0F;
+                const int y = (face.position >> 8) & 0x1FF;
+                in_section = in_section && x + SizeX(face) <= CHUNK_WIDTH &&
+                    z + SizeZ(face) <= CHUNK_WIDTH && y + SizeY(face) <= CHUNK_WIDTH;
+                // Merged faces are flat
+                flat = flat && (SizeX(face) == 1 || SizeY(face) == 1 || SizeZ(face) == 1);
+            }
+            CHECK(in_section);
+            CHECK(flat);
+
+            // Both meshers have their own shape table, but the shapes are
+            // added in the same order as the blocks are the same
+            const std::map<BlockFace, int> coverage = GetCoverage(mesh.opaque_faces);
+            const std::map<BlockFace, int> greedy_coverage = GetCoverage(greedy_mesh.opaque_faces);
+            CHECK(coverage == greedy_coverage);
+            bool covered_once = true;
+            for (auto it = greedy_coverage.begin(); it != greedy_coverage.end(); ++it)
+            {
+                covered_once = covered_once && it->second == 1;
+            }
+            CHECK(covered_once);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::shared_ptr<Atlas> atlas = std::make_shared<Atlas>();
+    atlas->LoadData(AssetsManager::getInstance().GetTexturesPathsNames());
+
+    TestSlab(atlas);
+    TestCoverage(atlas);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "botcraft/Game/AABB.hpp"
+#include "botcraft/Game/Entities/Entity.hpp"
+#include "botcraft/Game/Entities/EntityStore.hpp"
+#include "botcraft/Game/Entities/Player.hpp"
+
+#include "TestUtilities.hpp"
+
+using namespace Botcraft;
+
+// QueryRadius and QueryAABB must return exactly the entities a scan
+// of all the entities would return (each one once), including around
+// and across the grid cell boundaries, after the entities moved to
+// other cells and after some of them were removed. Entities added as
+// not indexed must be found at the position of their object
+
+namespace
+{
+    const std::vector<int> GetIds(const std::vector<std::shared_ptr<Entity> >& entities)
+    {
+        std::vector<int> output(entities.size());
+        for (size_t i = 0; i < entities.size(); ++i)
+        {
+            output[i] = entities[i]->GetEID();
+        }
+        std::sort(output.begin(), output.end());
+        return output;
+    }
+
+    const std::vector<int> QueryRadius(const EntityStore& store, const Vector3<double>& center, const double radius)
+    {
+        std::vector<std::shared_ptr<Entity> > found;
+        store.QueryRadius(center, radius, found);
+        return GetIds(found);
+    }
+
+    const std::vector<int> QueryAABB(const EntityStore& store, const AABB& box)
+    {
+        std::vector<std::shared_ptr<Entity> > found;
+        store.QueryAABB(box, found);
+        return GetIds(found);
+    }
+
+    const std::vector<int> ScanRadius(const EntityStore& store, const Vector3<double>& center, const double radius)
+    {
+        std::vector<std::shared_ptr<Entity> > found;
+        const std::vector<std::shared_ptr<Entity> >& entities = store.GetAll();
+        for (size_t i = 0; i < entities.size(); ++i)
+        {
+            const Vector3<double> diff = entities[i]->GetPosition() - center;
+            if (diff.dot(diff) <= radius * radius)
+            {
+                found.push_back(entities[i]);
+            }
+        }
+        return GetIds(found);
+    }
+
+    const std::vector<int> ScanAABB(const EntityStore& store, const AABB& box)
+    {
+        std::vector<std::shared_ptr<Entity> > found;
+        const std::vector<std::shared_ptr<Entity> >& entities = store.GetAll();
+        for (size_t i = 0; i < entities.size(); ++i)
+        {
+            if (box.Collide(entities[i]->GetCollider()))
+            {
+                found.push_back(entities[i]);
+            }
+        }
+        return GetIds(found);
+    }
+
+    std::shared_ptr<Entity> CreateEntity(const int id, const Vector3<double>& position, const bool is_player)
+    {
+        std::shared_ptr<Entity> entity = is_player ? std::make_shared<Player>() : std::make_shared<Entity>();
+        entity->SetEID(id);
+        entity->SetPosition(position);
+        return entity;
+    }
+
+    void TestCellBoundaries()
+    {
+        // Cells are 16 blocks wide, on both sides of 0 and 16
+        EntityStore store;
+        store.Add(CreateEntity(0, Vector3<double>(15.999, 64.0, 0.5), false));
+        store.Add(CreateEntity(1, Vector3<double>(16.0, 64.0, 0.5), false));
+        store.Add(CreateEntity(2, Vector3<double>(16.4, 64.0, 0.5), false));
+        store.Add(CreateEntity(3, Vector3<double>(16.6, 64.0, 0.5), false));
+        store.Add(CreateEntity(4, Vector3<double>(-0.001, 64.0, 0.5), false));
+        store.Add(CreateEntity(5, Vector3<double>(0.0, 64.0, 0.5), false));
+        store.Add(CreateEntity(6, Vector3<double>(0.5, 64.0, -16.0), false));
+        CHECK(store.Size() == 7);
+
+        CHECK(QueryRadius(store, Vector3<double>(16.0, 64.0, 0.5), 0.5) == std::vector<int>({ 0, 1, 2 }));
+        CHECK(QueryRadius(store, Vector3<double>(0.0, 64.0, 0.5), 0.01) == std::vector<int>({ 4, 5 }));
+        // Radius exactly reaching an entity in the next cell
+        CHECK(QueryRadius(store, Vector3<double>(0.5, 64.0, -15.0), 1.0) == std::vector<int>({ 6 }));
+        CHECK(QueryRadius(store, Vector3<double>(0.5, 64.0, -14.9), 1.0).empty());
+        // Query contained in a single cell, entity right outside
+        CHECK(QueryRadius(store, Vector3<double>(8.0, 64.0, 8.0), 7.9).empty());
+
+        // Box touching the collider of an entity in another cell
+        CHECK(QueryAABB(store, AABB(Vector3<double>(16.5, 64.25, 0.5), Vector3<double>(0.25, 0.0, 0.0))) == std::vector<int>({ 1, 2, 3 }));
+        CHECK(QueryAABB(store, AABB(Vector3<double>(-0.5, 64.25, 0.5), Vector3<double>(0.25, 0.25, 0.25))) == std::vector<int>({ 4, 5 }));
+
+        // A player standing at the top of a cell has a collider
+        // reaching the cell above it, where the box is
+        store.Add(CreateEntity(7, Vector3<double>(40.5, 47.5, 40.5), true));
+        CHECK(QueryAABB(store, AABB(Vector3<double>(40.5, 48.5, 40.5), Vector3<double>(0.1, 0.1, 0.1))) == std::vector<int>({ 7 }));
+        CHECK(QueryAABB(store, AABB(Vector3<double>(40.5, 49.5, 40.5), Vector3<double>(0.1, 0.1, 0.1))).empty());
+        CHECK(QueryRadius(store, Vector3<double>(40.5, 48.5, 40.5), 0.5).empty());
+
+        // Moving across a boundary and back
+        const int slot = store.GetSlot(1);
+        store.SetPosition(slot, Vector3<double>(15.5, 64.0, 0.5));
+        CHECK(store.Get(1)->GetPosition() == Vector3<double>(15.5, 64.0, 0.5));
+        CHECK(QueryRadius(store, Vector3<double>(16.0, 64.0, 0.5), 0.5) == std::vector<int>({ 0, 1, 2 }));
+        CHECK(QueryRadius(store, Vector3<double>(17.0, 64.0, 0.5), 1.0) == std::vector<int>({ 2, 3 }));
+        store.SetPosition(slot, Vector3<double>(16.0, 64.0, 0.5));
+        CHECK(QueryRadius(store, Vector3<double>(17.0, 64.0, 0.5), 1.0) == std::vector<int>({ 1, 2, 3 }));
+
+        // Removed entities are not returned
+        store.Remove(2);
+        store.Remove(2);
+        CHECK(store.Size() == 7);
+        CHECK(store.Get(2) == nullptr && store.GetSlot(2) == -1);
+        CHECK(QueryRadius(store, Vector3<double>(16.0, 64.0, 0.5), 0.5) == std::vector<int>({ 0, 1 }));
+
+        store.Clear();
+        CHECK(store.Size() == 0);
+        CHECK(QueryRadius(store, Vector3<double>(16.0, 64.0, 0.5), 100.0).empty());
+    }
+
+    void TestRandomQueries()
+    {
+        std::mt19937 random_gen(42);
+        std::uniform_real_distribution<double> position_dist(-40.0, 40.0);
+        std::uniform_real_distribution<double> move_dist(-12.0, 12.0);
+        std::uniform_real_distribution<double> size_dist(0.0, 20.0);
+        std::uniform_int_distribution<int> type_dist(0, 1);
+
+        const int num_entities = 500;
+        EntityStore store;
+        for (int i = 0; i < num_entities; ++i)
+        {
+            const Vector3<double> position(position_dist(random_gen), position_dist(random_gen), position_dist(random_gen));
+            store.Add(CreateEntity(i, position, type_dist(random_gen) == 1));
+        }
+        // Not indexed, moved without going through the store
+        std::shared_ptr<Entity> local_player = CreateEntity(num_entities, Vector3<double>(0.0, 0.0, 0.0), true);
+        store.Add(local_player, false);
+
+        const auto check_queries = [&]()
+        {
+            for (int i = 0; i < 200; ++i)
+            {
+                const Vector3<double> center(position_dist(random_gen), position_dist(random_gen), position_dist(random_gen));
+                const double radius = size_dist(random_gen);
+                CHECK(QueryRadius(store, center, radius) == ScanRadius(store, center, radius));
+
+                const AABB box(center, Vector3<double>(size_dist(random_gen), size_dist(random_gen), size_dist(random_gen)) * 0.5);
+                CHECK(QueryAABB(store, box) == ScanAABB(store, box));
+            }
+            // Larger than the whole area, every entity once
+            CHECK(QueryRadius(store, Vector3<double>(0.0, 0.0, 0.0), 1000.0).size() == store.Size());
+        };
+        check_queries();
+
+        // Move all the entities, most of them to another cell
+        for (int i = 0; i < num_entities; ++i)
+        {
+            const int slot = store.GetSlot(i);
+            store.SetPosition(slot, store.GetPosition(slot) + Vector3<double>(move_dist(random_gen), move_dist(random_gen), move_dist(random_gen)));
+        }
+        local_player->SetPosition(Vector3<double>(5.0, 5.0, 5.0));
+        check_queries();
+        CHECK(QueryRadius(store, Vector3<double>(5.0, 5.0, 5.0), 0.0) == std::vector<int>({ num_entities }));
+
+        // Remove one entity out of three (the last ones are moved in the
+        // freed slots), then add some back with a new position
+        for (int i = 0; i < num_entities; i += 3)
+        {
+            store.Remove(i);
+        }
+        store.Remove(num_entities);
+        check_queries();
+        for (int i = 0; i < num_entities; i += 3)
+        {
+            CHECK(store.Get(i) == nullptr);
+        }
+        for (int i = 0; i < num_entities; i += 6)
+        {
+            const Vector3<double> position(position_dist(random_gen), position_dist(random_gen), position_dist(random_gen));
+            store.Add(CreateEntity(i, position, false));
+        }
+        // Replacing an entity with the same id
+        store.Add(CreateEntity(1, Vector3<double>(100.5, 100.0, 100.5), false));
+        CHECK(QueryRadius(store, Vector3<double>(100.5, 100.0, 100.5), 0.1) == std::vector<int>({ 1 }));
+        check_queries();
+
+        // Every entity can still be found at its position
+        const std::vector<std::shared_ptr<Entity> >& entities = store.GetAll();
+        for (size_t i = 0; i < entities.size(); ++i)
+        {
+            const int slot = store.GetSlot(entities[i]->GetEID());
+            CHECK(slot == static_cast<int>(i));
+            CHECK(store.GetPosition(slot) == entities[i]->GetPosition());
+            const std::vector<int> found = QueryRadius(store, entities[i]->GetPosition(), 0.0);
+            CHECK(std::find(found.begin(), found.end(), entities[i]->GetEID()) != found.end());
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    TestCellBoundaries();
+    TestRandomQueries();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <vector>
+
+#include "botcraft/Renderer/FaceBufferAllocator.hpp"
+
+#include "TestUtilities.hpp"
+
+using namespace Botcraft::Renderer;
+
+// The ranges given by FaceBufferAllocator must be big enough for the
+// requested faces and never overlap, and freed ranges must be merged
+// back so the whole buffer can be used again. This doesn't need
+// OpenGL, only the free space bookkeeping is checked
+
+namespace
+{
+    // True if no two allocations share a face
+    bool AreDisjoint(std::vector<FaceAllocation> allocations)
+    {
+        std::sort(allocations.begin(), allocations.end(), [](const FaceAllocation& a, const FaceAllocation& b)
+            {
+                return a.offset < b.offset;
+            });
+        for (size_t i = 1; i < allocations.size(); ++i)
+        {
+            if (allocations[i - 1].offset + allocations[i - 1].size > allocations[i].offset)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void TestAllocateFree()
+    {
+        FaceBufferAllocator allocator(4096);
+        CHECK(allocator.GetCapacity() == 4096);
+        CHECK(allocator.GetUsed() == 0);
+        CHECK(allocator.GetLargestFreeRange() == 4096);
+
+        std::vector<FaceAllocation> allocations(3);
+        CHECK(allocator.Allocate(100, allocations[0]));
+        CHECK(allocator.Allocate(500, allocations[1]));
+        CHECK(allocator.Allocate(1, allocations[2]));
+        for (size_t i = 0; i < allocations.size(); ++i)
+        {
+            CHECK(allocations[i].offset + allocations[i].size <= allocator.GetCapacity());
+        }
+        // Extra space is reserved to update in place
+        CHECK(allocations[0].size >= 125);
+        CHECK(allocations[1].size >= 625);
+        CHECK(allocations[2].size >= 1);
+        CHECK(AreDisjoint(allocations));
+        CHECK(allocator.GetUsed() == allocations[0].size + allocations[1].size + allocations[2].size);
+
+        // Freeing the middle range, then its neighbours,
+        // merges everything back into one range
+        allocator.Free(allocations[1]);
+        CHECK(allocations[1].size == 0);
+        allocator.Free(allocations[0]);
+        allocator.Free(allocations[2]);
+        CHECK(allocator.GetUsed() == 0);
+        CHECK(allocator.GetLargestFreeRange() == 4096);
+
+        // Freeing an empty allocation does nothing
+        allocator.Free(allocations[0]);
+        CHECK(allocator.GetUsed() == 0);
+    }
+
+    void TestGrow()
+    {
+        FaceBufferAllocator allocator(1024);
+        FaceAllocation small, big;
+        CHECK(allocator.Allocate(500, small));
+        CHECK(!allocator.Allocate(1000, big));
+        CHECK(big.size == 0);
+
+        // The added space is merged with the free space at the end
+        allocator.Grow(2048);
+        CHECK(allocator.GetCapacity() == 2048);
+        CHECK(allocator.GetLargestFreeRange() == 2048 - small.size);
+        CHECK(allocator.Allocate(1000, big));
+        CHECK(AreDisjoint({ small, big }));
+
+        // Can't shrink
+        allocator.Grow(512);
+        CHECK(allocator.GetCapacity() == 2048);
+    }
+
+    void TestResize()
+    {
+        FaceBufferAllocator allocator(8192);
+        FaceAllocation allocation;
+        CHECK(allocator.Resize(200, allocation));
+        const FaceAllocation first = allocation;
+        CHECK(first.size >= 200);
+
+        // Still fits, updated in place
+        CHECK(allocator.Resize(first.size, allocation));
+        CHECK(allocation.offset == first.offset && allocation.size == first.size);
+        CHECK(allocator.Resize(first.size / 4, allocation));
+        CHECK(allocation.offset == first.offset && allocation.size == first.size);
+
+        // Too big, moved to a bigger range
+        CHECK(allocator.Resize(first.size + 1, allocation));
+        CHECK(allocation.size > first.size);
+        CHECK(allocator.GetUsed() == allocation.size);
+
+        // Too small, moved to a smaller range
+        const FaceAllocation second = allocation;
+        CHECK(allocator.Resize(second.size / 8, allocation));
+        CHECK(allocation.size < second.size);
+        CHECK(allocator.GetUsed() == allocation.size);
+
+        // No room, the allocation is emptied
+        CHECK(!allocator.Resize(10000, allocation));
+        CHECK(allocation.size == 0);
+        CHECK(allocator.GetUsed() == 0);
+    }
+
+    void TestRandomOperations()
+    {
+        FaceBufferAllocator allocator(1 << 16);
+        std::vector<FaceAllocation> allocations(64);
+        unsigned int random = 7;
+        bool all_valid = true;
+        for (int i = 0; i < 10000; ++i)
+        {
+            random = random * 1664525u + 1013904223u;
+            FaceAllocation& allocation = allocations[(random >> 8) % allocations.size()];
+            const unsigned int num_faces = (random >> 16) % 1500;
+            if (num_faces < 100)
+            {
+                allocator.Free(allocation);
+            }
+            else if (!allocator.Resize(num_faces, allocation))
+            {
+                allocator.Grow(allocator.GetCapacity() * 2);
+                all_valid = all_valid && allocator.Allocate(num_faces, allocation);
+            }
+            all_valid = all_valid && (allocation.size == 0 || allocation.size >= num_faces);
+        }
+        CHECK(all_valid);
+
+        std::vector<FaceAllocation> used_allocations;
+        unsigned int used = 0;
+        for (size_t i = 0; i < allocations.size(); ++i)
+        {
+            if (allocations[i].size > 0)
+            {
+                CHECK(allocations[i].offset + allocations[i].size <= allocator.GetCapacity());
+                used_allocations.push_back(allocations[i]);
+                used += allocations[i].size;
+            }
+        }
+        CHECK(AreDisjoint(used_allocations));
+        CHECK(allocator.GetUsed() == used);
+
+        for (size_t i = 0; i < allocations.size(); ++i)
+        {
+            allocator.Free(allocations[i]);
+        }
+        CHECK(allocator.GetUsed() == 0);
+        CHECK(allocator.GetLargestFreeRange() == allocator.GetCapacity());
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    TestAllocateFree();
+    TestGrow();
+    TestResize();
+    TestRandomOperations();
+
+    return TEST_RESULT();
+}
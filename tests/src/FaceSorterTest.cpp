@@ -0,0 +1,113 @@
+#include <cmath>
+#include <vector>
+
+#include "botcraft/Renderer/FaceSorter.hpp"
+
+#include "TestUtilities.hpp"
+
+using namespace Botcraft::Renderer;
+
+// Transparent faces are sorted by the distance between the camera and
+// their center, which must account for the size of merged and LOD
+// faces the same way the shader stretches them
+
+namespace
+{
+    PackedFace MakeFace(const int x, const int y, const int z, const unsigned int shape,
+        const int size_x = 1, const int size_y = 1, const int size_z = 1)
+    {
+        PackedFace face;
+        face.position = PackFacePosition(x, y, z) | PackFaceSize(size_x, size_y, size_z);
+        face.shape = shape;
+        face.texture_multipliers = { 0xFFFFFFFF, 0xFFFFFFFF };
+        return face;
+    }
+
+    bool IsClose(const glm::vec3& a, const glm::vec3& b)
+    {
+        return std::abs(a.x - b.x) < 1e-4f && std::abs(a.y - b.y) < 1e-4f && std::abs(a.z - b.z) < 1e-4f;
+    }
+
+    void TestCenters()
+    {
+        // Centers relative to the block corner: top, bottom and west faces
+        const std::vector<glm::vec3> shape_centers = {
+            glm::vec3(0.5f, 1.0f, 0.5f),
+            glm::vec3(0.5f, 0.0f, 0.5f),
+            glm::vec3(0.0f, 0.5f, 0.5f)
+        };
+
+        const std::vector<PackedFace> faces = {
+            MakeFace(2, 5, 3, 0),
+            // Merged top face over 4x4 blocks
+            MakeFace(2, 5, 3, 0, 4, 1, 4),
+            // Bottom face of a 2x2x2 LOD cell, it stays at the bottom
+            MakeFace(4, 8, 6, 1, 2, 2, 2),
+            // Top face of a 4x4x4 LOD cell, it goes up to the top of the cell
+            MakeFace(0, 12, 0, 0, 4, 4, 4),
+            // West face of a 8x8x8 LOD cell
+            MakeFace(8, 0, 8, 2, 8, 8, 8)
+        };
+
+        std::vector<glm::vec3> centers;
+        FaceSorter::ComputeCenters(faces, shape_centers, centers);
+        CHECK(centers.size() == faces.size());
+        CHECK(IsClose(centers[0], glm::vec3(2.5f, 6.0f, 3.5f)));
+        CHECK(IsClose(centers[1], glm::vec3(4.0f, 6.0f, 5.0f)));
+        CHECK(IsClose(centers[2], glm::vec3(5.0f, 8.0f, 7.0f)));
+        CHECK(IsClose(centers[3], glm::vec3(2.0f, 16.0f, 2.0f)));
+        CHECK(IsClose(centers[4], glm::vec3(8.0f, 4.0f, 12.0f)));
+    }
+
+    void TestSort()
+    {
+        const std::vector<glm::vec3> shape_centers = { glm::vec3(0.5f, 1.0f, 0.5f) };
+        std::vector<PackedFace> faces;
+        for (int x = 0; x < 16; ++x)
+        {
+            faces.push_back(MakeFace(x, 0, 0, 0));
+        }
+        // A big merged face starting at the camera block
+        // but with its center far from it
+        faces.push_back(MakeFace(0, 0, 0, 0, 16, 1, 16));
+
+        std::vector<glm::vec3> centers;
+        FaceSorter::ComputeCenters(faces, shape_centers, centers);
+
+        FaceSorter sorter;
+        const glm::vec3 cam_pos(0.5f, 3.0f, 0.5f);
+        sorter.Sort(cam_pos, faces, centers);
+        CHECK(faces.size() == 17);
+        CHECK(centers.size() == 17);
+
+        // From far to near
+        bool sorted = true;
+        for (size_t i = 1; i < centers.size(); ++i)
+        {
+            const glm::vec3 previous = cam_pos - centers[i - 1];
+            const glm::vec3 current = cam_pos - centers[i];
+            sorted = sorted && previous.x * previous.x + previous.y * previous.y + previous.z * previous.z >=
+                current.x * current.x + current.y * current.y + current.z * current.z;
+        }
+        CHECK(sorted);
+        // Faces are moved with their centers
+        std::vector<glm::vec3> expected;
+        FaceSorter::ComputeCenters(faces, shape_centers, expected);
+        bool moved = true;
+        for (size_t i = 0; i < centers.size(); ++i)
+        {
+            moved = moved && IsClose(centers[i], expected[i]);
+        }
+        CHECK(moved);
+        CHECK(((faces.back().position >> 17) & 0x0F) == 0);
+        CHECK((faces.back().position & 0x0F) == 0);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    TestCenters();
+    TestSort();
+
+    return TEST_RESULT();
+}
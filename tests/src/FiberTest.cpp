@@ -0,0 +1,121 @@
+#include <memory>
+#include <stdexcept>
+
+#include "botcraft/Utilities/Fiber.hpp"
+
+#include "TestUtilities.hpp"
+
+using namespace Botcraft;
+
+// A fiber must run its function up to each Suspend, forward its
+// exceptions to Resume, and a fiber destroyed while suspended
+// must unwind its stack so the destructors of its objects are called
+
+namespace
+{
+    struct Counter
+    {
+        Counter(int& count_) : count(count_) {}
+        ~Counter() { count += 1; }
+
+        int& count;
+    };
+
+    void TestResume()
+    {
+        int steps = 0;
+        std::unique_ptr<Fiber> fiber;
+        fiber = std::unique_ptr<Fiber>(new Fiber([&]()
+            {
+                for (int i = 0; i < 3; ++i)
+                {
+                    steps += 1;
+                    fiber->Suspend();
+                }
+            }));
+
+        // Not started before the first Resume
+        CHECK(steps == 0);
+        fiber->Resume();
+        CHECK(steps == 1);
+        fiber->Resume();
+        fiber->Resume();
+        CHECK(steps == 3);
+        CHECK(!fiber->IsFinished());
+        fiber->Resume();
+        CHECK(fiber->IsFinished());
+        // Does nothing once finished
+        fiber->Resume();
+        CHECK(steps == 3);
+    }
+
+    void TestException()
+    {
+        Fiber fiber([]()
+            {
+                throw std::runtime_error("Fiber error");
+            });
+        bool caught = false;
+        try
+        {
+            fiber.Resume();
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        CHECK(caught);
+        CHECK(fiber.IsFinished());
+    }
+
+    void TestUnwind()
+    {
+        int destroyed = 0;
+        bool cleaned_up = false;
+        Fiber* fiber = nullptr;
+        fiber = new Fiber([&]()
+            {
+                Counter outer(destroyed);
+                try
+                {
+                    Counter inner(destroyed);
+                    while (true)
+                    {
+                        fiber->Suspend();
+                    }
+                }
+                catch (const Fiber::Unwind&)
+                {
+                    cleaned_up = true;
+                    throw;
+                }
+            });
+        fiber->Resume();
+        fiber->Resume();
+        CHECK(destroyed == 0);
+
+        // Destroyed while suspended
+        delete fiber;
+        CHECK(destroyed == 2);
+        CHECK(cleaned_up);
+
+        // Never started, nothing to unwind
+        int not_started = 0;
+        {
+            Fiber other([&]()
+                {
+                    Counter counter(not_started);
+                });
+        }
+        CHECK(not_started == 0);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    TestResume();
+    TestException();
+    TestUnwind();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,175 @@
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "botcraft/Game/AssetsManager.hpp"
+#include "botcraft/Game/World/World.hpp"
+#include "botcraft/Renderer/MapRasterizer.hpp"
+
+#include "TestUtilities.hpp"
+
+using namespace Botcraft;
+using namespace Botcraft::Renderer;
+
+// On a small synthetic chunk, the map pixels must have the color of
+// the top texture of the surface block (tinted for grass and water),
+// skip the transparent blocks, and be shaded like the in-game maps
+// from the height difference with the northern block and from the
+// water depth. Only the modifications changing the surface must
+// trigger a new scan, and unloaded chunks must be transparent
+
+namespace
+{
+    const int FLOOR_Y = 50;
+
+#if PROTOCOL_VERSION < 347
+    const std::string GRASS_BLOCK = "minecraft:grass";
+#else
+    const std::string GRASS_BLOCK = "minecraft:grass_block";
+#endif
+
+    void AddChunk(World& world, const int x, const int z)
+    {
+#if PROTOCOL_VERSION < 719
+        world.AddChunk(x, z, Dimension::Overworld);
+#else
+        world.AddChunk(x, z, "minecraft:overworld");
+#endif
+    }
+
+    void SetBlock(World& world, const Position& pos, const std::string& name)
+    {
+#if PROTOCOL_VERSION < 347
+        const std::pair<int, unsigned char> id = AssetsManager::getInstance().GetBlockstateID(name);
+        world.SetBlock(pos, id.first, id.second);
+#else
+        world.SetBlock(pos, AssetsManager::getInstance().GetBlockstateID(name));
+#endif
+    }
+
+    struct Pixel
+    {
+        int r;
+        int g;
+        int b;
+        int a;
+    };
+
+    // Pixel of block x, z in the image of the chunks 0, 0 to 1, 0
+    Pixel GetPixel(const std::vector<unsigned char>& image, const int x, const int z)
+    {
+        const unsigned char* pixel = image.data() + (z * 2 * CHUNK_WIDTH + x) * 4;
+        return Pixel{ pixel[0], pixel[1], pixel[2], pixel[3] };
+    }
+
+    // Same pixel, shaded with another brightness
+    bool IsShaded(const Pixel& pixel, const Pixel& bright, const int brightness)
+    {
+        return pixel.a == 255 &&
+            pixel.r == bright.r * brightness / 255 &&
+            pixel.g == bright.g * brightness / 255 &&
+            pixel.b == bright.b * brightness / 255;
+    }
+
+    bool IsEqual(const Pixel& a, const Pixel& b)
+    {
+        return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    }
+
+    void TestMapRasterizer()
+    {
+        std::shared_ptr<World> world = std::make_shared<World>(false);
+        AddChunk(*world, 0, 0);
+        // Loaded but empty
+        AddChunk(*world, 1, 0);
+
+        for (int x = 0; x < CHUNK_WIDTH; ++x)
+        {
+            for (int z = 0; z < CHUNK_WIDTH; ++z)
+            {
+                SetBlock(*world, Position(x, FLOOR_Y, z), "minecraft:stone");
+            }
+        }
+        // One block higher than the northern one, then one lower
+        SetBlock(*world, Position(4, FLOOR_Y + 1, 5), "minecraft:stone");
+        SetBlock(*world, Position(8, FLOOR_Y, 3), "minecraft:dirt");
+        SetBlock(*world, Position(10, FLOOR_Y, 3), GRASS_BLOCK);
+        SetBlock(*world, Position(12, FLOOR_Y + 1, 3), "minecraft:glass");
+        // Shallow and deep water
+        SetBlock(*world, Position(5, FLOOR_Y + 1, 10), "minecraft:water");
+        for (int y = FLOOR_Y + 1; y < FLOOR_Y + 11; ++y)
+        {
+            SetBlock(*world, Position(7, y, 10), "minecraft:water");
+        }
+
+        MapRasterizer rasterizer(world, 2);
+        CHECK(rasterizer.Update() == 2);
+        CHECK(rasterizer.Update() == 0);
+
+        std::vector<unsigned char> image;
+        rasterizer.Rasterize(0, 0, 1, 0, image);
+        CHECK(image.size() == 2 * CHUNK_WIDTH * CHUNK_WIDTH * 4);
+
+        // Flat, higher and lower than the northern block
+        const Pixel stone = GetPixel(image, 4, 3);
+        const Pixel stone_high = GetPixel(image, 4, 5);
+        const Pixel stone_low = GetPixel(image, 4, 6);
+        CHECK(stone_high.a == 255);
+        CHECK(IsShaded(stone, stone_high, 220));
+        CHECK(IsShaded(stone_low, stone_high, 180));
+        // Stone texture is gray
+        CHECK(std::abs(stone_high.r - stone_high.g) < 20 && std::abs(stone_high.g - stone_high.b) < 20);
+
+        // Other textures, grass is tinted green
+        const Pixel dirt = GetPixel(image, 8, 3);
+        const Pixel grass = GetPixel(image, 10, 3);
+        CHECK(dirt.a == 255 && !IsEqual(dirt, stone));
+        CHECK(dirt.r > dirt.b);
+        CHECK(grass.a == 255 && grass.g > grass.r && grass.g > grass.b);
+
+        // Glass is not visible, the stone below is used (with its height)
+        CHECK(IsEqual(GetPixel(image, 12, 3), stone));
+        CHECK(IsEqual(GetPixel(image, 12, 4), stone));
+
+        // Water is tinted blue and darker when deeper
+        const Pixel shallow_water = GetPixel(image, 5, 10);
+        const Pixel deep_water = GetPixel(image, 7, 10);
+        CHECK(shallow_water.a == 255 && shallow_water.b > shallow_water.r && shallow_water.b > shallow_water.g);
+        CHECK(IsShaded(deep_water, shallow_water, 180));
+
+        // Empty columns are transparent
+        CHECK(GetPixel(image, CHUNK_WIDTH + 3, 3).a == 0);
+
+        // Below the surface, nothing to scan again
+        SetBlock(*world, Position(3, FLOOR_Y - 10, 3), "minecraft:dirt");
+        CHECK(rasterizer.Update() == 0);
+
+        // Back to a flat surface
+        SetBlock(*world, Position(4, FLOOR_Y + 1, 5), "minecraft:air");
+        CHECK(rasterizer.Update() == 1);
+        rasterizer.Rasterize(0, 0, 1, 0, image);
+        CHECK(IsShaded(GetPixel(image, 4, 5), stone_high, 220));
+        CHECK(IsShaded(GetPixel(image, 4, 6), stone_high, 220));
+
+        // On the empty chunk
+        SetBlock(*world, Position(CHUNK_WIDTH + 3, FLOOR_Y, 3), "minecraft:dirt");
+        CHECK(rasterizer.Update() == 1);
+        rasterizer.Rasterize(0, 0, 1, 0, image);
+        CHECK(GetPixel(image, CHUNK_WIDTH + 3, 3).a == 255);
+        CHECK(GetPixel(image, CHUNK_WIDTH + 4, 3).a == 0);
+
+        world->RemoveChunk(0, 0);
+        rasterizer.Update();
+        rasterizer.Rasterize(0, 0, 1, 0, image);
+        CHECK(GetPixel(image, 4, 3).a == 0);
+        CHECK(GetPixel(image, CHUNK_WIDTH + 3, 3).a == 255);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    TestMapRasterizer();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <set>
+#include <vector>
+
+#include "botcraft/Renderer/MemoryBudget.hpp"
+
+#include "TestUtilities.hpp"
+
+using namespace Botcraft;
+using namespace Botcraft::Renderer;
+
+// Over the budget, MemoryBudget must drop the sections furthest from
+// the camera first, and only until the memory used is back under 90%
+// of the budget. New meshes beyond the eviction distance are dropped,
+// and dropped sections are given back once the camera gets closer.
+// With a camera moving along a line of sections, the memory used must
+// stay under the budget and the section of the camera must be kept.
+// This doesn't need OpenGL, only the choice of the sections is checked
+
+namespace
+{
+    const size_t SECTION_BYTES = 100;
+
+    float Distance(const Position& section, const float camera_x)
+    {
+        return std::abs(section.x * 16 + 8.0f - camera_x);
+    }
+
+    void TestEviction()
+    {
+        MemoryBudget budget;
+
+        // No budget, nothing is ever dropped
+        CHECK(!budget.Update(1000000));
+        CHECK(budget.KeepMesh(Position(100, 0, 0), 1000.0f, true));
+        CHECK(budget.GetNumEvicted() == 0);
+
+        budget.SetBudget(10 * SECTION_BYTES);
+        CHECK(!budget.Update(10 * SECTION_BYTES));
+        CHECK(budget.Update(12 * SECTION_BYTES));
+
+        // 12 sections of various sizes, closest first
+        std::vector<SectionMemory> sections;
+        size_t used_bytes = 0;
+        for (int i = 0; i < 12; ++i)
+        {
+            const size_t bytes = i == 10 ? 2 * SECTION_BYTES : SECTION_BYTES / 2 + (i % 3) * SECTION_BYTES / 2;
+            sections.push_back({ Position(i, 0, 0), Distance(Position(i, 0, 0), 0.0f), bytes });
+            used_bytes += bytes;
+        }
+        CHECK(budget.Update(used_bytes));
+        std::vector<Position> evicted;
+        budget.Evict(used_bytes, sections, evicted);
+
+        // Furthest first, just enough to be under 90%
+        CHECK(evicted.size() >= 2);
+        size_t remaining_bytes = used_bytes;
+        for (size_t i = 0; i < evicted.size(); ++i)
+        {
+            CHECK(evicted[i] == Position(11 - static_cast<int>(i), 0, 0));
+            CHECK(budget.IsEvicted(evicted[i]));
+            CHECK(remaining_bytes > 9 * SECTION_BYTES);
+            remaining_bytes -= sections[i].bytes;
+        }
+        CHECK(remaining_bytes <= 9 * SECTION_BYTES);
+        CHECK(budget.GetNumEvicted() == evicted.size());
+        const float eviction_distance = budget.GetEvictionDistance();
+        CHECK(eviction_distance == Distance(evicted.back(), 0.0f));
+        CHECK(!budget.IsEvicted(Position(0, 0, 0)));
+
+        // New meshes beyond the eviction distance are not kept, unless empty
+        CHECK(!budget.KeepMesh(Position(20, 0, 0), Distance(Position(20, 0, 0), 0.0f), true));
+        CHECK(budget.IsEvicted(Position(20, 0, 0)));
+        CHECK(budget.KeepMesh(Position(21, 0, 0), Distance(Position(21, 0, 0), 0.0f), false));
+        CHECK(!budget.IsEvicted(Position(21, 0, 0)));
+        CHECK(budget.KeepMesh(Position(1, 0, 0), Distance(Position(1, 0, 0), 0.0f), true));
+
+        // Camera didn't move and no room, nothing to restore
+        std::vector<Position> restored;
+        budget.Update(remaining_bytes);
+        budget.GetSectionsToRestore([](const Position& p) { return Distance(p, 0.0f); }, restored);
+        CHECK(restored.empty());
+
+        // Camera moved toward the evicted sections, with a margin
+        budget.GetSectionsToRestore([](const Position& p) { return Distance(p, 40.0f); }, restored);
+        CHECK(std::find(restored.begin(), restored.end(), Position(20, 0, 0)) == restored.end());
+        for (size_t i = 0; i < restored.size(); ++i)
+        {
+            CHECK(Distance(restored[i], 40.0f) < eviction_distance - 16.0f);
+            CHECK(!budget.IsEvicted(restored[i]));
+        }
+        CHECK(!restored.empty());
+        CHECK(budget.GetEvictionDistance() == eviction_distance);
+
+        // Memory used went under 75%, the limit moves one chunk further, only once
+        CHECK(!budget.Update(5 * SECTION_BYTES));
+        budget.GetSectionsToRestore([](const Position& p) { return Distance(p, 0.0f); }, restored);
+        CHECK(budget.GetEvictionDistance() == eviction_distance + 16.0f);
+        budget.GetSectionsToRestore([](const Position& p) { return Distance(p, 0.0f); }, restored);
+        CHECK(budget.GetEvictionDistance() == eviction_distance + 16.0f);
+
+        // Nothing evicted anymore, no more limit
+        budget.Clear();
+        CHECK(budget.GetNumEvicted() == 0);
+        CHECK(budget.GetEvictionDistance() == std::numeric_limits<float>::max());
+        CHECK(budget.KeepMesh(Position(20, 0, 0), Distance(Position(20, 0, 0), 0.0f), true));
+
+        budget.SetBudget(0);
+        CHECK(!budget.Update(1000000));
+    }
+
+    void TestMovingCamera()
+    {
+        // A line of 40 sections, only 10 fit in the budget
+        const int num_sections = 40;
+        MemoryBudget budget;
+        budget.SetBudget(10 * SECTION_BYTES);
+
+        std::set<int> resident;
+        for (int i = 0; i < num_sections; ++i)
+        {
+            resident.insert(i);
+        }
+
+        int num_restored = 0;
+        for (float camera_x = 0.0f; camera_x < num_sections * 16.0f; camera_x += 8.0f)
+        {
+            const auto distance = [camera_x](const Position& p) { return Distance(p, camera_x); };
+
+            // Dropped sections close enough are meshed again
+            std::vector<Position> restored;
+            budget.GetSectionsToRestore(distance, restored);
+            for (size_t i = 0; i < restored.size(); ++i)
+            {
+                num_restored += 1;
+                if (budget.KeepMesh(restored[i], distance(restored[i]), true))
+                {
+                    resident.insert(restored[i].x);
+                }
+            }
+
+            // Then the faces are uploaded and the budget is enforced
+            size_t used_bytes = resident.size() * SECTION_BYTES;
+            if (budget.Update(used_bytes))
+            {
+                std::vector<SectionMemory> sections;
+                for (auto it = resident.begin(); it != resident.end(); ++it)
+                {
+                    sections.push_back({ Position(*it, 0, 0), distance(Position(*it, 0, 0)), SECTION_BYTES });
+                }
+                std::vector<Position> evicted;
+                budget.Evict(used_bytes, sections, evicted);
+                float min_evicted_distance = std::numeric_limits<float>::max();
+                for (size_t i = 0; i < evicted.size(); ++i)
+                {
+                    resident.erase(evicted[i].x);
+                    min_evicted_distance = std::min(min_evicted_distance, distance(evicted[i]));
+                }
+                // No kept section is further than a dropped one
+                for (auto it = resident.begin(); it != resident.end(); ++it)
+                {
+                    CHECK(distance(Position(*it, 0, 0)) <= min_evicted_distance);
+                }
+                used_bytes = resident.size() * SECTION_BYTES;
+            }
+
+            CHECK(used_bytes <= 10 * SECTION_BYTES);
+            CHECK(resident.size() + budget.GetNumEvicted() == num_sections);
+            CHECK(resident.find(static_cast<int>(camera_x / 16.0f)) != resident.end());
+        }
+        // The furthest sections are dropped first, so sections are not
+        // dropped and meshed again over and over when the camera moves
+        CHECK(num_restored < 2 * num_sections);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    TestEviction();
+    TestMovingCamera();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,220 @@
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "botcraft/Game/World/Chunk.hpp"
+#include "botcraft/Renderer/SectionVisibility.hpp"
+
+#include "TestUtilities.hpp"
+
+using namespace Botcraft;
+using namespace Botcraft::Renderer;
+
+// SectionVisibility::Compute must connect two faces of a section only
+// if the non opaque blocks link them, and GetVisibleSections must
+// only go through the faces connected to the one it entered by
+
+namespace
+{
+    const int HEIGHT = 16;
+
+    const int Index(const int x, const int y, const int z)
+    {
+        return x + CHUNK_WIDTH * (z + CHUNK_WIDTH * y);
+    }
+
+    const bool IsConnected(const SectionVisibility& visibility, const Orientation a, const Orientation b)
+    {
+        return visibility.IsConnected(a, b) && visibility.IsConnected(b, a);
+    }
+
+    void TestCompute()
+    {
+        std::vector<bool> visited;
+        const std::vector<Orientation> sides = { Orientation::North, Orientation::West, Orientation::East, Orientation::South };
+
+        // Empty section, everything is connected
+        std::vector<bool> opaque(CHUNK_WIDTH * CHUNK_WIDTH * HEIGHT, false);
+        SectionVisibility visibility(false);
+        visibility.Compute(opaque, HEIGHT, visited);
+        CHECK(visibility.IsFullyConnected());
+
+        // Full section, nothing is connected
+        opaque.assign(opaque.size(), true);
+        visibility.Compute(opaque, HEIGHT, visited);
+        for (int i = 0; i < 6; ++i)
+        {
+            for (int j = 0; j < 6; ++j)
+            {
+                CHECK(!visibility.IsConnected(static_cast<Orientation>(i), static_cast<Orientation>(j)));
+            }
+        }
+
+        // Horizontal floor in the middle, the top and
+        // bottom halves are only connected to the sides
+        opaque.assign(opaque.size(), false);
+        for (int x = 0; x < CHUNK_WIDTH; ++x)
+        {
+            for (int z = 0; z < CHUNK_WIDTH; ++z)
+            {
+                opaque[Index(x, HEIGHT / 2, z)] = true;
+            }
+        }
+        visibility.Compute(opaque, HEIGHT, visited);
+        CHECK(!IsConnected(visibility, Orientation::Bottom, Orientation::Top));
+        for (size_t i = 0; i < sides.size(); ++i)
+        {
+            CHECK(IsConnected(visibility, Orientation::Bottom, sides[i]));
+            CHECK(IsConnected(visibility, Orientation::Top, sides[i]));
+            for (size_t j = 0; j < sides.size(); ++j)
+            {
+                CHECK(IsConnected(visibility, sides[i], sides[j]));
+            }
+        }
+
+        // Wall on the x axis, west and east are not connected
+        opaque.assign(opaque.size(), false);
+        for (int y = 0; y < HEIGHT; ++y)
+        {
+            for (int z = 0; z < CHUNK_WIDTH; ++z)
+            {
+                opaque[Index(CHUNK_WIDTH / 2, y, z)] = true;
+            }
+        }
+        visibility.Compute(opaque, HEIGHT, visited);
+        CHECK(!IsConnected(visibility, Orientation::West, Orientation::East));
+        CHECK(IsConnected(visibility, Orientation::West, Orientation::North));
+        CHECK(IsConnected(visibility, Orientation::East, Orientation::Top));
+        CHECK(IsConnected(visibility, Orientation::Bottom, Orientation::Top));
+
+        // A hole in the wall connects both sides
+        opaque[Index(CHUNK_WIDTH / 2, 3, 7)] = false;
+        visibility.Compute(opaque, HEIGHT, visited);
+        CHECK(visibility.IsFullyConnected());
+
+        // Vertical shaft in solid stone, only the top and bottom are connected
+        opaque.assign(opaque.size(), true);
+        for (int y = 0; y < HEIGHT; ++y)
+        {
+            opaque[Index(5, y, 9)] = false;
+        }
+        visibility.Compute(opaque, HEIGHT, visited);
+        CHECK(IsConnected(visibility, Orientation::Bottom, Orientation::Top));
+        for (size_t i = 0; i < sides.size(); ++i)
+        {
+            CHECK(!visibility.IsConnected(sides[i], Orientation::Bottom));
+            CHECK(!visibility.IsConnected(sides[i], Orientation::Top));
+            CHECK(!visibility.IsConnected(sides[i], sides[i]));
+        }
+
+        // Two separate pockets: one touching north and west, the other
+        // touching east and south, they must not be connected together
+        opaque.assign(opaque.size(), true);
+        for (int i = 0; i < 4; ++i)
+        {
+            opaque[Index(i, 8, 0)] = false;
+            opaque[Index(0, 8, i)] = false;
+            opaque[Index(CHUNK_WIDTH - 1 - i, 8, CHUNK_WIDTH - 1)] = false;
+            opaque[Index(CHUNK_WIDTH - 1, 8, CHUNK_WIDTH - 1 - i)] = false;
+        }
+        visibility.Compute(opaque, HEIGHT, visited);
+        CHECK(IsConnected(visibility, Orientation::North, Orientation::West));
+        CHECK(IsConnected(visibility, Orientation::East, Orientation::South));
+        CHECK(!IsConnected(visibility, Orientation::North, Orientation::East));
+        CHECK(!IsConnected(visibility, Orientation::West, Orientation::South));
+        CHECK(!IsConnected(visibility, Orientation::Bottom, Orientation::Top));
+
+        // Smaller sections (LOD or shorter section heights)
+        std::vector<bool> small_opaque(CHUNK_WIDTH * CHUNK_WIDTH * 4, false);
+        for (int x = 0; x < CHUNK_WIDTH; ++x)
+        {
+            for (int y = 0; y < 4; ++y)
+            {
+                small_opaque[Index(x, y, 4)] = true;
+            }
+        }
+        visibility.Compute(small_opaque, 4, visited);
+        CHECK(!IsConnected(visibility, Orientation::North, Orientation::South));
+        CHECK(IsConnected(visibility, Orientation::North, Orientation::Top));
+        CHECK(IsConnected(visibility, Orientation::South, Orientation::Bottom));
+    }
+
+    void TestVisibleSections()
+    {
+        const Position min_section(-5, -2, -2);
+        const Position max_section(5, 2, 2);
+        const auto always = [](const Position&) { return true; };
+        std::unordered_set<Position> visible;
+
+        // Empty world, everything in the box is visible
+        std::unordered_map<Position, SectionVisibility> visibilities;
+        GetVisibleSections(Position(0, 0, 0), visibilities, min_section, max_section, always, visible);
+        CHECK(visible.size() == 11 * 5 * 5);
+        CHECK(visible.find(Position(-5, -2, 2)) != visible.end());
+        CHECK(visible.find(Position(6, 0, 0)) == visible.end());
+
+        // Only the sections in the frustum
+        GetVisibleSections(Position(0, 0, 0), visibilities, min_section, max_section,
+            [](const Position& p) { return p.x >= 0; }, visible);
+        CHECK(visible.size() == 6 * 5 * 5);
+
+        // An opaque wall at x = 2, the wall is visible but not what's behind
+        for (int y = min_section.y; y <= max_section.y; ++y)
+        {
+            for (int z = min_section.z; z <= max_section.z; ++z)
+            {
+                visibilities[Position(2, y, z)] = SectionVisibility(false);
+            }
+        }
+        GetVisibleSections(Position(0, 0, 0), visibilities, min_section, max_section, always, visible);
+        CHECK(visible.size() == 8 * 5 * 5);
+        CHECK(visible.find(Position(2, 1, -1)) != visible.end());
+        CHECK(visible.find(Position(3, 0, 0)) == visible.end());
+
+        // A hole in the wall, seen straight from the camera
+        SectionVisibility hole(false);
+        hole.SetConnected(Orientation::West, Orientation::East);
+        visibilities[Position(2, 0, 0)] = hole;
+        GetVisibleSections(Position(0, 0, 0), visibilities, min_section, max_section, always, visible);
+        CHECK(visible.find(Position(3, 0, 0)) != visible.end());
+        CHECK(visible.find(Position(5, 0, 0)) != visible.end());
+        // Never going back toward the camera, the sections behind the
+        // wall are only seen going away from the camera in x
+        CHECK(visible.find(Position(3, 2, 2)) != visible.end());
+        CHECK(visible.size() == 8 * 5 * 5 + 3 * 5 * 5);
+
+        // In a tunnel going east in solid stone, only the tunnel
+        // and the sections around the camera are visible
+        visibilities.clear();
+        for (int x = min_section.x; x <= max_section.x; ++x)
+        {
+            for (int y = min_section.y; y <= max_section.y; ++y)
+            {
+                for (int z = min_section.z; z <= max_section.z; ++z)
+                {
+                    visibilities[Position(x, y, z)] = SectionVisibility(false);
+                }
+            }
+        }
+        SectionVisibility tunnel(false);
+        tunnel.SetConnected(Orientation::West, Orientation::East);
+        for (int x = 0; x <= 4; ++x)
+        {
+            visibilities[Position(x, 0, 0)] = tunnel;
+        }
+        GetVisibleSections(Position(0, 0, 0), visibilities, min_section, max_section, always, visible);
+        // The camera section, its 6 neighbours and the tunnel up to its end
+        CHECK(visible.size() == 1 + 6 + 4);
+        CHECK(visible.find(Position(5, 0, 0)) != visible.end());
+        CHECK(visible.find(Position(-2, 0, 0)) == visible.end());
+        CHECK(visible.find(Position(2, 1, 0)) == visible.end());
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    TestCompute();
+    TestVisibleSections();
+
+    return TEST_RESULT();
+}
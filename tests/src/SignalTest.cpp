@@ -0,0 +1,77 @@
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "botcraft/Utilities/Signal.hpp"
+
+#include "TestUtilities.hpp"
+
+using namespace Botcraft;
+
+// Signal listeners must be called on Notify until they are removed,
+// and the version must count every Notify, whatever the thread
+
+namespace
+{
+    void TestListeners()
+    {
+        Signal signal;
+        int first_calls = 0;
+        int second_calls = 0;
+        const size_t first_id = signal.AddListener([&]() { first_calls += 1; });
+        const size_t second_id = signal.AddListener([&]() { second_calls += 1; });
+
+        signal.Notify();
+        CHECK(first_calls == 1 && second_calls == 1);
+        CHECK(signal.GetVersion() == 1);
+
+        signal.RemoveListener(first_id);
+        signal.Notify();
+        CHECK(first_calls == 1 && second_calls == 2);
+
+        signal.RemoveListener(second_id);
+        // Removing twice does nothing
+        signal.RemoveListener(second_id);
+        signal.Notify();
+        CHECK(first_calls == 1 && second_calls == 2);
+        CHECK(signal.GetVersion() == 3);
+    }
+
+    void TestConcurrentNotify()
+    {
+        const int num_threads = 4;
+        const int num_notifies = 10000;
+
+        Signal signal;
+        std::atomic<int> calls(0);
+        const size_t id = signal.AddListener([&]() { calls += 1; });
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < num_threads; ++i)
+        {
+            threads.push_back(std::thread([&]()
+                {
+                    for (int j = 0; j < num_notifies; ++j)
+                    {
+                        signal.Notify();
+                    }
+                }));
+        }
+        for (int i = 0; i < num_threads; ++i)
+        {
+            threads[i].join();
+        }
+
+        CHECK(signal.GetVersion() == num_threads * num_notifies);
+        CHECK(calls == num_threads * num_notifies);
+        signal.RemoveListener(id);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    TestListeners();
+    TestConcurrentNotify();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,169 @@
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "botcraft/Game/AssetsManager.hpp"
+#include "botcraft/Game/World/World.hpp"
+#include "botcraft/Game/World/StructureDiff.hpp"
+
+#include "TestUtilities.hpp"
+
+using namespace Botcraft;
+
+// A small structure diffed against a world must report the right
+// missing/wrong/additional/unknown counts and needed items, both
+// after the initial diff and after the blocks or chunks changed,
+// and the nearest remaining block must be the closest one that
+// can be fixed with the given items
+
+namespace
+{
+    void AddChunk(World& world, const int x, const int z)
+    {
+#if PROTOCOL_VERSION < 719
+        world.AddChunk(x, z, Dimension::Overworld);
+#else
+        world.AddChunk(x, z, "minecraft:overworld");
+#endif
+    }
+
+    void SetBlock(World& world, const Position& pos, const std::string& name)
+    {
+#if PROTOCOL_VERSION < 347
+        const std::pair<int, unsigned char> id = AssetsManager::getInstance().GetBlockstateID(name);
+        world.SetBlock(pos, id.first, id.second);
+#else
+        world.SetBlock(pos, AssetsManager::getInstance().GetBlockstateID(name));
+#endif
+    }
+
+    void TestStructureDiff()
+    {
+        std::shared_ptr<World> world = std::make_shared<World>(false);
+        AddChunk(*world, 0, 0);
+
+        // 4x2x2 structure, the two first x slices are in
+        // the loaded chunk, the two others are not loaded.
+        // Stone on the bottom layer, air on the top one but
+        // one dirt block in the first corner
+        const Position start(14, 10, 0);
+        const Position end(17, 11, 1);
+        std::map<short, std::string> palette;
+        palette[0] = "minecraft:stone";
+        palette[1] = "minecraft:dirt";
+        std::vector<std::vector<std::vector<short> > > target(4, std::vector<std::vector<short> >(2, std::vector<short>(2, -1)));
+        for (int x = 0; x < 4; ++x)
+        {
+            for (int z = 0; z < 2; ++z)
+            {
+                target[x][0][z] = 0;
+            }
+        }
+        target[0][1][0] = 1;
+
+        SetBlock(*world, Position(14, 10, 0), "minecraft:stone");
+        SetBlock(*world, Position(14, 10, 1), "minecraft:dirt");
+        SetBlock(*world, Position(15, 10, 1), "minecraft:stone");
+        SetBlock(*world, Position(14, 11, 1), "minecraft:stone");
+
+        StructureDiff diff(start, end, target, palette);
+        CHECK(diff.GetNumBlocks() == 16);
+        diff.Watch(world);
+
+        // (15, 10, 0) and (14, 11, 0) missing, (14, 10, 1)
+        // wrong, (14, 11, 1) additional, x = 16 and 17 unknown
+        CHECK(diff.GetNumMissing() == 2);
+        CHECK(diff.GetNumWrong() == 1);
+        CHECK(diff.GetNumAdditional() == 1);
+        CHECK(diff.GetNumUnknown() == 8);
+        CHECK(diff.GetNumRemaining() == 4);
+        CHECK(diff.GetDonePercentage() == 25.0f);
+        CHECK(diff.GetNumNeeded("minecraft:stone") == 2);
+        CHECK(diff.GetNumNeeded("minecraft:dirt") == 1);
+        CHECK(diff.GetNumNeeded("minecraft:glass") == 0);
+        CHECK(diff.GetNeededItems().size() == 2);
+        CHECK(diff.GetRemaining(10).size() == 4);
+        CHECK(diff.GetRemaining(3).size() == 3);
+
+        Position nearest;
+        CHECK(diff.GetNearestRemaining(Vector3<double>(15.5, 10.5, 0.5), nearest));
+        CHECK(nearest == Position(15, 10, 0));
+        // Far away, still the closest one
+        CHECK(diff.GetNearestRemaining(Vector3<double>(100.0, 11.5, 0.5), nearest));
+        CHECK(nearest == Position(15, 10, 0));
+
+        // Only dirt can be placed, digging is not allowed
+        Position found;
+        std::string found_item;
+        const auto accept = [&](const Position& pos, const std::string& item)
+        {
+            found = pos;
+            found_item = item;
+            return true;
+        };
+        CHECK(diff.FindNearest(Vector3<double>(15.5, 10.5, 1.5), { "minecraft:dirt" }, false, world, accept));
+        CHECK(found == Position(14, 11, 0) && found_item == "minecraft:dirt");
+        // Nothing to place, the nearest block to dig
+        CHECK(diff.FindNearest(Vector3<double>(15.5, 10.5, 1.5), {}, true, world, accept));
+        CHECK(found == Position(14, 10, 1) && found_item.empty());
+        CHECK(!diff.FindNearest(Vector3<double>(15.5, 10.5, 1.5), { "minecraft:glass" }, false, world, accept));
+
+        // Incremental updates from the world changes
+        SetBlock(*world, Position(15, 10, 0), "minecraft:stone");
+        SetBlock(*world, Position(14, 11, 1), "minecraft:air");
+        SetBlock(*world, Position(14, 11, 0), "minecraft:stone");
+        CHECK(diff.GetNumMissing() == 0);
+        CHECK(diff.GetNumWrong() == 2);
+        CHECK(diff.GetNumAdditional() == 0);
+        CHECK(diff.GetNumNeeded("minecraft:stone") == 1);
+        CHECK(diff.GetNumNeeded("minecraft:dirt") == 1);
+
+        // Outside of the structure, nothing changes
+        SetBlock(*world, Position(13, 10, 0), "minecraft:stone");
+        SetBlock(*world, Position(14, 12, 0), "minecraft:stone");
+        CHECK(diff.GetNumRemaining() == 2);
+
+        // Added chunks stay unknown until their blocks are received
+        AddChunk(*world, 1, 0);
+        CHECK(diff.GetNumUnknown() == 8);
+        SetBlock(*world, Position(16, 10, 0), "minecraft:stone");
+        SetBlock(*world, Position(16, 10, 1), "minecraft:air");
+        SetBlock(*world, Position(16, 11, 0), "minecraft:air");
+        CHECK(diff.GetNumUnknown() == 5);
+        CHECK(diff.GetNumMissing() == 1);
+        CHECK(diff.GetNumNeeded("minecraft:stone") == 2);
+        CHECK(diff.GetDonePercentage() == 50.0f);
+
+        // Unloaded blocks keep their last known state
+        world->RemoveChunk(1, 0);
+        CHECK(diff.GetNumUnknown() == 5);
+        CHECK(diff.GetNumMissing() == 1);
+
+        // Everything fixed
+        AddChunk(*world, 1, 0);
+        SetBlock(*world, Position(14, 10, 1), "minecraft:stone");
+        SetBlock(*world, Position(14, 11, 0), "minecraft:dirt");
+        for (int x = 16; x < 18; ++x)
+        {
+            for (int z = 0; z < 2; ++z)
+            {
+                SetBlock(*world, Position(x, 10, z), "minecraft:stone");
+                SetBlock(*world, Position(x, 11, z), "minecraft:air");
+            }
+        }
+        CHECK(diff.GetNumUnknown() == 0);
+        CHECK(diff.GetNumRemaining() == 0);
+        CHECK(diff.GetNeededItems().empty());
+        CHECK(diff.GetDonePercentage() == 100.0f);
+        CHECK(!diff.GetNearestRemaining(Vector3<double>(15.5, 10.5, 0.5), nearest));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    TestStructureDiff();
+
+    return TEST_RESULT();
+}